@@ -28,7 +28,10 @@
 #include "itkObjectFactory.h"
 #include "itkPoint.h"
 
+#include "otbDEMTileCache.h"
+
 #include "OTBOSSIMAdaptersExport.h"
+#include <memory>
 #include <string>
 
 class ossimElevManager;
@@ -80,6 +83,19 @@ namespace otb
  * height above ellipsoid, and follow the same logic as the
  * GetHeightAboveEllipsoid() method.
  *
+ * Optionally, heights are read from OSSIM once on a grid of one arc
+ * second, and then interpolated from a cache of tiles (see
+ * DEMTileCache), which is much faster than asking OSSIM for every point
+ * of a dense lookup. For SRTM, DTED and the EGM96 geoid, whose posts lie
+ * on this grid, the heights are the same; the heights of other DEMs are
+ * resampled, so the cache is off by default. It is enabled by setting
+ * its size with the OTB_DEM_TILE_CACHE_SIZE environment variable (see
+ * ConfigurationManager::GetDEMTileCacheSize()) or with
+ * SetTileCacheCapacity(). The cache is cleared whenever the DEM
+ * directory, the geoid or the default height changes. Several points
+ * can be processed at once with the array versions of
+ * GetHeightAboveEllipsoid() and GetHeightAboveMSL().
+ *
  * DEM directory can either contain DTED or SRTM formats.
  * \ingroup Images
  *
@@ -139,10 +155,19 @@ public:
   virtual double GetHeightAboveMSL(double lon, double lat) const;
   virtual double GetHeightAboveMSL(const PointType& geoPoint) const;
 
+  /** Compute the height above MSL of count geographic points at once.
+   *  Points are best sorted by location, like the lines of an image. */
+  virtual void GetHeightAboveMSL(const double* lon, const double* lat, double* heights, size_t count) const;
+
   /** Compute the height above ellipsoid of a geographic point. */
   virtual double GetHeightAboveEllipsoid(double lon, double lat) const;
   virtual double GetHeightAboveEllipsoid(const PointType& geoPoint) const;
 
+  /** Compute the height above ellipsoid of count geographic points at
+   *  once. Points are best sorted by location, like the lines of an
+   *  image. */
+  virtual void GetHeightAboveEllipsoid(const double* lon, const double* lat, double* heights, size_t count) const;
+
   /** Set the default height above ellipsoid in case no information is available*/
   virtual void SetDefaultHeightAboveEllipsoid(double h);
 
@@ -167,6 +192,16 @@ public:
    */
   void ClearDEMs();
 
+  /** Set the memory used by the cache of heights in bytes, 0 disables
+   *  the cache */
+  void SetTileCacheCapacity(unsigned long long capacity);
+
+  /** Get the memory used by the cache of heights in bytes */
+  unsigned long long GetTileCacheCapacity() const;
+
+  /** Remove all the cached heights */
+  void ClearTileCache();
+
 protected:
   DEMHandler();
   ~DEMHandler() override {}
@@ -181,6 +216,10 @@ protected:
   // ellipsoid We therefore must keep it on our side
   double m_DefaultHeightAboveEllipsoid;
 
+  // Heights above ellipsoid and above MSL sampled from ossim
+  std::unique_ptr<DEMTileCache> m_EllipsoidTileCache;
+  std::unique_ptr<DEMTileCache> m_MSLTileCache;
+
   static Pointer m_Singleton;
 
 };
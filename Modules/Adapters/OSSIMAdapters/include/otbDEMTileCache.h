@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbDEMTileCache_h
+#define otbDEMTileCache_h
+
+#include "itkSimpleFastMutexLock.h"
+
+#include "OTBOSSIMAdaptersExport.h"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace otb
+{
+
+/** \class DEMTileCache
+ *
+ * \brief Thread-safe cache of elevation tiles on a regular geographic grid
+ *
+ * Heights are sampled once on a regular grid of posts, spaced by
+ * PostSpacing degrees in longitude and latitude, and kept in tiles of
+ * TileSize x TileSize cells. The height of a point is then bilinearly
+ * interpolated from the four posts around it, without calling the
+ * sample function again.
+ *
+ * When the heights returned by the sample function are themselves
+ * bilinearly interpolated from posts lying on the cache grid, the
+ * cached heights are identical: for instance a post spacing of one
+ * arc second matches SRTM, DTED and the EGM96 geoid grids. Points
+ * whose posts are not all valid (NaN) are sampled directly.
+ *
+ * The cache is bounded in size: the least recently used tiles are
+ * evicted first. Tiles are spread over several stripes, each with a
+ * lock of its own, so that concurrent threads rarely wait for each
+ * other. A null capacity disables the cache: every height is then
+ * sampled directly.
+ *
+ * \sa DEMHandler
+ *
+ * \ingroup OTBOSSIMAdapters
+ */
+class OTBOSSIMAdapters_EXPORT DEMTileCache
+{
+public:
+  /** Function returning the height of a point (lon, lat) in degrees */
+  typedef std::function<double (double, double)> SampleFunctionType;
+
+  explicit DEMTileCache(const SampleFunctionType & sample);
+  ~DEMTileCache();
+
+  /** Height of a point, interpolated from the cached tiles. This method
+   *  is thread-safe. */
+  double GetHeight(double lon, double lat);
+
+  /** Heights of count points, interpolated from the cached tiles. The
+   *  points are best sorted by location (lines of an image for
+   *  instance), so that consecutive points share the same tile. This
+   *  method is thread-safe. */
+  void GetHeights(const double * lon, const double * lat, double * heights, size_t count);
+
+  /** Remove all the tiles, for instance when the DEM changes */
+  void Clear();
+
+  /** Set the capacity of the cache in bytes, 0 disables the cache */
+  void SetCapacity(unsigned long long capacity);
+  unsigned long long GetCapacity() const;
+
+  /** True if the capacity is not null */
+  bool IsEnabled() const;
+
+  /** Set the spacing of the posts in degrees, and clear the cache. This
+   *  method must not be called while heights are computed. */
+  void SetPostSpacing(double spacing);
+  double GetPostSpacing() const;
+
+  /** Size of the tiles currently cached, in bytes */
+  unsigned long long GetSize() const;
+
+  /** Number of tiles sampled since the last reset of the counters */
+  unsigned long long GetNumberOfLoadedTiles() const;
+
+  /** Reset the counter of loaded tiles */
+  void ResetCounters();
+
+  /** Number of cells of a tile along each dimension */
+  static const unsigned int TileSize = 256;
+
+  /** Number of stripes, each with a lock and an LRU list of its own */
+  static const unsigned int NumberOfStripes = 8;
+
+private:
+  DEMTileCache(const DEMTileCache &) = delete;
+  void operator =(const DEMTileCache &) = delete;
+
+  struct TileKey
+  {
+    TileKey() : x(0), y(0) {}
+    TileKey(long long tx, long long ty) : x(tx), y(ty) {}
+
+    bool operator<(const TileKey & k) const
+    {
+      if (x != k.x) return x < k.x;
+      return y < k.y;
+    }
+
+    bool operator==(const TileKey & k) const
+    {
+      return x == k.x && y == k.y;
+    }
+
+    long long x;
+    long long y;
+  };
+
+  /** Heights of the (TileSize+1) x (TileSize+1) posts of a tile, from
+   *  south-west to north-east, one line of latitude after the other */
+  typedef std::vector<double>             TileType;
+  typedef std::shared_ptr<const TileType> TilePointerType;
+
+  struct Entry
+  {
+    TileKey         key;
+    TilePointerType tile;
+  };
+
+  typedef std::list<Entry>                          EntryListType;
+  typedef std::map<TileKey, EntryListType::iterator> EntryMapType;
+
+  /** Part of the cache protected by a single lock */
+  struct Stripe
+  {
+    Stripe() : capacity(0), size(0), generation(0), loaded(0) {}
+
+    /** Entries, from the most to the least recently used */
+    EntryListType                    entries;
+    EntryMapType                     index;
+    unsigned long long               capacity;
+    unsigned long long               size;
+    /** Incremented by Clear(), so that tiles sampled before are not
+     *  inserted afterwards */
+    unsigned long long               generation;
+    unsigned long long               loaded;
+    mutable itk::SimpleFastMutexLock lock;
+  };
+
+  /** Stripe in charge of a tile */
+  Stripe & GetStripe(const TileKey & key);
+
+  /** Find a tile, sampling it if it is not cached */
+  TilePointerType GetTile(const TileKey & key);
+
+  /** Sample the posts of a tile */
+  TilePointerType LoadTile(const TileKey & key) const;
+
+  /** Height of a point from its tile: (i, j) is the south-west post
+   *  of its cell in the tile, (dx, dy) its position in the cell. NaN if
+   *  one of the posts around the point is not valid. */
+  static double Interpolate(const TileType & tile, long long i, long long j,
+                            double dx, double dy);
+
+  /** Remove the least recently used entries of a stripe until it fits
+   *  in its capacity (lock must be held) */
+  static void EvictUnsafe(Stripe & stripe);
+
+  SampleFunctionType m_Sample;
+  double             m_PostSpacing;
+  std::atomic<bool>  m_Enabled;
+  Stripe             m_Stripes[NumberOfStripes];
+}; // end of DEMTileCache
+
+} // end namespace otb
+
+#endif // otbDEMTileCache_h
@@ -22,6 +22,10 @@
 #define otbSensorModelAdapter_h
 
 #include "otbDEMHandler.h"
+#include "itkSimpleFastMutexLock.h"
+
+#include <memory>
+#include <vector>
 
 class ossimProjection;
 class ossimTieGptSet;
@@ -39,6 +43,14 @@ class ImageKeywordlist;
  * InverseSensorModel and ForwardSensorModel. If you feel that you need to use
  * it directly, think again!
  *
+ * OSSIM models hold a mutable state and are not reentrant. The methods
+ * transforming arrays of points work on clones of the model, taken from
+ * a pool, so that they can be called from several threads at once and
+ * pay for the lock only once per array. For RPC models, the inverse
+ * transform of arrays is computed by evaluating the rational
+ * polynomials directly on all the points, when this gives the same
+ * result as the OSSIM model (see HasFastRPCModel()).
+ *
  * \sa InverseSensorModel
  * \sa ForwardSensorModel
  * \ingroup Projection
@@ -87,6 +99,30 @@ public:
   void InverseTransformPoint(double lon, double lat,
                              double& x, double& y, double& z) const;
 
+  /** Forward sensor modelling of count points with elevation (above
+   *  ellipsoid) provided by the user. This method is thread-safe. */
+  void ForwardTransformPoints(const double* x, const double* y, const double* z,
+                              double* lon, double* lat, double* h, size_t count) const;
+
+  /** Forward sensor modelling of count points with elevation (above
+   *  ellipsoid) estimated by the algorithm. This method is thread-safe. */
+  void ForwardTransformPoints(const double* x, const double* y,
+                              double* lon, double* lat, double* h, size_t count) const;
+
+  /** Inverse sensor modelling of count points with elevation (above
+   *  ellipsoid) provided by the user. This method is thread-safe. */
+  void InverseTransformPoints(const double* lon, const double* lat, const double* h,
+                              double* x, double* y, double* z, size_t count) const;
+
+  /** Inverse sensor modelling of count points with elevation (above
+   *  ellipsoid) from DEMHandler. This method is thread-safe. */
+  void InverseTransformPoints(const double* lon, const double* lat,
+                              double* x, double* y, double* z, size_t count) const;
+
+  /** True if the inverse transform of arrays of points evaluates the
+   *  RPC polynomials directly */
+  bool HasFastRPCModel() const;
+
 
   /** Add a tie point with elevation (above ellipsoid) provided by the user */
   void AddTiePoint(double x, double y, double z, double lon, double lat);
@@ -117,8 +153,28 @@ private:
   SensorModelAdapter(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  /** Coefficients of an RPC model, evaluated without OSSIM */
+  struct RPCModel;
+
+  /** Take a clone of the model from the pool, or create one. Returns
+   *  m_SensorModel itself if the model can not be cloned. */
+  InternalMapProjectionPointer AcquireModel() const;
+
+  /** Give a clone back to the pool */
+  void ReleaseModel(InternalMapProjectionPointer model) const;
+
+  /** To be called whenever m_SensorModel changes: drop the clones and
+   *  look for an RPC model */
+  void ModelChanged();
+
   InternalMapProjectionPointer m_SensorModel;
 
+  /** Clones of m_SensorModel not in use */
+  mutable std::vector<InternalMapProjectionPointer> m_ModelPool;
+  mutable itk::SimpleFastMutexLock                  m_ModelPoolLock;
+
+  std::unique_ptr<RPCModel> m_RPCModel;
+
   InternalTiePointsContainerPointer m_TiePoints;
 
   /** Object that read and use DEM */
@@ -20,6 +20,7 @@
 
 #include "otbDEMHandler.h"
 #include "otbMacro.h"
+#include "otbConfigurationManager.h"
 
 #include <cassert>
 
@@ -50,6 +51,32 @@
 
 namespace otb
 {
+
+namespace
+{
+double SampleHeightAboveMSL(double lon, double lat)
+{
+  ossimGpt ossimWorldPoint;
+  ossimWorldPoint.lon = lon;
+  ossimWorldPoint.lat = lat;
+
+  assert( ossimElevManager::instance()!=NULL );
+
+  return ossimElevManager::instance()->getHeightAboveMSL(ossimWorldPoint);
+}
+
+double SampleHeightAboveEllipsoid(double lon, double lat)
+{
+  ossimGpt ossimWorldPoint;
+  ossimWorldPoint.lon = lon;
+  ossimWorldPoint.lat = lat;
+
+  assert( ossimElevManager::instance()!=NULL );
+
+  return ossimElevManager::instance()->getHeightAboveEllipsoid(ossimWorldPoint);
+}
+}
+
 /** Initialize the singleton */
 DEMHandler::Pointer DEMHandler::m_Singleton = nullptr;
 
@@ -72,10 +99,14 @@ DEMHandler::Pointer DEMHandler::Instance()
 DEMHandler
 ::DEMHandler() :
   m_GeoidFile(""),
-  m_DefaultHeightAboveEllipsoid(0)
+  m_DefaultHeightAboveEllipsoid(0),
+  m_EllipsoidTileCache(new DEMTileCache(SampleHeightAboveEllipsoid)),
+  m_MSLTileCache(new DEMTileCache(SampleHeightAboveMSL))
 {
   assert( ossimElevManager::instance()!=NULL );
 
+  this->SetTileCacheCapacity(ConfigurationManager::GetDEMTileCacheSize() * 1024 * 1024);
+
   ossimElevManager::instance()->setDefaultHeightAboveEllipsoid(m_DefaultHeightAboveEllipsoid);
   // Force geoid fallback
   ossimElevManager::instance()->setUseGeoidIfNullFlag(true);
@@ -109,6 +140,8 @@ DEMHandler
       ossimElevManager::instance()->addDatabase(imageElevationDatabase.get());
       }
     }
+
+  this->ClearTileCache();
 }
 
 
@@ -119,6 +152,8 @@ DEMHandler
   assert( ossimElevManager::instance()!=NULL );
 
   ossimElevManager::instance()->clear();
+
+  this->ClearTileCache();
 }
 
 
@@ -145,6 +180,10 @@ DEMHandler
       ossimRefPtr<ossimElevationDatabase> imageElevationDatabase = new ossimImageElevationDatabase;
       result = imageElevationDatabase->open(DEMDirectory);
     }
+
+  // Loading the elevation path adds it to the ossimElevManager
+  this->ClearTileCache();
+
   return result;
 }
 
@@ -172,6 +211,8 @@ DEMHandler
 
       ossimElevManager::instance()->setDefaultHeightAboveEllipsoid(ossim::nan());
 
+      this->ClearTileCache();
+
       return true;
       }
     else
@@ -199,17 +240,7 @@ double
 DEMHandler
 ::GetHeightAboveMSL(double lon, double lat) const
 {
-  double   height;
-  ossimGpt ossimWorldPoint;
-
-  ossimWorldPoint.lon = lon;
-  ossimWorldPoint.lat = lat;
-
-  assert( ossimElevManager::instance()!=NULL );
-
-  height = ossimElevManager::instance()->getHeightAboveMSL(ossimWorldPoint);
-
-  return height;
+  return m_MSLTileCache->GetHeight(lon, lat);
 }
 
 double
@@ -219,21 +250,18 @@ DEMHandler
   return GetHeightAboveMSL(geoPoint[0], geoPoint[1]);
 }
 
+void
+DEMHandler
+::GetHeightAboveMSL(const double* lon, const double* lat, double* heights, size_t count) const
+{
+  m_MSLTileCache->GetHeights(lon, lat, heights, count);
+}
+
 double
 DEMHandler
 ::GetHeightAboveEllipsoid(double lon, double lat) const
 {
-  double   height;
-  ossimGpt ossimWorldPoint;
-
-  ossimWorldPoint.lon = lon;
-  ossimWorldPoint.lat = lat;
-
-  assert( ossimElevManager::instance()!=NULL );
-
-  height = ossimElevManager::instance()->getHeightAboveEllipsoid(ossimWorldPoint);
-
-  return height;
+  return m_EllipsoidTileCache->GetHeight(lon, lat);
 }
 
 double
@@ -243,6 +271,13 @@ DEMHandler
   return GetHeightAboveEllipsoid(geoPoint[0], geoPoint[1]);
 }
 
+void
+DEMHandler
+::GetHeightAboveEllipsoid(const double* lon, const double* lat, double* heights, size_t count) const
+{
+  m_EllipsoidTileCache->GetHeights(lon, lat, heights, count);
+}
+
 void
 DEMHandler
 ::SetDefaultHeightAboveEllipsoid(double h)
@@ -254,6 +289,8 @@ DEMHandler
   assert( ossimElevManager::instance()!=NULL );
 
   ossimElevManager::instance()->setDefaultHeightAboveEllipsoid(h);
+
+  this->ClearTileCache();
 }
 
 double
@@ -294,12 +331,38 @@ std::string DEMHandler::GetGeoidFile() const
   return m_GeoidFile;
 }
 
+void
+DEMHandler
+::SetTileCacheCapacity(unsigned long long capacity)
+{
+  // Shared between the heights above ellipsoid and above MSL
+  m_EllipsoidTileCache->SetCapacity(capacity / 2);
+  m_MSLTileCache->SetCapacity(capacity / 2);
+}
+
+unsigned long long
+DEMHandler
+::GetTileCacheCapacity() const
+{
+  return m_EllipsoidTileCache->GetCapacity() + m_MSLTileCache->GetCapacity();
+}
+
+void
+DEMHandler
+::ClearTileCache()
+{
+  m_EllipsoidTileCache->Clear();
+  m_MSLTileCache->Clear();
+}
+
 void
 DEMHandler
 ::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "DEMHandler" << std::endl;
+  os << indent << "TileCacheCapacity: " << this->GetTileCacheCapacity() << std::endl;
+  os << indent << "TileCacheSize: " << m_EllipsoidTileCache->GetSize() + m_MSLTileCache->GetSize() << std::endl;
 }
 
 } // namespace otb
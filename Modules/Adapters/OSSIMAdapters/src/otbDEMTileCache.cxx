@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbDEMTileCache.h"
+#include "itkMutexLockHolder.h"
+
+#include <cmath>
+
+namespace otb
+{
+
+typedef itk::MutexLockHolder<itk::SimpleFastMutexLock> StripeLockHolder;
+
+namespace
+{
+// Larger post coordinates do not fit in the tile keys
+const double MaximumPostCoordinate = 1e12;
+
+// Floor division of a post coordinate by the tile size
+inline long long TileCoordinate(long long post)
+{
+  const long long size = DEMTileCache::TileSize;
+  return post >= 0 ? post / size : -((-post - 1) / size) - 1;
+}
+}
+
+DEMTileCache
+::DEMTileCache(const SampleFunctionType & sample)
+  : m_Sample(sample),
+    m_PostSpacing(1.0 / 3600.0),
+    m_Enabled(false)
+{
+}
+
+DEMTileCache
+::~DEMTileCache()
+{
+}
+
+double
+DEMTileCache
+::GetHeight(double lon, double lat)
+{
+  double height;
+  this->GetHeights(&lon, &lat, &height, 1);
+  return height;
+}
+
+void
+DEMTileCache
+::GetHeights(const double * lon, const double * lat, double * heights, size_t count)
+{
+  if (!m_Enabled)
+    {
+    for (size_t k = 0; k < count; ++k)
+      {
+      heights[k] = m_Sample(lon[k], lat[k]);
+      }
+    return;
+    }
+
+  // The tile of the previous point, looked up again only when the
+  // points leave it
+  TileKey         currentKey;
+  TilePointerType current;
+
+  for (size_t k = 0; k < count; ++k)
+    {
+    const double u = lon[k] / m_PostSpacing;
+    const double v = lat[k] / m_PostSpacing;
+
+    if (!(std::abs(u) < MaximumPostCoordinate && std::abs(v) < MaximumPostCoordinate))
+      {
+      heights[k] = m_Sample(lon[k], lat[k]);
+      continue;
+      }
+
+    const long long i = static_cast<long long>(std::floor(u));
+    const long long j = static_cast<long long>(std::floor(v));
+    const TileKey key(TileCoordinate(i), TileCoordinate(j));
+
+    if (!current || !(key == currentKey))
+      {
+      current = this->GetTile(key);
+      currentKey = key;
+      }
+
+    const double height = Interpolate(*current,
+                                      i - key.x * TileSize, j - key.y * TileSize,
+                                      u - i, v - j);
+
+    // Invalid posts around the point: let the sample function decide
+    heights[k] = std::isnan(height) ? m_Sample(lon[k], lat[k]) : height;
+    }
+}
+
+double
+DEMTileCache
+::Interpolate(const TileType & tile, long long i, long long j, double dx, double dy)
+{
+  const size_t stride = TileSize + 1;
+  const double * post = &tile[static_cast<size_t>(j) * stride + static_cast<size_t>(i)];
+
+  // NaN posts give a NaN height, even with a null weight
+  return (1. - dy) * ((1. - dx) * post[0] + dx * post[1])
+         + dy * ((1. - dx) * post[stride] + dx * post[stride + 1]);
+}
+
+DEMTileCache::Stripe &
+DEMTileCache
+::GetStripe(const TileKey & key)
+{
+  const size_t hash = static_cast<size_t>(key.x) * 31 + static_cast<size_t>(key.y);
+  return m_Stripes[hash % NumberOfStripes];
+}
+
+DEMTileCache::TilePointerType
+DEMTileCache
+::GetTile(const TileKey & key)
+{
+  Stripe & stripe = this->GetStripe(key);
+  unsigned long long generation = 0;
+
+  {
+  StripeLockHolder lock(stripe.lock);
+  EntryMapType::iterator it = stripe.index.find(key);
+  if (it != stripe.index.end())
+    {
+    // Move the entry to the front of the LRU list
+    stripe.entries.splice(stripe.entries.begin(), stripe.entries, it->second);
+    return it->second->tile;
+    }
+  generation = stripe.generation;
+  }
+
+  // Sampled without the lock, so that the other threads keep on reading
+  // the cached tiles of this stripe
+  TilePointerType tile = this->LoadTile(key);
+  const unsigned long long bytes = tile->size() * sizeof(double);
+
+  StripeLockHolder lock(stripe.lock);
+  ++stripe.loaded;
+
+  if (generation != stripe.generation || bytes > stripe.capacity)
+    {
+    // Cleared in the meantime, or too large: used for this call only
+    return tile;
+    }
+
+  EntryMapType::iterator it = stripe.index.find(key);
+  if (it != stripe.index.end())
+    {
+    // Already sampled by another thread
+    stripe.entries.splice(stripe.entries.begin(), stripe.entries, it->second);
+    return it->second->tile;
+    }
+
+  Entry entry;
+  entry.key = key;
+  entry.tile = tile;
+  stripe.entries.push_front(entry);
+  stripe.index[key] = stripe.entries.begin();
+  stripe.size += bytes;
+
+  EvictUnsafe(stripe);
+
+  return tile;
+}
+
+DEMTileCache::TilePointerType
+DEMTileCache
+::LoadTile(const TileKey & key) const
+{
+  const size_t stride = TileSize + 1;
+  std::shared_ptr<TileType> tile = std::make_shared<TileType>(stride * stride);
+
+  for (size_t r = 0; r < stride; ++r)
+    {
+    const double lat = static_cast<double>(key.y * TileSize + static_cast<long long>(r)) * m_PostSpacing;
+    for (size_t c = 0; c < stride; ++c)
+      {
+      const double lon = static_cast<double>(key.x * TileSize + static_cast<long long>(c)) * m_PostSpacing;
+      (*tile)[r * stride + c] = m_Sample(lon, lat);
+      }
+    }
+
+  return tile;
+}
+
+void
+DEMTileCache
+::EvictUnsafe(Stripe & stripe)
+{
+  while (stripe.size > stripe.capacity && !stripe.entries.empty())
+    {
+    const Entry & last = stripe.entries.back();
+    stripe.size -= last.tile->size() * sizeof(double);
+    stripe.index.erase(last.key);
+    stripe.entries.pop_back();
+    }
+}
+
+void
+DEMTileCache
+::Clear()
+{
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    stripe.entries.clear();
+    stripe.index.clear();
+    stripe.size = 0;
+    ++stripe.generation;
+    }
+}
+
+void
+DEMTileCache
+::SetCapacity(unsigned long long capacity)
+{
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    stripe.capacity = capacity / NumberOfStripes;
+    EvictUnsafe(stripe);
+    }
+  m_Enabled = capacity > 0;
+}
+
+unsigned long long
+DEMTileCache
+::GetCapacity() const
+{
+  unsigned long long capacity = 0;
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    const Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    capacity += stripe.capacity;
+    }
+  return capacity;
+}
+
+bool
+DEMTileCache
+::IsEnabled() const
+{
+  return m_Enabled;
+}
+
+void
+DEMTileCache
+::SetPostSpacing(double spacing)
+{
+  m_PostSpacing = spacing;
+  this->Clear();
+}
+
+double
+DEMTileCache
+::GetPostSpacing() const
+{
+  return m_PostSpacing;
+}
+
+unsigned long long
+DEMTileCache
+::GetSize() const
+{
+  unsigned long long size = 0;
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    const Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    size += stripe.size;
+    }
+  return size;
+}
+
+unsigned long long
+DEMTileCache
+::GetNumberOfLoadedTiles() const
+{
+  unsigned long long loaded = 0;
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    const Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    loaded += stripe.loaded;
+    }
+  return loaded;
+}
+
+void
+DEMTileCache
+::ResetCounters()
+{
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    stripe.loaded = 0;
+    }
+}
+
+} // end namespace otb
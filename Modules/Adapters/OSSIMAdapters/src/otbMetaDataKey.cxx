@@ -57,6 +57,7 @@ char const* VectorDataKeywordlistDelimiterKey = "VectorDataKeywordlistDelimiter"
 char const* ResolutionFactor = "ResolutionFactor";
 char const* SubDatasetIndex = "SubDatasetIndex";
 char const* CacheSizeInBytes = "CacheSizeInBytes";
+char const* PrefetchDepth = "PrefetchDepth";
 
 char const* TileHintX = "TileHintX";
 char const* TileHintY = "TileHintY";
@@ -92,6 +93,7 @@ const MetaDataKey::KeyTypeDef Types[] =
   MetaDataKey::KeyTypeDef(MetaDataKey::ResolutionFactor,                  MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::SubDatasetIndex,                   MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::CacheSizeInBytes,                  MetaDataKey::TENTIER),
+  MetaDataKey::KeyTypeDef(MetaDataKey::PrefetchDepth,                     MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::TileHintX,                         MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::TileHintY,                         MetaDataKey::TENTIER),
   MetaDataKey::KeyTypeDef(MetaDataKey::NoDataValueAvailable,              MetaDataKey::TVECTOR),
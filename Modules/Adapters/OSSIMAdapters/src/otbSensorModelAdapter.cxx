@@ -22,9 +22,11 @@
 #include "otbSensorModelAdapter.h"
 
 #include <cassert>
+#include <cmath>
 
 #include "otbMacro.h"
 #include "otbImageKeywordlist.h"
+#include "itkMutexLockHolder.h"
 
 #if defined(__GNUC__) || defined(__clang__)
 #pragma GCC diagnostic push
@@ -35,6 +37,7 @@
 #include "ossim/projection/ossimSensorModelFactory.h"
 #include "ossim/projection/ossimSensorModel.h"
 #include "ossim/projection/ossimRpcProjection.h"
+#include "ossim/projection/ossimRpcModel.h"
 #include "ossim/ossimPluginProjectionFactory.h"
 #include "ossim/base/ossimTieGptSet.h"
 
@@ -44,6 +47,7 @@
 #include "ossim/projection/ossimSensorModelFactory.h"
 #include "ossim/projection/ossimSensorModel.h"
 #include "ossim/projection/ossimRpcProjection.h"
+#include "ossim/projection/ossimRpcModel.h"
 #include "ossim/ossimPluginProjectionFactory.h"
 #include "ossim/base/ossimTieGptSet.h"
 
@@ -53,6 +57,113 @@
 namespace otb
 {
 
+struct SensorModelAdapter::RPCModel
+{
+  explicit RPCModel(const ossimRpcModel::rpcModelStruct & params);
+
+  /** Line and sample of count points, in the OSSIM frame */
+  void Evaluate(const double* lon, const double* lat, const double* h,
+                double* line, double* samp, size_t count) const;
+
+  /** True if the polynomials give the same image points as model over
+   *  the validity domain of the RPC */
+  bool Matches(const ossimProjection & model) const;
+
+  double lineOffset, sampOffset, latOffset, lonOffset, hgtOffset;
+  double lineScale, sampScale, latScale, lonScale, hgtScale;
+
+  /** Sample numerator, sample denominator, line numerator and line
+   *  denominator coefficients, with the terms in the order of the 'B'
+   *  polynomial format */
+  double coefficients[4][20];
+};
+
+SensorModelAdapter::RPCModel
+::RPCModel(const ossimRpcModel::rpcModelStruct & params)
+  : lineOffset(params.lineOffset), sampOffset(params.sampOffset),
+    latOffset(params.latOffset), lonOffset(params.lonOffset), hgtOffset(params.hgtOffset),
+    lineScale(params.lineScale), sampScale(params.sampScale),
+    latScale(params.latScale), lonScale(params.lonScale), hgtScale(params.hgtScale)
+{
+  // Position in the 'B' format of the terms of the 'A' format
+  static const unsigned int AToB[20] =
+    {0, 1, 2, 3, 4, 5, 6, 10, 7, 8, 9, 11, 14, 17, 12, 15, 18, 13, 16, 19};
+
+  const double* source[4] = {params.sampNumCoef, params.sampDenCoef, params.lineNumCoef, params.lineDenCoef};
+
+  for (unsigned int c = 0; c < 4; ++c)
+    {
+    for (unsigned int i = 0; i < 20; ++i)
+      {
+      const unsigned int j = (params.type == 'A') ? AToB[i] : i;
+      coefficients[c][j] = source[c][i];
+      }
+    }
+}
+
+void
+SensorModelAdapter::RPCModel
+::Evaluate(const double* lon, const double* lat, const double* h,
+           double* line, double* samp, size_t count) const
+{
+  // No branch nor call in the loop, so that the compiler can vectorize it
+  for (size_t k = 0; k < count; ++k)
+    {
+    const double P = (lat[k] - latOffset) / latScale;
+    const double L = (lon[k] - lonOffset) / lonScale;
+    const double H = std::isnan(h[k]) ? -hgtOffset / hgtScale : (h[k] - hgtOffset) / hgtScale;
+
+    const double terms[20] =
+      {1., L, P, H, L*P, L*H, P*H, L*L, P*P, H*H,
+       L*P*H, L*L*L, L*P*P, L*H*H, L*L*P, P*P*P, P*H*H, L*L*H, P*P*H, H*H*H};
+
+    double values[4] = {0., 0., 0., 0.};
+    for (unsigned int c = 0; c < 4; ++c)
+      {
+      for (unsigned int i = 0; i < 20; ++i)
+        {
+        values[c] += coefficients[c][i] * terms[i];
+        }
+      }
+
+    samp[k] = values[0] / values[1] * sampScale + sampOffset;
+    line[k] = values[2] / values[3] * lineScale + lineOffset;
+    }
+}
+
+bool
+SensorModelAdapter::RPCModel
+::Matches(const ossimProjection & model) const
+{
+  // Adjustments, derived models or an unknown polynomial format would
+  // show up on the corners and the centre of the validity domain
+  for (int i = -1; i <= 1; ++i)
+    {
+    for (int j = -1; j <= 1; ++j)
+      {
+      for (int k = -1; k <= 1; ++k)
+        {
+        const double lon = lonOffset + i * lonScale;
+        const double lat = latOffset + j * latScale;
+        const double h = hgtOffset + k * hgtScale;
+
+        ossimGpt ossimGPoint(lat, lon, h);
+        ossimDpt ossimDPoint;
+        model.worldToLineSample(ossimGPoint, ossimDPoint);
+
+        double line, samp;
+        this->Evaluate(&lon, &lat, &h, &line, &samp, 1);
+
+        if (!(std::abs(line - ossimDPoint.y) < 1e-6 && std::abs(samp - ossimDPoint.x) < 1e-6))
+          {
+          return false;
+          }
+        }
+      }
+    }
+  return true;
+}
+
 SensorModelAdapter::SensorModelAdapter():
   m_SensorModel(nullptr), m_TiePoints(nullptr) // FIXME keeping the original value but...
 {
@@ -62,6 +173,10 @@ SensorModelAdapter::SensorModelAdapter():
 
 SensorModelAdapter::~SensorModelAdapter()
 {
+  for (std::vector<InternalMapProjectionPointer>::iterator it = m_ModelPool.begin(); it != m_ModelPool.end(); ++it)
+    {
+    delete *it;
+    }
   delete m_SensorModel;
   delete m_TiePoints;
 }
@@ -79,6 +194,8 @@ void SensorModelAdapter::CreateProjection(const ImageKeywordlist& image_kwl)
     {
     m_SensorModel = ossimplugins::ossimPluginProjectionFactory::instance()->createProjection(geom);
     }
+
+  this->ModelChanged();
 }
 
 bool SensorModelAdapter::IsValidSensorModel() const
@@ -166,6 +283,165 @@ void SensorModelAdapter::InverseTransformPoint(double lon, double lat,
   z = ossimGPoint.height();
 }
 
+void SensorModelAdapter::ForwardTransformPoints(const double* x, const double* y, const double* z,
+                                                double* lon, double* lat, double* h, size_t count) const
+{
+  if (this->m_SensorModel == nullptr)
+    {
+    itkExceptionMacro(<< "ForwardTransformPoints(): Invalid sensor model (m_SensorModel pointer is null)");
+    }
+
+  InternalMapProjectionPointer model = this->AcquireModel();
+  for (size_t k = 0; k < count; ++k)
+    {
+    ossimDpt ossimPoint( internal::ConvertToOSSIMFrame(x[k]),
+                         internal::ConvertToOSSIMFrame(y[k]));
+    ossimGpt ossimGPoint;
+
+    model->lineSampleHeightToWorld(ossimPoint, z[k], ossimGPoint);
+
+    lon[k] = ossimGPoint.lon;
+    lat[k] = ossimGPoint.lat;
+    h[k] = ossimGPoint.hgt;
+    }
+  this->ReleaseModel(model);
+}
+
+void SensorModelAdapter::ForwardTransformPoints(const double* x, const double* y,
+                                                double* lon, double* lat, double* h, size_t count) const
+{
+  if (this->m_SensorModel == nullptr)
+    {
+    itkExceptionMacro(<< "ForwardTransformPoints(): Invalid sensor model (m_SensorModel pointer is null)");
+    }
+
+  InternalMapProjectionPointer model = this->AcquireModel();
+  for (size_t k = 0; k < count; ++k)
+    {
+    ossimDpt ossimPoint( internal::ConvertToOSSIMFrame(x[k]),
+                         internal::ConvertToOSSIMFrame(y[k]));
+    ossimGpt ossimGPoint;
+
+    model->lineSampleToWorld(ossimPoint, ossimGPoint);
+
+    lon[k] = ossimGPoint.lon;
+    lat[k] = ossimGPoint.lat;
+    h[k] = ossimGPoint.hgt;
+    }
+  this->ReleaseModel(model);
+}
+
+void SensorModelAdapter::InverseTransformPoints(const double* lon, const double* lat, const double* h,
+                                                double* x, double* y, double* z, size_t count) const
+{
+  if (this->m_SensorModel == nullptr)
+    {
+    itkExceptionMacro(<< "InverseTransformPoints(): Invalid sensor model (m_SensorModel pointer is null)");
+    }
+
+  if (m_RPCModel)
+    {
+    m_RPCModel->Evaluate(lon, lat, h, y, x, count);
+    for (size_t k = 0; k < count; ++k)
+      {
+      x[k] = internal::ConvertFromOSSIMFrame(x[k]);
+      y[k] = internal::ConvertFromOSSIMFrame(y[k]);
+      z[k] = h[k];
+      }
+    return;
+    }
+
+  InternalMapProjectionPointer model = this->AcquireModel();
+  for (size_t k = 0; k < count; ++k)
+    {
+    ossimGpt ossimGPoint(lat[k], lon[k], h[k]);
+    ossimDpt ossimDPoint;
+
+    model->worldToLineSample(ossimGPoint, ossimDPoint);
+
+    x[k] = internal::ConvertFromOSSIMFrame(ossimDPoint.x);
+    y[k] = internal::ConvertFromOSSIMFrame(ossimDPoint.y);
+    z[k] = ossimGPoint.height();
+    }
+  this->ReleaseModel(model);
+}
+
+void SensorModelAdapter::InverseTransformPoints(const double* lon, const double* lat,
+                                                double* x, double* y, double* z, size_t count) const
+{
+  // Get elevations from DEMHandler
+  std::vector<double> h(count);
+  m_DEMHandler->GetHeightAboveEllipsoid(lon, lat, h.data(), count);
+
+  this->InverseTransformPoints(lon, lat, h.data(), x, y, z, count);
+}
+
+bool SensorModelAdapter::HasFastRPCModel() const
+{
+  return m_RPCModel != nullptr;
+}
+
+SensorModelAdapter::InternalMapProjectionPointer SensorModelAdapter::AcquireModel() const
+{
+  {
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_ModelPoolLock);
+  if (!m_ModelPool.empty())
+    {
+    InternalMapProjectionPointer model = m_ModelPool.back();
+    m_ModelPool.pop_back();
+    return model;
+    }
+  }
+
+  ossimObject * clone = m_SensorModel->dup();
+  InternalMapProjectionPointer model = dynamic_cast<InternalMapProjectionPointer>(clone);
+  if (model == nullptr)
+    {
+    // Not reentrant, as the single point methods
+    delete clone;
+    return m_SensorModel;
+    }
+  return model;
+}
+
+void SensorModelAdapter::ReleaseModel(InternalMapProjectionPointer model) const
+{
+  if (model == m_SensorModel)
+    {
+    return;
+    }
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_ModelPoolLock);
+  m_ModelPool.push_back(model);
+}
+
+void SensorModelAdapter::ModelChanged()
+{
+  {
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_ModelPoolLock);
+  for (std::vector<InternalMapProjectionPointer>::iterator it = m_ModelPool.begin(); it != m_ModelPool.end(); ++it)
+    {
+    delete *it;
+    }
+  m_ModelPool.clear();
+  }
+
+  m_RPCModel.reset();
+
+  ossimRpcModel * rpcModel = dynamic_cast<ossimRpcModel *>(m_SensorModel);
+  if (rpcModel != nullptr)
+    {
+    ossimRpcModel::rpcModelStruct params;
+    rpcModel->getRpcParameters(params);
+
+    std::unique_ptr<RPCModel> fastModel(new RPCModel(params));
+    if (fastModel->Matches(*m_SensorModel))
+      {
+      m_RPCModel = std::move(fastModel);
+      }
+    otbMsgDevMacro(<< "RPC model evaluated " << (m_RPCModel ? "directly" : "by OSSIM"));
+    }
+}
+
 void SensorModelAdapter::AddTiePoint(double x, double y, double z, double lon, double lat)
 {
   // Create the tie point
@@ -224,6 +500,8 @@ double SensorModelAdapter::Optimize()
       // Call optimize fit
       precision  = simpleRpcModel->optimizeFit(*m_TiePoints);
       }
+
+    this->ModelChanged();
     }
 
   // Return the precision
@@ -243,6 +521,8 @@ bool SensorModelAdapter::ReadGeomFile(const std::string & infile)
     m_SensorModel = ossimplugins::ossimPluginProjectionFactory::instance()->createProjection(geom);
     }
 
+  this->ModelChanged();
+
   // otbMsgDevMacro(<< "ReadGeomFile("<<geom<<") -> " << m_SensorModel);
   return (m_SensorModel != nullptr);
 }
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "itkMacro.h"
+#include "otbDEMTileCache.h"
+#include "otbDEMHandler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#pragma GCC diagnostic ignored "-Woverloaded-virtual"
+#pragma GCC diagnostic ignored "-Wshadow"
+#include "ossim/elevation/ossimElevManager.h"
+#include "ossim/base/ossimGpt.h"
+#pragma GCC diagnostic pop
+#else
+#include "ossim/elevation/ossimElevManager.h"
+#include "ossim/base/ossimGpt.h"
+#endif
+
+namespace
+{
+// Height of the posts of a synthetic DEM with a post every 3 arc seconds
+double PostHeight(double i, double j)
+{
+  if (i == 100 && j == 100)
+    {
+    return std::numeric_limits<double>::quiet_NaN();
+    }
+  return 100. * std::sin(0.1 * i) + 50. * std::cos(0.07 * j);
+}
+
+// Bilinear interpolation of the synthetic DEM, NaN next to the hole
+double SyntheticHeight(double lon, double lat)
+{
+  const double u = lon * 1200.;
+  const double v = lat * 1200.;
+  const double i = std::floor(u);
+  const double j = std::floor(v);
+  const double dx = u - i;
+  const double dy = v - j;
+  return (1. - dy) * ((1. - dx) * PostHeight(i, j) + dx * PostHeight(i + 1, j))
+         + dy * ((1. - dx) * PostHeight(i, j + 1) + dx * PostHeight(i + 1, j + 1));
+}
+}
+
+int otbDEMTileCacheTest(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  otb::DEMTileCache cache(SyntheticHeight);
+  bool fail = false;
+
+  // Disabled cache: every height is sampled
+  cache.SetCapacity(0);
+  if (cache.IsEnabled() || cache.GetHeight(0.01, 0.02) != SyntheticHeight(0.01, 0.02)
+      || cache.GetNumberOfLoadedTiles() != 0)
+    {
+    std::cerr << "Disabled cache should sample the heights directly" << std::endl;
+    fail = true;
+    }
+
+  cache.SetCapacity(16 * 1024 * 1024);
+
+  // Lines of points across several tiles, around the origin and the hole
+  std::vector<double> lon, lat;
+  for (double y = -0.05; y < 0.12; y += 0.000731)
+    {
+    for (double x = -0.05; x < 0.12; x += 0.000617)
+      {
+      lon.push_back(x);
+      lat.push_back(y);
+      }
+    }
+
+  std::vector<double> heights(lon.size());
+  cache.GetHeights(lon.data(), lat.data(), heights.data(), lon.size());
+
+  double maxError = 0.;
+  for (size_t k = 0; k < lon.size(); ++k)
+    {
+    const double expected = SyntheticHeight(lon[k], lat[k]);
+    if (std::isnan(expected) != std::isnan(heights[k]))
+      {
+      std::cerr << "Validity differs at (" << lon[k] << ", " << lat[k] << ")" << std::endl;
+      fail = true;
+      break;
+      }
+    if (!std::isnan(expected))
+      {
+      maxError = std::max(maxError, std::abs(heights[k] - expected));
+      }
+    const double single = cache.GetHeight(lon[k], lat[k]);
+    if (single != heights[k] && !(std::isnan(single) && std::isnan(heights[k])))
+      {
+      std::cerr << "GetHeight() and GetHeights() differ at (" << lon[k] << ", " << lat[k] << ")" << std::endl;
+      fail = true;
+      break;
+      }
+    }
+
+  std::cout << lon.size() << " points, " << cache.GetNumberOfLoadedTiles() << " tiles loaded, "
+            << cache.GetSize() << " bytes cached, maximum error " << maxError << std::endl;
+
+  if (maxError > 1e-9)
+    {
+    std::cerr << "Cached heights differ from the sampled heights: " << maxError << std::endl;
+    fail = true;
+    }
+
+  // Points next to the hole are sampled directly
+  if (!std::isnan(cache.GetHeight(100.5 / 1200., 100.5 / 1200.))
+      || std::isnan(cache.GetHeight(102.5 / 1200., 100.5 / 1200.)))
+    {
+    std::cerr << "Only the heights next to an invalid post should be invalid" << std::endl;
+    fail = true;
+    }
+
+  // Tiles are loaded once
+  const unsigned long long loaded = cache.GetNumberOfLoadedTiles();
+  cache.GetHeights(lon.data(), lat.data(), heights.data(), lon.size());
+  if (cache.GetNumberOfLoadedTiles() != loaded)
+    {
+    std::cerr << "Cached tiles should not be loaded again" << std::endl;
+    fail = true;
+    }
+
+  cache.Clear();
+  if (cache.GetSize() != 0)
+    {
+    std::cerr << "Clear() should remove all the tiles" << std::endl;
+    fail = true;
+    }
+
+  // A cache holding a single tile per stripe still gives the same heights
+  cache.SetCapacity(otb::DEMTileCache::NumberOfStripes * (otb::DEMTileCache::TileSize + 1)
+                    * (otb::DEMTileCache::TileSize + 1) * sizeof(double));
+  std::vector<double> evicted(lon.size());
+  cache.GetHeights(lon.data(), lat.data(), evicted.data(), lon.size());
+  bool same = true;
+  for (size_t k = 0; k < lon.size(); ++k)
+    {
+    same = same && (evicted[k] == heights[k] || (std::isnan(evicted[k]) && std::isnan(heights[k])));
+    }
+  if (!same)
+    {
+    std::cerr << "Heights differ after eviction" << std::endl;
+    fail = true;
+    }
+
+  return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int otbDEMHandlerTileCacheTest(int argc, char * argv[])
+{
+  if (argc != 8)
+    {
+    std::cerr << "Usage: " << argv[0] << " demdir geoid longitude latitude width height tolerance" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const double longitude = atof(argv[3]);
+  const double latitude = atof(argv[4]);
+  const double width = atof(argv[5]);
+  const double height = atof(argv[6]);
+  const double tolerance = atof(argv[7]);
+
+  otb::DEMHandler::Pointer demHandler = otb::DEMHandler::Instance();
+  demHandler->OpenDEMDirectory(argv[1]);
+  demHandler->OpenGeoidFile(argv[2]);
+
+  std::vector<double> lon, lat;
+  for (double y = latitude; y < latitude + height; y += height / 97.)
+    {
+    for (double x = longitude; x < longitude + width; x += width / 103.)
+      {
+      lon.push_back(x);
+      lat.push_back(y);
+      }
+    }
+
+  // Heights from ossim
+  const unsigned long long capacity = demHandler->GetTileCacheCapacity();
+  demHandler->SetTileCacheCapacity(0);
+  std::vector<double> reference(lon.size());
+  for (size_t k = 0; k < lon.size(); ++k)
+    {
+    reference[k] = demHandler->GetHeightAboveEllipsoid(lon[k], lat[k]);
+    }
+
+  // Heights from the cache
+  demHandler->SetTileCacheCapacity(capacity > 0 ? capacity : 64 * 1024 * 1024);
+  std::vector<double> cached(lon.size());
+  demHandler->GetHeightAboveEllipsoid(lon.data(), lat.data(), cached.data(), lon.size());
+
+  double maxError = 0.;
+  for (size_t k = 0; k < lon.size(); ++k)
+    {
+    if (std::isnan(reference[k]) != std::isnan(cached[k]))
+      {
+      std::cerr << "Validity differs at (" << lon[k] << ", " << lat[k] << ")" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (!std::isnan(reference[k]))
+      {
+      maxError = std::max(maxError, std::abs(reference[k] - cached[k]));
+      }
+    }
+
+  std::cout << lon.size() << " points, maximum error " << maxError << " meters" << std::endl;
+
+  if (maxError > tolerance)
+    {
+    std::cerr << "Maximum error (" << maxError << " meters) > tolerance (" << tolerance << " meters)" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
+
+int otbDEMHandlerNoTileCacheTest(int argc, char * argv[])
+{
+  if (argc != 6)
+    {
+    std::cerr << "Usage: " << argv[0] << " demdir longitude latitude width height" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const double longitude = atof(argv[2]);
+  const double latitude = atof(argv[3]);
+  const double width = atof(argv[4]);
+  const double height = atof(argv[5]);
+
+  otb::DEMHandler::Pointer demHandler = otb::DEMHandler::Instance();
+
+  // The cache resamples DEMs whose posts are not on the arc second grid:
+  // it must be off unless requested
+  if (demHandler->GetTileCacheCapacity() != 0)
+    {
+    std::cerr << "The tile cache should be disabled by default, its capacity is "
+              << demHandler->GetTileCacheCapacity() << " bytes" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  demHandler->OpenDEMDirectory(argv[1]);
+
+  std::vector<double> lon, lat;
+  for (double y = latitude; y < latitude + height; y += height / 97.)
+    {
+    for (double x = longitude; x < longitude + width; x += width / 103.)
+      {
+      lon.push_back(x);
+      lat.push_back(y);
+      }
+    }
+
+  std::vector<double> heights(lon.size());
+  demHandler->GetHeightAboveEllipsoid(lon.data(), lat.data(), heights.data(), lon.size());
+
+  // Heights are exactly the ones of ossim
+  for (size_t k = 0; k < lon.size(); ++k)
+    {
+    ossimGpt point;
+    point.lon = lon[k];
+    point.lat = lat[k];
+    const double reference = ossimElevManager::instance()->getHeightAboveEllipsoid(point);
+    const double single = demHandler->GetHeightAboveEllipsoid(lon[k], lat[k]);
+
+    const bool sameBatch = heights[k] == reference || (std::isnan(heights[k]) && std::isnan(reference));
+    const bool sameSingle = single == reference || (std::isnan(single) && std::isnan(reference));
+    if (!sameBatch || !sameSingle)
+      {
+      std::cerr << "Height at (" << lon[k] << ", " << lat[k] << ") is " << heights[k] << " (batch), "
+                << single << " (single), expected " << reference << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << lon.size() << " points, heights unchanged" << std::endl;
+
+  return EXIT_SUCCESS;
+}
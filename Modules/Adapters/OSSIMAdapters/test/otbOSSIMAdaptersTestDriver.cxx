@@ -28,6 +28,9 @@ void RegisterTests()
   REGISTER_TEST(otbOssimElevManagerTest2);
   REGISTER_TEST(otbOssimElevManagerTest4);
   REGISTER_TEST(otbDEMHandlerTest);
+  REGISTER_TEST(otbDEMTileCacheTest);
+  REGISTER_TEST(otbDEMHandlerTileCacheTest);
+  REGISTER_TEST(otbDEMHandlerNoTileCacheTest);
   REGISTER_TEST(otbRPCSolverAdapterTest);
   REGISTER_TEST(otbSarSensorModelAdapterTest);
 }
@@ -26,6 +26,7 @@
 #include "otbStreamingShrinkImageFilter.h"
 #include "itkListSample.h"
 #include "otbListSampleToHistogramListGenerator.h"
+#include "otbStreamingQuantilesVectorImageFilter.h"
 #include "itkImageRegionConstIterator.h"
 
 #include "otbImageListToVectorImageFilter.h"
@@ -80,6 +81,9 @@ public:
 
   typedef StreamingShrinkImageFilter<UInt8ImageType, UInt8ImageType> UInt8ShrinkFilterType;
 
+  typedef StreamingQuantilesVectorImageFilter<FloatVectorImageType,
+    UInt8ImageType> QuantilesFilterType;
+
   typedef Functor::LogFunctor<FloatVectorImageType::InternalPixelType> TransferLogFunctor;
   typedef UnaryImageFunctorWithVectorImageFilter<FloatVectorImageType,
     FloatVectorImageType,
@@ -161,6 +165,13 @@ private:
     SetDefaultParameterFloat("quantile.low", 2.0);
     DisableParameter("quantile.low");
 
+    AddParameter(ParameterType_Bool, "quantile.fullres",
+      "Full resolution quantiles");
+    SetParameterDescription("quantile.fullres",
+      "If activated, the quantiles are estimated on the full resolution "
+      "image in a single streaming pass, with mergeable quantile sketches, "
+      "instead of the histogram of a quicklook of 1000 pixels square at most");
+
     AddParameter(ParameterType_Choice, "channels", "Channels selection");
     SetParameterDescription("channels", "It's possible to select the channels "
       "of the output image. There are 3 modes, the available choices are:");
@@ -240,29 +251,48 @@ private:
     }
   }
 
-  template<class TImageType>
-  void GenericDoExecute()
+  // Estimate the quantiles on the histogram of a quicklook
+  void ComputeQuicklookQuantiles(FloatVectorImageType * image,
+    FloatVectorImageType::PixelType & inputMin,
+    FloatVectorImageType::PixelType & inputMax)
   {
-    // Clear previously registered filters
-    m_Filters.clear();
-
-    std::string rescaleType = this->GetParameterString("type");
-    typedef otb::VectorRescaleIntensityImageFilter<FloatVectorImageType, TImageType> RescalerType;
-    typename RescalerType::Pointer rescaler = RescalerType::New();
-
-    // selected channel
-    auto tempImage = GetSelectedChannels<FloatVectorImageType>();
-
-    const unsigned int nbComp(tempImage->GetNumberOfComponentsPerPixel());
+    const unsigned int nbComp(image->GetNumberOfComponentsPerPixel());
 
     // We need to subsample the input image in order to estimate its histogram
     // Shrink factor is computed so as to load a quicklook of 1000
     // pixels square at most
-    auto imageSize = tempImage->GetLargestPossibleRegion().GetSize();
+    auto imageSize = image->GetLargestPossibleRegion().GetSize();
     unsigned int shrinkFactor = std::max({int(imageSize[0])/1000, 
       int(imageSize[1])/1000, 1});
     otbAppLogDEBUG( << "Shrink factor used to compute Min/Max: "<<shrinkFactor );
 
+    // Decode the closest coarser level of the file (overview or JPEG2000
+    // resolution level) instead of the full resolution. The mask is
+    // shrunk on the full resolution grid, so it is not used with a mask.
+    FloatVectorImageType::Pointer quicklookInput = image;
+    unsigned int resolutionFactor = 0;
+    if (!IsParameterEnabled("mask"))
+      {
+      FloatVectorImageType * nativeImage =
+        GetParameterImageAtNativeResolution("in", shrinkFactor, resolutionFactor);
+      if (resolutionFactor > 0)
+        {
+        shrinkFactor /= 1u << resolutionFactor;
+        otbAppLogDEBUG( << "Reading resolution level " << resolutionFactor
+                        << ", remaining shrink factor: " << shrinkFactor );
+
+        quicklookInput = GetSelectedChannels<FloatVectorImageType>(nativeImage);
+        if (GetParameterString("type") == "log2")
+          {
+          TransferLogType::Pointer transferLog = TransferLogType::New();
+          m_Filters.push_back(transferLog.GetPointer());
+          transferLog->SetInput(quicklookInput);
+          transferLog->UpdateOutputInformation();
+          quicklookInput = transferLog->GetOutput();
+          }
+        }
+      }
+
     otbAppLogDEBUG( << "Shrink starts..." );
     typename ShrinkFilterType::Pointer shrinkFilter = ShrinkFilterType::New();
     shrinkFilter->SetShrinkFactor(shrinkFactor);
@@ -271,23 +301,8 @@ private:
     AddProcess(shrinkFilter->GetStreamer(), 
       "Computing shrink Image for min/max estimation...");
 
-    if ( rescaleType == "log2")
-    {
-      //define the transfer log
-      m_TransferLog = TransferLogType::New();
-      m_TransferLog->SetInput(tempImage);
-      m_TransferLog->UpdateOutputInformation();
-
-      shrinkFilter->SetInput(m_TransferLog->GetOutput());
-      rescaler->SetInput(m_TransferLog->GetOutput());
-      shrinkFilter->Update();
-    }
-    else
-    {
-      shrinkFilter->SetInput(tempImage);
-      rescaler->SetInput(tempImage);
-      shrinkFilter->Update();
-    }
+    shrinkFilter->SetInput(quicklookInput);
+    shrinkFilter->Update();
 
     otbAppLogDEBUG( << "Evaluating input Min/Max..." );
     itk::ImageRegionConstIterator<FloatVectorImageType>
@@ -295,8 +310,7 @@ private:
         shrinkFilter->GetOutput()->GetLargestPossibleRegion());
 
     typename ListSampleType::Pointer listSample = ListSampleType::New();
-    listSample->SetMeasurementVectorSize( 
-      tempImage->GetNumberOfComponentsPerPixel());
+    listSample->SetMeasurementVectorSize(nbComp);
 
     // Now we generate the list of samples
     if (IsParameterEnabled("mask"))
@@ -353,7 +367,6 @@ private:
     assert(histOutput);
 
     // And extract the lower and upper quantile
-    typename FloatVectorImageType::PixelType inputMin(nbComp), inputMax(nbComp);
     for(unsigned int i = 0; i < nbComp; ++i)
     {
       auto && elm = histOutput->GetNthElement(i);
@@ -363,6 +376,90 @@ private:
       inputMax[i] = elm->Quantile(0, 
         1.0 - 0.01 * GetParameterFloat("quantile.high"));
     }
+  }
+
+  // Estimate the quantiles on the full resolution image, in one pass
+  void ComputeFullResolutionQuantiles(FloatVectorImageType * image,
+    FloatVectorImageType::PixelType & inputMin,
+    FloatVectorImageType::PixelType & inputMax)
+  {
+    QuantilesFilterType::Pointer quantilesFilter = QuantilesFilterType::New();
+    quantilesFilter->SetInput(image);
+    // Samples with nodata values are ignored
+    quantilesFilter->SetNoDataFlag(true);
+    if (IsParameterEnabled("mask"))
+    {
+      quantilesFilter->SetMaskImage(this->GetParameterUInt8Image("mask"));
+    }
+    quantilesFilter->GetStreamer()->
+      SetAutomaticAdaptativeStreaming(GetParameterInt("ram"));
+    AddProcess(quantilesFilter->GetStreamer(),
+      "Computing full resolution quantiles...");
+    quantilesFilter->Update();
+
+    // if all pixels were masked
+    if (IsParameterEnabled("mask") && !quantilesFilter->GetSketches().empty()
+        && quantilesFilter->GetSketches()[0].IsEmpty())
+    {
+      otbAppLogINFO( << "All pixels were masked, the application assume "
+        "a wrong mask and include all the image");
+      quantilesFilter->SetMaskImage(nullptr);
+      quantilesFilter->Update();
+    }
+
+    QuantilesFilterType::RealPixelType low = quantilesFilter->GetQuantiles(
+      0.01 * GetParameterFloat("quantile.low"));
+    QuantilesFilterType::RealPixelType high = quantilesFilter->GetQuantiles(
+      1.0 - 0.01 * GetParameterFloat("quantile.high"));
+    for(unsigned int i = 0; i < low.GetSize(); ++i)
+    {
+      inputMin[i] = low[i];
+      inputMax[i] = high[i];
+    }
+  }
+
+  template<class TImageType>
+  void GenericDoExecute()
+  {
+    // Clear previously registered filters
+    m_Filters.clear();
+
+    std::string rescaleType = this->GetParameterString("type");
+    typedef otb::VectorRescaleIntensityImageFilter<FloatVectorImageType, TImageType> RescalerType;
+    typename RescalerType::Pointer rescaler = RescalerType::New();
+
+    // selected channel
+    auto tempImage = GetSelectedChannels<FloatVectorImageType>(GetParameterImage("in"));
+
+    const unsigned int nbComp(tempImage->GetNumberOfComponentsPerPixel());
+
+    typename FloatVectorImageType::PixelType inputMin(nbComp), inputMax(nbComp);
+
+    if ( rescaleType == "log2")
+    {
+      //define the transfer log
+      m_TransferLog = TransferLogType::New();
+      m_TransferLog->SetInput(tempImage);
+      m_TransferLog->UpdateOutputInformation();
+      rescaler->SetInput(m_TransferLog->GetOutput());
+    }
+    else
+    {
+      rescaler->SetInput(tempImage);
+    }
+
+    if (GetParameterInt("quantile.fullres"))
+    {
+      ComputeFullResolutionQuantiles(rescaleType == "log2" ?
+        m_TransferLog->GetOutput() : tempImage.GetPointer(),
+        inputMin, inputMax);
+    }
+    else
+    {
+      ComputeQuicklookQuantiles(rescaleType == "log2" ?
+        m_TransferLog->GetOutput() : tempImage.GetPointer(),
+        inputMin, inputMax);
+    }
 
     otbAppLogDEBUG( << std::setprecision(5) 
                     << "Min/Max computation done : min=" 
@@ -449,9 +546,9 @@ private:
     return channels;
   }
 
-  // return an image with the bands order modified of the input image
+  // return an image with the bands order modified of the given image
   template<class TImageType>
-  typename TImageType::Pointer GetSelectedChannels()
+  typename TImageType::Pointer GetSelectedChannels(FloatVectorImageType * image)
   {
     typedef MultiToMonoChannelExtractROI<FloatVectorImageType::InternalPixelType,
       typename TImageType::InternalPixelType> ExtractROIFilterType;
@@ -476,7 +573,7 @@ private:
       typename ExtractROIFilterType::Pointer extractROIFilter = 
         ExtractROIFilterType::New();
       m_Filters.push_back(extractROIFilter.GetPointer());
-      extractROIFilter->SetInput(GetParameterImage("in"));
+      extractROIFilter->SetInput(image);
       if (!monoChannel) 
         extractROIFilter->SetChannel(channel);
 
@@ -24,6 +24,8 @@
 #include "otbPerBandVectorImageFilter.h"
 #include "itkDiscreteGaussianImageFilter.h"
 #include "itkShrinkImageFilter.h"
+#include "otbClampImageFilter.h"
+#include "otbPyramidImageFileWriter.h"
 
 
 namespace otb
@@ -93,13 +95,16 @@ private:
 
     AddParameter(ParameterType_Float,  "vfactor", "Variance factor");
     SetDefaultParameterFloat("vfactor", 0.6);
-    SetParameterDescription( "vfactor", "Variance factor use in smoothing. It is multiplied by the subsampling factor of each level in the  pyramid (default is 0.6).");
+    SetParameterDescription( "vfactor", "Variance factor use in smoothing. It is multiplied by the subsampling factor of each level in the  pyramid, or by the remaining one when the level is subsampled from an overview of the input file (default is 0.6).");
 
     // Boolean Fast scheme
     AddParameter(ParameterType_Bool, "fast", "Use Fast Scheme");
     std::ostringstream desc;
     desc<<"If used, this option allows one to speed-up computation by iteratively"
-        <<" subsampling previous level of pyramid instead of processing the full input.";
+        <<" subsampling previous level of pyramid instead of processing the full input."
+        <<" The input is then read once, all the levels being written in a single pass:"
+        <<" each pixel of a level is the mean of the corresponding block of the previous"
+        <<" level, which replaces the gaussian smoothing (the variance factor is ignored).";
     SetParameterDescription("fast", desc.str());
 
     // Doc example parameter settings
@@ -133,13 +138,48 @@ private:
 
     bool fastScheme = GetParameterInt("fast");
 
-    // Get the input image
-    FloatVectorImageType::Pointer inImage = GetParameterImage("in");
-
     // Get the Initial Output Image FileName
     std::string path, fname, ext;
     std::string ofname = GetParameterString("out");
 
+    if(fastScheme)
+      {
+      // All the levels are reduced from the previous one in a single pass
+      // over the input
+      FloatVectorImageType::Pointer inImage = GetParameterImage("in");
+      switch(this->GetParameterOutputImagePixelType("out"))
+        {
+        case ImagePixelType_uint8:
+          WriteLevelsInCascade<UInt8VectorImageType>(inImage, ofname, nbLevels, shrinkFactor);
+          break;
+        case ImagePixelType_int16:
+          WriteLevelsInCascade<Int16VectorImageType>(inImage, ofname, nbLevels, shrinkFactor);
+          break;
+        case ImagePixelType_uint16:
+          WriteLevelsInCascade<UInt16VectorImageType>(inImage, ofname, nbLevels, shrinkFactor);
+          break;
+        case ImagePixelType_int32:
+          WriteLevelsInCascade<Int32VectorImageType>(inImage, ofname, nbLevels, shrinkFactor);
+          break;
+        case ImagePixelType_uint32:
+          WriteLevelsInCascade<UInt32VectorImageType>(inImage, ofname, nbLevels, shrinkFactor);
+          break;
+        case ImagePixelType_float:
+          WriteLevelsInCascade<FloatVectorImageType>(inImage, ofname, nbLevels, shrinkFactor);
+          break;
+        case ImagePixelType_double:
+          WriteLevelsInCascade<DoubleVectorImageType>(inImage, ofname, nbLevels, shrinkFactor);
+          break;
+        default:
+          otbAppLogFATAL(<< "The fast scheme does not support complex output pixel types");
+          break;
+        }
+
+      // Disable this parameter since the images have already been produced
+      DisableParameter("out");
+      return;
+      }
+
     // Get the extension and the prefix of the filename
     path  = itksys::SystemTools::GetFilenamePath(ofname);
     fname = itksys::SystemTools::GetFilenameWithoutExtension(ofname);
@@ -153,25 +193,30 @@ private:
       otbAppLogDEBUG( << "Processing level " << currentLevel
                       << " with shrink factor "<<currentFactor);
 
+      // Start from the closest coarser level of the file (overview or
+      // JPEG2000 resolution level), if any
+      unsigned int resolutionFactor = 0;
+      FloatVectorImageType::Pointer inImage =
+        GetParameterImageAtNativeResolution("in", currentFactor, resolutionFactor);
+      const unsigned int levelFactor = currentFactor >> resolutionFactor;
+      if (resolutionFactor > 0)
+        {
+        otbAppLogDEBUG( << "Reading resolution level " << resolutionFactor
+                        << ", remaining shrink factor " << levelFactor);
+        }
+
       m_SmoothingFilter->SetInput(inImage);
 
       // According to
       // http://www.ipol.im/pub/algo/gjmr_line_segment_detector/
       // This is a good balance between blur and aliasing
-      double variance = varianceFactor * static_cast<double>(currentFactor);
+      double variance = varianceFactor * static_cast<double>(levelFactor);
       m_SmoothingFilter->GetFilter()->SetVariance(variance);
 
       m_ShrinkFilter->SetInput(m_SmoothingFilter->GetOutput());
-      m_ShrinkFilter->SetShrinkFactors(currentFactor);
+      m_ShrinkFilter->SetShrinkFactors(levelFactor);
 
-      if(!fastScheme)
-        {
-        currentFactor *= shrinkFactor;
-        }
-      else
-        {
-        otbAppLogWARNING("fast scheme enabled : not implemented for the moment ");
-        }
+      currentFactor *= shrinkFactor;
 
       // Create an output parameter to write the current output image
       OutputImageParameter::Pointer paramOut = OutputImageParameter::New();
@@ -205,8 +250,41 @@ private:
     DisableParameter("out");
   }
 
+  template <class TOutputImage>
+  void WriteLevelsInCascade(FloatVectorImageType* inImage, const std::string & fileName,
+                            unsigned int nbLevels, unsigned int shrinkFactor)
+  {
+    typedef otb::ClampImageFilter<FloatVectorImageType, TOutputImage> ClampFilterType;
+    typedef otb::PyramidImageFileWriter<TOutputImage>                 WriterType;
+
+    typename ClampFilterType::Pointer clampFilter = ClampFilterType::New();
+    clampFilter->SetInput(inImage);
+
+    typename WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(clampFilter->GetOutput());
+    writer->SetFileName(fileName);
+    writer->SetNumberOfLevels(nbLevels);
+    writer->SetShrinkFactor(shrinkFactor);
+    writer->WriteFullResolutionOff();
+    writer->SetAutomaticStrippedStreaming(GetParameterInt("ram"));
+
+    for (unsigned int level = 1; level <= nbLevels; ++level)
+      {
+      otbAppLogINFO(<< "File: " << writer->GetLevelFileName(level) << " will be written.");
+      }
+
+    // Keep the pipeline alive along with the application
+    m_ClampFilter = clampFilter;
+    m_PyramidWriter = writer;
+
+    AddProcess(writer, "Writing the levels of the pyramid");
+    writer->Update();
+  }
+
   SmoothingVectorImageFilterType::Pointer   m_SmoothingFilter;
   ShrinkFilterType::Pointer                 m_ShrinkFilter;
+  itk::ProcessObject::Pointer               m_ClampFilter;
+  itk::ProcessObject::Pointer               m_PyramidWriter;
 };
 }
 }
@@ -60,8 +60,9 @@ private:
     SetDocName("Quick Look");
     SetDocLongDescription("Generates a subsampled version of an extract of an image defined by ROIStart and ROISize.\n "
                           "This extract is subsampled using the ratio OR the output image Size.");
-    SetDocLimitations(" This application does not provide yet the optimal way to decode coarser level of resolution from JPEG2000 images (like in Monteverdi).\n"
-                      "Trying to subsampled huge JPEG200 image with the application will lead to poor performances for now.");
+    SetDocLimitations("When the input file has overviews, or is a JPEG2000 image, the closest coarser level "
+                      "of resolution is decoded instead of the full resolution, as long as it divides the ratio. "
+                      "The quicklook is then subsampled from this level, which may slightly change the pixels kept.");
     SetDocAuthors("OTB-Team");
     SetDocSeeAlso(" ");
 
@@ -205,7 +206,49 @@ bool CropRegionOfInterest()
 
   void DoExecute() override
   {
-    InputImageType::Pointer inImage = GetParameterImage("in");
+    unsigned int Ratio = static_cast<unsigned int>(GetParameterInt("sr"));
+    unsigned int SamplingRatioX = 1;
+    unsigned int SamplingRatioY = 1;
+
+    if ( !HasUserValue("sr") )
+      {
+      if ( IsParameterEnabled("sx") && IsParameterEnabled("sy") )
+        {
+        SamplingRatioX =  GetParameterInt("rsx") / GetParameterInt("sx");
+        SamplingRatioY =  GetParameterInt("rsy") / GetParameterInt("sy");
+        if (SamplingRatioX > Ratio) Ratio = SamplingRatioX;
+        if (SamplingRatioY > Ratio) Ratio = SamplingRatioY;
+        }
+      else
+        {
+        if ( IsParameterEnabled("sx") )
+          {
+          Ratio =  GetParameterInt("rsx") / GetParameterInt("sx");
+          }
+        if ( IsParameterEnabled("sy") )
+          {
+          Ratio =  GetParameterInt("rsy") / GetParameterInt("sy");
+          }
+        }
+      }
+
+    if ( Ratio < 1)
+      {
+      otbAppLogFATAL( << "Error in SizeX and/or SizeY : ratio must be greater than 1.");
+      return;
+      }
+    otbAppLogINFO( << "Ratio used: "<<Ratio << ".");
+
+    // Decode the closest coarser level of the file (overview or JPEG2000
+    // resolution level) instead of the full resolution
+    unsigned int resolutionFactor = 0;
+    InputImageType::Pointer inImage = GetParameterImageAtNativeResolution("in", Ratio, resolutionFactor);
+    const unsigned int levelRatio = 1u << resolutionFactor;
+    if (resolutionFactor > 0)
+      {
+      otbAppLogINFO( << "Reading resolution level " << resolutionFactor
+                     << " of the input image, remaining ratio: " << Ratio / levelRatio << ".");
+      }
 
     ExtractROIFilterType::Pointer extractROIFilter =
       ExtractROIFilterType::New();
@@ -219,11 +262,19 @@ bool CropRegionOfInterest()
         || HasUserValue("rsx") || HasUserValue("rsy")
         || (GetSelectedItems("cl").size() > 0))
       {
+      // ROI expressed in the grid of the level read
+      InputImageType::RegionType region;
+      region.SetIndex(0, GetParameterInt("rox") / levelRatio);
+      region.SetIndex(1, GetParameterInt("roy") / levelRatio);
+      region.SetSize(0, (GetParameterInt("rsx") + levelRatio - 1) / levelRatio);
+      region.SetSize(1, (GetParameterInt("rsy") + levelRatio - 1) / levelRatio);
+      region.Crop(inImage->GetLargestPossibleRegion());
+
       extractROIFilter->SetInput(inImage);
-      extractROIFilter->SetStartX(GetParameterInt("rox"));
-      extractROIFilter->SetStartY(GetParameterInt("roy"));
-      extractROIFilter->SetSizeX(GetParameterInt("rsx"));
-      extractROIFilter->SetSizeY(GetParameterInt("rsy"));
+      extractROIFilter->SetStartX(region.GetIndex(0));
+      extractROIFilter->SetStartY(region.GetIndex(1));
+      extractROIFilter->SetSizeX(region.GetSize(0));
+      extractROIFilter->SetSizeY(region.GetSize(1));
 
       if ((GetSelectedItems("cl").size() > 0))
         {
@@ -247,40 +298,7 @@ bool CropRegionOfInterest()
       resamplingFilter->SetInput(inImage);
       }
 
-    unsigned int Ratio = static_cast<unsigned int>(GetParameterInt("sr"));
-    unsigned int SamplingRatioX = 1;
-    unsigned int SamplingRatioY = 1;
-
-    if ( !HasUserValue("sr") )
-      {
-      if ( IsParameterEnabled("sx") && IsParameterEnabled("sy") )
-        {
-        SamplingRatioX =  GetParameterInt("rsx") / GetParameterInt("sx");
-        SamplingRatioY =  GetParameterInt("rsy") / GetParameterInt("sy");
-        if (SamplingRatioX > Ratio) Ratio = SamplingRatioX;
-        if (SamplingRatioY > Ratio) Ratio = SamplingRatioY;
-        }
-      else
-        {
-        if ( IsParameterEnabled("sx") )
-          {
-          Ratio =  GetParameterInt("rsx") / GetParameterInt("sx");
-          }
-        if ( IsParameterEnabled("sy") )
-          {
-          Ratio =  GetParameterInt("rsy") / GetParameterInt("sy");
-          }
-        }
-      }
-
-    if ( Ratio < 1)
-      {
-      otbAppLogFATAL( << "Error in SizeX and/or SizeY : ratio must be greater than 1.");
-      return;
-      }
-    otbAppLogINFO( << "Ratio used: "<<Ratio << ".");
-
-    resamplingFilter->SetShrinkFactor( Ratio );
+    resamplingFilter->SetShrinkFactor( Ratio / levelRatio );
     resamplingFilter->Update();
 
     SetParameterOutputImage("out", resamplingFilter->GetOutput());
@@ -31,6 +31,7 @@ otb_module(OTBAppImageUtils
     OTBCurlAdapters
     OTBITK
     OTBImageBase
+    OTBImageIO
     OTBImageManipulation
     OTBOSSIMAdapters
     OTBObjectList
@@ -227,6 +227,19 @@ private:
                             "but increasing this parameter will reduce processing time.");
     MandatoryOff("opt.gridspacing");
 
+    // Adaptive displacement field
+    AddParameter(ParameterType_Float, "opt.gridtolerance", "Resampling grid tolerance");
+    SetDefaultParameterFloat("opt.gridtolerance", 0.1);
+    SetParameterDescription("opt.gridtolerance",
+                            "When enabled, the deformation grid is refined where "
+                            "needed, so that its interpolation stays within this error "
+                            "(in input image pixels) of the sensor model. "
+                            "opt.gridspacing then sets the size of the coarsest cells. "
+                            "Flat areas need few sensor model evaluations, while "
+                            "mountainous areas remain accurate.");
+    DisableParameter("opt.gridtolerance");
+    MandatoryOff("opt.gridtolerance");
+
     // Doc example parameter settings
     SetDocExampleParameterValue("io.in", "QB_TOULOUSE_MUL_Extract_500_500.tif");
     SetDocExampleParameterValue("io.out","QB_Toulouse_ortho.tif");
@@ -659,10 +672,31 @@ private:
       m_ResampleFilter->SetDisplacementFieldSpacing(gridSpacing);
       }
 
+    if (IsParameterEnabled("opt.gridtolerance"))
+      {
+      if (GetParameterFloat("opt.gridtolerance") <= 0)
+        {
+        otbAppLogFATAL("opt.gridtolerance must be strictly positive");
+        }
+      m_ResampleFilter->SetDisplacementFieldMaximumError(GetParameterFloat("opt.gridtolerance"));
+      otbAppLogINFO("Using an adaptive deformation grid with a tolerance of "
+                    << GetParameterFloat("opt.gridtolerance") << " input pixels");
+      }
+
     // Output Image
     SetParameterOutputImage("io.out", m_ResampleFilter->GetOutput());
     }
 
+  void AfterExecuteAndWriteOutputs() override
+  {
+    if (IsParameterEnabled("opt.gridtolerance"))
+      {
+      otbAppLogINFO("Adaptive deformation grid: " << m_ResampleFilter->GetNumberOfTransformEvaluations()
+                    << " sensor model evaluations, estimated maximum error of "
+                    << m_ResampleFilter->GetAchievedError() << " input pixels");
+      }
+  }
+
   ResampleFilterType::Pointer     m_ResampleFilter;
   std::string                     m_OutputProjectionRef;
   };
@@ -34,8 +34,13 @@
 #include "otbMultiToMonoChannelExtractROI.h"
 #include "otbImportGeoInformationImageFilter.h"
 
+#include "itkMultiThreader.h"
+#include "itkMutexLockHolder.h"
+#include "itkSimpleFastMutexLock.h"
+
 #include <time.h>
 #include <algorithm>
+#include <atomic>
 
 #include "otbWrapperApplication.h"
 #include "otbWrapperApplicationFactory.h"
@@ -89,7 +94,7 @@ public:
     AffineFunctorType>                        LabelShiftFilterType;
 
   LSMSSegmentation(): //m_FinalReader(),m_ImportGeoInformationFilter(),
-    m_FilesToRemoveAfterExecute(),m_TmpDirCleanup(false){}
+    m_FilesToRemoveAfterExecute(),m_TmpDirCleanup(false),m_LabelImage(),m_ImportGeoInformationFilter(){}
 
   ~LSMSSegmentation() override{}
 
@@ -98,6 +103,8 @@ private:
   // ImportGeoInformationImageFilterType::Pointer m_ImportGeoInformationFilter;
   std::vector<std::string> m_FilesToRemoveAfterExecute;
   bool m_TmpDirCleanup;
+  LabelImageType::Pointer m_LabelImage;
+  ImportGeoInformationImageFilterType::Pointer m_ImportGeoInformationFilter;
 
   std::string CreateFileName(unsigned int row, unsigned int column, std::string label)
   {
@@ -215,6 +222,363 @@ private:
     return vrtfname;
   }
 
+  std::string CreateExpression(unsigned int nbComp, float ranger, float spatialr)
+  {
+    //Expression 1 : radiometric distance < ranger
+    std::stringstream expr;
+    expr<<"sqrt((p1b1-p2b1)*(p1b1-p2b1)";
+    for(unsigned int i=1; i<nbComp; i++)
+      expr<<"+(p1b"<<i+1<<"-p2b"<<i+1<<")*(p1b"<<i+1<<"-p2b"<<i+1<<")";
+    expr<<")"<<"<"<<ranger;
+
+    if(HasValue("inpos"))
+      {
+      //Expression 2 : final positions < spatialr
+      expr<<" and sqrt((p1b"<<nbComp+1<<"-p2b"<<nbComp+1<<")*(p1b"<<nbComp+1<<"-p2b"<<nbComp+1<<")+";
+      expr<<"(p1b"<<nbComp+2<<"-p2b"<<nbComp+2<<")*(p1b"<<nbComp+2<<"-p2b"<<nbComp+2<<"))"<<"<"<<spatialr;
+      }
+    return expr.str();
+  }
+
+  /** Tile segmented in memory. The extracted region has a margin of one
+   *  pixel on the right and bottom sides, used to stitch the tile with
+   *  its neighbours. */
+  struct MemoryTile
+  {
+    ImageType::Pointer      range;
+    ImageType::Pointer      position;
+    LabelImageType::Pointer labels;
+  };
+
+  /** Tiles shared by the segmentation threads */
+  struct MemoryTileBatch
+  {
+    std::vector<MemoryTile> *  tiles;
+    std::string                expression;
+    std::atomic<unsigned long> next;
+    itk::SimpleFastMutexLock   lock;
+    std::string                error;
+  };
+
+  static void SegmentTile(MemoryTile & tile, const std::string & expression)
+  {
+    CCFilterType::Pointer ccFilter = CCFilterType::New();
+    ConcatenateType::Pointer concat = ConcatenateType::New();
+
+    // Tiles are already processed in parallel
+    ccFilter->SetNumberOfThreads(1);
+
+    if(tile.position.IsNotNull())
+      {
+      concat->SetInput1(tile.range);
+      concat->SetInput2(tile.position);
+      concat->SetNumberOfThreads(1);
+      ccFilter->SetInput(concat->GetOutput());
+      }
+    else
+      {
+      ccFilter->SetInput(tile.range);
+      }
+
+    ccFilter->GetFunctor().SetExpression(expression);
+    ccFilter->Update();
+
+    tile.labels = ccFilter->GetOutput();
+    tile.labels->DisconnectPipeline();
+    tile.range = nullptr;
+    tile.position = nullptr;
+  }
+
+  static ITK_THREAD_RETURN_TYPE SegmentTilesCallback(void * arg)
+  {
+    itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+    MemoryTileBatch * batch = static_cast<MemoryTileBatch *>(info->UserData);
+
+    for(unsigned long k = batch->next++; k < batch->tiles->size(); k = batch->next++)
+      {
+      try
+        {
+        SegmentTile((*batch->tiles)[k],batch->expression);
+        }
+      catch(itk::ExceptionObject & err)
+        {
+        itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(batch->lock);
+        batch->error = err.GetDescription();
+        }
+      catch(std::exception & err)
+        {
+        itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(batch->lock);
+        batch->error = err.what();
+        }
+      }
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  static LabelImagePixelType FindCanonicalLabel(std::vector<LabelImagePixelType> & LUT, LabelImagePixelType label)
+  {
+    while(LUT[label] != label)
+      {
+      LUT[label] = LUT[LUT[label]];
+      label = LUT[label];
+      }
+    return label;
+  }
+
+  /** In-memory segmentation: tiles are read one after the other, since
+   *  the input may be an upstream pipeline, and segmented concurrently.
+   *  Labels of the tiles are written in a single image, the seams are
+   *  reconciled with a union-find, and the small regions are pruned while
+   *  relabelling. Labels are identical to the ones of the tiled workflow
+   *  with temporary files. */
+  void ExecuteInMemory()
+  {
+    clock_t tic = clock();
+
+    const float ranger         = GetParameterFloat("ranger");
+    const float spatialr       = GetParameterFloat("spatialr");
+
+    unsigned int minRegionSize = GetParameterInt("minsize");
+
+    unsigned long sizeTilesX   = GetParameterInt("tilesizex");
+    unsigned long sizeTilesY   = GetParameterInt("tilesizey");
+
+    ImageType::Pointer spatialIn;
+
+    if(HasValue("inpos"))
+      {
+      spatialIn = GetParameterImage("inpos");
+      }
+
+    ImageType::Pointer imageIn = GetParameterImage("in");
+    imageIn->UpdateOutputInformation();
+
+    unsigned long sizeImageX = imageIn->GetLargestPossibleRegion().GetSize()[0];
+    unsigned long sizeImageY = imageIn->GetLargestPossibleRegion().GetSize()[1];
+    unsigned int nbComp      = imageIn->GetNumberOfComponentsPerPixel();
+
+    unsigned int nbTilesX = sizeImageX/sizeTilesX + (sizeImageX%sizeTilesX > 0 ? 1 : 0);
+    unsigned int nbTilesY = sizeImageY/sizeTilesY + (sizeImageY%sizeTilesY > 0 ? 1 : 0);
+    unsigned int nbTiles  = nbTilesX*nbTilesY;
+
+    otbAppLogINFO(<<"Number of tiles: "<<nbTilesX<<" x "<<nbTilesY);
+
+    m_LabelImage = LabelImageType::New();
+    m_LabelImage->SetRegions(imageIn->GetLargestPossibleRegion());
+    m_LabelImage->Allocate();
+
+    LabelImagePixelType * labels = m_LabelImage->GetBufferPointer();
+
+    // Labels of the bottom and right margins of each tile, compared with
+    // the first row and column of the next tiles
+    std::vector<std::vector<LabelImagePixelType> > bottomMargins(nbTiles);
+    std::vector<std::vector<LabelImagePixelType> > rightMargins(nbTiles);
+
+    itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+    const unsigned int nbThreads = std::max<unsigned int>(1,itk::MultiThreader::GetGlobalDefaultNumberOfThreads());
+
+    MemoryTileBatch batch;
+    batch.expression = CreateExpression(nbComp,ranger,spatialr);
+
+    unsigned long regionCount = 0;
+
+    otbAppLogINFO(<<"Tile segmentation on "<<nbThreads<<" threads ...");
+
+    for(unsigned int first = 0; first < nbTiles; first += nbThreads)
+      {
+      const unsigned int last = std::min(first+nbThreads,nbTiles);
+      std::vector<MemoryTile> tiles(last-first);
+
+      for(unsigned int tile = first; tile < last; ++tile)
+        {
+        unsigned long startX = (tile%nbTilesX)*sizeTilesX;
+        unsigned long startY = (tile/nbTilesX)*sizeTilesY;
+        unsigned long sizeX = std::min(sizeTilesX+1,sizeImageX-startX);
+        unsigned long sizeY = std::min(sizeTilesY+1,sizeImageY-startY);
+
+        MultiChannelExtractROIFilterType::Pointer extractROIFilter = MultiChannelExtractROIFilterType::New();
+        extractROIFilter->SetInput(imageIn);
+        extractROIFilter->SetStartX(startX);
+        extractROIFilter->SetStartY(startY);
+        extractROIFilter->SetSizeX(sizeX);
+        extractROIFilter->SetSizeY(sizeY);
+        extractROIFilter->Update();
+        tiles[tile-first].range = extractROIFilter->GetOutput();
+        tiles[tile-first].range->DisconnectPipeline();
+
+        if(HasValue("inpos"))
+          {
+          MultiChannelExtractROIFilterType::Pointer extractROIFilter2 = MultiChannelExtractROIFilterType::New();
+          extractROIFilter2->SetInput(spatialIn);
+          extractROIFilter2->SetStartX(startX);
+          extractROIFilter2->SetStartY(startY);
+          extractROIFilter2->SetSizeX(sizeX);
+          extractROIFilter2->SetSizeY(sizeY);
+          extractROIFilter2->Update();
+          tiles[tile-first].position = extractROIFilter2->GetOutput();
+          tiles[tile-first].position->DisconnectPipeline();
+          }
+        }
+
+      batch.tiles = &tiles;
+      batch.next = 0;
+      threader->SetNumberOfThreads(last-first);
+      threader->SetSingleMethod(SegmentTilesCallback,&batch);
+      threader->SingleMethodExecute();
+
+      if(!batch.error.empty())
+        {
+        otbAppLogFATAL(<<"Tile segmentation failed: "<<batch.error);
+        }
+
+      // Shift the labels of the tiles, in the same order as the tiled
+      // workflow, and keep their margins
+      for(unsigned int tile = first; tile < last; ++tile)
+        {
+        const LabelImageType * tileLabels = tiles[tile-first].labels;
+        const LabelImagePixelType * in = tileLabels->GetBufferPointer();
+        const unsigned long tileSizeX = tileLabels->GetBufferedRegion().GetSize()[0];
+        const unsigned long tileSizeY = tileLabels->GetBufferedRegion().GetSize()[1];
+
+        unsigned long startX = (tile%nbTilesX)*sizeTilesX;
+        unsigned long startY = (tile/nbTilesX)*sizeTilesY;
+        unsigned long sizeX = std::min(sizeTilesX,sizeImageX-startX);
+        unsigned long sizeY = std::min(sizeTilesY,sizeImageY-startY);
+
+        LabelImagePixelType maxLabel = 0;
+        for(unsigned long k = 0; k < tileSizeX*tileSizeY; ++k)
+          {
+          maxLabel = std::max(maxLabel,in[k]);
+          }
+
+        for(unsigned long y = 0; y < sizeY; ++y)
+          {
+          LabelImagePixelType * out = labels + (startY+y)*sizeImageX + startX;
+          for(unsigned long x = 0; x < sizeX; ++x)
+            {
+            out[x] = in[y*tileSizeX+x] + regionCount;
+            }
+          }
+        if(tileSizeY > sizeY)
+          {
+          bottomMargins[tile].resize(sizeX);
+          for(unsigned long x = 0; x < sizeX; ++x)
+            {
+            bottomMargins[tile][x] = in[sizeY*tileSizeX+x] + regionCount;
+            }
+          }
+        if(tileSizeX > sizeX)
+          {
+          rightMargins[tile].resize(sizeY);
+          for(unsigned long y = 0; y < sizeY; ++y)
+            {
+            rightMargins[tile][y] = in[y*tileSizeX+sizeX] + regionCount;
+            }
+          }
+
+        regionCount+=maxLabel;
+        }
+      }
+
+    // Union-find over the seams, each set is labelled by its minimum
+    otbAppLogINFO(<<"Tiles stitching ...");
+    std::vector<LabelImagePixelType> LUT(regionCount+1);
+    for(LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
+      LUT[curLabel] = curLabel;
+
+    for(unsigned int tile = 0; tile < nbTiles; ++tile)
+      {
+      unsigned long startX = (tile%nbTilesX)*sizeTilesX;
+      unsigned long startY = (tile/nbTilesX)*sizeTilesY;
+      unsigned long sizeX = std::min(sizeTilesX,sizeImageX-startX);
+      unsigned long sizeY = std::min(sizeTilesY,sizeImageY-startY);
+
+      std::vector<std::pair<LabelImagePixelType,LabelImagePixelType> > seam;
+      if(tile >= nbTilesX)
+        {
+        for(unsigned long x = 0; x < sizeX; ++x)
+          {
+          seam.push_back(std::make_pair(labels[startY*sizeImageX+startX+x],bottomMargins[tile-nbTilesX][x]));
+          }
+        }
+      if(tile%nbTilesX > 0)
+        {
+        for(unsigned long y = 0; y < sizeY; ++y)
+          {
+          seam.push_back(std::make_pair(labels[(startY+y)*sizeImageX+startX],rightMargins[tile-1][y]));
+          }
+        }
+
+      for(unsigned long k = 0; k < seam.size(); ++k)
+        {
+        LabelImagePixelType curCanLabel = FindCanonicalLabel(LUT,seam[k].first);
+        LabelImagePixelType adjCanLabel = FindCanonicalLabel(LUT,seam[k].second);
+        if(curCanLabel < adjCanLabel)
+          {
+          LUT[adjCanLabel] = curCanLabel;
+          }
+        else
+          {
+          LUT[curCanLabel] = adjCanLabel;
+          }
+        }
+      }
+    bottomMargins.clear();
+    rightMargins.clear();
+
+    for(LabelImagePixelType label = 1; label < regionCount+1; ++label)
+      {
+      LUT[label] = FindCanonicalLabel(LUT,label);
+      }
+
+    // Region sizes, then final labels in a single relabelling of the image
+    const unsigned long nbPixels = sizeImageX*sizeImageY;
+    std::vector<unsigned long> sizePerRegion(regionCount+1,0);
+    for(unsigned long k = 0; k < nbPixels; ++k)
+      {
+      sizePerRegion[LUT[labels[k]]]+=1;
+      }
+
+    otbAppLogINFO(<<"Small regions pruning ...");
+    unsigned int smallCount = 0;
+    LabelImagePixelType newLab=1;
+    std::vector<LabelImagePixelType> newLabels(regionCount+1,0);
+    for(LabelImagePixelType curLabel = 1; curLabel <= regionCount; ++curLabel)
+      {
+      if(sizePerRegion[curLabel]<minRegionSize)
+        {
+        newLabels[curLabel]=0;
+        ++smallCount;
+        }
+      else
+        {
+        newLabels[curLabel]=newLab;
+        newLab+=1;
+        }
+      }
+
+    otbAppLogINFO(<<smallCount<<" small regions will be removed");
+
+    for(LabelImagePixelType label = 1; label < regionCount+1; ++label)
+      {
+      LUT[label] = newLabels[LUT[label]];
+      }
+    for(unsigned long k = 0; k < nbPixels; ++k)
+      {
+      labels[k] = LUT[labels[k]];
+      }
+
+    clock_t toc = clock();
+
+    otbAppLogINFO(<<"Elapsed time: "<<(double)(toc - tic) / CLOCKS_PER_SEC<<" seconds");
+
+    m_ImportGeoInformationFilter = ImportGeoInformationImageFilterType::New();
+    m_ImportGeoInformationFilter->SetInput(m_LabelImage);
+    m_ImportGeoInformationFilter->SetSource(imageIn);
+
+    SetParameterOutputImage("out",m_ImportGeoInformationFilter->GetOutput());
+    RegisterPipeline();
+  }
+
   void DoInit() override
   {
     SetName("LSMSSegmentation");
@@ -240,6 +604,10 @@ private:
                           " set and tmpdir does not exists before running the application, it will"
                           " be removed as well during cleanup). The tmpdir option allows defining"
                           " a directory where to write the temporary files.\n\n"
+                          "The inmemory option avoids the temporary files: tiles are segmented"
+                          " concurrently and kept in memory, and the whole label image must then"
+                          " fit in memory (4 bytes per pixel). Labels are identical in both"
+                          " modes.\n\n"
                           "Please also note that the output image type should be set to uint32 to"
                           " ensure that there are enough labels available.\n\n"
                           "The output of this application can be passed to the"
@@ -307,6 +675,9 @@ private:
     SetParameterDescription("cleanup","If activated, the application will try to remove all temporary files it created.");
     SetParameterInt("cleanup",1);
 
+    AddParameter(ParameterType_Bool,"inmemory","In-memory processing");
+    SetParameterDescription("inmemory","If activated, tiles are segmented concurrently and stitched in memory, without any temporary file. The whole label image is kept in memory (4 bytes per pixel).");
+
     // Doc example parameter settings
     SetDocExampleParameterValue("in","smooth.tif");
     SetDocExampleParameterValue("inpos","position.tif");
@@ -328,6 +699,12 @@ private:
   {
     m_FilesToRemoveAfterExecute.clear();
 
+    if(GetParameterInt("inmemory"))
+      {
+      ExecuteInMemory();
+      return;
+      }
+
     clock_t tic = clock();
 
     const float ranger         = GetParameterFloat("ranger");
@@ -426,22 +803,8 @@ private:
          ccFilter->SetInput(extractROIFilter->GetOutput());
           }
 
-        //Expression 1 : radiometric distance < ranger
-        std::stringstream expr;
-        expr<<"sqrt((p1b1-p2b1)*(p1b1-p2b1)";
-        for(unsigned int i=1; i<nbComp; i++)
-          expr<<"+(p1b"<<i+1<<"-p2b"<<i+1<<")*(p1b"<<i+1<<"-p2b"<<i+1<<")";
-        expr<<")"<<"<"<<ranger;
-
-        if(HasValue("inpos"))
-          {
-          //Expression 2 : final positions < spatialr
-          expr<<" and sqrt((p1b"<<nbComp+1<<"-p2b"<<nbComp+1<<")*(p1b"<<nbComp+1<<"-p2b"<<nbComp+1<<")+";
-          expr<<"(p1b"<<nbComp+2<<"-p2b"<<nbComp+2<<")*(p1b"<<nbComp+2<<"-p2b"<<nbComp+2<<"))"<<"<"<<spatialr;
-          }
-
         //Segmentation
-        ccFilter->GetFunctor().SetExpression(expr.str());
+        ccFilter->GetFunctor().SetExpression(CreateExpression(nbComp,ranger,spatialr));
         ccFilter->Update();
 
         //Shifting
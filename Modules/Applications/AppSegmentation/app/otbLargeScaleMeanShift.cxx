@@ -96,6 +96,12 @@ private:
 
     ShareParameter("tilesizex","segmentation.tilesizex");
     ShareParameter("tilesizey","segmentation.tilesizey");
+    ShareParameter("inmemory","segmentation.inmemory",
+      "In-memory segmentation",
+      "If activated, the segmentation step processes its tiles concurrently "
+      "in memory and is connected in memory to the merging step: no temporary "
+      "file is written for the segmentation, but the whole label image is kept "
+      "in memory (4 bytes per pixel).");
 
     AddParameter(ParameterType_Choice, "mode","Output mode");
     SetParameterDescription("mode", "Type of segmented output");
@@ -176,10 +182,19 @@ private:
       0.5 * (double)GetInternalApplication("smoothing")->GetParameterInt("spatialr"));
     GetInternalApplication("segmentation")->SetParameterFloat("ranger",
       0.5 * GetInternalApplication("smoothing")->GetParameterFloat("ranger"));
-    GetInternalApplication("segmentation")->ExecuteAndWriteOutput();
-
-    GetInternalApplication("merging")->SetParameterString("inseg",
-      tmpFilenames[0]);
+    if (GetParameterInt("inmemory"))
+      {
+      // label image kept in memory, no temporary file
+      ExecuteInternal("segmentation");
+      GetInternalApplication("merging")->SetParameterInputImage("inseg",
+        GetInternalApplication("segmentation")->GetParameterOutputImage("out"));
+      }
+    else
+      {
+      GetInternalApplication("segmentation")->ExecuteAndWriteOutput();
+      GetInternalApplication("merging")->SetParameterString("inseg",
+        tmpFilenames[0]);
+      }
     EnableParameter("mode.raster.out");
     if (isVector)
       {
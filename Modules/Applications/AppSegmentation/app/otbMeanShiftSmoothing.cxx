@@ -162,6 +162,10 @@ private:
     AddParameter(ParameterType_Bool, "modesearch", "Mode search.");
     SetParameterDescription("modesearch", "If activated pixel iterative convergence is stopped if the path crosses an already converged pixel. Be careful, with this option, the result will slightly depend on thread number and the results will not be stable (see [4] for more details).");
 
+    AddParameter(ParameterType_Bool, "bucket", "Range buckets");
+    SetParameterDescription("bucket", "If activated, pixels are sorted in buckets of range values, so that only the neighbors whose range value is close to the one of the current pixel are visited. The result is unchanged.");
+    SetParameterInt("bucket", 1);
+
     // Doc example parameter settings
     SetDocExampleParameterValue("in", "maur_rgb.png");
     SetDocExampleParameterValue("fout", "smooth.tif");
@@ -191,6 +195,7 @@ private:
     filter->SetMaxIterationNumber(GetParameterInt("maxiter"));
     filter->SetRangeBandwidthRamp(GetParameterFloat("rangeramp"));
     filter->SetModeSearch(GetParameterInt("modesearch"));
+    filter->SetBucketOptimization(GetParameterInt("bucket"));
 
     //Compute the margin used to ensure exact results (tile wise smoothing)
     //This margin is valid for the default uniform kernel used by the
@@ -151,6 +151,12 @@ AddParameter(ParameterType_Int,"parameters.nbbin","Histogram number of bin");
 SetParameterDescription("parameters.nbbin", "Histogram number of bin");
 SetDefaultParameterInt("parameters.nbbin", 8);
 
+AddParameter(ParameterType_Bool,"parameters.incremental","Incremental computation");
+SetParameterDescription("parameters.incremental", "If set, the co-occurrence matrix "
+  "is updated as the window slides along each line, instead of being rebuilt for "
+  "every pixel. This is much faster for large radii, and gives the same textures "
+  "up to floating point rounding (simple and advanced sets only).");
+
 AddParameter(ParameterType_Choice, "texture", "Texture Set Selection");
 SetParameterDescription("texture", "Choice of The Texture Set");
 
@@ -260,6 +266,7 @@ void DoExecute() override
     m_HarTexFilter->SetNumberOfBinsPerAxis(GetParameterInt("parameters.nbbin"));
     m_HarTexFilter->SetSubsampleFactor(stepping);
     m_HarTexFilter->SetSubsampleOffset(stepOffset);
+    m_HarTexFilter->SetIncremental(GetParameterInt("parameters.incremental"));
     m_HarTexFilter->UpdateOutputInformation();
     m_HarImageList->PushBack(m_HarTexFilter->GetEnergyOutput());
     m_HarImageList->PushBack(m_HarTexFilter->GetEntropyOutput());
@@ -283,6 +290,7 @@ void DoExecute() override
     m_AdvTexFilter->SetNumberOfBinsPerAxis(GetParameterInt("parameters.nbbin"));
     m_AdvTexFilter->SetSubsampleFactor(stepping);
     m_AdvTexFilter->SetSubsampleOffset(stepOffset);
+    m_AdvTexFilter->SetIncremental(GetParameterInt("parameters.incremental"));
     m_AdvImageList->PushBack(m_AdvTexFilter->GetMeanOutput());
     m_AdvImageList->PushBack(m_AdvTexFilter->GetVarianceOutput());
     m_AdvImageList->PushBack(m_AdvTexFilter->GetDissimilarityOutput());
@@ -84,6 +84,42 @@ public:
    */
   static RAMValueType GetMaxRAMHint();
 
+  /**
+   * BlockCacheSize is the maximum memory used to share decoded image
+   * blocks between all the readers of the process, expressed in
+   * MegaBytes.
+   *
+   * If environment variable OTB_BLOCK_CACHE_SIZE is defined and could
+   * be converted to int, return its content as a 64 bits unsigned int.
+   * Else, returns default value, which is 0 (no shared cache)
+   *
+   */
+  static RAMValueType GetBlockCacheSize();
+
+  /**
+   * DEMTileCacheSize is the maximum memory used to cache the heights
+   * sampled from the DEM and the geoid by DEMHandler, expressed in
+   * MegaBytes.
+   *
+   * If environment variable OTB_DEM_TILE_CACHE_SIZE is defined and
+   * could be converted to int, return its content as a 64 bits
+   * unsigned int.
+   * Else, returns default value, which is 0 (no cache)
+   *
+   */
+  static RAMValueType GetDEMTileCacheSize();
+
+  /**
+   * TraceFile is the path of the file where a trace of the processing
+   * (filters, streaming divisions, reads and writes) is written at
+   * exit, in the Chrome trace JSON format.
+   *
+   * If environment variable OTB_TRACE_FILE is defined,
+   * returns it contents as a string
+   * Else, returns an empty string (no trace)
+   */
+  static std::string GetTraceFile();
+
   /**
    * Logger level controls the level of logging that OTB will output.
    * 
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbPipelineTraceObserver_h
+#define otbPipelineTraceObserver_h
+
+#include "otbTracer.h"
+#include "itkCommand.h"
+#include "itkProcessObject.h"
+
+#include "OTBCommonExport.h"
+
+#include <map>
+#include <vector>
+
+namespace otb
+{
+
+/** \class PipelineTraceObserver
+ *
+ * \brief Record the execution of every filter of a pipeline in the Tracer
+ *
+ * Attach() walks the pipeline upstream of a data object and observes the
+ * StartEvent and EndEvent of each process object: each GenerateData()
+ * call is recorded as an event named after the filter class, with the
+ * current streaming division, the number of threads of the filter and
+ * the requested region of its output.
+ *
+ * In a streamed pipeline the upstream filters are updated before the
+ * downstream ones start, so that the recorded durations do not overlap
+ * and give the time spent in each filter. The filters of the internal
+ * mini-pipelines of composite filters are not connected to the pipeline:
+ * their time is included in the one of the composite filter.
+ *
+ * Writers attach an observer to their input when the Tracer is enabled.
+ *
+ * \sa Tracer
+ *
+ * \ingroup OTBCommon
+ */
+class OTBCommon_EXPORT PipelineTraceObserver
+{
+public:
+  PipelineTraceObserver();
+  ~PipelineTraceObserver();
+
+  /** Observe all the process objects upstream of data */
+  void Attach(itk::DataObject * data);
+
+  /** Stop observing */
+  void Detach();
+
+  /** Streaming division added to the recorded events */
+  void SetDivision(unsigned int division)
+  {
+    m_Division = division;
+  }
+
+private:
+  PipelineTraceObserver(const PipelineTraceObserver &) = delete;
+  void operator =(const PipelineTraceObserver &) = delete;
+
+  void StartCallback(const itk::Object * caller, const itk::EventObject & event);
+  void EndCallback(const itk::Object * caller, const itk::EventObject & event);
+
+  typedef itk::MemberCommand<PipelineTraceObserver> CommandType;
+
+  struct Observation
+  {
+    itk::ProcessObject::Pointer process;
+    unsigned long               startTag;
+    unsigned long               endTag;
+  };
+
+  std::vector<Observation>                         m_Observations;
+  std::map<const itk::Object *, Tracer::TimeType>  m_StartTimes;
+  CommandType::Pointer                             m_StartCommand;
+  CommandType::Pointer                             m_EndCommand;
+  unsigned int                                     m_Division;
+};
+
+} // end namespace otb
+
+#endif // otbPipelineTraceObserver_h
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbPyramidCascade_h
+#define otbPyramidCascade_h
+
+#include "itkMultiThreader.h"
+
+#include <cmath>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace otb
+{
+
+/** \class PyramidCascade
+ *
+ * \brief Computes the decimated levels of an image pyramid in a single pass
+ *
+ * The lines of the full resolution image are pushed in order, by strips
+ * of any height. Each level is computed from the lines of the previous
+ * one, as soon as a complete line of ShrinkFactor x ShrinkFactor blocks
+ * is available, and handed over to a callback along with its position in
+ * the level. Between two strips, only the lines of the incomplete block
+ * line of each level are kept in memory.
+ *
+ * Level k has ceil(size / ShrinkFactor^k) pixels along each dimension,
+ * as the GDAL overviews. Its pixels are either the mean of their block,
+ * partial blocks on the right and bottom borders being averaged over the
+ * pixels available, or the upper left pixel of their block. Buffers hold
+ * the components of each pixel contiguously, as in a VectorImage.
+ *
+ * The columns of the block lines are reduced by several threads.
+ *
+ * \ingroup OTBCommon
+ */
+template <class TValue>
+class PyramidCascade
+{
+public:
+  typedef TValue ValueType;
+
+  /** How the pixels of a block are reduced */
+  enum ResamplingType
+  {
+    Average,
+    Nearest
+  };
+
+  /** Called with the level (starting at 1), the index of the first line
+   *  in this level, the number of lines and their buffer */
+  typedef std::function<void (unsigned int, unsigned int, unsigned int, const ValueType *)> CallbackType;
+
+  PyramidCascade();
+  ~PyramidCascade() {}
+
+  /** Number of decimated levels, the full resolution excluded */
+  void SetNumberOfLevels(unsigned int nbLevels);
+  unsigned int GetNumberOfLevels() const;
+
+  /** Decimation factor between two consecutive levels */
+  void SetShrinkFactor(unsigned int factor);
+  unsigned int GetShrinkFactor() const;
+
+  void SetResampling(ResamplingType resampling);
+  ResamplingType GetResampling() const;
+
+  void SetNumberOfThreads(unsigned int nbThreads);
+  unsigned int GetNumberOfThreads() const;
+
+  void SetCallback(const CallbackType & callback);
+
+  /** Prepare the levels of an image of width x height pixels. This must
+   *  be called before the first line is pushed. */
+  void Initialize(unsigned int width, unsigned int height, unsigned int nbComponents);
+
+  /** Push the next nbLines lines of the full resolution image. The
+   *  callback is called for each level before returning. */
+  void PushLines(unsigned int nbLines, const ValueType * buffer);
+
+  /** Size of a level, level 0 being the full resolution */
+  unsigned int GetLevelWidth(unsigned int level) const;
+  unsigned int GetLevelHeight(unsigned int level) const;
+
+  /** True once all the lines of the full resolution image are pushed */
+  bool IsComplete() const;
+
+  /** Length of a level along a dimension of the given length */
+  static unsigned int GetLevelLength(unsigned int length, unsigned int factor, unsigned int level);
+
+private:
+  PyramidCascade(const PyramidCascade &) = delete;
+  void operator =(const PyramidCascade &) = delete;
+
+  struct Level
+  {
+    Level() : width(0), height(0), nbLines(0), nbPendingLines(0) {}
+
+    unsigned int width;
+    unsigned int height;
+    /** Number of lines received */
+    unsigned int nbLines;
+    /** Lines of the incomplete block line */
+    std::vector<ValueType> pending;
+    unsigned int nbPendingLines;
+    /** Lines of the next level, computed from this one */
+    std::vector<ValueType> reduced;
+  };
+
+  struct ReduceStruct
+  {
+    const PyramidCascade * cascade;
+    unsigned int level;
+    const ValueType * input;
+    unsigned int nbInputLines;
+    ValueType * output;
+    unsigned int nbChunks;
+  };
+
+  /** Lines received by a level */
+  void Push(unsigned int level, unsigned int nbLines, const ValueType * buffer);
+
+  /** Reduce lines of a level into the lines of the next one, and pass
+   *  them on. nbInputLines is a multiple of the shrink factor, except for
+   *  the last lines of the level. */
+  void ReduceAndPush(unsigned int level, const ValueType * input, unsigned int nbInputLines);
+
+  /** Reduce the output columns [x0, x1) */
+  void ReduceColumns(unsigned int level, const ValueType * input, unsigned int nbInputLines,
+                     ValueType * output, unsigned int x0, unsigned int x1) const;
+
+  static ITK_THREAD_RETURN_TYPE ReduceCallback(void * arg);
+
+  static ValueType ConvertMean(double mean, std::true_type)
+  {
+    return static_cast<ValueType>(std::floor(mean + 0.5));
+  }
+
+  static ValueType ConvertMean(double mean, std::false_type)
+  {
+    return static_cast<ValueType>(mean);
+  }
+
+  unsigned int               m_NumberOfLevels;
+  unsigned int               m_ShrinkFactor;
+  ResamplingType             m_Resampling;
+  unsigned int               m_NumberOfThreads;
+  unsigned int               m_NumberOfComponents;
+  CallbackType               m_Callback;
+  std::vector<Level>         m_Levels;
+  itk::MultiThreader::Pointer m_Threader;
+}; // end of PyramidCascade
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbPyramidCascade.hxx"
+#endif
+
+#endif // otbPyramidCascade_h
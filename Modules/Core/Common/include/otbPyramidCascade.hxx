@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbPyramidCascade_hxx
+#define otbPyramidCascade_hxx
+
+#include "otbPyramidCascade.h"
+#include "itkMacro.h"
+
+#include <algorithm>
+
+namespace otb
+{
+
+template <class TValue>
+PyramidCascade<TValue>
+::PyramidCascade()
+  : m_NumberOfLevels(1),
+    m_ShrinkFactor(2),
+    m_Resampling(Average),
+    m_NumberOfThreads(itk::MultiThreader::GetGlobalDefaultNumberOfThreads()),
+    m_NumberOfComponents(1)
+{
+  m_Threader = itk::MultiThreader::New();
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::SetNumberOfLevels(unsigned int nbLevels)
+{
+  m_NumberOfLevels = nbLevels;
+}
+
+template <class TValue>
+unsigned int
+PyramidCascade<TValue>
+::GetNumberOfLevels() const
+{
+  return m_NumberOfLevels;
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::SetShrinkFactor(unsigned int factor)
+{
+  if (factor < 2)
+    {
+    itkGenericExceptionMacro(<< "The shrink factor of a pyramid must be at least 2, got " << factor);
+    }
+  m_ShrinkFactor = factor;
+}
+
+template <class TValue>
+unsigned int
+PyramidCascade<TValue>
+::GetShrinkFactor() const
+{
+  return m_ShrinkFactor;
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::SetResampling(ResamplingType resampling)
+{
+  m_Resampling = resampling;
+}
+
+template <class TValue>
+typename PyramidCascade<TValue>::ResamplingType
+PyramidCascade<TValue>
+::GetResampling() const
+{
+  return m_Resampling;
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::SetNumberOfThreads(unsigned int nbThreads)
+{
+  m_NumberOfThreads = std::max(1u, nbThreads);
+}
+
+template <class TValue>
+unsigned int
+PyramidCascade<TValue>
+::GetNumberOfThreads() const
+{
+  return m_NumberOfThreads;
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::SetCallback(const CallbackType & callback)
+{
+  m_Callback = callback;
+}
+
+template <class TValue>
+unsigned int
+PyramidCascade<TValue>
+::GetLevelLength(unsigned int length, unsigned int factor, unsigned int level)
+{
+  for (unsigned int k = 0; k < level; ++k)
+    {
+    length = (length + factor - 1) / factor;
+    }
+  return length;
+}
+
+template <class TValue>
+unsigned int
+PyramidCascade<TValue>
+::GetLevelWidth(unsigned int level) const
+{
+  return m_Levels.at(level).width;
+}
+
+template <class TValue>
+unsigned int
+PyramidCascade<TValue>
+::GetLevelHeight(unsigned int level) const
+{
+  return m_Levels.at(level).height;
+}
+
+template <class TValue>
+bool
+PyramidCascade<TValue>
+::IsComplete() const
+{
+  return !m_Levels.empty() && m_Levels[0].nbLines == m_Levels[0].height;
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::Initialize(unsigned int width, unsigned int height, unsigned int nbComponents)
+{
+  m_NumberOfComponents = std::max(1u, nbComponents);
+
+  m_Levels.clear();
+  m_Levels.resize(m_NumberOfLevels + 1);
+  for (unsigned int k = 0; k <= m_NumberOfLevels; ++k)
+    {
+    Level & level = m_Levels[k];
+    level.width = GetLevelLength(width, m_ShrinkFactor, k);
+    level.height = GetLevelLength(height, m_ShrinkFactor, k);
+    if (k < m_NumberOfLevels)
+      {
+      level.pending.resize(static_cast<size_t>(m_ShrinkFactor) * level.width * m_NumberOfComponents);
+      }
+    }
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::PushLines(unsigned int nbLines, const ValueType * buffer)
+{
+  if (m_Levels.empty())
+    {
+    itkGenericExceptionMacro(<< "The pyramid cascade is not initialized");
+    }
+  if (m_Levels[0].nbLines + nbLines > m_Levels[0].height)
+    {
+    itkGenericExceptionMacro(<< "Too many lines pushed in the pyramid cascade: "
+                             << m_Levels[0].nbLines + nbLines << " for an image of "
+                             << m_Levels[0].height << " lines");
+    }
+  if (nbLines > 0)
+    {
+    this->Push(0, nbLines, buffer);
+    }
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::Push(unsigned int level, unsigned int nbLines, const ValueType * buffer)
+{
+  Level & current = m_Levels[level];
+  current.nbLines += nbLines;
+
+  if (level == m_NumberOfLevels)
+    {
+    return;
+    }
+
+  const size_t lineLength = static_cast<size_t>(current.width) * m_NumberOfComponents;
+  const bool isLast = current.nbLines == current.height;
+
+  // Complete the pending block line first
+  if (current.nbPendingLines > 0)
+    {
+    const unsigned int taken = std::min(m_ShrinkFactor - current.nbPendingLines, nbLines);
+    std::copy(buffer, buffer + taken * lineLength,
+              current.pending.begin() + current.nbPendingLines * lineLength);
+    current.nbPendingLines += taken;
+    buffer += taken * lineLength;
+    nbLines -= taken;
+
+    if (current.nbPendingLines == m_ShrinkFactor || (isLast && nbLines == 0))
+      {
+      this->ReduceAndPush(level, current.pending.data(), current.nbPendingLines);
+      current.nbPendingLines = 0;
+      }
+    }
+
+  if (nbLines == 0)
+    {
+    return;
+    }
+
+  // Complete block lines are reduced straight from the buffer, as well as
+  // the last lines of the level
+  const unsigned int nbBlockLines = isLast ? nbLines : nbLines - nbLines % m_ShrinkFactor;
+  if (nbBlockLines > 0)
+    {
+    this->ReduceAndPush(level, buffer, nbBlockLines);
+    }
+
+  const unsigned int nbRemainingLines = nbLines - nbBlockLines;
+  if (nbRemainingLines > 0)
+    {
+    const ValueType * remaining = buffer + nbBlockLines * lineLength;
+    std::copy(remaining, remaining + nbRemainingLines * lineLength, current.pending.begin());
+    current.nbPendingLines = nbRemainingLines;
+    }
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::ReduceAndPush(unsigned int level, const ValueType * input, unsigned int nbInputLines)
+{
+  Level & current = m_Levels[level];
+  const Level & next = m_Levels[level + 1];
+
+  const unsigned int nbOutputLines = (nbInputLines + m_ShrinkFactor - 1) / m_ShrinkFactor;
+  current.reduced.resize(static_cast<size_t>(next.width) * m_NumberOfComponents * nbOutputLines);
+
+  // Threads are only worth it for large enough block lines
+  const size_t nbOutputPixels = static_cast<size_t>(next.width) * nbOutputLines;
+  const unsigned int nbChunks = static_cast<unsigned int>(
+    std::min<size_t>(std::min<size_t>(m_NumberOfThreads, next.width), std::max<size_t>(1, nbOutputPixels / 4096)));
+
+  if (nbChunks <= 1)
+    {
+    this->ReduceColumns(level, input, nbInputLines, current.reduced.data(), 0, next.width);
+    }
+  else
+    {
+    ReduceStruct str;
+    str.cascade = this;
+    str.level = level;
+    str.input = input;
+    str.nbInputLines = nbInputLines;
+    str.output = current.reduced.data();
+    str.nbChunks = nbChunks;
+
+    m_Threader->SetNumberOfThreads(nbChunks);
+    m_Threader->SetSingleMethod(ReduceCallback, &str);
+    m_Threader->SingleMethodExecute();
+    }
+
+  const unsigned int firstLine = next.nbLines;
+  if (m_Callback)
+    {
+    m_Callback(level + 1, firstLine, nbOutputLines, current.reduced.data());
+    }
+  this->Push(level + 1, nbOutputLines, current.reduced.data());
+}
+
+template <class TValue>
+ITK_THREAD_RETURN_TYPE
+PyramidCascade<TValue>
+::ReduceCallback(void * arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  const ReduceStruct * str = static_cast<const ReduceStruct *>(info->UserData);
+  const unsigned int width = str->cascade->m_Levels[str->level + 1].width;
+
+  // The threader may run fewer threads than chunks
+  for (unsigned int chunk = info->ThreadID; chunk < str->nbChunks; chunk += info->NumberOfThreads)
+    {
+    const unsigned int x0 = static_cast<unsigned int>(static_cast<unsigned long long>(width) * chunk / str->nbChunks);
+    const unsigned int x1 = static_cast<unsigned int>(static_cast<unsigned long long>(width) * (chunk + 1) / str->nbChunks);
+    str->cascade->ReduceColumns(str->level, str->input, str->nbInputLines, str->output, x0, x1);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template <class TValue>
+void
+PyramidCascade<TValue>
+::ReduceColumns(unsigned int level, const ValueType * input, unsigned int nbInputLines,
+                ValueType * output, unsigned int x0, unsigned int x1) const
+{
+  const unsigned int factor = m_ShrinkFactor;
+  const unsigned int nbComp = m_NumberOfComponents;
+  const unsigned int width = m_Levels[level].width;
+  const size_t inputLineLength = static_cast<size_t>(width) * nbComp;
+  const size_t outputLineLength = static_cast<size_t>(m_Levels[level + 1].width) * nbComp;
+
+  std::vector<double> sum(nbComp);
+
+  for (unsigned int y0 = 0, j = 0; y0 < nbInputLines; y0 += factor, ++j)
+    {
+    const unsigned int y1 = std::min(y0 + factor, nbInputLines);
+    ValueType * out = output + j * outputLineLength + static_cast<size_t>(x0) * nbComp;
+
+    for (unsigned int x = x0; x < x1; ++x, out += nbComp)
+      {
+      const unsigned int c0 = x * factor;
+      const unsigned int c1 = std::min(c0 + factor, width);
+
+      if (m_Resampling == Nearest)
+        {
+        const ValueType * in = input + y0 * inputLineLength + static_cast<size_t>(c0) * nbComp;
+        std::copy(in, in + nbComp, out);
+        continue;
+        }
+
+      std::fill(sum.begin(), sum.end(), 0.);
+      for (unsigned int y = y0; y < y1; ++y)
+        {
+        const ValueType * in = input + y * inputLineLength + static_cast<size_t>(c0) * nbComp;
+        for (unsigned int c = c0; c < c1; ++c, in += nbComp)
+          {
+          for (unsigned int b = 0; b < nbComp; ++b)
+            {
+            sum[b] += static_cast<double>(in[b]);
+            }
+          }
+        }
+
+      const double count = static_cast<double>((y1 - y0) * (c1 - c0));
+      for (unsigned int b = 0; b < nbComp; ++b)
+        {
+        out[b] = ConvertMean(sum[b] / count, typename std::is_integral<ValueType>::type());
+        }
+      }
+    }
+}
+
+} // end namespace otb
+
+#endif
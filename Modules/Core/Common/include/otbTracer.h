@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbTracer_h
+#define otbTracer_h
+
+#include "itkSimpleFastMutexLock.h"
+
+#include "OTBCommonExport.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace otb
+{
+
+/** \class Tracer
+ *
+ * \brief Record a timeline of the processing, exported as a Chrome trace
+ *
+ * The tracer records timed events (filter executions, streaming
+ * divisions, image reads and writes, waits) with the thread they
+ * occurred in. Events are exported in the Trace Event JSON format, which
+ * can be opened with chrome://tracing or https://ui.perfetto.dev.
+ *
+ * Tracing is disabled by default, and the cost of a disabled tracer is
+ * a single test. It is enabled at startup if the OTB_TRACE_FILE
+ * environment variable is set (see ConfigurationManager::GetTraceFile()):
+ * the trace is then written to that file at exit. It can also be
+ * enabled with Start() and written with Stop().
+ *
+ * Events are usually recorded with a TraceScope.
+ *
+ * \sa TraceScope, PipelineTraceObserver
+ *
+ * \ingroup OTBCommon
+ */
+class OTBCommon_EXPORT Tracer
+{
+public:
+  /** Timestamps and durations, in microseconds */
+  typedef std::int64_t TimeType;
+
+  /** Arguments of an event: keys and values already formatted in JSON */
+  typedef std::vector<std::pair<std::string, std::string> > ArgumentListType;
+
+  // GetInstance returns a reference to the unique Tracer
+  static Tracer& GetInstance();
+
+  /** Clear the recorded events and start recording. The trace is
+   *  written to fileName when stopped (nothing is written if fileName
+   *  is empty). */
+  void Start(const std::string & fileName = "");
+
+  /** Stop recording and write the trace if a file name was given to
+   *  Start(). Returns false if the trace could not be written. */
+  bool Stop();
+
+  /** True if events are currently recorded */
+  bool IsEnabled() const
+  {
+    return m_Enabled.load(std::memory_order_relaxed);
+  }
+
+  /** Time elapsed since the tracer creation */
+  TimeType GetTime() const;
+
+  /** Record an event with a duration */
+  void AddCompleteEvent(const std::string & name, const std::string & category,
+                        TimeType start, TimeType duration,
+                        const ArgumentListType & arguments = ArgumentListType());
+
+  /** Record the value of a counter */
+  void AddCounterEvent(const std::string & name, TimeType time, double value);
+
+  /** Give a name to the calling thread in the trace */
+  void SetCurrentThreadName(const std::string & name);
+
+  /** Number of recorded events */
+  size_t GetNumberOfEvents() const;
+
+  /** Remove the recorded events */
+  void Clear();
+
+  /** Write the recorded events in the Trace Event JSON format */
+  void Write(std::ostream & os) const;
+
+  /** Write the recorded events to a file. Returns false on error. */
+  bool Write(const std::string & fileName) const;
+
+  /** Format a value for the arguments of an event */
+  static std::string FormatArgument(const std::string & value);
+  static std::string FormatArgument(const char * value);
+  template <class T>
+  static std::string FormatArgument(const T & value)
+  {
+    std::ostringstream oss;
+    oss << value;
+    return oss.str();
+  }
+
+private:
+  // private constructor so that this class is allocated only inside GetInstance
+  Tracer();
+  ~Tracer();
+
+  Tracer(const Tracer &) = delete;
+  void operator =(const Tracer &) = delete;
+
+  struct Event
+  {
+    std::string      name;
+    std::string      category;
+    char             phase;
+    TimeType         time;
+    TimeType         duration;
+    unsigned int     thread;
+    ArgumentListType arguments;
+  };
+
+  /** Compact identifier of the calling thread (lock must be held) */
+  unsigned int GetCurrentThreadUnsafe();
+
+  static std::string Escape(const std::string & value);
+
+  std::atomic<bool>                          m_Enabled;
+  std::string                                m_FileName;
+  std::chrono::steady_clock::time_point      m_Origin;
+  std::vector<Event>                         m_Events;
+  std::map<std::thread::id, unsigned int>    m_Threads;
+  std::map<unsigned int, std::string>        m_ThreadNames;
+  mutable itk::SimpleFastMutexLock           m_Mutex;
+};
+
+/** \class TraceScope
+ *
+ * \brief Record the duration of a scope in the Tracer
+ *
+ * The event starts with the construction of the TraceScope and ends
+ * with its destruction. Nothing is recorded if the tracer is disabled
+ * when the scope starts.
+ *
+ * \code
+ * {
+ * otb::TraceScope scope("Read", "io");
+ * scope.AddArgument("bytes", nbBytes);
+ * ...
+ * }
+ * \endcode
+ *
+ * \sa Tracer
+ *
+ * \ingroup OTBCommon
+ */
+class OTBCommon_EXPORT TraceScope
+{
+public:
+  TraceScope(const char * name, const char * category);
+  TraceScope(const std::string & name, const char * category);
+  ~TraceScope();
+
+  /** True if the scope will be recorded */
+  bool IsEnabled() const
+  {
+    return m_Enabled;
+  }
+
+  /** Add an argument to the event */
+  template <class T>
+  void AddArgument(const std::string & key, const T & value)
+  {
+    if (m_Enabled)
+      {
+      m_Arguments.push_back(std::make_pair(key, Tracer::FormatArgument(value)));
+      }
+  }
+
+private:
+  TraceScope(const TraceScope &) = delete;
+  void operator =(const TraceScope &) = delete;
+
+  bool                       m_Enabled;
+  std::string                m_Name;
+  const char *               m_Category;
+  Tracer::TimeType           m_Start;
+  Tracer::ArgumentListType   m_Arguments;
+};
+
+} // end namespace otb
+
+#endif // otbTracer_h
@@ -22,6 +22,7 @@
 #define otbUnaryFunctorVectorImageFilter_h
 
 #include "itkInPlaceImageFilter.h"
+#include "otbFunctorTraits.h"
 
 namespace otb
 {
@@ -32,6 +33,11 @@ namespace otb
  * and the type of the output image.  It is also parameterized by the
  * operation to be applied.  A Functor style is used.
  *
+ * Functors providing void operator()(OutputPixel &, const InputPixel &)
+ * write their result in an output pixel sized once per thread, instead
+ * of returning a new pixel for each input pixel (see
+ * otb::Functor::HasOutputArgument).
+ *
  * \ingroup IntensityImageFilters   Multithreaded
  *
  * \ingroup OTBCommon
@@ -118,6 +124,17 @@ private:
   UnaryFunctorVectorImageFilter(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  typedef otb::Functor::HasOutputArgument<FunctorType, OutputImagePixelType, InputImagePixelType>
+    FunctorHasOutputArgumentType;
+
+  /** Pixel loop with functors returning the output pixel */
+  void ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+                    itk::ThreadIdType threadId, std::false_type);
+
+  /** Pixel loop with functors writing in the output pixel */
+  void ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+                    itk::ThreadIdType threadId, std::true_type);
+
   FunctorType m_Functor;
 }; // end of class
 
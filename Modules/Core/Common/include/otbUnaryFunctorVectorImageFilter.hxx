@@ -23,6 +23,7 @@
 
 #include "otbUnaryFunctorVectorImageFilter.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkProgressReporter.h"
 
 namespace otb
@@ -61,6 +62,16 @@ void
 UnaryFunctorVectorImageFilter<TInputImage, TOutputImage, TFunction>
 ::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
                        itk::ThreadIdType threadId)
+{
+  this->ApplyFunctor(outputRegionForThread, threadId,
+                     typename FunctorHasOutputArgumentType::Type());
+}
+
+template <class TInputImage, class TOutputImage, class TFunction>
+void
+UnaryFunctorVectorImageFilter<TInputImage, TOutputImage, TFunction>
+::ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+               itk::ThreadIdType threadId, std::false_type)
 {
   InputImageRegionType inputRegionForThread;
   this->CallCopyOutputRegionToInputRegion( inputRegionForThread, outputRegionForThread );
@@ -85,6 +96,49 @@ UnaryFunctorVectorImageFilter<TInputImage, TOutputImage, TFunction>
   }
 }
 
+template <class TInputImage, class TOutputImage, class TFunction>
+void
+UnaryFunctorVectorImageFilter<TInputImage, TOutputImage, TFunction>
+::ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+               itk::ThreadIdType threadId, std::true_type)
+{
+  InputImageRegionType inputRegionForThread;
+  this->CallCopyOutputRegionToInputRegion( inputRegionForThread, outputRegionForThread );
+
+  itk::ImageScanlineConstIterator< InputImageType > inputIt ( this->GetInput(), inputRegionForThread );
+  inputIt.GoToBegin();
+
+  itk::ImageScanlineIterator< OutputImageType > outputIt ( this->GetOutput(), outputRegionForThread );
+  outputIt.GoToBegin();
+
+  // support progress methods/callbacks
+  const itk::SizeValueType numberOfLinesToProcess =
+    outputRegionForThread.GetNumberOfPixels() / outputRegionForThread.GetSize(0);
+  itk::ProgressReporter progress(this, threadId, numberOfLinesToProcess);
+
+  // Single output pixel for the whole region, filled by the functor and
+  // copied in the output buffer
+  OutputImagePixelType outputPixel;
+  itk::NumericTraits< OutputImagePixelType >::SetLength( outputPixel,
+                                                         this->GetOutput()->GetNumberOfComponentsPerPixel() );
+
+  while ( !outputIt.IsAtEnd() && !inputIt.IsAtEnd() )
+  {
+    while ( !inputIt.IsAtEndOfLine() )
+    {
+      m_Functor( outputPixel, inputIt.Get() );
+      outputIt.Set( outputPixel );
+
+      ++inputIt;
+      ++outputIt;
+    }
+    inputIt.NextLine();
+    outputIt.NextLine();
+
+    progress.CompletedPixel();
+  }
+}
+
 } // end namespace otb
 
 #endif
@@ -66,6 +66,41 @@ ConfigurationManager::RAMValueType ConfigurationManager::GetMaxRAMHint()
   return value;
 }
 
+ConfigurationManager::RAMValueType ConfigurationManager::GetBlockCacheSize()
+{
+  std::string svalue;
+
+  RAMValueType value = 0;
+
+  if(itksys::SystemTools::GetEnv("OTB_BLOCK_CACHE_SIZE",svalue))
+    {
+    value = static_cast<RAMValueType>(strtoul(svalue.c_str(),nullptr,10));
+    }
+
+  return value;
+}
+
+ConfigurationManager::RAMValueType ConfigurationManager::GetDEMTileCacheSize()
+{
+  std::string svalue;
+
+  RAMValueType value = 0;
+
+  if(itksys::SystemTools::GetEnv("OTB_DEM_TILE_CACHE_SIZE",svalue))
+    {
+    value = static_cast<RAMValueType>(strtoul(svalue.c_str(),nullptr,10));
+    }
+
+  return value;
+}
+
+std::string ConfigurationManager::GetTraceFile()
+{
+  std::string svalue;
+  itksys::SystemTools::GetEnv("OTB_TRACE_FILE",svalue);
+  return svalue;
+}
+
 itk::LoggerBase::PriorityLevelType ConfigurationManager::GetLoggerLevel()
 {
   std::string svalue;
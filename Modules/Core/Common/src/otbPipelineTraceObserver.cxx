@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbPipelineTraceObserver.h"
+#include "itkImageBase.h"
+
+#include <set>
+
+namespace otb
+{
+
+PipelineTraceObserver
+::PipelineTraceObserver()
+  : m_Division(0)
+{
+  m_StartCommand = CommandType::New();
+  m_StartCommand->SetCallbackFunction(this, &PipelineTraceObserver::StartCallback);
+  m_EndCommand = CommandType::New();
+  m_EndCommand->SetCallbackFunction(this, &PipelineTraceObserver::EndCallback);
+}
+
+PipelineTraceObserver
+::~PipelineTraceObserver()
+{
+  this->Detach();
+}
+
+void
+PipelineTraceObserver
+::Attach(itk::DataObject * data)
+{
+  this->Detach();
+
+  std::set<itk::ProcessObject *> visited;
+  std::vector<itk::DataObject *> toVisit(1, data);
+
+  while (!toVisit.empty())
+    {
+    itk::DataObject * current = toVisit.back();
+    toVisit.pop_back();
+
+    itk::ProcessObject * source = current ? current->GetSource() : nullptr;
+    if (source == nullptr || !visited.insert(source).second)
+      {
+      continue;
+      }
+
+    Observation observation;
+    observation.process = source;
+    observation.startTag = source->AddObserver(itk::StartEvent(), m_StartCommand);
+    observation.endTag = source->AddObserver(itk::EndEvent(), m_EndCommand);
+    m_Observations.push_back(observation);
+
+    itk::ProcessObject::DataObjectPointerArray inputs = source->GetInputs();
+    for (unsigned int i = 0; i < inputs.size(); ++i)
+      {
+      if (inputs[i].IsNotNull())
+        {
+        toVisit.push_back(inputs[i].GetPointer());
+        }
+      }
+    }
+}
+
+void
+PipelineTraceObserver
+::Detach()
+{
+  for (std::vector<Observation>::iterator it = m_Observations.begin(); it != m_Observations.end(); ++it)
+    {
+    it->process->RemoveObserver(it->startTag);
+    it->process->RemoveObserver(it->endTag);
+    }
+  m_Observations.clear();
+  m_StartTimes.clear();
+}
+
+void
+PipelineTraceObserver
+::StartCallback(const itk::Object * caller, const itk::EventObject & itkNotUsed(event))
+{
+  m_StartTimes[caller] = Tracer::GetInstance().GetTime();
+}
+
+void
+PipelineTraceObserver
+::EndCallback(const itk::Object * caller, const itk::EventObject & itkNotUsed(event))
+{
+  std::map<const itk::Object *, Tracer::TimeType>::iterator start = m_StartTimes.find(caller);
+  if (start == m_StartTimes.end())
+    {
+    return;
+    }
+
+  Tracer & tracer = Tracer::GetInstance();
+  const Tracer::TimeType end = tracer.GetTime();
+
+  Tracer::ArgumentListType arguments;
+  arguments.push_back(std::make_pair(std::string("division"), Tracer::FormatArgument(m_Division)));
+
+  itk::ProcessObject * process = const_cast<itk::ProcessObject *>(dynamic_cast<const itk::ProcessObject *>(caller));
+  if (process != nullptr)
+    {
+    arguments.push_back(std::make_pair(std::string("threads"), Tracer::FormatArgument(process->GetNumberOfThreads())));
+
+    // Images processed by OTB pipelines are 2D
+    itk::ProcessObject::DataObjectPointerArray outputs = process->GetOutputs();
+    const itk::ImageBase<2> * output = outputs.empty()
+      ? nullptr
+      : dynamic_cast<const itk::ImageBase<2> *>(outputs[0].GetPointer());
+    if (output != nullptr)
+      {
+      const itk::ImageRegion<2> & region = output->GetRequestedRegion();
+      std::ostringstream oss;
+      oss << region.GetIndex()[0] << "," << region.GetIndex()[1] << " "
+          << region.GetSize()[0] << "x" << region.GetSize()[1];
+      arguments.push_back(std::make_pair(std::string("region"), Tracer::FormatArgument(oss.str())));
+      arguments.push_back(std::make_pair(std::string("pixels"), Tracer::FormatArgument(region.GetNumberOfPixels())));
+      }
+    }
+
+  tracer.AddCompleteEvent(caller->GetNameOfClass(), "filter", start->second, end - start->second, arguments);
+  m_StartTimes.erase(start);
+}
+
+} // end namespace otb
@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbTracer.h"
+#include "otbConfigurationManager.h"
+#include "itkMutexLockHolder.h"
+
+#include <fstream>
+#include <iomanip>
+
+namespace otb
+{
+
+Tracer &
+Tracer
+::GetInstance()
+{
+  static Tracer theUniqueInstance;
+  return theUniqueInstance;
+}
+
+Tracer
+::Tracer()
+  : m_Enabled(false),
+    m_Origin(std::chrono::steady_clock::now())
+{
+  const std::string fileName = ConfigurationManager::GetTraceFile();
+  if (!fileName.empty())
+    {
+    this->Start(fileName);
+    }
+}
+
+Tracer
+::~Tracer()
+{
+  if (this->IsEnabled())
+    {
+    this->Stop();
+    }
+}
+
+void
+Tracer
+::Start(const std::string & fileName)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  m_Events.clear();
+  m_FileName = fileName;
+  m_Enabled = true;
+}
+
+bool
+Tracer
+::Stop()
+{
+  std::string fileName;
+  {
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  m_Enabled = false;
+  fileName = m_FileName;
+  m_FileName.clear();
+  }
+
+  if (fileName.empty())
+    {
+    return true;
+    }
+  return this->Write(fileName);
+}
+
+Tracer::TimeType
+Tracer
+::GetTime() const
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - m_Origin).count();
+}
+
+unsigned int
+Tracer
+::GetCurrentThreadUnsafe()
+{
+  const std::thread::id id = std::this_thread::get_id();
+  std::map<std::thread::id, unsigned int>::const_iterator it = m_Threads.find(id);
+  if (it != m_Threads.end())
+    {
+    return it->second;
+    }
+  const unsigned int thread = static_cast<unsigned int>(m_Threads.size());
+  m_Threads[id] = thread;
+  return thread;
+}
+
+void
+Tracer
+::AddCompleteEvent(const std::string & name, const std::string & category,
+                   TimeType start, TimeType duration,
+                   const ArgumentListType & arguments)
+{
+  if (!this->IsEnabled())
+    {
+    return;
+    }
+
+  Event event;
+  event.name = name;
+  event.category = category;
+  event.phase = 'X';
+  event.time = start;
+  event.duration = duration;
+  event.arguments = arguments;
+
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  event.thread = this->GetCurrentThreadUnsafe();
+  m_Events.push_back(event);
+}
+
+void
+Tracer
+::AddCounterEvent(const std::string & name, TimeType time, double value)
+{
+  if (!this->IsEnabled())
+    {
+    return;
+    }
+
+  Event event;
+  event.name = name;
+  event.category = "counter";
+  event.phase = 'C';
+  event.time = time;
+  event.duration = 0;
+  event.arguments.push_back(std::make_pair(std::string("value"), FormatArgument(value)));
+
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  event.thread = this->GetCurrentThreadUnsafe();
+  m_Events.push_back(event);
+}
+
+void
+Tracer
+::SetCurrentThreadName(const std::string & name)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  m_ThreadNames[this->GetCurrentThreadUnsafe()] = name;
+}
+
+size_t
+Tracer
+::GetNumberOfEvents() const
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  return m_Events.size();
+}
+
+void
+Tracer
+::Clear()
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+  m_Events.clear();
+}
+
+std::string
+Tracer
+::Escape(const std::string & value)
+{
+  std::ostringstream oss;
+  for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+    {
+    switch (*it)
+      {
+      case '"':
+        oss << "\\\"";
+        break;
+      case '\\':
+        oss << "\\\\";
+        break;
+      case '\n':
+        oss << "\\n";
+        break;
+      case '\t':
+        oss << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(*it) < 0x20)
+          {
+          oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(*it) << std::dec;
+          }
+        else
+          {
+          oss << *it;
+          }
+      }
+    }
+  return oss.str();
+}
+
+std::string
+Tracer
+::FormatArgument(const std::string & value)
+{
+  return "\"" + Escape(value) + "\"";
+}
+
+std::string
+Tracer
+::FormatArgument(const char * value)
+{
+  return FormatArgument(std::string(value));
+}
+
+void
+Tracer
+::Write(std::ostream & os) const
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> lock(m_Mutex);
+
+  os << "{\"traceEvents\":[";
+
+  bool first = true;
+  for (std::map<unsigned int, std::string>::const_iterator it = m_ThreadNames.begin(); it != m_ThreadNames.end(); ++it)
+    {
+    os << (first ? "\n" : ",\n");
+    os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << it->first
+       << ",\"args\":{\"name\":\"" << Escape(it->second) << "\"}}";
+    first = false;
+    }
+
+  for (std::vector<Event>::const_iterator it = m_Events.begin(); it != m_Events.end(); ++it)
+    {
+    os << (first ? "\n" : ",\n");
+    os << "{\"name\":\"" << Escape(it->name) << "\",\"cat\":\"" << Escape(it->category)
+       << "\",\"ph\":\"" << it->phase << "\",\"ts\":" << it->time;
+    if (it->phase == 'X')
+      {
+      os << ",\"dur\":" << it->duration;
+      }
+    os << ",\"pid\":1,\"tid\":" << it->thread;
+    if (!it->arguments.empty())
+      {
+      os << ",\"args\":{";
+      for (ArgumentListType::const_iterator ait = it->arguments.begin(); ait != it->arguments.end(); ++ait)
+        {
+        os << (ait == it->arguments.begin() ? "" : ",") << "\"" << Escape(ait->first) << "\":" << ait->second;
+        }
+      os << "}";
+      }
+    os << "}";
+    first = false;
+    }
+
+  os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+bool
+Tracer
+::Write(const std::string & fileName) const
+{
+  std::ofstream ofs(fileName.c_str());
+  if (!ofs)
+    {
+    return false;
+    }
+  this->Write(ofs);
+  return ofs.good();
+}
+
+TraceScope
+::TraceScope(const char * name, const char * category)
+  : m_Enabled(Tracer::GetInstance().IsEnabled()),
+    m_Category(category),
+    m_Start(0)
+{
+  if (m_Enabled)
+    {
+    m_Name = name;
+    m_Start = Tracer::GetInstance().GetTime();
+    }
+}
+
+TraceScope
+::TraceScope(const std::string & name, const char * category)
+  : m_Enabled(Tracer::GetInstance().IsEnabled()),
+    m_Category(category),
+    m_Start(0)
+{
+  if (m_Enabled)
+    {
+    m_Name = name;
+    m_Start = Tracer::GetInstance().GetTime();
+    }
+}
+
+TraceScope
+::~TraceScope()
+{
+  if (m_Enabled)
+    {
+    Tracer & tracer = Tracer::GetInstance();
+    tracer.AddCompleteEvent(m_Name, m_Category, m_Start, tracer.GetTime() - m_Start, m_Arguments);
+    }
+}
+
+} // end namespace otb
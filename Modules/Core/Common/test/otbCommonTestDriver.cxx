@@ -28,6 +28,8 @@ void RegisterTests()
   REGISTER_TEST(otbRectangle);
   REGISTER_TEST(otbSystemTest);
   REGISTER_TEST(otbStopwatchTest);
+  REGISTER_TEST(otbTracerTest);
+  REGISTER_TEST(otbPyramidCascade);
   REGISTER_TEST(otbParseHdfSubsetName);
   REGISTER_TEST(otbParseHdfFileName);
   REGISTER_TEST(otbImageRegionSquareTileSplitter);
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "itkMacro.h"
+#include "otbPyramidCascade.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+namespace
+{
+// Straightforward reduction of a whole level into the next one
+template <class TValue>
+std::vector<TValue> ReduceLevel(const std::vector<TValue> & input, unsigned int width, unsigned int height,
+                                unsigned int nbComp, unsigned int factor, bool average)
+{
+  const unsigned int outWidth = (width + factor - 1) / factor;
+  const unsigned int outHeight = (height + factor - 1) / factor;
+  std::vector<TValue> output(outWidth * outHeight * nbComp);
+  for (unsigned int j = 0; j < outHeight; ++j)
+    {
+    for (unsigned int i = 0; i < outWidth; ++i)
+      {
+      for (unsigned int b = 0; b < nbComp; ++b)
+        {
+        double sum = 0.;
+        unsigned int count = 0;
+        for (unsigned int y = j * factor; y < std::min((j + 1) * factor, height); ++y)
+          {
+          for (unsigned int x = i * factor; x < std::min((i + 1) * factor, width); ++x)
+            {
+            sum += input[(y * width + x) * nbComp + b];
+            ++count;
+            }
+          }
+        const TValue nearest = input[(j * factor * width + i * factor) * nbComp + b];
+        const double mean = sum / count;
+        output[(j * outWidth + i) * nbComp + b] =
+          !average ? nearest : (std::is_integral<TValue>::value ? static_cast<TValue>(std::floor(mean + 0.5))
+                                                                : static_cast<TValue>(mean));
+        }
+      }
+    }
+  return output;
+}
+
+template <class TValue>
+bool CheckCascade(unsigned int width, unsigned int height, unsigned int nbComp, unsigned int factor,
+                  unsigned int nbLevels, bool average, unsigned int nbThreads, unsigned int maxStrip)
+{
+  typedef otb::PyramidCascade<TValue> CascadeType;
+
+  std::vector<TValue> image(width * height * nbComp);
+  for (size_t k = 0; k < image.size(); ++k)
+    {
+    image[k] = static_cast<TValue>((k * 7919) % 251);
+    }
+
+  // Levels received through the callback
+  std::vector<std::vector<TValue> > levels(nbLevels + 1);
+  std::vector<unsigned int> nextLines(nbLevels + 1, 0);
+  bool ordered = true;
+
+  CascadeType cascade;
+  cascade.SetNumberOfLevels(nbLevels);
+  cascade.SetShrinkFactor(factor);
+  cascade.SetResampling(average ? CascadeType::Average : CascadeType::Nearest);
+  cascade.SetNumberOfThreads(nbThreads);
+  cascade.SetCallback([&](unsigned int level, unsigned int firstLine, unsigned int nbLines, const TValue * buffer)
+    {
+    ordered = ordered && firstLine == nextLines[level];
+    nextLines[level] += nbLines;
+    levels[level].insert(levels[level].end(), buffer,
+                         buffer + nbLines * cascade.GetLevelWidth(level) * nbComp);
+    });
+  cascade.Initialize(width, height, nbComp);
+
+  // Strips of various heights
+  unsigned int line = 0;
+  for (unsigned int strip = 1; line < height; strip = strip % maxStrip + 1)
+    {
+    const unsigned int nbLines = std::min(strip, height - line);
+    cascade.PushLines(nbLines, image.data() + line * width * nbComp);
+    line += nbLines;
+    }
+
+  if (!cascade.IsComplete() || !ordered)
+    {
+    std::cerr << "Lines of the levels are not complete or not in order" << std::endl;
+    return false;
+    }
+
+  std::vector<TValue> expected = image;
+  unsigned int w = width, h = height;
+  for (unsigned int level = 1; level <= nbLevels; ++level)
+    {
+    expected = ReduceLevel(expected, w, h, nbComp, factor, average);
+    w = (w + factor - 1) / factor;
+    h = (h + factor - 1) / factor;
+    if (w != cascade.GetLevelWidth(level) || h != cascade.GetLevelHeight(level)
+        || h != otb::PyramidCascade<TValue>::GetLevelLength(height, factor, level))
+      {
+      std::cerr << "Wrong size of level " << level << std::endl;
+      return false;
+      }
+    if (levels[level] != expected)
+      {
+      std::cerr << "Wrong values in level " << level << " (" << width << "x" << height << ", factor "
+                << factor << ", " << (average ? "average" : "nearest") << ")" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int otbPyramidCascade(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  bool ok = true;
+  ok = CheckCascade<float>(37, 29, 3, 2, 4, true, 1, 7) && ok;
+  ok = CheckCascade<float>(300, 41, 2, 3, 3, true, 4, 7) && ok;
+  ok = CheckCascade<unsigned char>(37, 29, 1, 2, 3, true, 4, 7) && ok;
+  ok = CheckCascade<short>(64, 64, 4, 2, 6, true, 2, 7) && ok;
+  ok = CheckCascade<unsigned short>(37, 29, 3, 2, 4, false, 4, 7) && ok;
+  ok = CheckCascade<double>(5, 3, 1, 2, 5, true, 4, 7) && ok;
+
+  // Block lines large enough to be reduced by several threads
+  ok = CheckCascade<float>(2001, 203, 3, 2, 3, true, 4, 64) && ok;
+  ok = CheckCascade<unsigned short>(2001, 203, 1, 2, 3, false, 4, 64) && ok;
+
+  // Pushing too many lines is an error
+  otb::PyramidCascade<float> cascade;
+  cascade.Initialize(4, 2, 1);
+  std::vector<float> lines(4 * 3);
+  try
+    {
+    cascade.PushLines(3, lines.data());
+    std::cerr << "Pushing too many lines should throw" << std::endl;
+    ok = false;
+    }
+  catch (itk::ExceptionObject &)
+    {
+    }
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+
+#include "itkMacro.h"
+#include "itkImage.h"
+
+#include "otbTracer.h"
+#include "otbPipelineTraceObserver.h"
+#include "otbUnaryFunctorImageFilter.h"
+
+namespace
+{
+
+class ScaleFunctor
+{
+public:
+  float operator()(const float & value) const
+  {
+    return 2 * value;
+  }
+
+  bool operator !=(const ScaleFunctor &) const
+  {
+    return false;
+  }
+
+  bool operator ==(const ScaleFunctor &) const
+  {
+    return true;
+  }
+
+  unsigned int GetOutputSize() const
+  {
+    return 1;
+  }
+};
+
+unsigned int CountOccurrences(const std::string & text, const std::string & pattern)
+{
+  unsigned int count = 0;
+  for (std::string::size_type pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+    {
+    ++count;
+    }
+  return count;
+}
+
+}
+
+int otbTracerTest(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  typedef itk::Image<float, 2>                                            ImageType;
+  typedef otb::UnaryFunctorImageFilter<ImageType, ImageType, ScaleFunctor> FilterType;
+
+  otb::Tracer & tracer = otb::Tracer::GetInstance();
+
+  // Nothing is recorded while the tracer is disabled
+  tracer.Stop();
+  tracer.Clear();
+  {
+  otb::TraceScope scope("Disabled", "test");
+  }
+  if (tracer.GetNumberOfEvents() != 0)
+    {
+    std::cerr << "Events recorded while the tracer is disabled" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  tracer.Start();
+  tracer.SetCurrentThreadName("Main");
+  {
+  otb::TraceScope scope("Scope \"quoted\"", "test");
+  scope.AddArgument("bytes", 1024);
+  scope.AddArgument("file", "C:\\data\\image.tif");
+  }
+  tracer.AddCounterEvent("Memory", tracer.GetTime(), 12.5);
+
+  // Two filters, each executed once per division
+  ImageType::RegionType region;
+  region.SetSize(0, 64);
+  region.SetSize(1, 64);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(1.);
+
+  FilterType::Pointer filter1 = FilterType::New();
+  filter1->SetInput(image);
+  FilterType::Pointer filter2 = FilterType::New();
+  filter2->SetInput(filter1->GetOutput());
+
+  {
+  otb::PipelineTraceObserver observer;
+  observer.Attach(filter2->GetOutput());
+
+  filter2->UpdateOutputInformation();
+  for (unsigned int division = 0; division < 2; ++division)
+    {
+    ImageType::RegionType split = region;
+    split.SetIndex(1, 32 * division);
+    split.SetSize(1, 32);
+
+    observer.SetDivision(division);
+    filter2->GetOutput()->SetRequestedRegion(split);
+    filter2->GetOutput()->PropagateRequestedRegion();
+    filter2->GetOutput()->UpdateOutputData();
+    }
+  }
+
+  // The observer is detached: this update is not recorded
+  filter1->Modified();
+  filter2->Update();
+
+  tracer.Stop();
+
+  std::ostringstream oss;
+  tracer.Write(oss);
+  const std::string trace = oss.str();
+  std::cout << trace;
+
+  if (tracer.GetNumberOfEvents() != 6)
+    {
+    std::cerr << "Expected 6 events, got " << tracer.GetNumberOfEvents() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (trace.find("{\"traceEvents\":[") != 0
+      || trace.find("\"Scope \\\"quoted\\\"\"") == std::string::npos
+      || trace.find("\"file\":\"C:\\\\data\\\\image.tif\"") == std::string::npos
+      || trace.find("\"bytes\":1024") == std::string::npos
+      || trace.find("\"ph\":\"C\"") == std::string::npos
+      || trace.find("\"args\":{\"name\":\"Main\"}") == std::string::npos
+      || CountOccurrences(trace, "\"name\":\"UnaryFunctorImageFilter\"") != 4
+      || CountOccurrences(trace, "\"division\":1") != 2
+      || CountOccurrences(trace, "\"pixels\":2048") != 4)
+    {
+    std::cerr << "Unexpected trace content" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
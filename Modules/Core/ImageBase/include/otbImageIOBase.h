@@ -300,6 +300,17 @@ public:
    * Returns: overview info, empty if none. */ 
   virtual std::vector<std::string> GetOverviewsInfo() = 0;
 
+  /** Get the largest resolution factor k, with 2^k lower than or equal
+   * to the given decimation, for which the file holds a native coarser
+   * level (overview or JPEG2000 resolution level). Reading with this
+   * factor (see the resol extended filename option) then decodes that
+   * level instead of the full resolution.
+   * Returns: 0 if the file has no such level. */
+  virtual unsigned int GetNativeResolutionFactor(unsigned int itkNotUsed(decimation))
+  {
+    return 0;
+  }
+
   /** Provide hist about the output container to deal with complex pixel
    *  type */ 
   virtual void SetOutputImagePixelType( bool isComplexInternalPixelType, 
@@ -351,6 +362,20 @@ public:
    * pointer to the beginning of the image data. */
   virtual void Write( const void* buffer) = 0;
 
+  /** Determine if regions can be written concurrently to this file with
+   * WriteRegion(). Default is false. */
+  virtual bool CanWriteRegionsConcurrently()
+    {
+    return false;
+    }
+
+  /** Writes the given region to disk from the memory buffer provided.
+   * Unlike Write(), the IORegion is not used: several threads may call
+   * this method at the same time, on regions which do not overlap,
+   * provided that CanWriteRegionsConcurrently() returns true. The default
+   * implementation throws an exception. */
+  virtual void WriteRegion(const itk::ImageIORegion & region, const void* buffer);
+
   /* --- Support reading and writing data as a series of files. --- */
 
   /** The different types of ImageIO's can support data of varying
@@ -429,6 +454,15 @@ public:
    * conversion)*/
   void DoMapBuffer(void* buffer, size_t numberOfPixels, std::vector<unsigned int>& bandList);
 
+  /** Same as DoMapBuffer(), for a buffer of pixels with the given component
+   *  size and number of components. This function does not use the state
+   *  of an ImageIO, so it can be called from any thread. */
+  static void MapBuffer(void* buffer,
+                        size_t numberOfPixels,
+                        size_t componentSize,
+                        unsigned int numberOfComponents,
+                        const std::vector<unsigned int>& bandList);
+
   /** Returns a const ref to the list of attached files*/
   itkGetConstReferenceMacro(AttachedFileNames, std::vector<std::string> );
 
@@ -1192,6 +1192,13 @@ ImageIOBase::GetSplitRegionForWriting(unsigned int ithPiece,
   return largestPossibleRegion;
 }
 
+void
+ImageIOBase
+::WriteRegion(const itk::ImageIORegion & itkNotUsed(region), const void* itkNotUsed(buffer))
+{
+  itkExceptionMacro(<< "Concurrent writing of regions is not supported by " << this->GetNameOfClass());
+}
+
 /** Given a requested region, determine what could be the region that we can
  * read from the file. This is called the streamable region, which will be
  * smaller than the LargestPossibleRegion and greater or equal to the
@@ -1276,8 +1283,18 @@ void
 ImageIOBase
 ::DoMapBuffer(void* buffer, size_t numberOfPixels, std::vector<unsigned int>& bandList)
 {
-  size_t componentSize = this->GetComponentSize();
-  size_t inPixelSize = componentSize * this->GetNumberOfComponents();
+  MapBuffer(buffer, numberOfPixels, this->GetComponentSize(), this->GetNumberOfComponents(), bandList);
+}
+
+void
+ImageIOBase
+::MapBuffer(void* buffer,
+            size_t numberOfPixels,
+            size_t componentSize,
+            unsigned int numberOfComponents,
+            const std::vector<unsigned int>& bandList)
+{
+  size_t inPixelSize = componentSize * numberOfComponents;
   size_t outPixelSize = componentSize * bandList.size();
   char* inPos = static_cast<char*>(buffer);
   char* outPos = static_cast<char*>(buffer);
@@ -24,6 +24,7 @@
 #include "itkInterpolateImageFunction.h"
 #include "vnl/vnl_vector.h"
 #include "otbMath.h"
+#include "otbSeparableInterpolationKernel.h"
 
 #include "otbVectorImage.h"
 
@@ -48,13 +49,17 @@ namespace otb
  * spline) is known to produce the best approximation of the original
  * function.
  *
+ * The kernel is separable: resampling filters may evaluate it through
+ * the SeparableInterpolationKernel interface.
+ *
  * \ingroup ImageFunctions ImageInterpolators
  *
  * \ingroup OTBInterpolation
  */
 template< class TInputImage, class TCoordRep = double >
 class ITK_EXPORT BCOInterpolateImageFunctionBase :
-  public itk::InterpolateImageFunction<TInputImage, TCoordRep>
+  public itk::InterpolateImageFunction<TInputImage, TCoordRep>,
+  public SeparableInterpolationKernel
 {
 public:
   /** Standard class typedefs. */
@@ -111,12 +116,21 @@ public:
    * calling the method. */
   OutputType EvaluateAtContinuousIndex( const ContinuousIndexType & index ) const override = 0;
 
+  /** Size of the window, 2*Radius+1 */
+  unsigned int GetKernelSize() const override;
+
+  /** BCO coefficients along one dimension, the first one applying to
+   *  the pixel at Radius before the nearest pixel */
+  long ComputeKernelWeights(double coordinate, double * weights) const override;
+
 protected:
   BCOInterpolateImageFunctionBase() : m_Radius(2), m_WinSize(5), m_Alpha(-0.5) {};
   ~BCOInterpolateImageFunctionBase() override {};
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
   /** Compute the BCO coefficients. */
   virtual CoefContainerType EvaluateCoef( const ContinuousIndexValueType & indexValue ) const;
+  /** Compute the BCO coefficients into a buffer of WinSize values. */
+  void ComputeCoef( const ContinuousIndexValueType & indexValue, double * coef ) const;
   
     /** Used radius for the BCO */
   unsigned int           m_Radius;
@@ -80,8 +80,16 @@ BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
 ::EvaluateCoef( const ContinuousIndexValueType & indexValue ) const
 {
   // Init BCO coefficient container
-
   CoefContainerType BCOCoef(m_WinSize, 0.);
+  this->ComputeCoef(indexValue, BCOCoef.data_block());
+  return BCOCoef;
+}
+
+template<class TInputImage, class TCoordRep>
+void
+BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::ComputeCoef( const ContinuousIndexValueType & indexValue, double * BCOCoef ) const
+{
   double offset, dist, position, step;
 
   offset = indexValue - itk::Math::Floor<IndexValueType>(indexValue+0.5);
@@ -122,8 +130,24 @@ BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
 
   for ( unsigned int i = 0; i < m_WinSize; ++i)
     BCOCoef[i] = BCOCoef[i] / sum;
+}
 
-  return BCOCoef;
+template <class TInputImage, class TCoordRep>
+unsigned int BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::GetKernelSize() const
+{
+  return m_WinSize;
+}
+
+template <class TInputImage, class TCoordRep>
+long BCOInterpolateImageFunctionBase<TInputImage, TCoordRep>
+::ComputeKernelWeights(double coordinate, double * weights) const
+{
+  // Same rounding as EvaluateAtContinuousIndex()
+  const ContinuousIndexValueType indexValue = static_cast<ContinuousIndexValueType>(coordinate);
+  this->ComputeCoef(indexValue, weights);
+  return static_cast<long>(itk::Math::Floor< IndexValueType >( indexValue+0.5 ))
+    - static_cast<long>(m_Radius);
 }
 
 template <class TInputImage, class TCoordRep>
@@ -24,6 +24,7 @@
 #include "itkInterpolateImageFunction.h"
 #include "itkConstNeighborhoodIterator.h"
 #include "itkConstantBoundaryCondition.h"
+#include "otbSeparableInterpolationKernel.h"
 
 namespace otb
 {
@@ -36,6 +37,10 @@ namespace otb
  *
  * The Initialize() method need to be call to create the filter.
  *
+ * With the zero flux Neumann and the constant boundary conditions, the
+ * kernel can also be evaluated through the SeparableInterpolationKernel
+ * interface by the resampling filters.
+ *
  * \ingroup ImageFunctions ImageInterpolators
  *
  * \ingroup OTBInterpolation
@@ -43,7 +48,8 @@ namespace otb
 template <class TInputImage, class TFunction, class TBoundaryCondition = itk::ZeroFluxNeumannBoundaryCondition<TInputImage>,
     class TCoordRep = double>
 class ITK_EXPORT GenericInterpolateImageFunction :
-  public itk::InterpolateImageFunction<TInputImage, TCoordRep>
+  public itk::InterpolateImageFunction<TInputImage, TCoordRep>,
+  public SeparableInterpolationKernel
 {
 public:
   /** Standard class typedefs. */
@@ -88,6 +94,19 @@ public:
    * calling the method. */
   OutputType EvaluateAtContinuousIndex(const ContinuousIndexType& index) const override;
 
+  /** Size of the window, twice the radius. Returns 0 if the tables
+   *  have not been initialized, or with other boundary conditions than
+   *  the zero flux Neumann and the constant ones. */
+  unsigned int GetKernelSize() const override;
+
+  /** Value of the pixels outside the buffered region, according to
+   *  the boundary condition */
+  BoundaryType GetKernelBoundary() const override;
+
+  /** Weights of the window along one dimension, the first one applying
+   *  to the pixel at Radius-1 before the floor of the coordinate */
+  long ComputeKernelWeights(double coordinate, double * weights) const override;
+
   /** Set/Get the window radius*/
   virtual void SetRadius(unsigned int rad);
   virtual unsigned int GetRadius() const
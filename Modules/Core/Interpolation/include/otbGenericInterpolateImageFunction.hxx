@@ -23,6 +23,8 @@
 #include "otbGenericInterpolateImageFunction.h"
 #include "vnl/vnl_math.h"
 
+#include <type_traits>
+
 namespace otb
 {
 
@@ -319,6 +321,74 @@ GenericInterpolateImageFunction<TInputImage, TFunction, TBoundaryCondition, TCoo
   return static_cast<OutputType>(xPixelValue);
 }
 
+template<class TInputImage, class TFunction, class TBoundaryCondition, class TCoordRep>
+unsigned int
+GenericInterpolateImageFunction<TInputImage, TFunction, TBoundaryCondition, TCoordRep>
+::GetKernelSize() const
+{
+  // The constant of the boundary condition of the iterator is never
+  // set: it is zero
+  const bool supported =
+    std::is_same<TBoundaryCondition, itk::ZeroFluxNeumannBoundaryCondition<TInputImage> >::value
+    || std::is_same<TBoundaryCondition, itk::ConstantBoundaryCondition<TInputImage> >::value;
+  if (!m_TablesHaveBeenGenerated || !supported)
+    {
+    return 0;
+    }
+  return m_WindowSize;
+}
+
+template<class TInputImage, class TFunction, class TBoundaryCondition, class TCoordRep>
+typename GenericInterpolateImageFunction<TInputImage, TFunction, TBoundaryCondition, TCoordRep>::BoundaryType
+GenericInterpolateImageFunction<TInputImage, TFunction, TBoundaryCondition, TCoordRep>
+::GetKernelBoundary() const
+{
+  if (std::is_same<TBoundaryCondition, itk::ConstantBoundaryCondition<TInputImage> >::value)
+    {
+    return BOUNDARY_ZERO;
+    }
+  return BOUNDARY_NEAREST;
+}
+
+template<class TInputImage, class TFunction, class TBoundaryCondition, class TCoordRep>
+long
+GenericInterpolateImageFunction<TInputImage, TFunction, TBoundaryCondition, TCoordRep>
+::ComputeKernelWeights(double coordinate, double * weights) const
+{
+  // Same computation as EvaluateAtContinuousIndex()
+  const double index = static_cast<TCoordRep>(coordinate);
+  long baseIndex = static_cast<long>(index);
+  if (index < 0.0 && double(baseIndex) != index)
+    {
+    baseIndex--;
+    }
+  double x = index - double(baseIndex) + this->GetRadius();
+
+  for (unsigned int i = 0; i < m_WindowSize; ++i)
+    {
+    x -= 1.0;
+    weights[i] = m_Function(x);
+    }
+
+  if (m_NormalizeWeight == true)
+    {
+    double sum = 0.;
+    for (unsigned int i = 0; i < m_WindowSize; ++i)
+      {
+      sum += weights[i];
+      }
+    if (sum != 1.)
+      {
+      for (unsigned int i = 0; i < m_WindowSize; ++i)
+        {
+        weights[i] = weights[i] / sum;
+        }
+      }
+    }
+
+  return baseIndex - static_cast<long>(this->GetRadius()) + 1;
+}
+
 template<class TInputImage, class TFunction, class TBoundaryCondition, class TCoordRep>
 void
 GenericInterpolateImageFunction<TInputImage, TFunction, TBoundaryCondition, TCoordRep>
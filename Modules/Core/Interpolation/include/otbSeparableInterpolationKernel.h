@@ -0,0 +1,261 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbSeparableInterpolationKernel_h
+#define otbSeparableInterpolationKernel_h
+
+#include "itkImageBase.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace otb
+{
+
+/** \class SeparableInterpolationKernel
+ *  \brief Interface of the interpolators whose kernel is separable
+ *
+ * Interpolators implementing this interface compute their value at a
+ * continuous index as a weighted sum of the pixels of a window, with
+ * weights that are the product of one weight per dimension. Pixels
+ * outside the buffered region of the input image are either replaced by
+ * the nearest pixel of the region (zero flux Neumann boundary
+ * condition) or by zero (constant boundary condition).
+ *
+ * This allows the resampling filters to compute the weights once per
+ * output pixel (or once per output line and column when the
+ * transform is a scale and a translation), and to apply them to all
+ * the bands of the image at once. See SeparableKernelEvaluator.
+ *
+ * \sa BCOInterpolateImageFunction
+ * \sa GenericInterpolateImageFunction
+ *
+ * \ingroup OTBInterpolation
+ */
+class SeparableInterpolationKernel
+{
+public:
+  /** Value of the pixels outside the buffered region */
+  typedef enum
+  {
+    BOUNDARY_NEAREST,
+    BOUNDARY_ZERO
+  } BoundaryType;
+
+  virtual ~SeparableInterpolationKernel() {}
+
+  /** Number of pixels weighted along each dimension. Returns 0 when
+   *  the kernel can not be used, in which case the interpolator has to
+   *  be evaluated as usual. */
+  virtual unsigned int GetKernelSize() const = 0;
+
+  /** Compute the GetKernelSize() weights of the kernel at a continuous
+   *  index coordinate, along any dimension. Returns the index of the
+   *  pixel the first weight applies to, the next weights apply to the
+   *  next pixels. */
+  virtual long ComputeKernelWeights(double coordinate, double * weights) const = 0;
+
+  /** Value of the pixels outside the buffered region */
+  virtual BoundaryType GetKernelBoundary() const
+  {
+    return BOUNDARY_NEAREST;
+  }
+};
+
+/** \class SeparableKernelEvaluator
+ *  \brief Apply a separable interpolation kernel to all the bands of an image
+ *
+ * The weights of the kernel along each dimension are computed into
+ * Taps, holding the weights and the offsets in the image buffer of the
+ * pixels they apply to. Evaluate() then accumulates the pixels of the
+ * window, all the bands of a pixel at a time: pixels of an Image or a
+ * VectorImage are contiguous in memory, so that the compiler can
+ * vectorize the loop over the bands.
+ *
+ * The sums are computed in the same order as BCOInterpolateImageFunction,
+ * one column of the window after the other.
+ *
+ * Only 2D images whose buffer is made of scalars (Image and VectorImage
+ * of arithmetic types) are supported. An evaluator holds a buffer for
+ * its intermediate sums: each thread must use its own copy.
+ *
+ * \ingroup OTBInterpolation
+ */
+template <class TInputImage>
+class SeparableKernelEvaluator
+{
+public:
+  typedef TInputImage                               ImageType;
+  typedef typename ImageType::InternalPixelType     InternalPixelType;
+  typedef typename ImageType::RegionType            RegionType;
+
+  /** Weights of the kernel along one dimension, and offsets in the
+   *  image buffer of the pixels they apply to */
+  struct Taps
+  {
+    std::vector<double>         weights;
+    std::vector<std::ptrdiff_t> offsets;
+  };
+
+  SeparableKernelEvaluator()
+    : m_Kernel(nullptr),
+      m_Buffer(nullptr),
+      m_NumberOfComponents(0),
+      m_KernelSize(0),
+      m_ZeroBoundary(false)
+  {
+    m_Start[0] = m_Start[1] = 0;
+    m_End[0] = m_End[1] = 0;
+    m_Stride[0] = m_Stride[1] = 0;
+  }
+
+  /** Check the kernel of an interpolator can be applied to an image,
+   *  and prepare the evaluation. The interpolator is usually an
+   *  itk::InterpolateImageFunction, and is used if it implements
+   *  SeparableInterpolationKernel. Returns false if it can not be
+   *  used. */
+  template <class TInterpolator>
+  bool Initialize(const TInterpolator * interpolator, const ImageType * image)
+  {
+    m_Kernel = dynamic_cast<const SeparableInterpolationKernel *>(interpolator);
+    m_KernelSize = m_Kernel != nullptr ? m_Kernel->GetKernelSize() : 0;
+    m_ZeroBoundary = m_Kernel != nullptr
+      && m_Kernel->GetKernelBoundary() == SeparableInterpolationKernel::BOUNDARY_ZERO;
+
+    if (m_KernelSize == 0 || image == nullptr || ImageType::ImageDimension != 2
+        || !std::is_arithmetic<InternalPixelType>::value)
+      {
+      m_Kernel = nullptr;
+      return false;
+      }
+
+    const RegionType & region = image->GetBufferedRegion();
+    if (region.GetNumberOfPixels() == 0)
+      {
+      m_Kernel = nullptr;
+      return false;
+      }
+
+    m_Buffer = image->GetBufferPointer();
+    m_NumberOfComponents = image->GetNumberOfComponentsPerPixel();
+    for (unsigned int dim = 0; dim < 2; ++dim)
+      {
+      m_Start[dim] = region.GetIndex()[dim];
+      m_End[dim] = region.GetIndex()[dim] + static_cast<long>(region.GetSize()[dim]) - 1;
+      }
+    m_Stride[0] = m_NumberOfComponents;
+    m_Stride[1] = static_cast<std::ptrdiff_t>(region.GetSize()[0]) * m_NumberOfComponents;
+    m_Line.resize(m_NumberOfComponents);
+    return true;
+  }
+
+  /** True if Initialize() succeeded */
+  bool IsValid() const
+  {
+    return m_Kernel != nullptr;
+  }
+
+  unsigned int GetNumberOfComponents() const
+  {
+    return m_NumberOfComponents;
+  }
+
+  /** Compute the weights at a continuous index coordinate along a
+   *  dimension (0 for columns, 1 for lines) */
+  void ComputeTaps(double coordinate, unsigned int dim, Taps & taps) const
+  {
+    taps.weights.resize(m_KernelSize);
+    taps.offsets.resize(m_KernelSize);
+
+    const long first = m_Kernel->ComputeKernelWeights(coordinate, taps.weights.data());
+    for (unsigned int i = 0; i < m_KernelSize; ++i)
+      {
+      const long unclamped = first + static_cast<long>(i);
+      const long index = std::min(std::max(unclamped, m_Start[dim]), m_End[dim]);
+      taps.offsets[i] = (index - m_Start[dim]) * m_Stride[dim];
+      if (m_ZeroBoundary && index != unclamped)
+        {
+        // The whole line or column of the window is outside the buffer
+        taps.weights[i] = 0.;
+        }
+      }
+  }
+
+  /** Interpolated value of all the bands, from the weights along the
+   *  columns (x) and the lines (y) */
+  void Evaluate(const Taps & x, const Taps & y, double * values)
+  {
+    const unsigned int nbComponents = m_NumberOfComponents;
+    double * line = m_Line.data();
+
+    std::fill(values, values + nbComponents, 0.);
+
+    for (unsigned int i = 0; i < m_KernelSize; ++i)
+      {
+      std::fill(line, line + nbComponents, 0.);
+      const InternalPixelType * column = m_Buffer + x.offsets[i];
+      for (unsigned int j = 0; j < m_KernelSize; ++j)
+        {
+        const InternalPixelType * pixel = column + y.offsets[j];
+        const double weight = y.weights[j];
+        for (unsigned int k = 0; k < nbComponents; ++k)
+          {
+          line[k] += ToReal(pixel[k]) * weight;
+          }
+        }
+      const double weight = x.weights[i];
+      for (unsigned int k = 0; k < nbComponents; ++k)
+        {
+        values[k] += line[k] * weight;
+        }
+      }
+  }
+
+private:
+  /** Pixels of non arithmetic types are rejected by Initialize(), this
+   *  overload only allows the class to be instantiated for them */
+  template <class T>
+  static typename std::enable_if<std::is_arithmetic<T>::value, double>::type ToReal(const T & value)
+  {
+    return static_cast<double>(value);
+  }
+
+  template <class T>
+  static typename std::enable_if<!std::is_arithmetic<T>::value, double>::type ToReal(const T &)
+  {
+    return 0.;
+  }
+
+  const SeparableInterpolationKernel * m_Kernel;
+  const InternalPixelType *            m_Buffer;
+  unsigned int                         m_NumberOfComponents;
+  unsigned int                         m_KernelSize;
+  bool                                 m_ZeroBoundary;
+  long                                 m_Start[2];
+  long                                 m_End[2];
+  std::ptrdiff_t                       m_Stride[2];
+  std::vector<double>                  m_Line;
+};
+
+} // end namespace otb
+
+#endif
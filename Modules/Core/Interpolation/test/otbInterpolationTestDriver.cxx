@@ -39,4 +39,5 @@ void RegisterTests()
   REGISTER_TEST(otbBCOInterpolateImageFunctionVectorImageTest);
   REGISTER_TEST(otbProlateInterpolateImageFunction);
   REGISTER_TEST(otbProlateValidationTest);
+  REGISTER_TEST(otbSeparableInterpolationKernel);
 }
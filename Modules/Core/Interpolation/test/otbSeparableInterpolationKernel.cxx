@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "itkMacro.h"
+
+#include "otbSeparableInterpolationKernel.h"
+#include "otbBCOInterpolateImageFunction.h"
+#include "otbWindowedSincInterpolateImageLanczosFunction.h"
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+// Fill an image whose buffered region does not start at the origin
+template <class TImage>
+typename TImage::Pointer CreateImage(unsigned int nbBands)
+{
+  typename TImage::IndexType index;
+  index[0] = 5;
+  index[1] = -3;
+  typename TImage::SizeType size;
+  size[0] = 41;
+  size[1] = 29;
+  typename TImage::RegionType region(index, size);
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<TImage> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    typename TImage::PixelType pixel = it.Get();
+    for (unsigned int b = 0; b < nbBands; ++b)
+      {
+      const double value = 100. + 80. * std::sin(0.31 * it.GetIndex()[0] + b) * std::cos(0.17 * it.GetIndex()[1] * (b + 1));
+      itk::DefaultConvertPixelTraits<typename TImage::PixelType>::SetNthComponent(b, pixel, value);
+      }
+    it.Set(pixel);
+    }
+  return image;
+}
+
+// Compare the evaluation of the kernel with the interpolator, all over
+// the buffered region and its border
+template <class TImage, class TInterpolator>
+bool CheckKernel(const TImage * image, const TInterpolator * interpolator,
+                 double tolerance, const char * name)
+{
+  typedef itk::DefaultConvertPixelTraits<typename TInterpolator::OutputType> ConvertType;
+
+  otb::SeparableKernelEvaluator<TImage> evaluator;
+  if (!evaluator.Initialize(interpolator, image))
+    {
+    std::cerr << name << ": the kernel should be separable" << std::endl;
+    return false;
+    }
+
+  typename otb::SeparableKernelEvaluator<TImage>::Taps xTaps, yTaps;
+  std::vector<double> values(evaluator.GetNumberOfComponents());
+
+  const typename TImage::RegionType & region = image->GetBufferedRegion();
+  double maxError = 0.;
+
+  typename TInterpolator::ContinuousIndexType index;
+  for (double y = region.GetIndex()[1] - 0.5; y < region.GetIndex()[1] + region.GetSize()[1] - 0.5; y += 0.37)
+    {
+    for (double x = region.GetIndex()[0] - 0.5; x < region.GetIndex()[0] + region.GetSize()[0] - 0.5; x += 0.53)
+      {
+      index[0] = x;
+      index[1] = y;
+      const typename TInterpolator::OutputType expected = interpolator->EvaluateAtContinuousIndex(index);
+
+      evaluator.ComputeTaps(x, 0, xTaps);
+      evaluator.ComputeTaps(y, 1, yTaps);
+      evaluator.Evaluate(xTaps, yTaps, values.data());
+
+      for (unsigned int b = 0; b < values.size(); ++b)
+        {
+        maxError = std::max(maxError, std::abs(values[b] - ConvertType::GetNthComponent(b, expected)));
+        }
+      }
+    }
+
+  std::cout << name << ": maximum difference " << maxError << std::endl;
+
+  if (maxError > tolerance)
+    {
+    std::cerr << name << ": the kernel differs from the interpolator (" << maxError << " > " << tolerance << ")" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end anonymous namespace
+
+int otbSeparableInterpolationKernel(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  typedef otb::VectorImage<float, 2>                                  VectorImageType;
+  typedef otb::Image<double, 2>                                       ImageType;
+  typedef otb::BCOInterpolateImageFunction<VectorImageType>           VectorBCOType;
+  typedef otb::BCOInterpolateImageFunction<ImageType>                 BCOType;
+  typedef otb::WindowedSincInterpolateImageLanczosFunction<ImageType> LanczosType;
+  typedef otb::WindowedSincInterpolateImageLanczosFunction
+    <ImageType, itk::ZeroFluxNeumannBoundaryCondition<ImageType> >   LanczosNeumannType;
+
+  VectorImageType::Pointer vectorImage = CreateImage<VectorImageType>(13);
+  ImageType::Pointer image = CreateImage<ImageType>(1);
+
+  bool ok = true;
+
+  // The BCO kernel sums the pixels in the same order as the interpolator
+  VectorBCOType::Pointer vectorBCO = VectorBCOType::New();
+  vectorBCO->SetInputImage(vectorImage);
+  vectorBCO->SetRadius(3);
+  ok = CheckKernel(vectorImage.GetPointer(), vectorBCO.GetPointer(), 0., "BCO (VectorImage)") && ok;
+
+  BCOType::Pointer bco = BCOType::New();
+  bco->SetInputImage(image);
+  bco->SetAlpha(-0.75);
+  ok = CheckKernel(image.GetPointer(), bco.GetPointer(), 0., "BCO (Image)") && ok;
+
+  // The windowed sinc interpolators sum the pixels in another order
+  LanczosType::Pointer lanczos = LanczosType::New();
+  lanczos->SetInputImage(image);
+  lanczos->SetRadius(3);
+
+  otb::SeparableKernelEvaluator<ImageType> evaluator;
+  if (evaluator.Initialize(lanczos.GetPointer(), image.GetPointer()))
+    {
+    std::cerr << "The kernel should not be used before Initialize()" << std::endl;
+    ok = false;
+    }
+
+  lanczos->Initialize();
+  ok = CheckKernel(image.GetPointer(), lanczos.GetPointer(), 1e-9, "Lanczos (constant boundary)") && ok;
+
+  LanczosNeumannType::Pointer lanczosNeumann = LanczosNeumannType::New();
+  lanczosNeumann->SetInputImage(image);
+  lanczosNeumann->SetRadius(4);
+  lanczosNeumann->Initialize();
+  ok = CheckKernel(image.GetPointer(), lanczosNeumann.GetPointer(), 1e-9, "Lanczos (zero flux Neumann boundary)") && ok;
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -106,10 +106,13 @@ ImageListToVectorImageFilter<TImageList, TVectorImage>
   OutputIteratorType outputIt(outputPtr, outputPtr->GetRequestedRegion());
   outputIt.GoToBegin();
 
+  // Single output pixel, filled for each position and copied in the
+  // output buffer
+  typename OutputVectorImageType::PixelType pixel(black.GetSize());
+
   while (!outputIt.IsAtEnd())
     {
-    typename OutputVectorImageType::PixelType pixel = outputIt.Get();
-    unsigned int                              counter = 0;
+    unsigned int counter = 0;
     // for each input iterator, fill the right component
     for (typename InputIteratorListType::iterator it = inputIteratorList.begin();
          it != inputIteratorList.end(); ++it)
@@ -121,6 +124,11 @@ ImageListToVectorImageFilter<TImageList, TVectorImage>
         ++counter;
         }
       }
+    // remaining components are left black
+    for (; counter < pixel.GetSize(); ++counter)
+      {
+      pixel[counter] = 0;
+      }
     outputIt.Set(pixel);
     progress.CompletedPixel();
     ++outputIt;
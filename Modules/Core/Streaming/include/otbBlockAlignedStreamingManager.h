@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbBlockAlignedStreamingManager_h
+#define otbBlockAlignedStreamingManager_h
+
+#include "otbStreamingManager.h"
+
+#include <vector>
+
+namespace otb
+{
+
+/** \class BlockAlignedStreamingManager
+ *  \brief This class computes the divisions needed to stream an image
+ *  so that they follow the block grids of all the input files.
+ *
+ * RAMDrivenAdaptativeStreamingManager only knows the TileHint found in
+ * the MetaDataDictionary of the image to write. When the pipeline reads
+ * several files, or when the splits do not match the internal blocks
+ * of a file, the blocks crossed by a split border are decoded once per
+ * split, which is expensive for compressed formats (JPEG2000, COG).
+ *
+ * This streaming manager walks the pipeline upstream of the image to
+ * write and collects the block grid (TileHintX, TileHintY) of every
+ * reader whose output lies on the same pixel grid as the written
+ * image. The splits are then made of whole cells of the union of these
+ * grids: a cell is the smallest region whose borders are block borders
+ * in every grid. If such cells are too large for the available RAM,
+ * the grids with the smallest blocks are ignored first.
+ *
+ * The number of bytes of input blocks read more than once with the
+ * computed splits is estimated, logged, and available through
+ * GetBytesReadMoreThanOnce().
+ *
+ * You can use SetAvailableRAMInMB to set the available RAM. An
+ * estimation of the pipeline memory print will be done, and the
+ * number of divisions will then be computed to fit the available RAM.
+ *
+ * \sa RAMDrivenAdaptativeStreamingManager
+ * \sa ImageRegionAdaptativeSplitter
+ * \sa ImageFileWriter
+ *
+ * \ingroup OTBStreaming
+ */
+template<class TImage>
+class ITK_EXPORT BlockAlignedStreamingManager : public StreamingManager<TImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef BlockAlignedStreamingManager  Self;
+  typedef StreamingManager<TImage>      Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  typedef TImage                          ImageType;
+  typedef typename Superclass::RegionType RegionType;
+  typedef typename Superclass::SizeType   SizeType;
+  typedef typename Superclass::IndexType  IndexType;
+
+  /** Creation through object factory macro */
+  itkNewMacro(Self);
+
+  /** Type macro */
+  itkTypeMacro(BlockAlignedStreamingManager, itk::LightObject);
+
+  /** Dimension of input image. */
+  itkStaticConstMacro(ImageDimension, unsigned int, ImageType::ImageDimension);
+
+  /** Block grid of an input file */
+  struct BlockGrid
+  {
+    /** Index of the first block, the origin of the largest possible
+     *  region of the file */
+    IndexType origin;
+
+    /** Size of the blocks */
+    SizeType blockSize;
+
+    /** Size of a pixel (all bands) in the file */
+    unsigned long long bytesPerPixel;
+  };
+
+  typedef std::vector<BlockGrid>  BlockGridListType;
+  typedef std::vector<RegionType> RegionListType;
+
+  /** The number of Megabytes available (if 0, the configuration option is
+    used)*/
+  itkSetMacro(AvailableRAMInMB, unsigned int);
+
+  /** The number of Megabytes available (if 0, the configuration option is
+    used)*/
+  itkGetConstMacro(AvailableRAMInMB, unsigned int);
+
+  /** The multiplier to apply to the memory print estimation */
+  itkSetMacro(Bias, double);
+
+  /** The multiplier to apply to the memory print estimation */
+  itkGetConstMacro(Bias, double);
+
+  /** Size of the cells the splits are made of, valid after PrepareStreaming */
+  itkGetConstReferenceMacro(Alignment, SizeType);
+
+  /** Estimated number of bytes of input blocks read more than once,
+   *  valid after PrepareStreaming */
+  itkGetConstMacro(BytesReadMoreThanOnce, unsigned long long);
+
+  /** Block grids found upstream, valid after PrepareStreaming */
+  const BlockGridListType & GetBlockGrids() const
+  {
+    return m_BlockGrids;
+  }
+
+  /** Actually computes the stream divisions, according to the specified streaming mode,
+   * eventually using the input parameter to estimate memory consumption */
+  void PrepareStreaming(itk::DataObject * input, const RegionType &region) override;
+
+  /** Find the block grids of the readers upstream of input which
+   *  produce images on the same pixel grid as input */
+  static BlockGridListType CollectBlockGrids(itk::DataObject * input);
+
+  /** Size of the cells of the union of the grids. Grids with the
+   *  smallest blocks are ignored until the region holds at least
+   *  nbDivisions cells. A null size means that no grid is usable. */
+  static SizeType ComputeAlignment(const BlockGridListType & grids,
+                                   const RegionType & region,
+                                   unsigned long nbDivisions);
+
+  /** Number of bytes of blocks decoded more than once when reading
+   *  the splits of region one after the other */
+  static unsigned long long EstimateBytesReadMoreThanOnce(const BlockGridListType & grids,
+                                                          const RegionListType & splits,
+                                                          const RegionType & region);
+
+protected:
+  BlockAlignedStreamingManager();
+  ~BlockAlignedStreamingManager() override;
+
+  /** The number of MegaBytes of RAM available */
+  unsigned int m_AvailableRAMInMB;
+
+  /** The multiplier to apply to the memory print estimation */
+  double m_Bias;
+
+private:
+  BlockAlignedStreamingManager(const Self &) = delete;
+  void operator =(const Self&) = delete;
+
+  /** Number of blocks of grid intersecting region */
+  static unsigned long long CountBlocks(const BlockGrid & grid, const RegionType & region);
+
+  BlockGridListType  m_BlockGrids;
+  SizeType           m_Alignment;
+  unsigned long long m_BytesReadMoreThanOnce;
+};
+
+} // End namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbBlockAlignedStreamingManager.hxx"
+#endif
+
+#endif
@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbBlockAlignedStreamingManager_hxx
+#define otbBlockAlignedStreamingManager_hxx
+
+#include "otbBlockAlignedStreamingManager.h"
+#include "otbMacro.h"
+#include "otbImageRegionAdaptativeSplitter.h"
+#include "otbImageIOBase.h"
+#include "itkMetaDataObject.h"
+#include "itkImageBase.h"
+#include "itkProcessObject.h"
+#include "otbMetaDataKey.h"
+
+#include <algorithm>
+#include <set>
+
+namespace otb
+{
+
+namespace BlockAlignedStreamingManagerHelpers
+{
+
+/** Size of a component of a file, from the DataType key set by the ImageIO */
+inline unsigned long long ComponentSize(const itk::MetaDataDictionary & dict, unsigned long long defaultSize)
+{
+  ImageIOBase::IOComponentType type = ImageIOBase::UNKNOWNCOMPONENTTYPE;
+  if (!itk::ExposeMetaData<ImageIOBase::IOComponentType>(dict, MetaDataKey::DataType, type))
+    {
+    return defaultSize;
+    }
+
+  switch (type)
+    {
+    case ImageIOBase::UCHAR:
+    case ImageIOBase::CHAR:
+      return 1;
+    case ImageIOBase::USHORT:
+    case ImageIOBase::SHORT:
+      return 2;
+    case ImageIOBase::UINT:
+    case ImageIOBase::INT:
+    case ImageIOBase::FLOAT:
+    case ImageIOBase::CSHORT:
+      return 4;
+    case ImageIOBase::ULONG:
+    case ImageIOBase::LONG:
+      return sizeof(long);
+    case ImageIOBase::DOUBLE:
+    case ImageIOBase::CINT:
+    case ImageIOBase::CFLOAT:
+      return 8;
+    case ImageIOBase::CDOUBLE:
+      return 16;
+    default:
+      return defaultSize;
+    }
+}
+
+inline unsigned long GreatestCommonDivisor(unsigned long a, unsigned long b)
+{
+  while (b != 0)
+    {
+    unsigned long r = a % b;
+    a = b;
+    b = r;
+    }
+  return a;
+}
+
+} // End namespace BlockAlignedStreamingManagerHelpers
+
+template <class TImage>
+BlockAlignedStreamingManager<TImage>::BlockAlignedStreamingManager()
+  : m_AvailableRAMInMB(0),
+    m_Bias(1.0),
+    m_BytesReadMoreThanOnce(0)
+{
+  m_Alignment.Fill(0);
+}
+
+template <class TImage>
+BlockAlignedStreamingManager<TImage>::~BlockAlignedStreamingManager()
+{
+}
+
+template <class TImage>
+typename BlockAlignedStreamingManager<TImage>::BlockGridListType
+BlockAlignedStreamingManager<TImage>::CollectBlockGrids(itk::DataObject * input)
+{
+  typedef itk::ImageBase<ImageDimension> ImageBaseType;
+
+  BlockGridListType grids;
+
+  const ImageBaseType * reference = dynamic_cast<const ImageBaseType *>(input);
+  if (reference == nullptr)
+    {
+    return grids;
+    }
+
+  std::set<itk::ProcessObject *> visited;
+  std::vector<itk::DataObject *>  toVisit(1, input);
+
+  while (!toVisit.empty())
+    {
+    itk::DataObject * data = toVisit.back();
+    toVisit.pop_back();
+
+    itk::ProcessObject * source = data->GetSource();
+
+    if (source != nullptr && source->GetNumberOfInputs() > 0)
+      {
+      // Not a reader: walk up to its inputs
+      if (visited.insert(source).second)
+        {
+        itk::ProcessObject::DataObjectPointerArray inputs = source->GetInputs();
+        for (unsigned int i = 0; i < inputs.size(); ++i)
+          {
+          if (inputs[i].IsNotNull())
+            {
+            toVisit.push_back(inputs[i].GetPointer());
+            }
+          }
+        }
+      continue;
+      }
+
+    // A reader output, or an image in memory: only its grid matters
+    const ImageBaseType * image = dynamic_cast<const ImageBaseType *>(data);
+    if (image == nullptr
+        || image->GetLargestPossibleRegion() != reference->GetLargestPossibleRegion()
+        || image->GetSpacing() != reference->GetSpacing()
+        || image->GetOrigin() != reference->GetOrigin())
+      {
+      // Resampled, cropped or shifted inputs do not share the pixel grid
+      continue;
+      }
+
+    unsigned int tileHintX(0), tileHintY(0);
+    const itk::MetaDataDictionary & dict = image->GetMetaDataDictionary();
+    itk::ExposeMetaData<unsigned int>(dict, MetaDataKey::TileHintX, tileHintX);
+    itk::ExposeMetaData<unsigned int>(dict, MetaDataKey::TileHintY, tileHintY);
+
+    if (tileHintX == 0 || tileHintY == 0 || ImageDimension < 2)
+      {
+      continue;
+      }
+
+    BlockGrid grid;
+    grid.origin = image->GetLargestPossibleRegion().GetIndex();
+    grid.blockSize.Fill(1);
+    grid.blockSize[0] = tileHintX;
+    grid.blockSize[1] = tileHintY;
+    grid.bytesPerPixel = image->GetNumberOfComponentsPerPixel()
+      * BlockAlignedStreamingManagerHelpers::ComponentSize(dict, sizeof(typename Superclass::PixelType));
+
+    grids.push_back(grid);
+    }
+
+  return grids;
+}
+
+template <class TImage>
+typename BlockAlignedStreamingManager<TImage>::SizeType
+BlockAlignedStreamingManager<TImage>::ComputeAlignment(const BlockGridListType & grids,
+                                                       const RegionType & region,
+                                                       unsigned long nbDivisions)
+{
+  SizeType alignment;
+  alignment.Fill(0);
+
+  BlockGridListType remaining = grids;
+
+  while (!remaining.empty())
+    {
+    unsigned long long nbCells = 1;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+      // Least common multiple of the block sizes, a cell larger than the
+      // region is as good as the region itself
+      unsigned long lcm = 1;
+      for (typename BlockGridListType::const_iterator it = remaining.begin(); it != remaining.end(); ++it)
+        {
+        const unsigned long size = it->blockSize[dim];
+        lcm = (lcm / BlockAlignedStreamingManagerHelpers::GreatestCommonDivisor(lcm, size)) * size;
+        if (lcm >= region.GetSize()[dim])
+          {
+          lcm = region.GetSize()[dim];
+          break;
+          }
+        }
+      alignment[dim] = std::max(1UL, lcm);
+      nbCells *= (region.GetSize()[dim] + alignment[dim] - 1) / alignment[dim];
+      }
+
+    if (nbCells >= nbDivisions || remaining.size() == 1)
+      {
+      break;
+      }
+
+    // Cells are too large for the available RAM: give up the grid whose
+    // blocks are the cheapest to decode twice
+    typename BlockGridListType::iterator cheapest = remaining.begin();
+    unsigned long long cheapestBytes = 0;
+    for (typename BlockGridListType::iterator it = remaining.begin(); it != remaining.end(); ++it)
+      {
+      unsigned long long bytes = it->bytesPerPixel;
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+        bytes *= it->blockSize[dim];
+        }
+      if (it == remaining.begin() || bytes < cheapestBytes)
+        {
+        cheapest = it;
+        cheapestBytes = bytes;
+        }
+      }
+    remaining.erase(cheapest);
+    }
+
+  return alignment;
+}
+
+template <class TImage>
+unsigned long long
+BlockAlignedStreamingManager<TImage>::CountBlocks(const BlockGrid & grid, const RegionType & region)
+{
+  unsigned long long nbBlocks = 1;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+    if (region.GetSize()[dim] == 0)
+      {
+      return 0;
+      }
+    const long start = region.GetIndex()[dim] - grid.origin[dim];
+    const long end = start + static_cast<long>(region.GetSize()[dim]) - 1;
+    const long blockSize = static_cast<long>(grid.blockSize[dim]);
+    nbBlocks *= end / blockSize - start / blockSize + 1;
+    }
+  return nbBlocks;
+}
+
+template <class TImage>
+unsigned long long
+BlockAlignedStreamingManager<TImage>::EstimateBytesReadMoreThanOnce(const BlockGridListType & grids,
+                                                                    const RegionListType & splits,
+                                                                    const RegionType & region)
+{
+  unsigned long long bytes = 0;
+
+  for (typename BlockGridListType::const_iterator it = grids.begin(); it != grids.end(); ++it)
+    {
+    // The splits cover the region: every block of the region is read at
+    // least once, and once more for each additional split it intersects
+    unsigned long long nbBlocksRead = 0;
+    for (typename RegionListType::const_iterator sit = splits.begin(); sit != splits.end(); ++sit)
+      {
+      nbBlocksRead += CountBlocks(*it, *sit);
+      }
+    const unsigned long long nbBlocks = CountBlocks(*it, region);
+
+    unsigned long long blockBytes = it->bytesPerPixel;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+      blockBytes *= it->blockSize[dim];
+      }
+
+    if (nbBlocksRead > nbBlocks)
+      {
+      bytes += (nbBlocksRead - nbBlocks) * blockBytes;
+      }
+    }
+
+  return bytes;
+}
+
+template <class TImage>
+void
+BlockAlignedStreamingManager<TImage>::PrepareStreaming( itk::DataObject * input, const RegionType &region )
+{
+  unsigned long nbDivisions =
+      this->EstimateOptimalNumberOfDivisions(input, region, m_AvailableRAMInMB, m_Bias);
+
+  m_BlockGrids = CollectBlockGrids(input);
+  m_Alignment = ComputeAlignment(m_BlockGrids, region, nbDivisions);
+
+  typename otb::ImageRegionAdaptativeSplitter<itkGetStaticConstMacro(ImageDimension)>::Pointer splitter =
+      otb::ImageRegionAdaptativeSplitter<itkGetStaticConstMacro(ImageDimension)>::New();
+
+  // Splits are made of whole cells, as long as the RAM allows it
+  splitter->SetTileHint(m_Alignment);
+
+  this->m_Splitter = splitter;
+
+  this->m_ComputedNumberOfSplits = this->m_Splitter->GetNumberOfSplits(region, nbDivisions);
+
+  this->m_Region = region;
+
+  RegionListType splits;
+  for (unsigned int i = 0; i < this->m_ComputedNumberOfSplits; ++i)
+    {
+    splits.push_back(this->GetSplit(i));
+    }
+
+  m_BytesReadMoreThanOnce = EstimateBytesReadMoreThanOnce(m_BlockGrids, splits, region);
+
+  otbLogMacro(Info,<<"Block aligned streaming: " << m_BlockGrids.size() << " input block grid(s), "
+              << this->m_ComputedNumberOfSplits << " splits aligned on " << m_Alignment
+              << ", " << m_BytesReadMoreThanOnce / (1024 * 1024) << " MB of input blocks read more than once");
+}
+
+} // End namespace otb
+
+#endif
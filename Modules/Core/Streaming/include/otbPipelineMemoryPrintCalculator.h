@@ -68,6 +68,15 @@ namespace otb
  *  correction factor parameters allows compensating this bias to the first
  *  order.
  *
+ *  To overcome these limitations, the Measure() method runs the
+ *  pipeline on the requested region of the data to write (a small
+ *  probe region in general) and records the peak increase of the memory
+ *  allocated by the process, which includes the mini-pipelines of
+ *  composite filters. The allocated memory is sampled at the start,
+ *  progress and end events of every filter of the pipeline, so that
+ *  buffers released before the end of the update are counted. This measurement is only available on platforms
+ *  where the allocated memory can be queried (glibc, macOS).
+ *
  * \ingroup OTBStreaming
  */
 class OTBStreaming_EXPORT PipelineMemoryPrintCalculator :
@@ -124,6 +133,19 @@ public:
   /** Evaluate the print (in bytes) of a single data object */
   MemoryPrintType EvaluateDataObjectPrint(DataObjectType * data);
 
+  /** Measure the pipeline memory print: the data of the pipeline is
+   *  released, the data to write is updated, and the peak increase of
+   *  the memory allocated by the process during the update is recorded
+   *  as memory print (bias correction factor applied). The peak is
+   *  sampled at the start, progress and end events of each filter. The data of the pipeline is released
+   *  again afterwards. Returns false if the allocated memory can not be
+   *  measured on this platform. */
+  bool Measure();
+
+  /** Get the memory currently allocated on the heap by the process,
+   *  in bytes. Returns false if it can not be measured on this platform. */
+  static bool GetAllocatedMemory(MemoryPrintType & allocated);
+
 protected:
   /** Constructor */
   PipelineMemoryPrintCalculator();
@@ -137,6 +159,9 @@ protected:
   /** Recursive method to evaluate memory print in bytes */
   MemoryPrintType EvaluateProcessObjectPrintRecursive(ProcessObjectType * process);
 
+  /** Recursive method to release the outputs of the pipeline */
+  void ReleaseDataRecursive(ProcessObjectType * process);
+
 private:
   PipelineMemoryPrintCalculator(const Self &) = delete;
   void operator =(const Self&) = delete;
@@ -32,7 +32,10 @@
 #include "otbTileDimensionTiledStreamingManager.h"
 #include "otbRAMDrivenTiledStreamingManager.h"
 #include "otbRAMDrivenAdaptativeStreamingManager.h"
+#include "otbBlockAlignedStreamingManager.h"
 #include "otbUtils.h"
+#include "otbPipelineTraceObserver.h"
+#include "otbTracer.h"
 
 namespace otb
 {
@@ -149,6 +152,18 @@ StreamingImageVirtualWriter<TInputImage>
   m_StreamingManager = streamingManager;
 }
 
+template <class TInputImage>
+void
+StreamingImageVirtualWriter<TInputImage>
+::SetAutomaticBlockAlignedStreaming(unsigned int availableRAM, double bias)
+{
+  typedef BlockAlignedStreamingManager<TInputImage> BlockAlignedStreamingManagerType;
+  typename BlockAlignedStreamingManagerType::Pointer streamingManager = BlockAlignedStreamingManagerType::New();
+  streamingManager->SetAvailableRAMInMB(availableRAM);
+  streamingManager->SetBias(bias);
+  m_StreamingManager = streamingManager;
+}
+
 template <class TInputImage>
 void
 StreamingImageVirtualWriter<TInputImage>
@@ -240,11 +255,24 @@ StreamingImageVirtualWriter<TInputImage>
    * piece, and copy the results into the output image.
    */
   InputImageRegionType streamRegion;
+
+  // Record the execution of each filter of the pipeline
+  PipelineTraceObserver traceObserver;
+  if (Tracer::GetInstance().IsEnabled())
+    {
+    traceObserver.Attach(inputPtr);
+    }
+
   for (m_CurrentDivision = 0;
        m_CurrentDivision < m_NumberOfDivisions && !this->GetAbortGenerateData();
        m_CurrentDivision++, m_DivisionProgress = 0, this->UpdateFilterProgress())
     {
     streamRegion = m_StreamingManager->GetSplit(m_CurrentDivision);
+
+    TraceScope divisionScope("Division", "streaming");
+    divisionScope.AddArgument("division", m_CurrentDivision);
+    divisionScope.AddArgument("pixels", streamRegion.GetNumberOfPixels());
+    traceObserver.SetDivision(m_CurrentDivision);
     //inputPtr->ReleaseData();
     //inputPtr->SetRequestedRegion(streamRegion);
     //inputPtr->Update();
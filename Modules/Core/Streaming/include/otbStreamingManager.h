@@ -94,6 +94,20 @@ public:
   itkSetMacro(DefaultRAM, MemoryPrintType);
   itkGetMacro(DefaultRAM, MemoryPrintType);
 
+  /** Enable/disable the memory calibration: instead of being estimated
+   *  from the pipeline structure, the memory print is measured by
+   *  running the pipeline on two small probe regions, which accounts for
+   *  the mini-pipelines of composite filters. Only RAM driven modes are
+   *  affected. */
+  itkSetMacro(MemoryCalibration, bool);
+  itkGetConstMacro(MemoryCalibration, bool);
+  itkBooleanMacro(MemoryCalibration);
+
+  /** Set/Get the size (in pixels, in each dimension) of the largest
+   *  calibration probe. The other probe is half this size. */
+  itkSetMacro(CalibrationProbeSize, unsigned int);
+  itkGetConstMacro(CalibrationProbeSize, unsigned int);
+
 protected:
   StreamingManager();
   ~StreamingManager() override;
@@ -102,6 +116,14 @@ protected:
                                                         MemoryPrintType availableRAMInMB,
                                                         double bias = 1.0);
 
+  /** Measure the memory print of the pipeline on two probe regions and
+   *  extrapolate the number of divisions needed for region. Returns false
+   *  if the memory can not be measured. */
+  virtual bool CalibrateNumberOfDivisions(ImageType * input, const RegionType &region,
+                                          MemoryPrintType availableRAMInBytes,
+                                          double bias,
+                                          unsigned int & nbDivisions);
+
   /** The number of splits generated by the splitter */
   unsigned int m_ComputedNumberOfSplits;
 
@@ -123,6 +145,12 @@ private:
 
   /** Default available RAM in MB */
   MemoryPrintType m_DefaultRAM;
+
+  /** Whether the memory print is measured rather than estimated */
+  bool m_MemoryCalibration;
+
+  /** Size of the largest calibration probe */
+  unsigned int m_CalibrationProbeSize;
 };
 
 } // End namespace otb
@@ -25,6 +25,9 @@
 #include "otbConfigurationManager.h"
 #include "itkExtractImageFilter.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace otb
 {
 
@@ -32,6 +35,8 @@ template <class TImage>
 StreamingManager<TImage>::StreamingManager()
   : m_ComputedNumberOfSplits(0)
   , m_DefaultRAM(0)
+  , m_MemoryCalibration(false)
+  , m_CalibrationProbeSize(256)
 {
 }
 
@@ -85,6 +90,16 @@ StreamingManager<TImage>::EstimateOptimalNumberOfDivisions(itk::DataObject * inp
   ImageType* inputImage = dynamic_cast<ImageType*>(input);
 
   MemoryPrintType pipelineMemoryPrint;
+  if (inputImage && m_MemoryCalibration)
+    {
+    unsigned int calibratedNumberOfDivisions = 0;
+    if (this->CalibrateNumberOfDivisions(inputImage, region, availableRAMInBytes, bias, calibratedNumberOfDivisions))
+      {
+      return calibratedNumberOfDivisions;
+      }
+    otbLogMacro(Warning,<<"Memory calibration is not available, the memory print will be estimated");
+    }
+
   if (inputImage)
     {
 
@@ -161,6 +176,90 @@ StreamingManager<TImage>::EstimateOptimalNumberOfDivisions(itk::DataObject * inp
   return optimalNumberOfDivisions;
 }
 
+template <class TImage>
+bool
+StreamingManager<TImage>::CalibrateNumberOfDivisions(ImageType * inputImage, const RegionType &region,
+                                                     MemoryPrintType availableRAMInBytes,
+                                                     double bias,
+                                                     unsigned int & nbDivisions)
+{
+  typedef itk::ExtractImageFilter<ImageType, ImageType> ExtractFilterType;
+
+  // Two probes around the image center: the memory allocated once for
+  // the whole processing (DEM tiles, models, lookup tables...) is
+  // separated from the memory proportional to the size of the region
+  const unsigned int probeSizes[2] = {std::max(1u, m_CalibrationProbeSize / 2), std::max(1u, m_CalibrationProbeSize)};
+  double nbPixels[2];
+  double prints[2];
+
+  for (unsigned int i = 0; i < 2; ++i)
+    {
+    SizeType probeSize;
+    probeSize.Fill(probeSizes[i]);
+    IndexType index;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+      index[dim] = region.GetIndex()[dim] + region.GetSize()[dim] / 2 - probeSizes[i] / 2;
+      }
+
+    RegionType probe(index, probeSize);
+    if (!probe.Crop(region))
+      {
+      return false;
+      }
+
+    typename ExtractFilterType::Pointer extractFilter = ExtractFilterType::New();
+    extractFilter->SetInput(inputImage);
+    extractFilter->SetExtractionRegion(probe);
+
+    otb::PipelineMemoryPrintCalculator::Pointer memoryPrintCalculator = otb::PipelineMemoryPrintCalculator::New();
+    memoryPrintCalculator->SetDataToWrite(extractFilter->GetOutput());
+    memoryPrintCalculator->SetBiasCorrectionFactor(1.0);
+
+    if (!memoryPrintCalculator->Measure())
+      {
+      return false;
+      }
+
+    // remove the contribution of the ExtractImageFilter
+    const MemoryPrintType extractContrib =
+      memoryPrintCalculator->EvaluateDataObjectPrint(extractFilter->GetOutput());
+    const MemoryPrintType print = memoryPrintCalculator->GetMemoryPrint();
+
+    nbPixels[i] = static_cast<double>(probe.GetNumberOfPixels());
+    prints[i] = print > extractContrib ? static_cast<double>(print - extractContrib) : 0.;
+    }
+
+  if (nbPixels[1] <= nbPixels[0] || prints[1] <= prints[0])
+    {
+    // The region is too small, or the measure is not significant
+    return false;
+    }
+
+  const double printPerPixel = bias * (prints[1] - prints[0]) / (nbPixels[1] - nbPixels[0]);
+  const double fixedPrint = std::max(0., prints[0] - (prints[1] - prints[0]) / (nbPixels[1] - nbPixels[0]) * nbPixels[0]);
+
+  double availableForRegion = static_cast<double>(availableRAMInBytes) - fixedPrint;
+  if (availableForRegion <= 0.)
+    {
+    otbLogMacro(Warning,<<"Memory allocated once for the processing ("<<fixedPrint * otb::PipelineMemoryPrintCalculator::ByteToMegabyte
+                <<" MB) exceeds the available memory");
+    availableForRegion = static_cast<double>(availableRAMInBytes);
+    }
+
+  const double pixelsPerDivision = std::max(1., availableForRegion / printPerPixel);
+  nbDivisions = static_cast<unsigned int>(std::ceil(static_cast<double>(region.GetNumberOfPixels()) / pixelsPerDivision));
+  nbDivisions = std::max(1u, nbDivisions);
+
+  otbLogMacro(Info,<<"Measured memory: "<<fixedPrint * otb::PipelineMemoryPrintCalculator::ByteToMegabyte<<" MB allocated once, "
+              <<printPerPixel<<" bytes per pixel, "
+              <<(fixedPrint + printPerPixel * region.GetNumberOfPixels()) * otb::PipelineMemoryPrintCalculator::ByteToMegabyte
+              <<" MB for full processing (avail.: "<<availableRAMInBytes * otb::PipelineMemoryPrintCalculator::ByteToMegabyte
+              <<" MB), optimal image partitioning: "<<nbDivisions<<" blocks");
+
+  return true;
+}
+
 template <class TImage>
 unsigned int
 StreamingManager<TImage>::GetNumberOfSplits()
@@ -19,8 +19,11 @@
  */
 
 
+#include <atomic>
 #include <complex>
 #include <ostream>
+#include <utility>
+#include <vector>
 
 #include "otbPipelineMemoryPrintCalculator.h"
 
@@ -30,9 +33,116 @@
 #include "otbVectorImage.h"
 #include "itkFixedArray.h"
 #include "otbImageList.h"
+#include "itkCommand.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
 
 namespace otb
 {
+namespace
+{
+typedef PipelineMemoryPrintCalculator::MemoryPrintType MemoryPrintType;
+
+/** Increase of the allocated memory since reference */
+MemoryPrintType AllocatedIncrease(MemoryPrintType reference, MemoryPrintType allocated)
+{
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  // mallinfo counters wrap beyond 4GB
+  return static_cast<unsigned int>(allocated - reference);
+#else
+  return allocated > reference ? allocated - reference : 0;
+#endif
+}
+
+/** \class AllocatedMemoryPeakCommand
+ * Records the largest increase of the allocated memory seen at the
+ * events of the observed filters. Progress events are invoked by the
+ * threads of the filters, the peak is updated atomically.
+ */
+class AllocatedMemoryPeakCommand : public itk::Command
+{
+public:
+  typedef AllocatedMemoryPeakCommand Self;
+  typedef itk::Command               Superclass;
+  typedef itk::SmartPointer<Self>    Pointer;
+
+  itkNewMacro(Self);
+
+  void Execute(itk::Object * itkNotUsed(caller), const itk::EventObject & itkNotUsed(event)) override
+  {
+    this->Sample();
+  }
+
+  void Execute(const itk::Object * itkNotUsed(caller), const itk::EventObject & itkNotUsed(event)) override
+  {
+    this->Sample();
+  }
+
+  void Sample()
+  {
+    MemoryPrintType allocated = 0;
+    if (!PipelineMemoryPrintCalculator::GetAllocatedMemory(allocated))
+      {
+      return;
+      }
+    const MemoryPrintType increase = AllocatedIncrease(m_Reference, allocated);
+    MemoryPrintType peak = m_Peak.load();
+    while (increase > peak && !m_Peak.compare_exchange_weak(peak, increase))
+      {
+      }
+  }
+
+  void SetReference(MemoryPrintType reference)
+  {
+    m_Reference = reference;
+    m_Peak = 0;
+  }
+
+  MemoryPrintType GetPeak() const
+  {
+    return m_Peak.load();
+  }
+
+protected:
+  AllocatedMemoryPeakCommand() : m_Reference(0), m_Peak(0) {}
+
+private:
+  MemoryPrintType              m_Reference;
+  std::atomic<MemoryPrintType> m_Peak;
+};
+
+typedef std::vector<std::pair<itk::ProcessObject::Pointer, unsigned long> > ObserverTagsType;
+
+/** Observe the start, progress and end events of the filters upstream of process */
+void AddPeakObserverRecursive(itk::ProcessObject * process, itk::Command * command,
+                              PipelineMemoryPrintCalculator::ProcessObjectPointerSetType & visited,
+                              ObserverTagsType & tags)
+{
+  if (visited.count(process))
+    {
+    return;
+    }
+  visited.insert(process);
+
+  tags.emplace_back(process, process->AddObserver(itk::StartEvent(), command));
+  tags.emplace_back(process, process->AddObserver(itk::ProgressEvent(), command));
+  tags.emplace_back(process, process->AddObserver(itk::EndEvent(), command));
+
+  itk::ProcessObject::DataObjectPointerArray inputs = process->GetInputs();
+  for (unsigned int i = 0; i < inputs.size(); ++i)
+    {
+    if (inputs[i] && inputs[i]->GetSource())
+      {
+      AddPeakObserverRecursive(inputs[i]->GetSource(), command, visited, tags);
+      }
+    }
+}
+}
+
 const double PipelineMemoryPrintCalculator::ByteToMegabyte = 1./std::pow(2.0, 20);
 const double PipelineMemoryPrintCalculator::MegabyteToByte = std::pow(2.0, 20);
 
@@ -107,6 +217,130 @@ PipelineMemoryPrintCalculator
 
 }
 
+// [static]
+bool
+PipelineMemoryPrintCalculator
+::GetAllocatedMemory(MemoryPrintType & allocated)
+{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  struct mallinfo2 info = mallinfo2();
+  allocated = static_cast<MemoryPrintType>(info.uordblks) + static_cast<MemoryPrintType>(info.hblkhd);
+  return true;
+#elif defined(__GLIBC__)
+  // Counters are int: they wrap beyond 2GB, differences remain valid
+  // modulo 4GB
+  struct mallinfo info = mallinfo();
+  allocated = static_cast<unsigned int>(info.uordblks) + static_cast<unsigned int>(info.hblkhd);
+  return true;
+#elif defined(__APPLE__)
+  malloc_statistics_t stats;
+  malloc_zone_statistics(nullptr, &stats);
+  allocated = static_cast<MemoryPrintType>(stats.size_in_use);
+  return true;
+#else
+  allocated = 0;
+  return false;
+#endif
+}
+
+bool
+PipelineMemoryPrintCalculator
+::Measure()
+{
+  MemoryPrintType before = 0;
+  if (!GetAllocatedMemory(before))
+    {
+    return false;
+    }
+
+  // Start from an empty pipeline, so that only the buffers of the
+  // requested region are measured
+  m_VisitedProcessObjects.clear();
+  if (m_DataToWrite->GetSource())
+    {
+    this->ReleaseDataRecursive(m_DataToWrite->GetSource());
+    }
+  GetAllocatedMemory(before);
+
+  // The allocated memory is sampled along the update, so that the
+  // buffers released before its end are counted
+  AllocatedMemoryPeakCommand::Pointer peakCommand = AllocatedMemoryPeakCommand::New();
+  peakCommand->SetReference(before);
+  ObserverTagsType tags;
+  if (m_DataToWrite->GetSource())
+    {
+    ProcessObjectPointerSetType visited;
+    AddPeakObserverRecursive(m_DataToWrite->GetSource(), peakCommand, visited, tags);
+    }
+
+  try
+    {
+    m_DataToWrite->UpdateOutputInformation();
+    m_DataToWrite->PropagateRequestedRegion();
+    m_DataToWrite->UpdateOutputData();
+    }
+  catch (...)
+    {
+    for (const auto & tag : tags)
+      {
+      tag.first->RemoveObserver(tag.second);
+      }
+    throw;
+    }
+  peakCommand->Sample();
+
+  for (const auto & tag : tags)
+    {
+    tag.first->RemoveObserver(tag.second);
+    }
+
+  m_MemoryPrint = peakCommand->GetPeak();
+
+  otbLogMacro(Debug,<<"Measured memory print: "<<m_MemoryPrint * ByteToMegabyte<<" MB");
+
+  // Apply bias correction factor
+  m_MemoryPrint *= m_BiasCorrectionFactor;
+
+  // Give the memory back before the actual processing
+  m_VisitedProcessObjects.clear();
+  if (m_DataToWrite->GetSource())
+    {
+    this->ReleaseDataRecursive(m_DataToWrite->GetSource());
+    }
+
+  return true;
+}
+
+void
+PipelineMemoryPrintCalculator
+::ReleaseDataRecursive(ProcessObjectType * process)
+{
+  if(m_VisitedProcessObjects.count(process))
+    {
+    return;
+    }
+  m_VisitedProcessObjects.insert(process);
+
+  ProcessObjectType::DataObjectPointerArray inputs = process->GetInputs();
+  for(unsigned int i = 0; i < inputs.size(); ++i)
+    {
+    // Data without source (images in memory) is not released
+    if(inputs[i] && inputs[i]->GetSource())
+      {
+      this->ReleaseDataRecursive(inputs[i]->GetSource());
+      }
+    }
+
+  ProcessObjectType::DataObjectPointerArray outputs = process->GetOutputs();
+  for(unsigned int i = 0; i < outputs.size(); ++i)
+    {
+    if(outputs[i])
+      {
+      outputs[i]->ReleaseData();
+      }
+    }
+}
+
 PipelineMemoryPrintCalculator::MemoryPrintType
 PipelineMemoryPrintCalculator
 ::EvaluateProcessObjectPrintRecursive(ProcessObjectType * process)
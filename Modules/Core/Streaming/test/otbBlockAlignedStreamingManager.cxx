@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbVectorImage.h"
+#include "otbBlockAlignedStreamingManager.h"
+#include "otbMetaDataKey.h"
+#include "itkMetaDataObject.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+
+typedef otb::VectorImage<unsigned short, 2>          ImageType;
+typedef otb::BlockAlignedStreamingManager<ImageType> BlockAlignedStreamingManagerType;
+
+ImageType::Pointer makeTiledImage(const ImageType::RegionType & region, unsigned int tileX, unsigned int tileY)
+{
+  ImageType::Pointer image = ImageType::New();
+
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(4);
+
+  itk::MetaDataDictionary& dict = image->GetMetaDataDictionary();
+
+  itk::EncapsulateMetaData<unsigned int>(dict, otb::MetaDataKey::TileHintX, tileX);
+  itk::EncapsulateMetaData<unsigned int>(dict, otb::MetaDataKey::TileHintY, tileY);
+
+  return image;
+}
+
+BlockAlignedStreamingManagerType::RegionListType
+getSplits(BlockAlignedStreamingManagerType * manager)
+{
+  BlockAlignedStreamingManagerType::RegionListType splits;
+  for (unsigned int i = 0; i < manager->GetNumberOfSplits(); ++i)
+    {
+    splits.push_back(manager->GetSplit(i));
+    }
+  return splits;
+}
+
+}
+
+int otbBlockAlignedStreamingManager(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  ImageType::RegionType region;
+  region.SetIndex(0, 0);
+  region.SetIndex(1, 0);
+  region.SetSize(0, 10013);
+  region.SetSize(1, 5727);
+
+  // Single file with 512x512 blocks: splits are made of whole blocks
+  ImageType::Pointer image = makeTiledImage(region, 512, 512);
+
+  BlockAlignedStreamingManagerType::Pointer streamingManager = BlockAlignedStreamingManagerType::New();
+  streamingManager->SetAvailableRAMInMB(10);
+  streamingManager->PrepareStreaming(image, region);
+
+  if (streamingManager->GetBlockGrids().size() != 1)
+    {
+    std::cerr << "Expected 1 block grid, got " << streamingManager->GetBlockGrids().size() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  BlockAlignedStreamingManagerType::RegionListType splits = getSplits(streamingManager);
+
+  for (unsigned int i = 0; i < splits.size(); ++i)
+    {
+    for (unsigned int dim = 0; dim < 2; ++dim)
+      {
+      if (splits[i].GetIndex()[dim] % 512 != 0
+          || (splits[i].GetUpperIndex()[dim] + 1 != region.GetUpperIndex()[dim] + 1
+              && (splits[i].GetUpperIndex()[dim] + 1) % 512 != 0))
+        {
+        std::cerr << "Split " << splits[i] << " is not aligned on the block grid" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  if (streamingManager->GetBytesReadMoreThanOnce() != 0)
+    {
+    std::cerr << "Expected no block read twice, got " << streamingManager->GetBytesReadMoreThanOnce() << " bytes" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Two files with 256x256 blocks and strips of 48 lines: cells of the union
+  BlockAlignedStreamingManagerType::BlockGridListType grids;
+  BlockAlignedStreamingManagerType::BlockGrid tiled;
+  tiled.origin.Fill(0);
+  tiled.blockSize[0] = 256;
+  tiled.blockSize[1] = 256;
+  tiled.bytesPerPixel = 8;
+  grids.push_back(tiled);
+
+  BlockAlignedStreamingManagerType::BlockGrid stripped;
+  stripped.origin.Fill(0);
+  stripped.blockSize[0] = 10013;
+  stripped.blockSize[1] = 48;
+  stripped.bytesPerPixel = 1;
+  grids.push_back(stripped);
+
+  BlockAlignedStreamingManagerType::SizeType alignment =
+    BlockAlignedStreamingManagerType::ComputeAlignment(grids, region, 8);
+  if (alignment[0] != 10013 || alignment[1] != 768)
+    {
+    std::cerr << "Expected an alignment of [10013, 768], got " << alignment << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Too many divisions for the 8 cells of the union: the strips are
+  // the cheapest blocks to read twice
+  alignment = BlockAlignedStreamingManagerType::ComputeAlignment(grids, region, 100);
+  if (alignment[0] != 256 || alignment[1] != 256)
+    {
+    std::cerr << "Expected an alignment of [256, 256], got " << alignment << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Stripped splits of 100 lines on 256x256 blocks
+  BlockAlignedStreamingManagerType::RegionListType strips;
+  for (unsigned int y = 0; y < region.GetSize()[1]; y += 100)
+    {
+    ImageType::RegionType strip = region;
+    strip.SetIndex(1, y);
+    strip.SetSize(1, std::min<unsigned int>(100, region.GetSize()[1] - y));
+    strips.push_back(strip);
+    }
+
+  BlockAlignedStreamingManagerType::BlockGridListType tiledOnly(1, tiled);
+  const unsigned long long bytes =
+    BlockAlignedStreamingManagerType::EstimateBytesReadMoreThanOnce(tiledOnly, strips, region);
+
+  // The 58 strips touch 80 rows of blocks, 57 more than the 23 rows of
+  // the image, each row being made of 40 blocks
+  const unsigned long long expected = 57ULL * 40 * 256 * 256 * 8;
+  if (bytes != expected)
+    {
+    std::cerr << "Expected " << expected << " bytes read more than once, got " << bytes << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
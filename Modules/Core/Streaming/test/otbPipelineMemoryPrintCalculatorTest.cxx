@@ -24,6 +24,7 @@
 #include "otbImage.h"
 #include "otbImageFileReader.h"
 #include "otbVectorImageToIntensityImageFilter.h"
+#include "itkShiftScaleImageFilter.h"
 
 
 
@@ -61,3 +62,71 @@ int otbPipelineMemoryPrintCalculatorTest(int itkNotUsed(argc), char * argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbPipelineMemoryPrintCalculatorMeasure(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  typedef otb::Image<float, 2>                   FloatImageType;
+  typedef otb::Image<double, 2>                  DoubleImageType;
+  typedef itk::ShiftScaleImageFilter
+    <FloatImageType, DoubleImageType>            ToDoubleFilterType;
+  typedef itk::ShiftScaleImageFilter
+    <DoubleImageType, FloatImageType>            ToFloatFilterType;
+
+  otb::PipelineMemoryPrintCalculator::MemoryPrintType allocated = 0;
+  if (!otb::PipelineMemoryPrintCalculator::GetAllocatedMemory(allocated))
+    {
+    std::cout << "Allocated memory can not be measured on this platform, skipping." << std::endl;
+    return EXIT_SUCCESS;
+    }
+
+  // Image in memory, which is allocated before the measure
+  const unsigned int size = 1024;
+  FloatImageType::RegionType region;
+  region.SetSize(0, size);
+  region.SetSize(1, size);
+  FloatImageType::Pointer image = FloatImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(1.);
+
+  // The double buffer is released as soon as the second filter is
+  // done: the net allocation is only the float output, the peak holds
+  // both buffers
+  ToDoubleFilterType::Pointer toDouble = ToDoubleFilterType::New();
+  toDouble->SetInput(image);
+  toDouble->GetOutput()->ReleaseDataFlagOn();
+
+  ToFloatFilterType::Pointer toFloat = ToFloatFilterType::New();
+  toFloat->SetInput(toDouble->GetOutput());
+  toFloat->UpdateLargestPossibleRegion();
+
+  otb::PipelineMemoryPrintCalculator::Pointer calculator = otb::PipelineMemoryPrintCalculator::New();
+  calculator->SetDataToWrite(toFloat->GetOutput());
+
+  if (!calculator->Measure())
+    {
+    std::cerr << "Measure() failed although the allocated memory is available" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const double expectedPrint = static_cast<double>(region.GetNumberOfPixels())
+    * (sizeof(double) + sizeof(float));
+  const double measuredPrint = static_cast<double>(calculator->GetMemoryPrint());
+  std::cout << "Measured memory print: " << measuredPrint << " bytes, expected: "
+            << expectedPrint << " bytes" << std::endl;
+
+  if (measuredPrint < 0.9 * expectedPrint || measuredPrint > 1.3 * expectedPrint)
+    {
+    std::cerr << "Measured memory print does not match the peak footprint of the pipeline" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The data is released after the measure
+  if (toFloat->GetOutput()->GetBufferedRegion().GetNumberOfPixels() != 0)
+    {
+    std::cerr << "Pipeline data has not been released after the measure" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
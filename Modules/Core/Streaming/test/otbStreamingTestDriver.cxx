@@ -28,4 +28,6 @@ void RegisterTests()
   REGISTER_TEST(otbRAMDrivenTiledStreamingManager);
   REGISTER_TEST(otbRAMDrivenAdaptativeStreamingManager);
   REGISTER_TEST(otbPipelineMemoryPrintCalculatorTest);
+  REGISTER_TEST(otbPipelineMemoryPrintCalculatorMeasure);
+  REGISTER_TEST(otbBlockAlignedStreamingManager);
 }
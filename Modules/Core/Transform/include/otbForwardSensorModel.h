@@ -76,6 +76,11 @@ public:
   /** Compute the world coordinates. */
   OutputPointType TransformPoint(const InputPointType& point) const override;
 
+  /** Transform count points at once, with a clone of the sensor model */
+  void TransformPoints(const InputPointType * inputPoints,
+                       OutputPointType * outputPoints,
+                       size_t count) const override;
+
 protected:
   ForwardSensorModel();
   ~ForwardSensorModel() override;
@@ -24,6 +24,8 @@
 #include "otbForwardSensorModel.h"
 #include "otbMacro.h"
 
+#include <vector>
+
 namespace otb
 {
 
@@ -69,6 +71,46 @@ ForwardSensorModel<TScalarType, NInputDimensions, NOutputDimensions>
   return outputPoint;
 }
 
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+ForwardSensorModel<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformPoints(const InputPointType * inputPoints, OutputPointType * outputPoints, size_t count) const
+{
+  std::vector<double> x(count), y(count), z;
+  std::vector<double> lon(count), lat(count), h(count);
+
+  for (size_t k = 0; k < count; ++k)
+    {
+    x[k] = inputPoints[k][0];
+    y[k] = inputPoints[k][1];
+    }
+
+  if (InputPointType::PointDimension == 3)
+    {
+    z.resize(count);
+    for (size_t k = 0; k < count; ++k)
+      {
+      z[k] = inputPoints[k][InputPointType::PointDimension - 1];
+      }
+    this->m_Model->ForwardTransformPoints(x.data(), y.data(), z.data(), lon.data(), lat.data(), h.data(), count);
+    }
+  else
+    {
+    this->m_Model->ForwardTransformPoints(x.data(), y.data(), lon.data(), lat.data(), h.data(), count);
+    }
+
+  for (size_t k = 0; k < count; ++k)
+    {
+    outputPoints[k][0] = lon[k];
+    outputPoints[k][1] = lat[k];
+
+    if (OutputPointType::PointDimension == 3)
+      {
+      outputPoints[k][OutputPointType::PointDimension - 1] = h[k];
+      }
+    }
+}
+
 template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
 void
 ForwardSensorModel<TScalarType, NInputDimensions, NOutputDimensions>
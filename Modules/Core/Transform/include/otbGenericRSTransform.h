@@ -171,6 +171,14 @@ public:
 
   OutputPointType TransformPoint(const InputPointType& point) const override;
 
+  /** Transform count points at once. The input and the output
+   *  transforms each process the whole array, so that sensor models
+   *  work on a clone of their own, and evaluate RPC models on all the
+   *  points in a row. This method is thread-safe. */
+  void TransformPoints(const InputPointType * inputPoints,
+                       OutputPointType * outputPoints,
+                       size_t count) const override;
+
   virtual void  InstantiateTransform();
   
   // Get inverse methods
@@ -199,6 +207,13 @@ private:
   GenericRSTransform(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  /** Transform count points with transform, all at once if it is an
+   *  otb::Transform */
+  static void TransformPointsWith(const GenericTransformType * transform,
+                                  const typename GenericTransformType::InputPointType * inputPoints,
+                                  typename GenericTransformType::OutputPointType * outputPoints,
+                                  size_t count);
+
   ImageKeywordlist m_InputKeywordList;
   ImageKeywordlist m_OutputKeywordList;
 
@@ -30,6 +30,8 @@
 
 #include "ogr_spatialref.h"
 
+#include <vector>
+
 namespace otb
 {
 
@@ -280,6 +282,72 @@ GenericRSTransform<TScalarType, NInputDimensions, NOutputDimensions>
   return outputPoint;
 }
 
+template<class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+GenericRSTransform<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformPoints(const InputPointType * inputPoints, OutputPointType * outputPoints, size_t count) const
+{
+  // Check that the transform is instantiated
+  this->GetTransform();
+
+  typedef typename GenericTransformType::InputPointType  GenericInputPointType;
+  typedef typename GenericTransformType::OutputPointType GenericOutputPointType;
+
+  std::vector<GenericInputPointType> points(count);
+  for (size_t k = 0; k < count; ++k)
+    {
+    for (unsigned int dim = 0; dim < NInputDimensions; ++dim)
+      {
+      points[k][dim] = inputPoints[k][dim];
+      }
+
+    // Apply input origin/spacing
+    points[k][0] = points[k][0] * m_InputSpacing[0] + m_InputOrigin[0];
+    points[k][1] = points[k][1] * m_InputSpacing[1] + m_InputOrigin[1];
+    }
+
+  std::vector<GenericOutputPointType> geoPoints(count);
+  TransformPointsWith(m_InputTransform, points.data(), geoPoints.data(), count);
+
+  std::vector<GenericOutputPointType> transformedPoints(count);
+  TransformPointsWith(m_OutputTransform, geoPoints.data(), transformedPoints.data(), count);
+
+  for (size_t k = 0; k < count; ++k)
+    {
+    for (unsigned int dim = 0; dim < NOutputDimensions; ++dim)
+      {
+      outputPoints[k][dim] = transformedPoints[k][dim];
+      }
+
+    // Apply output origin/spacing
+    outputPoints[k][0] = (outputPoints[k][0] - m_OutputOrigin[0]) / m_OutputSpacing[0];
+    outputPoints[k][1] = (outputPoints[k][1] - m_OutputOrigin[1]) / m_OutputSpacing[1];
+    }
+}
+
+template<class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+GenericRSTransform<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformPointsWith(const GenericTransformType * transform,
+                      const typename GenericTransformType::InputPointType * inputPoints,
+                      typename GenericTransformType::OutputPointType * outputPoints,
+                      size_t count)
+{
+  typedef otb::Transform<double, NInputDimensions, NOutputDimensions> BatchTransformType;
+
+  const BatchTransformType * batchTransform = dynamic_cast<const BatchTransformType *>(transform);
+  if (batchTransform != nullptr)
+    {
+    batchTransform->TransformPoints(inputPoints, outputPoints, count);
+    return;
+    }
+
+  for (size_t k = 0; k < count; ++k)
+    {
+    outputPoints[k] = transform->TransformPoint(inputPoints[k]);
+    }
+}
+
 template<class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
 bool
 GenericRSTransform<TScalarType, NInputDimensions, NOutputDimensions>
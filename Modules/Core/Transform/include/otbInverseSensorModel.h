@@ -75,6 +75,11 @@ public:
 
   // Transform of geographic point in image sensor index
   OutputPointType TransformPoint(const InputPointType& point) const override;
+
+  /** Transform count points at once, with a clone of the sensor model */
+  void TransformPoints(const InputPointType * inputPoints,
+                       OutputPointType * outputPoints,
+                       size_t count) const override;
   // Transform of geographic point in image sensor index -- Backward Compatibility
   //  OutputPointType TransformPoint(const InputPointType &point, double height) const;
 
@@ -24,6 +24,8 @@
 #include "otbInverseSensorModel.h"
 #include "otbMacro.h"
 
+#include <vector>
+
 namespace otb
 {
 
@@ -72,6 +74,46 @@ InverseSensorModel<TScalarType, NInputDimensions, NOutputDimensions>
   return outputPoint;
 }
 
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+InverseSensorModel<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformPoints(const InputPointType * inputPoints, OutputPointType * outputPoints, size_t count) const
+{
+  std::vector<double> lon(count), lat(count), h;
+  std::vector<double> x(count), y(count), z(count);
+
+  for (size_t k = 0; k < count; ++k)
+    {
+    lon[k] = inputPoints[k][0];
+    lat[k] = inputPoints[k][1];
+    }
+
+  if (InputPointType::PointDimension == 3)
+    {
+    h.resize(count);
+    for (size_t k = 0; k < count; ++k)
+      {
+      h[k] = inputPoints[k][InputPointType::PointDimension - 1];
+      }
+    this->m_Model->InverseTransformPoints(lon.data(), lat.data(), h.data(), x.data(), y.data(), z.data(), count);
+    }
+  else
+    {
+    this->m_Model->InverseTransformPoints(lon.data(), lat.data(), x.data(), y.data(), z.data(), count);
+    }
+
+  for (size_t k = 0; k < count; ++k)
+    {
+    outputPoints[k][0] = x[k];
+    outputPoints[k][1] = y[k];
+
+    if (OutputPointType::PointDimension == 3)
+      {
+      outputPoints[k][OutputPointType::PointDimension - 1] = z[k];
+      }
+    }
+}
+
 
 template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
 void
@@ -23,6 +23,7 @@
 
 #include "itkWarpImageFilter.h"
 #include "otbStreamingTraits.h"
+#include "otbSeparableInterpolationKernel.h"
 
 namespace otb
 {
@@ -40,6 +41,10 @@ namespace otb
  * If the maximum displacement is wrong, this filter is likely to request data outside of the input image buffered region. In this case, pixels
  * outside the region will be set to Zero according to itk::NumericTraits.
  *
+ * When the interpolator has a separable kernel (see
+ * SeparableInterpolationKernel), its weights are computed once per
+ * output pixel and applied to all the bands of the input at once.
+ *
  * \sa itk::WarpImageFilter
  *
  * \ingroup Streamed
@@ -80,6 +85,10 @@ public:
   typedef typename DisplacementFieldType::Pointer    DisplacementFieldPointerType;
   typedef typename DisplacementFieldType::RegionType DisplacementFieldRegionType;
 
+  /** Evaluation of the separable interpolators */
+  typedef SeparableKernelEvaluator<InputImageType>   KernelEvaluatorType;
+  typedef typename KernelEvaluatorType::Taps         KernelTapsType;
+
   /** Accessors */
   itkSetMacro(MaximumDisplacement, DisplacementValueType);
   itkGetConstReferenceMacro(MaximumDisplacement, DisplacementValueType);
@@ -107,6 +116,9 @@ protected:
 
   void GenerateOutputInformation() override;
 
+  /** Set up the evaluation of the separable interpolators */
+  void BeforeThreadedGenerateData() override;
+
   /**
    * Re-implement the method ThreadedGenerateData to mask area outside the deformation grid
    */
@@ -117,12 +129,22 @@ private:
   StreamingWarpImageFilter(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  /** Warp a region with the separable kernel of the interpolator, as
+   *  itk::WarpImageFilter::ThreadedGenerateData() does with the
+   *  interpolator itself */
+  void WarpWithKernel(const OutputImageRegionType& outputRegionForThread,
+                      itk::ThreadIdType threadId);
+
   //Because of itk positive spacing we need this member to be compliant with otb
   //signed spacing
   SpacingType m_OutputSignedSpacing;
 
   // Assessment of the maximum displacement for streaming
   DisplacementValueType m_MaximumDisplacement;
+
+  // Set up in BeforeThreadedGenerateData if the interpolator kernel is
+  // separable
+  KernelEvaluatorType m_KernelEvaluator;
 };
 
 } // end namespace otb
@@ -24,10 +24,13 @@
 
 #include "otbStreamingWarpImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkProgressReporter.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkMetaDataObject.h"
 #include "otbMetaDataKey.h"
 
+#include <vector>
+
 namespace otb
 {
 
@@ -290,6 +293,104 @@ StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
   itk::EncapsulateMetaData<std::vector<double> >(dict,MetaDataKey::NoDataValue,noDataValue);
 }
 
+template<class TInputImage, class TOutputImage, class TDisplacementField>
+void
+StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
+::BeforeThreadedGenerateData()
+{
+  // Connects the interpolator to the input and sets the edge padding
+  // value up
+  Superclass::BeforeThreadedGenerateData();
+
+  m_KernelEvaluator = KernelEvaluatorType();
+  m_KernelEvaluator.Initialize(this->GetInterpolator(), this->GetInput());
+}
+
+template<class TInputImage, class TOutputImage, class TDisplacementField>
+void
+StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
+::WarpWithKernel(
+  const OutputImageRegionType& outputRegionForThread,
+  itk::ThreadIdType threadId )
+{
+  typedef typename Superclass::InterpolatorType             InterpolatorType;
+  typedef typename InterpolatorType::ContinuousIndexType    ContinuousIndexType;
+  typedef itk::DefaultConvertPixelTraits<PixelType>         OutputConvertType;
+  typedef typename OutputConvertType::ComponentType         OutputComponentType;
+
+  const InputImageType * inputPtr = this->GetInput();
+  OutputImagePointerType outputPtr = this->GetOutput();
+  const DisplacementFieldType * fieldPtr = this->GetDisplacementField();
+  const InterpolatorType * interpolator = this->GetInterpolator();
+  const PixelType paddingValue = this->GetEdgePaddingValue();
+
+  // Same test as itk::WarpImageFilter: the displacement is then read
+  // instead of interpolated
+  const bool sameInformation =
+    outputPtr->GetOrigin() == fieldPtr->GetOrigin()
+    && outputPtr->GetSpacing() == fieldPtr->GetSpacing()
+    && outputPtr->GetDirection() == fieldPtr->GetDirection()
+    && outputPtr->GetLargestPossibleRegion() == fieldPtr->GetLargestPossibleRegion();
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  // Each thread needs its own buffers
+  KernelEvaluatorType evaluator(m_KernelEvaluator);
+  const unsigned int nComponents = evaluator.GetNumberOfComponents();
+  KernelTapsType xTaps, yTaps;
+  std::vector<double> values(nComponents);
+
+  PixelType outputValue;
+  itk::NumericTraits<PixelType>::SetLength(outputValue, nComponents);
+
+  DisplacementValueType displacement;
+  itk::NumericTraits<DisplacementValueType>::SetLength(displacement, InputImageType::ImageDimension);
+
+  PointType point;
+  ContinuousIndexType index;
+
+  itk::ImageRegionIteratorWithIndex<OutputImageType> outputIt(outputPtr, outputRegionForThread);
+
+  for (outputIt.GoToBegin(); !outputIt.IsAtEnd(); ++outputIt)
+    {
+    // compute the required input image point
+    outputPtr->TransformIndexToPhysicalPoint(outputIt.GetIndex(), point);
+    if (sameInformation)
+      {
+      displacement = fieldPtr->GetPixel(outputIt.GetIndex());
+      }
+    else
+      {
+      this->EvaluateDisplacementAtPhysicalPoint(point, displacement);
+      }
+    for (unsigned int j = 0; j < InputImageType::ImageDimension; ++j)
+      {
+      point[j] += displacement[j];
+      }
+    inputPtr->TransformPhysicalPointToContinuousIndex(point, index);
+
+    if (interpolator->IsInsideBuffer(index))
+      {
+      // The weights are shared by all the bands
+      evaluator.ComputeTaps(index[0], 0, xTaps);
+      evaluator.ComputeTaps(index[1], 1, yTaps);
+      evaluator.Evaluate(xTaps, yTaps, values.data());
+
+      for (unsigned int k = 0; k < nComponents; ++k)
+        {
+        OutputConvertType::SetNthComponent(k, outputValue, static_cast<OutputComponentType>(values[k]));
+        }
+      outputIt.Set(outputValue);
+      }
+    else
+      {
+      outputIt.Set(paddingValue);
+      }
+
+    progress.CompletedPixel();
+    }
+}
+
 template<class TInputImage, class TOutputImage, class TDisplacementField>
 void
 StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
@@ -297,8 +398,16 @@ StreamingWarpImageFilter<TInputImage, TOutputImage, TDisplacementField>
   const OutputImageRegionType& outputRegionForThread,
   itk::ThreadIdType threadId )
   {
-  // the superclass itk::WarpImageFilter is doing the actual warping
-  Superclass::ThreadedGenerateData(outputRegionForThread,threadId);
+  // the superclass itk::WarpImageFilter is doing the actual warping,
+  // unless the interpolator kernel is separable
+  if (m_KernelEvaluator.IsValid())
+    {
+    this->WarpWithKernel(outputRegionForThread,threadId);
+    }
+  else
+    {
+    Superclass::ThreadedGenerateData(outputRegionForThread,threadId);
+    }
 
   // second pass on the thread region to mask pixels outside the displacement grid
   const PixelType paddingValue = this->GetEdgePaddingValue();
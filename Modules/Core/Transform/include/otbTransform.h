@@ -100,6 +100,19 @@ public:
 
   OutputPointType TransformPoint(const InputPointType  & ) const override
     { return OutputPointType(); }
+
+  /** Method to transform count points at once. Subclasses whose model
+   *  is expensive to call point by point override it; the default
+   *  implementation calls TransformPoint() on each point. */
+  virtual void TransformPoints(const InputPointType * inputPoints,
+                               OutputPointType * outputPoints,
+                               size_t count) const
+  {
+    for (size_t k = 0; k < count; ++k)
+      {
+      outputPoints[k] = this->TransformPoint(inputPoints[k]);
+      }
+  }
   
   using Superclass::TransformVector;
   /**  Method to transform a vector. */
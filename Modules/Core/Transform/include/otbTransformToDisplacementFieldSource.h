@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbTransformToDisplacementFieldSource_h
+#define otbTransformToDisplacementFieldSource_h
+
+#include "itkTransformToDisplacementFieldSource.h"
+#include "otbTransform.h"
+#include "itkProgressReporter.h"
+
+#include <vector>
+
+namespace otb
+{
+
+/** \class TransformToDisplacementFieldSource
+ * \brief Generate a displacement field from a coordinate transform,
+ * transforming whole lines of points at once.
+ *
+ * itk::TransformToDisplacementFieldSource calls TransformPoint() for
+ * every pixel of the field. When the transform is an otb::Transform,
+ * this source calls TransformPoints() on each line of the field
+ * instead, which lets sensor models and GenericRSTransform process
+ * the points in bulk. Other transforms are handled by the ITK
+ * implementation.
+ *
+ * When MaximumError is set, the field of a 2D non-linear transform is
+ * estimated on an adaptive grid instead of being computed at every
+ * pixel. The output is split in square cells of InitialCellSize pixels,
+ * with the exact displacement computed at their corners. The
+ * displacement is then computed at the middle of the edges and at the
+ * centre of each cell: if the bilinear interpolation of the corners
+ * differs from it by less than MaximumError, the pixels of the cell are
+ * interpolated, otherwise the cell is split in four and checked again.
+ * Errors are measured in pixels of ErrorSpacing, typically the spacing
+ * of the image the field points to. Smooth transforms thus need few
+ * evaluations, while rough areas (mountains with a sensor model for
+ * instance) are refined down to the pixel.
+ *
+ * The number of transform evaluations and the largest error estimated
+ * on the interpolated cells are accumulated over the successive
+ * updates, until ResetStatistics() is called.
+ *
+ * \sa otb::Transform::TransformPoints()
+ * \sa StreamingResampleImageFilter
+ *
+ * \ingroup OTBTransform
+ */
+template <class TOutputImage, class TTransformPrecisionType = double>
+class ITK_EXPORT TransformToDisplacementFieldSource
+  : public itk::TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+{
+public:
+  /** Standard class typedefs. */
+  typedef TransformToDisplacementFieldSource                                            Self;
+  typedef itk::TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType> Superclass;
+  typedef itk::SmartPointer<Self>                                                       Pointer;
+  typedef itk::SmartPointer<const Self>                                                 ConstPointer;
+
+  typedef typename Superclass::OutputImageType       OutputImageType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename Superclass::TransformType         TransformType;
+  typedef typename Superclass::PixelType             PixelType;
+  typedef typename Superclass::PixelValueType        PixelValueType;
+  typedef typename Superclass::IndexType             IndexType;
+  typedef typename Superclass::PointType             PointType;
+  typedef typename Superclass::SizeType              SizeType;
+  typedef typename Superclass::SpacingType           SpacingType;
+  typedef typename PointType::VectorType             VectorType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(TransformToDisplacementFieldSource, itk::TransformToDisplacementFieldSource);
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+  typedef otb::Transform<TTransformPrecisionType,
+                         itkGetStaticConstMacro(ImageDimension),
+                         itkGetStaticConstMacro(ImageDimension)> BatchTransformType;
+
+  /** Maximum interpolation error of the adaptive grid, in pixels of
+   *  ErrorSpacing. 0 (the default) computes the displacement at every
+   *  pixel. */
+  itkSetMacro(MaximumError, double);
+  itkGetConstMacro(MaximumError, double);
+
+  /** Pixel size used to express the interpolation errors (1 by
+   *  default) */
+  itkSetMacro(ErrorSpacing, SpacingType);
+  itkGetConstReferenceMacro(ErrorSpacing, SpacingType);
+
+  /** Size in pixels of the coarsest cells of the adaptive grid, rounded
+   *  down to a power of two (32 by default) */
+  itkSetMacro(InitialCellSize, unsigned int);
+  itkGetConstMacro(InitialCellSize, unsigned int);
+
+  /** Number of points transformed since the last reset */
+  itkGetConstMacro(NumberOfTransformEvaluations, unsigned long long);
+
+  /** Largest interpolation error estimated on the cells of the adaptive
+   *  grid since the last reset, in pixels of ErrorSpacing */
+  itkGetConstMacro(AchievedError, double);
+
+  /** Reset the number of evaluations and the achieved error */
+  void ResetStatistics();
+
+protected:
+  TransformToDisplacementFieldSource();
+  ~TransformToDisplacementFieldSource() override {}
+
+  void BeforeThreadedGenerateData() override;
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            itk::ThreadIdType threadId) override;
+
+  void AfterThreadedGenerateData() override;
+
+  /** Fill the region from the adaptive grid */
+  void AdaptiveThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                    itk::ThreadIdType threadId);
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  TransformToDisplacementFieldSource(const Self &) = delete;
+  void operator =(const Self&) = delete;
+
+  /** Square cell of the adaptive grid, with the exact displacements at
+   *  its corners */
+  struct Cell
+  {
+    IndexType    index;
+    long         size;
+    VectorType   corners[4];
+  };
+
+  /** Exact displacements at a set of pixels */
+  void ComputeDisplacements(const std::vector<IndexType> & indices,
+                            std::vector<VectorType> & displacements,
+                            itk::ThreadIdType threadId);
+
+  /** Interpolation error in pixels of ErrorSpacing */
+  double ComputeError(const VectorType & exact, const VectorType & interpolated) const;
+
+  /** Write the bilinear interpolation of the corners of a cell on its
+   *  pixels within the region */
+  void FillCell(const Cell & cell, const OutputImageRegionType & region,
+                itk::ProgressReporter & progress);
+
+  double       m_MaximumError;
+  SpacingType  m_ErrorSpacing;
+  unsigned int m_InitialCellSize;
+
+  unsigned long long m_NumberOfTransformEvaluations;
+  double             m_AchievedError;
+
+  /** Per thread statistics of the current update */
+  std::vector<unsigned long long> m_ThreadNumberOfTransformEvaluations;
+  std::vector<double>             m_ThreadAchievedError;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbTransformToDisplacementFieldSource.hxx"
+#endif
+
+#endif
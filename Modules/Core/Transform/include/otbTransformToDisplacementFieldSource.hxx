@@ -0,0 +1,426 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbTransformToDisplacementFieldSource_hxx
+#define otbTransformToDisplacementFieldSource_hxx
+
+#include "otbTransformToDisplacementFieldSource.h"
+#include "itkImageScanlineIterator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace otb
+{
+
+template <class TOutputImage, class TTransformPrecisionType>
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::TransformToDisplacementFieldSource()
+  : m_MaximumError(0.),
+    m_InitialCellSize(32),
+    m_NumberOfTransformEvaluations(0),
+    m_AchievedError(0.)
+{
+  m_ErrorSpacing.Fill(1.);
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::ResetStatistics()
+{
+  m_NumberOfTransformEvaluations = 0;
+  m_AchievedError = 0.;
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::BeforeThreadedGenerateData()
+{
+  Superclass::BeforeThreadedGenerateData();
+
+  m_ThreadNumberOfTransformEvaluations.assign(this->GetNumberOfThreads(), 0);
+  m_ThreadAchievedError.assign(this->GetNumberOfThreads(), 0.);
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::AfterThreadedGenerateData()
+{
+  for (unsigned int i = 0; i < m_ThreadNumberOfTransformEvaluations.size(); ++i)
+    {
+    m_NumberOfTransformEvaluations += m_ThreadNumberOfTransformEvaluations[i];
+    m_AchievedError = std::max(m_AchievedError, m_ThreadAchievedError[i]);
+    }
+
+  Superclass::AfterThreadedGenerateData();
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+  const TransformType * transform = this->GetTransform();
+
+  if (transform->IsLinear())
+    {
+    Superclass::ThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
+  if (m_MaximumError > 0. && ImageDimension == 2)
+    {
+    this->AdaptiveThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
+  m_ThreadNumberOfTransformEvaluations[threadId] += outputRegionForThread.GetNumberOfPixels();
+
+  const BatchTransformType * batchTransform = dynamic_cast<const BatchTransformType *>(transform);
+
+  if (batchTransform == nullptr)
+    {
+    Superclass::ThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
+  OutputImageType * outputPtr = this->GetOutput();
+
+  itk::ImageScanlineIterator<OutputImageType> outIt(outputPtr, outputRegionForThread);
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  const size_t lineLength = outputRegionForThread.GetSize()[0];
+  std::vector<PointType> outputPoints(lineLength);
+  std::vector<PointType> transformedPoints(lineLength);
+
+  PixelType deformation;
+
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); outIt.NextLine())
+    {
+    IndexType index = outIt.GetIndex();
+    for (size_t k = 0; k < lineLength; ++k, ++index[0])
+      {
+      outputPtr->TransformIndexToPhysicalPoint(index, outputPoints[k]);
+      }
+
+    // Compute the corresponding input positions of the whole line
+    batchTransform->TransformPoints(outputPoints.data(), transformedPoints.data(), lineLength);
+
+    for (size_t k = 0; k < lineLength; ++k, ++outIt)
+      {
+      for (unsigned int i = 0; i < ImageDimension; ++i)
+        {
+        deformation[i] = static_cast<PixelValueType>(transformedPoints[k][i] - outputPoints[k][i]);
+        }
+      outIt.Set(deformation);
+      progress.CompletedPixel();
+      }
+    }
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::AdaptiveThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                               itk::ThreadIdType threadId)
+{
+  const IndexType start = outputRegionForThread.GetIndex();
+  const SizeType  size = outputRegionForThread.GetSize();
+  const IndexType origin = this->GetOutput()->GetLargestPossibleRegion().GetIndex();
+
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  long cellSize = 2;
+  while (static_cast<unsigned long>(2 * cellSize) <= m_InitialCellSize)
+    {
+    cellSize *= 2;
+    }
+
+  // The cells lie on a lattice anchored on the largest possible region,
+  // so that the field does not depend on the split between threads
+  IndexType first = start;
+  long      nbCells[2];
+  for (unsigned int dim = 0; dim < 2; ++dim)
+    {
+    const long offset = start[dim] - origin[dim];
+    first[dim] = origin[dim] + (offset >= 0 ? offset / cellSize : -((-offset - 1) / cellSize) - 1) * cellSize;
+    nbCells[dim] = (start[dim] + static_cast<long>(size[dim]) - first[dim] + cellSize - 1) / cellSize;
+    }
+
+  // Exact displacements at the corners of the coarsest cells
+  std::vector<IndexType> indices;
+  for (long j = 0; j <= nbCells[1]; ++j)
+    {
+    for (long i = 0; i <= nbCells[0]; ++i)
+      {
+      IndexType index = first;
+      index[0] += i * cellSize;
+      index[1] += j * cellSize;
+      indices.push_back(index);
+      }
+    }
+
+  std::vector<VectorType> displacements;
+  this->ComputeDisplacements(indices, displacements, threadId);
+
+  std::vector<Cell> cells;
+  for (long j = 0; j < nbCells[1]; ++j)
+    {
+    for (long i = 0; i < nbCells[0]; ++i)
+      {
+      const long k = j * (nbCells[0] + 1) + i;
+      Cell cell;
+      cell.index = indices[k];
+      cell.size = cellSize;
+      cell.corners[0] = displacements[k];
+      cell.corners[1] = displacements[k + 1];
+      cell.corners[2] = displacements[k + nbCells[0] + 1];
+      cell.corners[3] = displacements[k + nbCells[0] + 2];
+      cells.push_back(cell);
+      }
+    }
+
+  // Offsets of the middle of the bottom, left, right and top edges and
+  // of the centre of a cell, in half cells
+  static const long checkOffsets[5][2] = {{1, 0}, {0, 1}, {2, 1}, {1, 2}, {1, 1}};
+
+  std::vector<Cell> refinedCells;
+
+  while (!cells.empty())
+    {
+    // Exact displacements at the check points of all the cells of this
+    // level, computed at once
+    indices.resize(5 * cells.size());
+    for (size_t c = 0; c < cells.size(); ++c)
+      {
+      const long half = cells[c].size / 2;
+      for (unsigned int p = 0; p < 5; ++p)
+        {
+        IndexType index = cells[c].index;
+        index[0] += checkOffsets[p][0] * half;
+        index[1] += checkOffsets[p][1] * half;
+        indices[5 * c + p] = index;
+        }
+      }
+
+    this->ComputeDisplacements(indices, displacements, threadId);
+
+    refinedCells.clear();
+
+    for (size_t c = 0; c < cells.size(); ++c)
+      {
+      const Cell &       cell = cells[c];
+      const VectorType * exact = &displacements[5 * c];
+      const long         half = cell.size / 2;
+
+      if (cell.size == 2)
+        {
+        // Every pixel of the cell is a corner or a check point
+        Cell pixels[4];
+        pixels[0].corners[0] = cell.corners[0];
+        pixels[1].corners[0] = exact[0];
+        pixels[2].corners[0] = exact[1];
+        pixels[3].corners[0] = exact[4];
+        for (unsigned int p = 0; p < 4; ++p)
+          {
+          pixels[p].index = cell.index;
+          pixels[p].index[0] += p % 2;
+          pixels[p].index[1] += p / 2;
+          pixels[p].size = 1;
+          this->FillCell(pixels[p], outputRegionForThread, progress);
+          }
+        continue;
+        }
+
+      const VectorType interpolated[5] =
+        {(cell.corners[0] + cell.corners[1]) * 0.5,
+         (cell.corners[0] + cell.corners[2]) * 0.5,
+         (cell.corners[1] + cell.corners[3]) * 0.5,
+         (cell.corners[2] + cell.corners[3]) * 0.5,
+         (cell.corners[0] + cell.corners[1] + cell.corners[2] + cell.corners[3]) * 0.25};
+
+      double error = 0.;
+      for (unsigned int p = 0; p < 5; ++p)
+        {
+        // NaN errors (invalid displacements) refine the cell as well
+        const double pointError = this->ComputeError(exact[p], interpolated[p]);
+        error = (pointError <= error) ? error : pointError;
+        }
+
+      if (error <= m_MaximumError)
+        {
+        m_ThreadAchievedError[threadId] = std::max(m_ThreadAchievedError[threadId], error);
+        this->FillCell(cell, outputRegionForThread, progress);
+        continue;
+        }
+
+      // Split in four cells, whose corners are the corners and the check
+      // points of this one
+      const VectorType * children[4][4] =
+        {{&cell.corners[0], &exact[0], &exact[1], &exact[4]},
+         {&exact[0], &cell.corners[1], &exact[4], &exact[2]},
+         {&exact[1], &exact[4], &cell.corners[2], &exact[3]},
+         {&exact[4], &exact[2], &exact[3], &cell.corners[3]}};
+
+      for (unsigned int q = 0; q < 4; ++q)
+        {
+        Cell child;
+        child.index = cell.index;
+        child.index[0] += (q % 2) * half;
+        child.index[1] += (q / 2) * half;
+        child.size = half;
+
+        // Skip the cells outside the region
+        bool inside = true;
+        for (unsigned int dim = 0; dim < 2; ++dim)
+          {
+          inside = inside && child.index[dim] < start[dim] + static_cast<long>(size[dim])
+                   && child.index[dim] + half > start[dim];
+          }
+        if (!inside)
+          {
+          continue;
+          }
+
+        for (unsigned int p = 0; p < 4; ++p)
+          {
+          child.corners[p] = *children[q][p];
+          }
+        refinedCells.push_back(child);
+        }
+      }
+
+    cells.swap(refinedCells);
+    }
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::ComputeDisplacements(const std::vector<IndexType> & indices,
+                       std::vector<VectorType> & displacements,
+                       itk::ThreadIdType threadId)
+{
+  const OutputImageType * outputPtr = this->GetOutput();
+  const size_t            count = indices.size();
+
+  std::vector<PointType> points(count);
+  std::vector<PointType> transformedPoints(count);
+  for (size_t k = 0; k < count; ++k)
+    {
+    outputPtr->TransformIndexToPhysicalPoint(indices[k], points[k]);
+    }
+
+  const TransformType *      transform = this->GetTransform();
+  const BatchTransformType * batchTransform = dynamic_cast<const BatchTransformType *>(transform);
+  if (batchTransform != nullptr)
+    {
+    batchTransform->TransformPoints(points.data(), transformedPoints.data(), count);
+    }
+  else
+    {
+    for (size_t k = 0; k < count; ++k)
+      {
+      transformedPoints[k] = transform->TransformPoint(points[k]);
+      }
+    }
+
+  displacements.resize(count);
+  for (size_t k = 0; k < count; ++k)
+    {
+    displacements[k] = transformedPoints[k] - points[k];
+    }
+
+  m_ThreadNumberOfTransformEvaluations[threadId] += count;
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+double
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::ComputeError(const VectorType & exact, const VectorType & interpolated) const
+{
+  double error = 0.;
+  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+    const double e = (exact[dim] - interpolated[dim]) / m_ErrorSpacing[dim];
+    error += e * e;
+    }
+  return std::sqrt(error);
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::FillCell(const Cell & cell, const OutputImageRegionType & region, itk::ProgressReporter & progress)
+{
+  OutputImageType * outputPtr = this->GetOutput();
+
+  const IndexType start = region.GetIndex();
+  const SizeType  size = region.GetSize();
+
+  const long beginX = std::max<long>(cell.index[0], start[0]);
+  const long endX = std::min<long>(cell.index[0] + cell.size, start[0] + static_cast<long>(size[0]));
+  const long beginY = std::max<long>(cell.index[1], start[1]);
+  const long endY = std::min<long>(cell.index[1] + cell.size, start[1] + static_cast<long>(size[1]));
+
+  IndexType index = start;
+  PixelType deformation;
+
+  for (long y = beginY; y < endY; ++y)
+    {
+    const double v = static_cast<double>(y - cell.index[1]) / cell.size;
+    for (long x = beginX; x < endX; ++x)
+      {
+      const double u = static_cast<double>(x - cell.index[0]) / cell.size;
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+        deformation[dim] = static_cast<PixelValueType>(
+          (1. - v) * ((1. - u) * cell.corners[0][dim] + u * cell.corners[1][dim])
+          + v * ((1. - u) * cell.corners[2][dim] + u * cell.corners[3][dim]));
+        }
+      index[0] = x;
+      index[1] = y;
+      outputPtr->SetPixel(index, deformation);
+      progress.CompletedPixel();
+      }
+    }
+}
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumError: " << m_MaximumError << std::endl;
+  os << indent << "ErrorSpacing: " << m_ErrorSpacing << std::endl;
+  os << indent << "InitialCellSize: " << m_InitialCellSize << std::endl;
+  os << indent << "NumberOfTransformEvaluations: " << m_NumberOfTransformEvaluations << std::endl;
+  os << indent << "AchievedError: " << m_AchievedError << std::endl;
+}
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "otbImage.h"
+#include "otbImageFileReader.h"
+#include "otbGenericRSTransform.h"
+
+namespace
+{
+typedef otb::GenericRSTransform<> TransformType;
+typedef TransformType::InputPointType  InputPointType;
+typedef TransformType::OutputPointType OutputPointType;
+
+// Maximum distance between the points transformed one at a time and
+// all at once
+double CompareTransformPoints(const TransformType * transform, const std::vector<InputPointType> & points)
+{
+  std::vector<OutputPointType> transformed(points.size());
+  transform->TransformPoints(points.data(), transformed.data(), points.size());
+
+  double maxError = 0.;
+  for (size_t k = 0; k < points.size(); ++k)
+    {
+    const OutputPointType expected = transform->TransformPoint(points[k]);
+    for (unsigned int dim = 0; dim < 2; ++dim)
+      {
+      const double error = std::abs(expected[dim] - transformed[k][dim]);
+      // NaN errors are reported as well
+      if (!(error <= maxError))
+        {
+        maxError = error;
+        }
+      }
+    }
+  return maxError;
+}
+}
+
+int otbGenericRSTransformTransformPoints(int argc, char* argv[])
+{
+  if (argc != 3)
+    {
+    std::cerr << "Usage: " << argv[0] << " infname tolerance" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef otb::Image<unsigned short, 2>   ImageType;
+  typedef otb::ImageFileReader<ImageType> ReaderType;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(argv[1]);
+  reader->UpdateOutputInformation();
+  ImageType::Pointer image = reader->GetOutput();
+
+  const double tolerance = atof(argv[2]);
+
+  // Image to WGS84 and back
+  TransformType::Pointer forward = TransformType::New();
+  forward->SetInputKeywordList(image->GetImageKeywordlist());
+  forward->SetInputProjectionRef(image->GetProjectionRef());
+  forward->InstantiateTransform();
+
+  TransformType::Pointer inverse = TransformType::New();
+  forward->GetInverse(inverse);
+
+  // Lines of points over the image extent
+  const ImageType::SizeType size = image->GetLargestPossibleRegion().GetSize();
+  std::vector<InputPointType> imagePoints;
+  for (unsigned int j = 0; j <= 20; ++j)
+    {
+    for (unsigned int i = 0; i <= 30; ++i)
+      {
+      ImageType::IndexType index = image->GetLargestPossibleRegion().GetIndex();
+      index[0] += i * (size[0] - 1) / 30;
+      index[1] += j * (size[1] - 1) / 20;
+      InputPointType point;
+      image->TransformIndexToPhysicalPoint(index, point);
+      imagePoints.push_back(point);
+      }
+    }
+
+  std::vector<InputPointType> geoPoints(imagePoints.size());
+  forward->TransformPoints(imagePoints.data(), geoPoints.data(), imagePoints.size());
+
+  const double forwardError = CompareTransformPoints(forward, imagePoints);
+  const double inverseError = CompareTransformPoints(inverse, geoPoints);
+
+  std::cout << imagePoints.size() << " points, forward error " << forwardError
+            << ", inverse error " << inverseError << std::endl;
+
+  if (!(forwardError <= tolerance) || !(inverseError <= tolerance))
+    {
+    std::cerr << "TransformPoints() and TransformPoint() differ by more than " << tolerance << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@ void RegisterTests()
   REGISTER_TEST(otbGenericRSTransformWithSRID);
   REGISTER_TEST(otbCreateInverseForwardSensorModel);
   REGISTER_TEST(otbGenericRSTransform);
+  REGISTER_TEST(otbGenericRSTransformTransformPoints);
   REGISTER_TEST(otbCreateProjectionWithOSSIM);
   REGISTER_TEST(otbLogPolarTransformResample);
   REGISTER_TEST(otbLogPolarTransform);
@@ -35,4 +36,5 @@ void RegisterTests()
   REGISTER_TEST(otbInverseLogPolarTransform);
   REGISTER_TEST(otbInverseLogPolarTransformResample);
   REGISTER_TEST(otbStreamingResampleImageFilterWithAffineTransform);
+  REGISTER_TEST(otbTransformToDisplacementFieldSourceAdaptive);
 }
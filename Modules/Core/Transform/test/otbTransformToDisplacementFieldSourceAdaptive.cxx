@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "otbImage.h"
+#include "otbImageFileReader.h"
+#include "otbGenericRSTransform.h"
+#include "otbTransformToDisplacementFieldSource.h"
+#include "itkImageRegionConstIterator.h"
+
+int otbTransformToDisplacementFieldSourceAdaptive(int argc, char* argv[])
+{
+  if (argc != 4)
+    {
+    std::cerr << "Usage: " << argv[0] << " infname maximumError tolerance" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  typedef otb::Image<unsigned short, 2>                                    ImageType;
+  typedef otb::ImageFileReader<ImageType>                                  ReaderType;
+  typedef otb::GenericRSTransform<>                                        TransformType;
+  typedef itk::Vector<double, 2>                                           DisplacementType;
+  typedef otb::Image<DisplacementType, 2>                                  DisplacementFieldType;
+  typedef otb::TransformToDisplacementFieldSource<DisplacementFieldType>   SourceType;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(argv[1]);
+  reader->UpdateOutputInformation();
+  ImageType::Pointer image = reader->GetOutput();
+
+  const double maximumError = atof(argv[2]);
+  const double tolerance = atof(argv[3]);
+
+  // Footprint of the image in WGS84
+  TransformType::Pointer imageToGround = TransformType::New();
+  imageToGround->SetInputKeywordList(image->GetImageKeywordlist());
+  imageToGround->SetInputProjectionRef(image->GetProjectionRef());
+  imageToGround->InstantiateTransform();
+
+  TransformType::Pointer groundToImage = TransformType::New();
+  imageToGround->GetInverse(groundToImage);
+
+  const ImageType::RegionType region = image->GetLargestPossibleRegion();
+  double minLon = 180., maxLon = -180., minLat = 90., maxLat = -90.;
+  for (unsigned int c = 0; c < 4; ++c)
+    {
+    ImageType::IndexType index = region.GetIndex();
+    index[0] += (c % 2) * (region.GetSize()[0] - 1);
+    index[1] += (c / 2) * (region.GetSize()[1] - 1);
+    TransformType::InputPointType point;
+    image->TransformIndexToPhysicalPoint(index, point);
+    const TransformType::OutputPointType geoPoint = imageToGround->TransformPoint(point);
+    minLon = std::min(minLon, geoPoint[0]);
+    maxLon = std::max(maxLon, geoPoint[0]);
+    minLat = std::min(minLat, geoPoint[1]);
+    maxLat = std::max(maxLat, geoPoint[1]);
+    }
+
+  // Displacement field on a geographic grid covering the footprint
+  SourceType::SizeType size;
+  size[0] = 300;
+  size[1] = 250;
+  SourceType::SpacingType spacing;
+  spacing[0] = (maxLon - minLon) / size[0];
+  spacing[1] = (maxLat - minLat) / size[1];
+  SourceType::OriginType origin;
+  origin[0] = minLon;
+  origin[1] = minLat;
+
+  SourceType::Pointer exactSource = SourceType::New();
+  exactSource->SetTransform(groundToImage);
+  exactSource->SetOutputSize(size);
+  exactSource->SetOutputSpacing(spacing);
+  exactSource->SetOutputOrigin(origin);
+  exactSource->Update();
+
+  SourceType::Pointer adaptiveSource = SourceType::New();
+  adaptiveSource->SetTransform(groundToImage);
+  adaptiveSource->SetOutputSize(size);
+  adaptiveSource->SetOutputSpacing(spacing);
+  adaptiveSource->SetOutputOrigin(origin);
+  adaptiveSource->SetMaximumError(maximumError);
+  adaptiveSource->SetErrorSpacing(image->GetSpacing());
+  adaptiveSource->Update();
+
+  itk::ImageRegionConstIterator<DisplacementFieldType> exactIt(exactSource->GetOutput(),
+                                                               exactSource->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<DisplacementFieldType> adaptiveIt(adaptiveSource->GetOutput(),
+                                                                  adaptiveSource->GetOutput()->GetLargestPossibleRegion());
+
+  double error = 0.;
+  for (exactIt.GoToBegin(), adaptiveIt.GoToBegin(); !exactIt.IsAtEnd(); ++exactIt, ++adaptiveIt)
+    {
+    double pixelError = 0.;
+    for (unsigned int dim = 0; dim < 2; ++dim)
+      {
+      const double e = (exactIt.Get()[dim] - adaptiveIt.Get()[dim]) / image->GetSpacing()[dim];
+      pixelError += e * e;
+      }
+    pixelError = std::sqrt(pixelError);
+    if (!(pixelError <= error))
+      {
+      error = pixelError;
+      }
+    }
+
+  std::cout << "Adaptive grid: " << adaptiveSource->GetNumberOfTransformEvaluations() << " evaluations instead of "
+            << exactSource->GetNumberOfTransformEvaluations() << ", estimated error "
+            << adaptiveSource->GetAchievedError() << " pixels, actual error " << error << " pixels" << std::endl;
+
+  if (!(error <= tolerance))
+    {
+    std::cerr << "Error of the adaptive grid (" << error << " pixels) > tolerance (" << tolerance << " pixels)" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (adaptiveSource->GetNumberOfTransformEvaluations() >= exactSource->GetNumberOfTransformEvaluations())
+    {
+    std::cerr << "The adaptive grid should need fewer evaluations" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
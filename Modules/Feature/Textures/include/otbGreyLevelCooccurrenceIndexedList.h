@@ -129,6 +129,36 @@ public:
   //m_InputImageMaximum. If so add to m_Vector via AddPairToVector method */
   void AddPixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2);
 
+  /** Remove a pixel pair previously added with AddPixelPair(). Pairs whose
+    * frequency drops to zero are removed from m_Vector. */
+  void RemovePixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2);
+
+  /** Add the pairs made of each pixel of region and of its neighbour at
+    * offset, when this neighbour lies in the buffered region of image.
+    * The pairs are added line after line. */
+  template <class TImage>
+  void AddPixelPairs(const TImage * image, const typename TImage::RegionType & region,
+                     const typename TImage::OffsetType & offset);
+
+  /** Remove the pairs added by AddPixelPairs() with the same region. This
+    * allows one to update the list when a window slides over an image. */
+  template <class TImage>
+  void RemovePixelPairs(const TImage * image, const typename TImage::RegionType & region,
+                        const typename TImage::OffsetType & offset);
+
+  /** Replace the pairs of previousRegion, added by AddPixelPairs(), by
+    * the pairs of region. When region spans the same lines as
+    * previousRegion, further right (a window sliding along a line), only
+    * the columns leaving and entering the window are updated. Otherwise
+    * the list is rebuilt. */
+  template <class TImage>
+  void MoveWindow(const TImage * image, const typename TImage::RegionType & previousRegion,
+                  const typename TImage::RegionType & region,
+                  const typename TImage::OffsetType & offset);
+
+  /** Remove all the pairs, keeping the bins set by Initialize() */
+  void Clear();
+
   /* Get the frequency value from Vector with index =[j,i] */
   RelativeFrequencyType GetFrequency(IndexValueType i, IndexValueType j);
 
@@ -146,6 +176,16 @@ protected:
     * co-occurrence pair is added again with index values swapped */
   void AddPairToVector(IndexType index);
 
+  /** Decrement the frequency of the pair with given index, and remove it
+    * from m_Vector (moving the last pair in its place) when it drops to
+    * zero. */
+  void RemovePairFromVector(IndexType index);
+
+  /** Add or remove the pairs of a region */
+  template <class TImage>
+  void UpdatePixelPairs(const TImage * image, const typename TImage::RegionType & region,
+                        const typename TImage::OffsetType & offset, bool add);
+
   void SetBinMin(const unsigned int dimension, const InstanceIdentifier nbin,
                  PixelValueType min);
 
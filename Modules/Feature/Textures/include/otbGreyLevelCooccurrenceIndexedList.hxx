@@ -23,6 +23,7 @@
 #define otbGreyLevelCooccurrenceIndexedList_hxx
 
 #include "otbGreyLevelCooccurrenceIndexedList.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 
 namespace otb
 {
@@ -246,6 +247,142 @@ AddPixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue
     }
 }
 
+template <class TPixel >
+void
+GreyLevelCooccurrenceIndexedList<TPixel>::
+RemovePixelPair(const PixelValueType& pixelvalue1, const PixelValueType& pixelvalue2)
+{
+  // Pairs out of bounds were not added
+  if ( pixelvalue1 < m_InputImageMinimum
+       || pixelvalue1 > m_InputImageMaximum
+       || pixelvalue2 < m_InputImageMinimum
+       || pixelvalue2 > m_InputImageMaximum )
+    {
+    return;
+    }
+
+  IndexType index;
+  PixelPairType ppair( PixelPairSize);
+  ppair[0] = pixelvalue1;
+  ppair[1] = pixelvalue2;
+
+  this->GetIndex(ppair, index);
+  this->RemovePairFromVector(index);
+  if(m_Symmetry)
+    {
+    IndexValueType temp;
+    temp = index[0];
+    index[0] = index[1];
+    index[1] = temp;
+    this->RemovePairFromVector(index);
+    }
+}
+
+template <class TPixel>
+template <class TImage>
+void
+GreyLevelCooccurrenceIndexedList<TPixel>::
+AddPixelPairs(const TImage * image, const typename TImage::RegionType & region,
+              const typename TImage::OffsetType & offset)
+{
+  this->UpdatePixelPairs(image, region, offset, true);
+}
+
+template <class TPixel>
+template <class TImage>
+void
+GreyLevelCooccurrenceIndexedList<TPixel>::
+RemovePixelPairs(const TImage * image, const typename TImage::RegionType & region,
+                 const typename TImage::OffsetType & offset)
+{
+  this->UpdatePixelPairs(image, region, offset, false);
+}
+
+template <class TPixel>
+template <class TImage>
+void
+GreyLevelCooccurrenceIndexedList<TPixel>::
+UpdatePixelPairs(const TImage * image, const typename TImage::RegionType & region,
+                 const typename TImage::OffsetType & offset, bool add)
+{
+  const typename TImage::RegionType & bufferedRegion = image->GetBufferedRegion();
+
+  itk::ImageRegionConstIteratorWithIndex<TImage> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    const typename TImage::IndexType neighbour = it.GetIndex() + offset;
+    if ( !bufferedRegion.IsInside(neighbour) )
+      {
+      continue; // don't put a pixel in the co-occurrence list if the value is
+                // out of bounds
+      }
+    if (add)
+      {
+      this->AddPixelPair(it.Get(), image->GetPixel(neighbour));
+      }
+    else
+      {
+      this->RemovePixelPair(it.Get(), image->GetPixel(neighbour));
+      }
+    }
+}
+
+template <class TPixel>
+template <class TImage>
+void
+GreyLevelCooccurrenceIndexedList<TPixel>::
+MoveWindow(const TImage * image, const typename TImage::RegionType & previousRegion,
+           const typename TImage::RegionType & region,
+           const typename TImage::OffsetType & offset)
+{
+  const IndexValueType previousBegin = previousRegion.GetIndex(0);
+  const IndexValueType previousEnd = previousBegin + static_cast<IndexValueType>(previousRegion.GetSize(0));
+  const IndexValueType begin = region.GetIndex(0);
+  const IndexValueType end = begin + static_cast<IndexValueType>(region.GetSize(0));
+
+  bool sameLines = true;
+  for (unsigned int dim = 1; dim < TImage::ImageDimension; ++dim)
+    {
+    sameLines = sameLines && previousRegion.GetIndex(dim) == region.GetIndex(dim)
+                && previousRegion.GetSize(dim) == region.GetSize(dim);
+    }
+
+  if (!sameLines || begin < previousBegin || end < previousEnd || begin >= previousEnd)
+    {
+    this->Clear();
+    this->AddPixelPairs(image, region, offset);
+    return;
+    }
+
+  typename TImage::RegionType columns = region;
+  if (begin > previousBegin)
+    {
+    columns.SetIndex(0, previousBegin);
+    columns.SetSize(0, begin - previousBegin);
+    this->RemovePixelPairs(image, columns, offset);
+    }
+  if (end > previousEnd)
+    {
+    columns.SetIndex(0, previousEnd);
+    columns.SetSize(0, end - previousEnd);
+    this->AddPixelPairs(image, columns, offset);
+    }
+}
+
+template <class TPixel>
+void
+GreyLevelCooccurrenceIndexedList<TPixel>::
+Clear()
+{
+  typename VectorType::const_iterator it;
+  for (it = m_Vector.begin(); it != m_Vector.end(); ++it)
+    {
+    m_LookupArray[(*it).first[1] * m_Size[0] + (*it).first[0]] = -1;
+    }
+  m_Vector.clear();
+  m_TotalFrequency = 0;
+}
+
 template <class TPixel>
 typename GreyLevelCooccurrenceIndexedList<TPixel>::RelativeFrequencyType
 GreyLevelCooccurrenceIndexedList<TPixel>::
@@ -309,6 +446,33 @@ GreyLevelCooccurrenceIndexedList<TPixel>
   m_TotalFrequency = m_TotalFrequency + 1;
 }
 
+template <class TPixel>
+void
+GreyLevelCooccurrenceIndexedList<TPixel>
+::RemovePairFromVector(IndexType index)
+{
+  InstanceIdentifier instanceId = 0;
+  instanceId = index[1] * m_Size[0] + index[0];
+  int vindex = m_LookupArray[instanceId];
+  if( vindex < 0)
+    {
+    return;
+    }
+  if( --m_Vector[vindex].second == 0)
+    {
+    int last = m_Vector.size() - 1;
+    if( vindex != last )
+      {
+      m_Vector[vindex] = m_Vector[last];
+      IndexType moved = m_Vector[vindex].first;
+      m_LookupArray[moved[1] * m_Size[0] + moved[0]] = vindex;
+      }
+    m_Vector.pop_back();
+    m_LookupArray[instanceId] = -1;
+    }
+  m_TotalFrequency = m_TotalFrequency - 1;
+}
+
 template <class TPixel>
 void
 GreyLevelCooccurrenceIndexedList<TPixel>
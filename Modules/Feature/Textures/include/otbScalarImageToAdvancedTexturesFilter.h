@@ -179,6 +179,17 @@ public:
   /** Get the sub-sampling offset */
   itkGetMacro(SubsampleOffset, OffsetType);
 
+  /** Set the incremental mode: along each line, the co-occurrence list is
+   * updated with the columns leaving and entering the window, instead of
+   * being rebuilt for every pixel. This reduces the cost per pixel from
+   * the area of the window to its height. The textures are the same, up
+   * to the order of floating point summations. Off by default. */
+  itkSetMacro(Incremental, bool);
+
+  /** Get the incremental mode */
+  itkGetMacro(Incremental, bool);
+  itkBooleanMacro(Incremental);
+
   /** Get the mean output image */
   OutputImageType * GetMeanOutput();
 
@@ -253,6 +264,9 @@ private:
 
   /** Sub-sampling offset */
   OffsetType m_SubsampleOffset;
+
+  /** Update the co-occurrence list as the window slides along the lines */
+  bool m_Incremental;
 };
 } // End namespace otb
 
@@ -42,6 +42,7 @@ ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>
 , m_InputImageMaximum(255)
 , m_SubsampleFactor()
 , m_SubsampleOffset()
+, m_Incremental(false)
 {
   // There are 10 outputs corresponding to the 9 textures indices
   this->SetNumberOfRequiredOutputs(10);
@@ -363,6 +364,13 @@ ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>
   // Set-up progress reporting
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
+  // Co-occurrence list of the thread, cleared or updated from one window
+  // to the next
+  CooccurrenceIndexedListPointerType GLCIList = CooccurrenceIndexedListType::New();
+  GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
+  InputRegionType previousRegion;
+  bool hasPreviousRegion = false;
+
   // Iterate on outputs to compute textures
   while (!varianceIt.IsAtEnd()
          && !meanIt.IsAtEnd()
@@ -398,24 +406,18 @@ ScalarImageToAdvancedTexturesFilter<TInputImage, TOutputImage>
     inputRegion.SetSize(inputSize);
     inputRegion.Crop(inputPtr->GetRequestedRegion());
 
-    CooccurrenceIndexedListPointerType GLCIList = CooccurrenceIndexedListType::New();
-    GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
-
-    typedef itk::ConstNeighborhoodIterator< InputImageType > NeighborhoodIteratorType;
-    NeighborhoodIteratorType neighborIt;
-    neighborIt = NeighborhoodIteratorType(m_NeighborhoodRadius, inputPtr, inputRegion);
-    for ( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
-    {
-    const InputPixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-    bool pixelInBounds;
-    const InputPixelType pixelIntensity =  neighborIt.GetPixel(m_Offset, pixelInBounds);
-    if ( !pixelInBounds )
+    if (m_Incremental && hasPreviousRegion)
       {
-      continue; // don't put a pixel in the co-occurrence list if the value is
-               // out of bounds
+      // Only update the columns leaving and entering the window
+      GLCIList->MoveWindow(inputPtr.GetPointer(), previousRegion, inputRegion, m_Offset);
       }
-    GLCIList->AddPixelPair(centerPixelIntensity, pixelIntensity);
-    }
+    else
+      {
+      GLCIList->Clear();
+      GLCIList->AddPixelPairs(inputPtr.GetPointer(), inputRegion, m_Offset);
+      }
+    previousRegion = inputRegion;
+    hasPreviousRegion = true;
 
     PixelValueType m_Mean                    = itk::NumericTraits< PixelValueType >::Zero;
     PixelValueType m_Variance                = itk::NumericTraits< PixelValueType >::Zero;
@@ -44,6 +44,7 @@ ScalarImageToTexturesFilter<TInputImage, TOutputImage>
 , m_InputImageMaximum(255)
 , m_SubsampleFactor()
 , m_SubsampleOffset()
+, m_Incremental(false)
 {
   // There are 8 outputs corresponding to the 8 textures indices
   this->SetNumberOfRequiredOutputs(8);
@@ -330,6 +331,13 @@ ScalarImageToTexturesFilter<TInputImage, TOutputImage>
   // Set-up progress reporting
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
+  // Co-occurrence list of the thread, cleared or updated from one window
+  // to the next
+  CooccurrenceIndexedListPointerType GLCIList = CooccurrenceIndexedListType::New();
+  GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
+  InputRegionType previousRegion;
+  bool hasPreviousRegion = false;
+
   // Iterate on outputs to compute textures
   while (!energyIt.IsAtEnd()
          && !entropyIt.IsAtEnd()
@@ -362,24 +370,18 @@ ScalarImageToTexturesFilter<TInputImage, TOutputImage>
     inputRegion.SetSize(inputSize);
     inputRegion.Crop(inputPtr->GetRequestedRegion());
 
-    CooccurrenceIndexedListPointerType GLCIList = CooccurrenceIndexedListType::New();
-    GLCIList->Initialize(m_NumberOfBinsPerAxis, m_InputImageMinimum, m_InputImageMaximum);
-
-    typedef itk::ConstNeighborhoodIterator< InputImageType > NeighborhoodIteratorType;
-    NeighborhoodIteratorType neighborIt;
-    neighborIt = NeighborhoodIteratorType(m_NeighborhoodRadius, inputPtr, inputRegion);
-    for ( neighborIt.GoToBegin(); !neighborIt.IsAtEnd(); ++neighborIt )
+    if (m_Incremental && hasPreviousRegion)
+      {
+      // Only update the columns leaving and entering the window
+      GLCIList->MoveWindow(inputPtr.GetPointer(), previousRegion, inputRegion, m_Offset);
+      }
+    else
       {
-      const InputPixelType centerPixelIntensity = neighborIt.GetCenterPixel();
-      bool pixelInBounds;
-      const InputPixelType pixelIntensity =  neighborIt.GetPixel(m_Offset, pixelInBounds);
-      if ( !pixelInBounds )
-        {
-        continue; // don't put a pixel in the co-occurrence list if the value is
-                  // out of bounds
-        }
-      GLCIList->AddPixelPair(centerPixelIntensity, pixelIntensity);
+      GLCIList->Clear();
+      GLCIList->AddPixelPairs(inputPtr.GetPointer(), inputRegion, m_Offset);
       }
+    previousRegion = inputRegion;
+    hasPreviousRegion = true;
 
     double pixelMean = 0.;
     double marginalMean;
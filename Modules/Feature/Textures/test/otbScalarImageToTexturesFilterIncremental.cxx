@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "itkMacro.h"
+
+#include "otbScalarImageToTexturesFilter.h"
+#include "otbScalarImageToAdvancedTexturesFilter.h"
+#include "otbImage.h"
+#include "otbImageFileReader.h"
+#include "itkImageRegionConstIterator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Largest difference between the outputs of the incremental and the
+// non-incremental filters
+template <class TFilter>
+double CompareIncremental(typename TFilter::InputImageType * input,
+                          unsigned int radius, int offsetx, int offsety,
+                          unsigned int subsample)
+{
+  typename TFilter::SizeType sradius;
+  sradius.Fill(radius);
+  typename TFilter::OffsetType offset;
+  offset[0] = offsetx;
+  offset[1] = offsety;
+  typename TFilter::SizeType factor;
+  factor.Fill(subsample);
+
+  typename TFilter::Pointer filters[2];
+  for (unsigned int i = 0; i < 2; ++i)
+    {
+    filters[i] = TFilter::New();
+    filters[i]->SetInput(input);
+    filters[i]->SetRadius(sradius);
+    filters[i]->SetOffset(offset);
+    filters[i]->SetSubsampleFactor(factor);
+    filters[i]->SetNumberOfBinsPerAxis(8);
+    filters[i]->SetInputImageMinimum(0);
+    filters[i]->SetInputImageMaximum(255);
+    filters[i]->SetIncremental(i == 1);
+    filters[i]->Update();
+    }
+
+  typedef typename TFilter::OutputImageType              OutputImageType;
+  typedef itk::ImageRegionConstIterator<OutputImageType> IteratorType;
+
+  double maxDiff = 0.;
+  for (unsigned int o = 0; o < filters[0]->GetNumberOfOutputs(); ++o)
+    {
+    IteratorType it(filters[0]->GetOutput(o), filters[0]->GetOutput(o)->GetLargestPossibleRegion());
+    IteratorType itInc(filters[1]->GetOutput(o), filters[1]->GetOutput(o)->GetLargestPossibleRegion());
+    for (it.GoToBegin(), itInc.GoToBegin(); !it.IsAtEnd(); ++it, ++itInc)
+      {
+      maxDiff = std::max(maxDiff, static_cast<double>(std::abs(it.Get() - itInc.Get())));
+      }
+    }
+  return maxDiff;
+}
+}
+
+int otbScalarImageToTexturesFilterIncremental(int argc, char * argv[])
+{
+  if (argc != 7)
+    {
+    std::cerr << "Usage: " << argv[0] << " infname radius offsetx offsety subsample tolerance" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const char *       infname   = argv[1];
+  const unsigned int radius    = atoi(argv[2]);
+  const int          offsetx   = atoi(argv[3]);
+  const int          offsety   = atoi(argv[4]);
+  const unsigned int subsample = atoi(argv[5]);
+  const double       tolerance = atof(argv[6]);
+
+  const unsigned int Dimension = 2;
+  typedef float                                                          PixelType;
+  typedef otb::Image<PixelType, Dimension>                               ImageType;
+  typedef otb::ScalarImageToTexturesFilter<ImageType, ImageType>         TexturesFilterType;
+  typedef otb::ScalarImageToAdvancedTexturesFilter<ImageType, ImageType> AdvancedTexturesFilterType;
+  typedef otb::ImageFileReader<ImageType>                                ReaderType;
+
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(infname);
+  reader->Update();
+
+  const double diff = CompareIncremental<TexturesFilterType>(
+    reader->GetOutput(), radius, offsetx, offsety, subsample);
+  const double advancedDiff = CompareIncremental<AdvancedTexturesFilterType>(
+    reader->GetOutput(), radius, offsetx, offsety, subsample);
+
+  std::cout << "Maximum difference: " << diff << " (simple textures), "
+            << advancedDiff << " (advanced textures)" << std::endl;
+
+  if (diff > tolerance || advancedDiff > tolerance)
+    {
+    std::cerr << "Incremental textures differ from the reference textures" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
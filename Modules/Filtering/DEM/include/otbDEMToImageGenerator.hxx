@@ -24,6 +24,9 @@
 #include "otbDEMToImageGenerator.h"
 #include "otbMacro.h"
 #include "itkProgressReporter.h"
+#include "itkImageScanlineIterator.h"
+
+#include <vector>
 
 namespace otb
 {
@@ -111,69 +114,59 @@ DEMToImageGenerator<TDEMImage>
 {
   DEMImagePointerType DEMImage = this->GetOutput();
 
-  // Create an iterator that will walk the output region
-  ImageIteratorType outIt = ImageIteratorType(DEMImage, outputRegionForThread);
+  // Walk the output region line by line
+  itk::ImageScanlineIterator<DEMImageType> outIt(DEMImage, outputRegionForThread);
 
   // support progress methods/callbacks
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
-  // Walk the output image, evaluating the height at each pixel
+  const size_t lineLength = outputRegionForThread.GetSize()[0];
+  std::vector<double> lon(lineLength);
+  std::vector<double> lat(lineLength);
+  std::vector<double> height(lineLength);
+
   IndexType currentindex;
   PointType phyPoint;
-  double    height;
   PointType geoPoint;
 
-  for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt)
+  for (outIt.GoToBegin(); !outIt.IsAtEnd(); outIt.NextLine())
     {
+    // Evaluate the heights of a whole line at once
     currentindex = outIt.GetIndex();
-    DEMImage->TransformIndexToPhysicalPoint(currentindex, phyPoint);
+    for (size_t k = 0; k < lineLength; ++k, ++currentindex[0])
+      {
+      DEMImage->TransformIndexToPhysicalPoint(currentindex, phyPoint);
 
+      geoPoint = m_Transform.IsNotNull() ? m_Transform->TransformPoint(phyPoint) : phyPoint;
+      lon[k] = geoPoint[0];
+      lat[k] = geoPoint[1];
+      }
 
-    if(m_Transform.IsNotNull())
+    if(m_AboveEllipsoid)
       {
-        geoPoint = m_Transform->TransformPoint(phyPoint);
-        if(m_AboveEllipsoid)
-          {
-          height = m_DEMHandler->GetHeightAboveEllipsoid(geoPoint); // Altitude
-                                                              // calculation
-          }
-        else
-          {
-          height = m_DEMHandler->GetHeightAboveMSL(geoPoint); // Altitude
-                                                              // calculation
-          }
+      m_DEMHandler->GetHeightAboveEllipsoid(lon.data(), lat.data(), height.data(), lineLength);
       }
     else
       {
- if(m_AboveEllipsoid)
-          {
-          height = m_DEMHandler->GetHeightAboveEllipsoid(phyPoint); // Altitude
-                                                                    // calculation
-          }
-        else
-          {
-          height = m_DEMHandler->GetHeightAboveMSL(phyPoint); // Altitude
-                                                              // calculation
-          }
+      m_DEMHandler->GetHeightAboveMSL(lon.data(), lat.data(), height.data(), lineLength);
       }
-/*    otbMsgDevMacro(<< "Index : (" << currentindex[0]<< "," << currentindex[1] << ") -> PhyPoint : ("
-                   << phyPoint[0] << "," << phyPoint[1] << ") -> GeoPoint: ("
-                   << geoPoint[0] << "," << geoPoint[1] << ") -> height" << height);
-*/
-//       otbMsgDevMacro(<< "height" << height);
-    // DEM sets a default value (-32768) at point where it doesn't have altitude information.
-    // OSSIM has chosen to change this default value in OSSIM_DBL_NAN (-4.5036e15).
-    if (!vnl_math_isnan(height))
-      {
-      // Fill the image
-      DEMImage->SetPixel(currentindex, static_cast<PixelType>(height));
-      }
-    else
+
+    for (size_t k = 0; k < lineLength; ++k, ++outIt)
       {
-      // Back to the MNT default value
-      DEMImage->SetPixel(currentindex, m_DefaultUnknownValue);
+      // DEM sets a default value (-32768) at point where it doesn't have altitude information.
+      // OSSIM has chosen to change this default value in OSSIM_DBL_NAN (-4.5036e15).
+      if (!vnl_math_isnan(height[k]))
+        {
+        // Fill the image
+        outIt.Set(static_cast<PixelType>(height[k]));
+        }
+      else
+        {
+        // Back to the MNT default value
+        outIt.Set(m_DefaultUnknownValue);
+        }
+      progress.CompletedPixel();
       }
-    progress.CompletedPixel();
     }
 }
 
@@ -19,6 +19,7 @@
 #define otbBinaryFunctorImageFilter_h
 
 #include "itkBinaryFunctorImageFilter.h"
+#include "otbFunctorTraits.h"
 
 namespace otb
 {
@@ -33,6 +34,10 @@ namespace otb
  * this number is lower or equal to zero, the behavior of the itk::BinaryFunctorImageFilter
  * remains unchanged.
  *
+ * Functors providing void operator()(TOutputPixel &, const TInput1Pixel &, const TInput2Pixel &)
+ * write their result in an output pixel sized once per thread, instead of
+ * returning a new pixel for each position (see otb::Functor::HasOutputArgument).
+ *
  * \sa itk::BinaryFunctorImageFilter
  *
  * \ingroup OTBImageManipulation
@@ -50,6 +55,16 @@ public:
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
+  /** Superclass typedefs. */
+  typedef typename Superclass::Input1ImageType       Input1ImageType;
+  typedef typename Superclass::Input2ImageType       Input2ImageType;
+  typedef typename Superclass::Input1ImagePixelType  Input1ImagePixelType;
+  typedef typename Superclass::Input2ImagePixelType  Input2ImagePixelType;
+  typedef typename Superclass::OutputImageType       OutputImageType;
+  typedef typename Superclass::OutputImagePixelType  OutputImagePixelType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename Superclass::FunctorType           FunctorType;
+
   /** Run-time type information (and related methods). */
   itkTypeMacro(BinaryFunctorImageFilter, itk::BinaryFunctorImageFilter);
 
@@ -73,12 +88,31 @@ protected:
       this->GetFunctor().GetOutputSize());
   }
 
+  /** Dispatch the pixel loop depending on the form of the functor */
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                            itk::ThreadIdType threadId) override;
+
 private:
   BinaryFunctorImageFilter(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  typedef otb::Functor::HasOutputArgument<FunctorType, OutputImagePixelType, Input1ImagePixelType, Input2ImagePixelType>
+    FunctorHasOutputArgumentType;
+
+  /** Pixel loop with functors returning the output pixel */
+  void ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+                    itk::ThreadIdType threadId, std::false_type);
+
+  /** Pixel loop with functors writing in the output pixel */
+  void ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+                    itk::ThreadIdType threadId, std::true_type);
+
 };
 
 } // end namespace otb
 
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbBinaryFunctorImageFilter.hxx"
+#endif
+
 #endif
@@ -0,0 +1,105 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef otbBinaryFunctorImageFilter_hxx
+#define otbBinaryFunctorImageFilter_hxx
+
+#include "otbBinaryFunctorImageFilter.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+
+namespace otb
+{
+
+template <class TInputImage1, class TInputImage2, class TOutputImage, class TFunction>
+void
+BinaryFunctorImageFilter<TInputImage1, TInputImage2, TOutputImage, TFunction>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+  this->ApplyFunctor(outputRegionForThread, threadId,
+                     typename FunctorHasOutputArgumentType::Type());
+}
+
+template <class TInputImage1, class TInputImage2, class TOutputImage, class TFunction>
+void
+BinaryFunctorImageFilter<TInputImage1, TInputImage2, TOutputImage, TFunction>
+::ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+               itk::ThreadIdType threadId, std::false_type)
+{
+  Superclass::ThreadedGenerateData(outputRegionForThread, threadId);
+}
+
+template <class TInputImage1, class TInputImage2, class TOutputImage, class TFunction>
+void
+BinaryFunctorImageFilter<TInputImage1, TInputImage2, TOutputImage, TFunction>
+::ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+               itk::ThreadIdType threadId, std::true_type)
+{
+  const Input1ImageType * inputPtr1 = dynamic_cast<const Input1ImageType *>(itk::ProcessObject::GetInput(0));
+  const Input2ImageType * inputPtr2 = dynamic_cast<const Input2ImageType *>(itk::ProcessObject::GetInput(1));
+
+  // One of the inputs is a constant: use the functor returning the pixel
+  if (inputPtr1 == nullptr || inputPtr2 == nullptr)
+    {
+    Superclass::ThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
+  OutputImageType * outputPtr = this->GetOutput(0);
+
+  const itk::SizeValueType size0 = outputRegionForThread.GetSize(0);
+  if (size0 == 0)
+    {
+    return;
+    }
+  const itk::SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
+  itk::ProgressReporter progress(this, threadId, numberOfLinesToProcess);
+
+  itk::ImageScanlineConstIterator<Input1ImageType> inputIt1(inputPtr1, outputRegionForThread);
+  itk::ImageScanlineConstIterator<Input2ImageType> inputIt2(inputPtr2, outputRegionForThread);
+  itk::ImageScanlineIterator<OutputImageType>      outputIt(outputPtr, outputRegionForThread);
+
+  // Single output pixel for the whole region, filled by the functor and
+  // copied in the output buffer
+  OutputImagePixelType outputPixel;
+  itk::NumericTraits<OutputImagePixelType>::SetLength(outputPixel,
+                                                      outputPtr->GetNumberOfComponentsPerPixel());
+
+  FunctorType & functor = this->GetFunctor();
+
+  while (!inputIt1.IsAtEnd())
+    {
+    while (!inputIt1.IsAtEndOfLine())
+      {
+      functor(outputPixel, inputIt1.Get(), inputIt2.Get());
+      outputIt.Set(outputPixel);
+      ++inputIt1;
+      ++inputIt2;
+      ++outputIt;
+      }
+    inputIt1.NextLine();
+    inputIt2.NextLine();
+    outputIt.NextLine();
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+}
+
+} // end namespace otb
+
+#endif
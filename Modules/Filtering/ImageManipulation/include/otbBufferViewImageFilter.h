@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbBufferViewImageFilter_h
+#define otbBufferViewImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+#include <type_traits>
+
+namespace otb
+{
+
+/** \class BufferViewImageFilter
+ *  \brief Expose the pixel buffer of an image as an image of another type
+ *
+ * When two image types store their pixels in the same kind of buffer,
+ * for instance otb::Image<float> and otb::VectorImage<float> with a
+ * single component, or two vector images of the same component type,
+ * the output of this filter shares the buffer of its input instead of
+ * copying it. No pixel is copied nor converted: only the buffer
+ * description (buffered region, number of components) changes.
+ *
+ * Use CanView() to check that a given input can be viewed as the output
+ * type. Types are compatible when their pixel containers are identical;
+ * a vector image can only be viewed as a scalar image if it has a
+ * single component. Otherwise, use a ClampImageFilter to convert the
+ * pixels.
+ *
+ * As the buffer is shared, the output must not be modified in place:
+ * consumers of the output should run with InPlaceOff(). A filter running
+ * in place on the output writes into the buffer of the input, and then
+ * releases the output. When this happens, the next update of the view
+ * releases its input as well, so that the upstream pipeline computes the
+ * buffer again instead of serving the modified pixels. An input without
+ * source can not be computed again: an exception is then thrown.
+ *
+ * \sa ClampImageFilter
+ *
+ * \ingroup OTBImageManipulation
+ */
+template <class TInputImage, class TOutputImage>
+class ITK_EXPORT BufferViewImageFilter :
+  public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef BufferViewImageFilter                              Self;
+  typedef itk::ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self>                            Pointer;
+  typedef itk::SmartPointer<const Self>                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(BufferViewImageFilter, itk::ImageToImageFilter);
+
+  typedef TInputImage  InputImageType;
+  typedef TOutputImage OutputImageType;
+
+  /** True if the input and output images store their pixels in the
+   *  same kind of buffer */
+  static constexpr bool LayoutCompatible =
+    std::is_same<typename TInputImage::PixelContainer, typename TOutputImage::PixelContainer>::value
+    && static_cast<unsigned int>(TInputImage::ImageDimension) == static_cast<unsigned int>(TOutputImage::ImageDimension);
+
+  /** True if the image type stores several components per pixel */
+  static constexpr bool InputIsVector =
+    !std::is_same<typename TInputImage::PixelType, typename TInputImage::InternalPixelType>::value;
+  static constexpr bool OutputIsVector =
+    !std::is_same<typename TOutputImage::PixelType, typename TOutputImage::InternalPixelType>::value;
+
+  /** Check if the buffer of input can be viewed as an output image.
+   *  This may update the output information of input. */
+  static bool CanView(InputImageType * input);
+
+protected:
+  BufferViewImageFilter();
+  ~BufferViewImageFilter() override {}
+
+  void GenerateOutputInformation() override;
+
+  /** Release the input if a consumer has modified the shared buffer */
+  void UpdateOutputData(itk::DataObject * output) override;
+
+  void GenerateData() override;
+
+private:
+  BufferViewImageFilter(const Self &) = delete;
+  void operator =(const Self&) = delete;
+
+  /** Share the input buffer with the output */
+  void ShareBuffer(std::true_type);
+
+  /** Incompatible layouts: nothing can be shared */
+  void ShareBuffer(std::false_type);
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbBufferViewImageFilter.hxx"
+#endif
+
+#endif
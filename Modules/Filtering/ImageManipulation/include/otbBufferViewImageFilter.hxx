@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbBufferViewImageFilter_hxx
+#define otbBufferViewImageFilter_hxx
+
+#include "otbBufferViewImageFilter.h"
+
+namespace otb
+{
+
+template <class TInputImage, class TOutputImage>
+BufferViewImageFilter<TInputImage, TOutputImage>
+::BufferViewImageFilter()
+{
+  this->SetNumberOfRequiredInputs(1);
+}
+
+template <class TInputImage, class TOutputImage>
+bool
+BufferViewImageFilter<TInputImage, TOutputImage>
+::CanView(InputImageType * input)
+{
+  if (!LayoutCompatible || input == nullptr)
+    {
+    return false;
+    }
+
+  if (InputIsVector && !OutputIsVector)
+    {
+    // A scalar image can only view a single band
+    input->UpdateOutputInformation();
+    return input->GetNumberOfComponentsPerPixel() == 1;
+    }
+
+  return true;
+}
+
+template <class TInputImage, class TOutputImage>
+void
+BufferViewImageFilter<TInputImage, TOutputImage>
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  const unsigned int nbComponents = this->GetInput()->GetNumberOfComponentsPerPixel();
+  if (InputIsVector && !OutputIsVector && nbComponents != 1)
+    {
+    itkExceptionMacro(<< "Unable to view an image with " << nbComponents << " components as a scalar image");
+    }
+
+  this->GetOutput()->SetNumberOfComponentsPerPixel(nbComponents);
+}
+
+template <class TInputImage, class TOutputImage>
+void
+BufferViewImageFilter<TInputImage, TOutputImage>
+::UpdateOutputData(itk::DataObject * output)
+{
+  // A filter running in place on the output has written into the shared
+  // buffer, and released the output afterwards
+  InputImageType * input = const_cast<InputImageType *>(this->GetInput());
+  if (input != nullptr && this->GetOutput()->GetDataReleased()
+      && input->GetBufferedRegion().GetNumberOfPixels() > 0)
+    {
+    if (input->GetSource() == nullptr)
+      {
+      itkExceptionMacro(<< "The buffer of the input may have been modified in place through the view, "
+                        << "and it can not be computed again");
+      }
+    input->ReleaseData();
+    }
+
+  Superclass::UpdateOutputData(output);
+}
+
+template <class TInputImage, class TOutputImage>
+void
+BufferViewImageFilter<TInputImage, TOutputImage>
+::GenerateData()
+{
+  this->ShareBuffer(std::integral_constant<bool, LayoutCompatible>());
+}
+
+template <class TInputImage, class TOutputImage>
+void
+BufferViewImageFilter<TInputImage, TOutputImage>
+::ShareBuffer(std::true_type)
+{
+  // Same as Graft(), across image types: the container itself is shared
+  InputImageType * input = const_cast<InputImageType *>(this->GetInput());
+  OutputImageType * output = this->GetOutput();
+
+  output->SetBufferedRegion(input->GetBufferedRegion());
+  output->SetPixelContainer(input->GetPixelContainer());
+}
+
+template <class TInputImage, class TOutputImage>
+void
+BufferViewImageFilter<TInputImage, TOutputImage>
+::ShareBuffer(std::false_type)
+{
+  itkExceptionMacro(<< "Input and output image types do not share the same buffer layout");
+}
+
+} // end namespace otb
+
+#endif
@@ -22,7 +22,7 @@
 #define otbConcatenateVectorImageFilter_hxx
 
 #include "otbConcatenateVectorImageFilter.h"
-#include "itkImageRegionIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkProgressReporter.h"
 
 namespace otb
@@ -140,62 +140,57 @@ ConcatenateVectorImageFilter<TInputImage1, TInputImage2, TOutputImage>
   InputImage2PointerType input2 = this->GetInput2();
   OutputImagePointerType output = this->GetOutput();
 
-  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
-
   // Define the portion of the input to walk for this thread
   typename InputImage1Type::RegionType inputRegionForThread;
   this->CallCopyOutputRegionToInputRegion(inputRegionForThread, outputRegionForThread);
 
-  // Iterators typedefs
-  typedef itk::ImageRegionIterator<InputImage1Type> Input1IteratorType;
-  typedef itk::ImageRegionIterator<InputImage2Type> Input2IteratorType;
-  typedef itk::ImageRegionIterator<OutputImageType> OutputIteratorType;
+  // Retrieve the size of each input pixel
+  const unsigned int l1 = input1->GetNumberOfComponentsPerPixel();
+  const unsigned int l2 = input2->GetNumberOfComponentsPerPixel();
+  const unsigned int lOut = output->GetNumberOfComponentsPerPixel();
+  // Check the size of the output pixel
+  assert(l1 + l2 == lOut);
+
+  typedef typename InputImage1Type::InternalPixelType InputInternalPixel1Type;
+  typedef typename InputImage2Type::InternalPixelType InputInternalPixel2Type;
+
+  // The pixels of a line are contiguous in the interleaved buffers: the
+  // components are copied from the input buffers to the output buffer
+  // without building any pixel
+  typedef itk::ImageScanlineConstIterator<InputImage1Type> Input1IteratorType;
+  typedef itk::ImageScanlineIterator<OutputImageType>      OutputIteratorType;
 
-  // Iterators declaration
   Input1IteratorType input1It(input1, inputRegionForThread);
-  Input2IteratorType input2It(input2, inputRegionForThread);
   OutputIteratorType outputIt(output, outputRegionForThread);
 
-  input1It.GoToBegin();
-  input2It.GoToBegin();
-  outputIt.GoToBegin();
+  const unsigned long width = outputRegionForThread.GetSize(0);
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels() / width);
 
-  typename OutputImageType::PixelType outputPix(outputIt.Get().GetSize());
-  // Retrieve the size of each input pixel
-  const unsigned int l1 = input1It.Get().GetSize();
-  const unsigned int l2 = input2It.Get().GetSize();
-
-  // Iterate through the pixel
-  while (!outputIt.IsAtEnd())
+  for (input1It.GoToBegin(), outputIt.GoToBegin();
+       !outputIt.IsAtEnd();
+       input1It.NextLine(), outputIt.NextLine())
     {
-
-    // Check the size of each input pixel
-    assert(l1 == input1It.Get().GetSize());
-    assert(l2 == input2It.Get().GetSize());
-    // Check the size of the output pixel
-    assert(l1 + l2 == outputPix.GetSize());
-    // References to the input pixels
-    InputPixel1Type const& pix1 = input1It.Get();
-    InputPixel2Type const& pix2 = input2It.Get();
-
-    // Loop through each band of the first image
-    for (unsigned int i = 0; i < l1; ++i)
-      {
-      // Fill the output pixel
-      outputPix[i] = static_cast<typename OutputImageType::InternalPixelType>(pix1[i]);
-      }
-    // Loop though each band of the second image
-    for (unsigned int i = 0; i < l2; ++i)
+    const InputInternalPixel1Type * pix1 = input1->GetBufferPointer()
+      + input1->ComputeOffset(input1It.GetIndex()) * l1;
+    const InputInternalPixel2Type * pix2 = input2->GetBufferPointer()
+      + input2->ComputeOffset(input1It.GetIndex()) * l2;
+    OutputInternalPixelType * outputPix = output->GetBufferPointer()
+      + output->ComputeOffset(outputIt.GetIndex()) * lOut;
+
+    for (unsigned long x = 0; x < width; ++x)
       {
-      // Fill the output pixel
-      outputPix[i + l1] = static_cast<typename OutputImageType::InternalPixelType>(pix2[i]);
+      // Loop through each band of the first image
+      for (unsigned int i = 0; i < l1; ++i)
+        {
+        *outputPix++ = static_cast<OutputInternalPixelType>(*pix1++);
+        }
+      // Loop though each band of the second image
+      for (unsigned int i = 0; i < l2; ++i)
+        {
+        *outputPix++ = static_cast<OutputInternalPixelType>(*pix2++);
+        }
       }
-    // Set the output pixel
-    outputIt.Set(outputPix);
-    // Increment the iterator
-    ++input1It;
-    ++input2It;
-    ++outputIt;
+    progress.CompletedPixel();
     }
 
 }
@@ -25,8 +25,10 @@
 #include "itkImageToImageFilter.h"
 #include "itkLinearInterpolateImageFunction.h"
 #include "itkDefaultConvertPixelTraits.h"
+#include "itkProgressReporter.h"
 
 #include "otbMacro.h"
+#include "otbSeparableInterpolationKernel.h"
 
 namespace otb
 {
@@ -51,6 +53,12 @@ namespace otb
  *  If CheckOutputBounds flag is set to true (default value), the
  *  interpolated value will be checked for output pixel type range
  *  prior to casting.
+ *
+ *  When the interpolator has a separable kernel (see
+ *  SeparableInterpolationKernel, implemented by the BCO and windowed
+ *  sinc interpolators), its weights are computed once per output
+ *  column and once per output line, and applied to all the bands of
+ *  the input pixels at once.
  *   
  * \ingroup OTBImageManipulation
  * \ingroup Streamed
@@ -100,6 +108,10 @@ public:
   typedef typename InterpolatorType::OutputType                           InterpolatorOutputType;
   typedef itk::DefaultConvertPixelTraits< InterpolatorOutputType >        InterpolatorConvertType;
   typedef typename InterpolatorConvertType::ComponentType                 InterpolatorComponentType;
+
+  /** Evaluation of the separable interpolators */
+  typedef SeparableKernelEvaluator<InputImageType>                        KernelEvaluatorType;
+  typedef typename KernelEvaluatorType::Taps                              KernelTapsType;
   
   /** Input pixel continuous index typdef */
   typedef typename itk::ContinuousIndex<double,InputImageDimension >      ContinuousInputIndexType;
@@ -186,12 +198,47 @@ protected:
   }
   
   
+  /** Same as CastPixelWithBoundsChecking(), for the values computed by
+   *  the kernel evaluator */
+  inline void CastComponentsWithBoundsChecking( const double * values,
+                                                const InterpolatorComponentType& minComponent,
+                                                const InterpolatorComponentType& maxComponent,
+                                                OutputPixelType& outputValue ) const
+  {
+    const unsigned int nComponents = OutputPixelConvertType::GetNumberOfComponents( outputValue );
+
+    for (unsigned int n=0; n<nComponents; n++)
+      {
+      InterpolatorComponentType component = static_cast<InterpolatorComponentType>( values[n] );
+
+      if ( m_CheckOutputBounds && component < minComponent )
+        {
+        OutputPixelConvertType::SetNthComponent( n, outputValue, static_cast<OutputPixelComponentType>( minComponent ) );
+        }
+      else if ( m_CheckOutputBounds && component > maxComponent )
+        {
+        OutputPixelConvertType::SetNthComponent( n, outputValue, static_cast<OutputPixelComponentType>( maxComponent ) );
+        }
+      else
+        {
+        OutputPixelConvertType::SetNthComponent(n, outputValue,
+                                                static_cast<OutputPixelComponentType>( component ) );
+        }
+      }
+  }
+
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
 private:
   GridResampleImageFilter(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  /** Resample a region with the separable kernel of the interpolator.
+   *  The weights of the columns are computed on the first line and
+   *  reused as long as the lines start at the same input position. */
+  void ResampleWithKernel(const OutputImageRegionType& region,
+                          itk::ProgressReporter& progress);
+
   IndexType              m_OutputStartIndex;     // output image start index
   SizeType               m_OutputSize;            // output image size
   PointType              m_OutputOrigin;         // output image origin
@@ -210,6 +257,11 @@ private:
                                                    // variable for
                                                    // speed-up. Computed
                                                    // in BeforeThreadedGenerateData
+
+  KernelEvaluatorType     m_KernelEvaluator;       // Set up in
+                                                   // BeforeThreadedGenerateData
+                                                   // if the interpolator
+                                                   // kernel is separable
   
 };
 
@@ -31,6 +31,8 @@
 #include "itkImageScanlineIterator.h"
 #include "itkContinuousIndex.h"
 
+#include <vector>
+
 namespace otb
 {
   
@@ -45,7 +47,8 @@ GridResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecision>
     m_EdgePaddingValue(),
     m_CheckOutputBounds(true),
     m_Interpolator(),
-    m_ReachableOutputRegion()
+    m_ReachableOutputRegion(),
+    m_KernelEvaluator()
 {
   // Set linear interpolator as default
   m_Interpolator = dynamic_cast<InterpolatorType *>(DefaultInterpolatorType::New().GetPointer());
@@ -219,6 +222,9 @@ GridResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecision>
   // Connect input image to interpolator
   m_Interpolator->SetInputImage( this->GetInput() );
 
+  // Use the separable kernel of the interpolator if it has one
+  m_KernelEvaluator = KernelEvaluatorType();
+  m_KernelEvaluator.Initialize( m_Interpolator.GetPointer(), this->GetInput() );
 
   unsigned int nComponents
     = itk::DefaultConvertPixelTraits<OutputPixelType>::GetNumberOfComponents(
@@ -335,6 +341,12 @@ GridResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecision>
                                   threadId,
                                   regionToCompute.GetSize()[1]);
 
+  if (m_KernelEvaluator.IsValid())
+    {
+    this->ResampleWithKernel(regionToCompute, progress);
+    return;
+    }
+
   // Temporary variables for loop
   PointType outPoint;
   ContinuousInputIndexType inCIndex;
@@ -381,6 +393,81 @@ GridResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecision>
 
 }
 
+template <typename TInputImage, typename TOutputImage,
+          typename TInterpolatorPrecision>
+void
+GridResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecision>
+::ResampleWithKernel(const OutputImageRegionType& region, itk::ProgressReporter& progress)
+{
+  OutputImageType *outputPtr = this->GetOutput();
+  const InputImageType *inputPtr = this->GetInput();
+
+  const OutputPixelComponentType minValue =  itk::NumericTraits< OutputPixelComponentType >::NonpositiveMin();
+  const OutputPixelComponentType maxValue =  itk::NumericTraits< OutputPixelComponentType >::max();
+
+  const InterpolatorComponentType minOutputValue = static_cast< InterpolatorComponentType >( minValue );
+  const InterpolatorComponentType maxOutputValue = static_cast< InterpolatorComponentType >( maxValue );
+
+  // Each thread needs its own buffers
+  KernelEvaluatorType evaluator(m_KernelEvaluator);
+  const unsigned int nComponents = evaluator.GetNumberOfComponents();
+
+  std::vector<double> values(nComponents);
+  OutputPixelType outputValue;
+  itk::NumericTraits<OutputPixelType>::SetLength( outputValue, nComponents );
+
+  // Weights of the columns of the region, and of the current line
+  std::vector<KernelTapsType> columns(region.GetSize()[0]);
+  KernelTapsType line;
+  bool columnsComputed = false;
+  double columnsStart = 0.;
+
+  const double delta = outputPtr->GetSignedSpacing()[0]/inputPtr->GetSignedSpacing()[0];
+
+  PointType outPoint;
+  ContinuousInputIndexType inCIndex;
+
+  itk::ImageScanlineIterator<OutputImageType> outIt(outputPtr, region);
+  outIt.GoToBegin();
+
+  while(!outIt.IsAtEnd())
+    {
+    // Map output index to input continuous index
+    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(),outPoint);
+    inputPtr->TransformPhysicalPointToContinuousIndex(outPoint,inCIndex);
+
+    // The input positions of the columns are accumulated as in the
+    // generic loop, so that the weights are exactly the same
+    if (!columnsComputed || inCIndex[0] != columnsStart)
+      {
+      columnsStart = inCIndex[0];
+      double x = inCIndex[0];
+      for (typename std::vector<KernelTapsType>::iterator it = columns.begin(); it != columns.end(); ++it)
+        {
+        evaluator.ComputeTaps(x, 0, *it);
+        x += delta;
+        }
+      columnsComputed = true;
+      }
+
+    evaluator.ComputeTaps(inCIndex[1], 1, line);
+
+    for (typename std::vector<KernelTapsType>::const_iterator it = columns.begin(); it != columns.end(); ++it)
+      {
+      evaluator.Evaluate(*it, line, values.data());
+
+      this->CastComponentsWithBoundsChecking(values.data(),minOutputValue,maxOutputValue,outputValue);
+
+      outIt.Set(outputValue);
+      ++outIt;
+      }
+
+    progress.CompletedPixel();
+
+    outIt.NextLine();
+    }
+}
+
 template <typename TInputImage, typename TOutputImage,
           typename TInterpolatorPrecision>
 void
@@ -23,7 +23,7 @@
 
 #include "itkImageToImageFilter.h"
 #include "otbStreamingWarpImageFilter.h"
-#include "itkTransformToDisplacementFieldSource.h"
+#include "otbTransformToDisplacementFieldSource.h"
 #include "itkLinearInterpolateImageFunction.h"
 #include "otbImage.h"
 #include "itkVector.h"
@@ -47,6 +47,13 @@ namespace otb
  * the  interpolator (SetInterpolator()) and the origin (SetOrigin())
  * can be set using the method between brackets.
  *
+ * When a maximum displacement field error is set (in pixels of the
+ * input image), the displacement field is estimated on an adaptive
+ * grid instead: cells are refined until the interpolated displacement
+ * is within this error of the transform, starting from cells of the
+ * displacement field spacing (32 output pixels at least). See
+ * otb::TransformToDisplacementFieldSource.
+ *
  *
  *
  * \ingroup Projection
@@ -88,8 +95,8 @@ public:
                                    DisplacementFieldType>        WarpImageFilterType;
 
   /** Internal filters typedefs*/
-  typedef itk::TransformToDisplacementFieldSource<DisplacementFieldType,
-                                                 double>        DisplacementFieldGeneratorType;
+  typedef TransformToDisplacementFieldSource<DisplacementFieldType,
+                                             double>            DisplacementFieldGeneratorType;
   typedef typename DisplacementFieldGeneratorType::TransformType TransformType;
   typedef typename DisplacementFieldGeneratorType::SizeType      SizeType;
   typedef typename DisplacementFieldGeneratorType::SpacingType   SpacingType;
@@ -124,6 +131,19 @@ public:
     return m_SignedOutputSpacing;
   };
 
+  /** Maximum error of the adaptive displacement field, in pixels of the
+   *  input image. 0 (the default) uses a regular grid with the
+   *  displacement field spacing. */
+  itkSetMacro(DisplacementFieldMaximumError, double);
+  itkGetConstMacro(DisplacementFieldMaximumError, double);
+
+  /** Number of points transformed to build the displacement field */
+  otbGetObjectMemberConstMacro(DisplacementFilter, NumberOfTransformEvaluations, unsigned long long);
+
+  /** Largest error estimated on the interpolated cells of the adaptive
+   *  displacement field, in pixels of the input image */
+  otbGetObjectMemberConstMacro(DisplacementFilter, AchievedError, double);
+
   /** The resampled image parameters */
   // Output Origin
   void SetOutputOrigin(const OriginType & origin)
@@ -190,10 +210,15 @@ private:
   StreamingResampleImageFilter(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  /** Set the spacing and direction of the displacement field */
+  void SetDisplacementFilterSpacing(SpacingType spacing);
+
   //We need this to respect ConstRef macro and to be compliant with itk positive 
   //spacing
   SpacingType m_SignedOutputSpacing;
 
+  double m_DisplacementFieldMaximumError;
+
   typename DisplacementFieldGeneratorType::Pointer   m_DisplacementFilter;
   typename WarpImageFilterType::Pointer             m_WarpFilter;
 };
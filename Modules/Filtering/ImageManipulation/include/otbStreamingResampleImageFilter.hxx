@@ -23,6 +23,7 @@
 
 #include "otbStreamingResampleImageFilter.h"
 #include "itkProgressAccumulator.h"
+#include <algorithm>
 #include "otbImage.h"
 
 namespace otb
@@ -31,6 +32,7 @@ namespace otb
 template <class TInputImage, class TOutputImage, class TInterpolatorPrecisionType>
 StreamingResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType>
 ::StreamingResampleImageFilter()
+  : m_DisplacementFieldMaximumError(0.)
 {
   // internal filters instantiation
   m_DisplacementFilter = DisplacementFieldGeneratorType::New();
@@ -73,6 +75,35 @@ StreamingResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionTy
     this->SetDisplacementFieldSpacing(2.*this->GetOutputSpacing());
     }
 
+  if (m_DisplacementFieldMaximumError > 0.)
+    {
+    // The adaptive grid estimates the displacement of every output
+    // pixel, starting from cells of the displacement field spacing
+    double cellSize = 32.;
+    for(unsigned int dim = 0; dim < InputImageType::ImageDimension; ++dim)
+      {
+      cellSize = std::max(cellSize, std::abs(this->GetDisplacementFieldSpacing()[dim]
+                                             / this->GetOutputSpacing()[dim]));
+      }
+    this->SetDisplacementFilterSpacing(this->GetOutputSpacing());
+    m_DisplacementFilter->SetInitialCellSize(static_cast<unsigned int>(cellSize));
+    m_DisplacementFilter->SetMaximumError(m_DisplacementFieldMaximumError);
+
+    // Errors are measured in input pixels
+    SpacingType errorSpacing;
+    errorSpacing.Fill(1.);
+    if (this->GetInput() != nullptr)
+      {
+      errorSpacing = this->GetInput()->GetSpacing();
+      }
+    m_DisplacementFilter->SetErrorSpacing(errorSpacing);
+    }
+  else
+    {
+    this->SetDisplacementFilterSpacing(this->GetDisplacementFieldSpacing());
+    m_DisplacementFilter->SetMaximumError(0.);
+    }
+
   // Retrieve output largest region
   SizeType largestSize       = this->GetOutputSize();
 
@@ -90,7 +121,7 @@ StreamingResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionTy
     displacementFieldLargestSize[dim] = static_cast<unsigned int>(
       std::ceil( largestSize[dim]*
                 std::abs(this->GetOutputSpacing()[dim] /
-                        this->GetDisplacementFieldSpacing()[dim]))) + 1;
+                        m_DisplacementFilter->GetOutputSpacing()[dim]))) + 1;
     }
   m_DisplacementFilter->SetOutputSize(displacementFieldLargestSize);
   m_DisplacementFilter->SetOutputIndex(this->GetOutputStartIndex());
@@ -133,7 +164,17 @@ StreamingResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionTy
 ::SetDisplacementFieldSpacing( SpacingType outputSpacing )
 {
   m_SignedOutputSpacing = outputSpacing;
-  typename TInputImage::DirectionType direction = this->m_DisplacementFilter->GetOutputDirection();
+  this->SetDisplacementFilterSpacing( outputSpacing );
+  this->Modified();
+}
+
+template <class TInputImage, class TOutputImage, class TInterpolatorPrecisionType>
+void
+StreamingResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType>
+::SetDisplacementFilterSpacing( SpacingType outputSpacing )
+{
+  typename TInputImage::DirectionType direction;
+  direction.SetIdentity();
   for(unsigned int i = 0; i < TInputImage::ImageDimension; ++i)
     {
     if ( outputSpacing[i] < 0 )
@@ -150,7 +191,6 @@ StreamingResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionTy
     }
   this->m_DisplacementFilter->SetOutputSpacing( outputSpacing );
   this->m_DisplacementFilter->SetOutputDirection( direction );
-  this->Modified();
 }
 
 template <class TInputImage, class TOutputImage, class TInterpolatorPrecisionType>
@@ -163,6 +203,7 @@ StreamingResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionTy
   os << indent << "OutputSpacing: " << this->GetOutputSpacing() << std::endl;
   os << indent << "OutputStartIndex: " << this->GetOutputStartIndex() << std::endl;
   os << indent << "OutputSize: " << this->GetOutputSize() << std::endl;
+  os << indent << "DisplacementFieldMaximumError: " << m_DisplacementFieldMaximumError << std::endl;
 }
 
 
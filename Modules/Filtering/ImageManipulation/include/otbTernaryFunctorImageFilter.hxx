@@ -0,0 +1,102 @@
+/*=========================================================================
+
+  Program:   ORFEO Toolbox
+  Language:  C++
+  Date:      $Date$
+  Version:   $Revision$
+
+
+  Copyright (c) Centre National d'Etudes Spatiales. All rights reserved.
+  See OTBCopyright.txt for details.
+
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notices for more information.
+
+=========================================================================*/
+
+#ifndef otbTernaryFunctorImageFilter_hxx
+#define otbTernaryFunctorImageFilter_hxx
+
+#include "otbTernaryFunctorImageFilter.h"
+#include "itkImageScanlineIterator.h"
+#include "itkProgressReporter.h"
+
+namespace otb
+{
+
+template <class TInputImage1, class TInputImage2, class TInputImage3, class TOutputImage, class TFunction>
+void
+TernaryFunctorImageFilter<TInputImage1, TInputImage2, TInputImage3, TOutputImage, TFunction>
+::ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread,
+                       itk::ThreadIdType threadId)
+{
+  this->ApplyFunctor(outputRegionForThread, threadId,
+                     typename FunctorHasOutputArgumentType::Type());
+}
+
+template <class TInputImage1, class TInputImage2, class TInputImage3, class TOutputImage, class TFunction>
+void
+TernaryFunctorImageFilter<TInputImage1, TInputImage2, TInputImage3, TOutputImage, TFunction>
+::ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+               itk::ThreadIdType threadId, std::false_type)
+{
+  Superclass::ThreadedGenerateData(outputRegionForThread, threadId);
+}
+
+template <class TInputImage1, class TInputImage2, class TInputImage3, class TOutputImage, class TFunction>
+void
+TernaryFunctorImageFilter<TInputImage1, TInputImage2, TInputImage3, TOutputImage, TFunction>
+::ApplyFunctor(const OutputImageRegionType& outputRegionForThread,
+               itk::ThreadIdType threadId, std::true_type)
+{
+  const Input1ImageType * inputPtr1 = dynamic_cast<const Input1ImageType *>(itk::ProcessObject::GetInput(0));
+  const Input2ImageType * inputPtr2 = dynamic_cast<const Input2ImageType *>(itk::ProcessObject::GetInput(1));
+  const Input3ImageType * inputPtr3 = dynamic_cast<const Input3ImageType *>(itk::ProcessObject::GetInput(2));
+
+  OutputImageType * outputPtr = this->GetOutput(0);
+
+  const itk::SizeValueType size0 = outputRegionForThread.GetSize(0);
+  if (size0 == 0)
+    {
+    return;
+    }
+  const itk::SizeValueType numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
+  itk::ProgressReporter progress(this, threadId, numberOfLinesToProcess);
+
+  itk::ImageScanlineConstIterator<Input1ImageType> inputIt1(inputPtr1, outputRegionForThread);
+  itk::ImageScanlineConstIterator<Input2ImageType> inputIt2(inputPtr2, outputRegionForThread);
+  itk::ImageScanlineConstIterator<Input3ImageType> inputIt3(inputPtr3, outputRegionForThread);
+  itk::ImageScanlineIterator<OutputImageType>      outputIt(outputPtr, outputRegionForThread);
+
+  // Single output pixel for the whole region, filled by the functor and
+  // copied in the output buffer
+  OutputImagePixelType outputPixel;
+  itk::NumericTraits<OutputImagePixelType>::SetLength(outputPixel,
+                                                      outputPtr->GetNumberOfComponentsPerPixel());
+
+  FunctorType & functor = this->GetFunctor();
+
+  while (!inputIt1.IsAtEnd())
+    {
+    while (!inputIt1.IsAtEndOfLine())
+      {
+      functor(outputPixel, inputIt1.Get(), inputIt2.Get(), inputIt3.Get());
+      outputIt.Set(outputPixel);
+      ++inputIt1;
+      ++inputIt2;
+      ++inputIt3;
+      ++outputIt;
+      }
+    inputIt1.NextLine();
+    inputIt2.NextLine();
+    inputIt3.NextLine();
+    outputIt.NextLine();
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+}
+
+} // end namespace otb
+
+#endif
@@ -150,9 +150,17 @@ public:
     // output instantiation
     TOutput result;
     result.SetSize(x.GetSize());
+    (*this)(result, x);
+    return result;
+  }
 
+  /** Computation in a pre-sized output pixel, used by the functor
+   *  filters so that no pixel is allocated per call. */
+  inline void operator ()(TOutput& result, const TInput& x)
+  {
     // consistency checking
-    if (result.GetSize() != m_OutputMinimum.GetSize()
+    if (result.GetSize() != x.GetSize()
+        || result.GetSize() != m_OutputMinimum.GetSize()
         || result.GetSize() != m_OutputMaximum.GetSize()
         || result.GetSize() != m_InputMinimum.GetSize()
         || result.GetSize() != m_InputMaximum.GetSize())
@@ -183,7 +191,6 @@ public:
         result[i] = static_cast<typename TOutput::ValueType>(scaledComponent + m_OutputMinimum[i]);
         }
       }
-    return result;
   }
 private:
   TOutput m_OutputMaximum;
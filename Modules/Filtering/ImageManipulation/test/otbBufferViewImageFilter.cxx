@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBufferViewImageFilter.h"
+#include "otbImage.h"
+#include "otbVectorImage.h"
+#include "otbImageToVectorImageCastFilter.h"
+
+#include "itkImageRegionIterator.h"
+#include "itkUnaryFunctorImageFilter.h"
+
+namespace
+{
+class AddOneFunctor
+{
+public:
+  float operator()(float value) const
+  {
+    return value + 1.f;
+  }
+
+  bool operator!=(const AddOneFunctor &) const
+  {
+    return false;
+  }
+
+  bool operator==(const AddOneFunctor & other) const
+  {
+    return !(*this != other);
+  }
+};
+}
+
+int otbBufferViewImageFilter(int itkNotUsed(argc), char * itkNotUsed(argv) [])
+{
+  typedef otb::Image<float, 2>                                    FloatImageType;
+  typedef otb::VectorImage<float, 2>                              FloatVectorImageType;
+  typedef otb::VectorImage<double, 2>                             DoubleVectorImageType;
+  typedef otb::BufferViewImageFilter<FloatImageType, FloatVectorImageType> ScalarToVectorViewType;
+  typedef otb::BufferViewImageFilter<FloatVectorImageType, FloatImageType> VectorToScalarViewType;
+  typedef otb::BufferViewImageFilter<FloatImageType, DoubleVectorImageType> IncompatibleViewType;
+
+  FloatImageType::RegionType region;
+  region.SetSize(0, 17);
+  region.SetSize(1, 11);
+
+  FloatImageType::Pointer image = FloatImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  float value = 0;
+  itk::ImageRegionIterator<FloatImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    it.Set(value++);
+    }
+
+  if (!ScalarToVectorViewType::CanView(image) || IncompatibleViewType::CanView(image))
+    {
+    std::cerr << "Wrong layout compatibility" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Scalar to vector: the buffer is shared
+  ScalarToVectorViewType::Pointer view = ScalarToVectorViewType::New();
+  view->SetInput(image);
+  view->Update();
+
+  FloatVectorImageType * output = view->GetOutput();
+  if (output->GetBufferPointer() != image->GetBufferPointer()
+      || output->GetNumberOfComponentsPerPixel() != 1
+      || output->GetBufferedRegion() != image->GetBufferedRegion())
+    {
+    std::cerr << "The output does not share the input buffer" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  FloatImageType::IndexType index;
+  index[0] = 5;
+  index[1] = 7;
+  if (output->GetPixel(index)[0] != image->GetPixel(index))
+    {
+    std::cerr << "Wrong pixel value: " << output->GetPixel(index)[0] << " instead of " << image->GetPixel(index) << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Back to scalar: a single band vector image can be viewed
+  VectorToScalarViewType::Pointer backView = VectorToScalarViewType::New();
+  backView->SetInput(output);
+  backView->Update();
+
+  if (backView->GetOutput()->GetBufferPointer() != image->GetBufferPointer())
+    {
+    std::cerr << "The scalar view does not share the input buffer" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A multi-band vector image can not be viewed as a scalar image
+  FloatVectorImageType::Pointer vectorImage = FloatVectorImageType::New();
+  vectorImage->SetRegions(region);
+  vectorImage->SetNumberOfComponentsPerPixel(3);
+  vectorImage->Allocate();
+
+  if (VectorToScalarViewType::CanView(vectorImage))
+    {
+    std::cerr << "A 3 bands image should not be viewed as a scalar image" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A consumer running in place writes into the shared buffer: the
+  // upstream buffer must be computed again on the next update
+  typedef otb::ImageToVectorImageCastFilter<FloatImageType, FloatVectorImageType> CastFilterType;
+  typedef itk::UnaryFunctorImageFilter<FloatImageType, FloatImageType, AddOneFunctor> AddOneFilterType;
+
+  CastFilterType::Pointer cast = CastFilterType::New();
+  cast->SetInput(image);
+
+  VectorToScalarViewType::Pointer castView = VectorToScalarViewType::New();
+  castView->SetInput(cast->GetOutput());
+
+  AddOneFilterType::Pointer addOne = AddOneFilterType::New();
+  addOne->SetInput(castView->GetOutput());
+  addOne->InPlaceOn();
+
+  for (unsigned int run = 0; run < 2; ++run)
+    {
+    addOne->Modified();
+    addOne->Update();
+    if (addOne->GetOutput()->GetPixel(index) != image->GetPixel(index) + 1.f)
+      {
+      std::cerr << "Run " << run << ": wrong pixel value after an in place consumer: "
+                << addOne->GetOutput()->GetPixel(index) << " instead of " << image->GetPixel(index) + 1.f << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbVectorImage.h"
+#include "otbBinaryFunctorImageFilter.h"
+#include "otbTernaryFunctorImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+/** Weighted sum of vector pixels, providing both functor forms */
+class WeightedSumFunctor
+{
+public:
+  typedef itk::VariableLengthVector<double> PixelType;
+
+  unsigned int GetOutputSize() const
+  {
+    return 3;
+  }
+
+  bool operator !=(const WeightedSumFunctor&) const
+  {
+    return false;
+  }
+
+  bool operator ==(const WeightedSumFunctor& other) const
+  {
+    return !(*this != other);
+  }
+
+  PixelType operator ()(const PixelType& a, const PixelType& b) const
+  {
+    PixelType result(GetOutputSize());
+    (*this)(result, a, b);
+    return result;
+  }
+
+  void operator ()(PixelType& result, const PixelType& a, const PixelType& b) const
+  {
+    for (unsigned int i = 0; i < result.GetSize(); ++i)
+      {
+      result[i] = a[i % a.GetSize()] + 2. * b[i % b.GetSize()];
+      }
+  }
+
+  PixelType operator ()(const PixelType& a, const PixelType& b, const PixelType& c) const
+  {
+    PixelType result(GetOutputSize());
+    (*this)(result, a, b, c);
+    return result;
+  }
+
+  void operator ()(PixelType& result, const PixelType& a, const PixelType& b, const PixelType& c) const
+  {
+    (*this)(result, a, b);
+    for (unsigned int i = 0; i < result.GetSize(); ++i)
+      {
+      result[i] += 3. * c[i % c.GetSize()];
+      }
+  }
+};
+
+typedef otb::VectorImage<double, 2> ImageType;
+
+ImageType::Pointer CreateImage(const ImageType::RegionType& region, unsigned int nbBands, unsigned int seed)
+{
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  ImageType::PixelType pixel(nbBands);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    for (unsigned int b = 0; b < nbBands; ++b)
+      {
+      pixel[b] = (it.GetIndex()[0] * 7 + it.GetIndex()[1] * 13 + b * 29 + seed) % 101;
+      }
+    it.Set(pixel);
+    }
+  return image;
+}
+
+bool CheckOutput(const ImageType* output, const ImageType* reference)
+{
+  itk::ImageRegionConstIteratorWithIndex<ImageType> outIt(output, reference->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType>          refIt(reference, reference->GetLargestPossibleRegion());
+  for (outIt.GoToBegin(), refIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt, ++refIt)
+    {
+    if (outIt.Get() != refIt.Get())
+      {
+      std::cerr << "Pixel " << outIt.GetIndex() << ": " << outIt.Get() << " instead of " << refIt.Get() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int otbFunctorImageFilterOutputArgument(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  typedef otb::BinaryFunctorImageFilter<ImageType, ImageType, ImageType, WeightedSumFunctor>             BinaryFilterType;
+  typedef otb::TernaryFunctorImageFilter<ImageType, ImageType, ImageType, ImageType, WeightedSumFunctor> TernaryFilterType;
+
+  static_assert(otb::Functor::HasOutputArgument<WeightedSumFunctor, ImageType::PixelType,
+                                                ImageType::PixelType, ImageType::PixelType>::value,
+                "The binary form writing in the output pixel should be detected");
+  static_assert(otb::Functor::HasOutputArgument<WeightedSumFunctor, ImageType::PixelType,
+                                                ImageType::PixelType, ImageType::PixelType, ImageType::PixelType>::value,
+                "The ternary form writing in the output pixel should be detected");
+
+  ImageType::RegionType region;
+  region.SetSize(0, 37);
+  region.SetSize(1, 23);
+
+  ImageType::Pointer image1 = CreateImage(region, 2, 0);
+  ImageType::Pointer image2 = CreateImage(region, 4, 5);
+  ImageType::Pointer image3 = CreateImage(region, 1, 11);
+
+  // Reference: the functor returning a new pixel
+  WeightedSumFunctor functor;
+  ImageType::Pointer binaryReference = CreateImage(region, functor.GetOutputSize(), 0);
+  ImageType::Pointer ternaryReference = CreateImage(region, functor.GetOutputSize(), 0);
+  itk::ImageRegionConstIterator<ImageType> it1(image1, region), it2(image2, region), it3(image3, region);
+  itk::ImageRegionIterator<ImageType> binIt(binaryReference, region), terIt(ternaryReference, region);
+  for (; !it1.IsAtEnd(); ++it1, ++it2, ++it3, ++binIt, ++terIt)
+    {
+    binIt.Set(functor(it1.Get(), it2.Get()));
+    terIt.Set(functor(it1.Get(), it2.Get(), it3.Get()));
+    }
+
+  BinaryFilterType::Pointer binaryFilter = BinaryFilterType::New();
+  binaryFilter->SetInput1(image1);
+  binaryFilter->SetInput2(image2);
+  binaryFilter->Update();
+
+  if (binaryFilter->GetOutput()->GetNumberOfComponentsPerPixel() != functor.GetOutputSize() ||
+      !CheckOutput(binaryFilter->GetOutput(), binaryReference))
+    {
+    std::cerr << "Wrong output of the binary functor filter" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  TernaryFilterType::Pointer ternaryFilter = TernaryFilterType::New();
+  ternaryFilter->SetInput1(image1);
+  ternaryFilter->SetInput2(image2);
+  ternaryFilter->SetInput3(image3);
+  ternaryFilter->Update();
+
+  if (ternaryFilter->GetOutput()->GetNumberOfComponentsPerPixel() != functor.GetOutputSize() ||
+      !CheckOutput(ternaryFilter->GetOutput(), ternaryReference))
+    {
+    std::cerr << "Wrong output of the ternary functor filter" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
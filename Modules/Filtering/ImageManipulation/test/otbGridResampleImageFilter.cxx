@@ -30,6 +30,7 @@
 #include "itkStreamingImageFilter.h"
 
 #include "otbImageFileWriter.h"
+#include "otbBCOInterpolateImageFunction.h"
 
 int otbGridResampleImageFilter(int itkNotUsed(argc), char * itkNotUsed(argv)[])
 {
@@ -160,3 +161,99 @@ int otbGridResampleImageFilter(int itkNotUsed(argc), char * itkNotUsed(argv)[])
 
   return EXIT_SUCCESS;
 }
+
+int otbGridResampleImageFilterBCO(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  // Same comparison with the BCO interpolator, whose separable kernel
+  // is evaluated by the filter itself
+  typedef otb::Image<double> ImageType;
+  typedef otb::GridResampleImageFilter<ImageType,ImageType> FilterType;
+  typedef itk::ResampleImageFilter<ImageType,ImageType> RefFilterType;
+  typedef otb::BCOInterpolateImageFunction<ImageType> InterpolatorType;
+  typedef itk::IdentityTransform<double,2> IdentityTransformType;
+
+  typedef itk::Statistics::MersenneTwisterRandomVariateGenerator RandomGeneratorType;
+  RandomGeneratorType::Pointer randomGenerator = RandomGeneratorType::GetInstance();
+
+  ImageType::SizeType size;
+  size.Fill(500);
+  ImageType::RegionType region;
+  region.SetSize(size);
+
+  ImageType::Pointer randomImage = ImageType::New();
+  randomImage->SetRegions(region);
+  randomImage->Allocate();
+  typedef itk::ImageRegionIterator<ImageType> IteratorType;
+  IteratorType iter(randomImage,region);
+  for (iter.GoToBegin() ; !iter.IsAtEnd() ; ++iter)
+    {
+    iter.Set(randomGenerator->GetUniformVariate(0.0, 1.0) * 1000);
+    }
+
+  InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  interpolator->SetRadius(3);
+  InterpolatorType::Pointer refInterpolator = InterpolatorType::New();
+  refInterpolator->SetRadius(3);
+
+  // Upsampling, so that the window of the kernel crosses the borders
+  // of the streamed regions
+  ImageType::SpacingType spacing;
+  spacing[0]=0.37;
+  spacing[1]=-0.29;
+  ImageType::PointType origin;
+  origin[0]=3.1;
+  origin[1]=71.7;
+  ImageType::SizeType outSize;
+  outSize.Fill(211);
+  ImageType::DirectionType direction;
+  direction.SetIdentity();
+  direction[1][1] = -1;
+  ImageType::SpacingType uspacing;
+  uspacing[0] = spacing[0];
+  uspacing[1] = -spacing[1];
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(randomImage);
+  filter->SetInterpolator(interpolator);
+  filter->SetOutputSize(outSize);
+  filter->SetOutputOrigin(origin);
+  filter->SetOutputSpacing(spacing);
+  filter->SetCheckOutputBounds(false);
+
+  RefFilterType::Pointer refFilter = RefFilterType::New();
+  refFilter->SetInput(randomImage);
+  refFilter->SetTransform(IdentityTransformType::New());
+  refFilter->SetInterpolator(refInterpolator);
+  refFilter->SetSize(outSize);
+  refFilter->SetOutputOrigin(origin);
+  refFilter->SetOutputSpacing(uspacing);
+  refFilter->SetOutputDirection(direction);
+
+  typedef itk::StreamingImageFilter<ImageType,ImageType> StreamingFilterType;
+  StreamingFilterType::Pointer streamingRef = StreamingFilterType::New();
+  streamingRef->SetInput(refFilter->GetOutput());
+  streamingRef->SetNumberOfStreamDivisions(7);
+
+  StreamingFilterType::Pointer streaming = StreamingFilterType::New();
+  streaming->SetInput(filter->GetOutput());
+  streaming->SetNumberOfStreamDivisions(7);
+
+  typedef otb::DifferenceImageFilter<ImageType,ImageType> ComparisonFilterType;
+  ComparisonFilterType::Pointer comparisonFilter = ComparisonFilterType::New();
+  comparisonFilter->SetValidInput(streamingRef->GetOutput());
+  comparisonFilter->SetTestInput(streaming->GetOutput());
+  comparisonFilter->SetDifferenceThreshold(1e-9);
+  comparisonFilter->Update();
+
+  unsigned int nbPixelsWithDiff = comparisonFilter->GetNumberOfPixelsWithDifferences();
+
+  std::cout<<"Number of pixels with differences: "<<nbPixelsWithDiff<<std::endl;
+
+  if(nbPixelsWithDiff)
+    {
+    std::cerr<<"Output of otb::GridResampleImageFilter with a BCO interpolator does not match output of itk::ResampleImageFilter"<<std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -48,6 +48,8 @@ void RegisterTests()
   REGISTER_TEST(otbChangeLabelImageFilter);
   REGISTER_TEST(otbBoxAndWhiskerImageFilter);
   REGISTER_TEST(otbVectorRescaleIntensityImageFilter);
+  REGISTER_TEST(otbVectorRescaleIntensityImageFilterOutputArgument);
+  REGISTER_TEST(otbFunctorImageFilterOutputArgument);
   REGISTER_TEST(otbLog10ThresholdedImageFilterTest);
   REGISTER_TEST(otbExtractROIResample);
   REGISTER_TEST(otbLocalGradientVectorImageFilterTest);
@@ -60,6 +62,7 @@ void RegisterTests()
   REGISTER_TEST(otbMultiplyByScalarImageFilterTest);
   REGISTER_TEST(otbClampImageFilterTest);
   REGISTER_TEST(otbClampImageFilterConversionTest);
+  REGISTER_TEST(otbBufferViewImageFilter);
   REGISTER_TEST(otbConcatenateVectorImageFilter);
   REGISTER_TEST(otbBinaryImageToDensityImageFilter);
   REGISTER_TEST(otbSpectralAngleDistanceImageFilter);
@@ -71,6 +74,7 @@ void RegisterTests()
   REGISTER_TEST(otbImageToNoDataMaskFilter);
   REGISTER_TEST(otbChangeInformationImageFilter);
   REGISTER_TEST(otbGridResampleImageFilter);
+  REGISTER_TEST(otbGridResampleImageFilterBCO);
   REGISTER_TEST(otbMaskedIteratorDecoratorNominal);
   REGISTER_TEST(otbMaskedIteratorDecoratorDegenerate);
   REGISTER_TEST(otbMaskedIteratorDecoratorExtended);
@@ -23,6 +23,7 @@
 #include "otbImageFileReader.h"
 #include "otbImageFileWriter.h"
 #include "otbMultiChannelExtractROI.h"
+#include "itkImageRegionIteratorWithIndex.h"
 
 int otbVectorRescaleIntensityImageFilter(int itkNotUsed(argc), char * argv[])
 {
@@ -71,3 +72,87 @@ int otbVectorRescaleIntensityImageFilter(int itkNotUsed(argc), char * argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbVectorRescaleIntensityImageFilterOutputArgument(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  typedef otb::VectorImage<double, 2>                                             InputImageType;
+  typedef otb::VectorImage<unsigned char, 2>                                      OutputImageType;
+  typedef otb::VectorRescaleIntensityImageFilter<InputImageType, OutputImageType> FilterType;
+  typedef FilterType::FunctorType                                                 FunctorType;
+
+  static_assert(otb::Functor::HasOutputArgument<FunctorType, OutputImageType::PixelType,
+                                                InputImageType::PixelType>::value,
+                "VectorAffineTransform should write in the output pixel");
+
+  const unsigned int nbBands = 4;
+  InputImageType::RegionType region;
+  region.SetSize(0, 37);
+  region.SetSize(1, 23);
+
+  InputImageType::Pointer image = InputImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<InputImageType> it(image, region);
+  InputImageType::PixelType pixel(nbBands);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    for (unsigned int b = 0; b < nbBands; ++b)
+      {
+      pixel[b] = (it.GetIndex()[0] * 7 + it.GetIndex()[1] * 13 + b * 29) % 101 - 10.5;
+      }
+    it.Set(pixel);
+    }
+
+  OutputImageType::PixelType outputMin(nbBands), outputMax(nbBands);
+  InputImageType::PixelType  inputMin(nbBands), inputMax(nbBands);
+  for (unsigned int b = 0; b < nbBands; ++b)
+    {
+    outputMin[b] = 10 * b;
+    outputMax[b] = 200 + 10 * b;
+    inputMin[b] = 5. * b;
+    inputMax[b] = 80. - 5. * b;
+    }
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(image);
+  filter->SetOutputMinimum(outputMin);
+  filter->SetOutputMaximum(outputMax);
+  filter->AutomaticInputMinMaxComputationOff();
+  filter->SetInputMinimum(inputMin);
+  filter->SetInputMaximum(inputMax);
+  filter->SetGamma(1.5);
+  filter->Update();
+
+  // Reference: the functor returning a new pixel
+  FunctorType functor;
+  functor.SetOutputMinimum(outputMin);
+  functor.SetOutputMaximum(outputMax);
+  functor.SetInputMinimum(inputMin);
+  functor.SetInputMaximum(inputMax);
+  functor.SetGamma(1.5);
+
+  itk::ImageRegionConstIterator<OutputImageType> outIt(filter->GetOutput(), region);
+  for (it.GoToBegin(), outIt.GoToBegin(); !it.IsAtEnd(); ++it, ++outIt)
+    {
+    const OutputImageType::PixelType expected = functor(it.Get());
+    const OutputImageType::PixelType & value = outIt.Get();
+    if (value.GetSize() != nbBands)
+      {
+      std::cerr << "Wrong number of components: " << value.GetSize() << std::endl;
+      return EXIT_FAILURE;
+      }
+    for (unsigned int b = 0; b < nbBands; ++b)
+      {
+      if (value[b] != expected[b])
+        {
+        std::cerr << "Pixel " << it.GetIndex() << " band " << b << ": " << +value[b]
+                  << " instead of " << +expected[b] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  return EXIT_SUCCESS;
+}
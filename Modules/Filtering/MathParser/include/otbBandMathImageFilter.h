@@ -70,6 +70,12 @@ namespace otb
  * This functionality assumes that all the band involved have the same
  * spacing and origin.
  *
+ * The expression is not evaluated pixel by pixel: each thread copies
+ * blocks of whole lines of its region (about BlockSize pixels) in a
+ * buffer per variable, and the parser evaluates the expression on the
+ * whole block at once (muParser bulk mode). This saves the cost of a
+ * parser call and of the iterators per pixel.
+ *
  *
  * \sa Parser
  *
@@ -142,7 +148,15 @@ private :
 
   std::string                           m_Expression;
   std::vector<ParserType::Pointer>      m_VParser;
+  /** Per thread, the block of values of each variable, one after the other */
   std::vector< std::vector<double> >    m_AImage;
+  /** Per thread, the block of results */
+  std::vector< std::vector<double> >    m_AResult;
+  /** Approximate number of pixels of a block evaluated at once by the parser */
+  static const unsigned long            BlockSize = 4096;
+  /** Number of lines of a block, and number of values of a variable in a block */
+  unsigned long                         m_LinesPerBlock;
+  unsigned long                         m_BlockLength;
   std::vector< std::string >            m_VVarName;
   unsigned int                          m_NbVar;
 
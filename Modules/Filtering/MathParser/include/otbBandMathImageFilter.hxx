@@ -23,12 +23,14 @@
 #define otbBandMathImageFilter_hxx
 #include "otbBandMathImageFilter.h"
 
-#include "itkImageRegionIterator.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkImageScanlineIterator.h"
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
 #include "otbMacro.h"
 
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -49,6 +51,8 @@ BandMathImageFilter<TImage>
   m_OverflowCount = 0;
   m_ThreadUnderflow.SetSize(1);
   m_ThreadOverflow.SetSize(1);
+  m_LinesPerBlock = 1;
+  m_BlockLength = 0;
 }
 
 /** Destructor */
@@ -184,6 +188,12 @@ void BandMathImageFilter<TImage>
   m_Spacing = this->GetNthInput(0)->GetSignedSpacing();
   m_Origin = this->GetNthInput(0)->GetOrigin();
 
+  // Blocks are made of whole lines of the thread regions, which are
+  // not wider than the requested region
+  const unsigned long width = std::max<unsigned long>(1, this->GetOutput()->GetRequestedRegion().GetSize(0));
+  m_LinesPerBlock = std::max<unsigned long>(1, BlockSize / width);
+  m_BlockLength = m_LinesPerBlock * width;
+
   // Allocate and initialize the thread temporaries
   m_ThreadUnderflow.SetSize(nbThreads);
   m_ThreadUnderflow.Fill(0);
@@ -191,6 +201,7 @@ void BandMathImageFilter<TImage>
   m_ThreadOverflow.Fill(0);
   m_VParser.resize(nbThreads);
   m_AImage.resize(nbThreads);
+  m_AResult.resize(nbThreads);
   m_NbVar = nbInputImages+nbAccessIndex;
   m_VVarName.resize(m_NbVar);
 
@@ -201,18 +212,19 @@ void BandMathImageFilter<TImage>
 
   for(i = 0; i < nbThreads; ++i)
     {
-    m_AImage[i].resize(m_NbVar);
+    m_AImage[i].resize(m_NbVar * m_BlockLength);
+    m_AResult[i].resize(m_BlockLength);
     m_VParser[i]->SetExpr(m_Expression);
 
     for(j=0; j < nbInputImages; ++j)
       {
-      m_VParser[i]->DefineVar(m_VVarName[j], &(m_AImage[i][j]));
+      m_VParser[i]->DefineVar(m_VVarName[j], &(m_AImage[i][j * m_BlockLength]));
       }
 
     for(j=nbInputImages; j < nbInputImages+nbAccessIndex; ++j)
       {
       m_VVarName[j] = tmpIdxVarNames[j-nbInputImages];
-      m_VParser[i]->DefineVar(m_VVarName[j], &(m_AImage[i][j]));
+      m_VParser[i]->DefineVar(m_VVarName[j], &(m_AImage[i][j * m_BlockLength]));
       }
     }
 }
@@ -249,86 +261,116 @@ void BandMathImageFilter<TImage>
 ::ThreadedGenerateData(const ImageRegionType& outputRegionForThread,
            itk::ThreadIdType threadId)
 {
-  double value;
   unsigned int j;
   unsigned int nbInputImages = this->GetNumberOfInputs();
 
-  typedef itk::ImageRegionConstIterator<TImage> ImageRegionConstIteratorType;
+  typedef itk::ImageScanlineConstIterator<TImage> ImageScanlineConstIteratorType;
+  typedef itk::ImageScanlineIterator<TImage>      ImageScanlineIteratorType;
 
   assert(nbInputImages);
-  std::vector< ImageRegionConstIteratorType > Vit(nbInputImages);
+  std::vector< ImageScanlineConstIteratorType > Vit(nbInputImages);
 
   for(j=0; j < nbInputImages; ++j)
     {
-    Vit[j] = ImageRegionConstIteratorType (this->GetNthInput(j), outputRegionForThread);
+    Vit[j] = ImageScanlineConstIteratorType (this->GetNthInput(j), outputRegionForThread);
     }
 
-  itk::ImageRegionIterator<TImage> ot (this->GetOutput(), outputRegionForThread);
+  ImageScanlineIteratorType ot (this->GetOutput(), outputRegionForThread);
 
   // support progress methods/callbacks
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
   std::vector<double>      & threadImage     = m_AImage[threadId];
+  std::vector<double>      & threadResult    = m_AResult[threadId];
   ParserType::Pointer const& threadParser    = m_VParser[threadId];
   long                     & threadUnderflow = m_ThreadUnderflow[threadId];
   long                     & threadOverflow  = m_ThreadOverflow[threadId];
-  ImageRegionConstIteratorType & firstImageRegion = Vit.front(); // alias for better perfs
+  ImageScanlineConstIteratorType & firstImageRegion = Vit.front(); // alias for better perfs
+
+  const unsigned long width = outputRegionForThread.GetSize(0);
+  double * idxX    = &threadImage[nbInputImages * m_BlockLength];
+  double * idxY    = idxX + m_BlockLength;
+  double * idxPhyX = idxY + m_BlockLength;
+  double * idxPhyY = idxPhyX + m_BlockLength;
+
+  const double minValue = static_cast<double>(itk::NumericTraits<PixelType>::NonpositiveMin());
+  const double maxValue = static_cast<double>(itk::NumericTraits<PixelType>::max());
+
   while(!firstImageRegion.IsAtEnd())
-     {
-     for(j=0; j < nbInputImages; ++j)
-       {
-       threadImage[j] = static_cast<double>(Vit[j].Get());
-       }
-
-    // Image Indexes
-    for(j=0; j < 2; ++j)
-      {
-      threadImage[nbInputImages+j]   = static_cast<double>(firstImageRegion.GetIndex()[j]);
-      }
-    for(j=0; j < 2; ++j)
+    {
+    // Copy a block of whole lines, variable after variable
+    unsigned long count = 0;
+    for(unsigned long line = 0; line < m_LinesPerBlock && !firstImageRegion.IsAtEnd(); ++line)
       {
-      threadImage[nbInputImages+2+j] = static_cast<double>(m_Origin[j])
-        + static_cast<double>(firstImageRegion.GetIndex()[j]) * static_cast<double>(m_Spacing[j]);
+      const IndexType lineIndex = firstImageRegion.GetIndex();
+
+      for(j=0; j < nbInputImages; ++j)
+        {
+        double * values = &threadImage[j * m_BlockLength + count];
+        ImageScanlineConstIteratorType & it = Vit[j];
+        while(!it.IsAtEndOfLine())
+          {
+          *values++ = static_cast<double>(it.Get());
+          ++it;
+          }
+        it.NextLine();
+        }
+
+      // Image Indexes
+      const double y = static_cast<double>(lineIndex[1]);
+      const double phyY = static_cast<double>(m_Origin[1]) + y * static_cast<double>(m_Spacing[1]);
+      for(unsigned long k = 0; k < width; ++k)
+        {
+        const double x = static_cast<double>(lineIndex[0]) + static_cast<double>(k);
+        idxX[count + k]    = x;
+        idxY[count + k]    = y;
+        idxPhyX[count + k] = static_cast<double>(m_Origin[0]) + x * static_cast<double>(m_Spacing[0]);
+        idxPhyY[count + k] = phyY;
+        }
+
+      count += width;
       }
 
     try
       {
-
-      value = threadParser->Eval();
+      threadParser->Eval(&threadResult[0], static_cast<int>(count));
       }
     catch(itk::ExceptionObject& err)
       {
       itkExceptionMacro(<< err);
       }
 
-    // Case value is equal to -inf or inferior to the minimum value
-    // allowed by the pixelType cast
-    if (value < double(itk::NumericTraits<PixelType>::NonpositiveMin()))
-      {
-      ot.Set(itk::NumericTraits<PixelType>::NonpositiveMin());
-      threadUnderflow++;
-      }
-    // Case value is equal to inf or superior to the maximum value
-    // allowed by the pixelType cast
-    else if (value > double(itk::NumericTraits<PixelType>::max()))
+    const double * result = &threadResult[0];
+    for(unsigned long written = 0; written < count; written += width)
       {
-      ot.Set(itk::NumericTraits<PixelType>::max());
-      threadOverflow++;
+      while(!ot.IsAtEndOfLine())
+        {
+        const double value = *result++;
+
+        // Case value is equal to -inf or inferior to the minimum value
+        // allowed by the pixelType cast
+        if (value < minValue)
+          {
+          ot.Set(itk::NumericTraits<PixelType>::NonpositiveMin());
+          threadUnderflow++;
+          }
+        // Case value is equal to inf or superior to the maximum value
+        // allowed by the pixelType cast
+        else if (value > maxValue)
+          {
+          ot.Set(itk::NumericTraits<PixelType>::max());
+          threadOverflow++;
+          }
+        else
+          {
+          ot.Set(static_cast<PixelType>(value));
+          }
+
+        ++ot;
+        progress.CompletedPixel();
+        }
+      ot.NextLine();
       }
-    else
-      {
-      ot.Set(static_cast<PixelType>(value));
-      }
-
-    for(j=0; j < nbInputImages; ++j)
-      {
-      ++Vit[j];
-      }
-
-    ++ot;
-
-    progress.CompletedPixel();
-
     }
 }
 
@@ -69,6 +69,12 @@ public:
   /** Trigger the parsing */
   ValueType Eval();
 
+  /** Evaluate the expression nbValues times in a row (bulk mode): every
+   *  variable must then point to an array of nbValues values, and the
+   *  results are written to results. This is much faster than nbValues
+   *  calls to Eval() for the same variables. */
+  void Eval(ValueType * results, int nbValues);
+
   /** Define a variable */
   void DefineVar(const std::string &sName, ValueType *fVar);
 
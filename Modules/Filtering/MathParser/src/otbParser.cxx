@@ -96,6 +96,19 @@ public:
     return result;
   }
 
+  /** Trigger the parsing in bulk mode */
+  void Eval(ValueType * results, int nbValues)
+  {
+    try
+      {
+      m_MuParser.Eval(results, nbValues);
+      }
+    catch(ExceptionType &e)
+      {
+      ExceptionHandler(e);
+      }
+  }
+
 
   /** Define a variable */
   void DefineVar(const std::string &sName, ValueType *fVar)
@@ -254,6 +267,11 @@ Parser::ValueType Parser::Eval()
   return m_InternalParser->Eval();
 }
 
+void Parser::Eval(Parser::ValueType * results, int nbValues)
+{
+  m_InternalParser->Eval(results, nbValues);
+}
+
 void Parser::DefineVar(const std::string &sName, Parser::ValueType *fVar)
 {
   m_InternalParser->DefineVar(sName, fVar);
@@ -21,6 +21,9 @@
 #include "otbMath.h"
 #include "otbParser.h"
 
+#include <algorithm>
+#include <vector>
+
 typedef otb::Parser ParserType;
 
 
@@ -108,6 +111,32 @@ void otbParserTest_LogicalOperator(void)
   otbParserTest_ThrowIfNotEqual(static_cast<int>(parser->Eval()), 1, "LogicalOperator or");
 }
 
+void otbParserTest_BulkEval(void)
+{
+  const int size = 100;
+  std::vector<double> red(size), nir(size), results(size);
+  for (int i = 0; i < size; ++i)
+    {
+    red[i] = 10.0 + i;
+    nir[i] = 200.0 - 2 * i;
+    }
+
+  ParserType::Pointer parser = ParserType::New();
+  parser->DefineVar("red", &red[0]);
+  parser->DefineVar("nir", &nir[0]);
+  parser->SetExpr("ndvi(red, nir) + (red > 50 ? 1 : 0)");
+  parser->Eval(&results[0], size);
+
+  // Compare to the values one by one
+  double maxError = 0.0;
+  for (int i = 0; i < size; ++i)
+    {
+    const double ref = (nir[i] - red[i]) / (nir[i] + red[i]) + (red[i] > 50 ? 1 : 0);
+    maxError = std::max(maxError, std::abs(results[i] - ref));
+    }
+  otbParserTest_ThrowIfNotEqual(maxError, 0.0, "BulkEval");
+}
+
 int otbParserTest(int itkNotUsed(argc), char * itkNotUsed(argv) [])
 {
   otbParserTest_Numerical();
@@ -117,5 +146,6 @@ int otbParserTest(int itkNotUsed(argc), char * itkNotUsed(argv) [])
   otbParserTest_UserDefinedVars();
   otbParserTest_Mixed();
   otbParserTest_LogicalOperator();
+  otbParserTest_BulkEval();
   return EXIT_SUCCESS;
 }
@@ -110,6 +110,18 @@ public:
                                         DisplacementFieldSpacing,
                                         SpacingType);
 
+  /** Maximum error of the adaptive displacement field, in input pixels
+   *  (0 uses a regular grid) */
+  otbSetObjectMemberMacro(Resampler, DisplacementFieldMaximumError, double);
+  otbGetObjectMemberConstMacro(Resampler, DisplacementFieldMaximumError, double);
+
+  /** Number of points transformed to build the displacement field */
+  otbGetObjectMemberConstMacro(Resampler, NumberOfTransformEvaluations, unsigned long long);
+
+  /** Largest error estimated on the adaptive displacement field, in
+   *  input pixels */
+  otbGetObjectMemberConstMacro(Resampler, AchievedError, double);
+
   /** The resampled image parameters */
   /** Output Origin */
   void SetOutputOrigin(const OriginType & origin)
@@ -27,6 +27,10 @@
 #include "itkImageRegionConstIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
 
 
 namespace otb
@@ -181,16 +185,17 @@ private:
   unsigned int m_NumberOfComponentsPerPixel;
 };
 
-#if 0 //disable bucket mode
 /** \class BucketImage
  *
- * This class indexes pixels in a N-dimensional image into a N+1-dimensional
- * array of buckets. Each pixel is stored into one bucket depending on its
- * position on the lattice (the width of a bucket is given at construction) and
- * one spectral component (also given at construction by spectralCoordinate).
+ * This class indexes the pixels of an image by line and by bucket of values
+ * of one of their components. The width of a bucket is given at
+ * initialization: pixels whose values differ by less than this width are in
+ * the same bucket or in adjacent buckets.
  *
- * The (spatially and spectrally) neighboring buckets of pixels can then be
- * obtained by using GetNeighborhoodBucketListIndices().
+ * Within a line, the pixels of a bucket are sorted by column. The pixels of a
+ * neighborhood whose value is close to a given value can thus be visited in
+ * the same order as with a region iterator, skipping all the other pixels.
+ * Pixels with a non-finite value are not indexed.
  *
  * \ingroup OTBSmoothing
  */
@@ -199,206 +204,156 @@ class BucketImage
 {
 public:
   typedef TImage ImageType;
-  typedef typename ImageType::ConstPointer ImageConstPointerType;
-  typedef typename ImageType::PixelType PixelType;
-  typedef typename ImageType::InternalPixelType InternalPixelType;
   typedef typename ImageType::RegionType RegionType;
   typedef typename ImageType::IndexType IndexType;
+  typedef typename ImageType::SizeType SizeType;
+  typedef typename ImageType::InternalPixelType InternalPixelType;
 
   typedef double RealType;
+  typedef unsigned int ColumnType;
 
   static const unsigned int ImageDimension = ImageType::ImageDimension;
 
-  /** The bucket image has dimension N+1 (ie. usually 3D for most images) */
-  typedef std::vector<typename ImageType::SizeType::SizeValueType> BucketImageSizeType;
-  typedef std::vector<typename ImageType::IndexType::IndexValueType> BucketImageIndexType;
-  //typedef std::vector<long> BucketImageIndexType;
-
+  /** Maximum number of buckets: wider buckets are used beyond */
+  static const unsigned int MaximumNumberOfBuckets = 256;
 
-  /** pixel buckets typedefs and declarations */
-  typedef const typename ImageType::InternalPixelType * ImageDataPointerType;
-  typedef std::vector<ImageDataPointerType> BucketType;
-  typedef std::vector<BucketType> BucketListType;
-
-  BucketImage()
+  BucketImage() :
+    m_Component(0), m_MinimumValue(0), m_BucketWidth(1), m_NumberOfLines(0), m_NumberOfBuckets(0)
   {
   }
 
-  /** Constructor for the bucket image. It operates on the specified
-   * region.
-   * spatialRadius specifies the width of a bucket in pixels.
-   * rangeRadius is the spectral width for the specified spectral coordinate in
-   * one bucket.
-   * spectralCoordinate is the index of the pixel used for classification in buckets.
+  /** Index the pixels of the buffered region of the image. component is the
+   * pixel component used to sort pixels in buckets, whose values lie between
+   * minimum and maximum. bucketWidth must be positive.
    */
-  BucketImage(ImageConstPointerType image, const RegionType & region, RealType spatialRadius, RealType rangeRadius,
-              unsigned int spectralCoordinate) :
-    m_Image(image), m_Region(region), m_SpatialRadius(spatialRadius), m_RangeRadius(rangeRadius),
-        m_SpectralCoordinate(spectralCoordinate)
+  void Initialize(const ImageType * image, unsigned int component, RealType minimum, RealType maximum,
+                  RealType bucketWidth)
   {
-
-    // Find max and min of the used spectral band
-    itk::ImageRegionConstIterator<ImageType> inputIt(m_Image, m_Region);
-    inputIt.GoToBegin();
-    InternalPixelType minValue = inputIt.Get()[spectralCoordinate];
-    InternalPixelType maxValue = minValue;
-    ++inputIt;
-    while (!inputIt.IsAtEnd())
+    m_Region = image->GetBufferedRegion();
+    m_Component = component;
+    m_MinimumValue = minimum;
+
+    // Slightly wider buckets, so that values closer than bucketWidth are in
+    // adjacent buckets despite rounding errors
+    m_BucketWidth = bucketWidth * (1. + 1e-6);
+    if ((maximum - minimum) / m_BucketWidth >= MaximumNumberOfBuckets - 1)
       {
-      const PixelType &p = inputIt.Get();
-      minValue = std::min(minValue, p[m_SpectralCoordinate]);
-      maxValue = std::max(maxValue, p[m_SpectralCoordinate]);
-      ++inputIt;
+      m_BucketWidth = (maximum - minimum) / (MaximumNumberOfBuckets - 1) * (1. + 1e-6);
       }
+    m_NumberOfBuckets = std::min(static_cast<unsigned int>((maximum - minimum) / m_BucketWidth) + 1,
+                                 MaximumNumberOfBuckets);
+
+    const size_t numberOfColumns = m_Region.GetSize(0);
+    const size_t numberOfPixels = m_Region.GetNumberOfPixels();
+    m_NumberOfLines = numberOfColumns > 0 ? numberOfPixels / numberOfColumns : 0;
 
-    m_MinValue = minValue;
-    m_MaxValue = maxValue;
+    // Counting sort of the pixels by line and bucket: pixels are visited in
+    // raster order, so that columns are sorted within a bucket
+    const unsigned int numberOfComponents = image->GetNumberOfComponentsPerPixel();
+    const InternalPixelType * buffer = image->GetBufferPointer();
+    std::vector<unsigned int> buckets(numberOfPixels);
 
-    // Compute bucket image dimensions. Note: empty buckets are at each border
-    // to simplify image border issues
-    m_DimensionVector.resize(ImageDimension + 1); // NB: pays for a 0-innit
-    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    m_BucketOffsets.assign(m_NumberOfLines * m_NumberOfBuckets + 1, 0);
+    for (size_t i = 0; i < numberOfPixels; ++i)
       {
-      m_DimensionVector[dim] = m_Region.GetSize()[dim] / m_SpatialRadius + 3;
+      const RealType value = buffer[i * numberOfComponents + m_Component];
+      if (!std::isfinite(value))
+        {
+        buckets[i] = m_NumberOfBuckets;
+        continue;
+        }
+      buckets[i] = this->ClampBucket(this->GetBucket(value));
+      ++m_BucketOffsets[(i / numberOfColumns) * m_NumberOfBuckets + buckets[i] + 1];
       }
-    m_DimensionVector[ImageDimension] = (unsigned int) ((maxValue - minValue) / m_RangeRadius) + 3;
-
-    unsigned int numBuckets = m_DimensionVector[0];
-    for (unsigned int dim = 1; dim <= ImageDimension; ++dim)
-      numBuckets *= m_DimensionVector[dim];
-
-    m_BucketList.resize(numBuckets);
-    // Build buckets
-    itk::ImageRegionConstIteratorWithIndex<ImageType> it(m_Image, m_Region);
-    it.GoToBegin();
-    // this iterator is only used to get the pixel data pointer
-    FastImageRegionConstIterator<ImageType> fastIt(m_Image, m_Region);
-    fastIt.GoToBegin();
-
-    while (!it.IsAtEnd())
+    for (size_t i = 1; i < m_BucketOffsets.size(); ++i)
       {
-      const IndexType & index = it.GetIndex();
-      const PixelType & pixel = it.Get();
-
-      // Find which bucket this pixel belongs to
-      const BucketImageIndexType bucketIndex = GetBucketIndex(pixel, index);
-
-      unsigned int bucketListIndex = BucketIndexToBucketListIndex(bucketIndex);
-      assert(bucketListIndex < numBuckets);
-      m_BucketList[bucketListIndex].push_back(fastIt.GetPixelPointer());
-      ++it;
-      ++fastIt;
+      m_BucketOffsets[i] += m_BucketOffsets[i - 1];
       }
 
-    // Prepare neighborhood offset vector
-    // BucketImageIndexType zeroOffsetIndex(ImageDimension+1);
-    std::vector<BucketImageIndexType> neighborsIndexList;
-    neighborsIndexList.reserve(simple_pow(3, ImageDimension + 1));
-    neighborsIndexList.resize(1, BucketImageIndexType(ImageDimension + 1)); // zeroOffsetIndex
-    // neighborsIndexList.push_back(zeroOffsetIndex);
-    for (unsigned dim = 0; dim <= ImageDimension; ++dim)
+    std::vector<size_t> position(m_BucketOffsets.begin(), m_BucketOffsets.end() - 1);
+    m_Columns.resize(m_BucketOffsets.back());
+    for (size_t i = 0; i < numberOfPixels; ++i)
       {
-      // take all neighbors already in the list and add their direct neighbor
-      // along the current dim
-      const unsigned int curSize = neighborsIndexList.size();
-      for (unsigned int i = 0; i < curSize; ++i)
+      if (buckets[i] < m_NumberOfBuckets)
         {
-        BucketImageIndexType index = neighborsIndexList[i];
-        index[dim]--;
-        neighborsIndexList.push_back(index);
-        index[dim] += 2;
-        neighborsIndexList.push_back(index);
+        m_Columns[position[(i / numberOfColumns) * m_NumberOfBuckets + buckets[i]]++] =
+          static_cast<ColumnType>(i % numberOfColumns);
         }
       }
-    // Convert all neighbors n-dimensional indices to bucket list 1D indices
-    const unsigned int neighborhoodOffsetVectorSize = neighborsIndexList.size();
-    m_NeighborhoodOffsetVector.reserve(neighborhoodOffsetVectorSize);
-    for (unsigned int i = 0; i < neighborhoodOffsetVectorSize; ++i)
-      {
-      const int listIndex = BucketIndexToBucketListIndex(neighborsIndexList[i]);
-      m_NeighborhoodOffsetVector.push_back(listIndex);
-      }
   }
 
-  ~BucketImage()
+  /** Release the memory used by the index */
+  void Clear()
   {
+    std::vector<size_t>().swap(m_BucketOffsets);
+    std::vector<ColumnType>().swap(m_Columns);
+    m_NumberOfLines = 0;
+    m_NumberOfBuckets = 0;
   }
 
-  /** Returns the N+1-dimensional bucket index for a given pixel value at the given index */
-  BucketImageIndexType GetBucketIndex(const PixelType & pixel, const IndexType & index)
+  /** Returns the bucket of a value, which may be outside of the valid buckets */
+  long GetBucket(RealType value) const
   {
-    BucketImageIndexType bucketIndex(ImageDimension + 1);
-    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
-      {
-      bucketIndex[dim] = (index[dim] - m_Region.GetIndex()[dim]) / m_SpatialRadius + 1;
-      }
-    bucketIndex[ImageDimension] = (pixel[m_SpectralCoordinate] - m_MinValue) / m_RangeRadius + 1;
-    return bucketIndex;
+    return static_cast<long>(std::floor((value - m_MinimumValue) / m_BucketWidth));
   }
 
-  /** Converts a N+1-dimensional bucket index into the 1D list index usable by
-   GetBucket() */
-  int BucketIndexToBucketListIndex(const BucketImageIndexType & bucketIndex) const
+  /** Returns the line of an index of the buffered region */
+  size_t GetLine(const IndexType & index) const
   {
-    int bucketListIndex = bucketIndex[0];
-    for (unsigned int dim = 1; dim <= ImageDimension; ++dim)
+    size_t line = 0;
+    for (unsigned int dim = ImageDimension - 1; dim > 0; --dim)
       {
-      bucketListIndex = bucketListIndex * m_DimensionVector[dim] + bucketIndex[dim];
+      line = line * m_Region.GetSize(dim) + (index[dim] - m_Region.GetIndex(dim));
       }
-    return bucketListIndex;
+    return line;
   }
 
-  /** Retrieves the list of all buckets in the neighborhood of the given bucket */
-  std::vector<unsigned int> GetNeighborhoodBucketListIndices(int bucketIndex) const
+  /** Retrieves the columns of the pixels of a bucket in a line, sorted */
+  void GetColumns(size_t line, unsigned int bucket, const ColumnType *& begin, const ColumnType *& end) const
   {
-    const unsigned int neighborhoodOffsetVectorSize = m_NeighborhoodOffsetVector.size();
-    std::vector<unsigned int> indices(neighborhoodOffsetVectorSize);
+    const size_t b = line * m_NumberOfBuckets + bucket;
+    begin = m_Columns.data() + m_BucketOffsets[b];
+    end = m_Columns.data() + m_BucketOffsets[b + 1];
+  }
 
-    for (unsigned int i = 0; i < neighborhoodOffsetVectorSize; ++i)
-      {
-      indices[i] = bucketIndex + m_NeighborhoodOffsetVector[i];
-      }
-    return indices;
+  /** Pixel component used to sort pixels in buckets */
+  unsigned int GetComponent() const
+  {
+    return m_Component;
   }
 
-  /* Returns the list of pixels (actually pointer to pixel data) contained in a bucket */
-  const BucketType & GetBucket(unsigned int index) const
+  unsigned int GetNumberOfBuckets() const
   {
-    return m_BucketList[index];
+    return m_NumberOfBuckets;
   }
 
-  unsigned int GetNumberOfNeighborBuckets() const
+  const RegionType & GetRegion() const
   {
-    return m_NeighborhoodOffsetVector.size();
+    return m_Region;
   }
 
 private:
-  /** Input image */
-  ImageConstPointerType m_Image;
-  /** Processed region */
-  RegionType m_Region;
+  unsigned int ClampBucket(long bucket) const
+  {
+    return static_cast<unsigned int>(std::max(0l, std::min(bucket, static_cast<long>(m_NumberOfBuckets) - 1)));
+  }
 
-  /** Spatial radius of one bucket of pixels */
-  RealType m_SpatialRadius;
-  /** Range radius (at a single dimension) of one bucket of pixels */
-  RealType m_RangeRadius;
-  /** pixels are separated in buckets depending on their spatial position and
-   also their value at one coordinate */
-  unsigned int m_SpectralCoordinate;
-  /** Min and Max of selected spectral coordinate */
-  InternalPixelType m_MinValue;
-  InternalPixelType m_MaxValue;
-
-  /** the buckets are stored in this list */
-  BucketListType m_BucketList;
-  /** This vector holds the dimensions of the 3D (ND?) bucket image */
-  BucketImageSizeType m_DimensionVector;
-  /** Vector of offsets in the buckets list to get all buckets in the
-   * neighborhood
-   */
-  std::vector<int> m_NeighborhoodOffsetVector;
+  /** Indexed region */
+  RegionType m_Region;
+  /** Pixel component used to sort pixels in buckets */
+  unsigned int m_Component;
+  /** Value at the beginning of the first bucket */
+  RealType m_MinimumValue;
+  /** Width of a bucket */
+  RealType m_BucketWidth;
+  size_t m_NumberOfLines;
+  unsigned int m_NumberOfBuckets;
+
+  /** Position in m_Columns of the first pixel of each bucket of each line */
+  std::vector<size_t> m_BucketOffsets;
+  /** Columns of the pixels, sorted by line, bucket and column */
+  std::vector<ColumnType> m_Columns;
 };
-#endif
 
 } // end namespace Meanshift
 
@@ -438,6 +393,8 @@ private:
  * MeanShifVector squared norm is compared with Threshold (set using Get/Set accessor) to define pixel convergence (1e-3 by default).
  * MaxIterationNumber defines maximum iteration number for each pixel convergence (set using Get/Set accessor). Set to 4 by default.
  * ModeSearch is a boolean value, to choose between optimized and non optimized algorithm. If set to true (by default), assign mode value to each pixel on a path covered in convergence steps.
+ * GlobalModeSearch extends mode search to the pixels processed by the other threads.
+ * BucketOptimization sorts pixels in buckets of range values, so that only the neighbors close to the current pixel in range are visited.
  *
  * For more information on mean shift techniques, one might consider reading the following article:
  *
@@ -541,12 +498,25 @@ public:
   itkSetMacro(ModeSearch, bool);
   itkGetConstReferenceMacro(ModeSearch, bool);
 
-#if 0
+  /** Toggle mode search across threads, which is disabled by default.
+   * When on, together with mode search, the path of a pixel is also stopped
+   * when it crosses a pixel already assigned to a mode by another thread.
+   * The result then depends on the scheduling of the threads.
+   */
+  itkSetMacro(GlobalModeSearch, bool);
+  itkGetConstReferenceMacro(GlobalModeSearch, bool);
+
   /** Toggle bucket optimization, which is disabled by default.
+   * When on, pixels are sorted in buckets of range values, one range
+   * component being chosen so that the buckets are as selective as possible.
+   * Only the neighbors in the buckets adjacent to the current range value
+   * are visited when computing the mean shift vector, in the same order as
+   * without buckets. The result is unchanged for a kernel with a compact
+   * support (KernelUniform), whereas the range is truncated to the kernel
+   * radius with KernelGaussian.
    */
   itkSetMacro(BucketOptimization, bool);
   itkGetConstReferenceMacro(BucketOptimization, bool);
-#endif
 
   /** Global shift allows tackling down numerical instabilities by
   aligning pixel indices when performing tile processing */
@@ -612,9 +582,45 @@ protected:
                                         const RealVector& jointPixel, const OutputRegionType& outputRegion,
                                         const RealVector& bandwidth,
                                         RealVector& meanShiftVector);
-#if 0
-  virtual void CalculateMeanShiftVectorBucket(const RealVector& jointPixel, RealVector& meanShiftVector);
-#endif
+
+  /** Computes the mean shift vector visiting only the neighbors in the
+   * range buckets adjacent to the current pixel value */
+  virtual void CalculateMeanShiftVectorBucket(const RealVector& jointPixel, const OutputRegionType& outputRegion,
+                                              const RealVector& bandwidth, RealVector& meanShiftVector);
+
+  /** Returns the neighborhood of a pixel of the joint spatial-range domain,
+   * restricted to the given region */
+  RegionType GetNeighborhoodRegion(const RealVector& jointPixel, const OutputRegionType& outputRegion) const;
+
+  /** Accumulates the contribution of a neighbor to the mean shift vector */
+  inline void AccumulateNeighbor(const RealType * jointNeighbor, const RealType * jointPixel,
+                                 const RealType * bandwidth, RealType * shifts, RealType * meanShiftVector,
+                                 RealType & weightSum) const
+  {
+    const unsigned int jointDimension = ImageDimension + m_NumberOfComponentsPerPixel;
+
+    // Compute the squared norm of the difference
+    // This is the L2 norm, TODO: replace by the templated norm
+    RealType norm2 = 0;
+    for (unsigned int comp = 0; comp < jointDimension; comp++)
+      {
+      shifts[comp] = jointNeighbor[comp] - jointPixel[comp];
+      const RealType d = shifts[comp] / bandwidth[comp];
+      norm2 += d * d;
+      }
+
+    // Compute pixel weight from kernel
+    const RealType weight = m_Kernel(norm2);
+
+    // Update sum of weights
+    weightSum += weight;
+
+    // Update mean shift vector
+    for (unsigned int comp = 0; comp < jointDimension; comp++)
+      {
+      meanShiftVector[comp] += weight * shifts[comp];
+      }
+  }
 
 private:
   MeanShiftSmoothingImageFilter(const Self &) = delete;
@@ -648,21 +654,24 @@ private:
   /** Input data in the joint spatial-range domain, scaled by the bandwidths */
   typename RealVectorImageType::Pointer m_JointImage;
 
-  /** Image to store the status at each pixel:
+  /** Status at each pixel of the input requested region:
    * 0 : no mode has been found yet
    * 1 : a mode has been assigned to this pixel
    * 2 : pixel is in the path of the currently processed pixel and a mode will
    *     be assigned to it
+   * The status is atomic, so that threads can read the modes assigned by the
+   * other threads.
    */
-  typename ModeTableImageType::Pointer m_ModeTable;
+  std::unique_ptr<std::atomic<unsigned char>[]> m_ModeTable;
 
   /** Boolean to enable mode search  */
   bool m_ModeSearch;
 
-#if 0
+  /** Boolean to enable mode search across threads */
+  bool m_GlobalModeSearch;
+
   /** Boolean to enable bucket optimization */
   bool m_BucketOptimization;
-#endif
 
   /** Mode counters (local to each thread) */
   itk::VariableLengthVector<LabelType> m_NumLabels;
@@ -670,10 +679,11 @@ private:
    of labels */
   unsigned int m_ThreadIdNumberOfBits;
 
-#if 0
   typedef Meanshift::BucketImage<RealVectorImageType> BucketImageType;
   BucketImageType m_BucketImage;
-#endif
+
+  /** True if buckets are used for the current update */
+  bool m_UseBuckets;
 
   InputIndexType m_GlobalShift;
 
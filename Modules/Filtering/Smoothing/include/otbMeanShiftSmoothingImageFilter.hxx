@@ -42,10 +42,10 @@ MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterati
       // , m_JointImage(0)
       // , m_ModeTable(0)
       , m_ModeSearch(false)
-      , m_ThreadIdNumberOfBits(0)
-#if 0
+      , m_GlobalModeSearch(false)
       , m_BucketOptimization(false)
-#endif
+      , m_ThreadIdNumberOfBits(0)
+      , m_UseBuckets(false)
 {
   this->SetNumberOfRequiredOutputs(4);
   this->SetNthOutput(0, OutputImageType::New());
@@ -257,17 +257,62 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
   jointImageFunctor->Update();
   m_JointImage = jointImageFunctor->GetOutput();
 
-#if 0
+  m_UseBuckets = false;
   if (m_BucketOptimization)
     {
-    // Create bucket image
-    // Note: because values in the input m_JointImage are normalized, the
-    // rangeRadius argument is just 1
-    m_BucketImage = BucketImageType(static_cast<typename RealVectorImageType::ConstPointer> (m_JointImage),
-                                    m_JointImage->GetRequestedRegion(), m_Kernel.GetRadius(m_SpatialBandwidth), 1,
-                                    ImageDimension);
+    // Range of each component, to find the component giving the most
+    // selective buckets
+    const unsigned int jointDimension = ImageDimension + m_NumberOfComponentsPerPixel;
+    const size_t numberOfPixels = m_JointImage->GetBufferedRegion().GetNumberOfPixels();
+    const RealType * buffer = m_JointImage->GetBufferPointer();
+
+    std::vector<RealType> minValues(m_NumberOfComponentsPerPixel, itk::NumericTraits<RealType>::max());
+    std::vector<RealType> maxValues(m_NumberOfComponentsPerPixel, itk::NumericTraits<RealType>::NonpositiveMin());
+    // Non-finite values spread over the mean shift vectors of their whole
+    // neighborhood: buckets, which skip them, are not used in this case
+    bool allFinite = true;
+    for (size_t i = 0; i < numberOfPixels && allFinite; ++i)
+      {
+      const RealType * jointPixel = buffer + i * jointDimension + ImageDimension;
+      for (unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel; ++comp)
+        {
+        allFinite = allFinite && std::isfinite(jointPixel[comp]);
+        minValues[comp] = std::min(minValues[comp], jointPixel[comp]);
+        maxValues[comp] = std::max(maxValues[comp], jointPixel[comp]);
+        }
+      }
+
+    unsigned int bestComponent = m_NumberOfComponentsPerPixel;
+    RealType bestNumberOfBuckets = 0;
+    RealType bestBucketWidth = 0;
+    for (unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel && allFinite; ++comp)
+      {
+      // Neighbors with a non-zero weight are closer than the kernel radius
+      // for the largest range bandwidth of the component
+      const RealType bucketWidth = m_Kernel.GetRadius(std::max(m_RangeBandwidthRamp * minValues[comp],
+                                                               m_RangeBandwidthRamp * maxValues[comp])
+                                                      + m_RangeBandwidth);
+      if (!(bucketWidth > 0) || !std::isfinite(bucketWidth))
+        {
+        continue;
+        }
+      const RealType numberOfBuckets = (maxValues[comp] - minValues[comp]) / bucketWidth;
+      if (bestComponent == m_NumberOfComponentsPerPixel || numberOfBuckets > bestNumberOfBuckets)
+        {
+        bestComponent = comp;
+        bestNumberOfBuckets = numberOfBuckets;
+        bestBucketWidth = bucketWidth;
+        }
+      }
+
+    if (bestComponent < m_NumberOfComponentsPerPixel)
+      {
+      m_BucketImage.Initialize(m_JointImage, ImageDimension + bestComponent, minValues[bestComponent],
+                               maxValues[bestComponent], bestBucketWidth);
+      m_UseBuckets = true;
+      }
     }
-#endif
+
   /*
    // Allocate the joint domain image
    m_JointImage = RealVectorImageType::New();
@@ -303,18 +348,20 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
    }
    */
 
-  //TODO don't create mode table iterator when ModeSearch is set to false
-  m_ModeTable = ModeTableImageType::New();
-  m_ModeTable->SetRegions(inputPtr->GetRequestedRegion());
-  m_ModeTable->Allocate();
-  m_ModeTable->FillBuffer(0);
+  m_ModeTable.reset();
 
   if (m_ModeSearch)
     {
-    // Image to store the status at each pixel:
+    // Status at each pixel, on the same region as the joint image:
     // 0 : no mode has been found yet
     // 1 : a mode has been assigned to this pixel
     // 2 : a mode will be assigned to this pixel
+    const size_t numberOfPixels = m_JointImage->GetBufferedRegion().GetNumberOfPixels();
+    m_ModeTable.reset(new std::atomic<unsigned char>[numberOfPixels]);
+    for (size_t i = 0; i < numberOfPixels; ++i)
+      {
+      m_ModeTable[i].store(0, std::memory_order_relaxed);
+      }
 
 
     // Initialize counters for mode (also used for mode labeling)
@@ -341,24 +388,17 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
 
 }
 
-// Calculates the mean shift vector at the position given by jointPixel
+// Calculates the neighborhood of the position given by jointPixel
 template<class TInputImage, class TOutputImage, class TKernel, class TOutputIterationImage>
-void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>::CalculateMeanShiftVector(
-                                                                                                                        const typename RealVectorImageType::Pointer jointImage,
-                                                                                                                        const RealVector& jointPixel,
-                                                                                                                        const OutputRegionType& outputRegion,
-                                                                                                                        const RealVector & bandwidth,
-                                                                                                                        RealVector& meanShiftVector)
+typename MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>::RegionType
+MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>::GetNeighborhoodRegion(
+                                                                                                             const RealVector& jointPixel,
+                                                                                                             const OutputRegionType& outputRegion) const
 {
-  const unsigned int jointDimension = ImageDimension + m_NumberOfComponentsPerPixel;
-
   InputIndexType inputIndex;
   InputIndexType regionIndex;
   InputSizeType regionSize;
 
-  assert(meanShiftVector.GetSize() == jointDimension);
-  meanShiftVector.Fill(0);
-
   // Calculates current pixel neighborhood region, restricted to the output image region
   for (unsigned int comp = 0; comp < ImageDimension; ++comp)
     {
@@ -377,6 +417,24 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
   RegionType neighborhoodRegion;
   neighborhoodRegion.SetIndex(regionIndex);
   neighborhoodRegion.SetSize(regionSize);
+  return neighborhoodRegion;
+}
+
+// Calculates the mean shift vector at the position given by jointPixel
+template<class TInputImage, class TOutputImage, class TKernel, class TOutputIterationImage>
+void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>::CalculateMeanShiftVector(
+                                                                                                                        const typename RealVectorImageType::Pointer jointImage,
+                                                                                                                        const RealVector& jointPixel,
+                                                                                                                        const OutputRegionType& outputRegion,
+                                                                                                                        const RealVector & bandwidth,
+                                                                                                                        RealVector& meanShiftVector)
+{
+  const unsigned int jointDimension = ImageDimension + m_NumberOfComponentsPerPixel;
+
+  assert(meanShiftVector.GetSize() == jointDimension);
+  meanShiftVector.Fill(0);
+
+  const RegionType neighborhoodRegion = this->GetNeighborhoodRegion(jointPixel, outputRegion);
 
   RealType weightSum = 0;
   RealVector shifts(jointDimension);
@@ -384,65 +442,12 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
   // An iterator on the neighborhood of the current pixel (in joint
   // spatial-range domain)
   otb::Meanshift::FastImageRegionConstIterator<RealVectorImageType> it(jointImage, neighborhoodRegion);
-  //itk::ImageRegionConstIterator<RealVectorImageType> it(jointImage, neighborhoodRegion);
 
   it.GoToBegin();
   while (!it.IsAtEnd())
     {
-    const RealType *jointNeighbor = it.GetPixelPointer();
-
-    // Compute the squared norm of the difference
-    // This is the L2 norm, TODO: replace by the templated norm
-    RealType norm2 = 0;
-    for (unsigned int comp = 0; comp < jointDimension; comp++)
-      {
-      shifts[comp] = jointNeighbor[comp] - jointPixel[comp];
-      double d = shifts[comp] / bandwidth[comp];
-      norm2 += d*d;
-      }
-
-    // Compute pixel weight from kernel
-    const RealType weight = m_Kernel(norm2);
-    /*
-     // The following code is an alternative way to compute norm2 and weight
-     // It separates the norms of spatial and range elements
-     RealType spatialNorm2;
-     RealType rangeNorm2;
-     spatialNorm2 = 0;
-     for (unsigned int comp = 0; comp < ImageDimension; comp++)
-     {
-     RealType d;
-     d = jointNeighbor[comp] - jointPixel[comp];
-     spatialNorm2 += d*d;
-     }
-
-     if(spatialNorm2 >= 1.0)
-     {
-     weight = 0;
-     }
-     else
-     {
-     rangeNorm2 = 0;
-     for (unsigned int comp = 0; comp < m_NumberOfComponentsPerPixel; comp++)
-     {
-     RealType d;
-     d = jointNeighbor[ImageDimension + comp] - jointPixel[ImageDimension + comp];
-     rangeNorm2 += d*d;
-     }
-
-     weight = (rangeNorm2 <= 1.0)? 1.0 : 0.0;
-     }
-     */
-
-    // Update sum of weights
-    weightSum += weight;
-
-    // Update mean shift vector
-    for (unsigned int comp = 0; comp < jointDimension; comp++)
-      {
-      meanShiftVector[comp] += weight * shifts[comp];
-      }
-
+    this->AccumulateNeighbor(it.GetPixelPointer(), jointPixel.GetDataPointer(), bandwidth.GetDataPointer(),
+                             shifts.GetDataPointer(), meanShiftVector.GetDataPointer(), weightSum);
     ++it;
     }
 
@@ -455,69 +460,105 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
     }
 }
 
-#if 0
-// Calculates the mean shift vector at the position given by jointPixel
+// Calculates the mean shift vector at the position given by jointPixel,
+// visiting only the neighbors in the range buckets around jointPixel
 template<class TInputImage, class TOutputImage, class TKernel, class TOutputIterationImage>
 void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>::CalculateMeanShiftVectorBucket(
                                                                                                                               const RealVector& jointPixel,
+                                                                                                                              const OutputRegionType& outputRegion,
+                                                                                                                              const RealVector& bandwidth,
                                                                                                                               RealVector& meanShiftVector)
 {
   const unsigned int jointDimension = ImageDimension + m_NumberOfComponentsPerPixel;
 
-  RealType weightSum = 0;
-
-  for (unsigned int comp = 0; comp < jointDimension; comp++)
+  const RealType value = jointPixel[m_BucketImage.GetComponent()];
+  if (!std::isfinite(value))
     {
-    meanShiftVector[comp] = 0;
+    this->CalculateMeanShiftVector(m_JointImage, jointPixel, outputRegion, bandwidth, meanShiftVector);
+    return;
     }
 
-  RealVector jointNeighbor(ImageDimension + m_NumberOfComponentsPerPixel);
+  assert(meanShiftVector.GetSize() == jointDimension);
+  meanShiftVector.Fill(0);
 
-  InputIndexType index;
-  for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+  const RegionType neighborhoodRegion = this->GetNeighborhoodRegion(jointPixel, outputRegion);
+  const size_t numberOfPixels = neighborhoodRegion.GetNumberOfPixels();
+
+  // Neighbors with a non-zero weight are in the adjacent buckets
+  const long bucket = m_BucketImage.GetBucket(value);
+  const long firstBucket = std::max(0l, bucket - 1);
+  const long lastBucket = std::min(static_cast<long>(m_BucketImage.GetNumberOfBuckets()) - 1, bucket + 1);
+  if (numberOfPixels == 0 || firstBucket > lastBucket)
     {
-    index[dim] = jointPixel[dim] * m_SpatialBandwidth + 0.5;
+    return;
     }
 
-  const std::vector<unsigned int>
-      neighborBuckets = m_BucketImage.GetNeighborhoodBucketListIndices(
-                                                                       m_BucketImage.BucketIndexToBucketListIndex(
-                                                                                                                  m_BucketImage.GetBucketIndex(
-                                                                                                                                               jointPixel,
-                                                                                                                                               index)));
+  typedef typename BucketImageType::ColumnType ColumnType;
+
+  const RegionType & bufferedRegion = m_BucketImage.GetRegion();
+  const ColumnType firstColumn = neighborhoodRegion.GetIndex(0) - bufferedRegion.GetIndex(0);
+  const ColumnType endColumn = firstColumn + neighborhoodRegion.GetSize(0);
+  const size_t numberOfLines = numberOfPixels / neighborhoodRegion.GetSize(0);
+
+  const RealType * buffer = m_JointImage->GetBufferPointer();
+  const RealType * jointPixelPtr = jointPixel.GetDataPointer();
+  const RealType * bandwidthPtr = bandwidth.GetDataPointer();
+  RealType * meanShiftVectorPtr = meanShiftVector.GetDataPointer();
+
+  RealType weightSum = 0;
+  RealVector shifts(jointDimension);
+
+  const ColumnType * begin[3];
+  const ColumnType * end[3];
+  const unsigned int numberOfBuckets = lastBucket - firstBucket + 1;
 
-  unsigned int numNeighbors = m_BucketImage.GetNumberOfNeighborBuckets();
-  for (unsigned int neighborIndex = 0; neighborIndex < numNeighbors; ++neighborIndex)
+  InputIndexType lineIndex = neighborhoodRegion.GetIndex();
+  for (size_t line = 0; line < numberOfLines; ++line)
     {
-    const typename BucketImageType::BucketType & bucket = m_BucketImage.GetBucket(neighborBuckets[neighborIndex]);
-    if (bucket.empty()) continue;
-    typename BucketImageType::BucketType::const_iterator it = bucket.begin();
-    while (it != bucket.end())
+    // Columns of the neighbors of this line, in each bucket
+    const size_t bucketLine = m_BucketImage.GetLine(lineIndex);
+    for (unsigned int b = 0; b < numberOfBuckets; ++b)
       {
-      jointNeighbor.SetData(const_cast<RealType*> (*it));
+      m_BucketImage.GetColumns(bucketLine, static_cast<unsigned int>(firstBucket + b), begin[b], end[b]);
+      begin[b] = std::lower_bound(begin[b], end[b], firstColumn);
+      }
 
-      // Compute the squared norm of the difference
-      // This is the L2 norm, TODO: replace by the templated norm
-      RealType norm2 = 0;
-      for (unsigned int comp = 0; comp < jointDimension; comp++)
+    // First pixel of the line in the buffer
+    InputIndexType lineStart = lineIndex;
+    lineStart[0] = bufferedRegion.GetIndex(0);
+    const RealType * lineBuffer = buffer + m_JointImage->ComputeOffset(lineStart) * jointDimension;
+
+    // Merge the sorted columns of the buckets, so that neighbors are visited
+    // in the same order as with a region iterator
+    while (true)
+      {
+      unsigned int next = numberOfBuckets;
+      for (unsigned int b = 0; b < numberOfBuckets; ++b)
         {
-        const RealType d = jointNeighbor[comp] - jointPixel[comp];
-        norm2 += d * d;
+        if (begin[b] != end[b] && *begin[b] < endColumn && (next == numberOfBuckets || *begin[b] < *begin[next]))
+          {
+          next = b;
+          }
+        }
+      if (next == numberOfBuckets)
+        {
+        break;
         }
 
-      // Compute pixel weight from kernel
-      const RealType weight = m_Kernel(norm2);
-
-      // Update sum of weights
-      weightSum += weight;
+      this->AccumulateNeighbor(lineBuffer + *begin[next] * jointDimension, jointPixelPtr, bandwidthPtr,
+                               shifts.GetDataPointer(), meanShiftVectorPtr, weightSum);
+      ++begin[next];
+      }
 
-      // Update mean shift vector
-      for (unsigned int comp = 0; comp < jointDimension; comp++)
+    // Next line of the neighborhood
+    for (unsigned int dim = 1; dim < ImageDimension; ++dim)
+      {
+      ++lineIndex[dim];
+      if (lineIndex[dim] < neighborhoodRegion.GetIndex(dim) + static_cast<InputIndexValueType>(neighborhoodRegion.GetSize(dim)))
         {
-        meanShiftVector[comp] += weight * jointNeighbor[comp];
+        break;
         }
-
-      ++it;
+      lineIndex[dim] = neighborhoodRegion.GetIndex(dim);
       }
     }
 
@@ -525,11 +566,10 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
     {
     for (unsigned int comp = 0; comp < jointDimension; comp++)
       {
-      meanShiftVector[comp] = meanShiftVector[comp] / weightSum - jointPixel[comp];
+      meanShiftVector[comp] = meanShiftVector[comp] / weightSum;
       }
     }
 }
-#endif
 
 template<class TInputImage, class TOutputImage, class TKernel, class TOutputIterationImage>
 void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>
@@ -567,6 +607,7 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
   RegionType const& requestedRegion = input->GetRequestedRegion();
+  OutputRegionType const& outputRequestedRegion = rangeOutput->GetRequestedRegion();
 
   typedef itk::ImageRegionConstIteratorWithIndex<RealVectorImageType> JointImageIteratorType;
   JointImageIteratorType jointIt(m_JointImage, outputRegionForThread);
@@ -576,14 +617,11 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
   OutputIterationIteratorType iterationIt(iterationOutput, outputRegionForThread);
   OutputLabelIteratorType labelIt(labelOutput, outputRegionForThread);
 
-  typedef itk::ImageRegionIterator<ModeTableImageType> ModeTableImageIteratorType;
-  ModeTableImageIteratorType modeTableIt(m_ModeTable, outputRegionForThread);
 
   jointIt.GoToBegin();
   rangeIt.GoToBegin();
   spatialIt.GoToBegin();
   iterationIt.GoToBegin();
-  modeTableIt.GoToBegin();
   labelIt.GoToBegin();
 
   unsigned int iteration = 0;
@@ -601,12 +639,15 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
   // index of the current pixel updated during the mean shift loop
   InputIndexType modeCandidate;
 
-  for (; !jointIt.IsAtEnd(); ++jointIt, ++rangeIt, ++spatialIt, ++iterationIt, ++modeTableIt, ++labelIt, progress.CompletedPixel())
+  for (; !jointIt.IsAtEnd(); ++jointIt, ++rangeIt, ++spatialIt, ++iterationIt, ++labelIt, progress.CompletedPixel())
     {
 
+    // index of the currently processed output pixel
+    InputIndexType currentIndex = jointIt.GetIndex();
+    const typename RealVectorImageType::OffsetValueType currentOffset = m_JointImage->ComputeOffset(currentIndex);
+
     // if pixel has been already processed (by mode search optimization), skip
-    typename ModeTableImageType::InternalPixelType const& currentPixelMode = modeTableIt.Get();
-    if (m_ModeSearch && currentPixelMode == 1)
+    if (m_ModeSearch && m_ModeTable[currentOffset].load(std::memory_order_relaxed) == 1)
       {
       numBreaks++;
       continue;
@@ -623,9 +664,6 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
     for (unsigned int comp = ImageDimension; comp < jointDimension; comp++)
       bandwidth[comp] = m_RangeBandwidthRamp*jointPixel[comp]+m_RangeBandwidth;
 
-    // index of the currently processed output pixel
-    InputIndexType currentIndex = jointIt.GetIndex();
-
     // Number of points currently in the pointList
     unsigned int pointCount = 0; // Note: used only in mode search optimization
     iteration = 0;
@@ -644,9 +682,18 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
         // If pixel candidate has status 0 (no mode assigned) or 1 (mode assigned)
         // but not 2 (pixel in current search path), and pixel has actually moved
         // from its initial position, and pixel candidate is inside the output
-        // region, then perform optimization tasks
-        if (modeCandidate != currentIndex && m_ModeTable->GetPixel(modeCandidate) != 2
-            && outputRegionForThread.IsInside(modeCandidate))
+        // region, then perform optimization tasks. Pixels of the other threads
+        // are only considered with global mode search, once assigned (status 1).
+        const bool candidateInThreadRegion = outputRegionForThread.IsInside(modeCandidate);
+        unsigned char candidateStatus = 2;
+        if (modeCandidate != currentIndex
+            && (candidateInThreadRegion || (m_GlobalModeSearch && outputRequestedRegion.IsInside(modeCandidate))))
+          {
+          // Acquire, so that the outputs of a pixel assigned by another thread
+          // are visible
+          candidateStatus = m_ModeTable[m_JointImage->ComputeOffset(modeCandidate)].load(std::memory_order_acquire);
+          }
+        if (candidateStatus == 1 || (candidateStatus == 0 && candidateInThreadRegion))
           {
           // Obtain the data point to see if it close to jointPixel
           RealType diff = 0;
@@ -661,12 +708,12 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
             {
             // If no mode has been associated to the candidate pixel then
             // associate it to the upcoming mode
-            if (m_ModeTable->GetPixel(modeCandidate) == 0)
+            if (candidateStatus == 0)
               {
               // Add the candidate to the list of pixels that will be assigned the
               // finally calculated mode value
               pointList[pointCount++] = modeCandidate;
-              m_ModeTable->SetPixel(modeCandidate, 2);
+              m_ModeTable[m_JointImage->ComputeOffset(modeCandidate)].store(2, std::memory_order_relaxed);
               }
             else // == 1
               {
@@ -678,7 +725,7 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
                 jointPixel[ImageDimension + comp] = rangePixel[comp];
                 }
               // Update the mode table because pixel will be assigned just now
-              modeTableIt.Set(2); // m_ModeTable->SetPixel(currentIndex, 2);
+              m_ModeTable[currentOffset].store(2, std::memory_order_relaxed);
               // bypass further calculation
               numBreaks++;
               break;
@@ -689,19 +736,14 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
         } // end if (m_ModeSearch)
 
       //Calculate meanShiftVector
-#if 0
-      if (m_BucketOptimization)
+      if (m_UseBuckets)
         {
-        this->CalculateMeanShiftVectorBucket(jointPixel, meanShiftVector);
+        this->CalculateMeanShiftVectorBucket(jointPixel, requestedRegion, bandwidth, meanShiftVector);
         }
       else
         {
-#endif
         this->CalculateMeanShiftVector(m_JointImage, jointPixel, requestedRegion, bandwidth, meanShiftVector);
-
-#if 0
         }
-#endif
 
       // Compute mean shift vector squared norm (not normalized by bandwidth)
       // and add mean shift vector to current joint pixel
@@ -736,9 +778,6 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
 
     if (m_ModeSearch)
       {
-      // Update the mode table now that the current pixel has been assigned
-      modeTableIt.Set(1); // m_ModeTable->SetPixel(currentIndex, 1);
-
       // If the loop exited with hasConverged or too many iterations, then we have a new mode
       LabelType label;
       if (hasConverged || iteration == m_MaxIterationNumber)
@@ -752,12 +791,17 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
         }
       labelIt.Set(label);
 
+      // Update the mode table now that the current pixel has been assigned.
+      // Release, so that the outputs are visible to the other threads before
+      // the status.
+      m_ModeTable[currentOffset].store(1, std::memory_order_release);
+
       // Also assign all points in the list to the same mode
       for (unsigned int i = 0; i < pointCount; i++)
         {
         rangeOutput->SetPixel(pointList[i], rangePixel);
-        m_ModeTable->SetPixel(pointList[i], 1);
         labelOutput->SetPixel(pointList[i], label);
+        m_ModeTable[m_JointImage->ComputeOffset(pointList[i])].store(1, std::memory_order_release);
         }
       }
     else // if ModeSearch is not set LabelOutput can't be generated
@@ -774,6 +818,8 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
 template<class TInputImage, class TOutputImage, class TKernel, class TOutputIterationImage>
 void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIterationImage>::AfterThreadedGenerateData()
 {
+  m_BucketImage.Clear();
+
   typename OutputLabelImageType::Pointer labelOutput = this->GetLabelOutput();
   typedef itk::ImageRegionIterator<OutputLabelImageType> OutputLabelIteratorType;
   OutputLabelIteratorType labelIt(labelOutput, labelOutput->GetRequestedRegion());
@@ -827,6 +873,9 @@ void MeanShiftSmoothingImageFilter<TInputImage, TOutputImage, TKernel, TOutputIt
   Superclass::PrintSelf(os, indent);
   os << indent << "Spatial bandwidth: " << m_SpatialBandwidth << std::endl;
   os << indent << "Range bandwidth: " << m_RangeBandwidth << std::endl;
+  os << indent << "Mode search: " << m_ModeSearch << std::endl;
+  os << indent << "Global mode search: " << m_GlobalModeSearch << std::endl;
+  os << indent << "Bucket optimization: " << m_BucketOptimization << std::endl;
 }
 
 } // end namespace otb
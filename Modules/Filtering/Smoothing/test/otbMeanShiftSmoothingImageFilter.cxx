@@ -25,10 +25,10 @@
 
 int otbMeanShiftSmoothingImageFilter(int argc, char * argv[])
 {
-  if (argc != 10 && argc != 11)
+  if (argc < 10 || argc > 13)
     {
     std::cerr << "Usage: " << argv[0] <<
-    " infname spatialfname spectralfname iterationfname labelfname spatialBandwidth rangeBandwidth threshold maxiterationnumber (usemodesearch)"
+    " infname spatialfname spectralfname iterationfname labelfname spatialBandwidth rangeBandwidth threshold maxiterationnumber (usemodesearch) (usebucket) (useglobalmodesearch)"
               << std::endl;
     return EXIT_FAILURE;
     }
@@ -43,10 +43,20 @@ int otbMeanShiftSmoothingImageFilter(int argc, char * argv[])
   const double       threshold                 = atof(argv[8]);
   const unsigned int maxiterationnumber        = atoi(argv[9]);
   bool               usemodesearch                 = true;
-  if(argc==11)
+  if(argc>=11)
     {
       usemodesearch        = atoi(argv[10])!=0;
     }
+  bool               usebucket                 = false;
+  if(argc>=12)
+    {
+      usebucket            = atoi(argv[11])!=0;
+    }
+  bool               useglobalmodesearch       = false;
+  if(argc>=13)
+    {
+      useglobalmodesearch  = atoi(argv[12])!=0;
+    }
 
   /* maxit - threshold */
 
@@ -76,6 +86,8 @@ int otbMeanShiftSmoothingImageFilter(int argc, char * argv[])
   filter->SetMaxIterationNumber(maxiterationnumber);
   filter->SetInput(reader->GetOutput());
   filter->SetModeSearch(usemodesearch);
+  filter->SetBucketOptimization(usebucket);
+  filter->SetGlobalModeSearch(useglobalmodesearch);
   //filter->SetNumberOfThreads(1);
   SpatialWriterType::Pointer writer1 = SpatialWriterType::New();
   WriterType::Pointer writer2 = WriterType::New();
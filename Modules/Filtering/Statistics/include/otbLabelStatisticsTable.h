@@ -0,0 +1,374 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbLabelStatisticsTable_h
+#define otbLabelStatisticsTable_h
+
+#include "otbQuantileSketch.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace otb
+{
+
+/** \class LabelStatisticsTable
+ *
+ * \brief Compact storage of per-label statistics of a multiband image
+ *
+ * The statistics of all the labels are stored in flat arrays, one slot
+ * per label: population, number of valid values, sum and sum of squares,
+ * minimum and maximum of each band, and optionally a QuantileSketch per
+ * band to estimate the median. Labels are found with an open addressing
+ * hash table with linear probing, so that there is no allocation per
+ * label.
+ *
+ * Labels of a compact range can be stored in a dense part instead: slots
+ * are then allocated beforehand and found without hashing. In order to
+ * split the labels between several tables (see
+ * PersistentStreamingStatisticsMapFromLabelImageFilter), the dense part
+ * only holds the labels min + phase + k * stride of the range
+ * [min, max]. Labels outside of the dense part go to the hash table.
+ * Dense ranges are only supported for integer labels.
+ *
+ * \ingroup OTBStatistics
+ */
+template <class TLabel>
+class LabelStatisticsTable
+{
+public:
+  typedef TLabel   LabelType;
+  typedef uint64_t CountType;
+
+  /** Slot index of a label absent from the table */
+  static const size_t NoSlot = static_cast<size_t>(-1);
+
+  LabelStatisticsTable()
+    : m_NumberOfBands(0),
+      m_ComputeMedian(false),
+      m_MedianSketchSize(32),
+      m_NumberOfLabels(0),
+      m_DenseMinimum(),
+      m_DenseSize(0),
+      m_DenseStride(1),
+      m_DensePhase(0),
+      m_Mask(0),
+      m_NumberOfHashedLabels(0)
+  {
+  }
+
+  /** Clear the table, and set the number of bands and the statistics */
+  void Initialize(unsigned int nbBands, bool computeMedian, unsigned int medianSketchSize)
+  {
+    m_NumberOfBands = nbBands;
+    m_ComputeMedian = computeMedian;
+    m_MedianSketchSize = medianSketchSize;
+    m_DenseSize = 0;
+    this->Clear();
+  }
+
+  /** Preallocate the slots of the labels minimum + phase + k * stride up
+   *  to maximum. Must be called after Initialize(). */
+  void SetDenseRange(LabelType minimum, LabelType maximum, unsigned int stride, unsigned int phase)
+  {
+    m_DenseMinimum = minimum;
+    m_DenseStride = stride;
+    m_DensePhase = phase;
+    const unsigned long long range = static_cast<unsigned long long>(maximum - minimum) + 1;
+    m_DenseSize = range > phase ? (range - phase + stride - 1) / stride : 0;
+    this->Clear();
+  }
+
+  /** Remove all the labels, keeping the dense range */
+  void Clear()
+  {
+    m_NumberOfLabels = 0;
+    m_Labels.clear();
+    m_Population.clear();
+    m_BandCount.clear();
+    m_Sum.clear();
+    m_SqSum.clear();
+    m_Min.clear();
+    m_Max.clear();
+    m_Sketches.clear();
+    m_HashLabels.clear();
+    m_HashSlots.clear();
+    m_Mask = 0;
+    m_NumberOfHashedLabels = 0;
+
+    for (size_t i = 0; i < m_DenseSize; ++i)
+      {
+      this->AddSlot(m_DenseMinimum + static_cast<LabelType>(m_DensePhase + i * m_DenseStride));
+      }
+  }
+
+  /** Slot of a label, created if needed */
+  size_t FindOrInsert(LabelType label)
+  {
+    const size_t dense = this->GetDenseIndex(label);
+    if (dense != NoSlot)
+      {
+      return dense;
+      }
+
+    if (2 * (m_NumberOfHashedLabels + 1) > m_HashSlots.size())
+      {
+      this->Rehash(m_HashSlots.empty() ? 1024 : 2 * m_HashSlots.size());
+      }
+
+    size_t pos = Hash(label) & m_Mask;
+    while (m_HashSlots[pos] != NoSlot)
+      {
+      if (m_HashLabels[pos] == label)
+        {
+        return m_HashSlots[pos];
+        }
+      pos = (pos + 1) & m_Mask;
+      }
+
+    const size_t slot = m_Labels.size();
+    m_HashLabels[pos] = label;
+    m_HashSlots[pos] = slot;
+    ++m_NumberOfHashedLabels;
+    this->AddSlot(label);
+    return slot;
+  }
+
+  /** Slot of a label, NoSlot if it is absent */
+  size_t Find(LabelType label) const
+  {
+    const size_t dense = this->GetDenseIndex(label);
+    if (dense != NoSlot)
+      {
+      return m_Population[dense] > 0 ? dense : NoSlot;
+      }
+    if (m_HashSlots.empty())
+      {
+      return NoSlot;
+      }
+    size_t pos = Hash(label) & m_Mask;
+    while (m_HashSlots[pos] != NoSlot)
+      {
+      if (m_HashLabels[pos] == label)
+        {
+        return m_HashSlots[pos];
+        }
+      pos = (pos + 1) & m_Mask;
+      }
+    return NoSlot;
+  }
+
+  /** Add a pixel of NumberOfBands values to a slot. Values equal to
+   *  noDataValue are not accumulated when useNoData is true, but the
+   *  pixel still counts in the population. */
+  template <class TValue>
+  void Update(size_t slot, const TValue * values, bool useNoData, double noDataValue)
+  {
+    if (m_Population[slot]++ == 0)
+      {
+      ++m_NumberOfLabels;
+      }
+    const size_t offset = slot * m_NumberOfBands;
+    for (unsigned int band = 0; band < m_NumberOfBands; ++band)
+      {
+      const double value = static_cast<double>(values[band]);
+      if (useNoData && value == noDataValue)
+        {
+        continue;
+        }
+      const size_t i = offset + band;
+      if (m_BandCount[i]++ == 0 || value < m_Min[i])
+        {
+        m_Min[i] = value;
+        }
+      if (value > m_Max[i] || m_BandCount[i] == 1)
+        {
+        m_Max[i] = value;
+        }
+      m_Sum[i] += value;
+      m_SqSum[i] += value * value;
+      if (m_ComputeMedian)
+        {
+        m_Sketches[i].Insert(value);
+        }
+      }
+  }
+
+  /** Number of slots, including the empty dense ones */
+  size_t GetNumberOfSlots() const
+  {
+    return m_Labels.size();
+  }
+
+  /** Number of labels with at least one pixel */
+  size_t GetNumberOfLabels() const
+  {
+    return m_NumberOfLabels;
+  }
+
+  unsigned int GetNumberOfBands() const
+  {
+    return m_NumberOfBands;
+  }
+
+  bool GetComputeMedian() const
+  {
+    return m_ComputeMedian;
+  }
+
+  /** Accessors to the statistics of a slot, and of a band of a slot */
+  LabelType GetLabel(size_t slot) const
+  {
+    return m_Labels[slot];
+  }
+
+  CountType GetPopulation(size_t slot) const
+  {
+    return m_Population[slot];
+  }
+
+  CountType GetBandCount(size_t slot, unsigned int band) const
+  {
+    return m_BandCount[slot * m_NumberOfBands + band];
+  }
+
+  double GetSum(size_t slot, unsigned int band) const
+  {
+    return m_Sum[slot * m_NumberOfBands + band];
+  }
+
+  double GetSqSum(size_t slot, unsigned int band) const
+  {
+    return m_SqSum[slot * m_NumberOfBands + band];
+  }
+
+  double GetMin(size_t slot, unsigned int band) const
+  {
+    return m_Min[slot * m_NumberOfBands + band];
+  }
+
+  double GetMax(size_t slot, unsigned int band) const
+  {
+    return m_Max[slot * m_NumberOfBands + band];
+  }
+
+  /** Only available when the median is computed */
+  const QuantileSketch & GetSketch(size_t slot, unsigned int band) const
+  {
+    return m_Sketches[slot * m_NumberOfBands + band];
+  }
+
+private:
+  static size_t Hash(LabelType label)
+  {
+    // Fibonacci hashing, so that consecutive labels are spread
+    const uint64_t h = static_cast<uint64_t>(std::hash<LabelType>()(label)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(h ^ (h >> 32));
+  }
+
+  size_t GetDenseIndex(LabelType label) const
+  {
+    if (m_DenseSize == 0 || label < m_DenseMinimum)
+      {
+      return NoSlot;
+      }
+    const unsigned long long delta = static_cast<unsigned long long>(label - m_DenseMinimum);
+    if (delta < m_DensePhase || (delta - m_DensePhase) % m_DenseStride != 0)
+      {
+      return NoSlot;
+      }
+    const unsigned long long index = (delta - m_DensePhase) / m_DenseStride;
+    return index < m_DenseSize ? static_cast<size_t>(index) : NoSlot;
+  }
+
+  void AddSlot(LabelType label)
+  {
+    m_Labels.push_back(label);
+    m_Population.push_back(0);
+    m_BandCount.resize(m_BandCount.size() + m_NumberOfBands, 0);
+    m_Sum.resize(m_Sum.size() + m_NumberOfBands, 0.);
+    m_SqSum.resize(m_SqSum.size() + m_NumberOfBands, 0.);
+    m_Min.resize(m_Min.size() + m_NumberOfBands, 0.);
+    m_Max.resize(m_Max.size() + m_NumberOfBands, 0.);
+    if (m_ComputeMedian)
+      {
+      m_Sketches.resize(m_Sketches.size() + m_NumberOfBands, QuantileSketch(m_MedianSketchSize));
+      }
+  }
+
+  void Rehash(size_t capacity)
+  {
+    std::vector<LabelType> labels(capacity);
+    std::vector<size_t>    slots(capacity, NoSlot);
+    const size_t mask = capacity - 1;
+    for (size_t i = 0; i < m_HashSlots.size(); ++i)
+      {
+      if (m_HashSlots[i] != NoSlot)
+        {
+        size_t pos = Hash(m_HashLabels[i]) & mask;
+        while (slots[pos] != NoSlot)
+          {
+          pos = (pos + 1) & mask;
+          }
+        labels[pos] = m_HashLabels[i];
+        slots[pos] = m_HashSlots[i];
+        }
+      }
+    m_HashLabels.swap(labels);
+    m_HashSlots.swap(slots);
+    m_Mask = mask;
+  }
+
+  unsigned int m_NumberOfBands;
+  bool         m_ComputeMedian;
+  unsigned int m_MedianSketchSize;
+  size_t       m_NumberOfLabels;
+
+  /** Statistics of the slots, band after band for the per band ones */
+  std::vector<LabelType>      m_Labels;
+  std::vector<CountType>      m_Population;
+  std::vector<CountType>      m_BandCount;
+  std::vector<double>         m_Sum;
+  std::vector<double>         m_SqSum;
+  std::vector<double>         m_Min;
+  std::vector<double>         m_Max;
+  std::vector<QuantileSketch> m_Sketches;
+
+  /** Dense part: the first m_DenseSize slots */
+  LabelType          m_DenseMinimum;
+  unsigned long long m_DenseSize;
+  unsigned int       m_DenseStride;
+  unsigned int       m_DensePhase;
+
+  /** Hash part, with a power of two capacity */
+  std::vector<LabelType> m_HashLabels;
+  std::vector<size_t>    m_HashSlots;
+  size_t                 m_Mask;
+  size_t                 m_NumberOfHashedLabels;
+};
+
+template <class TLabel>
+const size_t LabelStatisticsTable<TLabel>::NoSlot;
+
+} // end namespace otb
+
+#endif
@@ -47,16 +47,23 @@ public:
   typedef typename  itk::NumericTraits< typename RealVectorType::ValueType >::RealType RealType;
 
   TOutput operator() ( const TInput & input )
+  {
+    TOutput output ( input.Size() );
+    (*this)( output, input );
+    return output;
+  }
+
+  /** Computation in a pre-sized output pixel, used by the functor
+   *  filters so that no pixel is allocated per call. */
+  void operator() ( TOutput & output, const TInput & input )
   {
     unsigned int length = input.Size();
-    TOutput output ( length );
     for ( unsigned int i = 0; i < length; ++i )
     {
       output[i] = static_cast<typename TOutput::ValueType>(
                     ( static_cast< RealType >( input[i] ) - m_Mean[i] )
                       / m_StdDev[i] );
     }
-    return output;
   }
 
   template < class T >
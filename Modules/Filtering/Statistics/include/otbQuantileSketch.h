@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbQuantileSketch_h
+#define otbQuantileSketch_h
+
+#include "OTBStatisticsExport.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace otb
+{
+
+/** \class QuantileSketch
+ *
+ * \brief Mergeable summary of a stream of values for approximate quantiles
+ *
+ * This is a KLL sketch (Karnin, Lang and Liberty, "Optimal quantile
+ * approximation in streams", 2016): values are kept in a hierarchy of
+ * compactors, where a value of level h stands for 2^h values of the
+ * stream. When a compactor is full, it is sorted and one value out of two
+ * is promoted to the next level. The capacity of the compactors decreases
+ * geometrically from the top level, so that the memory is bounded by a
+ * few times K values whatever the length of the stream, and the rank
+ * error of the quantiles is of the order of 1/K.
+ *
+ * Sketches built on disjoint parts of a stream (one per thread or per
+ * streamed region for instance) can be merged: the result is a sketch of
+ * the whole stream with the same accuracy. The compaction offsets
+ * alternate instead of being random, so that the result only depends on
+ * the order of the values and of the merges.
+ *
+ * \ingroup OTBStatistics
+ */
+class OTBStatistics_EXPORT QuantileSketch
+{
+public:
+  /** K controls the accuracy and the memory of the sketch */
+  explicit QuantileSketch(unsigned int k = 200);
+
+  /** Add a value to the sketch */
+  void Insert(double value)
+  {
+    m_Levels[0].push_back(value);
+    ++m_Size;
+    ++m_Count;
+    if (m_Count == 1 || value < m_Minimum)
+      {
+      m_Minimum = value;
+      }
+    if (m_Count == 1 || value > m_Maximum)
+      {
+      m_Maximum = value;
+      }
+    if (m_Size >= m_MaximumSize)
+      {
+      this->Compress();
+      }
+  }
+
+  /** Merge the values summarized by another sketch into this one */
+  void Merge(const QuantileSketch & other);
+
+  /** Remove all the values */
+  void Clear();
+
+  /** Approximate quantile q (between 0 and 1) of the values. The minimum
+   *  and maximum values are exact. Returns 0 if the sketch is empty. */
+  double GetQuantile(double q) const;
+
+  /** Approximate quantiles of several q at once, faster than calling
+   *  GetQuantile() for each of them */
+  std::vector<double> GetQuantiles(const std::vector<double> & q) const;
+
+  /** Number of values inserted */
+  unsigned long long GetCount() const
+  {
+    return m_Count;
+  }
+
+  bool IsEmpty() const
+  {
+    return m_Count == 0;
+  }
+
+  double GetMinimum() const
+  {
+    return m_Minimum;
+  }
+
+  double GetMaximum() const
+  {
+    return m_Maximum;
+  }
+
+  unsigned int GetK() const
+  {
+    return m_K;
+  }
+
+  /** Number of values retained by the sketch */
+  size_t GetNumberOfRetainedValues() const
+  {
+    return m_Size;
+  }
+
+private:
+  /** Capacity of a compactor, depending on its depth below the top level */
+  size_t GetCapacity(unsigned int level) const;
+
+  /** Add a level on top of the hierarchy */
+  void Grow();
+
+  /** Compact the lowest full level */
+  void Compress();
+
+  unsigned int                      m_K;
+  unsigned long long                m_Count;
+  double                            m_Minimum;
+  double                            m_Maximum;
+  std::vector<std::vector<double> > m_Levels;
+  /** Offset of the next compaction of each level, 0 or 1 */
+  std::vector<unsigned char>        m_Offsets;
+  size_t                            m_Size;
+  size_t                            m_MaximumSize;
+};
+
+} // end namespace otb
+
+#endif
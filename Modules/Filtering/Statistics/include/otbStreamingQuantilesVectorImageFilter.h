@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingQuantilesVectorImageFilter_h
+#define otbStreamingQuantilesVectorImageFilter_h
+
+#include "otbPersistentImageFilter.h"
+#include "otbPersistentFilterStreamingDecorator.h"
+#include "otbQuantileSketch.h"
+#include "otbImage.h"
+#include "itkVariableLengthVector.h"
+
+#include <vector>
+
+namespace otb
+{
+
+/** \class PersistentStreamingQuantilesVectorImageFilter
+ * \brief Compute approximate quantiles of each band of a large image using streaming
+ *
+ * Each thread summarizes the values of each band in a QuantileSketch.
+ * The sketches persist along the streamed regions, and are merged by
+ * Synthetize(): quantiles are computed on the full resolution image in a
+ * single pass, with a memory bounded by the accuracy parameter K of the
+ * sketches, and without the binning of a histogram.
+ *
+ * An optional mask restricts the computation to the pixels where it is
+ * not null. Non-finite values are ignored, and so are the values equal to
+ * NoDataValue if NoDataFlag is set.
+ *
+ * To reset the temporary data, one should call the Reset() function.
+ *
+ * \sa QuantileSketch
+ * \sa PersistentImageFilter
+ * \ingroup Streamed
+ * \ingroup Multithreaded
+ * \ingroup MathematicalStatisticsImageFilters
+ *
+ * \ingroup OTBStatistics
+ */
+template<class TInputImage, class TMaskImage = otb::Image<unsigned char, 2> >
+class ITK_EXPORT PersistentStreamingQuantilesVectorImageFilter :
+  public PersistentImageFilter<TInputImage, TInputImage>
+{
+public:
+  /** Standard Self typedef */
+  typedef PersistentStreamingQuantilesVectorImageFilter   Self;
+  typedef PersistentImageFilter<TInputImage, TInputImage> Superclass;
+  typedef itk::SmartPointer<Self>                         Pointer;
+  typedef itk::SmartPointer<const Self>                   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Runtime information support. */
+  itkTypeMacro(PersistentStreamingQuantilesVectorImageFilter, PersistentImageFilter);
+
+  /** Image related typedefs. */
+  typedef TInputImage                           ImageType;
+  typedef typename ImageType::Pointer           InputImagePointer;
+  typedef typename ImageType::RegionType        RegionType;
+  typedef typename ImageType::PixelType         PixelType;
+  typedef typename ImageType::InternalPixelType InternalPixelType;
+  typedef TMaskImage                            MaskImageType;
+
+  typedef itk::VariableLengthVector<double>     RealPixelType;
+  typedef std::vector<QuantileSketch>           SketchListType;
+
+  /** Set the mask: only the pixels where it is not null are used */
+  void SetMaskImage(const MaskImageType * mask);
+  const MaskImageType * GetMaskImage() const;
+
+  /** Quantile q (between 0 and 1) of each band */
+  RealPixelType GetQuantiles(double q) const;
+
+  /** Sketches of the bands, valid after Synthetize() */
+  const SketchListType & GetSketches() const
+  {
+    return m_Sketches;
+  }
+
+  void Reset(void) override;
+
+  void Synthetize(void) override;
+
+  /** Accuracy of the sketches (see QuantileSketch) */
+  itkSetMacro(K, unsigned int);
+  itkGetMacro(K, unsigned int);
+
+  itkSetMacro(NoDataFlag, bool);
+  itkGetMacro(NoDataFlag, bool);
+
+  itkSetMacro(NoDataValue, InternalPixelType);
+  itkGetMacro(NoDataValue, InternalPixelType);
+
+protected:
+  PersistentStreamingQuantilesVectorImageFilter();
+
+  ~PersistentStreamingQuantilesVectorImageFilter() override {}
+
+  /** The output image is not used: nothing is allocated */
+  void AllocateOutputs() override;
+
+  void GenerateOutputInformation() override;
+
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId) override;
+
+private:
+  PersistentStreamingQuantilesVectorImageFilter(const Self &) = delete;
+  void operator =(const Self&) = delete;
+
+  unsigned int      m_K;
+  bool              m_NoDataFlag;
+  InternalPixelType m_NoDataValue;
+
+  /** Sketches of each band, per thread */
+  std::vector<SketchListType> m_ThreadSketches;
+  SketchListType              m_Sketches;
+}; // end of class PersistentStreamingQuantilesVectorImageFilter
+
+/**===========================================================================*/
+
+/** \class StreamingQuantilesVectorImageFilter
+ * \brief This class streams the whole input image through the PersistentStreamingQuantilesVectorImageFilter.
+ *
+ * \sa PersistentStreamingQuantilesVectorImageFilter
+ * \sa PersistentFilterStreamingDecorator
+ * \ingroup Streamed
+ * \ingroup Multithreaded
+ * \ingroup MathematicalStatisticsImageFilters
+ *
+ * \ingroup OTBStatistics
+ */
+template<class TInputImage, class TMaskImage = otb::Image<unsigned char, 2> >
+class ITK_EXPORT StreamingQuantilesVectorImageFilter :
+  public PersistentFilterStreamingDecorator<PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage> >
+{
+public:
+  /** Standard Self typedef */
+  typedef StreamingQuantilesVectorImageFilter Self;
+  typedef PersistentFilterStreamingDecorator
+  <PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage> > Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Type macro */
+  itkNewMacro(Self);
+
+  /** Creation through object factory macro */
+  itkTypeMacro(StreamingQuantilesVectorImageFilter, PersistentFilterStreamingDecorator);
+
+  typedef TInputImage                                 InputImageType;
+  typedef TMaskImage                                  MaskImageType;
+  typedef typename Superclass::FilterType             QuantilesFilterType;
+  typedef typename QuantilesFilterType::RealPixelType RealPixelType;
+  typedef typename QuantilesFilterType::SketchListType SketchListType;
+  typedef typename QuantilesFilterType::InternalPixelType InternalPixelType;
+
+  using Superclass::SetInput;
+  void SetInput(InputImageType * input)
+  {
+    this->GetFilter()->SetInput(input);
+  }
+  const InputImageType * GetInput()
+  {
+    return this->GetFilter()->GetInput();
+  }
+
+  void SetMaskImage(const MaskImageType * mask)
+  {
+    this->GetFilter()->SetMaskImage(mask);
+  }
+  const MaskImageType * GetMaskImage() const
+  {
+    return this->GetFilter()->GetMaskImage();
+  }
+
+  /** Quantile q (between 0 and 1) of each band */
+  RealPixelType GetQuantiles(double q) const
+  {
+    return this->GetFilter()->GetQuantiles(q);
+  }
+
+  const SketchListType & GetSketches() const
+  {
+    return this->GetFilter()->GetSketches();
+  }
+
+  otbSetObjectMemberMacro(Filter, K, unsigned int);
+  otbGetObjectMemberMacro(Filter, K, unsigned int);
+
+  otbSetObjectMemberMacro(Filter, NoDataFlag, bool);
+  otbGetObjectMemberMacro(Filter, NoDataFlag, bool);
+
+  otbSetObjectMemberMacro(Filter, NoDataValue, InternalPixelType);
+  otbGetObjectMemberMacro(Filter, NoDataValue, InternalPixelType);
+
+protected:
+  /** Constructor */
+  StreamingQuantilesVectorImageFilter() {}
+
+  /** Destructor */
+  ~StreamingQuantilesVectorImageFilter() override {}
+
+private:
+  StreamingQuantilesVectorImageFilter(const Self &) = delete;
+  void operator =(const Self&) = delete;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbStreamingQuantilesVectorImageFilter.hxx"
+#endif
+
+#endif
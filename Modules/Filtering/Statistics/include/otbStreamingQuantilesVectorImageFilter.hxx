@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbStreamingQuantilesVectorImageFilter_hxx
+#define otbStreamingQuantilesVectorImageFilter_hxx
+#include "otbStreamingQuantilesVectorImageFilter.h"
+
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+#include "otbMacro.h"
+
+namespace otb
+{
+
+template<class TInputImage, class TMaskImage>
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::PersistentStreamingQuantilesVectorImageFilter()
+ : m_K(200),
+   m_NoDataFlag(false),
+   m_NoDataValue(itk::NumericTraits<InternalPixelType>::Zero)
+{
+  this->SetNumberOfRequiredInputs(1);
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::SetMaskImage(const MaskImageType * mask)
+{
+  this->itk::ProcessObject::SetNthInput(1, const_cast<MaskImageType *>(mask));
+}
+
+template<class TInputImage, class TMaskImage>
+const typename PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>::MaskImageType *
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::GetMaskImage() const
+{
+  if (this->GetNumberOfInputs() < 2)
+    {
+    return nullptr;
+    }
+  return static_cast<const MaskImageType *>(this->itk::ProcessObject::GetInput(1));
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+  if (this->GetInput())
+    {
+    this->GetOutput()->CopyInformation(this->GetInput());
+    this->GetOutput()->SetLargestPossibleRegion(this->GetInput()->GetLargestPossibleRegion());
+
+    if (this->GetOutput()->GetRequestedRegion().GetNumberOfPixels() == 0)
+      {
+      this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+      }
+    }
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::AllocateOutputs()
+{
+  // Nothing that needs to be allocated: the output image is not intended
+  // to be used
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::Reset()
+{
+  TInputImage * inputPtr = const_cast<TInputImage *>(this->GetInput());
+  inputPtr->UpdateOutputInformation();
+
+  const unsigned int numberOfComponent = inputPtr->GetNumberOfComponentsPerPixel();
+
+  m_Sketches.clear();
+  m_ThreadSketches = std::vector<SketchListType>(this->GetNumberOfThreads(),
+                                                 SketchListType(numberOfComponent, QuantileSketch(m_K)));
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::Synthetize()
+{
+  if (m_ThreadSketches.empty())
+    {
+    return;
+    }
+
+  m_Sketches = m_ThreadSketches[0];
+  for (unsigned int threadId = 1; threadId < m_ThreadSketches.size(); ++threadId)
+    {
+    for (unsigned int j = 0; j < m_Sketches.size(); ++j)
+      {
+      m_Sketches[j].Merge(m_ThreadSketches[threadId][j]);
+      }
+    }
+  m_ThreadSketches.clear();
+}
+
+template<class TInputImage, class TMaskImage>
+typename PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>::RealPixelType
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::GetQuantiles(double q) const
+{
+  RealPixelType quantiles(m_Sketches.size());
+  for (unsigned int j = 0; j < m_Sketches.size(); ++j)
+    {
+    quantiles[j] = m_Sketches[j].GetQuantile(q);
+    }
+  return quantiles;
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId)
+{
+  itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
+
+  const TInputImage * inputPtr = this->GetInput();
+  const MaskImageType * maskPtr = this->GetMaskImage();
+  SketchListType & sketches = m_ThreadSketches[threadId];
+
+  itk::ImageRegionConstIterator<TInputImage> it(inputPtr, outputRegionForThread);
+  itk::ImageRegionConstIterator<MaskImageType> maskIt;
+  if (maskPtr)
+    {
+    maskIt = itk::ImageRegionConstIterator<MaskImageType>(maskPtr, outputRegionForThread);
+    maskIt.GoToBegin();
+    }
+
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it, progress.CompletedPixel())
+    {
+    if (maskPtr)
+      {
+      const bool valid = maskIt.Get() != 0;
+      ++maskIt;
+      if (!valid)
+        {
+        continue;
+        }
+      }
+
+    const PixelType& vectorValue = it.Get();
+    for (unsigned int j = 0; j < sketches.size(); ++j)
+      {
+      const double value = static_cast<double>(vectorValue[j]);
+      if (!vnl_math_isfinite(value) || (m_NoDataFlag && vectorValue[j] == m_NoDataValue))
+        {
+        continue;
+        }
+      sketches[j].Insert(value);
+      }
+    }
+}
+
+template<class TInputImage, class TMaskImage>
+void
+PersistentStreamingQuantilesVectorImageFilter<TInputImage, TMaskImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "K: " << m_K << std::endl;
+  os << indent << "NoDataFlag: " << (m_NoDataFlag ? "true" : "false") << std::endl;
+  os << indent << "NoDataValue: " << m_NoDataValue << std::endl;
+}
+
+} // end namespace otb
+#endif
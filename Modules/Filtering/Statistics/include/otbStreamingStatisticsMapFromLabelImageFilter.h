@@ -27,6 +27,7 @@
 #include "itkArray.h"
 #include "itkSimpleDataObjectDecorator.h"
 #include "otbPersistentFilterStreamingDecorator.h"
+#include "otbLabelStatisticsTable.h"
 
 
 namespace otb
@@ -164,6 +165,19 @@ protected:
 /** \class PersistentStreamingStatisticsMapFromLabelImageFilter
  * \brief Computes mean radiometric value for each label of a label image, based on a support VectorImage
  *
+ * The labels are sharded between the threads: each requested region is
+ * first scanned by all the threads, which sort the pixels by shard of
+ * their label, then each thread accumulates the pixels of its own shard
+ * in a LabelStatisticsTable. A label is thus accumulated by a single
+ * thread, in the order of the pixels, and the shards never need to be
+ * merged. The tables store the statistics in flat arrays, with no
+ * allocation per label, so that millions of labels fit in memory.
+ *
+ * When the labels span a compact range, SetDenseLabelRange() preallocates
+ * their statistics so that they are found without hashing. The median of
+ * each band can be estimated as well with SetComputeMedian(), at the cost
+ * of a QuantileSketch per label and per band.
+ *
  * This filter persists its temporary data. It means that if you Update it n times on n different
  * requested regions, the output statistics will be the statitics of the whole set of n regions.
  *
@@ -207,9 +221,8 @@ public:
   typedef typename VectorImageType::PixelType::ValueType                VectorPixelValueType;
   typedef typename LabelImageType::PixelType                            LabelPixelType;
   typedef itk::VariableLengthVector<double>                             RealVectorPixelType;
-  typedef StatisticsAccumulator<RealVectorPixelType>                    AccumulatorType;
-  typedef std::map<LabelPixelType, AccumulatorType >                    AccumulatorMapType;
-  typedef std::vector<AccumulatorMapType>                               AccumulatorMapCollectionType;
+  typedef LabelStatisticsTable<LabelPixelType>                          StatisticsTableType;
+  typedef std::vector<StatisticsTableType>                              StatisticsTableCollectionType;
   typedef std::map<LabelPixelType, RealVectorPixelType >  PixelValueMapType;
   typedef std::map<LabelPixelType, double>                LabelPopulationMapType;
 
@@ -225,6 +238,25 @@ public:
   itkGetMacro(UseNoDataValue, bool);
   itkSetMacro(UseNoDataValue, bool);
 
+  /** Estimate the median of each band for each label (off by default) */
+  itkGetMacro(ComputeMedian, bool);
+  itkSetMacro(ComputeMedian, bool);
+  itkBooleanMacro(ComputeMedian);
+
+  /** Size K of the quantile sketches used to estimate the medians */
+  itkGetMacro(MedianSketchSize, unsigned int);
+  itkSetMacro(MedianSketchSize, unsigned int);
+
+  /** Preallocate the statistics of the labels in [minimum, maximum] */
+  void SetDenseLabelRange(LabelPixelType minimum, LabelPixelType maximum);
+
+  /** Store all the labels in the hash tables (default) */
+  void ClearDenseLabelRange();
+
+  itkGetMacro(UseDenseLabelRange, bool);
+  itkGetMacro(DenseLabelMinimum, LabelPixelType);
+  itkGetMacro(DenseLabelMaximum, LabelPixelType);
+
   /** Smart Pointer type to a DataObject. */
   typedef typename itk::DataObject::Pointer DataObjectPointer;
   typedef itk::ProcessObject::DataObjectPointerArraySizeType DataObjectPointerArraySizeType;
@@ -253,9 +285,22 @@ public:
   /** Return the computed Max for each label in the input label image */
   PixelValueMapType GetMaxValueMap() const;
 
+  /** Return the estimated Median for each label in the input label image,
+   *  empty if ComputeMedian is off */
+  PixelValueMapType GetMedianValueMap() const;
+
   /** Return the computed number of labeled pixels for each label in the input label image */
   LabelPopulationMapType GetLabelPopulationMap() const;
 
+  /** Return the number of labels found in the input label image */
+  size_t GetNumberOfLabels() const;
+
+  /** Tables of statistics, one per shard of labels */
+  const StatisticsTableCollectionType & GetStatisticsTables() const
+  {
+    return m_Tables;
+  }
+
   /** Make a DataObject of the correct type to be used as the specified
    * output. */
   DataObjectPointer MakeOutput(DataObjectPointerArraySizeType idx) override;
@@ -281,23 +326,49 @@ protected:
   ~PersistentStreamingStatisticsMapFromLabelImageFilter() override {}
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
+  void BeforeThreadedGenerateData() override;
+
   void ThreadedGenerateData(const RegionType& outputRegionForThread, itk::ThreadIdType threadId ) override;
 
+  void AfterThreadedGenerateData() override;
+
 private:
   PersistentStreamingStatisticsMapFromLabelImageFilter(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  /** Pixel of the requested region, sorted in the shard of its label */
+  struct ShardedPixel
+  {
+    LabelPixelType       label;
+    itk::OffsetValueType offset;
+  };
+  typedef std::vector<ShardedPixel> ShardedPixelListType;
+
+  /** Shard of a label */
+  unsigned int GetShard(LabelPixelType label) const;
+
+  /** Accumulate the pixels of a shard, sorted by all the threads */
+  void AccumulateShard(unsigned int shard);
+
+  static ITK_THREAD_RETURN_TYPE AccumulateShardCallback(void * arg);
+
+  /** Build a map of a statistic over all the labels */
+  template <class TFunction>
+  PixelValueMapType BuildValueMap(TFunction statistic) const;
+
   VectorPixelValueType                   m_NoDataValue;
   bool                                   m_UseNoDataValue;
+  bool                                   m_ComputeMedian;
+  unsigned int                           m_MedianSketchSize;
+  bool                                   m_UseDenseLabelRange;
+  LabelPixelType                         m_DenseLabelMinimum;
+  LabelPixelType                         m_DenseLabelMaximum;
 
-  AccumulatorMapCollectionType           m_AccumulatorMaps;
-
-  PixelValueMapType                      m_MeanRadiometricValue;
-  PixelValueMapType                      m_StDevRadiometricValue;
-  PixelValueMapType                      m_MinRadiometricValue;
-  PixelValueMapType                      m_MaxRadiometricValue;
+  /** One table per shard, filled by the thread of the shard */
+  StatisticsTableCollectionType          m_Tables;
 
-  LabelPopulationMapType                 m_LabelPopulation;
+  /** Pixels of the requested region, per thread and per shard */
+  std::vector<std::vector<ShardedPixelListType> > m_ShardedPixels;
 
 }; // end of class PersistentStreamingStatisticsMapFromLabelImageFilter
 
@@ -369,6 +440,7 @@ public:
 
   typedef typename VectorImageType::PixelType                        VectorPixelType;
   typedef typename VectorImageType::PixelType::ValueType             VectorPixelValueType;
+  typedef typename LabelImageType::PixelType                         LabelPixelType;
 
   typedef typename Superclass::FilterType::PixelValueMapType         PixelValueMapType;
   typedef typename Superclass::FilterType::PixelValueMapObjectType   PixelValueMapObjectType;
@@ -424,12 +496,24 @@ public:
     return this->GetFilter()->GetMaxValueMap();
   }
 
+  /** Return the estimated Median for each label */
+  PixelValueMapType GetMedianValueMap() const
+  {
+    return this->GetFilter()->GetMedianValueMap();
+  }
+
   /** Return the computed number of labeled pixels for each label */
   LabelPopulationMapType GetLabelPopulationMap() const
   {
     return this->GetFilter()->GetLabelPopulationMap();
   }
 
+  /** Return the number of labels */
+  size_t GetNumberOfLabels() const
+  {
+    return this->GetFilter()->GetNumberOfLabels();
+  }
+
   /** Set the no data value */
   void SetNoDataValue(VectorPixelValueType value)
   {
@@ -454,6 +538,24 @@ public:
       return this->GetFilter()->GetUseNoDataValue();
   }
 
+  /** Configure whether the median of each band is estimated */
+  void SetComputeMedian(bool computeMedian)
+  {
+      this->GetFilter()->SetComputeMedian(computeMedian);
+  }
+
+  /** Return whether the median of each band is estimated */
+  bool GetComputeMedian() const
+  {
+      return this->GetFilter()->GetComputeMedian();
+  }
+
+  /** Preallocate the statistics of a compact range of labels */
+  void SetDenseLabelRange(LabelPixelType minimum, LabelPixelType maximum)
+  {
+      this->GetFilter()->SetDenseLabelRange(minimum, maximum);
+  }
+
 protected:
   /** Constructor */
   StreamingStatisticsMapFromLabelImageFilter() {}
@@ -25,6 +25,8 @@
 
 #include "itkInputDataObjectIterator.h"
 #include "itkImageRegionIterator.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkMultiThreader.h"
 #include "itkProgressReporter.h"
 #include "otbMacro.h"
 #include <cmath>
@@ -35,7 +37,12 @@ namespace otb
 template<class TInputVectorImage, class TLabelImage>
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
 ::PersistentStreamingStatisticsMapFromLabelImageFilter()
-    : m_UseNoDataValue()
+    : m_UseNoDataValue(),
+      m_ComputeMedian(false),
+      m_MedianSketchSize(32),
+      m_UseDenseLabelRange(false),
+      m_DenseLabelMinimum(),
+      m_DenseLabelMaximum()
 {
   // first output is a copy of the image, DataObject created by
   // superclass
@@ -78,12 +85,66 @@ PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelIm
     (this->itk::ProcessObject::GetInput(1));
 }
 
+template<class TInputVectorImage, class TLabelImage>
+void
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::SetDenseLabelRange(LabelPixelType minimum, LabelPixelType maximum)
+{
+  if (maximum < minimum)
+    {
+    itkExceptionMacro(<< "Invalid dense label range [" << minimum << ", " << maximum << "]");
+    }
+  m_UseDenseLabelRange = true;
+  m_DenseLabelMinimum = minimum;
+  m_DenseLabelMaximum = maximum;
+  this->Modified();
+}
+
+template<class TInputVectorImage, class TLabelImage>
+void
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::ClearDenseLabelRange()
+{
+  m_UseDenseLabelRange = false;
+  this->Modified();
+}
+
+template<class TInputVectorImage, class TLabelImage>
+template <class TFunction>
+typename PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>::PixelValueMapType
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::BuildValueMap(TFunction statistic) const
+{
+  PixelValueMapType valueMap;
+  for (auto const& table: m_Tables)
+    {
+    const unsigned int nbBands = table.GetNumberOfBands();
+    for (size_t slot = 0; slot < table.GetNumberOfSlots(); ++slot)
+      {
+      if (table.GetPopulation(slot) == 0)
+        {
+        continue;
+        }
+      RealVectorPixelType value(nbBands);
+      for (unsigned int band = 0; band < nbBands; ++band)
+        {
+        value[band] = statistic(table, slot, band);
+        }
+      valueMap.emplace_hint(valueMap.end(), table.GetLabel(slot), value);
+      }
+    }
+  return valueMap;
+}
+
 template<class TInputVectorImage, class TLabelImage>
 typename PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>::PixelValueMapType
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
 ::GetMeanValueMap() const
 {
-  return m_MeanRadiometricValue;
+  return this->BuildValueMap([](const StatisticsTableType & table, size_t slot, unsigned int band)
+    {
+    return table.GetSum(slot, band) / table.GetBandCount(slot, band);
+    });
 }
 
 template<class TInputVectorImage, class TLabelImage>
@@ -91,7 +152,15 @@ typename PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage,
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
 ::GetStandardDeviationValueMap() const
 {
-  return m_StDevRadiometricValue;
+  return this->BuildValueMap([](const StatisticsTableType & table, size_t slot, unsigned int band)
+    {
+    // Number of valid pixels in band
+    const double count = table.GetBandCount(slot, band);
+    const double sum = table.GetSum(slot, band);
+    // Unbiased standard deviation
+    const double variance = (table.GetSqSum(slot, band) - sum * (sum / count)) / (count - 1);
+    return std::sqrt(variance);
+    });
 }
 
 template<class TInputVectorImage, class TLabelImage>
@@ -99,7 +168,10 @@ typename PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage,
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
 ::GetMinValueMap() const
 {
-  return m_MinRadiometricValue;
+  return this->BuildValueMap([](const StatisticsTableType & table, size_t slot, unsigned int band)
+    {
+    return table.GetMin(slot, band);
+    });
 }
 
 template<class TInputVectorImage, class TLabelImage>
@@ -107,7 +179,25 @@ typename PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage,
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
 ::GetMaxValueMap() const
 {
-  return m_MaxRadiometricValue;
+  return this->BuildValueMap([](const StatisticsTableType & table, size_t slot, unsigned int band)
+    {
+    return table.GetMax(slot, band);
+    });
+}
+
+template<class TInputVectorImage, class TLabelImage>
+typename PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>::PixelValueMapType
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::GetMedianValueMap() const
+{
+  if (m_Tables.empty() || !m_Tables.front().GetComputeMedian())
+    {
+    return PixelValueMapType();
+    }
+  return this->BuildValueMap([](const StatisticsTableType & table, size_t slot, unsigned int band)
+    {
+    return table.GetSketch(slot, band).GetQuantile(0.5);
+    });
 }
 
 template<class TInputVectorImage, class TLabelImage>
@@ -115,7 +205,31 @@ typename PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage,
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
 ::GetLabelPopulationMap() const
 {
-  return m_LabelPopulation;
+  LabelPopulationMapType populationMap;
+  for (auto const& table: m_Tables)
+    {
+    for (size_t slot = 0; slot < table.GetNumberOfSlots(); ++slot)
+      {
+      if (table.GetPopulation(slot) > 0)
+        {
+        populationMap[table.GetLabel(slot)] = table.GetPopulation(slot);
+        }
+      }
+    }
+  return populationMap;
+}
+
+template<class TInputVectorImage, class TLabelImage>
+size_t
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::GetNumberOfLabels() const
+{
+  size_t nbLabels = 0;
+  for (auto const& table: m_Tables)
+    {
+    nbLabels += table.GetNumberOfLabels();
+    }
+  return nbLabels;
 }
 
 template<class TInputVectorImage, class TLabelImage>
@@ -153,77 +267,19 @@ template<class TInputVectorImage, class TLabelImage>
 void
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
 ::Synthetize()
- {
-  // Update temporary accumulator
-  AccumulatorMapType outputAcc;
-  auto endAcc = outputAcc.end();
-
-  for (auto const& threadAccMap: m_AccumulatorMaps)
-    {
-    for(auto const& it: threadAccMap)
-      {
-      auto label = it.first;
-      auto itAcc = outputAcc.find(label);
-      if (itAcc == endAcc)
-        {
-        outputAcc.emplace(label, it.second);
-        }
-      else
-        {
-        itAcc->second.Update(it.second);
-        }
-      }
-    }
-
-  // Publish output maps
-  for(auto& it: outputAcc)
-    {
-    const LabelPixelType label = it.first;
-    const auto &bandCount = it.second.GetBandCount();
-    const auto &sum       = it.second.GetSum();
-    const auto &sqSum     = it.second.GetSqSum();
-
-    // Count
-    m_LabelPopulation[label] = it.second.GetCount();
-
-    // Mean & stdev
-    RealVectorPixelType mean (sum);
-    RealVectorPixelType std (sqSum);
-    for (unsigned int band = 0 ; band < mean.GetSize() ; band++)
-      {
-      // Number of valid pixels in band
-      auto count = bandCount[band];
-      // Mean
-      mean[band] /= count;
-
-      // Unbiased standard deviation (not sure unbiased is usefull here)
-      const double variance = (sqSum[band] - (sum[band] * mean[band])) / (count - 1);
-      std[band] = std::sqrt(variance);
-      }
-    m_MeanRadiometricValue[label] = mean;
-    m_StDevRadiometricValue[label] = std;
-
-    // Min & max
-    m_MinRadiometricValue[label] = it.second.GetMin();
-    m_MaxRadiometricValue[label] = it.second.GetMax();
-    }
-
- }
+{
+  // Each label has been accumulated in a single shard: there is nothing
+  // to merge, the maps are built on request from the tables
+  m_ShardedPixels.clear();
+}
 
 template<class TInputVectorImage, class TLabelImage>
 void
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
 ::Reset()
 {
-  m_AccumulatorMaps.clear();
-
-  m_MeanRadiometricValue.clear();
-  m_StDevRadiometricValue.clear();
-  m_MinRadiometricValue.clear();
-  m_MaxRadiometricValue.clear();
-  m_LabelPopulation.clear();
-  m_AccumulatorMaps.resize(this->GetNumberOfThreads());
-
+  m_Tables.clear();
+  m_ShardedPixels.clear();
 }
 
 template<class TInputVectorImage, class TLabelImage>
@@ -256,6 +312,54 @@ PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelIm
     }
 }
 
+template<class TInputVectorImage, class TLabelImage>
+unsigned int
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::GetShard(LabelPixelType label) const
+{
+  const unsigned int nbShards = m_Tables.size();
+  if (m_UseDenseLabelRange && !(label < m_DenseLabelMinimum) && !(m_DenseLabelMaximum < label))
+    {
+    // Consistent with the dense ranges of the tables
+    return static_cast<unsigned long long>(label - m_DenseLabelMinimum) % nbShards;
+    }
+  const uint64_t h = static_cast<uint64_t>(std::hash<LabelPixelType>()(label)) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<unsigned int>((h >> 32) % nbShards);
+}
+
+template<class TInputVectorImage, class TLabelImage>
+void
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::BeforeThreadedGenerateData()
+{
+  const unsigned int nbThreads = this->GetNumberOfThreads();
+
+  // The tables are kept from one requested region to the next
+  if (m_Tables.empty())
+    {
+    m_Tables.resize(nbThreads);
+    for (unsigned int shard = 0; shard < nbThreads; ++shard)
+      {
+      m_Tables[shard].Initialize(this->GetInput()->GetNumberOfComponentsPerPixel(),
+                                 m_ComputeMedian, m_MedianSketchSize);
+      if (m_UseDenseLabelRange)
+        {
+        m_Tables[shard].SetDenseRange(m_DenseLabelMinimum, m_DenseLabelMaximum, nbThreads, shard);
+        }
+      }
+    }
+
+  m_ShardedPixels.resize(nbThreads);
+  for (auto & threadPixels: m_ShardedPixels)
+    {
+    threadPixels.resize(m_Tables.size());
+    for (auto & shardPixels: threadPixels)
+      {
+      shardPixels.clear();
+      }
+    }
+}
+
 template<class TInputVectorImage, class TLabelImage>
 void
 PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
@@ -267,33 +371,83 @@ PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelIm
   InputVectorImagePointer inputPtr =  const_cast<TInputVectorImage *>(this->GetInput());
   LabelImagePointer labelInputPtr =  const_cast<TLabelImage *>(this->GetInputLabelImage());
 
-  itk::ImageRegionConstIterator<TInputVectorImage> inIt(inputPtr, outputRegionForThread);
-  itk::ImageRegionConstIterator<TLabelImage> labelIt(labelInputPtr, outputRegionForThread);
+  itk::ImageScanlineConstIterator<TLabelImage> labelIt(labelInputPtr, outputRegionForThread);
   itk::ProgressReporter progress(this, threadId, outputRegionForThread.GetNumberOfPixels());
 
-  auto &acc = m_AccumulatorMaps[threadId];
-  auto endAcc = acc.end();
+  auto &shardedPixels = m_ShardedPixels[threadId];
 
-  // do the work
-  for (inIt.GoToBegin(), labelIt.GoToBegin();
-       !inIt.IsAtEnd() && !labelIt.IsAtEnd();
-       ++inIt, ++labelIt)
+  // Sort the pixels by shard, with their offset in the input buffer
+  for (labelIt.GoToBegin(); !labelIt.IsAtEnd(); labelIt.NextLine())
     {
-      const auto &value = inIt.Get();
-      auto label = labelIt.Get();
+    ShardedPixel pixel;
+    pixel.offset = inputPtr->ComputeOffset(labelIt.GetIndex());
+    while (!labelIt.IsAtEndOfLine())
+      {
+      pixel.label = labelIt.Get();
+      shardedPixels[this->GetShard(pixel.label)].push_back(pixel);
+      ++pixel.offset;
+      ++labelIt;
+      progress.CompletedPixel();
+      }
+    }
+}
 
-      // Update the accumulator
-      auto itAcc = acc.find(label);
-      if (itAcc == endAcc)
-        {
-        acc.emplace(label, AccumulatorType(this->GetNoDataValue(), this->GetUseNoDataValue(), value));
-        }
-      else
+template<class TInputVectorImage, class TLabelImage>
+void
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::AfterThreadedGenerateData()
+{
+  // Accumulate each shard in its own thread
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetNumberOfThreads(m_Tables.size());
+  threader->SetSingleMethod(AccumulateShardCallback, this);
+  threader->SingleMethodExecute();
+}
+
+template<class TInputVectorImage, class TLabelImage>
+ITK_THREAD_RETURN_TYPE
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::AccumulateShardCallback(void * arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  Self * self = static_cast<Self *>(info->UserData);
+  // Threads beyond the number of shards have nothing to do
+  for (unsigned int shard = info->ThreadID; shard < self->m_Tables.size(); shard += info->NumberOfThreads)
+    {
+    self->AccumulateShard(shard);
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template<class TInputVectorImage, class TLabelImage>
+void
+PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelImage>
+::AccumulateShard(unsigned int shard)
+{
+  const VectorImageType * inputPtr = this->GetInput();
+  const unsigned int nbBands = inputPtr->GetNumberOfComponentsPerPixel();
+  const typename VectorImageType::InternalPixelType * buffer = inputPtr->GetBufferPointer();
+  const double noDataValue = static_cast<double>(m_NoDataValue);
+
+  auto &table = m_Tables[shard];
+  LabelPixelType lastLabel = LabelPixelType();
+  size_t lastSlot = StatisticsTableType::NoSlot;
+
+  // The threads handled consecutive parts of the region: pixels are
+  // accumulated in the order of the region
+  for (auto & threadPixels: m_ShardedPixels)
+    {
+    for (auto const& pixel: threadPixels[shard])
+      {
+      // Neighbour pixels often share the same label
+      if (lastSlot == StatisticsTableType::NoSlot || !(pixel.label == lastLabel))
         {
-        itAcc->second.Update(value);
+        lastSlot = table.FindOrInsert(pixel.label);
+        lastLabel = pixel.label;
         }
-
-      progress.CompletedPixel();
+      table.Update(lastSlot, buffer + pixel.offset * nbBands, m_UseNoDataValue, noDataValue);
+      }
+    threadPixels[shard].clear();
     }
 }
 
@@ -303,6 +457,11 @@ PersistentStreamingStatisticsMapFromLabelImageFilter<TInputVectorImage, TLabelIm
 ::PrintSelf(std::ostream& os, itk::Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "UseNoDataValue: " << m_UseNoDataValue << std::endl;
+  os << indent << "NoDataValue: " << m_NoDataValue << std::endl;
+  os << indent << "ComputeMedian: " << m_ComputeMedian << std::endl;
+  os << indent << "UseDenseLabelRange: " << m_UseDenseLabelRange << std::endl;
+  os << indent << "Number of labels: " << this->GetNumberOfLabels() << std::endl;
 }
 
 } // end namespace otb
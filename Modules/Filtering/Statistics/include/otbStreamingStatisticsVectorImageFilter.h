@@ -42,6 +42,22 @@ namespace otb
  *
  * To get the statistics once the regions have been processed via the pipeline, use the Synthetize() method.
  *
+ * Minimum and maximum, first and second order statistics and per band
+ * histograms can be enabled independently: all the enabled statistics are
+ * computed in a single pass over the image.
+ *
+ * By default, first and second order statistics are computed from the sums
+ * of the pixel values and of their products, which lose precision when the
+ * mean is large with respect to the standard deviation. With
+ * UseStableMoments, each thread accumulates the mean and the co-moment
+ * matrix (sum of the products of the deviations to the mean) of blocks of
+ * pixels, and merges them with the pairwise update of Chan et al. The
+ * accumulators of the threads are merged the same way in Synthetize().
+ *
+ * Histograms have NumberOfHistogramBins regular bins per band between
+ * HistogramMinimum and HistogramMaximum. Values out of these bounds are
+ * counted in the first or last bin.
+ *
  * \sa PersistentImageFilter
  * \ingroup Streamed
  * \ingroup Multithreaded
@@ -182,6 +198,15 @@ public:
   MatrixObjectType* GetCovarianceOutput();
   const MatrixObjectType* GetCovarianceOutput() const;
 
+  /** Return the computed histograms, flattened: bin b of band i is at
+   *  index i * NumberOfHistogramBins + b */
+  CountType GetHistogram() const
+  {
+    return this->GetHistogramOutput()->Get();
+  }
+  CountObjectType* GetHistogramOutput();
+  const CountObjectType* GetHistogramOutput() const;
+
   /** Make a DataObject of the correct type to be used as the specified
    * output.
    */
@@ -213,6 +238,21 @@ public:
   itkSetMacro(UseUnbiasedEstimator, bool);
   itkGetMacro(UseUnbiasedEstimator, bool);
 
+  itkSetMacro(UseStableMoments, bool);
+  itkGetMacro(UseStableMoments, bool);
+
+  itkSetMacro(EnableHistogram, bool);
+  itkGetMacro(EnableHistogram, bool);
+
+  itkSetMacro(NumberOfHistogramBins, unsigned int);
+  itkGetMacro(NumberOfHistogramBins, unsigned int);
+
+  itkSetMacro(HistogramMinimum, RealPixelType);
+  itkGetConstReferenceMacro(HistogramMinimum, RealPixelType);
+
+  itkSetMacro(HistogramMaximum, RealPixelType);
+  itkGetConstReferenceMacro(HistogramMaximum, RealPixelType);
+
 protected:
   PersistentStreamingStatisticsVectorImageFilter();
 
@@ -234,14 +274,43 @@ private:
   PersistentStreamingStatisticsVectorImageFilter(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  /** Number of pixels, mean and co-moment matrix of a set of pixels */
+  struct MomentsType
+  {
+    PrecisionType count;
+    RealPixelType mean;
+    MatrixType    comoment;
+  };
+
+  /** Number of pixels of the blocks accumulated with stable moments */
+  static const unsigned int MomentsBlockSize = 256;
+
+  /** Merge the moments of two disjoint sets of pixels into the first one */
+  void MergeMoments(MomentsType & moments, const MomentsType & other) const;
+
+  /** Merge the moments of a block of count pixels, stored pixel after
+   *  pixel, into moments */
+  void AccumulateMoments(MomentsType & moments, const PrecisionType * values, unsigned int count) const;
+
   bool m_EnableMinMax;
   bool m_EnableFirstOrderStats;
   bool m_EnableSecondOrderStats;
+  bool m_EnableHistogram;
 
 
   /* use an unbiased estimator to compute the covariance */
   bool m_UseUnbiasedEstimator;
 
+  /* accumulate the moments with the pairwise update */
+  bool m_UseStableMoments;
+
+  unsigned int  m_NumberOfHistogramBins;
+  RealPixelType m_HistogramMinimum;
+  RealPixelType m_HistogramMaximum;
+
+  std::vector<MomentsType>   m_ThreadMoments;
+  std::vector<CountType>     m_ThreadHistograms;
+
   std::vector<PixelType>     m_ThreadMin;
   std::vector<PixelType>     m_ThreadMax;
   std::vector<RealType>      m_ThreadFirstOrderComponentAccumulators;
@@ -485,9 +554,38 @@ public:
   otbSetObjectMemberMacro(Filter, UserIgnoredValue, InternalPixelType);
   otbGetObjectMemberMacro(Filter, UserIgnoredValue, InternalPixelType);
 
+  /** Return the computed histograms. */
+  CountType GetHistogram() const
+  {
+    return this->GetFilter()->GetHistogramOutput()->Get();
+  }
+  CountObjectType* GetHistogramOutput()
+  {
+    return this->GetFilter()->GetHistogramOutput();
+  }
+  const CountObjectType* GetHistogramOutput() const
+  {
+    return this->GetFilter()->GetHistogramOutput();
+  }
+
   otbSetObjectMemberMacro(Filter, UseUnbiasedEstimator, bool);
   otbGetObjectMemberMacro(Filter, UseUnbiasedEstimator, bool);
 
+  otbSetObjectMemberMacro(Filter, UseStableMoments, bool);
+  otbGetObjectMemberMacro(Filter, UseStableMoments, bool);
+
+  otbSetObjectMemberMacro(Filter, EnableHistogram, bool);
+  otbGetObjectMemberMacro(Filter, EnableHistogram, bool);
+
+  otbSetObjectMemberMacro(Filter, NumberOfHistogramBins, unsigned int);
+  otbGetObjectMemberMacro(Filter, NumberOfHistogramBins, unsigned int);
+
+  otbSetObjectMemberMacro(Filter, HistogramMinimum, RealPixelType);
+  otbGetObjectMemberMacro(Filter, HistogramMinimum, RealPixelType);
+
+  otbSetObjectMemberMacro(Filter, HistogramMaximum, RealPixelType);
+  otbGetObjectMemberMacro(Filter, HistogramMaximum, RealPixelType);
+
 protected:
   /** Constructor */
   StreamingStatisticsVectorImageFilter() {}
@@ -36,7 +36,10 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
  : m_EnableMinMax(true),
    m_EnableFirstOrderStats(true),
    m_EnableSecondOrderStats(true),
+   m_EnableHistogram(false),
    m_UseUnbiasedEstimator(true),
+   m_UseStableMoments(false),
+   m_NumberOfHistogramBins(256),
    m_IgnoreInfiniteValues(true),
    m_IgnoreUserDefinedValue(false),
    m_UserIgnoredValue(itk::NumericTraits<InternalPixelType>::Zero)
@@ -46,7 +49,7 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
 
   // allocate the data objects for the outputs which are
   // just decorators around vector/matrix types
-  for (unsigned int i = 1; i < 11; ++i)
+  for (unsigned int i = 1; i < 12; ++i)
     {
     this->itk::ProcessObject::SetNthOutput(i, this->MakeOutput(i).GetPointer());
     }
@@ -87,7 +90,8 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
       return static_cast<itk::DataObject*>(RealObjectType::New().GetPointer());
       break;
     case 10:
-      // relevant pixel
+    case 11:
+      // relevant pixel, histogram
       return static_cast<itk::DataObject*>(CountObjectType::New().GetPointer());
     default:
       // might as well make an image
@@ -113,6 +117,22 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
 }
 
 
+template<class TInputImage, class TPrecision>
+typename PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::CountObjectType*
+PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
+::GetHistogramOutput()
+{
+  return static_cast<CountObjectType*>(this->itk::ProcessObject::GetOutput(11));
+}
+
+template<class TInputImage, class TPrecision>
+const typename PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::CountObjectType*
+PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
+::GetHistogramOutput() const
+{
+  return static_cast<const CountObjectType*>(this->itk::ProcessObject::GetOutput(11));
+}
+
 template<class TInputImage, class TPrecision>
 typename PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>::PixelObjectType*
 PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
@@ -356,6 +376,36 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
     std::fill(m_ThreadSecondOrderComponentAccumulators.begin(), m_ThreadSecondOrderComponentAccumulators.end(), zeroReal);
     }
 
+  if (m_UseStableMoments && m_EnableFirstOrderStats)
+    {
+    MomentsType zeroMoments;
+    zeroMoments.count = itk::NumericTraits<PrecisionType>::ZeroValue();
+    zeroMoments.mean.SetSize(numberOfComponent);
+    zeroMoments.mean.Fill(itk::NumericTraits<PrecisionType>::ZeroValue());
+    if (m_EnableSecondOrderStats)
+      {
+      zeroMoments.comoment.SetSize(numberOfComponent, numberOfComponent);
+      zeroMoments.comoment.Fill(itk::NumericTraits<PrecisionType>::ZeroValue());
+      }
+    m_ThreadMoments = std::vector<MomentsType>(numberOfThreads, zeroMoments);
+    }
+
+  if (m_EnableHistogram)
+    {
+    if (m_NumberOfHistogramBins == 0)
+      {
+      itkExceptionMacro(<< "The number of histogram bins must be positive");
+      }
+    if (m_HistogramMinimum.GetSize() != numberOfComponent || m_HistogramMaximum.GetSize() != numberOfComponent)
+      {
+      itkExceptionMacro(<< "Histogram bounds must have " << numberOfComponent << " components");
+      }
+    CountType zeroHistogram(numberOfComponent * m_NumberOfHistogramBins);
+    zeroHistogram.Fill(0);
+    this->GetHistogramOutput()->Set(zeroHistogram);
+    m_ThreadHistograms = std::vector<CountType>(numberOfThreads, zeroHistogram);
+    }
+
   if (m_IgnoreInfiniteValues)
     {
       m_IgnoredInfinitePixelCount= std::vector<unsigned int>(numberOfThreads, 0);
@@ -391,6 +441,24 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
   RealType streamFirstOrderComponentAccumulator = itk::NumericTraits<RealType>::Zero;
   RealType streamSecondOrderComponentAccumulator = itk::NumericTraits<RealType>::Zero;
 
+  // Sized here, as merging moments without any pixel leaves them as is
+  MomentsType streamMoments;
+  streamMoments.count = itk::NumericTraits<PrecisionType>::ZeroValue();
+  streamMoments.mean.SetSize(numberOfComponent);
+  streamMoments.mean.Fill(itk::NumericTraits<PrecisionType>::ZeroValue());
+  if (m_EnableSecondOrderStats)
+    {
+    streamMoments.comoment.SetSize(numberOfComponent, numberOfComponent);
+    streamMoments.comoment.Fill(itk::NumericTraits<PrecisionType>::ZeroValue());
+    }
+
+  CountType histogram;
+  if (m_EnableHistogram)
+    {
+    histogram.SetSize(numberOfComponent * m_NumberOfHistogramBins);
+    histogram.Fill(0);
+    }
+
   unsigned int ignoredInfinitePixelCount = 0;
   unsigned int ignoredUserPixelCount = 0;
 
@@ -416,17 +484,26 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
         }
       }
 
-    if (m_EnableFirstOrderStats)
+    if (m_EnableFirstOrderStats && m_UseStableMoments)
+      {
+      this->MergeMoments(streamMoments, m_ThreadMoments[threadId]);
+      }
+    else if (m_EnableFirstOrderStats)
       {
       streamFirstOrderAccumulator += m_ThreadFirstOrderAccumulators[threadId];
       streamFirstOrderComponentAccumulator += m_ThreadFirstOrderComponentAccumulators[threadId];
       }
 
-    if (m_EnableSecondOrderStats)
+    if (m_EnableSecondOrderStats && !m_UseStableMoments)
       {
       streamSecondOrderAccumulator += m_ThreadSecondOrderAccumulators[threadId];
       streamSecondOrderComponentAccumulator += m_ThreadSecondOrderComponentAccumulators[threadId];
       }
+
+    if (m_EnableHistogram)
+      {
+      histogram += m_ThreadHistograms[threadId];
+      }
     // Ignored Infinite Pixels
     ignoredInfinitePixelCount += m_IgnoredInfinitePixelCount[threadId];
     // Ignored Pixels
@@ -464,7 +541,74 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
     this->GetMaximumOutput()->Set(maximum);
     }
 
-  if (m_EnableFirstOrderStats)
+  if (m_EnableHistogram)
+    {
+    this->GetHistogramOutput()->Set(histogram);
+    }
+
+  if (m_EnableFirstOrderStats && m_UseStableMoments)
+    {
+    const RealPixelType& mean = streamMoments.mean;
+    const PrecisionType count = streamMoments.count;
+    if (count == 0)
+      {
+      itkExceptionMacro(
+        "Statistics cannot be calculated with zero relevant pixels."
+      );
+      }
+    const double nbValues = static_cast<double>(count) * numberOfComponent;
+
+    RealType componentMean = itk::NumericTraits<RealType>::ZeroValue();
+    for (unsigned int r = 0; r < numberOfComponent; ++r)
+      {
+      componentMean += mean[r];
+      }
+    componentMean /= numberOfComponent;
+
+    this->GetMeanOutput()->Set(mean);
+    this->GetSumOutput()->Set(mean * count);
+    this->GetComponentMeanOutput()->Set(componentMean);
+
+    if (m_EnableSecondOrderStats)
+      {
+      const MatrixType& comoment = streamMoments.comoment;
+
+      double regul = 1.0;
+      double regulComponent = 1.0;
+      if( m_UseUnbiasedEstimator && count > 1 )
+        {
+        regul = static_cast<double>(count) / (static_cast<double>(count) - 1.0);
+        }
+      if( m_UseUnbiasedEstimator && nbValues > 1 )
+        {
+        regulComponent = nbValues / (nbValues - 1.0);
+        }
+
+      MatrixType cov(numberOfComponent, numberOfComponent);
+      MatrixType cor(numberOfComponent, numberOfComponent);
+      // Sums of the squared deviations of all the values to their mean
+      // (the component mean), and of the squared values
+      RealType componentComoment = itk::NumericTraits<RealType>::ZeroValue();
+      RealType componentSquares = itk::NumericTraits<RealType>::ZeroValue();
+      for (unsigned int r = 0; r < numberOfComponent; ++r)
+        {
+        for (unsigned int c = 0; c < numberOfComponent; ++c)
+          {
+          cov(r, c) = regul * comoment(r, c) / count;
+          cor(r, c) = comoment(r, c) / count + mean[r] * mean[c];
+          }
+        const RealType deviation = mean[r] - componentMean;
+        componentComoment += comoment(r, r) + count * deviation * deviation;
+        componentSquares += comoment(r, r) + count * mean[r] * mean[r];
+        }
+
+      this->GetCovarianceOutput()->Set(cov);
+      this->GetCorrelationOutput()->Set(cor);
+      this->GetComponentCorrelationOutput()->Set(componentSquares / nbValues);
+      this->GetComponentCovarianceOutput()->Set(regulComponent * componentComoment / nbValues);
+      }
+    }
+  else if (m_EnableFirstOrderStats)
     {
     this->GetComponentMeanOutput()->Set(streamFirstOrderComponentAccumulator / (nbRelevantPixel * numberOfComponent));
 
@@ -472,7 +616,7 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
     this->GetSumOutput()->Set(streamFirstOrderAccumulator);
     }
 
-  if (m_EnableSecondOrderStats)
+  if (m_EnableSecondOrderStats && !m_UseStableMoments)
     {
     MatrixType cor = streamSecondOrderAccumulator / nbRelevantPixel;
     this->GetCorrelationOutput()->Set(cor);
@@ -514,6 +658,100 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
     }
 }
 
+template<class TInputImage, class TPrecision>
+void
+PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
+::MergeMoments(MomentsType & moments, const MomentsType & other) const
+{
+  if (other.count == 0)
+    {
+    return;
+    }
+  if (moments.count == 0)
+    {
+    moments = other;
+    return;
+    }
+
+  const PrecisionType count = moments.count + other.count;
+  const RealPixelType delta = other.mean - moments.mean;
+
+  if (m_EnableSecondOrderStats)
+    {
+    const PrecisionType weight = moments.count * other.count / count;
+    for (unsigned int r = 0; r < delta.GetSize(); ++r)
+      {
+      for (unsigned int c = 0; c < delta.GetSize(); ++c)
+        {
+        moments.comoment(r, c) += other.comoment(r, c) + weight * delta[r] * delta[c];
+        }
+      }
+    }
+
+  moments.mean += delta * (other.count / count);
+  moments.count = count;
+}
+
+template<class TInputImage, class TPrecision>
+void
+PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
+::AccumulateMoments(MomentsType & moments, const PrecisionType * values, unsigned int count) const
+{
+  if (count == 0)
+    {
+    return;
+    }
+
+  const unsigned int numberOfComponent = moments.mean.GetSize();
+
+  MomentsType block;
+  block.count = count;
+  block.mean.SetSize(numberOfComponent);
+  block.mean.Fill(itk::NumericTraits<PrecisionType>::ZeroValue());
+
+  for (unsigned int k = 0; k < count; ++k)
+    {
+    const PrecisionType * value = values + k * numberOfComponent;
+    for (unsigned int r = 0; r < numberOfComponent; ++r)
+      {
+      block.mean[r] += value[r];
+      }
+    }
+  block.mean /= static_cast<PrecisionType>(count);
+
+  if (m_EnableSecondOrderStats)
+    {
+    // Second pass on the block, still in cache, for the deviations
+    block.comoment.SetSize(numberOfComponent, numberOfComponent);
+    block.comoment.Fill(itk::NumericTraits<PrecisionType>::ZeroValue());
+    std::vector<PrecisionType> deviation(numberOfComponent);
+    for (unsigned int k = 0; k < count; ++k)
+      {
+      const PrecisionType * value = values + k * numberOfComponent;
+      for (unsigned int r = 0; r < numberOfComponent; ++r)
+        {
+        deviation[r] = value[r] - block.mean[r];
+        }
+      for (unsigned int r = 0; r < numberOfComponent; ++r)
+        {
+        for (unsigned int c = r; c < numberOfComponent; ++c)
+          {
+          block.comoment(r, c) += deviation[r] * deviation[c];
+          }
+        }
+      }
+    for (unsigned int r = 0; r < numberOfComponent; ++r)
+      {
+      for (unsigned int c = 0; c < r; ++c)
+        {
+        block.comoment(r, c) = block.comoment(c, r);
+        }
+      }
+    }
+
+  this->MergeMoments(moments, block);
+}
+
 template<class TInputImage, class TPrecision>
 void
 PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
@@ -524,9 +762,40 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
 
   // Grab the input
   InputImagePointer inputPtr = const_cast<TInputImage *>(this->GetInput());
-  PixelType& threadMin  = m_ThreadMin [threadId];
-  PixelType& threadMax  = m_ThreadMax [threadId];
+  const unsigned int numberOfComponent = inputPtr->GetNumberOfComponentsPerPixel();
 
+  // Thread accumulators are copied locally, and written back at the end,
+  // so that threads do not write in the same cache lines
+  PixelType threadMin;
+  PixelType threadMax;
+  if (m_EnableMinMax)
+    {
+    threadMin = m_ThreadMin[threadId];
+    threadMax = m_ThreadMax[threadId];
+    }
+  unsigned int ignoredInfinitePixelCount = 0;
+  unsigned int ignoredUserPixelCount = 0;
+
+  const bool stableMoments = m_EnableFirstOrderStats && m_UseStableMoments;
+  std::vector<PrecisionType> block;
+  unsigned int blockCount = 0;
+  if (stableMoments)
+    {
+    block.resize(MomentsBlockSize * numberOfComponent);
+    }
+
+  CountType histogram;
+  std::vector<PrecisionType> binScale;
+  if (m_EnableHistogram)
+    {
+    histogram = m_ThreadHistograms[threadId];
+    binScale.resize(numberOfComponent);
+    for (unsigned int j = 0; j < numberOfComponent; ++j)
+      {
+      const PrecisionType range = m_HistogramMaximum[j] - m_HistogramMinimum[j];
+      binScale[j] = range > 0 ? m_NumberOfHistogramBins / range : itk::NumericTraits<PrecisionType>::ZeroValue();
+      }
+    }
 
   itk::ImageRegionConstIteratorWithIndex<TInputImage> it(inputPtr, outputRegionForThread);
 
@@ -544,13 +813,13 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
 
     if (m_IgnoreInfiniteValues && !(vnl_math_isfinite(finiteProbe)))
       {
-      m_IgnoredInfinitePixelCount[threadId] ++;
+      ignoredInfinitePixelCount ++;
       }
     else
       {
       if (userProbe)
         {
-        m_IgnoredUserPixelCount[threadId] ++;
+        ignoredUserPixelCount ++;
         }
       else
         {
@@ -569,7 +838,38 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
             }
           }
 
-        if (m_EnableFirstOrderStats)
+        if (m_EnableHistogram)
+          {
+          for (unsigned int j = 0; j < vectorValue.GetSize(); ++j)
+            {
+            const PrecisionType position = (vectorValue[j] - m_HistogramMinimum[j]) * binScale[j];
+            unsigned int bin = 0;
+            if (position >= m_NumberOfHistogramBins)
+              {
+              bin = m_NumberOfHistogramBins - 1;
+              }
+            else if (position > 0)
+              {
+              bin = static_cast<unsigned int>(position);
+              }
+            ++histogram[j * m_NumberOfHistogramBins + bin];
+            }
+          }
+
+        if (stableMoments)
+          {
+          PrecisionType * value = &block[blockCount * numberOfComponent];
+          for (unsigned int j = 0; j < numberOfComponent; ++j)
+            {
+            value[j] = static_cast<PrecisionType>(vectorValue[j]);
+            }
+          if (++blockCount == MomentsBlockSize)
+            {
+            this->AccumulateMoments(m_ThreadMoments[threadId], block.data(), blockCount);
+            blockCount = 0;
+            }
+          }
+        else if (m_EnableFirstOrderStats)
           {
           RealPixelType& threadFirstOrder  = m_ThreadFirstOrderAccumulators [threadId];
           RealType& threadFirstOrderComponent  = m_ThreadFirstOrderComponentAccumulators [threadId];
@@ -582,7 +882,7 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
             }
           }
 
-        if (m_EnableSecondOrderStats)
+        if (m_EnableSecondOrderStats && !stableMoments)
           {
           MatrixType&    threadSecondOrder = m_ThreadSecondOrderAccumulators[threadId];
           RealType& threadSecondOrderComponent = m_ThreadSecondOrderComponentAccumulators[threadId];
@@ -600,6 +900,27 @@ PersistentStreamingStatisticsVectorImageFilter<TInputImage, TPrecision>
       }
     }
 
+  if (stableMoments)
+    {
+    this->AccumulateMoments(m_ThreadMoments[threadId], block.data(), blockCount);
+    }
+  if (m_EnableMinMax)
+    {
+    m_ThreadMin[threadId] = threadMin;
+    m_ThreadMax[threadId] = threadMax;
+    }
+  if (m_EnableHistogram)
+    {
+    m_ThreadHistograms[threadId] = histogram;
+    }
+  if (ignoredInfinitePixelCount > 0)
+    {
+    m_IgnoredInfinitePixelCount[threadId] += ignoredInfinitePixelCount;
+    }
+  if (ignoredUserPixelCount > 0)
+    {
+    m_IgnoredUserPixelCount[threadId] += ignoredUserPixelCount;
+    }
  }
 
 template <class TImage, class TPrecision>
@@ -619,6 +940,8 @@ PersistentStreamingStatisticsVectorImageFilter<TImage, TPrecision>
   os << indent << "Component Covariance: "  << this->GetComponentCovarianceOutput()->Get()  << std::endl;
   os << indent << "Component Correlation: " << this->GetComponentCorrelationOutput()->Get() << std::endl;
   os << indent << "UseUnbiasedEstimator: "  << (this->m_UseUnbiasedEstimator ? "true" : "false")  << std::endl;
+  os << indent << "UseStableMoments: "      << (this->m_UseStableMoments ? "true" : "false")  << std::endl;
+  os << indent << "EnableHistogram: "       << (this->m_EnableHistogram ? "true" : "false")  << std::endl;
 }
 
 } // end namespace otb
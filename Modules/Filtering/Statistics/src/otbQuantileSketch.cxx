@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbQuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace otb
+{
+
+namespace
+{
+// Ratio between the capacities of two consecutive levels
+const double CapacityRatio = 2.0 / 3.0;
+}
+
+QuantileSketch
+::QuantileSketch(unsigned int k)
+  : m_K(std::max(k, 8u)),
+    m_Count(0),
+    m_Minimum(0.),
+    m_Maximum(0.),
+    m_Size(0),
+    m_MaximumSize(0)
+{
+  this->Grow();
+}
+
+size_t
+QuantileSketch
+::GetCapacity(unsigned int level) const
+{
+  const unsigned int depth = m_Levels.size() - level - 1;
+  return 2 * static_cast<size_t>(std::ceil(m_K * std::pow(CapacityRatio, static_cast<double>(depth)))) + 1;
+}
+
+void
+QuantileSketch
+::Grow()
+{
+  m_Levels.push_back(std::vector<double>());
+  m_Offsets.push_back(0);
+  m_MaximumSize = 0;
+  for (unsigned int h = 0; h < m_Levels.size(); ++h)
+    {
+    m_MaximumSize += this->GetCapacity(h);
+    }
+}
+
+void
+QuantileSketch
+::Compress()
+{
+  for (unsigned int h = 0; h < m_Levels.size(); ++h)
+    {
+    if (m_Levels[h].size() >= this->GetCapacity(h))
+      {
+      if (h + 1 >= m_Levels.size())
+        {
+        this->Grow();
+        }
+
+      std::vector<double> & level = m_Levels[h];
+      std::vector<double> & next = m_Levels[h + 1];
+      std::sort(level.begin(), level.end());
+
+      // Promote one value out of two, an odd value stays in the level
+      const size_t promoted = level.size() / 2;
+      const double kept = level.back();
+      const bool odd = (level.size() % 2) == 1;
+      for (size_t i = 0; i < promoted; ++i)
+        {
+        next.push_back(level[2 * i + m_Offsets[h]]);
+        }
+      m_Offsets[h] = 1 - m_Offsets[h];
+      level.clear();
+      if (odd)
+        {
+        level.push_back(kept);
+        }
+
+      m_Size -= promoted;
+      break;
+      }
+    }
+}
+
+void
+QuantileSketch
+::Merge(const QuantileSketch & other)
+{
+  if (other.m_Count == 0)
+    {
+    return;
+    }
+
+  while (m_Levels.size() < other.m_Levels.size())
+    {
+    this->Grow();
+    }
+
+  for (unsigned int h = 0; h < other.m_Levels.size(); ++h)
+    {
+    m_Levels[h].insert(m_Levels[h].end(), other.m_Levels[h].begin(), other.m_Levels[h].end());
+    }
+  m_Size += other.m_Size;
+
+  if (m_Count == 0 || other.m_Minimum < m_Minimum)
+    {
+    m_Minimum = other.m_Minimum;
+    }
+  if (m_Count == 0 || other.m_Maximum > m_Maximum)
+    {
+    m_Maximum = other.m_Maximum;
+    }
+  m_Count += other.m_Count;
+
+  while (m_Size >= m_MaximumSize)
+    {
+    const size_t size = m_Size;
+    this->Compress();
+    if (m_Size == size)
+      {
+      // No level is full: the hierarchy grew during the compression
+      break;
+      }
+    }
+}
+
+void
+QuantileSketch
+::Clear()
+{
+  m_Levels.clear();
+  m_Offsets.clear();
+  m_Count = 0;
+  m_Size = 0;
+  m_Minimum = 0.;
+  m_Maximum = 0.;
+  this->Grow();
+}
+
+double
+QuantileSketch
+::GetQuantile(double q) const
+{
+  return this->GetQuantiles(std::vector<double>(1, q))[0];
+}
+
+std::vector<double>
+QuantileSketch
+::GetQuantiles(const std::vector<double> & q) const
+{
+  std::vector<double> quantiles(q.size(), 0.);
+  if (m_Count == 0)
+    {
+    return quantiles;
+    }
+
+  // Retained values with their weights, sorted by value
+  std::vector<std::pair<double, double> > weighted;
+  weighted.reserve(m_Size);
+  double weight = 1.;
+  for (unsigned int h = 0; h < m_Levels.size(); ++h, weight *= 2.)
+    {
+    for (size_t i = 0; i < m_Levels[h].size(); ++i)
+      {
+      weighted.push_back(std::make_pair(m_Levels[h][i], weight));
+      }
+    }
+  std::sort(weighted.begin(), weighted.end());
+
+  std::vector<double> cumulated(weighted.size());
+  double total = 0.;
+  for (size_t i = 0; i < weighted.size(); ++i)
+    {
+    total += weighted[i].second;
+    cumulated[i] = total;
+    }
+
+  for (size_t k = 0; k < q.size(); ++k)
+    {
+    if (q[k] <= 0.)
+      {
+      quantiles[k] = m_Minimum;
+      }
+    else if (q[k] >= 1.)
+      {
+      quantiles[k] = m_Maximum;
+      }
+    else
+      {
+      const double rank = q[k] * total;
+      const size_t i = std::lower_bound(cumulated.begin(), cumulated.end(), rank) - cumulated.begin();
+      quantiles[k] = weighted[std::min(i, weighted.size() - 1)].first;
+      }
+    }
+  return quantiles;
+}
+
+} // end namespace otb
@@ -39,10 +39,15 @@ void RegisterTests()
   REGISTER_TEST(otbShiftScaleVectorImageFilterTest);
   REGISTER_TEST(otbStreamingCompareImageFilter);
   REGISTER_TEST(otbStreamingStatisticsMapFromLabelImageFilterTest);
+  REGISTER_TEST(otbStreamingStatisticsMapFromLabelImageFilterShards);
   REGISTER_TEST(otbRealAndImaginaryImageToComplexImageFilterTest);
   REGISTER_TEST(otbStreamingStatisticsImageFilter);
   REGISTER_TEST(otbListSampleToBalancedListSampleFilter);
   REGISTER_TEST(otbStreamingStatisticsVectorImageFilter);
+  REGISTER_TEST(otbStreamingStatisticsVectorImageFilterStableMoments);
+  REGISTER_TEST(otbStreamingStatisticsVectorImageFilterAllIgnored);
+  REGISTER_TEST(otbQuantileSketchTest);
+  REGISTER_TEST(otbStreamingQuantilesVectorImageFilter);
   REGISTER_TEST(otbStreamingMinMaxVectorImageFilter);
   REGISTER_TEST(otbListSampleGenerator);
   REGISTER_TEST(otbImaginaryImageToComplexImageFilterTest);
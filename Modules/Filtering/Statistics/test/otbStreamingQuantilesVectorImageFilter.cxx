@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "itkMacro.h"
+
+#include "otbStreamingQuantilesVectorImageFilter.h"
+#include "otbVectorImage.h"
+#include "otbImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+// Rank of a value among sorted values, between 0 and 1
+double Rank(const std::vector<double> & sorted, double value)
+{
+  const size_t lower = std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin();
+  const size_t upper = std::upper_bound(sorted.begin(), sorted.end(), value) - sorted.begin();
+  return 0.5 * (lower + upper) / sorted.size();
+}
+}
+
+int otbQuantileSketchTest(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  // Skewed values, inserted in several sketches then merged
+  std::vector<double> values;
+  std::vector<otb::QuantileSketch> sketches(7, otb::QuantileSketch(200));
+  for (unsigned int i = 0; i < 500000; ++i)
+    {
+    const double value = std::pow(static_cast<double>((i * 7919) % 100003), 2.);
+    values.push_back(value);
+    sketches[i % sketches.size()].Insert(value);
+    }
+  otb::QuantileSketch sketch(200);
+  for (unsigned int k = 0; k < sketches.size(); ++k)
+    {
+    sketch.Merge(sketches[k]);
+    }
+  std::sort(values.begin(), values.end());
+
+  bool fail = false;
+  if (sketch.GetCount() != values.size() || sketch.GetMinimum() != values.front()
+      || sketch.GetMaximum() != values.back())
+    {
+    std::cerr << "Wrong count, minimum or maximum" << std::endl;
+    fail = true;
+    }
+
+  double maxError = 0.;
+  for (double q = 0.01; q < 1.; q += 0.01)
+    {
+    maxError = std::max(maxError, std::abs(Rank(values, sketch.GetQuantile(q)) - q));
+    }
+  std::cout << sketch.GetNumberOfRetainedValues() << " values retained, maximum rank error " << maxError << std::endl;
+
+  if (maxError > 0.01)
+    {
+    std::cerr << "Rank error of the quantiles too large: " << maxError << std::endl;
+    fail = true;
+    }
+  if (sketch.GetNumberOfRetainedValues() > 10 * sketch.GetK())
+    {
+    std::cerr << "Too many values retained: " << sketch.GetNumberOfRetainedValues() << std::endl;
+    fail = true;
+    }
+
+  return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int otbStreamingQuantilesVectorImageFilter(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  typedef otb::VectorImage<float, 2>                             ImageType;
+  typedef otb::Image<unsigned char, 2>                           MaskImageType;
+  typedef otb::StreamingQuantilesVectorImageFilter<ImageType>    FilterType;
+
+  ImageType::RegionType region;
+  region.SetSize(0, 317);
+  region.SetSize(1, 233);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(2);
+  image->Allocate();
+  MaskImageType::Pointer mask = MaskImageType::New();
+  mask->SetRegions(region);
+  mask->Allocate();
+
+  // Only the second band has no-data values (the first band takes the
+  // value 0, which must not be ignored), masked pixels are the left half
+  const float noData = -1.f;
+  std::vector<double> first, second;
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  itk::ImageRegionIteratorWithIndex<MaskImageType> maskIt(mask, region);
+  for (it.GoToBegin(), maskIt.GoToBegin(); !it.IsAtEnd(); ++it, ++maskIt)
+    {
+    const long x = it.GetIndex()[0];
+    const long y = it.GetIndex()[1];
+    ImageType::PixelType pixel(2);
+    pixel[0] = static_cast<float>((x * 31 + y * 17) % 1000) / 10.f;
+    pixel[1] = (x + y) % 5 == 0 ? noData : static_cast<float>(std::exp(0.01 * ((x * y) % 700)));
+    it.Set(pixel);
+    maskIt.Set(x >= 150 ? 1 : 0);
+    if (x >= 150)
+      {
+      first.push_back(pixel[0]);
+      if (pixel[1] != noData)
+        {
+        second.push_back(pixel[1]);
+        }
+      }
+    }
+  std::sort(first.begin(), first.end());
+  std::sort(second.begin(), second.end());
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->GetStreamer()->SetNumberOfLinesStrippedStreaming(10);
+  filter->SetInput(image);
+  filter->SetMaskImage(mask);
+  filter->SetNoDataFlag(true);
+  filter->SetNoDataValue(noData);
+  filter->Update();
+
+  bool fail = false;
+  if (filter->GetSketches().size() != 2 || filter->GetSketches()[0].GetCount() != first.size()
+      || filter->GetSketches()[1].GetCount() != second.size())
+    {
+    std::cerr << "Masked pixels or no-data values should be ignored" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const double q[] = {0.02, 0.5, 0.98};
+  for (unsigned int k = 0; k < 3; ++k)
+    {
+    FilterType::RealPixelType quantiles = filter->GetQuantiles(q[k]);
+    const double error0 = std::abs(Rank(first, quantiles[0]) - q[k]);
+    const double error1 = std::abs(Rank(second, quantiles[1]) - q[k]);
+    std::cout << "Quantile " << q[k] << ": " << quantiles << ", rank errors " << error0 << " " << error1 << std::endl;
+    if (error0 > 0.01 || error1 > 0.01)
+      {
+      std::cerr << "Rank error of quantile " << q[k] << " too large" << std::endl;
+      fail = true;
+      }
+    }
+
+  return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
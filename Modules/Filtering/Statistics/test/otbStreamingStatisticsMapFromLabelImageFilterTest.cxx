@@ -28,6 +28,11 @@
 
 #include "otbStreamingStatisticsMapFromLabelImageFilter.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
 
 template<class InternalVectorPixelType>
 int generic_StreamingStatisticsMapFromLabelImageFilterTest(int itkNotUsed(argc), char * argv[])
@@ -253,3 +258,123 @@ int otbStreamingStatisticsMapFromLabelImageFilterTest(int argc, char * argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbStreamingStatisticsMapFromLabelImageFilterShards(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  typedef otb::VectorImage<float, 2>   VectorImageType;
+  typedef otb::Image<unsigned int, 2>  LabelImageType;
+  typedef otb::StreamingStatisticsMapFromLabelImageFilter<VectorImageType, LabelImageType> FilterType;
+
+  const unsigned int nbComponents = 2;
+  const float noDataValue = -1.f;
+
+  VectorImageType::RegionType region;
+  region.SetSize(0, 401);
+  region.SetSize(1, 257);
+
+  VectorImageType::Pointer image = VectorImageType::New();
+  image->SetNumberOfComponentsPerPixel(nbComponents);
+  image->SetRegions(region);
+  image->Allocate();
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(region);
+  labels->Allocate();
+
+  // Many small segments, and a few labels far from the others
+  std::map<unsigned int, std::vector<std::vector<double> > > values;
+  std::map<unsigned int, double> population;
+  itk::ImageRegionIteratorWithIndex<VectorImageType> it(image, region);
+  itk::ImageRegionIteratorWithIndex<LabelImageType> labelIt(labels, region);
+  for (it.GoToBegin(), labelIt.GoToBegin(); !it.IsAtEnd(); ++it, ++labelIt)
+    {
+    const unsigned int x = it.GetIndex()[0];
+    const unsigned int y = it.GetIndex()[1];
+    unsigned int label = 1 + (y / 3) * 200 + x / 2;
+    if ((x * 7 + y * 13) % 97 == 0)
+      {
+      label = 4000000000u - (x % 5);
+      }
+    VectorImageType::PixelType pixel(nbComponents);
+    pixel[0] = static_cast<float>((x * 31 + y * 17) % 251);
+    pixel[1] = (x + y) % 7 == 0 ? noDataValue : static_cast<float>(x) - static_cast<float>(y);
+    it.Set(pixel);
+    labelIt.Set(label);
+
+    population[label] += 1;
+    values[label].resize(nbComponents);
+    for (unsigned int band = 0; band < nbComponents; ++band)
+      {
+      if (pixel[band] != noDataValue)
+        {
+        values[label][band].push_back(pixel[band]);
+        }
+      }
+    }
+
+  bool fail = false;
+  for (unsigned int dense = 0; dense < 2; ++dense)
+    {
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(image);
+    filter->SetInputLabelImage(labels);
+    filter->SetUseNoDataValue(true);
+    filter->SetNoDataValue(noDataValue);
+    filter->SetComputeMedian(true);
+    if (dense)
+      {
+      filter->SetDenseLabelRange(1, 20000);
+      }
+    filter->GetStreamer()->SetNumberOfLinesStrippedStreaming(20);
+    filter->Update();
+
+    const FilterType::LabelPopulationMapType populationMap = filter->GetLabelPopulationMap();
+    const FilterType::PixelValueMapType meanMap = filter->GetMeanValueMap();
+    const FilterType::PixelValueMapType stdMap = filter->GetStandardDeviationValueMap();
+    const FilterType::PixelValueMapType minMap = filter->GetMinValueMap();
+    const FilterType::PixelValueMapType maxMap = filter->GetMaxValueMap();
+    const FilterType::PixelValueMapType medianMap = filter->GetMedianValueMap();
+
+    if (populationMap != population || filter->GetNumberOfLabels() != population.size()
+        || meanMap.size() != population.size() || medianMap.size() != population.size())
+      {
+      std::cerr << "Wrong labels or populations (dense range: " << dense << ")" << std::endl;
+      fail = true;
+      continue;
+      }
+
+    for (auto const& label: values)
+      {
+      for (unsigned int band = 0; band < nbComponents; ++band)
+        {
+        std::vector<double> v = label.second[band];
+        if (v.size() < 2)
+          {
+          continue;
+          }
+        double sum = 0., sqSum = 0.;
+        for (double value: v)
+          {
+          sum += value;
+          sqSum += value * value;
+          }
+        const double mean = sum / v.size();
+        const double stdDev = std::sqrt((sqSum - sum * mean) / (v.size() - 1));
+        std::sort(v.begin(), v.end());
+
+        const double median = medianMap.at(label.first)[band];
+        if (std::abs(meanMap.at(label.first)[band] - mean) > 1e-9 * (1. + std::abs(mean))
+            || std::abs(stdMap.at(label.first)[band] - stdDev) > 1e-6 * (1. + stdDev)
+            || minMap.at(label.first)[band] != v.front() || maxMap.at(label.first)[band] != v.back()
+            || median < v.front() || median > v.back())
+          {
+          std::cerr << "Wrong statistics for label " << label.first << " band " << band
+                    << " (dense range: " << dense << ")" << std::endl;
+          fail = true;
+          break;
+          }
+        }
+      }
+    }
+
+  return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -25,6 +25,11 @@
 #include "otbVectorImage.h"
 #include <fstream>
 #include "otbStreamingTraits.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 int otbStreamingStatisticsVectorImageFilter(int argc, char * argv[])
 {
@@ -75,3 +80,171 @@ int otbStreamingStatisticsVectorImageFilter(int argc, char * argv[])
 
   return EXIT_SUCCESS;
 }
+
+int otbStreamingStatisticsVectorImageFilterStableMoments(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  typedef otb::VectorImage<double, 2>                          ImageType;
+  typedef otb::StreamingStatisticsVectorImageFilter<ImageType> StreamingStatisticsVectorImageFilterType;
+
+  const unsigned int nbComp = 3;
+  const unsigned int nbBins = 16;
+
+  // Large offset with respect to the dispersion of the values
+  ImageType::RegionType region;
+  region.SetSize(0, 211);
+  region.SetSize(1, 157);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbComp);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    ImageType::PixelType pixel(nbComp);
+    const long x = it.GetIndex()[0];
+    const long y = it.GetIndex()[1];
+    pixel[0] = 1e8 + (x * 7 + y * 3) % 11;
+    pixel[1] = 1e8 + (x * y) % 13 - pixel[0] * 1e-8;
+    pixel[2] = -5e7 + (x + 2 * y) % 5;
+    it.Set(pixel);
+    }
+
+  // Reference statistics, with two passes
+  const double n = region.GetNumberOfPixels();
+  std::vector<long double> mean(nbComp, 0.);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    for (unsigned int r = 0; r < nbComp; ++r)
+      {
+      mean[r] += it.Get()[r];
+      }
+    }
+  for (unsigned int r = 0; r < nbComp; ++r)
+    {
+    mean[r] /= n;
+    }
+  std::vector<long double> cov(nbComp * nbComp, 0.);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    for (unsigned int r = 0; r < nbComp; ++r)
+      {
+      for (unsigned int c = 0; c < nbComp; ++c)
+        {
+        cov[r * nbComp + c] += (it.Get()[r] - mean[r]) * (it.Get()[c] - mean[c]) / (n - 1.);
+        }
+      }
+    }
+
+  StreamingStatisticsVectorImageFilterType::RealPixelType histogramMin(nbComp), histogramMax(nbComp);
+  histogramMin.Fill(1e8);
+  histogramMax.Fill(1e8 + 16);
+  histogramMin[2] = -5e7;
+  histogramMax[2] = -5e7 + 4;
+
+  StreamingStatisticsVectorImageFilterType::Pointer filter = StreamingStatisticsVectorImageFilterType::New();
+  filter->GetStreamer()->SetNumberOfLinesStrippedStreaming(10);
+  filter->SetInput(image);
+  filter->SetUseStableMoments(true);
+  filter->SetEnableHistogram(true);
+  filter->SetNumberOfHistogramBins(nbBins);
+  filter->SetHistogramMinimum(histogramMin);
+  filter->SetHistogramMaximum(histogramMax);
+  filter->Update();
+
+  bool fail = false;
+  for (unsigned int r = 0; r < nbComp; ++r)
+    {
+    if (std::abs(filter->GetMean()[r] - mean[r]) > 1e-5)
+      {
+      std::cerr << "Mean of band " << r << ": " << filter->GetMean()[r] << " instead of " << mean[r] << std::endl;
+      fail = true;
+      }
+    for (unsigned int c = 0; c < nbComp; ++c)
+      {
+      const double expected = cov[r * nbComp + c];
+      if (std::abs(filter->GetCovariance()(r, c) - expected) > 1e-6 * std::max(1., std::abs(expected)))
+        {
+        std::cerr << "Covariance (" << r << ", " << c << "): " << filter->GetCovariance()(r, c)
+                  << " instead of " << expected << std::endl;
+        fail = true;
+        }
+      }
+    }
+
+  // Histograms, with values out of the bounds in the last bin
+  StreamingStatisticsVectorImageFilterType::CountType histogram = filter->GetHistogram();
+  std::vector<unsigned long> expected(nbComp * nbBins, 0);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    for (unsigned int r = 0; r < nbComp; ++r)
+      {
+      const double position = (it.Get()[r] - histogramMin[r]) * nbBins / (histogramMax[r] - histogramMin[r]);
+      const unsigned int bin = position <= 0 ? 0 : std::min(nbBins - 1, static_cast<unsigned int>(position));
+      ++expected[r * nbBins + bin];
+      }
+    }
+  for (unsigned int k = 0; k < nbComp * nbBins; ++k)
+    {
+    if (histogram[k] != expected[k])
+      {
+      std::cerr << "Histogram bin " << k % nbBins << " of band " << k / nbBins << ": " << histogram[k]
+                << " instead of " << expected[k] << std::endl;
+      fail = true;
+      }
+    }
+
+  return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+int otbStreamingStatisticsVectorImageFilterAllIgnored(int itkNotUsed(argc), char * itkNotUsed(argv)[])
+{
+  typedef otb::VectorImage<double, 2>                          ImageType;
+  typedef otb::StreamingStatisticsVectorImageFilter<ImageType> StreamingStatisticsVectorImageFilterType;
+
+  const unsigned int nbComp = 3;
+  const double ignoredValue = -1.;
+
+  ImageType::RegionType region;
+  region.SetSize(0, 53);
+  region.SetSize(1, 37);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbComp);
+  image->Allocate();
+
+  ImageType::PixelType pixel(nbComp);
+  pixel.Fill(ignoredValue);
+  image->FillBuffer(pixel);
+
+  // Every pixel is ignored: both accumulation modes must report it
+  bool fail = false;
+  for (unsigned int stable = 0; stable < 2; ++stable)
+    {
+    StreamingStatisticsVectorImageFilterType::Pointer filter = StreamingStatisticsVectorImageFilterType::New();
+    filter->GetStreamer()->SetNumberOfLinesStrippedStreaming(10);
+    filter->SetInput(image);
+    filter->SetIgnoreUserDefinedValue(true);
+    filter->SetUserIgnoredValue(ignoredValue);
+    filter->SetUseStableMoments(stable == 1);
+
+    try
+      {
+      filter->Update();
+      std::cerr << "No exception with zero relevant pixels (stable moments: " << stable << ")" << std::endl;
+      fail = true;
+      }
+    catch (itk::ExceptionObject & err)
+      {
+      std::cout << "Expected exception (stable moments: " << stable << "): " << err.GetDescription() << std::endl;
+      }
+
+    if (filter->GetNbRelevantPixels()[0] != 0)
+      {
+      std::cerr << "Wrong number of relevant pixels (stable moments: " << stable << ")" << std::endl;
+      fail = true;
+      }
+    }
+
+  return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -43,6 +43,8 @@ namespace otb
  *             - a range of bands : '3:' means 3rd band until the last one
  *                 ':-2' means the first bands until the second to last
  *                 '2:4' means bands 2,3 and 4
+ * - &prefetch : number of regions read ahead in a background thread when
+ *           the image is streamed (0, the default, disables the read-ahead)
  *
  *  \sa ImageFileReader
  *
@@ -76,6 +78,7 @@ public:
     std::pair< bool, bool         >  skipGeom;
     std::pair< bool, bool         >  skipRpcTag;
     std::pair< bool, std::string  >  bandRange;
+    std::pair< bool, unsigned int >  prefetchDepth;
     std::vector<std::string>         optionList;
   };
 
@@ -103,6 +106,9 @@ public:
   /** Test if band range extended filename is set */
   bool BandRangeIsSet () const;
 
+  bool PrefetchDepthIsSet () const;
+  unsigned int GetPrefetchDepth () const;
+
 protected:
   ExtendedFilenameToReaderOptions();
   ~ExtendedFilenameToReaderOptions() override {}
@@ -36,6 +36,11 @@ namespace otb
  * - &writegeom=ON : to activate the creation of an external geom file
  * - &gdal:co:<KEY>=<VALUE> : the gdal creation option <KEY>
  * - streaming modes
+ * - &streaming:writebehind=ON : write streaming divisions from a dedicated I/O thread
+ * - &streaming:iothreads=N : write streaming divisions concurrently from N I/O threads
+ * - &streaming:calibration=ON : measure the memory print instead of estimating it
+ * - &cog=ON : write a Cloud Optimized GeoTIFF, overviews being computed while streaming
+ * - &cog:resampling=average|nearest : how the overviews of a Cloud Optimized GeoTIFF are computed
  * - box
  * See http://wiki.orfeo-toolbox.org/index.php/ExtendedFileName
  *
@@ -73,6 +78,11 @@ public:
     std::pair<bool,  std::string>                streamingType;
     std::pair<bool,  std::string>                streamingSizeMode;
     std::pair<bool,  double>                     streamingSizeValue;
+    std::pair<bool,  bool>                       streamingWriteBehind;
+    std::pair<bool,  unsigned int>               streamingIOThreads;
+    std::pair<bool,  bool>                       streamingCalibration;
+    std::pair<bool,  bool>                       cloudOptimized;
+    std::pair<bool,  std::string>                cloudOptimizedResampling;
     std::pair<bool,  std::string>                box;
     std::pair< bool, std::string>                bandRange;
     std::vector<std::string>                     optionList;
@@ -107,6 +117,16 @@ public:
   std::string GetStreamingSizeMode() const;
   bool StreamingSizeValueIsSet() const;
   double GetStreamingSizeValue() const;
+  bool StreamingWriteBehindIsSet() const;
+  bool GetStreamingWriteBehind() const;
+  bool StreamingIOThreadsIsSet() const;
+  unsigned int GetStreamingIOThreads() const;
+  bool StreamingCalibrationIsSet() const;
+  bool GetStreamingCalibration() const;
+  bool CloudOptimizedIsSet() const;
+  bool GetCloudOptimized() const;
+  bool CloudOptimizedResamplingIsSet() const;
+  std::string GetCloudOptimizedResampling() const;
   std::string GetBandRange () const;
 
   bool BoxIsSet() const;
@@ -52,6 +52,9 @@ ExtendedFilenameToReaderOptions
   m_Options.bandRange.first = false;
   m_Options.bandRange.second = "";
 
+  m_Options.prefetchDepth.first  = false;
+  m_Options.prefetchDepth.second = 0;
+
   m_Options.optionList.push_back("geom");
   m_Options.optionList.push_back("sdataidx");
   m_Options.optionList.push_back("resol");
@@ -59,6 +62,7 @@ ExtendedFilenameToReaderOptions
   m_Options.optionList.push_back("skipgeom");
   m_Options.optionList.push_back("skiprpctag");
   m_Options.optionList.push_back("bands");
+  m_Options.optionList.push_back("prefetch");
 }
 
 void
@@ -155,6 +159,12 @@ ExtendedFilenameToReaderOptions
       }
     }
 
+  if (!map["prefetch"].empty())
+    {
+    m_Options.prefetchDepth.first  = true;
+    m_Options.prefetchDepth.second = atoi(map["prefetch"].c_str());
+    }
+
   //Option Checking
   MapIteratorType it;
   for ( it=map.begin(); it != map.end(); it++ )
@@ -269,4 +279,17 @@ ExtendedFilenameToReaderOptions
   return m_Options.bandRange.second;
 }
 
+bool
+ExtendedFilenameToReaderOptions
+::PrefetchDepthIsSet () const
+{
+  return m_Options.prefetchDepth.first;
+}
+unsigned int
+ExtendedFilenameToReaderOptions
+::GetPrefetchDepth () const
+{
+  return m_Options.prefetchDepth.second;
+}
+
 } // end namespace otb
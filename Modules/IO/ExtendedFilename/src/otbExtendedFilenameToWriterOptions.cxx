@@ -46,6 +46,16 @@ ExtendedFilenameToWriterOptions
   m_Options.streamingType.first       = false;
   m_Options.streamingSizeMode.first   = false;
   m_Options.streamingSizeValue.first  = false;
+  m_Options.streamingWriteBehind.first  = false;
+  m_Options.streamingWriteBehind.second = false;
+  m_Options.streamingIOThreads.first  = false;
+  m_Options.streamingIOThreads.second = 1;
+  m_Options.streamingCalibration.first  = false;
+  m_Options.streamingCalibration.second = false;
+  m_Options.cloudOptimized.first  = false;
+  m_Options.cloudOptimized.second = false;
+  m_Options.cloudOptimizedResampling.first  = false;
+  m_Options.cloudOptimizedResampling.second = "average";
 
   m_Options.bandRange.first = false;
   m_Options.bandRange.second = "";
@@ -53,6 +63,8 @@ ExtendedFilenameToWriterOptions
   m_Options.optionList = {
     "writegeom", "writerpctags",
     "streaming:type", "streaming:sizemode", "streaming:sizevalue",
+    "streaming:writebehind", "streaming:iothreads", "streaming:calibration",
+    "cog", "cog:resampling",
     "nodata",
     "box", "bands"
   };
@@ -161,6 +173,7 @@ ExtendedFilenameToWriterOptions
     {
     if(map["streaming:type"] == "auto"
        || map["streaming:type"] == "tiled"
+       || map["streaming:type"] == "blockaligned"
        || map["streaming:type"] == "stripped"
        || map["streaming:type"] == "none")
       {
@@ -169,7 +182,7 @@ ExtendedFilenameToWriterOptions
       }
     else
       {
-      itkWarningMacro("Unkwown value "<<map["streaming:type"]<<" for streaming:type option. Available values are auto,tiled,stripped.");
+      itkWarningMacro("Unkwown value "<<map["streaming:type"]<<" for streaming:type option. Available values are auto,blockaligned,tiled,stripped,none.");
       }
     }
 
@@ -194,6 +207,68 @@ ExtendedFilenameToWriterOptions
     m_Options.streamingSizeValue.second = atof(map["streaming:sizevalue"].c_str());
     }
 
+  if(!map["streaming:writebehind"].empty())
+    {
+    m_Options.streamingWriteBehind.first = true;
+    if (   map["streaming:writebehind"] == "On"
+        || map["streaming:writebehind"] == "on"
+        || map["streaming:writebehind"] == "ON"
+        || map["streaming:writebehind"] == "true"
+        || map["streaming:writebehind"] == "True"
+        || map["streaming:writebehind"] == "1"   )
+      {
+      m_Options.streamingWriteBehind.second = true;
+      }
+    }
+
+  if(!map["streaming:iothreads"].empty())
+    {
+    m_Options.streamingIOThreads.first = true;
+    m_Options.streamingIOThreads.second = atoi(map["streaming:iothreads"].c_str());
+    }
+
+  if(!map["streaming:calibration"].empty())
+    {
+    m_Options.streamingCalibration.first = true;
+    if (   map["streaming:calibration"] == "On"
+        || map["streaming:calibration"] == "on"
+        || map["streaming:calibration"] == "ON"
+        || map["streaming:calibration"] == "true"
+        || map["streaming:calibration"] == "True"
+        || map["streaming:calibration"] == "1"   )
+      {
+      m_Options.streamingCalibration.second = true;
+      }
+    }
+
+  if(!map["cog"].empty())
+    {
+    m_Options.cloudOptimized.first = true;
+    if (   map["cog"] == "On"
+        || map["cog"] == "on"
+        || map["cog"] == "ON"
+        || map["cog"] == "true"
+        || map["cog"] == "True"
+        || map["cog"] == "1"   )
+      {
+      m_Options.cloudOptimized.second = true;
+      }
+    }
+
+  if(!map["cog:resampling"].empty())
+    {
+    if(map["cog:resampling"] == "average"
+       || map["cog:resampling"] == "nearest")
+      {
+      m_Options.cloudOptimizedResampling.first = true;
+      m_Options.cloudOptimizedResampling.second = map["cog:resampling"];
+      }
+    else
+      {
+      itkWarningMacro("Unkwown value "<<map["cog:resampling"]<<" for cog:resampling option. Available values are average,nearest.");
+      }
+    }
+
   //Manage region size to write in output image
   if(!map["box"].empty())
     {
@@ -351,6 +426,76 @@ ExtendedFilenameToWriterOptions
   return m_Options.streamingSizeValue.second;
 }
 
+bool
+ExtendedFilenameToWriterOptions
+::StreamingWriteBehindIsSet() const
+{
+  return m_Options.streamingWriteBehind.first;
+}
+
+bool
+ExtendedFilenameToWriterOptions
+::GetStreamingWriteBehind() const
+{
+  return m_Options.streamingWriteBehind.second;
+}
+
+bool
+ExtendedFilenameToWriterOptions
+::StreamingIOThreadsIsSet() const
+{
+  return m_Options.streamingIOThreads.first;
+}
+
+unsigned int
+ExtendedFilenameToWriterOptions
+::GetStreamingIOThreads() const
+{
+  return m_Options.streamingIOThreads.second;
+}
+
+bool
+ExtendedFilenameToWriterOptions
+::StreamingCalibrationIsSet() const
+{
+  return m_Options.streamingCalibration.first;
+}
+
+bool
+ExtendedFilenameToWriterOptions
+::GetStreamingCalibration() const
+{
+  return m_Options.streamingCalibration.second;
+}
+
+bool
+ExtendedFilenameToWriterOptions
+::CloudOptimizedIsSet() const
+{
+  return m_Options.cloudOptimized.first;
+}
+
+bool
+ExtendedFilenameToWriterOptions
+::GetCloudOptimized() const
+{
+  return m_Options.cloudOptimized.second;
+}
+
+bool
+ExtendedFilenameToWriterOptions
+::CloudOptimizedResamplingIsSet() const
+{
+  return m_Options.cloudOptimizedResampling.first;
+}
+
+std::string
+ExtendedFilenameToWriterOptions
+::GetCloudOptimizedResampling() const
+{
+  return m_Options.cloudOptimizedResampling.second;
+}
+
 bool
 ExtendedFilenameToWriterOptions
 ::BoxIsSet() const
@@ -0,0 +1,352 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbVectorImage.h"
+#include "otbImageFileWriter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include "gdal_priv.h"
+#include "cpl_vsi.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace
+{
+typedef unsigned short ValueType;
+
+/** Level of the reference pyramid, pixels being interleaved */
+struct ReferenceLevel
+{
+  unsigned int width;
+  unsigned int height;
+  std::vector<ValueType> values;
+};
+
+/** Averages the blocks of 2x2 pixels of a level, the partial blocks of
+ * the right and bottom borders over the pixels available */
+ReferenceLevel ReduceLevel(const ReferenceLevel & input, unsigned int nbBands)
+{
+  ReferenceLevel output;
+  output.width = (input.width + 1) / 2;
+  output.height = (input.height + 1) / 2;
+  output.values.resize(static_cast<size_t>(output.width) * output.height * nbBands);
+  for (unsigned int y = 0; y < output.height; ++y)
+    {
+    for (unsigned int x = 0; x < output.width; ++x)
+      {
+      for (unsigned int b = 0; b < nbBands; ++b)
+        {
+        double sum = 0.;
+        unsigned int count = 0;
+        for (unsigned int j = 2 * y; j < std::min(2 * y + 2, input.height); ++j)
+          {
+          for (unsigned int i = 2 * x; i < std::min(2 * x + 2, input.width); ++i)
+            {
+            sum += input.values[(static_cast<size_t>(j) * input.width + i) * nbBands + b];
+            ++count;
+            }
+          }
+        output.values[(static_cast<size_t>(y) * output.width + x) * nbBands + b] =
+          static_cast<ValueType>(std::floor(sum / count + 0.5));
+        }
+      }
+    }
+  return output;
+}
+
+/** Reads an unsigned integer stored on nbBytes with the byte order of the file */
+unsigned long long ReadTiffValue(std::istream & is, unsigned int nbBytes, bool littleEndian)
+{
+  unsigned char bytes[8] = {0};
+  is.read(reinterpret_cast<char *>(bytes), nbBytes);
+  unsigned long long value = 0;
+  for (unsigned int i = 0; i < nbBytes; ++i)
+    {
+    const unsigned int shift = 8 * (littleEndian ? i : nbBytes - 1 - i);
+    value |= static_cast<unsigned long long>(bytes[i]) << shift;
+    }
+  return value;
+}
+
+/** Gets the size of the TIFF header and the offsets of the IFDs, in the
+ * order of the IFD chain */
+bool ReadTiffStructure(const std::string & filename, unsigned long long & headerSize,
+                       std::vector<unsigned long long> & ifdOffsets)
+{
+  std::ifstream is(filename.c_str(), std::ios::binary);
+  char byteOrder[2];
+  is.read(byteOrder, 2);
+  const bool littleEndian = (byteOrder[0] == 'I');
+  const bool bigTiff = (ReadTiffValue(is, 2, littleEndian) == 43);
+  if (bigTiff)
+    {
+    // Size of the offsets and padding
+    ReadTiffValue(is, 4, littleEndian);
+    }
+  headerSize = bigTiff ? 16 : 8;
+
+  const unsigned int offsetSize = bigTiff ? 8 : 4;
+  const unsigned int countSize = bigTiff ? 8 : 2;
+  const unsigned int entrySize = bigTiff ? 20 : 12;
+
+  unsigned long long offset = ReadTiffValue(is, offsetSize, littleEndian);
+  while (is && offset != 0 && ifdOffsets.size() < 64)
+    {
+    ifdOffsets.push_back(offset);
+    is.seekg(offset);
+    const unsigned long long nbEntries = ReadTiffValue(is, countSize, littleEndian);
+    is.seekg(offset + countSize + nbEntries * entrySize);
+    offset = ReadTiffValue(is, offsetSize, littleEndian);
+    }
+  return static_cast<bool>(is) && offset == 0;
+}
+
+/** Gets the smallest and largest offsets of the tiles of a band */
+void GetTileOffsets(GDALRasterBand * band, unsigned long long & minOffset, unsigned long long & maxOffset)
+{
+  int blockWidth = 0, blockHeight = 0;
+  band->GetBlockSize(&blockWidth, &blockHeight);
+  const int nbBlocksX = (band->GetXSize() + blockWidth - 1) / blockWidth;
+  const int nbBlocksY = (band->GetYSize() + blockHeight - 1) / blockHeight;
+
+  minOffset = std::numeric_limits<unsigned long long>::max();
+  maxOffset = 0;
+  for (int y = 0; y < nbBlocksY; ++y)
+    {
+    for (int x = 0; x < nbBlocksX; ++x)
+      {
+      const char * item = band->GetMetadataItem(CPLSPrintf("BLOCK_OFFSET_%d_%d", x, y), "TIFF");
+      if (item != nullptr)
+        {
+        const unsigned long long offset = std::strtoull(item, nullptr, 10);
+        minOffset = std::min(minOffset, offset);
+        maxOffset = std::max(maxOffset, offset);
+        }
+      }
+    }
+}
+
+/** Compares the bands of a GDAL dataset or overview to a reference level */
+bool CheckLevel(const std::vector<GDALRasterBand *> & bands, const ReferenceLevel & reference, unsigned int level)
+{
+  const unsigned int nbBands = static_cast<unsigned int>(bands.size());
+  std::vector<ValueType> values(reference.values.size());
+  for (unsigned int b = 0; b < nbBands; ++b)
+    {
+    if (static_cast<unsigned int>(bands[b]->GetXSize()) != reference.width
+        || static_cast<unsigned int>(bands[b]->GetYSize()) != reference.height)
+      {
+      std::cerr << "Level " << level << " is " << bands[b]->GetXSize() << "x" << bands[b]->GetYSize()
+                << " instead of " << reference.width << "x" << reference.height << std::endl;
+      return false;
+      }
+    if (bands[b]->RasterIO(GF_Read, 0, 0, reference.width, reference.height,
+                           values.data() + b, reference.width, reference.height, GDT_UInt16,
+                           sizeof(ValueType) * nbBands, sizeof(ValueType) * nbBands * reference.width) != CE_None)
+      {
+      std::cerr << "Cannot read level " << level << " of band " << b + 1 << std::endl;
+      return false;
+      }
+    }
+
+  for (size_t i = 0; i < values.size(); ++i)
+    {
+    if (values[i] != reference.values[i])
+      {
+      const size_t pixel = i / nbBands;
+      std::cerr << "Level " << level << ", pixel (" << pixel % reference.width << ", " << pixel / reference.width
+                << "), band " << i % nbBands + 1 << ": " << values[i] << " instead of " << reference.values[i]
+                << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int otbImageFileWriterCloudOptimized(int itkNotUsed(argc), char* argv[])
+{
+  const std::string outputFilename = argv[1];
+
+  typedef otb::VectorImage<ValueType, 2>  ImageType;
+  typedef otb::ImageFileWriter<ImageType> WriterType;
+
+  // Odd sizes larger than 512 pixels, so that the borders hold partial blocks
+  const unsigned int width = 1101;
+  const unsigned int height = 1301;
+  const unsigned int nbBands = 2;
+
+  ImageType::RegionType region;
+  region.SetSize(0, width);
+  region.SetSize(1, height);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetNumberOfComponentsPerPixel(nbBands);
+  image->Allocate();
+
+  std::vector<ReferenceLevel> reference(1);
+  reference[0].width = width;
+  reference[0].height = height;
+  reference[0].values.reserve(static_cast<size_t>(width) * height * nbBands);
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  ImageType::PixelType pixel(nbBands);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+    for (unsigned int b = 0; b < nbBands; ++b)
+      {
+      pixel[b] = (it.GetIndex()[0] * 7 + it.GetIndex()[1] * 13 + it.GetIndex()[0] * it.GetIndex()[1] + b * 1000) % 4093;
+      reference[0].values.push_back(pixel[b]);
+      }
+    it.Set(pixel);
+    }
+
+  // Overviews are added until the smallest one fits in 512 pixels
+  while (reference.back().width > 512 || reference.back().height > 512)
+    {
+    reference.push_back(ReduceLevel(reference.back(), nbBands));
+    }
+  const int expectedNbOverviews = static_cast<int>(reference.size()) - 1;
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(image);
+  writer->SetFileName(outputFilename + "?&cog=ON&cog:resampling=average&streaming:type=stripped"
+                      "&streaming:sizemode=nbsplits&streaming:sizevalue=7&gdal:co:COMPRESS=DEFLATE");
+  writer->Update();
+
+  VSIStatBufL stat;
+  if (VSIStatL((outputFilename + ".tmp.tif").c_str(), &stat) == 0)
+    {
+    std::cerr << "The temporary file " << outputFilename << ".tmp.tif was not removed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  GDALAllRegister();
+  GDALDataset * dataset = static_cast<GDALDataset *>(GDALOpen(outputFilename.c_str(), GA_ReadOnly));
+  if (dataset == nullptr)
+    {
+    std::cerr << "Cannot open " << outputFilename << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  bool ok = (dataset->GetRasterCount() == static_cast<int>(nbBands));
+  if (!ok)
+    {
+    std::cerr << dataset->GetRasterCount() << " bands instead of " << nbBands << std::endl;
+    }
+
+  // Number of overviews and content of each level
+  for (unsigned int b = 0; ok && b < nbBands; ++b)
+    {
+    if (dataset->GetRasterBand(b + 1)->GetOverviewCount() != expectedNbOverviews)
+      {
+      std::cerr << "Band " << b + 1 << " has " << dataset->GetRasterBand(b + 1)->GetOverviewCount()
+                << " overviews instead of " << expectedNbOverviews << std::endl;
+      ok = false;
+      }
+    }
+  for (unsigned int level = 0; ok && level < reference.size(); ++level)
+    {
+    std::vector<GDALRasterBand *> bands;
+    for (unsigned int b = 0; b < nbBands; ++b)
+      {
+      GDALRasterBand * band = dataset->GetRasterBand(b + 1);
+      bands.push_back(level == 0 ? band : band->GetOverview(level - 1));
+      }
+    ok = CheckLevel(bands, reference[level], level);
+    }
+
+  // Layout: IFDs first, then the overview tiles, then the full resolution
+  // tiles
+  unsigned long long fullResolutionMin = 0, fullResolutionMax = 0;
+  unsigned long long overviewsMin = std::numeric_limits<unsigned long long>::max(), overviewsMax = 0;
+  for (unsigned int b = 0; ok && b < nbBands; ++b)
+    {
+    GDALRasterBand * band = dataset->GetRasterBand(b + 1);
+    unsigned long long minOffset = 0, maxOffset = 0;
+    GetTileOffsets(band, minOffset, maxOffset);
+    fullResolutionMin = (b == 0) ? minOffset : std::min(fullResolutionMin, minOffset);
+    fullResolutionMax = std::max(fullResolutionMax, maxOffset);
+    for (int level = 0; level < expectedNbOverviews; ++level)
+      {
+      GetTileOffsets(band->GetOverview(level), minOffset, maxOffset);
+      overviewsMin = std::min(overviewsMin, minOffset);
+      overviewsMax = std::max(overviewsMax, maxOffset);
+      }
+    }
+  GDALClose(dataset);
+
+  if (ok && (fullResolutionMax == 0 || overviewsMax == 0))
+    {
+    std::cerr << "Tile offsets are not available" << std::endl;
+    ok = false;
+    }
+  if (ok && overviewsMax >= fullResolutionMin)
+    {
+    std::cerr << "Overview tiles (up to offset " << overviewsMax << ") are not written before the full resolution tiles"
+              << " (from offset " << fullResolutionMin << ")" << std::endl;
+    ok = false;
+    }
+
+  unsigned long long headerSize = 0;
+  std::vector<unsigned long long> ifdOffsets;
+  if (ok && !ReadTiffStructure(outputFilename, headerSize, ifdOffsets))
+    {
+    std::cerr << "Cannot read the IFDs of " << outputFilename << std::endl;
+    ok = false;
+    }
+  if (ok && ifdOffsets.size() != reference.size())
+    {
+    std::cerr << ifdOffsets.size() << " IFDs instead of " << reference.size() << std::endl;
+    ok = false;
+    }
+  if (ok && *std::max_element(ifdOffsets.begin(), ifdOffsets.end()) >= std::min(overviewsMin, fullResolutionMin))
+    {
+    std::cerr << "The IFDs are not written before the tiles" << std::endl;
+    ok = false;
+    }
+
+#if GDAL_VERSION_NUM >= GDAL_COMPUTE_VERSION(3,1,0)
+  // Since GDAL 3.1, a ghost header describing the layout follows the
+  // TIFF header, before the first IFD
+  if (ok)
+    {
+    const std::string ghostHeaderKey = "GDAL_STRUCTURAL_METADATA_SIZE=";
+    std::ifstream is(outputFilename.c_str(), std::ios::binary);
+    std::string ghostHeader(ghostHeaderKey.size(), '\0');
+    is.seekg(headerSize);
+    is.read(&ghostHeader[0], ghostHeader.size());
+    if (ghostHeader != ghostHeaderKey || ifdOffsets.front() <= headerSize + ghostHeaderKey.size())
+      {
+      std::cerr << "The ghost header is not found after the TIFF header" << std::endl;
+      ok = false;
+      }
+    }
+#endif
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
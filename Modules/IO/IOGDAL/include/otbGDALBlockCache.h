@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbGDALBlockCache_h
+#define otbGDALBlockCache_h
+
+#include "itkSimpleFastMutexLock.h"
+
+#include "OTBIOGDALExport.h"
+
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace otb
+{
+
+/** \class GDALBlockCache
+ *
+ * \brief Process-wide cache of the blocks decoded by GDALImageIO
+ *
+ * GDAL keeps a cache of decoded blocks per dataset handle, so that two
+ * readers of the same file, in two applications chained in memory for
+ * instance, decode the same blocks twice. This cache is shared by all
+ * the GDALImageIO instances of the process: blocks are stored in the
+ * data type of the file, one band at a time, and identified by the
+ * dataset name, the overview level, the band and the block position.
+ *
+ * The cache is bounded in size: the least recently used blocks are
+ * evicted first. Entries are spread over several stripes, each with a
+ * lock of its own, so that concurrent readers rarely wait for each
+ * other.
+ *
+ * The capacity is set from the OTB_BLOCK_CACHE_SIZE environment
+ * variable (see ConfigurationManager::GetBlockCacheSize()). A null
+ * capacity disables the cache.
+ *
+ * \sa GDALImageIO
+ *
+ * \ingroup OTBIOGDAL
+ */
+class OTBIOGDAL_EXPORT GDALBlockCache
+{
+public:
+  /** Identification of a decoded block */
+  struct BlockKey
+  {
+    BlockKey() : overview(0), band(0), blockX(0), blockY(0) {}
+    BlockKey(const std::string & name, int ovr, int b, int bx, int by)
+      : dataset(name), overview(ovr), band(b), blockX(bx), blockY(by) {}
+
+    bool operator<(const BlockKey & k) const
+    {
+      if (blockX != k.blockX) return blockX < k.blockX;
+      if (blockY != k.blockY) return blockY < k.blockY;
+      if (band != k.band) return band < k.band;
+      if (overview != k.overview) return overview < k.overview;
+      return dataset < k.dataset;
+    }
+
+    /** Name of the dataset (file or subdataset) */
+    std::string dataset;
+    /** Overview level, 0 for the full resolution */
+    int overview;
+    /** Band, starting at 1 */
+    int band;
+    int blockX;
+    int blockY;
+  };
+
+  typedef std::vector<unsigned char>           BlockDataType;
+  typedef std::shared_ptr<const BlockDataType> BlockPointerType;
+
+  // GetInstance returns a reference to the unique GDALBlockCache
+  static GDALBlockCache& GetInstance();
+
+  /** Look for a block. Returns a null pointer if it is not cached. The
+   *  block data stays valid as long as the returned pointer is held,
+   *  even if the block is evicted in the meantime. This method is
+   *  thread-safe. */
+  BlockPointerType Get(const BlockKey & key);
+
+  /** Store a block, evicting the least recently used blocks if needed.
+   *  This method is thread-safe. */
+  void Insert(const BlockKey & key, const BlockPointerType & block);
+
+  /** Remove all the blocks of a dataset, for instance when the file is
+   *  overwritten */
+  void Invalidate(const std::string & dataset);
+
+  /** Remove all the blocks */
+  void Clear();
+
+  /** Set the capacity of the cache in bytes, 0 disables the cache */
+  void SetCapacity(unsigned long long capacity);
+  unsigned long long GetCapacity() const;
+
+  /** True if the capacity is not null */
+  bool IsEnabled() const;
+
+  /** Size of the blocks currently cached, in bytes */
+  unsigned long long GetSize() const;
+
+  /** Number of blocks found in the cache */
+  unsigned long long GetNumberOfHits() const;
+
+  /** Number of blocks not found in the cache */
+  unsigned long long GetNumberOfMisses() const;
+
+  /** Reset the hit and miss counters */
+  void ResetCounters();
+
+  /** Number of stripes, each with a lock and an LRU list of its own */
+  static const unsigned int NumberOfStripes = 16;
+
+private:
+  // private constructor so that this class is allocated only inside GetInstance
+  GDALBlockCache();
+  ~GDALBlockCache();
+
+  GDALBlockCache(const GDALBlockCache &) = delete;
+  void operator =(const GDALBlockCache &) = delete;
+
+  struct Entry
+  {
+    BlockKey         key;
+    BlockPointerType block;
+  };
+
+  typedef std::list<Entry>                            EntryListType;
+  typedef std::map<BlockKey, EntryListType::iterator> EntryMapType;
+
+  /** Part of the cache protected by a single lock */
+  struct Stripe
+  {
+    Stripe() : capacity(0), size(0), hits(0), misses(0) {}
+
+    /** Entries, from the most to the least recently used */
+    EntryListType                    entries;
+    EntryMapType                     index;
+    unsigned long long               capacity;
+    unsigned long long               size;
+    unsigned long long               hits;
+    unsigned long long               misses;
+    mutable itk::SimpleFastMutexLock lock;
+  };
+
+  /** Stripe in charge of a block */
+  Stripe & GetStripe(const BlockKey & key);
+
+  /** Remove the least recently used entries of a stripe until it fits
+   *  in its capacity (lock must be held) */
+  static void EvictUnsafe(Stripe & stripe);
+
+  Stripe m_Stripes[NumberOfStripes];
+}; // end of GDALBlockCache
+
+} // end namespace otb
+
+#endif // otbGDALBlockCache_h
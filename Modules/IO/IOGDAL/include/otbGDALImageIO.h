@@ -28,6 +28,7 @@
 
 /* ITK Libraries */
 #include "otbImageIOBase.h"
+#include "itkMutexLock.h"
 
 #include "OTBIOGDALExport.h"
 
@@ -35,6 +36,8 @@ namespace otb
 {
 class GDALDatasetWrapper;
 class GDALDataTypeWrapper;
+class GDALReadAheadCache;
+class GDALTiffDirectWriter;
 
 /** \class GDALImageIO
  *
@@ -62,7 +65,9 @@ class GDALDataTypeWrapper;
  * physical space as GDAL physical space : a given point of
  * image has the same physical location in OTB and in GDAL.
  *
- * The streaming read is implemented.
+ * The streaming read is implemented. When the image is streamed, the
+ * next regions can be read ahead in a background thread (see
+ * SetPrefetchDepth).
  *
  * \ingroup IOFilters
  *
@@ -109,6 +114,44 @@ public:
   itkSetMacro(WriteRPCTags,bool);
   itkGetMacro(WriteRPCTags,bool);
 
+  /** Set/Get the number of regions read ahead in a background thread,
+   *  extrapolated from the regions previously requested. Background reads
+   *  are aligned on the internal blocks of the dataset. 0 disables the
+   *  read-ahead. This value can also be set with the PrefetchDepth
+   *  metadata key (see the &prefetch extended filename option). */
+  itkSetMacro(PrefetchDepth, unsigned int);
+  itkGetMacro(PrefetchDepth, unsigned int);
+
+  /** Set/Get whether the output file is laid out so that regions can be
+   *  written concurrently with WriteRegion(). Only GeoTIFF files support
+   *  it: they are then written uncompressed, tiled and pixel interleaved,
+   *  whatever the creation options. */
+  itkSetMacro(ConcurrentWriting, bool);
+  itkGetMacro(ConcurrentWriting, bool);
+  itkBooleanMacro(ConcurrentWriting);
+
+  /** Set/Get the number of overviews written along with the image, with
+   *  WriteOverview(). Overview k is decimated by WrittenOverviewsFactor^k
+   *  and has ceil(size / WrittenOverviewsFactor^k) pixels along each
+   *  dimension. They are allocated when the image information is written,
+   *  and the file is closed once the image and all the overviews are
+   *  written. */
+  itkSetMacro(NumberOfWrittenOverviews, unsigned int);
+  itkGetMacro(NumberOfWrittenOverviews, unsigned int);
+  itkSetMacro(WrittenOverviewsFactor, unsigned int);
+  itkGetMacro(WrittenOverviewsFactor, unsigned int);
+
+  /** Set/Get whether a Cloud Optimized GeoTIFF is written. The image and
+   *  its overviews are then written in a temporary, tiled and uncompressed
+   *  GeoTIFF next to the output file. When the file is closed, GDAL reads
+   *  this temporary file back to copy it, with its overviews ahead of the
+   *  full resolution data, then the temporary file is removed. The
+   *  temporary file holds about 4/3 of the uncompressed image size, which
+   *  is usually more than the compressed output. */
+  itkSetMacro(CloudOptimized, bool);
+  itkGetMacro(CloudOptimized, bool);
+  itkBooleanMacro(CloudOptimized);
+
   
   /** Set/Get the options */
   void SetOptions(const GDALCreationOptionsType& opts)
@@ -180,6 +223,29 @@ public:
    * that the IORegion has been set properly. */
   void Write(const void* buffer) override;
 
+  /** Returns true if ConcurrentWriting is on and the file is a GeoTIFF */
+  bool CanWriteRegionsConcurrently() override;
+
+  /** Writes a region at its offsets in the file, without going through
+   *  GDAL. Several threads can call this method at the same time, on
+   *  regions which do not overlap. */
+  void WriteRegion(const itk::ImageIORegion & region, const void* buffer) override;
+
+  /** Returns true if overviews can be written along with the image: the
+   *  file must be a GeoTIFF written in streaming, regions not being
+   *  written concurrently */
+  bool CanWriteOverviews();
+
+  /** Writes a region of an overview (starting at 1), in the same layout
+   *  as the buffers passed to Write(). The regions of the image and of
+   *  the overviews can be written in any order. */
+  void WriteOverview(unsigned int overview, const itk::ImageIORegion & region, const void* buffer);
+
+  /** Stops the writing of a Cloud Optimized GeoTIFF before its end, after
+   *  an error or an abort: the temporary file is closed and removed
+   *  without being copied. Does nothing if no such file is being written. */
+  void DiscardCloudOptimizedWriting();
+
   /** Get all resolutions possible from the file dimensions */
   bool GetAvailableResolutions(std::vector<unsigned int>& res);
 
@@ -196,6 +262,12 @@ public:
   /** Get description about overviews available into the file specified */
   std::vector<std::string> GetOverviewsInfo() override;
 
+  /** Get the largest resolution factor k, with 2^k lower than or equal
+   *  to decimation, matching an overview exposed by GDAL. JPEG2000
+   *  resolution levels are exposed as overviews by the GDAL drivers.
+   *  Unlike GetOverviewsCount(), implicit overviews are not considered. */
+  unsigned int GetNativeResolutionFactor(unsigned int decimation) override;
+
   /** Returns gdal pixel type as string */
   std::string GetGdalPixelTypeAsString() const;
 
@@ -239,6 +311,14 @@ private:
 
   std::string FilenameToGdalDriverShortName(const std::string& name) const;
 
+  /** Name of the temporary file written when CloudOptimized is on */
+  std::string GetCloudOptimizedTemporaryFileName() const;
+
+  /** Close the written dataset, once the image and its overviews are
+   *  written. With CloudOptimized on, the temporary file is copied to
+   *  the output file, then removed. */
+  void CloseWrittenDataset();
+
   /** Parse a GML box from a Jpeg2000 file and get the origin */
   bool GetOriginFromGMLBox(std::vector<double> &origin);
   
@@ -247,6 +327,11 @@ private:
    */
   bool CreationOptionContains(std::string partialOption) const;
 
+  /** Read a region of the current resolution through the process-wide
+   *  GDALBlockCache, in the nominal buffer layout. Returns false if the
+   *  region can not be read this way. */
+  bool ReadFromBlockCache(unsigned char * buffer, int x, int y, int width, int height);
+
   /** GDAL parameters. */
   typedef itk::SmartPointer<GDALDatasetWrapper> GDALDatasetWrapperPointer;
   GDALDatasetWrapperPointer m_Dataset;
@@ -297,7 +382,36 @@ private:
 
 
   NoDataListType m_NoDataList;
-  
+
+  /** Number of regions read ahead */
+  unsigned int m_PrefetchDepth;
+
+  /** Background reader, created on the first streamed read */
+  itk::SmartPointer<GDALReadAheadCache> m_ReadAheadCache;
+
+  /** Whether regions are written concurrently */
+  bool m_ConcurrentWriting;
+
+  /** Writer used by WriteRegion(), created on the first call */
+  itk::SmartPointer<GDALTiffDirectWriter> m_DirectWriter;
+
+  /** Number of pixels written by WriteRegion() */
+  unsigned long long m_NumberOfPixelsWritten;
+
+  /** Overviews written with WriteOverview() */
+  unsigned int m_NumberOfWrittenOverviews;
+  unsigned int m_WrittenOverviewsFactor;
+
+  /** Number of overview pixels not written yet */
+  unsigned long long m_NumberOfPendingOverviewPixels;
+
+  /** Whether the last region of the image was written by Write() */
+  bool m_ImageWritten;
+
+  /** Whether a Cloud Optimized GeoTIFF is written */
+  bool m_CloudOptimized;
+
+  itk::SimpleMutexLock m_ConcurrentWritingMutex;
 };
 
 } // end namespace otb
@@ -31,6 +31,7 @@
 
 #include "OTBIOGDALExport.h"
 #include <string>
+#include <vector>
 
 namespace otb
 {
@@ -181,6 +182,14 @@ private:
 
   void OpenDataset( const std::string & filename );
 
+  /**
+   * \brief Compute the overviews in a single pass over the image, each
+   * level being reduced from the previous one (see PyramidCascade).
+   * Returns false if the overviews of the dataset can not be computed
+   * this way, in which case nothing is written.
+   */
+  bool BuildOverviewsInCascade( std::vector< int > & factors );
+
 
   GDALDatasetWrapper::Pointer m_GDALDataset;
   std::string m_InputFileName;
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbGDALReadAheadCache_h
+#define otbGDALReadAheadCache_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkMultiThreader.h"
+#include "itkMutexLock.h"
+#include "itkConditionVariable.h"
+
+#include "OTBIOGDALExport.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+namespace otb
+{
+
+class GDALDatasetWrapper;
+
+/** \class GDALReadAheadCache
+ *  \brief Background read-ahead of the next regions requested to GDALImageIO
+ *
+ * When a pipeline is streamed, the regions requested to the reader
+ * follow a regular pattern (strips or tiles of constant size). This
+ * class records the requested windows, extrapolates the next ones and
+ * reads them in a background thread, through a dataset handle of its
+ * own, into a bounded set of buffers. The next call to Fetch() is then
+ * served from memory.
+ *
+ * Background reads are expanded to the internal block grid of the
+ * dataset, so that a block shared by two consecutive regions is only
+ * decoded once.
+ *
+ * Buffers are pixel interleaved, with all bands read, which is the
+ * nominal layout used by GDALImageIO::Read().
+ *
+ * \sa GDALImageIO
+ *
+ * \ingroup OTBIOGDAL
+ */
+class OTBIOGDAL_EXPORT GDALReadAheadCache : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef GDALReadAheadCache            Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(GDALReadAheadCache, itk::Object);
+
+  /** A window in the raster, in pixels */
+  struct Window
+  {
+    Window() : x(0), y(0), width(0), height(0) {}
+    Window(int px, int py, int w, int h) : x(px), y(py), width(w), height(h) {}
+
+    bool Contains(const Window & w) const
+    {
+      return w.x >= x && w.y >= y
+        && w.x + w.width <= x + width
+        && w.y + w.height <= y + height;
+    }
+
+    bool IsEmpty() const
+    {
+      return width <= 0 || height <= 0;
+    }
+
+    bool operator==(const Window & w) const
+    {
+      return x == w.x && y == w.y && width == w.width && height == w.height;
+    }
+
+    int x;
+    int y;
+    int width;
+    int height;
+  };
+
+  typedef std::vector<Window> WindowListType;
+
+  /** Set/Get the number of windows read ahead */
+  itkSetMacro(Depth, unsigned int);
+  itkGetConstMacro(Depth, unsigned int);
+
+  /** Number of requests served from the cache */
+  itkGetConstMacro(NumberOfHits, unsigned long);
+
+  /** Number of requests not served from the cache */
+  itkGetConstMacro(NumberOfMisses, unsigned long);
+
+  /** Configure the cache for a given dataset.
+   * \param datasetName name used to open the dataset in the background thread
+   * \param gdalDataType GDALDataType of the buffers
+   * \param nbBands number of bands read
+   * \param bytePerPixel size of one component in bytes
+   * \param rasterWidth, rasterHeight raster size
+   * \param blockWidth, blockHeight internal block size of the dataset
+   */
+  void Initialize(const std::string & datasetName,
+                  int gdalDataType,
+                  int nbBands,
+                  int bytePerPixel,
+                  int rasterWidth,
+                  int rasterHeight,
+                  int blockWidth,
+                  int blockHeight);
+
+  /** Copy the window into buffer (pixel interleaved, all bands) if it
+   *  is covered by a window already read, or being read, in the
+   *  background. Returns false if the window is not available. */
+  bool Fetch(const Window & window, void * buffer);
+
+  /** Record a requested window and schedule the background read of the
+   *  windows expected next */
+  void Advise(const Window & window);
+
+  /** Discard the pending reads and stop the background thread */
+  void Stop();
+
+  /** Extrapolate the next windows from the two last requested ones.
+   *  Consecutive windows of the same size are assumed to be translated
+   *  by a constant offset; horizontal moves wrap to the next row of
+   *  windows at the end of a row. */
+  static WindowListType PredictNextWindows(const Window & previous,
+                                           const Window & current,
+                                           int rasterWidth,
+                                           int rasterHeight,
+                                           unsigned int count);
+
+  /** Expand a window to the block grid, and crop it to the raster */
+  static Window AlignToBlocks(const Window & window,
+                              int blockWidth,
+                              int blockHeight,
+                              int rasterWidth,
+                              int rasterHeight);
+
+protected:
+  GDALReadAheadCache();
+  ~GDALReadAheadCache() override;
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  GDALReadAheadCache(const Self &) = delete;
+  void operator =(const Self&) = delete;
+
+  /** A window read, or to be read, in the background */
+  struct Entry
+  {
+    Window                     window;
+    std::vector<unsigned char> data;
+    bool                       ready;
+    bool                       failed;
+  };
+
+  typedef std::list<Entry> EntryListType;
+
+  /** Entry point of the background thread */
+  static ITK_THREAD_RETURN_TYPE ThreadCallback(void * arg);
+
+  /** Loop of the background thread */
+  void ProcessQueue();
+
+  /** Read an entry from the dataset of the background thread */
+  bool ReadEntry(Entry & entry);
+
+  /** Look for an entry containing the window (lock must be held) */
+  EntryListType::iterator FindEntryUnsafe(const Window & window);
+
+  /** Remove the oldest entries not in use (lock must be held) */
+  void EvictUnsafe();
+
+  std::string   m_DatasetName;
+  int           m_DataType;
+  int           m_NbBands;
+  int           m_BytePerPixel;
+  int           m_RasterWidth;
+  int           m_RasterHeight;
+  int           m_BlockWidth;
+  int           m_BlockHeight;
+  unsigned int  m_Depth;
+
+  Window        m_PreviousWindow;
+  bool          m_HasPreviousWindow;
+
+  unsigned long m_NumberOfHits;
+  unsigned long m_NumberOfMisses;
+
+  /** Entries, from the oldest to the newest */
+  EntryListType m_Entries;
+
+  /** Entry being read by the background thread */
+  Entry *       m_CurrentEntry;
+
+  bool          m_Running;
+  bool          m_Closed;
+
+  itk::SimpleMutexLock             m_Mutex;
+  itk::ConditionVariable::Pointer  m_WorkAvailable;
+  itk::ConditionVariable::Pointer  m_EntryReady;
+
+  itk::MultiThreader::Pointer      m_Threader;
+  itk::ThreadIdType                m_ThreadId;
+
+  /** Dataset handle owned by the background thread */
+  itk::SmartPointer<GDALDatasetWrapper> m_Dataset;
+};
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbGDALTiffDirectWriter_h
+#define otbGDALTiffDirectWriter_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkMutexLock.h"
+
+#include "OTBIOGDALExport.h"
+
+#include <string>
+#include <vector>
+
+namespace otb
+{
+
+/** \class GDALTiffDirectWriter
+ *  \brief Concurrent writing of regions in an uncompressed tiled GeoTIFF
+ *
+ * This class follows the approach of the Simple Parallel Tiff Writer
+ * (SPTW) used by the MPI writers, without MPI: the GeoTIFF is created by
+ * GDAL, uncompressed, tiled and pixel interleaved. Open() reads the offset
+ * of each block in the file, then WriteRegion() copies the pixels directly
+ * at their offsets.
+ *
+ * When the file has been created sparse (SPARSE_OK=TRUE), none of its
+ * blocks is allocated: Open() then places them contiguously at the end of
+ * the file and updates the tile offsets and byte counts of the TIFF
+ * directory, without writing any pixel. Each block is then written once,
+ * by WriteRegion().
+ *
+ * Each call to WriteRegion() uses a file handle of its own, so that
+ * several threads can write non-overlapping regions at the same time:
+ * since every pixel has a fixed location in the file, the writes never
+ * overlap, even when two regions share a block.
+ *
+ * The buffers are pixel interleaved, in the byte order of the file,
+ * which is the native byte order for files created by GDAL.
+ *
+ * \sa GDALImageIO
+ *
+ * \ingroup OTBIOGDAL
+ */
+class OTBIOGDAL_EXPORT GDALTiffDirectWriter : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef GDALTiffDirectWriter          Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(GDALTiffDirectWriter, itk::Object);
+
+  /** Open an existing GeoTIFF for direct writing. An exception is thrown
+   *  if the file layout does not allow it (compression, band
+   *  interleaving, partially allocated blocks...) */
+  void Open(const std::string & filename);
+
+  /** Close all the file handles */
+  void Close();
+
+  /** Write a region of pixels. The buffer is pixel interleaved, with
+   *  all the bands of the file. This method is thread-safe. */
+  void WriteRegion(int x, int y, int width, int height, const void * buffer);
+
+  /** Size of a pixel (all bands) in bytes */
+  itkGetConstMacro(PixelSize, unsigned int);
+
+  itkGetConstMacro(BlockWidth, int);
+  itkGetConstMacro(BlockHeight, int);
+
+protected:
+  GDALTiffDirectWriter();
+  ~GDALTiffDirectWriter() override;
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  GDALTiffDirectWriter(const Self &) = delete;
+  void operator =(const Self&) = delete;
+
+  /** Get a file handle from the pool, or open a new one */
+  void * AcquireHandle();
+
+  /** Give a file handle back to the pool */
+  void ReleaseHandle(void * handle);
+
+  /** Allocate all the blocks of a sparse file at its end, and record
+   *  their offsets in the TIFF directory */
+  void AllocateBlocks(unsigned long long blockSize);
+
+  std::string            m_FileName;
+  int                    m_RasterWidth;
+  int                    m_RasterHeight;
+  int                    m_BlockWidth;
+  int                    m_BlockHeight;
+  int                    m_BlocksPerRow;
+  unsigned int           m_PixelSize;
+
+  /** Offset of each block in the file, row by row */
+  std::vector<unsigned long long> m_BlockOffsets;
+
+  /** File handles (VSILFILE) not in use */
+  std::vector<void *>    m_Handles;
+  itk::SimpleMutexLock   m_Mutex;
+};
+
+} // end namespace otb
+
+#endif
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbGDALBlockCache.h"
+#include "otbConfigurationManager.h"
+#include "itkMutexLockHolder.h"
+
+#include <functional>
+
+namespace otb
+{
+
+typedef itk::MutexLockHolder<itk::SimpleFastMutexLock> StripeLockHolder;
+
+GDALBlockCache&
+GDALBlockCache
+::GetInstance()
+{
+  // Constructed on the first call, so that the configuration is read
+  // after static initialization
+  static GDALBlockCache theUniqueInstance;
+  return theUniqueInstance;
+}
+
+GDALBlockCache
+::GDALBlockCache()
+{
+  this->SetCapacity(ConfigurationManager::GetBlockCacheSize() * 1024 * 1024);
+}
+
+GDALBlockCache
+::~GDALBlockCache()
+{
+}
+
+GDALBlockCache::Stripe &
+GDALBlockCache
+::GetStripe(const BlockKey & key)
+{
+  size_t hash = std::hash<std::string>()(key.dataset);
+  hash = hash * 31 + static_cast<size_t>(key.overview);
+  hash = hash * 31 + static_cast<size_t>(key.band);
+  hash = hash * 31 + static_cast<size_t>(key.blockX);
+  hash = hash * 31 + static_cast<size_t>(key.blockY);
+  return m_Stripes[hash % NumberOfStripes];
+}
+
+GDALBlockCache::BlockPointerType
+GDALBlockCache
+::Get(const BlockKey & key)
+{
+  Stripe & stripe = this->GetStripe(key);
+  StripeLockHolder lock(stripe.lock);
+
+  EntryMapType::iterator it = stripe.index.find(key);
+  if (it == stripe.index.end())
+    {
+    ++stripe.misses;
+    return BlockPointerType();
+    }
+
+  // Move the entry to the front of the LRU list
+  stripe.entries.splice(stripe.entries.begin(), stripe.entries, it->second);
+  ++stripe.hits;
+  return it->second->block;
+}
+
+void
+GDALBlockCache
+::Insert(const BlockKey & key, const BlockPointerType & block)
+{
+  if (!block)
+    {
+    return;
+    }
+
+  Stripe & stripe = this->GetStripe(key);
+  StripeLockHolder lock(stripe.lock);
+
+  // Blocks larger than a stripe are not cached
+  if (block->size() > stripe.capacity)
+    {
+    return;
+    }
+
+  EntryMapType::iterator it = stripe.index.find(key);
+  if (it != stripe.index.end())
+    {
+    // Already inserted by another reader
+    stripe.entries.splice(stripe.entries.begin(), stripe.entries, it->second);
+    return;
+    }
+
+  Entry entry;
+  entry.key = key;
+  entry.block = block;
+  stripe.entries.push_front(entry);
+  stripe.index[key] = stripe.entries.begin();
+  stripe.size += block->size();
+
+  EvictUnsafe(stripe);
+}
+
+void
+GDALBlockCache
+::EvictUnsafe(Stripe & stripe)
+{
+  while (stripe.size > stripe.capacity && !stripe.entries.empty())
+    {
+    const Entry & last = stripe.entries.back();
+    stripe.size -= last.block->size();
+    stripe.index.erase(last.key);
+    stripe.entries.pop_back();
+    }
+}
+
+void
+GDALBlockCache
+::Invalidate(const std::string & dataset)
+{
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+
+    EntryListType::iterator it = stripe.entries.begin();
+    while (it != stripe.entries.end())
+      {
+      if (it->key.dataset == dataset)
+        {
+        stripe.size -= it->block->size();
+        stripe.index.erase(it->key);
+        it = stripe.entries.erase(it);
+        }
+      else
+        {
+        ++it;
+        }
+      }
+    }
+}
+
+void
+GDALBlockCache
+::Clear()
+{
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    stripe.entries.clear();
+    stripe.index.clear();
+    stripe.size = 0;
+    }
+}
+
+void
+GDALBlockCache
+::SetCapacity(unsigned long long capacity)
+{
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    stripe.capacity = capacity / NumberOfStripes;
+    EvictUnsafe(stripe);
+    }
+}
+
+unsigned long long
+GDALBlockCache
+::GetCapacity() const
+{
+  unsigned long long capacity = 0;
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    const Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    capacity += stripe.capacity;
+    }
+  return capacity;
+}
+
+bool
+GDALBlockCache
+::IsEnabled() const
+{
+  const Stripe & stripe = m_Stripes[0];
+  StripeLockHolder lock(stripe.lock);
+  return stripe.capacity > 0;
+}
+
+unsigned long long
+GDALBlockCache
+::GetSize() const
+{
+  unsigned long long size = 0;
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    const Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    size += stripe.size;
+    }
+  return size;
+}
+
+unsigned long long
+GDALBlockCache
+::GetNumberOfHits() const
+{
+  unsigned long long hits = 0;
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    const Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    hits += stripe.hits;
+    }
+  return hits;
+}
+
+unsigned long long
+GDALBlockCache
+::GetNumberOfMisses() const
+{
+  unsigned long long misses = 0;
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    const Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    misses += stripe.misses;
+    }
+  return misses;
+}
+
+void
+GDALBlockCache
+::ResetCounters()
+{
+  for (unsigned int i = 0; i < NumberOfStripes; ++i)
+    {
+    Stripe & stripe = m_Stripes[i];
+    StripeLockHolder lock(stripe.lock);
+    stripe.hits = 0;
+    stripe.misses = 0;
+    }
+}
+
+} // end namespace otb
@@ -22,11 +22,15 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <algorithm>
+#include <memory>
+#include <cstdlib>
 
 #include "otbGDALImageIO.h"
 #include "otbMacro.h"
 #include "otbSystem.h"
 #include "otbStopwatch.h"
+#include "otbTracer.h"
 #include "itksys/SystemTools.hxx"
 #include "otbImage.h"
 #include "otb_tinyxml.h"
@@ -43,6 +47,10 @@
 #include "ogr_srs_api.h"
 
 #include "otbGDALDriverManagerWrapper.h"
+#include "otbGDALBlockCache.h"
+#include "otbGDALReadAheadCache.h"
+#include "otbGDALTiffDirectWriter.h"
+#include "itkMutexLockHolder.h"
 
 #include "otb_boost_string_header.h"
 
@@ -54,6 +62,85 @@ inline unsigned int uint_ceildivpow2(unsigned int a, unsigned int b) {
   return (a + (1 << b) - 1) >> b;
 }
 
+namespace
+{
+/** Force the GeoTIFF creation options needed by concurrent writing: every
+ * pixel must have a fixed location in the file. The file is created sparse,
+ * so that GDAL does not fill the blocks that are written afterwards */
+std::vector<std::string> ConcurrentWritingCreationOptions(const std::vector<std::string> & options)
+{
+  const char * forcedKeys[] = {"TILED", "COMPRESS", "INTERLEAVE", "SPARSE_OK", "ENDIANNESS"};
+
+  std::vector<std::string> result;
+  for (const auto & option : options)
+    {
+    bool forced = false;
+    for (const char * key : forcedKeys)
+      {
+      if (boost::algorithm::istarts_with(option, std::string(key) + "="))
+        {
+        forced = true;
+        }
+      }
+    if (forced)
+      {
+      otbLogMacro(Warning,<< "Creation option " << option << " ignored by concurrent writing");
+      }
+    else
+      {
+      result.push_back(option);
+      }
+    }
+
+  result.push_back("TILED=YES");
+  result.push_back("COMPRESS=NONE");
+  result.push_back("INTERLEAVE=PIXEL");
+  result.push_back("SPARSE_OK=TRUE");
+  result.push_back("ENDIANNESS=NATIVE");
+  return result;
+}
+
+/** Creation options of a Cloud Optimized GeoTIFF. The temporary file is
+ * written uncompressed, the compression options only apply to the copy */
+std::vector<std::string> CloudOptimizedCreationOptions(const std::vector<std::string> & options,
+                                                       bool temporary)
+{
+  std::vector<const char *> forcedKeys = {"TILED", "COPY_SRC_OVERVIEWS"};
+  if (temporary)
+    {
+    forcedKeys.insert(forcedKeys.end(), {"COMPRESS", "PREDICTOR", "JPEG_QUALITY", "ZLEVEL", "BIGTIFF"});
+    }
+
+  std::vector<std::string> result;
+  for (const auto & option : options)
+    {
+    bool forced = false;
+    for (const char * key : forcedKeys)
+      {
+      if (boost::algorithm::istarts_with(option, std::string(key) + "="))
+        {
+        forced = true;
+        }
+      }
+    if (!forced)
+      {
+      result.push_back(option);
+      }
+    }
+
+  result.push_back("TILED=YES");
+  if (temporary)
+    {
+    result.push_back("BIGTIFF=IF_SAFER");
+    }
+  else
+    {
+    result.push_back("COPY_SRC_OVERVIEWS=YES");
+    }
+  return result;
+}
+}
+
 namespace otb
 {
 
@@ -111,10 +198,20 @@ GDALImageIO::GDALImageIO()
   m_ResolutionFactor = 0;
   m_BytePerPixel = 0;
   m_WriteRPCTags = false;
+  m_PrefetchDepth = 0;
+  m_ConcurrentWriting = false;
+  m_NumberOfPixelsWritten = 0;
+  m_NumberOfWrittenOverviews = 0;
+  m_WrittenOverviewsFactor = 2;
+  m_NumberOfPendingOverviewPixels = 0;
+  m_ImageWritten = false;
+  m_CloudOptimized = false;
 }
 
 GDALImageIO::~GDALImageIO()
 {
+  // A Cloud Optimized GeoTIFF left unfinished is not copied
+  this->DiscardCloudOptimizedWriting();
   delete m_PxType;
 }
 
@@ -137,6 +234,10 @@ void GDALImageIO::PrintSelf(std::ostream& os, itk::Indent indent) const
   os << indent << "Compression Level : " << m_CompressionLevel << "\n";
   os << indent << "IsComplex (otb side) : " << m_IsComplex << "\n";
   os << indent << "Byte per pixel : " << m_BytePerPixel << "\n";
+  os << indent << "Prefetch depth : " << m_PrefetchDepth << "\n";
+  os << indent << "Concurrent writing : " << m_ConcurrentWriting << "\n";
+  os << indent << "Written overviews : " << m_NumberOfWrittenOverviews << " (factor " << m_WrittenOverviewsFactor << ")\n";
+  os << indent << "Cloud optimized : " << m_CloudOptimized << "\n";
 }
 
 // Read a 3D image (or event more bands)... not implemented yet
@@ -179,6 +280,10 @@ void GDALImageIO::Read(void* buffer)
   if (lFirstColumn + lNbColumns > static_cast<int>(m_OriginalDimensions[0]))
     lNbColumns = static_cast<int>(m_OriginalDimensions[0]-lFirstColumn);
 
+  TraceScope traceScope("GDALImageIO::Read", "io");
+  traceScope.AddArgument("file", m_FileName);
+  traceScope.AddArgument("bytes", static_cast<unsigned long long>(lNbColumnsRegion) * lNbLinesRegion * m_BytePerPixel * m_NbBands);
+
   GDALDataset* dataset = m_Dataset->GetDataSet();
 
   // In the indexed case, one has to retrieve the index image and the
@@ -248,6 +353,57 @@ void GDALImageIO::Read(void* buffer)
       bandOffset  = m_BytePerPixel;
       }
 
+    // Blocks already decoded by any reader of the process
+    if (pixelOffset == m_BytePerPixel * m_NbBands
+        && GDALBlockCache::GetInstance().IsEnabled()
+        && this->ReadFromBlockCache(p, lFirstColumnRegion, lFirstLineRegion, lNbColumnsRegion, lNbLinesRegion))
+      {
+      otbLogMacro(Debug,<<"GDAL read ["<<lFirstColumnRegion<<", "<<lFirstColumnRegion+lNbColumnsRegion-1<<"]x["<<lFirstLineRegion<<", "<<lFirstLineRegion+lNbLinesRegion-1<<"] served by the shared block cache from file "<<m_FileName);
+      traceScope.AddArgument("source", "block cache");
+      return;
+      }
+
+    // Read-ahead is only available at full resolution, with the nominal
+    // buffer layout
+    if (m_PrefetchDepth > 0
+        && m_ResolutionFactor == 0
+        && pixelOffset == m_BytePerPixel * m_NbBands
+        && lNbColumns == lNbColumnsRegion
+        && lNbLines == lNbLinesRegion)
+      {
+      if (m_ReadAheadCache.IsNull())
+        {
+        int blockSizeX = 0;
+        int blockSizeY = 0;
+        dataset->GetRasterBand(1)->GetBlockSize(&blockSizeX, &blockSizeY);
+
+        m_ReadAheadCache = GDALReadAheadCache::New();
+        m_ReadAheadCache->SetDepth(m_PrefetchDepth);
+        m_ReadAheadCache->Initialize(dataset->GetDescription(),
+                                     m_PxType->pixType,
+                                     m_NbBands,
+                                     m_BytePerPixel,
+                                     m_OriginalDimensions[0],
+                                     m_OriginalDimensions[1],
+                                     blockSizeX,
+                                     blockSizeY);
+        }
+
+      GDALReadAheadCache::Window window(lFirstColumn, lFirstLine, lNbColumns, lNbLines);
+      const bool hit = m_ReadAheadCache->Fetch(window, p);
+
+      // Schedule the next regions before reading the current one, so that
+      // both reads overlap
+      m_ReadAheadCache->Advise(window);
+
+      if (hit)
+        {
+        otbLogMacro(Debug,<<"GDAL read ["<<lFirstColumn<<", "<<lFirstColumn+lNbColumns-1<<"]x["<<lFirstLine<<", "<<lFirstLine+lNbLines-1<<"] served by read-ahead from file "<<m_FileName);
+        traceScope.AddArgument("source", "read-ahead");
+        return;
+        }
+      }
+
     // keep it for the moment
     otbLogMacro(Debug,<<"GDAL reads ["<<lFirstColumn<<", "<<lFirstColumnRegion+lNbColumnsRegion-1<<"]x["<<lFirstLineRegion<<", "<<lFirstLineRegion+lNbLinesRegion-1<<"] x "<<nbBands<<" bands of type "<<GDALGetDataTypeName(m_PxType->pixType)<<" from file "<<m_FileName);
 
@@ -281,6 +437,112 @@ void GDALImageIO::Read(void* buffer)
       }
 }
 
+bool GDALImageIO::ReadFromBlockCache(unsigned char * buffer, int x, int y, int width, int height)
+{
+  GDALDataset* dataset = m_Dataset->GetDataSet();
+  if (width <= 0 || height <= 0 || m_NbBands != dataset->GetRasterCount())
+    {
+    return false;
+    }
+
+  GDALBlockCache & cache = GDALBlockCache::GetInstance();
+  const std::string datasetName = dataset->GetDescription();
+  const int pixelOffset = m_BytePerPixel * m_NbBands;
+  const size_t lineOffset = static_cast<size_t>(pixelOffset) * width;
+
+  for (int bandIndex = 1; bandIndex <= m_NbBands; ++bandIndex)
+    {
+    GDALRasterBand* band = dataset->GetRasterBand(bandIndex);
+    int overview = 0;
+
+    if (m_ResolutionFactor > 0)
+      {
+      // Only an overview of the exact size of the image can be used
+      GDALRasterBand* overviewBand = nullptr;
+      for (int i = 0; i < band->GetOverviewCount() && overviewBand == nullptr; ++i)
+        {
+        GDALRasterBand* candidate = band->GetOverview(i);
+        if (candidate != nullptr
+            && candidate->GetXSize() == static_cast<int>(m_Dimensions[0])
+            && candidate->GetYSize() == static_cast<int>(m_Dimensions[1]))
+          {
+          overviewBand = candidate;
+          overview = i + 1;
+          }
+        }
+      if (overviewBand == nullptr)
+        {
+        return false;
+        }
+      band = overviewBand;
+      }
+
+    int blockWidth = 0;
+    int blockHeight = 0;
+    band->GetBlockSize(&blockWidth, &blockHeight);
+    if (blockWidth <= 0 || blockHeight <= 0)
+      {
+      return false;
+      }
+
+    // Blocks are cached in the data type of the file
+    const GDALDataType blockType = band->GetRasterDataType();
+    const int blockPixelSize = GDALGetDataTypeSize(blockType) / 8;
+
+    for (int by = y / blockHeight; by <= (y + height - 1) / blockHeight; ++by)
+      {
+      const int blockY0 = by * blockHeight;
+      const int blockH = std::min(blockHeight, band->GetYSize() - blockY0);
+
+      for (int bx = x / blockWidth; bx <= (x + width - 1) / blockWidth; ++bx)
+        {
+        const int blockX0 = bx * blockWidth;
+        const int blockW = std::min(blockWidth, band->GetXSize() - blockX0);
+
+        GDALBlockCache::BlockKey key(datasetName, overview, bandIndex, bx, by);
+        GDALBlockCache::BlockPointerType block = cache.Get(key);
+
+        if (!block)
+          {
+          std::shared_ptr<GDALBlockCache::BlockDataType> data =
+            std::make_shared<GDALBlockCache::BlockDataType>(static_cast<size_t>(blockW) * blockH * blockPixelSize);
+
+          CPLErr lCrGdal = band->RasterIO(GF_Read, blockX0, blockY0, blockW, blockH,
+                                          data->data(), blockW, blockH, blockType, 0, 0);
+          if (lCrGdal == CE_Failure)
+            {
+            return false;
+            }
+          cache.Insert(key, data);
+          block = data;
+          }
+
+        // Copy the part of the block inside the region, converting to
+        // the buffer data type
+        const int x0 = std::max(x, blockX0);
+        const int x1 = std::min(x + width, blockX0 + blockW);
+        const int y0 = std::max(y, blockY0);
+        const int y1 = std::min(y + height, blockY0 + blockH);
+
+        for (int line = y0; line < y1; ++line)
+          {
+          const unsigned char * src = block->data()
+            + (static_cast<size_t>(line - blockY0) * blockW + (x0 - blockX0)) * blockPixelSize;
+          unsigned char * dst = buffer
+            + static_cast<size_t>(line - y) * lineOffset
+            + static_cast<size_t>(x0 - x) * pixelOffset
+            + static_cast<size_t>(bandIndex - 1) * m_BytePerPixel;
+
+          GDALCopyWords(const_cast<unsigned char *>(src), blockType, blockPixelSize,
+                        dst, m_PxType->pixType, pixelOffset, x1 - x0);
+          }
+        }
+      }
+    }
+
+  return true;
+}
+
 bool GDALImageIO::GetSubDatasetInfo(std::vector<std::string> &names, std::vector<std::string> &desc)
 {
   // Note: we assume that the subdatasets are in order : SUBDATASET_ID_NAME, SUBDATASET_ID_DESC, SUBDATASET_ID+1_NAME, SUBDATASET_ID+1_DESC
@@ -364,6 +626,35 @@ unsigned int GDALImageIO::GetOverviewsCount()
   return possibleOverviewCount;
 }
 
+unsigned int GDALImageIO::GetNativeResolutionFactor(unsigned int decimation)
+{
+  if (decimation < 2)
+    return 0;
+
+  GDALRasterBand* band = m_Dataset->GetDataSet()->GetRasterBand(1);
+  const unsigned int width = m_Dataset->GetDataSet()->GetRasterXSize();
+  const unsigned int height = m_Dataset->GetDataSet()->GetRasterYSize();
+
+  unsigned int factor = 0;
+  for (int iOverview = 0; iOverview < band->GetOverviewCount(); iOverview++)
+    {
+    GDALRasterBand* overview = band->GetOverview(iOverview);
+    if (overview == nullptr)
+      continue;
+
+    // Overview sizes are rounded differently by the drivers
+    for (unsigned int k = factor + 1; k < 31 && (1u << k) <= decimation; k++)
+      {
+      const int w = uint_ceildivpow2(width, k);
+      const int h = uint_ceildivpow2(height, k);
+      if (std::abs(overview->GetXSize() - w) <= 1 && std::abs(overview->GetYSize() - h) <= 1)
+        {
+        factor = k;
+        }
+      }
+    }
+  return factor;
+}
 
 std::vector<std::string> GDALImageIO::GetOverviewsInfo()
 {
@@ -429,6 +720,13 @@ void GDALImageIO::InternalReadImageInformation()
                                     MetaDataKey::SubDatasetIndex,
                                     m_DatasetNumber);
 
+  itk::ExposeMetaData<unsigned int>(this->GetMetaDataDictionary(),
+                                    MetaDataKey::PrefetchDepth,
+                                    m_PrefetchDepth);
+
+  // The file may have changed: drop any previous read-ahead
+  m_ReadAheadCache = nullptr;
+
   // Detecting if we are in the case of an image with subdatasets
   // example: hdf Modis data
   // in this situation, we are going to change the filename to the
@@ -1257,6 +1555,7 @@ void GDALImageIO::Write(const void* buffer)
     }
     else
     {
+      GDALBlockCache::GetInstance().Invalidate(hOutputDS->GetDescription());
       GDALClose(hOutputDS);
     }
   }
@@ -1266,8 +1565,203 @@ void GDALImageIO::Write(const void* buffer)
       && lFirstColumn + lNbColumns == m_Dimensions[0])
     {
     // Last pixel written
-    // Reinitialize to close the file
+    // Reinitialize to close the file, unless overviews are still expected
+    m_ImageWritten = true;
+    if (m_NumberOfPendingOverviewPixels == 0)
+      {
+      this->CloseWrittenDataset();
+      }
+    }
+}
+
+bool GDALImageIO::CanWriteOverviews()
+{
+  return !m_ConcurrentWriting
+    && FilenameToGdalDriverShortName(m_FileName) == "GTiff"
+    && this->CanStreamWrite();
+}
+
+void GDALImageIO::WriteOverview(unsigned int overview, const itk::ImageIORegion & region, const void* buffer)
+{
+  if (buffer == nullptr)
+    {
+    itkExceptionMacro(<< "Null buffer passed to GDALImageIO for writing.");
+    }
+
+  if (overview == 0 || overview > m_NumberOfWrittenOverviews)
+    {
+    itkExceptionMacro(<< "Overview " << overview << " is not written in " << m_FileName
+                      << " (" << m_NumberOfWrittenOverviews << " overviews)");
+    }
+
+  if (m_FlagWriteImageInformation)
+    {
+    this->InternalWriteImageInformation(buffer);
+    m_FlagWriteImageInformation = false;
+    }
+
+  if (m_Dataset.IsNull())
+    {
+    itkExceptionMacro(<< "Overview written after the closing of " << m_FileName);
+    }
+
+  const int firstColumn = region.GetIndex()[0];
+  const int firstLine = region.GetIndex()[1];
+  const int nbColumns = region.GetSize()[0];
+  const int nbLines = region.GetSize()[1];
+
+  otbLogMacro(Debug,<<"GDAL writes ["<<firstColumn<<", "<<firstColumn+nbColumns-1<<"]x["<<firstLine<<", "<<firstLine+nbLines-1<<"] of overview "<<overview<<" to file "<<m_FileName);
+
+  GDALDataset* dataset = m_Dataset->GetDataSet();
+  for (int band = 0; band < m_NbBands; ++band)
+    {
+    GDALRasterBand* overviewBand = dataset->GetRasterBand(band + 1)->GetOverview(overview - 1);
+    if (overviewBand == nullptr)
+      {
+      itkExceptionMacro(<< "Overview " << overview << " of band " << band + 1 << " not found in " << m_FileName);
+      }
+
+    // Each band is picked in the pixel interleaved buffer
+    CPLErr lCrGdal = overviewBand->RasterIO(GF_Write,
+                                            firstColumn, firstLine, nbColumns, nbLines,
+                                            static_cast<unsigned char*>(const_cast<void*>(buffer)) + band * m_BytePerPixel,
+                                            nbColumns, nbLines,
+                                            m_PxType->pixType,
+                                            m_BytePerPixel * m_NbBands,
+                                            m_BytePerPixel * m_NbBands * nbColumns);
+    if (lCrGdal == CE_Failure)
+      {
+      itkExceptionMacro(<< "Error while writing overview " << overview << " of image (GDAL format) '"
+        << m_FileName << "' : " << CPLGetLastErrorMsg());
+      }
+    }
+
+  const unsigned long long nbPixels = static_cast<unsigned long long>(nbColumns) * nbLines;
+  m_NumberOfPendingOverviewPixels -= std::min(nbPixels, m_NumberOfPendingOverviewPixels);
+  if (m_NumberOfPendingOverviewPixels == 0 && m_ImageWritten)
+    {
+    // Image and overviews written: close the file
+    this->CloseWrittenDataset();
+    }
+}
+
+void GDALImageIO::CloseWrittenDataset()
+{
+  if (!m_CloudOptimized || m_Dataset.IsNull())
+    {
     m_Dataset = GDALDatasetWrapperPointer();
+    return;
+    }
+
+  const std::string temporaryFileName = this->GetCloudOptimizedTemporaryFileName();
+  GDALDriver* driver = GDALDriverManagerWrapper::GetInstance().GetDriverByName("GTiff");
+
+  otbLogMacro(Debug,<< "Copy " << temporaryFileName << " to the Cloud Optimized GeoTIFF " << m_FileName);
+
+  otb::Stopwatch chrono = otb::Stopwatch::StartNew();
+  m_Dataset->GetDataSet()->FlushCache();
+  GDALCreationOptionsType creationOptions = CloudOptimizedCreationOptions(m_CreationOptions, false);
+  GDALDataset* hOutputDS = driver->CreateCopy(GetGdalWriteImageFileName("GTiff", m_FileName).c_str(),
+                                              m_Dataset->GetDataSet(), FALSE,
+                                              otb::ogr::StringListConverter(creationOptions).to_ogr(),
+                                              nullptr, nullptr);
+  // The temporary file is removed whether the copy succeeded or not
+  m_Dataset = GDALDatasetWrapperPointer();
+  driver->Delete(temporaryFileName.c_str());
+  chrono.Stop();
+
+  if (!hOutputDS)
+    {
+    itkExceptionMacro(<< "Error while writing image (GDAL format) '"
+      << m_FileName << "' : " << CPLGetLastErrorMsg());
+    }
+  GDALBlockCache::GetInstance().Invalidate(hOutputDS->GetDescription());
+  GDALClose(hOutputDS);
+
+  otbLogMacro(Debug,<< "Cloud Optimized GeoTIFF copy took " << chrono.GetElapsedMilliseconds() << " ms")
+}
+
+void GDALImageIO::DiscardCloudOptimizedWriting()
+{
+  if (!m_CloudOptimized || m_Dataset.IsNull())
+    {
+    return;
+    }
+
+  const std::string temporaryFileName = this->GetCloudOptimizedTemporaryFileName();
+  otbLogMacro(Debug,<< "Remove the unfinished temporary file " << temporaryFileName);
+
+  m_Dataset = GDALDatasetWrapperPointer();
+  m_ImageWritten = false;
+  m_NumberOfPendingOverviewPixels = 0;
+  GDALDriver* driver = GDALDriverManagerWrapper::GetInstance().GetDriverByName("GTiff");
+  if (driver != nullptr)
+    {
+    driver->Delete(temporaryFileName.c_str());
+    }
+}
+
+bool GDALImageIO::CanWriteRegionsConcurrently()
+{
+  return m_ConcurrentWriting
+    && FilenameToGdalDriverShortName(m_FileName) == "GTiff"
+    && this->CanStreamWrite();
+}
+
+void GDALImageIO::WriteRegion(const itk::ImageIORegion & region, const void* buffer)
+{
+  if (buffer == nullptr)
+    {
+    itkExceptionMacro(<< "Null buffer passed to GDALImageIO for writing.");
+    }
+
+  GDALTiffDirectWriter::Pointer directWriter;
+  {
+  itk::MutexLockHolder<itk::SimpleMutexLock> lock(m_ConcurrentWritingMutex);
+  if (m_DirectWriter.IsNull())
+    {
+    if (!this->CanWriteRegionsConcurrently())
+      {
+      itkExceptionMacro(<< "Concurrent writing is not available for " << m_FileName);
+      }
+
+    if (m_FlagWriteImageInformation)
+      {
+      this->InternalWriteImageInformation(buffer);
+      m_FlagWriteImageInformation = false;
+      }
+
+    // The dataset is closed without any block, the direct writer then
+    // allocates them and the pixels are written directly at their offsets
+    m_Dataset = GDALDatasetWrapperPointer();
+
+    GDALTiffDirectWriter::Pointer writer = GDALTiffDirectWriter::New();
+    writer->Open(GetGdalWriteImageFileName("GTiff", m_FileName));
+    m_DirectWriter = writer;
+    m_NumberOfPixelsWritten = 0;
+    }
+  directWriter = m_DirectWriter;
+  }
+
+  const int firstColumn = region.GetIndex()[0];
+  const int firstLine = region.GetIndex()[1];
+  const int nbColumns = region.GetSize()[0];
+  const int nbLines = region.GetSize()[1];
+
+  otbLogMacro(Debug,<<"Direct write ["<<firstColumn<<", "<<firstColumn+nbColumns-1<<"]x["<<firstLine<<", "<<firstLine+nbLines-1<<"] x "<<m_NbBands<<" bands of type "<<GDALGetDataTypeName(m_PxType->pixType)<<" to file "<<m_FileName);
+
+  otb::Stopwatch chrono = otb::Stopwatch::StartNew();
+  directWriter->WriteRegion(firstColumn, firstLine, nbColumns, nbLines, buffer);
+  chrono.Stop();
+
+  otbLogMacro(Debug,<< "Direct write took " << chrono.GetElapsedMilliseconds() << " ms")
+
+  itk::MutexLockHolder<itk::SimpleMutexLock> lock(m_ConcurrentWritingMutex);
+  m_NumberOfPixelsWritten += static_cast<unsigned long long>(nbColumns) * nbLines;
+  if (m_NumberOfPixelsWritten == static_cast<unsigned long long>(m_Dimensions[0]) * m_Dimensions[1])
+    {
+    // Last pixel written: close the file
+    m_DirectWriter = nullptr;
     }
 }
 
@@ -1396,9 +1890,24 @@ void GDALImageIO::InternalWriteImageInformation(const void* buffer)
   if (m_CanStreamWrite)
     {
     GDALCreationOptionsType creationOptions = m_CreationOptions;
+    std::string writtenFileName = GetGdalWriteImageFileName(driverShortName, m_FileName);
+    if (m_CloudOptimized)
+      {
+      if (driverShortName != "GTiff" || m_ConcurrentWriting)
+        {
+        itkExceptionMacro(<< "Cloud Optimized GeoTIFF can not be written to " << m_FileName
+                          << (m_ConcurrentWriting ? " with concurrent writing" : ""));
+        }
+      creationOptions = CloudOptimizedCreationOptions(creationOptions, true);
+      writtenFileName = this->GetCloudOptimizedTemporaryFileName();
+      }
+    else if (m_ConcurrentWriting && driverShortName == "GTiff")
+      {
+      creationOptions = ConcurrentWritingCreationOptions(creationOptions);
+      }
     m_Dataset = GDALDriverManagerWrapper::GetInstance().Create(
                      driverShortName,
-                     GetGdalWriteImageFileName(driverShortName, m_FileName),
+                     writtenFileName,
                      m_Dimensions[0], m_Dimensions[1],
                      m_NbBands, m_PxType->pixType,
                      otb::ogr::StringListConverter(creationOptions).to_ogr());
@@ -1430,6 +1939,14 @@ void GDALImageIO::InternalWriteImageInformation(const void* buffer)
     itkExceptionMacro(<< CPLGetLastErrorMsg());
     }
 
+  // Blocks of a previous version of the file must not be served anymore.
+  // They are keyed by the GDAL description of the read datasets, which is
+  // also the one of the created dataset.
+  if (m_CanStreamWrite)
+    {
+    GDALBlockCache::GetInstance().Invalidate(m_Dataset->GetDataSet()->GetDescription());
+    }
+
   /*----------------------------------------------------------------------*/
   /*-------------------------- METADATA ----------------------------------*/
   /*----------------------------------------------------------------------*/
@@ -1604,6 +2121,53 @@ void GDALImageIO::InternalWriteImageInformation(const void* buffer)
   for (auto const& noData : m_NoDataList)
     dataset->GetRasterBand(noData.first)->SetNoDataValue(noData.second);
 
+  /* -------------------------------------------------------------------- */
+  /* Allocate the overviews written with WriteOverview()                  */
+  /* -------------------------------------------------------------------- */
+  m_ImageWritten = false;
+  m_NumberOfPendingOverviewPixels = 0;
+  if (m_NumberOfWrittenOverviews > 0)
+    {
+    if (!this->CanWriteOverviews())
+      {
+      itkExceptionMacro(<< "Overviews can not be written along with " << m_FileName);
+      }
+
+    std::vector<int> factors;
+    int factor = 1;
+    for (unsigned int i = 0; i < m_NumberOfWrittenOverviews; ++i)
+      {
+      factor *= m_WrittenOverviewsFactor;
+      factors.push_back(factor);
+      }
+
+    // NONE only allocates the overviews, their pixels are written later on
+    if (dataset->BuildOverviews("NONE", static_cast<int>(factors.size()), &factors.front(),
+                                0, nullptr, nullptr, nullptr) == CE_Failure)
+      {
+      itkExceptionMacro(<< "Error while allocating the overviews of " << m_FileName << " : " << CPLGetLastErrorMsg());
+      }
+
+    GDALRasterBand* band = dataset->GetRasterBand(1);
+    if (band->GetOverviewCount() != static_cast<int>(factors.size()))
+      {
+      itkExceptionMacro(<< "Unexpected number of overviews in " << m_FileName << ": " << band->GetOverviewCount());
+      }
+
+    for (unsigned int i = 0; i < factors.size(); ++i)
+      {
+      const unsigned int width = (m_Dimensions[0] + factors[i] - 1) / factors[i];
+      const unsigned int height = (m_Dimensions[1] + factors[i] - 1) / factors[i];
+      GDALRasterBand* overview = band->GetOverview(i);
+      if (overview == nullptr
+          || overview->GetXSize() != static_cast<int>(width)
+          || overview->GetYSize() != static_cast<int>(height))
+        {
+        itkExceptionMacro(<< "Unexpected size of overview " << i + 1 << " in " << m_FileName);
+        }
+      m_NumberOfPendingOverviewPixels += static_cast<unsigned long long>(width) * height;
+      }
+    }
 }
 
 std::string GDALImageIO::FilenameToGdalDriverShortName(const std::string& name) const
@@ -1719,6 +2283,11 @@ bool GDALImageIO::GetOriginFromGMLBox(std::vector<double> &origin)
   return true;
 }
 
+std::string GDALImageIO::GetCloudOptimizedTemporaryFileName() const
+{
+  return GetGdalWriteImageFileName("GTiff", m_FileName) + ".tmp.tif";
+}
+
 std::string GDALImageIO::GetGdalWriteImageFileName(const std::string& gdalDriverShortName, const std::string& filename) const
 {
   std::string gdalFileName;
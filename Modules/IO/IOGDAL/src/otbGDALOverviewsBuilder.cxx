@@ -29,7 +29,10 @@
 #include "otbGDALDriverManagerWrapper.h"
 #include "otbGDALImageIO.h"
 #include "otbSystem.h"
+#include "otbConfigurationManager.h"
+#include "otbPyramidCascade.h"
 
+#include <algorithm>
 #include <cctype>
 
 namespace otb
@@ -72,6 +75,119 @@ GDAL_COMPRESSION_NAMES[ GDAL_COMPRESSION_COUNT ] =
 };
 
 
+/***************************************************************************/
+namespace
+{
+
+// Read the image by strips of full lines, aligned on the blocks of the
+// image, and push them into a cascade writing the overviews of all bands.
+template< typename TValue >
+void
+ComputeOverviewsInCascade( GDALDataset * dataset,
+                           GDALDataType type,
+                           unsigned int nbOverviews,
+                           unsigned int factor,
+                           bool average,
+                           GDALOverviewsBuilder * builder )
+{
+  typedef PyramidCascade< TValue > CascadeType;
+
+  const int width = dataset->GetRasterXSize();
+  const int height = dataset->GetRasterYSize();
+  const int nbBands = dataset->GetRasterCount();
+  const int bytes = static_cast< int >( sizeof( TValue ) );
+  const int pixelSpace = bytes * nbBands;
+
+  CascadeType cascade;
+  cascade.SetNumberOfLevels( nbOverviews );
+  cascade.SetShrinkFactor( factor );
+  cascade.SetResampling(
+    average
+    ? CascadeType::Average
+    : CascadeType::Nearest
+  );
+
+  cascade.SetCallback(
+    [ & ]( unsigned int level, unsigned int firstLine, unsigned int nbLines, const TValue * buffer )
+    {
+    const int levelWidth = static_cast< int >( cascade.GetLevelWidth( level ) );
+
+    for( int b=0; b<nbBands; ++b )
+      {
+      GDALRasterBand * overview =
+        dataset->GetRasterBand( b + 1 )->GetOverview( level - 1 );
+
+      CPLErr lCrGdal =
+        overview->RasterIO(
+          GF_Write,
+          0, firstLine, levelWidth, nbLines,
+          const_cast< TValue * >( buffer ) + b,
+          levelWidth, nbLines,
+          type,
+          pixelSpace,
+          pixelSpace * levelWidth );
+
+      if( lCrGdal==CE_Failure )
+        itkGenericExceptionMacro(
+          << "Error while writing overview " << level
+          << " : " << CPLGetLastErrorMsg()
+        );
+      }
+    }
+  );
+
+  cascade.Initialize( width, height, nbBands );
+
+  // A quarter of the available RAM for the strips
+  const unsigned long long ram =
+    static_cast< unsigned long long >( ConfigurationManager::GetMaxRAMHint() ) * 1024 * 1024 / 4;
+  const unsigned long long lineBytes =
+    static_cast< unsigned long long >( pixelSpace ) * width;
+
+  int nbLines = static_cast< int >(
+    std::min< unsigned long long >( std::max< unsigned long long >( ram / lineBytes, 1 ), height )
+  );
+
+  int blockWidth = 0;
+  int blockHeight = 0;
+  dataset->GetRasterBand( 1 )->GetBlockSize( &blockWidth, &blockHeight );
+
+  if( blockHeight>0 && nbLines>blockHeight )
+    nbLines -= nbLines % blockHeight;
+
+  std::vector< TValue > strip( static_cast< size_t >( nbLines ) * width * nbBands );
+
+  for( int y=0; y<height; y+=nbLines )
+    {
+    const int lines = std::min( nbLines, height - y );
+
+    CPLErr lCrGdal =
+      dataset->RasterIO(
+        GF_Read,
+        0, y, width, lines,
+        &strip.front(),
+        width, lines,
+        type,
+        nbBands,
+        nullptr, // All bands
+        pixelSpace,
+        pixelSpace * width,
+        bytes );
+
+    if( lCrGdal==CE_Failure )
+      itkGenericExceptionMacro(
+        << "Error while reading lines " << y << " to " << y + lines - 1
+        << " : " << CPLGetLastErrorMsg()
+      );
+
+    cascade.PushLines( lines, &strip.front() );
+
+    builder->UpdateProgress( static_cast< float >( y + lines ) / height );
+    }
+}
+
+} // end of anonymous namespace
+
 /***************************************************************************/
 std::string
 GetConfigOption( const char * key )
@@ -547,15 +663,28 @@ GDALOverviewsBuilder
     m_ResamplingMethod<GDAL_RESAMPLING_COUNT
   );
 
-  CPLErr lCrGdal =
-    m_GDALDataset->GetDataSet()->BuildOverviews(
-      GDAL_RESAMPLING_NAMES[ m_ResamplingMethod ],
-      static_cast< int >( m_NbResolutions - 1 ),
-      &ovwlist.front(),
-      0, // All bands
-      nullptr, // All bands
-      ( GDALProgressFunc )otb_UpdateGDALProgress,
-      this );
+  CPLErr lCrGdal = CE_None;
+
+  try
+    {
+    if( !BuildOverviewsInCascade( ovwlist ) )
+      lCrGdal =
+        m_GDALDataset->GetDataSet()->BuildOverviews(
+          GDAL_RESAMPLING_NAMES[ m_ResamplingMethod ],
+          static_cast< int >( m_NbResolutions - 1 ),
+          &ovwlist.front(),
+          0, // All bands
+          nullptr, // All bands
+          ( GDALProgressFunc )otb_UpdateGDALProgress,
+          this );
+    }
+  catch( ... )
+    {
+    CPLSetConfigOption( "USE_RRD", erdas.c_str() );
+    CPLSetConfigOption( "COMPRESS_OVERVIEW", compression.c_str() );
+
+    throw;
+    }
 
   CPLSetConfigOption( "USE_RRD", erdas.c_str() );
   CPLSetConfigOption( "COMPRESS_OVERVIEW", compression.c_str() );
@@ -566,6 +695,123 @@ GDALOverviewsBuilder
     }
 }
 
+/***************************************************************************/
+bool
+GDALOverviewsBuilder
+::BuildOverviewsInCascade( std::vector< int > & factors )
+{
+  // Other resampling methods are left to GDAL, as well as the ERDAS
+  // format whose overviews may be decimated differently
+  if( factors.empty() ||
+      m_ResolutionFactor<2 ||
+      m_Format!=GDAL_FORMAT_GEOTIFF ||
+      ( m_ResamplingMethod!=GDAL_RESAMPLING_AVERAGE &&
+        m_ResamplingMethod!=GDAL_RESAMPLING_NEAREST ) )
+    return false;
+
+  GDALDataset * dataset = m_GDALDataset->GetDataSet();
+
+  const int nbBands = dataset->GetRasterCount();
+
+  if( nbBands<=0 )
+    return false;
+
+  const GDALDataType type = dataset->GetRasterBand( 1 )->GetRasterDataType();
+
+  switch( type )
+    {
+    case GDT_Byte:
+    case GDT_UInt16:
+    case GDT_Int16:
+    case GDT_UInt32:
+    case GDT_Int32:
+    case GDT_Float32:
+    case GDT_Float64:
+      break;
+
+    default:
+      return false;
+    }
+
+  for( int b=1; b<=nbBands; ++b )
+    {
+    GDALRasterBand * band = dataset->GetRasterBand( b );
+
+    if( band->GetRasterDataType()!=type )
+      return false;
+
+    // GDAL averages skip the no-data pixels
+    int hasNoData = 0;
+    band->GetNoDataValue( &hasNoData );
+
+    if( hasNoData && m_ResamplingMethod==GDAL_RESAMPLING_AVERAGE )
+      return false;
+    }
+
+  // NONE only allocates the overviews
+  if( dataset->BuildOverviews(
+        "NONE",
+        static_cast< int >( factors.size() ),
+        &factors.front(),
+        0, // All bands
+        nullptr, // All bands
+        nullptr,
+        nullptr )==CE_Failure )
+    return false;
+
+  // Overviews must match the levels of the cascade, otherwise GDAL
+  // computes them again from the image
+  for( int b=1; b<=nbBands; ++b )
+    {
+    GDALRasterBand * band = dataset->GetRasterBand( b );
+
+    if( band->GetOverviewCount()!=static_cast< int >( factors.size() ) )
+      return false;
+
+    for( unsigned int i=0; i<factors.size(); ++i )
+      {
+      GDALRasterBand * overview = band->GetOverview( i );
+
+      if( overview==nullptr ||
+          overview->GetXSize()!=( dataset->GetRasterXSize() + factors[ i ] - 1 ) / factors[ i ] ||
+          overview->GetYSize()!=( dataset->GetRasterYSize() + factors[ i ] - 1 ) / factors[ i ] )
+        return false;
+      }
+    }
+
+  const unsigned int nbOverviews = static_cast< unsigned int >( factors.size() );
+  const bool average = m_ResamplingMethod==GDAL_RESAMPLING_AVERAGE;
+
+  switch( type )
+    {
+    case GDT_Byte:
+      ComputeOverviewsInCascade< unsigned char >( dataset, type, nbOverviews, m_ResolutionFactor, average, this );
+      break;
+    case GDT_UInt16:
+      ComputeOverviewsInCascade< unsigned short >( dataset, type, nbOverviews, m_ResolutionFactor, average, this );
+      break;
+    case GDT_Int16:
+      ComputeOverviewsInCascade< short >( dataset, type, nbOverviews, m_ResolutionFactor, average, this );
+      break;
+    case GDT_UInt32:
+      ComputeOverviewsInCascade< unsigned int >( dataset, type, nbOverviews, m_ResolutionFactor, average, this );
+      break;
+    case GDT_Int32:
+      ComputeOverviewsInCascade< int >( dataset, type, nbOverviews, m_ResolutionFactor, average, this );
+      break;
+    case GDT_Float32:
+      ComputeOverviewsInCascade< float >( dataset, type, nbOverviews, m_ResolutionFactor, average, this );
+      break;
+    default:
+      ComputeOverviewsInCascade< double >( dataset, type, nbOverviews, m_ResolutionFactor, average, this );
+      break;
+    }
+
+  dataset->FlushCache();
+
+  return true;
+}
+
 /***************************************************************************/
 void
 GDALOverviewsBuilder
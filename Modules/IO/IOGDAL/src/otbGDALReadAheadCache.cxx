@@ -0,0 +1,438 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbGDALReadAheadCache.h"
+#include "otbGDALDatasetWrapper.h"
+#include "otbGDALDriverManagerWrapper.h"
+#include "otbMacro.h"
+#include "itkMutexLockHolder.h"
+#include "otbTracer.h"
+
+#include "gdal_priv.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace otb
+{
+
+GDALReadAheadCache
+::GDALReadAheadCache()
+  : m_DataType(0),
+    m_NbBands(0),
+    m_BytePerPixel(0),
+    m_RasterWidth(0),
+    m_RasterHeight(0),
+    m_BlockWidth(1),
+    m_BlockHeight(1),
+    m_Depth(0),
+    m_HasPreviousWindow(false),
+    m_NumberOfHits(0),
+    m_NumberOfMisses(0),
+    m_CurrentEntry(nullptr),
+    m_Running(false),
+    m_Closed(false),
+    m_ThreadId(0)
+{
+  m_WorkAvailable = itk::ConditionVariable::New();
+  m_EntryReady = itk::ConditionVariable::New();
+  m_Threader = itk::MultiThreader::New();
+}
+
+GDALReadAheadCache
+::~GDALReadAheadCache()
+{
+  this->Stop();
+}
+
+void
+GDALReadAheadCache
+::Initialize(const std::string & datasetName,
+             int gdalDataType,
+             int nbBands,
+             int bytePerPixel,
+             int rasterWidth,
+             int rasterHeight,
+             int blockWidth,
+             int blockHeight)
+{
+  this->Stop();
+
+  m_DatasetName = datasetName;
+  m_DataType = gdalDataType;
+  m_NbBands = nbBands;
+  m_BytePerPixel = bytePerPixel;
+  m_RasterWidth = rasterWidth;
+  m_RasterHeight = rasterHeight;
+  m_BlockWidth = std::max(1, blockWidth);
+  m_BlockHeight = std::max(1, blockHeight);
+  m_HasPreviousWindow = false;
+  m_NumberOfHits = 0;
+  m_NumberOfMisses = 0;
+}
+
+GDALReadAheadCache::WindowListType
+GDALReadAheadCache
+::PredictNextWindows(const Window & previous,
+                     const Window & current,
+                     int rasterWidth,
+                     int rasterHeight,
+                     unsigned int count)
+{
+  WindowListType predicted;
+
+  // Only regular patterns are extrapolated
+  if (previous.width != current.width || previous.height != current.height)
+    {
+    return predicted;
+    }
+
+  const int dx = current.x - previous.x;
+  const int dy = current.y - previous.y;
+
+  if ((dx == 0 && dy == 0) || dx < 0 || dy < 0)
+    {
+    return predicted;
+    }
+
+  Window next = current;
+  for (unsigned int i = 0; i < count; ++i)
+    {
+    next.x += dx;
+    next.y += dy;
+
+    if (dy == 0 && next.x >= rasterWidth)
+      {
+      // End of a row of tiles: go to the beginning of the next row
+      next.x = 0;
+      next.y += current.height;
+      }
+
+    if (next.x >= rasterWidth || next.y >= rasterHeight)
+      {
+      break;
+      }
+
+    Window cropped = next;
+    cropped.width = std::min(cropped.width, rasterWidth - cropped.x);
+    cropped.height = std::min(cropped.height, rasterHeight - cropped.y);
+    predicted.push_back(cropped);
+    }
+
+  return predicted;
+}
+
+GDALReadAheadCache::Window
+GDALReadAheadCache
+::AlignToBlocks(const Window & window,
+                int blockWidth,
+                int blockHeight,
+                int rasterWidth,
+                int rasterHeight)
+{
+  blockWidth = std::max(1, blockWidth);
+  blockHeight = std::max(1, blockHeight);
+
+  const int x0 = (window.x / blockWidth) * blockWidth;
+  const int y0 = (window.y / blockHeight) * blockHeight;
+  const int x1 = std::min(rasterWidth,
+                          ((window.x + window.width + blockWidth - 1) / blockWidth) * blockWidth);
+  const int y1 = std::min(rasterHeight,
+                          ((window.y + window.height + blockHeight - 1) / blockHeight) * blockHeight);
+
+  return Window(x0, y0, x1 - x0, y1 - y0);
+}
+
+GDALReadAheadCache::EntryListType::iterator
+GDALReadAheadCache
+::FindEntryUnsafe(const Window & window)
+{
+  for (EntryListType::iterator it = m_Entries.begin(); it != m_Entries.end(); ++it)
+    {
+    if (!it->failed && it->window.Contains(window))
+      {
+      return it;
+      }
+    }
+  return m_Entries.end();
+}
+
+bool
+GDALReadAheadCache
+::Fetch(const Window & window, void * buffer)
+{
+  itk::MutexLockHolder<itk::SimpleMutexLock> lock(m_Mutex);
+
+  EntryListType::iterator it = this->FindEntryUnsafe(window);
+  if (it == m_Entries.end())
+    {
+    ++m_NumberOfMisses;
+    return false;
+    }
+
+  // The window is being read in the background: wait for it
+  if (!it->ready && !it->failed)
+    {
+    TraceScope traceScope("Wait for read-ahead", "wait");
+    while (!it->ready && !it->failed)
+      {
+      m_EntryReady->Wait(&m_Mutex);
+      }
+    }
+
+  if (it->failed)
+    {
+    ++m_NumberOfMisses;
+    return false;
+    }
+
+  // Copy the requested window, line by line
+  const size_t pixelSize = static_cast<size_t>(m_BytePerPixel) * m_NbBands;
+  const size_t lineSize = pixelSize * window.width;
+  const size_t entryLineSize = pixelSize * it->window.width;
+  const unsigned char * src = it->data.data()
+    + (window.y - it->window.y) * entryLineSize
+    + (window.x - it->window.x) * pixelSize;
+  unsigned char * dst = static_cast<unsigned char *>(buffer);
+
+  for (int line = 0; line < window.height; ++line)
+    {
+    std::memcpy(dst, src, lineSize);
+    dst += lineSize;
+    src += entryLineSize;
+    }
+
+  ++m_NumberOfHits;
+  return true;
+}
+
+void
+GDALReadAheadCache
+::Advise(const Window & window)
+{
+  if (m_Depth == 0)
+    {
+    return;
+    }
+
+  itk::MutexLockHolder<itk::SimpleMutexLock> lock(m_Mutex);
+
+  WindowListType predicted;
+  if (m_HasPreviousWindow)
+    {
+    predicted = PredictNextWindows(m_PreviousWindow, window, m_RasterWidth, m_RasterHeight, m_Depth);
+    }
+  m_PreviousWindow = window;
+  m_HasPreviousWindow = true;
+
+  bool newWork = false;
+  for (WindowListType::const_iterator wit = predicted.begin(); wit != predicted.end(); ++wit)
+    {
+    if (this->FindEntryUnsafe(*wit) != m_Entries.end())
+      {
+      continue;
+      }
+
+    Entry entry;
+    entry.window = AlignToBlocks(*wit, m_BlockWidth, m_BlockHeight, m_RasterWidth, m_RasterHeight);
+    entry.ready = false;
+    entry.failed = false;
+    m_Entries.push_back(entry);
+    newWork = true;
+    }
+
+  this->EvictUnsafe();
+
+  if (newWork)
+    {
+    if (!m_Running)
+      {
+      m_Closed = false;
+      m_Running = true;
+      m_ThreadId = m_Threader->SpawnThread(ThreadCallback, this);
+      }
+    m_WorkAvailable->Signal();
+    }
+}
+
+void
+GDALReadAheadCache
+::EvictUnsafe()
+{
+  // Keep the windows read ahead, plus the one being consumed
+  const size_t maxEntries = m_Depth + 1;
+
+  EntryListType::iterator it = m_Entries.begin();
+  while (m_Entries.size() > maxEntries && it != m_Entries.end())
+    {
+    if (&(*it) == m_CurrentEntry)
+      {
+      ++it;
+      }
+    else
+      {
+      it = m_Entries.erase(it);
+      }
+    }
+}
+
+void
+GDALReadAheadCache
+::Stop()
+{
+  m_Mutex.Lock();
+  bool running = m_Running;
+  m_Closed = true;
+  m_WorkAvailable->Broadcast();
+  m_Mutex.Unlock();
+
+  if (running)
+    {
+    m_Threader->TerminateThread(m_ThreadId);
+    }
+
+  m_Mutex.Lock();
+  m_Running = false;
+  m_Entries.clear();
+  m_CurrentEntry = nullptr;
+  m_HasPreviousWindow = false;
+  m_Mutex.Unlock();
+
+  m_Dataset = nullptr;
+}
+
+ITK_THREAD_RETURN_TYPE
+GDALReadAheadCache
+::ThreadCallback(void * arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  Self * self = static_cast<Self *>(info->UserData);
+  self->ProcessQueue();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+GDALReadAheadCache
+::ProcessQueue()
+{
+  if (Tracer::GetInstance().IsEnabled())
+    {
+    Tracer::GetInstance().SetCurrentThreadName("Read-ahead");
+    }
+
+  while (true)
+    {
+    m_Mutex.Lock();
+
+    EntryListType::iterator next = m_Entries.end();
+    while (!m_Closed)
+      {
+      next = m_Entries.begin();
+      while (next != m_Entries.end() && (next->ready || next->failed))
+        {
+        ++next;
+        }
+      if (next != m_Entries.end())
+        {
+        break;
+        }
+      m_WorkAvailable->Wait(&m_Mutex);
+      }
+
+    if (m_Closed)
+      {
+      m_Mutex.Unlock();
+      break;
+      }
+
+    // Work on a private copy of the window, the entry may be consumed in
+    // the meantime but can not be evicted while it is the current entry
+    m_CurrentEntry = &(*next);
+    Entry work;
+    work.window = next->window;
+    work.ready = false;
+    work.failed = false;
+    m_Mutex.Unlock();
+
+    const bool success = this->ReadEntry(work);
+
+    m_Mutex.Lock();
+    m_CurrentEntry->data.swap(work.data);
+    m_CurrentEntry->ready = success;
+    m_CurrentEntry->failed = !success;
+    m_CurrentEntry = nullptr;
+    m_EntryReady->Broadcast();
+    m_Mutex.Unlock();
+    }
+}
+
+bool
+GDALReadAheadCache
+::ReadEntry(Entry & entry)
+{
+  if (m_Dataset.IsNull())
+    {
+    // A dataset handle must not be shared between threads
+    m_Dataset = GDALDriverManagerWrapper::GetInstance().Open(m_DatasetName);
+    if (m_Dataset.IsNull())
+      {
+      return false;
+      }
+    }
+
+  const int pixelOffset = m_BytePerPixel * m_NbBands;
+  entry.data.resize(static_cast<size_t>(pixelOffset) * entry.window.width * entry.window.height);
+
+  TraceScope traceScope("Read ahead", "io");
+  traceScope.AddArgument("file", m_DatasetName);
+  traceScope.AddArgument("bytes", entry.data.size());
+
+  otbLogMacro(Debug,<<"GDAL reads ahead ["<<entry.window.x<<", "<<entry.window.x+entry.window.width-1<<"]x["
+              <<entry.window.y<<", "<<entry.window.y+entry.window.height-1<<"] from "<<m_DatasetName);
+
+  CPLErr lCrGdal = m_Dataset->GetDataSet()->RasterIO(GF_Read,
+                                                     entry.window.x,
+                                                     entry.window.y,
+                                                     entry.window.width,
+                                                     entry.window.height,
+                                                     entry.data.data(),
+                                                     entry.window.width,
+                                                     entry.window.height,
+                                                     static_cast<GDALDataType>(m_DataType),
+                                                     m_NbBands,
+                                                     nullptr,
+                                                     pixelOffset,
+                                                     pixelOffset * entry.window.width,
+                                                     m_BytePerPixel);
+  return lCrGdal != CE_Failure;
+}
+
+void
+GDALReadAheadCache
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Depth: " << m_Depth << std::endl;
+  os << indent << "Block size: " << m_BlockWidth << "x" << m_BlockHeight << std::endl;
+  os << indent << "Hits: " << m_NumberOfHits << std::endl;
+  os << indent << "Misses: " << m_NumberOfMisses << std::endl;
+}
+
+} // end namespace otb
@@ -0,0 +1,497 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbGDALTiffDirectWriter.h"
+#include "otbGDALDatasetWrapper.h"
+#include "otbGDALDriverManagerWrapper.h"
+#include "otbMacro.h"
+#include "itkMutexLockHolder.h"
+
+#include "gdal_priv.h"
+#include "cpl_vsi.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace otb
+{
+
+namespace
+{
+const unsigned int TiffTagTileOffsets = 324;
+const unsigned int TiffTagTileByteCounts = 325;
+
+/** Decode an unsigned integer of size bytes in the byte order of the file */
+unsigned long long DecodeUnsigned(const unsigned char * bytes, unsigned int size, bool bigEndian)
+{
+  unsigned long long value = 0;
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    value |= static_cast<unsigned long long>(bytes[bigEndian ? size - 1 - i : i]) << (8 * i);
+    }
+  return value;
+}
+
+/** Encode an unsigned integer of size bytes in the byte order of the file */
+void EncodeUnsigned(unsigned char * bytes, unsigned int size, bool bigEndian, unsigned long long value)
+{
+  for (unsigned int i = 0; i < size; ++i)
+    {
+    bytes[bigEndian ? size - 1 - i : i] = static_cast<unsigned char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+bool ReadBytes(VSILFILE * handle, vsi_l_offset offset, unsigned char * bytes, size_t count)
+{
+  return VSIFSeekL(handle, offset, SEEK_SET) == 0 && VSIFReadL(bytes, 1, count, handle) == count;
+}
+
+bool WriteBytes(VSILFILE * handle, vsi_l_offset offset, const unsigned char * bytes, size_t count)
+{
+  return VSIFSeekL(handle, offset, SEEK_SET) == 0 && VSIFWriteL(bytes, 1, count, handle) == count;
+}
+
+/** Size of the elements of a TIFF directory entry of type SHORT, LONG
+ * or LONG8, 0 for the other types */
+unsigned int TiffElementSize(unsigned int type)
+{
+  switch (type)
+    {
+    case 3:
+      return 2;
+    case 4:
+      return 4;
+    case 16:
+      return 8;
+    default:
+      return 0;
+    }
+}
+
+/** Array of unsigned integers of a TIFF directory entry */
+struct TiffArrayEntry
+{
+  TiffArrayEntry() : elementSize(0), count(0), offset(0) {}
+
+  unsigned int       elementSize;
+  unsigned long long count;
+  vsi_l_offset       offset;
+};
+}
+
+GDALTiffDirectWriter
+::GDALTiffDirectWriter()
+  : m_RasterWidth(0),
+    m_RasterHeight(0),
+    m_BlockWidth(0),
+    m_BlockHeight(0),
+    m_BlocksPerRow(0),
+    m_PixelSize(0)
+{
+}
+
+GDALTiffDirectWriter
+::~GDALTiffDirectWriter()
+{
+  this->Close();
+}
+
+void
+GDALTiffDirectWriter
+::Open(const std::string & filename)
+{
+  this->Close();
+  m_BlockOffsets.clear();
+
+  GDALDatasetWrapper::Pointer wrapper = GDALDriverManagerWrapper::GetInstance().Open(filename);
+  if (wrapper.IsNull())
+    {
+    itkExceptionMacro(<< "Unable to open " << filename << " for direct writing: " << CPLGetLastErrorMsg());
+    }
+  GDALDataset * dataset = wrapper->GetDataSet();
+
+  if (std::string(dataset->GetDriver()->GetDescription()) != "GTiff")
+    {
+    itkExceptionMacro(<< "Direct writing requires a GeoTIFF file: " << filename);
+    }
+
+  const char * compression = dataset->GetMetadataItem("COMPRESSION", "IMAGE_STRUCTURE");
+  if (compression != nullptr && !EQUAL(compression, "NONE"))
+    {
+    itkExceptionMacro(<< "Direct writing requires an uncompressed file, " << filename << " is compressed with " << compression);
+    }
+
+  const int nbBands = dataset->GetRasterCount();
+  const char * interleave = dataset->GetMetadataItem("INTERLEAVE", "IMAGE_STRUCTURE");
+  if (nbBands > 1 && (interleave == nullptr || !EQUAL(interleave, "PIXEL")))
+    {
+    itkExceptionMacro(<< "Direct writing requires a pixel interleaved file: " << filename);
+    }
+
+  GDALRasterBand * band = dataset->GetRasterBand(1);
+  band->GetBlockSize(&m_BlockWidth, &m_BlockHeight);
+
+  m_RasterWidth = dataset->GetRasterXSize();
+  m_RasterHeight = dataset->GetRasterYSize();
+  m_PixelSize = nbBands * (GDALGetDataTypeSize(band->GetRasterDataType()) / 8);
+  m_BlocksPerRow = (m_RasterWidth + m_BlockWidth - 1) / m_BlockWidth;
+  const int blocksPerColumn = (m_RasterHeight + m_BlockHeight - 1) / m_BlockHeight;
+
+  // Blocks are either all allocated with their full size, or none of
+  // them when the file has been created sparse
+  const unsigned long long blockSize = static_cast<unsigned long long>(m_BlockWidth) * m_BlockHeight * m_PixelSize;
+  std::vector<unsigned long long> blockOffsets(static_cast<size_t>(m_BlocksPerRow) * blocksPerColumn, 0);
+  size_t nbAllocatedBlocks = 0;
+
+  for (int by = 0; by < blocksPerColumn; ++by)
+    {
+    for (int bx = 0; bx < m_BlocksPerRow; ++bx)
+      {
+      std::ostringstream offsetKey, sizeKey;
+      offsetKey << "BLOCK_OFFSET_" << bx << "_" << by;
+      sizeKey << "BLOCK_SIZE_" << bx << "_" << by;
+
+      const char * offset = band->GetMetadataItem(offsetKey.str().c_str(), "TIFF");
+      if (offset == nullptr || std::strtoull(offset, nullptr, 10) == 0)
+        {
+        continue;
+        }
+
+      const char * size = band->GetMetadataItem(sizeKey.str().c_str(), "TIFF");
+      if (size == nullptr || std::strtoull(size, nullptr, 10) != blockSize)
+        {
+        itkExceptionMacro(<< "Block (" << bx << ", " << by << ") of " << filename << " is not allocated with its full size for direct writing");
+        }
+      blockOffsets[by * m_BlocksPerRow + bx] = std::strtoull(offset, nullptr, 10);
+      ++nbAllocatedBlocks;
+      }
+    }
+
+  // The TIFF directory is only updated once GDAL has closed the file
+  wrapper = nullptr;
+  m_FileName = filename;
+
+  if (nbAllocatedBlocks == 0)
+    {
+    this->AllocateBlocks(blockSize);
+    }
+  else if (nbAllocatedBlocks == blockOffsets.size())
+    {
+    m_BlockOffsets.swap(blockOffsets);
+    }
+  else
+    {
+    itkExceptionMacro(<< "Only " << nbAllocatedBlocks << " blocks out of " << blockOffsets.size()
+                      << " are allocated in " << filename << ", direct writing is not possible");
+    }
+
+  otbLogMacro(Debug,<< "Direct writing to " << filename << ", " << m_BlockOffsets.size()
+              << " blocks of " << m_BlockWidth << "x" << m_BlockHeight);
+}
+
+void
+GDALTiffDirectWriter
+::Close()
+{
+  itk::MutexLockHolder<itk::SimpleMutexLock> lock(m_Mutex);
+  for (std::vector<void *>::iterator it = m_Handles.begin(); it != m_Handles.end(); ++it)
+    {
+    VSIFCloseL(static_cast<VSILFILE *>(*it));
+    }
+  m_Handles.clear();
+}
+
+void *
+GDALTiffDirectWriter
+::AcquireHandle()
+{
+  {
+  itk::MutexLockHolder<itk::SimpleMutexLock> lock(m_Mutex);
+  if (!m_Handles.empty())
+    {
+    void * handle = m_Handles.back();
+    m_Handles.pop_back();
+    return handle;
+    }
+  }
+
+  VSILFILE * handle = VSIFOpenL(m_FileName.c_str(), "r+b");
+  if (handle == nullptr)
+    {
+    itkExceptionMacro(<< "Unable to open " << m_FileName << " for direct writing");
+    }
+  return handle;
+}
+
+void
+GDALTiffDirectWriter
+::ReleaseHandle(void * handle)
+{
+  itk::MutexLockHolder<itk::SimpleMutexLock> lock(m_Mutex);
+  m_Handles.push_back(handle);
+}
+
+void
+GDALTiffDirectWriter
+::AllocateBlocks(unsigned long long blockSize)
+{
+  const size_t nbBlocks = static_cast<size_t>(m_BlocksPerRow) * ((m_RasterHeight + m_BlockHeight - 1) / m_BlockHeight);
+
+  VSILFILE * handle = VSIFOpenL(m_FileName.c_str(), "r+b");
+  if (handle == nullptr)
+    {
+    itkExceptionMacro(<< "Unable to open " << m_FileName << " for direct writing");
+    }
+
+  // Locate the tile offsets and byte counts in the first directory, of a
+  // classic TIFF or a BigTIFF
+  std::string error;
+  unsigned char header[16];
+  bool bigEndian = false;
+  bool bigTiff = false;
+  TiffArrayEntry offsetsEntry, byteCountsEntry;
+
+  if (!ReadBytes(handle, 0, header, 8))
+    {
+    error = "unable to read the TIFF header";
+    }
+  else
+    {
+    bigEndian = header[0] == 'M';
+    const unsigned long long version = DecodeUnsigned(header + 2, 2, bigEndian);
+    bigTiff = version == 43;
+    if (version != 42 && version != 43)
+      {
+      error = "unknown TIFF version";
+      }
+    else if (bigTiff && !ReadBytes(handle, 8, header + 8, 8))
+      {
+      error = "unable to read the BigTIFF header";
+      }
+    }
+
+  if (error.empty())
+    {
+    const unsigned int fieldSize = bigTiff ? 8 : 4;
+    const unsigned int entryCountSize = bigTiff ? 8 : 2;
+    const unsigned int entrySize = bigTiff ? 20 : 12;
+    const vsi_l_offset directoryOffset = bigTiff ? DecodeUnsigned(header + 8, 8, bigEndian)
+                                                 : DecodeUnsigned(header + 4, 4, bigEndian);
+
+    unsigned char bytes[20];
+    if (!ReadBytes(handle, directoryOffset, bytes, entryCountSize))
+      {
+      error = "unable to read the TIFF directory";
+      }
+    const unsigned long long nbEntries = error.empty() ? DecodeUnsigned(bytes, entryCountSize, bigEndian) : 0;
+
+    for (unsigned long long i = 0; i < nbEntries && error.empty(); ++i)
+      {
+      const vsi_l_offset entryOffset = directoryOffset + entryCountSize + i * entrySize;
+      if (!ReadBytes(handle, entryOffset, bytes, entrySize))
+        {
+        error = "unable to read the TIFF directory";
+        break;
+        }
+
+      const unsigned long long tag = DecodeUnsigned(bytes, 2, bigEndian);
+      if (tag != TiffTagTileOffsets && tag != TiffTagTileByteCounts)
+        {
+        continue;
+        }
+
+      TiffArrayEntry & entry = tag == TiffTagTileOffsets ? offsetsEntry : byteCountsEntry;
+      entry.elementSize = TiffElementSize(static_cast<unsigned int>(DecodeUnsigned(bytes + 2, 2, bigEndian)));
+      entry.count = DecodeUnsigned(bytes + 4, fieldSize, bigEndian);
+
+      // Small arrays are stored in the entry itself
+      if (entry.elementSize * entry.count <= fieldSize)
+        {
+        entry.offset = entryOffset + 4 + fieldSize;
+        }
+      else
+        {
+        entry.offset = DecodeUnsigned(bytes + 4 + fieldSize, fieldSize, bigEndian);
+        }
+      }
+    }
+
+  if (error.empty()
+      && (offsetsEntry.elementSize == 0 || byteCountsEntry.elementSize == 0
+          || offsetsEntry.count != nbBlocks || byteCountsEntry.count != nbBlocks))
+    {
+    error = "unexpected tile offsets or byte counts";
+    }
+
+  // Blocks are placed one after the other at the end of the file
+  std::vector<unsigned long long> blockOffsets(nbBlocks);
+  vsi_l_offset endOfBlocks = 0;
+  if (error.empty())
+    {
+    VSIFSeekL(handle, 0, SEEK_END);
+    const vsi_l_offset firstBlockOffset = VSIFTellL(handle);
+    for (size_t i = 0; i < nbBlocks; ++i)
+      {
+      blockOffsets[i] = firstBlockOffset + i * blockSize;
+      }
+    endOfBlocks = firstBlockOffset + nbBlocks * blockSize;
+
+    const unsigned long long maxOffset = offsetsEntry.elementSize == 8 ? ~0ULL : (1ULL << (8 * offsetsEntry.elementSize)) - 1;
+    const unsigned long long maxByteCount = byteCountsEntry.elementSize == 8 ? ~0ULL : (1ULL << (8 * byteCountsEntry.elementSize)) - 1;
+    if (blockOffsets.back() > maxOffset || blockSize > maxByteCount)
+      {
+      error = "blocks do not fit in a classic TIFF, BIGTIFF=YES is required";
+      }
+    }
+
+  if (error.empty())
+    {
+    std::vector<unsigned char> offsets(offsetsEntry.elementSize * nbBlocks);
+    std::vector<unsigned char> byteCounts(byteCountsEntry.elementSize * nbBlocks);
+    for (size_t i = 0; i < nbBlocks; ++i)
+      {
+      EncodeUnsigned(&offsets[i * offsetsEntry.elementSize], offsetsEntry.elementSize, bigEndian, blockOffsets[i]);
+      EncodeUnsigned(&byteCounts[i * byteCountsEntry.elementSize], byteCountsEntry.elementSize, bigEndian, blockSize);
+      }
+
+    // The file is extended by its last byte only: the blocks are not
+    // filled, each of them is written once by WriteRegion()
+    const unsigned char lastByte = 0;
+    if (!WriteBytes(handle, offsetsEntry.offset, offsets.data(), offsets.size())
+        || !WriteBytes(handle, byteCountsEntry.offset, byteCounts.data(), byteCounts.size())
+        || !WriteBytes(handle, endOfBlocks - 1, &lastByte, 1))
+      {
+      error = "unable to update the TIFF directory";
+      }
+    }
+
+  if (VSIFCloseL(handle) != 0 && error.empty())
+    {
+    error = "unable to update the TIFF directory";
+    }
+
+  if (!error.empty())
+    {
+    itkExceptionMacro(<< "Unable to allocate the blocks of " << m_FileName << " for direct writing: " << error);
+    }
+
+  m_BlockOffsets.swap(blockOffsets);
+}
+
+void
+GDALTiffDirectWriter
+::WriteRegion(int x, int y, int width, int height, const void * buffer)
+{
+  if (m_BlockOffsets.empty())
+    {
+    itkExceptionMacro(<< "No file opened for direct writing");
+    }
+
+  if (x < 0 || y < 0 || width <= 0 || height <= 0
+      || x + width > m_RasterWidth || y + height > m_RasterHeight)
+    {
+    itkExceptionMacro(<< "Region [" << x << ", " << y << ", " << width << ", " << height
+                      << "] is outside of " << m_FileName);
+    }
+
+  VSILFILE * handle = static_cast<VSILFILE *>(this->AcquireHandle());
+
+  const unsigned char * data = static_cast<const unsigned char *>(buffer);
+  const size_t bufferLineSize = static_cast<size_t>(width) * m_PixelSize;
+  const size_t blockLineSize = static_cast<size_t>(m_BlockWidth) * m_PixelSize;
+  std::vector<unsigned char> staging;
+  bool failed = false;
+
+  const int firstBlockY = y / m_BlockHeight;
+  const int lastBlockY = (y + height - 1) / m_BlockHeight;
+  const int firstBlockX = x / m_BlockWidth;
+  const int lastBlockX = (x + width - 1) / m_BlockWidth;
+
+  for (int by = firstBlockY; by <= lastBlockY && !failed; ++by)
+    {
+    const int y0 = std::max(y, by * m_BlockHeight);
+    const int y1 = std::min(y + height, (by + 1) * m_BlockHeight);
+
+    for (int bx = firstBlockX; bx <= lastBlockX && !failed; ++bx)
+      {
+      const int x0 = std::max(x, bx * m_BlockWidth);
+      const int x1 = std::min(x + width, (bx + 1) * m_BlockWidth);
+      const size_t chunkSize = static_cast<size_t>(x1 - x0) * m_PixelSize;
+      const unsigned long long blockOffset = m_BlockOffsets[by * m_BlocksPerRow + bx];
+
+      const unsigned char * src = data
+        + static_cast<size_t>(y0 - y) * bufferLineSize
+        + static_cast<size_t>(x0 - x) * m_PixelSize;
+
+      if (chunkSize == blockLineSize)
+        {
+        // Full block lines are contiguous in the file: one single write
+        const size_t count = chunkSize * (y1 - y0);
+        const unsigned char * chunk = src;
+        if (bufferLineSize != blockLineSize)
+          {
+          staging.resize(count);
+          for (int line = y0; line < y1; ++line)
+            {
+            std::memcpy(&staging[(line - y0) * chunkSize], src + (line - y0) * bufferLineSize, chunkSize);
+            }
+          chunk = staging.data();
+          }
+
+        const vsi_l_offset offset = blockOffset + static_cast<vsi_l_offset>(y0 - by * m_BlockHeight) * blockLineSize;
+        failed = VSIFSeekL(handle, offset, SEEK_SET) != 0
+          || VSIFWriteL(chunk, 1, count, handle) != count;
+        }
+      else
+        {
+        for (int line = y0; line < y1 && !failed; ++line)
+          {
+          const vsi_l_offset offset = blockOffset
+            + static_cast<vsi_l_offset>(line - by * m_BlockHeight) * blockLineSize
+            + static_cast<vsi_l_offset>(x0 - bx * m_BlockWidth) * m_PixelSize;
+          failed = VSIFSeekL(handle, offset, SEEK_SET) != 0
+            || VSIFWriteL(src + (line - y0) * bufferLineSize, 1, chunkSize, handle) != chunkSize;
+          }
+        }
+      }
+    }
+
+  this->ReleaseHandle(handle);
+
+  if (failed)
+    {
+    itkExceptionMacro(<< "Error while writing region [" << x << ", " << y << ", " << width << ", " << height
+                      << "] to " << m_FileName);
+    }
+}
+
+void
+GDALTiffDirectWriter
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Block size: " << m_BlockWidth << "x" << m_BlockHeight << std::endl;
+  os << indent << "Number of blocks: " << m_BlockOffsets.size() << std::endl;
+}
+
+} // end namespace otb
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbGDALBlockCache.h"
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+#include "otbImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+
+#include <iostream>
+
+typedef otb::GDALBlockCache::BlockKey         BlockKeyType;
+typedef otb::GDALBlockCache::BlockDataType    BlockDataType;
+typedef otb::GDALBlockCache::BlockPointerType BlockPointerType;
+
+int otbGDALBlockCache(int argc, char* argv[])
+{
+  if (argc != 3)
+    {
+    std::cerr << "Usage: " << argv[0] << " <input image> <output image>" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  otb::GDALBlockCache & cache = otb::GDALBlockCache::GetInstance();
+  cache.Clear();
+  cache.ResetCounters();
+
+  // 100 bytes per stripe
+  cache.SetCapacity(100 * otb::GDALBlockCache::NumberOfStripes);
+
+  BlockKeyType key("file.tif", 0, 1, 2, 3);
+  if (cache.Get(key))
+    {
+    std::cerr << "Empty cache should not hold any block" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  cache.Insert(key, std::make_shared<BlockDataType>(60, 42));
+  BlockPointerType block = cache.Get(key);
+  if (!block || block->size() != 60 || (*block)[0] != 42)
+    {
+    std::cerr << "Inserted block not found" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (cache.GetNumberOfHits() != 1 || cache.GetNumberOfMisses() != 1)
+    {
+    std::cerr << "Expected 1 hit and 1 miss, got " << cache.GetNumberOfHits() << " and "
+              << cache.GetNumberOfMisses() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Blocks larger than a stripe are not cached
+  BlockKeyType largeKey("file.tif", 0, 1, 0, 0);
+  cache.Insert(largeKey, std::make_shared<BlockDataType>(200));
+  if (cache.Get(largeKey))
+    {
+    std::cerr << "Block larger than a stripe should not be cached" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // The cache never grows beyond its capacity, and the last inserted
+  // block is always available
+  for (int i = 0; i < 1000; ++i)
+    {
+    BlockKeyType k("other.tif", i % 3, 1 + i % 4, i, 2 * i);
+    cache.Insert(k, std::make_shared<BlockDataType>(50));
+    if (!cache.Get(k))
+      {
+      std::cerr << "Last inserted block was evicted" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (cache.GetSize() > cache.GetCapacity())
+      {
+      std::cerr << "Cache size " << cache.GetSize() << " exceeds capacity " << cache.GetCapacity() << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // The block held outside of the cache stays valid after eviction
+  if (block->size() != 60 || (*block)[59] != 42)
+    {
+    std::cerr << "Block data changed after eviction" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  cache.Invalidate("other.tif");
+  if (cache.GetSize() != (cache.Get(key) ? 60u : 0u))
+    {
+    std::cerr << "Invalidated blocks still in the cache" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Two readers of the same file: the second one is served by the cache,
+  // with the same pixels
+  typedef otb::VectorImage<double, 2>           ImageType;
+  typedef otb::ImageFileReader<ImageType>       ReaderType;
+
+  cache.SetCapacity(64 * 1024 * 1024);
+  cache.Clear();
+  cache.ResetCounters();
+
+  ReaderType::Pointer reader1 = ReaderType::New();
+  reader1->SetFileName(argv[1]);
+  reader1->Update();
+
+  const unsigned long long misses = cache.GetNumberOfMisses();
+  if (misses == 0 || cache.GetNumberOfHits() != 0)
+    {
+    std::cerr << "First reader should only miss, got " << cache.GetNumberOfHits() << " hits and "
+              << misses << " misses" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  ReaderType::Pointer reader2 = ReaderType::New();
+  reader2->SetFileName(argv[1]);
+  reader2->Update();
+
+  if (cache.GetNumberOfMisses() != misses || cache.GetNumberOfHits() != misses)
+    {
+    std::cerr << "Second reader should only hit, got " << cache.GetNumberOfHits() << " hits and "
+              << cache.GetNumberOfMisses() - misses << " misses" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  itk::ImageRegionConstIterator<ImageType> it1(reader1->GetOutput(), reader1->GetOutput()->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> it2(reader2->GetOutput(), reader2->GetOutput()->GetLargestPossibleRegion());
+  for (it1.GoToBegin(), it2.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2)
+    {
+    if (it1.Get() != it2.Get())
+      {
+      std::cerr << "Pixel " << it1.GetIndex() << " differs between the two readers" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Overwriting a file invalidates its cached blocks
+  typedef otb::ImageFileWriter<ImageType>       WriterType;
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(argv[2]);
+  writer->SetInput(reader1->GetOutput());
+  writer->Update();
+
+  ReaderType::Pointer reader3 = ReaderType::New();
+  reader3->SetFileName(argv[2]);
+  reader3->Update();
+
+  ImageType::Pointer constant = ImageType::New();
+  constant->CopyInformation(reader1->GetOutput());
+  constant->SetRegions(reader1->GetOutput()->GetLargestPossibleRegion());
+  constant->SetNumberOfComponentsPerPixel(reader1->GetOutput()->GetNumberOfComponentsPerPixel());
+  constant->Allocate();
+  ImageType::PixelType value(constant->GetNumberOfComponentsPerPixel());
+  value.Fill(7.);
+  constant->FillBuffer(value);
+
+  WriterType::Pointer overwriter = WriterType::New();
+  overwriter->SetFileName(argv[2]);
+  overwriter->SetInput(constant);
+  overwriter->Update();
+
+  ReaderType::Pointer reader4 = ReaderType::New();
+  reader4->SetFileName(argv[2]);
+  reader4->Update();
+
+  itk::ImageRegionConstIterator<ImageType> it4(reader4->GetOutput(), reader4->GetOutput()->GetLargestPossibleRegion());
+  for (it4.GoToBegin(); !it4.IsAtEnd(); ++it4)
+    {
+    if (it4.Get() != value)
+      {
+      std::cerr << "Pixel " << it4.GetIndex() << " of the overwritten file is served from the cache" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  cache.SetCapacity(0);
+  cache.Clear();
+
+  return EXIT_SUCCESS;
+}
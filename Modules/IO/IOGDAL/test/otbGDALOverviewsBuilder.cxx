@@ -65,5 +65,23 @@ int otbGDALOverviewsBuilder(int itkNotUsed(argc), char* argv[])
     return EXIT_FAILURE;
     }
 
+  // The closest overview not coarser than the decimation is selected
+  const unsigned int coarsest = nbResolution - 1;
+  const unsigned int decimations[] = {1, 2, 3, 4, 7, 1u << (coarsest + 2)};
+  for (unsigned int decimation : decimations)
+    {
+    unsigned int expected = 0;
+    while (expected < coarsest && (2u << expected) <= decimation)
+      {
+      ++expected;
+      }
+    if (io->GetNativeResolutionFactor(decimation) != expected)
+      {
+      std::cout << "Got resolution factor " << io->GetNativeResolutionFactor(decimation)
+                << " for a decimation of " << decimation << ", expected " << expected << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
   return EXIT_SUCCESS;
 }
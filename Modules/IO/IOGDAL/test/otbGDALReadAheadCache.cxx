@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "otbGDALReadAheadCache.h"
+
+#include <iostream>
+
+typedef otb::GDALReadAheadCache::Window         WindowType;
+typedef otb::GDALReadAheadCache::WindowListType WindowListType;
+
+static bool CheckWindow(const WindowType & w, const WindowType & expected, const char * label)
+{
+  if (!(w == expected))
+    {
+    std::cerr << label << ": got [" << w.x << ", " << w.y << ", " << w.width << ", " << w.height
+              << "], expected [" << expected.x << ", " << expected.y << ", " << expected.width
+              << ", " << expected.height << "]" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+int otbGDALReadAheadCache(int itkNotUsed(argc), char* itkNotUsed(argv)[])
+{
+  bool ok = true;
+
+  // Strips of 100 lines on a 500x250 raster: the last one is cropped
+  WindowListType strips = otb::GDALReadAheadCache::PredictNextWindows(
+    WindowType(0, 0, 500, 100), WindowType(0, 100, 500, 100), 500, 250, 3);
+  if (strips.size() != 1)
+    {
+    std::cerr << "Strips: got " << strips.size() << " windows, expected 1" << std::endl;
+    return EXIT_FAILURE;
+    }
+  ok &= CheckWindow(strips[0], WindowType(0, 200, 500, 50), "Strips");
+
+  // Tiles of 200x100 on a 500x250 raster: wrap to the next row of tiles
+  WindowListType tiles = otb::GDALReadAheadCache::PredictNextWindows(
+    WindowType(0, 0, 200, 100), WindowType(200, 0, 200, 100), 500, 250, 2);
+  if (tiles.size() != 2)
+    {
+    std::cerr << "Tiles: got " << tiles.size() << " windows, expected 2" << std::endl;
+    return EXIT_FAILURE;
+    }
+  ok &= CheckWindow(tiles[0], WindowType(400, 0, 100, 100), "Tiles 1");
+  ok &= CheckWindow(tiles[1], WindowType(0, 100, 200, 100), "Tiles 2");
+
+  // No extrapolation of irregular or backward requests
+  if (!otb::GDALReadAheadCache::PredictNextWindows(
+        WindowType(0, 100, 500, 100), WindowType(0, 0, 500, 100), 500, 250, 2).empty()
+      || !otb::GDALReadAheadCache::PredictNextWindows(
+        WindowType(0, 0, 500, 100), WindowType(0, 100, 500, 50), 500, 250, 2).empty())
+    {
+    std::cerr << "Irregular requests should not be extrapolated" << std::endl;
+    ok = false;
+    }
+
+  // Block alignment
+  ok &= CheckWindow(otb::GDALReadAheadCache::AlignToBlocks(WindowType(10, 70, 100, 100), 256, 64, 500, 250),
+                    WindowType(0, 64, 256, 128), "Blocks");
+  ok &= CheckWindow(otb::GDALReadAheadCache::AlignToBlocks(WindowType(300, 200, 200, 50), 256, 64, 500, 250),
+                    WindowType(256, 192, 244, 58), "Cropped blocks");
+
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbGDALTiffDirectWriter.h"
+#include "otbGDALDriverManagerWrapper.h"
+
+#include "gdal_priv.h"
+#include "cpl_string.h"
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int Width = 40;
+const int Height = 35;
+const int NbBands = 3;
+
+unsigned short ExpectedValue(int x, int y, int band)
+{
+  return static_cast<unsigned short>(x + Width * y + Width * Height * band);
+}
+
+/** Create a GeoTIFF with the creation options of concurrent writing */
+bool CreateTiff(const std::string & filename, const char * compression)
+{
+  char ** options = nullptr;
+  options = CSLSetNameValue(options, "TILED", "YES");
+  options = CSLSetNameValue(options, "BLOCKXSIZE", "16");
+  options = CSLSetNameValue(options, "BLOCKYSIZE", "16");
+  options = CSLSetNameValue(options, "COMPRESS", compression);
+  options = CSLSetNameValue(options, "INTERLEAVE", "PIXEL");
+  options = CSLSetNameValue(options, "SPARSE_OK", "TRUE");
+  options = CSLSetNameValue(options, "ENDIANNESS", "NATIVE");
+
+  otb::GDALDatasetWrapper::Pointer dataset = otb::GDALDriverManagerWrapper::GetInstance().Create(
+    "GTiff", filename, Width, Height, NbBands, GDT_UInt16, options);
+  CSLDestroy(options);
+  return dataset.IsNotNull();
+}
+
+/** Write the pixels of a region, pixel interleaved */
+void WriteRegion(otb::GDALTiffDirectWriter * writer, int x, int y, int width, int height)
+{
+  std::vector<unsigned short> buffer(static_cast<size_t>(width) * height * NbBands);
+  for (int j = 0; j < height; ++j)
+    {
+    for (int i = 0; i < width; ++i)
+      {
+      for (int b = 0; b < NbBands; ++b)
+        {
+        buffer[(j * width + i) * NbBands + b] = ExpectedValue(x + i, y + j, b);
+        }
+      }
+    }
+  writer->WriteRegion(x, y, width, height, buffer.data());
+}
+}
+
+int otbGDALTiffDirectWriter(int argc, char* argv[])
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " <output prefix>" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const std::string filename = std::string(argv[1]) + ".tif";
+  if (!CreateTiff(filename, "NONE"))
+    {
+    std::cerr << "Unable to create " << filename << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // None of the blocks of the sparse file is allocated: Open() allocates them
+  otb::GDALTiffDirectWriter::Pointer writer = otb::GDALTiffDirectWriter::New();
+  writer->Open(filename);
+
+  if (writer->GetBlockWidth() != 16 || writer->GetBlockHeight() != 16
+      || writer->GetPixelSize() != NbBands * sizeof(unsigned short))
+    {
+    std::cerr << "Unexpected layout: blocks of " << writer->GetBlockWidth() << "x" << writer->GetBlockHeight()
+              << ", pixels of " << writer->GetPixelSize() << " bytes" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Regions written concurrently share blocks, and are not aligned on them
+  std::vector<std::thread> threads;
+  threads.emplace_back(WriteRegion, writer.GetPointer(), 0, 0, 23, 20);
+  threads.emplace_back(WriteRegion, writer.GetPointer(), 23, 0, 17, 20);
+  threads.emplace_back(WriteRegion, writer.GetPointer(), 0, 20, Width, Height - 20);
+  for (auto & thread : threads)
+    {
+    thread.join();
+    }
+  writer->Close();
+
+  // Every block is allocated, and GDAL reads back the written pixels
+  otb::GDALDatasetWrapper::Pointer wrapper = otb::GDALDriverManagerWrapper::GetInstance().Open(filename);
+  if (wrapper.IsNull())
+    {
+    std::cerr << "Unable to read back " << filename << std::endl;
+    return EXIT_FAILURE;
+    }
+  GDALDataset * dataset = wrapper->GetDataSet();
+
+  for (int by = 0; by < (Height + 15) / 16; ++by)
+    {
+    for (int bx = 0; bx < (Width + 15) / 16; ++bx)
+      {
+      std::ostringstream key;
+      key << "BLOCK_OFFSET_" << bx << "_" << by;
+      if (dataset->GetRasterBand(1)->GetMetadataItem(key.str().c_str(), "TIFF") == nullptr)
+        {
+        std::cerr << "Block (" << bx << ", " << by << ") is not allocated" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+
+  std::vector<unsigned short> pixels(static_cast<size_t>(Width) * Height * NbBands);
+  if (dataset->RasterIO(GF_Read, 0, 0, Width, Height, pixels.data(), Width, Height, GDT_UInt16,
+                        NbBands, nullptr, NbBands * sizeof(unsigned short),
+                        Width * NbBands * sizeof(unsigned short), sizeof(unsigned short)) != CE_None)
+    {
+    std::cerr << "Unable to read the pixels of " << filename << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for (int y = 0; y < Height; ++y)
+    {
+    for (int x = 0; x < Width; ++x)
+      {
+      for (int b = 0; b < NbBands; ++b)
+        {
+        const unsigned short value = pixels[(y * Width + x) * NbBands + b];
+        if (value != ExpectedValue(x, y, b))
+          {
+          std::cerr << "Pixel (" << x << ", " << y << ") of band " << b << ": got " << value
+                    << ", expected " << ExpectedValue(x, y, b) << std::endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  wrapper = nullptr;
+
+  // Compressed files can not be written directly
+  const std::string compressedFilename = std::string(argv[1]) + "_deflate.tif";
+  if (!CreateTiff(compressedFilename, "DEFLATE"))
+    {
+    std::cerr << "Unable to create " << compressedFilename << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  try
+    {
+    writer->Open(compressedFilename);
+    std::cerr << "Direct writing of a compressed file should fail" << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch (itk::ExceptionObject & err)
+    {
+    std::cout << "Expected exception: " << err.GetDescription() << std::endl;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -26,6 +26,9 @@ void RegisterTests()
   REGISTER_TEST(otbGDALImageIOTest_uint16);
   REGISTER_TEST(otbGDALImageIOTestWriteMetadata);
   REGISTER_TEST(otbGDALOverviewsBuilder);
+  REGISTER_TEST(otbGDALReadAheadCache);
+  REGISTER_TEST(otbGDALBlockCache);
+  REGISTER_TEST(otbGDALTiffDirectWriter);
   REGISTER_TEST(otbGDALImageIOTestCanWrite);
   REGISTER_TEST(otbOGRVectorDataIOCanWrite);
   REGISTER_TEST(otbGDALReadPxlComplexFloat);
@@ -156,6 +156,12 @@ public:
    * Returns: overview info, empty if none.*/
   std::vector<std::string> GetOverviewsInfo();
 
+  /** Get the resolution factor of the native coarser level (overview or
+   * JPEG2000 resolution level) closest to a decimation of the full
+   * resolution, without being coarser.
+   * Returns: resolution factor to use with the resol option, zero if none. */
+  unsigned int GetNativeResolutionFactor(unsigned int decimation);
+
 protected:
   ImageFileReader();
   ~ImageFileReader() override;
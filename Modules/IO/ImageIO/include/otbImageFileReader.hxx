@@ -302,6 +302,10 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
     itk::EncapsulateMetaData<unsigned int>(dict, MetaDataKey::ResolutionFactor, m_AdditionalNumber);
     }
 
+  // Pass the number of regions to read ahead
+  itk::EncapsulateMetaData<unsigned int>(dict, MetaDataKey::PrefetchDepth,
+    m_FilenameHelper->PrefetchDepthIsSet() ? m_FilenameHelper->GetPrefetchDepth() : 0);
+
   // Got to allocate space for the image. Determine the characteristics of
   // the image.
   //
@@ -760,6 +764,16 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>
   return this->m_ImageIO->GetOverviewsInfo();
  }
 
+template <class TOutputImage, class ConvertPixelTraits>
+unsigned int
+ImageFileReader<TOutputImage, ConvertPixelTraits>
+::GetNativeResolutionFactor(unsigned int decimation)
+ {
+  this->UpdateOutputInformation();
+
+  return this->m_ImageIO->GetNativeResolutionFactor(decimation);
+ }
+
 template <class TOutputImage, class ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>
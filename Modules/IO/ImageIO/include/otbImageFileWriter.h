@@ -25,7 +25,11 @@
 #include "itkProcessObject.h"
 #include "otbStreamingManager.h"
 #include "otbExtendedFilenameToWriterOptions.h"
+#include "otbImageIOWriteBehindQueue.h"
+#include "otbPyramidCascade.h"
 #include "itkFastMutexLock.h"
+#include "itkNumericTraits.h"
+#include <memory>
 #include <string>
 
 namespace otb
@@ -48,6 +52,25 @@ namespace otb
  * ImageFileWriter will write directly the streaming buffer in the image file, so
  * that the output image never needs to be completely allocated
  *
+ * In write-behind mode (see SetWriteBehind), each computed division is
+ * handed to a dedicated I/O thread, and the pipeline goes on with the next
+ * division while the previous ones are being encoded and written. The
+ * number of divisions waiting to be written is bounded by the available
+ * RAM (see SetWriteBehindQueueDepth).
+ *
+ * With several I/O threads (see SetNumberOfIOThreads), the divisions are
+ * written concurrently. This requires an ImageIO able to write regions
+ * concurrently: GeoTIFF files are then written uncompressed and tiled,
+ * each division being copied at its offsets in the file, in the same way
+ * as the MPI SimpleParallelTiffWriter does.
+ *
+ * With the extended filename option &cog=ON, a Cloud Optimized GeoTIFF
+ * is written: the image is streamed by strips, and its overviews are
+ * computed from the strips as they are written, with a PyramidCascade,
+ * so that the pipeline runs once. The image and its overviews go to an
+ * uncompressed temporary GeoTIFF, which GDAL reads back once to copy it
+ * to the final layout (see GDALImageIO::SetCloudOptimized()).
+ *
  * ImageFileWriter supports extended filenames, which allow controlling
  * some properties of the output file. See
  * http://wiki.orfeo-toolbox.org/index.php/ExtendedFileName for more
@@ -91,6 +114,12 @@ public:
   /** The Filename Helper. */
   typedef ExtendedFilenameToWriterOptions            FNameHelperType;
 
+  /** Cascade computing the overviews of a Cloud Optimized GeoTIFF, on the
+   *  scalar components of the pixels */
+  typedef typename InputImageType::InternalPixelType                    InternalPixelType;
+  typedef typename itk::NumericTraits<InternalPixelType>::ValueType     OverviewValueType;
+  typedef PyramidCascade<OverviewValueType>                             OverviewCascadeType;
+
   /** Dimension of input image. */
   itkStaticConstMacro(InputImageDimension, unsigned int,
                       InputImageType::ImageDimension);
@@ -161,6 +190,37 @@ public:
    *   is set from the CMake configuration option */
   void SetAutomaticAdaptativeStreaming(unsigned int availableRAM = 0, double bias = 1.0);
 
+  /**  Set the streaming mode to 'block aligned' and configure the number of MB
+   *   available. The actual number of divisions is computed automatically
+   *   by estimating the memory consumption of the pipeline.
+   *   Tiles will follow the block grids of all the input files of the
+   *   pipeline, so that input blocks are decoded only once.
+   *   Setting the availableRAM parameter to 0 means that the available RAM
+   *   is set from the CMake configuration option */
+  void SetAutomaticBlockAlignedStreaming(unsigned int availableRAM = 0, double bias = 1.0);
+
+  /** Enable/disable the write-behind mode: when enabled, the divisions
+   *  are written by a dedicated I/O thread while the next ones are
+   *  computed. This mode can also be enabled through the extended filename
+   *  option &streaming:writebehind=ON. */
+  itkSetMacro(WriteBehind, bool);
+  itkGetConstMacro(WriteBehind, bool);
+  itkBooleanMacro(WriteBehind);
+
+  /** Set/Get the maximum number of divisions waiting to be written in
+   *  write-behind mode. If 0 (default), the depth is computed so that
+   *  pending divisions use at most half of the available RAM. */
+  itkSetMacro(WriteBehindQueueDepth, unsigned int);
+  itkGetConstMacro(WriteBehindQueueDepth, unsigned int);
+
+  /** Set/Get the number of threads writing the divisions. More than one
+   *  thread enables the write-behind mode, with concurrent writes if the
+   *  ImageIO supports them (uncompressed tiled GeoTIFF with GDAL). This
+   *  number can also be set through the extended filename option
+   *  &streaming:iothreads=N. Default is 1. */
+  itkSetMacro(NumberOfIOThreads, unsigned int);
+  itkGetConstMacro(NumberOfIOThreads, unsigned int);
+
   /** Set the only input of the writer */
   using Superclass::SetInput;
   virtual void SetInput(const InputImageType *input);
@@ -244,6 +304,24 @@ private:
     this->UpdateProgress( (m_DivisionProgress + m_CurrentDivision) / m_NumberOfDivisions );
   }
 
+  /** Compute the write-behind queue depth from the available RAM */
+  unsigned int EstimateWriteBehindQueueDepth() const;
+
+  /** Number of I/O threads, from the extended filename or NumberOfIOThreads */
+  unsigned int GetActualNumberOfIOThreads() const;
+
+  /** Setup the streaming and the ImageIO to write a Cloud Optimized
+   *  GeoTIFF of the given region */
+  void PrepareCloudOptimizedWriting(const InputImageRegionType & region);
+
+  /** Create the cascade computing the overviews of a Cloud Optimized
+   *  GeoTIFF, for pixels of nbComponents scalar components */
+  void CreateOverviewCascade(unsigned int nbComponents);
+
+  /** Drop the overview cascade and remove the temporary file of a Cloud
+   *  Optimized GeoTIFF whose writing did not complete */
+  void DiscardCloudOptimizedWriting();
+
   unsigned int m_NumberOfDivisions;
   unsigned int m_CurrentDivision;
   float m_DivisionProgress;
@@ -283,6 +361,15 @@ private:
    *  number of components in the m_BandList (if used) */
   unsigned int m_IOComponents;
 
+  /** Write-behind mode */
+  bool m_WriteBehind;
+  unsigned int m_WriteBehindQueueDepth;
+  unsigned int m_NumberOfIOThreads;
+  ImageIOWriteBehindQueue::Pointer m_WriteBehindQueue;
+
+  /** Overviews of a Cloud Optimized GeoTIFF, fed with the written strips */
+  std::unique_ptr<OverviewCascadeType> m_OverviewCascade;
+
   /** Lock to ensure thread-safety (added for the AbortGenerateData flag) */
   itk::SimpleFastMutexLock m_Lock;
 };
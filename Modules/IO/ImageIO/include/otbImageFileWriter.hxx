@@ -37,6 +37,9 @@
 #include "otbMetaDataKey.h"
 
 #include "otbConfigure.h"
+#include "otbConfigurationManager.h"
+#include "otbPipelineTraceObserver.h"
+#include "otbTracer.h"
 
 #include "otbNumberOfDivisionsStrippedStreamingManager.h"
 #include "otbNumberOfDivisionsTiledStreamingManager.h"
@@ -45,12 +48,15 @@
 #include "otbTileDimensionTiledStreamingManager.h"
 #include "otbRAMDrivenTiledStreamingManager.h"
 #include "otbRAMDrivenAdaptativeStreamingManager.h"
+#include "otbBlockAlignedStreamingManager.h"
 
 #include "otb_boost_tokenizer_header.h"
 
 #include "otbStringUtils.h"
 #include "otbUtils.h"
 
+#include <algorithm>
+
 namespace otb
 {
 
@@ -72,7 +78,10 @@ ImageFileWriter<TInputImage>
     m_FilenameHelper(),
     m_IsObserving(true),
     m_ObserverID(0),
-    m_IOComponents(0)
+    m_IOComponents(0),
+    m_WriteBehind(false),
+    m_WriteBehindQueueDepth(0),
+    m_NumberOfIOThreads(1)
 {
   //Init output index shift
   m_ShiftOutputIndex.Fill(0);
@@ -173,6 +182,18 @@ ImageFileWriter<TInputImage>
   m_StreamingManager = streamingManager;
 }
 
+template <class TInputImage>
+void
+ImageFileWriter<TInputImage>
+::SetAutomaticBlockAlignedStreaming(unsigned int availableRAM, double bias)
+{
+  typedef BlockAlignedStreamingManager<TInputImage> BlockAlignedStreamingManagerType;
+  typename BlockAlignedStreamingManagerType::Pointer streamingManager = BlockAlignedStreamingManagerType::New();
+  streamingManager->SetAvailableRAMInMB(availableRAM);
+  streamingManager->SetBias(bias);
+  m_StreamingManager = streamingManager;
+}
+
 #ifndef ITK_LEGACY_REMOVE
 
 #endif // ITK_LEGACY_REMOVE
@@ -227,6 +248,180 @@ ImageFileWriter<TInputImage>
     {
     os << indent << "FactorySpecifiedmageIO: Off\n";
     }
+
+  os << indent << "WriteBehind: " << (m_WriteBehind ? "On" : "Off") << "\n";
+  os << indent << "WriteBehindQueueDepth: " << m_WriteBehindQueueDepth << "\n";
+  os << indent << "NumberOfIOThreads: " << m_NumberOfIOThreads << "\n";
+}
+
+template <class TInputImage>
+unsigned int
+ImageFileWriter<TInputImage>
+::GetActualNumberOfIOThreads() const
+{
+  if (m_FilenameHelper->StreamingIOThreadsIsSet())
+    {
+    return std::max(1u, m_FilenameHelper->GetStreamingIOThreads());
+    }
+  return std::max(1u, m_NumberOfIOThreads);
+}
+
+template <class TInputImage>
+unsigned int
+ImageFileWriter<TInputImage>
+::EstimateWriteBehindQueueDepth() const
+{
+  if (m_WriteBehindQueueDepth > 0)
+    {
+    return m_WriteBehindQueueDepth;
+    }
+
+  // Pending divisions may use up to half of the RAM budget of the
+  // streaming manager
+  unsigned long long availableRAMInMB = m_StreamingManager->GetDefaultRAM();
+  if (availableRAMInMB == 0)
+    {
+    availableRAMInMB = ConfigurationManager::GetMaxRAMHint();
+    }
+  const unsigned long long availableRAMInBytes = availableRAMInMB * 1024 * 1024 / 2;
+
+  const InputImageType * input = const_cast<Self*>(this)->GetInput();
+  unsigned long long bytesPerPixel = sizeof(typename InputImageType::InternalPixelType);
+  if (strcmp(input->GetNameOfClass(), "VectorImage") == 0)
+    {
+    bytesPerPixel *= input->GetNumberOfComponentsPerPixel();
+    }
+
+  // The first division is the largest one
+  const unsigned long long divisionSizeInBytes =
+    static_cast<unsigned long long>(m_StreamingManager->GetSplit(0).GetNumberOfPixels()) * bytesPerPixel;
+
+  unsigned int depth = ImageIOWriteBehindQueue::EstimateQueueDepth(availableRAMInBytes, divisionSizeInBytes);
+
+  // Keep every I/O thread busy if the RAM budget allows it
+  if (depth < this->GetActualNumberOfIOThreads())
+    {
+    otbLogMacro(Warning,<<"The RAM budget only allows "<<depth<<" divisions waiting to be written, some I/O threads will be idle");
+    }
+
+  // No need for more pending divisions than the divisions left to compute
+  return std::min(depth, std::max(1u, m_NumberOfDivisions - 1));
+}
+
+template <class TInputImage>
+void
+ImageFileWriter<TInputImage>
+::PrepareCloudOptimizedWriting(const InputImageRegionType & region)
+{
+  GDALImageIO * imageIO = dynamic_cast<GDALImageIO*>(m_ImageIO.GetPointer());
+  if (imageIO != nullptr)
+    {
+    // Overviews are written along with the image, by this thread
+    imageIO->SetConcurrentWriting(false);
+    }
+  if (imageIO == nullptr || !imageIO->CanWriteOverviews())
+    {
+    itkExceptionMacro(<< "Cloud Optimized GeoTIFF can not be written to " << m_FileName
+                      << ", only GeoTIFF files support it");
+    }
+
+  // The overviews are computed from strips of full lines
+  const bool stripped =
+    dynamic_cast<RAMDrivenStrippedStreamingManager<TInputImage>*>(m_StreamingManager.GetPointer()) != nullptr
+    || dynamic_cast<NumberOfLinesStrippedStreamingManager<TInputImage>*>(m_StreamingManager.GetPointer()) != nullptr
+    || dynamic_cast<NumberOfDivisionsStrippedStreamingManager<TInputImage>*>(m_StreamingManager.GetPointer()) != nullptr;
+  if (!stripped)
+    {
+    if (m_FilenameHelper->StreamingTypeIsSet())
+      {
+      otbLogMacro(Warning,<<"Cloud Optimized GeoTIFF is written by strips, the streaming type will be ignored.");
+      }
+    unsigned int oldDefaultRAM = m_StreamingManager->GetDefaultRAM();
+    this->SetAutomaticStrippedStreaming(oldDefaultRAM);
+    m_StreamingManager->SetDefaultRAM(oldDefaultRAM);
+    }
+
+  // Decimate until the smallest overview fits in a block of 512 pixels, as
+  // the GDAL COG driver does
+  const unsigned int factor = 2;
+  const unsigned int smallestOverviewSize = 512;
+  unsigned int nbOverviews = 0;
+  while (OverviewCascadeType::GetLevelLength(region.GetSize(0), factor, nbOverviews) > smallestOverviewSize
+         || OverviewCascadeType::GetLevelLength(region.GetSize(1), factor, nbOverviews) > smallestOverviewSize)
+    {
+    ++nbOverviews;
+    }
+
+  imageIO->SetCloudOptimized(true);
+  imageIO->SetNumberOfWrittenOverviews(nbOverviews);
+  imageIO->SetWrittenOverviewsFactor(factor);
+
+  otbLogMacro(Info,<<"File "<<m_FileName<<" will be written as a Cloud Optimized GeoTIFF with "<<nbOverviews<<" overviews");
+}
+
+template <class TInputImage>
+void
+ImageFileWriter<TInputImage>
+::CreateOverviewCascade(unsigned int nbComponents)
+{
+  m_OverviewCascade.reset();
+
+  GDALImageIO * imageIO = dynamic_cast<GDALImageIO*>(m_ImageIO.GetPointer());
+  if (imageIO == nullptr || imageIO->GetNumberOfWrittenOverviews() == 0)
+    {
+    return;
+    }
+
+  typename OverviewCascadeType::ResamplingType resampling = OverviewCascadeType::Average;
+  if (m_FilenameHelper->GetCloudOptimizedResampling() == "nearest")
+    {
+    resampling = OverviewCascadeType::Nearest;
+    }
+  else
+    {
+    // Averaging would mix the no-data pixels with the valid ones
+    std::vector<bool> noDataValueAvailable;
+    itk::ExposeMetaData<std::vector<bool> >(this->GetInput()->GetMetaDataDictionary(),
+                                            MetaDataKey::NoDataValueAvailable, noDataValueAvailable);
+    if (m_FilenameHelper->NoDataValueIsSet()
+        || std::find(noDataValueAvailable.begin(), noDataValueAvailable.end(), true) != noDataValueAvailable.end())
+      {
+      otbLogMacro(Warning,<<"No-data values are set, the overviews of "<<m_FileName<<" are computed with the nearest resampling");
+      resampling = OverviewCascadeType::Nearest;
+      }
+    }
+
+  m_OverviewCascade.reset(new OverviewCascadeType);
+  m_OverviewCascade->SetNumberOfLevels(imageIO->GetNumberOfWrittenOverviews());
+  m_OverviewCascade->SetShrinkFactor(imageIO->GetWrittenOverviewsFactor());
+  m_OverviewCascade->SetResampling(resampling);
+  m_OverviewCascade->SetNumberOfThreads(this->GetNumberOfThreads());
+  m_OverviewCascade->SetCallback([imageIO](unsigned int level, unsigned int firstLine, unsigned int nbLines,
+                                           const OverviewValueType * buffer)
+                                 {
+                                 itk::ImageIORegion ioRegion(TInputImage::ImageDimension);
+                                 ioRegion.SetIndex(0, 0);
+                                 ioRegion.SetIndex(1, firstLine);
+                                 ioRegion.SetSize(0, OverviewCascadeType::GetLevelLength(
+                                                    imageIO->GetDimensions(0), imageIO->GetWrittenOverviewsFactor(), level));
+                                 ioRegion.SetSize(1, nbLines);
+                                 imageIO->WriteOverview(level, ioRegion, buffer);
+                                 });
+  m_OverviewCascade->Initialize(imageIO->GetDimensions(0), imageIO->GetDimensions(1), nbComponents);
+}
+
+template <class TInputImage>
+void
+ImageFileWriter<TInputImage>
+::DiscardCloudOptimizedWriting()
+{
+  m_OverviewCascade.reset();
+
+  GDALImageIO * imageIO = dynamic_cast<GDALImageIO*>(m_ImageIO.GetPointer());
+  if (imageIO != nullptr)
+    {
+    imageIO->DiscardCloudOptimizedWriting();
+    }
 }
 
 //---------------------------------------------------------
@@ -321,6 +516,18 @@ ImageFileWriter<TInputImage>
         }
       this->SetAutomaticAdaptativeStreaming(sizevalue);
       }
+    else if(type == "blockaligned")
+      {
+      if(sizemode != "auto")
+        {
+        otbLogMacro(Warning,<<"In blockaligned streaming type, the sizemode option will be ignored.");
+        }
+      if(sizevalue == 0)
+        {
+        otbLogMacro(Warning,<<"sizemode is auto but sizevalue is 0. Value will be fetched from the OTB_MAX_RAM_HINT environment variable if set, or else use the default value");
+        }
+      this->SetAutomaticBlockAlignedStreaming(sizevalue);
+      }
     else if(type == "tiled")
       {
       if(sizemode == "auto")
@@ -507,6 +714,11 @@ ImageFileWriter<TInputImage>
     }
   m_ShiftOutputIndex = inputRegion.GetIndex();
 
+  if (m_FilenameHelper->GetCloudOptimized())
+    {
+    this->PrepareCloudOptimizedWriting(inputRegion);
+    }
+
   /**
    * Determine of number of pieces to divide the input.  This will be the
    * minimum of what the user specified via SetNumberOfDivisionsStrippedStreaming()
@@ -529,6 +741,12 @@ ImageFileWriter<TInputImage>
     otbLogMacro(Debug,<< "Buffered region is the largest possible region, there is no need for streaming.");
     this->SetNumberOfDivisionsStrippedStreaming(1);
     }
+
+  if (m_FilenameHelper->StreamingCalibrationIsSet())
+    {
+    m_StreamingManager->SetMemoryCalibration(m_FilenameHelper->GetStreamingCalibration());
+    }
+
   m_StreamingManager->PrepareStreaming(inputPtr, inputRegion);
   m_NumberOfDivisions = m_StreamingManager->GetNumberOfSplits();
 
@@ -628,29 +846,122 @@ ImageFileWriter<TInputImage>
    */
   InputImageRegionType streamRegion;
 
-  for (m_CurrentDivision = 0;
-       m_CurrentDivision < m_NumberOfDivisions && !this->GetAbortGenerateData();
-       m_CurrentDivision++, m_DivisionProgress = 0, this->UpdateFilterProgress())
+  /**
+   * In write-behind mode, the computed divisions are written by a
+   * dedicated I/O thread while the next ones are computed.
+   */
+  bool writeBehind = m_WriteBehind;
+  if (m_FilenameHelper->StreamingWriteBehindIsSet())
     {
-    streamRegion = m_StreamingManager->GetSplit(m_CurrentDivision);
+    writeBehind = m_FilenameHelper->GetStreamingWriteBehind();
+    }
 
-    inputPtr->SetRequestedRegion(streamRegion);
-    inputPtr->PropagateRequestedRegion();
-    inputPtr->UpdateOutputData();
+  // Several I/O threads imply the write-behind mode
+  const unsigned int nbIOThreads = this->GetActualNumberOfIOThreads();
+  writeBehind = writeBehind || nbIOThreads > 1;
 
-    // Write the whole image
-    itk::ImageIORegion ioRegion(TInputImage::ImageDimension);
-    for (unsigned int i = 0; i < TInputImage::ImageDimension; ++i)
+  // The overviews of a Cloud Optimized GeoTIFF are computed from the
+  // strips in the order they are written
+  if (writeBehind && m_FilenameHelper->GetCloudOptimized())
+    {
+    otbLogMacro(Warning,<<"Cloud Optimized GeoTIFF is not written in the background, write-behind mode and I/O threads will be ignored.");
+    writeBehind = false;
+    }
+  m_OverviewCascade.reset();
+
+  // Several I/O threads require a file layout allowing concurrent writes.
+  // The creation options are only overridden when several divisions are
+  // actually written concurrently.
+  GDALImageIO * gdalImageIO = dynamic_cast<GDALImageIO*>(m_ImageIO.GetPointer());
+  if (gdalImageIO != nullptr)
+    {
+    gdalImageIO->SetConcurrentWriting(writeBehind && nbIOThreads > 1 && m_NumberOfDivisions > 1);
+    }
+
+  m_WriteBehindQueue = nullptr;
+  if (writeBehind && m_NumberOfDivisions > 1)
+    {
+    m_WriteBehindQueue = ImageIOWriteBehindQueue::New();
+    m_WriteBehindQueue->SetImageIO(m_ImageIO);
+    m_WriteBehindQueue->SetMaximumNumberOfPendingRegions(this->EstimateWriteBehindQueueDepth());
+    m_WriteBehindQueue->SetNumberOfIOThreads(nbIOThreads);
+    if (nbIOThreads > 1 && !m_ImageIO->CanWriteRegionsConcurrently())
       {
-      ioRegion.SetSize(i, streamRegion.GetSize(i));
-      //Set the ioRegion index using the shifted index ( (0,0 without box parameter))
-      ioRegion.SetIndex(i, streamRegion.GetIndex(i) - m_ShiftOutputIndex[i]);
+      otbLogMacro(Warning,<<"Concurrent writing is not supported by "<<m_ImageIO->GetNameOfClass()<<" for "<<m_FileName<<", divisions will be written by a single I/O thread");
+      }
+    otbLogMacro(Info,<<"Writing in the background, with at most "<<m_WriteBehindQueue->GetMaximumNumberOfPendingRegions()<<" blocks waiting to be written");
+    }
+
+  // Record the execution of each filter of the pipeline
+  PipelineTraceObserver traceObserver;
+  if (Tracer::GetInstance().IsEnabled())
+    {
+    traceObserver.Attach(inputPtr);
+    }
+
+  try
+    {
+    for (m_CurrentDivision = 0;
+         m_CurrentDivision < m_NumberOfDivisions && !this->GetAbortGenerateData();
+         m_CurrentDivision++, m_DivisionProgress = 0, this->UpdateFilterProgress())
+      {
+      streamRegion = m_StreamingManager->GetSplit(m_CurrentDivision);
+
+      TraceScope divisionScope("Division", "streaming");
+      divisionScope.AddArgument("file", m_FileName);
+      divisionScope.AddArgument("division", m_CurrentDivision);
+      divisionScope.AddArgument("pixels", streamRegion.GetNumberOfPixels());
+      traceObserver.SetDivision(m_CurrentDivision);
+
+      inputPtr->SetRequestedRegion(streamRegion);
+      inputPtr->PropagateRequestedRegion();
+      inputPtr->UpdateOutputData();
+
+      // Write the whole image
+      itk::ImageIORegion ioRegion(TInputImage::ImageDimension);
+      for (unsigned int i = 0; i < TInputImage::ImageDimension; ++i)
+        {
+        ioRegion.SetSize(i, streamRegion.GetSize(i));
+        //Set the ioRegion index using the shifted index ( (0,0 without box parameter))
+        ioRegion.SetIndex(i, streamRegion.GetIndex(i) - m_ShiftOutputIndex[i]);
+        }
+      this->SetIORegion(ioRegion);
+
+      // In write-behind mode, the ImageIO region is set by the I/O thread
+      if (m_WriteBehindQueue.IsNull())
+        {
+        m_ImageIO->SetIORegion(m_IORegion);
+        }
+
+      // Start writing stream region in the image file
+      this->GenerateData();
       }
-    this->SetIORegion(ioRegion);
-    m_ImageIO->SetIORegion(m_IORegion);
 
-    // Start writing stream region in the image file
-    this->GenerateData();
+    if (m_WriteBehindQueue.IsNotNull())
+      {
+      // Wait for the pending divisions to be written
+      if (this->GetAbortGenerateData())
+        {
+        m_WriteBehindQueue->Abort();
+        }
+      else
+        {
+        TraceScope traceScope("Wait for I/O", "wait");
+        m_WriteBehindQueue->Stop();
+        }
+      m_WriteBehindQueue = nullptr;
+      }
+    m_OverviewCascade.reset();
+    }
+  catch (...)
+    {
+    if (m_WriteBehindQueue.IsNotNull())
+      {
+      m_WriteBehindQueue->Abort();
+      m_WriteBehindQueue = nullptr;
+      }
+    this->DiscardCloudOptimizedWriting();
+    throw;
     }
 
   /**
@@ -663,6 +974,7 @@ ImageFileWriter<TInputImage>
     }
   else
     {
+    this->DiscardCloudOptimizedWriting();
     itk::ProcessAborted e(__FILE__, __LINE__);
     e.SetLocation(ITK_LOCATION);
     e.SetDescription("Image writing has been aborted");
@@ -710,35 +1022,54 @@ ImageFileWriter<TInputImage>
   const InputImageType * input = this->GetInput();
   InputImagePointer cacheImage;
 
+  // In write-behind mode, the ImageIO belongs to the I/O thread as soon as
+  // the first division has been pushed, so it is only configured once
+  const bool writeBehind = m_WriteBehindQueue.IsNotNull();
+
   // Make sure that the image is the right type and no more than
   // four components.
   typedef typename InputImageType::PixelType ImagePixelType;
 
-  if (strcmp(input->GetNameOfClass(), "VectorImage") == 0)
+  if (!writeBehind || m_CurrentDivision == 0)
     {
-    typedef typename InputImageType::InternalPixelType VectorImagePixelType;
-    m_ImageIO->SetPixelTypeInfo(typeid(VectorImagePixelType));
+    if (strcmp(input->GetNameOfClass(), "VectorImage") == 0)
+      {
+      typedef typename InputImageType::InternalPixelType VectorImagePixelType;
+      m_ImageIO->SetPixelTypeInfo(typeid(VectorImagePixelType));
 
-    typedef typename InputImageType::AccessorFunctorType AccessorFunctorType;
-    m_ImageIO->SetNumberOfComponents(AccessorFunctorType::GetVectorLength(input));
+      typedef typename InputImageType::AccessorFunctorType AccessorFunctorType;
+      m_ImageIO->SetNumberOfComponents(AccessorFunctorType::GetVectorLength(input));
 
-    m_IOComponents = m_ImageIO->GetNumberOfComponents();
-    m_BandList.clear();
-    if (m_FilenameHelper->BandRangeIsSet())
-      {
-      // get band range
-      bool retBandRange = m_FilenameHelper->ResolveBandRange(m_FilenameHelper->GetBandRange(), m_IOComponents, m_BandList);
-      if (retBandRange == false || m_BandList.empty())
+      m_IOComponents = m_ImageIO->GetNumberOfComponents();
+      m_BandList.clear();
+      if (m_FilenameHelper->BandRangeIsSet())
         {
-        // invalid range
-        itkGenericExceptionMacro("The given band range is either empty or invalid for a " << m_IOComponents <<" bands input image!");
+        // get band range
+        bool retBandRange = m_FilenameHelper->ResolveBandRange(m_FilenameHelper->GetBandRange(), m_IOComponents, m_BandList);
+        if (retBandRange == false || m_BandList.empty())
+          {
+          // invalid range
+          itkGenericExceptionMacro("The given band range is either empty or invalid for a " << m_IOComponents <<" bands input image!");
+          }
         }
       }
+    else
+      {
+      // Set the pixel and component type; the number of components.
+      m_ImageIO->SetPixelTypeInfo(typeid(ImagePixelType));
+      }
     }
-  else
+
+  if (m_FilenameHelper->GetCloudOptimized() && m_CurrentDivision == 0)
     {
-    // Set the pixel and component type; the number of components.
-    m_ImageIO->SetPixelTypeInfo(typeid(ImagePixelType));
+    // The cascade sees the written pixels: the mapped bands of a
+    // VectorImage, split into their scalar components
+    unsigned int nbPixelComponents = 1;
+    if (strcmp(input->GetNameOfClass(), "VectorImage") == 0)
+      {
+      nbPixelComponents = m_BandList.empty() ? m_IOComponents : m_BandList.size();
+      }
+    this->CreateOverviewCascade(nbPixelComponents * sizeof(InternalPixelType) / sizeof(OverviewValueType));
     }
 
   // Setup the image IO for writing.
@@ -752,7 +1083,7 @@ ImageFileWriter<TInputImage>
 
   // No shift of the ioRegion from the buffered region is expected
   itk::ImageIORegionAdaptor<TInputImage::ImageDimension>::
-    Convert(m_ImageIO->GetIORegion(), ioRegion, m_ShiftOutputIndex);
+    Convert(m_IORegion, ioRegion, m_ShiftOutputIndex);
   InputImageRegionType bufferedRegion = input->GetBufferedRegion();
 
   // before this test, bad stuff would happened when they don't match.
@@ -810,15 +1141,62 @@ ImageFileWriter<TInputImage>
       }
     }
 
-  if (m_FilenameHelper->BandRangeIsSet() && (!m_BandList.empty()))
-  {
-    // Adapt the image size with the region and take into account a potential
-    // remapping of the components. m_BandList is empty if no band range is set
-    m_ImageIO->DoMapBuffer(const_cast< void* >(dataPtr), bufferedRegion.GetNumberOfPixels(), this->m_BandList);
-    m_ImageIO->SetNumberOfComponents(m_BandList.size());
-  }
+  if (writeBehind)
+    {
+    if (cacheImage.IsNull())
+      {
+      // The input buffer will be reused to compute the next division:
+      // the pending division needs its own copy
+      cacheImage = InputImageType::New();
+      cacheImage->CopyInformation(input);
+      cacheImage->SetBufferedRegion(bufferedRegion);
+      cacheImage->Allocate();
+      std::copy(input->GetBufferPointer(),
+                input->GetBufferPointer() + input->GetPixelContainer()->Size(),
+                cacheImage->GetBufferPointer());
+      dataPtr = (const void*) cacheImage->GetBufferPointer();
+      }
+
+    if (m_CurrentDivision == 0)
+      {
+      // m_BandList is empty if no band range is set
+      std::vector<unsigned int> bandList;
+      if (m_FilenameHelper->BandRangeIsSet())
+        {
+        bandList = m_BandList;
+        }
+      m_WriteBehindQueue->SetBandList(bandList, m_IOComponents);
+      }
+
+    m_WriteBehindQueue->Push(cacheImage, const_cast< void* >(dataPtr), ioRegion.GetNumberOfPixels(), m_IORegion);
+    }
+  else
+    {
+    if (m_FilenameHelper->BandRangeIsSet() && (!m_BandList.empty()))
+      {
+      // Adapt the image size with the region and take into account a potential
+      // remapping of the components. m_BandList is empty if no band range is set
+      m_ImageIO->DoMapBuffer(const_cast< void* >(dataPtr), bufferedRegion.GetNumberOfPixels(), this->m_BandList);
+      m_ImageIO->SetNumberOfComponents(m_BandList.size());
+      }
+
+    TraceScope traceScope("Write", "io");
+    traceScope.AddArgument("file", m_FileName);
+    traceScope.AddArgument("bytes", static_cast<unsigned long long>(ioRegion.GetNumberOfPixels())
+                           * m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents());
+
+    m_ImageIO->Write(dataPtr);
 
-  m_ImageIO->Write(dataPtr);
+    if (m_OverviewCascade)
+      {
+      if (ioRegion.GetSize(0) != m_ImageIO->GetDimensions(0))
+        {
+        itkExceptionMacro(<< "The overviews of " << m_FileName << " are computed from strips of full lines");
+        }
+      TraceScope overviewsScope("Overviews", "io");
+      m_OverviewCascade->PushLines(ioRegion.GetSize(1), static_cast<const OverviewValueType*>(dataPtr));
+      }
+    }
 
   if (m_WriteGeomFile  || m_FilenameHelper->GetWriteGEOMFile())
     {
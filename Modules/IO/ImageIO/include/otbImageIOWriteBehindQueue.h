@@ -0,0 +1,197 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbImageIOWriteBehindQueue_h
+#define otbImageIOWriteBehindQueue_h
+
+#include "otbImageIOBase.h"
+#include "itkDataObject.h"
+#include "itkMultiThreader.h"
+#include "itkMutexLock.h"
+#include "itkConditionVariable.h"
+#include "otbStopwatch.h"
+#include "OTBImageIOExport.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace otb
+{
+
+/** \class ImageIOWriteBehindQueue
+ *  \brief Bounded queue of computed regions written by a dedicated I/O thread.
+ *
+ * This class is used by ImageFileWriter in its write-behind mode: once
+ * a streaming division has been computed, its buffer is pushed into the
+ * queue and the writer immediately goes on with the next division,
+ * while the I/O thread encodes and writes the pending regions through
+ * the ImageIO, in the order they were pushed.
+ *
+ * The queue holds at most MaximumNumberOfPendingRegions regions.
+ * Push() blocks when the queue is full, which bounds the extra memory
+ * used by the write-behind mode.
+ *
+ * Since ImageIO objects are not thread-safe, the ImageIO must not be
+ * accessed by any other thread between the first call to Push() and the
+ * return of Stop(). A single I/O thread is used by default, writing the
+ * regions in order through ImageIO::Write(). When several I/O threads
+ * are requested and the ImageIO supports it (see
+ * ImageIOBase::CanWriteRegionsConcurrently()), the regions are written
+ * in parallel through ImageIOBase::WriteRegion().
+ *
+ * Errors raised by the I/O thread are reported to the caller on the next
+ * call to Push() or Stop().
+ *
+ * \sa ImageFileWriter
+ *
+ * \ingroup OTBImageIO
+ */
+class OTBImageIO_EXPORT ImageIOWriteBehindQueue : public itk::Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageIOWriteBehindQueue       Self;
+  typedef itk::Object                   Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageIOWriteBehindQueue, itk::Object);
+
+  typedef std::vector<unsigned int> BandListType;
+
+  /** Set/Get the ImageIO used to write the regions */
+  itkSetObjectMacro(ImageIO, otb::ImageIOBase);
+  itkGetObjectMacro(ImageIO, otb::ImageIOBase);
+
+  /** Set/Get the maximum number of regions waiting to be written */
+  itkSetMacro(MaximumNumberOfPendingRegions, unsigned int);
+  itkGetConstMacro(MaximumNumberOfPendingRegions, unsigned int);
+
+  /** Set/Get the number of I/O threads. More than one thread is only
+   *  used if the ImageIO can write regions concurrently. */
+  itkSetMacro(NumberOfIOThreads, unsigned int);
+  itkGetConstMacro(NumberOfIOThreads, unsigned int);
+
+  /** Set the band mapping applied to each buffer before writing
+   * (see ImageIOBase::DoMapBuffer). The number of components is the
+   * number of components of the buffers pushed in the queue. An empty
+   * band list means no mapping. */
+  void SetBandList(const BandListType & bandList, unsigned int numberOfComponents);
+
+  /** Push a region to be written. The holder object keeps the buffer
+   *  alive until it has been written. This call blocks while the queue
+   *  is full. The I/O thread is started on the first call. */
+  void Push(itk::DataObject * holder,
+            void * buffer,
+            size_t numberOfPixels,
+            const itk::ImageIORegion & region);
+
+  /** Wait for all pending regions to be written and stop the I/O thread.
+   *  If an error occurred in the I/O thread, it is thrown here. */
+  void Stop();
+
+  /** Discard pending regions and stop the I/O thread, without throwing */
+  void Abort();
+
+  /** Time spent by the caller waiting for a free slot in the queue */
+  Stopwatch::DurationType GetWaitingTimeInMilliseconds() const
+  {
+    return m_WaitingChrono.GetElapsedMilliseconds();
+  }
+
+  /** Time spent by the I/O threads writing regions (summed over all
+   *  threads) */
+  Stopwatch::DurationType GetWritingTimeInMilliseconds() const
+  {
+    return m_WritingTime;
+  }
+
+  /** Compute the maximum number of pending regions that fits in the given
+   *  RAM budget, given the size in bytes of one region. The result is at
+   *  least 1. */
+  static unsigned int EstimateQueueDepth(unsigned long long availableRAMInBytes,
+                                         unsigned long long regionSizeInBytes);
+
+protected:
+  ImageIOWriteBehindQueue();
+  ~ImageIOWriteBehindQueue() override;
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+private:
+  ImageIOWriteBehindQueue(const Self &) = delete;
+  void operator =(const Self&) = delete;
+
+  /** A region waiting to be written */
+  struct PendingRegion
+  {
+    itk::DataObject::Pointer holder;
+    void *                   buffer;
+    size_t                   numberOfPixels;
+    itk::ImageIORegion       region;
+  };
+
+  /** Entry point of the I/O thread */
+  static ITK_THREAD_RETURN_TYPE ThreadCallback(void * arg);
+
+  /** Loop of the I/O thread: write regions until the queue is closed */
+  void ProcessQueue();
+
+  /** Write one region through the ImageIO */
+  void WriteRegion(PendingRegion & pending);
+
+  /** Close the queue and join the I/O threads */
+  void JoinThreads();
+
+  /** Throw the error raised by the I/O thread, if any (lock must be held) */
+  void CheckErrorUnsafe();
+
+  otb::ImageIOBase::Pointer    m_ImageIO;
+  unsigned int                 m_MaximumNumberOfPendingRegions;
+  unsigned int                 m_NumberOfIOThreads;
+  BandListType                 m_BandList;
+  unsigned int                 m_NumberOfComponents;
+
+  std::deque<PendingRegion>    m_Queue;
+  unsigned int                 m_NumberOfRegionsInProgress;
+  bool                         m_Concurrent;
+  bool                         m_Closed;
+  bool                         m_Running;
+  bool                         m_HasError;
+  std::string                  m_ErrorDescription;
+
+  itk::SimpleMutexLock               m_Mutex;
+  itk::ConditionVariable::Pointer    m_NotEmpty;
+  itk::ConditionVariable::Pointer    m_NotFull;
+
+  itk::MultiThreader::Pointer     m_Threader;
+  std::vector<itk::ThreadIdType>  m_ThreadIds;
+
+  Stopwatch                    m_WaitingChrono;
+  Stopwatch::DurationType      m_WritingTime;
+};
+
+} // end namespace otb
+
+#endif
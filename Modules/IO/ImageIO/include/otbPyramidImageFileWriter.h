@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbPyramidImageFileWriter_h
+#define otbPyramidImageFileWriter_h
+
+#include "otbImageIOBase.h"
+#include "itkProcessObject.h"
+#include "otbStreamingManager.h"
+#include "otbExtendedFilenameToWriterOptions.h"
+#include "otbPyramidCascade.h"
+#include <string>
+#include <vector>
+
+namespace otb
+{
+
+/** \class PyramidImageFileWriter
+ * \brief Writes an image and its decimated levels in a single pass.
+ *
+ * The input image is streamed once, by strips of full lines in order
+ * (controlled by SetNumberOfLinesStrippedStreaming or
+ * SetAutomaticStrippedStreaming). Each strip is written to the full
+ * resolution file and pushed into a PyramidCascade, which computes the
+ * NumberOfLevels decimated levels from the lines of the previous level,
+ * using several threads. Level k is decimated by ShrinkFactor^k, its
+ * pixels being either the mean of their block or its upper left pixel
+ * (see SetResampling).
+ *
+ * When WriteOverviews is on, the levels are written as the overviews of
+ * the full resolution file, which must then be a GeoTIFF. Otherwise, each
+ * level is written in a file of its own, named after the full resolution
+ * file with the _k suffix (see GetLevelFileName()), and the full
+ * resolution file is only written if WriteFullResolution is on. The
+ * origin and spacing of each level file are those of its decimated grid.
+ *
+ * The GDAL creation options of the extended filename apply to all the
+ * files. Only images whose components are real values are supported.
+ *
+ * \sa ImageFileWriter
+ * \sa PyramidCascade
+ * \sa GDALOverviewsBuilder
+ *
+ * \ingroup OTBImageIO
+ */
+template <class TInputImage>
+class ITK_EXPORT PyramidImageFileWriter : public itk::ProcessObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef PyramidImageFileWriter                            Self;
+  typedef itk::ProcessObject                                Superclass;
+  typedef itk::SmartPointer<Self>                           Pointer;
+  typedef itk::SmartPointer<const Self>                     ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PyramidImageFileWriter, itk::ProcessObject);
+
+  /** Some typedefs for the input. */
+  typedef TInputImage                              InputImageType;
+  typedef typename InputImageType::Pointer         InputImagePointer;
+  typedef typename InputImageType::RegionType      InputImageRegionType;
+  typedef typename InputImageType::InternalPixelType InternalPixelType;
+
+  /** The cascade computing the levels */
+  typedef PyramidCascade<InternalPixelType>        CascadeType;
+  typedef typename CascadeType::ResamplingType     ResamplingType;
+
+  /** The Filename Helper. */
+  typedef ExtendedFilenameToWriterOptions          FNameHelperType;
+
+  /** Streaming manager base class pointer */
+  typedef StreamingManager<InputImageType>         StreamingManagerType;
+  typedef typename StreamingManagerType::Pointer   StreamingManagerPointerType;
+
+  /**  Set the streaming mode to 'stripped' and configure the number of strips
+   *   which will be used to stream the image with respect to a number of line
+   *   per strip */
+  void SetNumberOfLinesStrippedStreaming(unsigned int nbLinesPerStrip);
+
+  /**  Set the streaming mode to 'stripped' and configure the number of MB
+   *   available. The actual number of divisions is computed automatically
+   *   by estimating the memory consumption of the pipeline.
+   *   Setting the availableRAM parameter to 0 means that the available RAM
+   *   is set from the CMake configuration option. */
+  void SetAutomaticStrippedStreaming(unsigned int availableRAM = 0, double bias = 1.0);
+
+  /** Set/Get the input image */
+  using Superclass::SetInput;
+  virtual void SetInput(const InputImageType *input);
+  const InputImageType * GetInput();
+
+  /** Set/Get the extended filename of the full resolution file */
+  virtual void SetFileName(const std::string& extendedFileName);
+  virtual const char* GetFileName() const;
+
+  /** Number of decimated levels, the full resolution excluded */
+  itkSetMacro(NumberOfLevels, unsigned int);
+  itkGetConstMacro(NumberOfLevels, unsigned int);
+
+  /** Decimation factor between two consecutive levels */
+  itkSetMacro(ShrinkFactor, unsigned int);
+  itkGetConstMacro(ShrinkFactor, unsigned int);
+
+  /** How the pixels of a block are reduced (CascadeType::Average by
+   *  default) */
+  itkSetMacro(Resampling, ResamplingType);
+  itkGetConstMacro(Resampling, ResamplingType);
+
+  /** Write the levels as the overviews of the full resolution file */
+  itkSetMacro(WriteOverviews, bool);
+  itkGetConstMacro(WriteOverviews, bool);
+  itkBooleanMacro(WriteOverviews);
+
+  /** Write the full resolution file when the levels are written in
+   *  files of their own (on by default) */
+  itkSetMacro(WriteFullResolution, bool);
+  itkGetConstMacro(WriteFullResolution, bool);
+  itkBooleanMacro(WriteFullResolution);
+
+  /** Name of the file of a level, when the levels are written in files
+   *  of their own: path/name_level.ext for a full resolution file named
+   *  path/name.ext */
+  std::string GetLevelFileName(unsigned int level) const;
+
+  /** Streams the input and writes all the levels */
+  void Update() override;
+
+protected:
+  PyramidImageFileWriter();
+  ~PyramidImageFileWriter() override {}
+  void PrintSelf(std::ostream& os, itk::Indent indent) const override;
+
+  /** Does the streaming loop */
+  void GenerateData(void) override;
+
+private:
+  PyramidImageFileWriter(const PyramidImageFileWriter &) = delete;
+  void operator =(const PyramidImageFileWriter&) = delete;
+
+  /** Create and set up the ImageIO writing a level, 0 being the full
+   *  resolution */
+  ImageIOBase::Pointer CreateLevelImageIO(unsigned int level, const std::string & fileName,
+                                          unsigned int nbComponents);
+
+  /** Called by the cascade with the lines of a decimated level */
+  void WriteLevel(unsigned int level, unsigned int firstLine, unsigned int nbLines,
+                  const InternalPixelType * buffer);
+
+  std::string m_FileName;
+  FNameHelperType::Pointer m_FilenameHelper;
+  StreamingManagerPointerType m_StreamingManager;
+
+  unsigned int   m_NumberOfLevels;
+  unsigned int   m_ShrinkFactor;
+  ResamplingType m_Resampling;
+  bool           m_WriteOverviews;
+  bool           m_WriteFullResolution;
+
+  /** ImageIO of each level, the first one also writing the overviews
+   *  when WriteOverviews is on */
+  std::vector<ImageIOBase::Pointer> m_LevelImageIOs;
+
+  /** Width of each level */
+  std::vector<unsigned int> m_LevelWidths;
+};
+
+} // end namespace otb
+
+#ifndef OTB_MANUAL_INSTANTIATION
+#include "otbPyramidImageFileWriter.hxx"
+#endif
+
+#endif // otbPyramidImageFileWriter_h
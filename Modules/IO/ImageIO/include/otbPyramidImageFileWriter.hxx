@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbPyramidImageFileWriter_hxx
+#define otbPyramidImageFileWriter_hxx
+
+#include "otbPyramidImageFileWriter.h"
+#include "otbImageIOFactory.h"
+#include "otbGDALImageIO.h"
+#include "otbMacro.h"
+#include "otbNumberOfLinesStrippedStreamingManager.h"
+#include "otbRAMDrivenStrippedStreamingManager.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIterator.h"
+#include "itkContinuousIndex.h"
+#include "itksys/SystemTools.hxx"
+
+#include <sstream>
+
+namespace otb
+{
+
+template <class TInputImage>
+PyramidImageFileWriter<TInputImage>
+::PyramidImageFileWriter()
+  : m_NumberOfLevels(1),
+    m_ShrinkFactor(2),
+    m_Resampling(CascadeType::Average),
+    m_WriteOverviews(false),
+    m_WriteFullResolution(true)
+{
+  // The levels are computed from strips of full lines
+  this->SetAutomaticStrippedStreaming();
+
+  m_FilenameHelper = FNameHelperType::New();
+}
+
+template <class TInputImage>
+void
+PyramidImageFileWriter<TInputImage>
+::SetNumberOfLinesStrippedStreaming(unsigned int nbLinesPerStrip)
+{
+  typedef NumberOfLinesStrippedStreamingManager<TInputImage> NumberOfLinesStrippedStreamingManagerType;
+  typename NumberOfLinesStrippedStreamingManagerType::Pointer streamingManager = NumberOfLinesStrippedStreamingManagerType::New();
+  streamingManager->SetNumberOfLinesPerStrip(nbLinesPerStrip);
+  m_StreamingManager = streamingManager;
+}
+
+template <class TInputImage>
+void
+PyramidImageFileWriter<TInputImage>
+::SetAutomaticStrippedStreaming(unsigned int availableRAM, double bias)
+{
+  typedef RAMDrivenStrippedStreamingManager<TInputImage> RAMDrivenStrippedStreamingManagerType;
+  typename RAMDrivenStrippedStreamingManagerType::Pointer streamingManager = RAMDrivenStrippedStreamingManagerType::New();
+  streamingManager->SetAvailableRAMInMB(availableRAM);
+  streamingManager->SetBias(bias);
+  m_StreamingManager = streamingManager;
+}
+
+template <class TInputImage>
+void
+PyramidImageFileWriter<TInputImage>
+::SetInput(const InputImageType* input)
+{
+  this->ProcessObject::SetNthInput(0, const_cast<InputImageType*>(input));
+}
+
+template <class TInputImage>
+const typename PyramidImageFileWriter<TInputImage>::InputImageType *
+PyramidImageFileWriter<TInputImage>
+::GetInput()
+{
+  if (this->GetNumberOfInputs() < 1)
+    {
+    return nullptr;
+    }
+
+  return static_cast<const InputImageType*>(this->ProcessObject::GetInput(0));
+}
+
+template <class TInputImage>
+void
+PyramidImageFileWriter<TInputImage>
+::SetFileName(const std::string& extendedFileName)
+{
+  m_FilenameHelper->SetExtendedFileName(extendedFileName);
+  m_FileName = m_FilenameHelper->GetSimpleFileName();
+  this->Modified();
+}
+
+template <class TInputImage>
+const char*
+PyramidImageFileWriter<TInputImage>
+::GetFileName() const
+{
+  return m_FilenameHelper->GetSimpleFileName();
+}
+
+template <class TInputImage>
+std::string
+PyramidImageFileWriter<TInputImage>
+::GetLevelFileName(unsigned int level) const
+{
+  if (level == 0)
+    {
+    return m_FileName;
+    }
+
+  const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+
+  std::ostringstream oss;
+  if (!path.empty())
+    {
+    oss << path << "/";
+    }
+  oss << itksys::SystemTools::GetFilenameWithoutExtension(m_FileName) << "_" << level
+      << itksys::SystemTools::GetFilenameExtension(m_FileName);
+  return oss.str();
+}
+
+template <class TInputImage>
+ImageIOBase::Pointer
+PyramidImageFileWriter<TInputImage>
+::CreateLevelImageIO(unsigned int level, const std::string & fileName, unsigned int nbComponents)
+{
+  ImageIOBase::Pointer imageIO = ImageIOFactory::CreateImageIO(fileName.c_str(), ImageIOFactory::WriteMode);
+
+  if (imageIO.IsNull())
+    {
+    itk::ImageFileWriterException e(__FILE__, __LINE__);
+    std::ostringstream msg;
+    msg << "Cannot write image " << fileName << ". Probably unsupported format or incorrect filename extension.";
+    e.SetDescription(msg.str());
+    e.SetLocation(ITK_LOCATION);
+    throw e;
+    }
+
+  GDALImageIO * gdalImageIO = dynamic_cast<GDALImageIO*>(imageIO.GetPointer());
+  if (gdalImageIO != nullptr && m_FilenameHelper->gdalCreationOptionsIsSet())
+    {
+    gdalImageIO->SetOptions(m_FilenameHelper->GetgdalCreationOptions());
+    }
+
+  if (m_WriteOverviews)
+    {
+    if (gdalImageIO == nullptr || !gdalImageIO->CanWriteOverviews())
+      {
+      itkExceptionMacro(<< "Overviews can not be written along with " << fileName
+                        << ", only GeoTIFF files support it");
+      }
+    gdalImageIO->SetNumberOfWrittenOverviews(m_NumberOfLevels);
+    gdalImageIO->SetWrittenOverviewsFactor(m_ShrinkFactor);
+    }
+
+  // Lines are written as soon as they are computed
+  if (!imageIO->CanStreamWrite())
+    {
+    itkExceptionMacro(<< "The file format of " << fileName << " does not support streaming");
+    }
+
+  //
+  // Setup the ImageIO with the decimated grid of the level: its pixels
+  // are centered on the blocks of the full resolution pixels
+  //
+  const InputImageType * inputPtr = this->GetInput();
+  const InputImageRegionType inputRegion = inputPtr->GetLargestPossibleRegion();
+
+  unsigned int factor = 1;
+  for (unsigned int k = 0; k < level; ++k)
+    {
+    factor *= m_ShrinkFactor;
+    }
+
+  itk::ContinuousIndex<double, TInputImage::ImageDimension> firstPixel;
+  for (unsigned int i = 0; i < TInputImage::ImageDimension; ++i)
+    {
+    firstPixel[i] = inputRegion.GetIndex(i) + 0.5 * (factor - 1);
+    }
+  typename TInputImage::PointType origin;
+  inputPtr->TransformContinuousIndexToPhysicalPoint(firstPixel, origin);
+
+  const typename TInputImage::SpacingType&   spacing = inputPtr->GetSpacing();
+  const typename TInputImage::DirectionType& direction = inputPtr->GetDirection();
+  imageIO->SetNumberOfDimensions(TInputImage::ImageDimension);
+  for (unsigned int i = 0; i < TInputImage::ImageDimension; ++i)
+    {
+    const int direction_sign = direction[i][i] < 0 ? -1 : 1;
+    imageIO->SetDimensions(i, CascadeType::GetLevelLength(inputRegion.GetSize(i), m_ShrinkFactor, level));
+    imageIO->SetSpacing(i, direction_sign * spacing[i] * factor);
+    imageIO->SetOrigin(i, origin[i]);
+
+    vnl_vector<double> axisDirection(TInputImage::ImageDimension);
+    // Please note: direction cosines are stored as columns of the
+    // direction matrix
+    for (unsigned int j = 0; j < TInputImage::ImageDimension; ++j)
+      {
+      axisDirection[j] = direction_sign * direction[j][i];
+      }
+    imageIO->SetDirection(i, axisDirection);
+    }
+
+  imageIO->SetPixelTypeInfo(typeid(InternalPixelType));
+  imageIO->SetNumberOfComponents(nbComponents);
+  imageIO->SetMetaDataDictionary(inputPtr->GetMetaDataDictionary());
+  imageIO->SetFileName(fileName);
+  imageIO->WriteImageInformation();
+
+  return imageIO;
+}
+
+template <class TInputImage>
+void
+PyramidImageFileWriter<TInputImage>
+::WriteLevel(unsigned int level, unsigned int firstLine, unsigned int nbLines,
+             const InternalPixelType * buffer)
+{
+  itk::ImageIORegion ioRegion(TInputImage::ImageDimension);
+  ioRegion.SetIndex(0, 0);
+  ioRegion.SetIndex(1, firstLine);
+  ioRegion.SetSize(0, m_LevelWidths[level]);
+  ioRegion.SetSize(1, nbLines);
+
+  if (m_WriteOverviews)
+    {
+    static_cast<GDALImageIO*>(m_LevelImageIOs[0].GetPointer())->WriteOverview(level, ioRegion, buffer);
+    }
+  else
+    {
+    m_LevelImageIOs[level]->SetIORegion(ioRegion);
+    m_LevelImageIOs[level]->Write(buffer);
+    }
+}
+
+template <class TInputImage>
+void
+PyramidImageFileWriter<TInputImage>
+::Update()
+{
+  InputImageType * inputPtr = const_cast<InputImageType *>(this->GetInput());
+  if (inputPtr == nullptr)
+    {
+    itkExceptionMacro(<< "No input to writer");
+    }
+  inputPtr->UpdateOutputInformation();
+
+  this->SetAbortGenerateData(0);
+  this->SetProgress(0.0);
+
+  this->InvokeEvent(itk::StartEvent());
+  this->UpdateProgress(0);
+
+  this->GenerateData();
+
+  if (this->GetAbortGenerateData())
+    {
+    itk::ProcessAborted e(__FILE__, __LINE__);
+    e.SetLocation(ITK_LOCATION);
+    e.SetDescription("Image writing has been aborted");
+    throw e;
+    }
+
+  this->UpdateProgress(1.0);
+  this->InvokeEvent(itk::EndEvent());
+
+  this->ReleaseInputs();
+}
+
+template <class TInputImage>
+void
+PyramidImageFileWriter<TInputImage>
+::GenerateData(void)
+{
+  if (m_FileName.empty())
+    {
+    itkExceptionMacro(<< "No filename was specified");
+    }
+
+  InputImagePointer inputPtr = const_cast<InputImageType *>(this->GetInput());
+  const InputImageRegionType inputRegion = inputPtr->GetLargestPossibleRegion();
+  const unsigned int nbComponents = inputPtr->GetNumberOfComponentsPerPixel();
+
+  CascadeType cascade;
+  cascade.SetNumberOfLevels(m_NumberOfLevels);
+  cascade.SetShrinkFactor(m_ShrinkFactor);
+  cascade.SetResampling(m_Resampling);
+  cascade.SetNumberOfThreads(this->GetNumberOfThreads());
+  cascade.SetCallback([this](unsigned int level, unsigned int firstLine, unsigned int nbLines,
+                             const InternalPixelType * buffer)
+                      {
+                      this->WriteLevel(level, firstLine, nbLines, buffer);
+                      });
+  cascade.Initialize(inputRegion.GetSize(0), inputRegion.GetSize(1), nbComponents);
+
+  m_LevelWidths.clear();
+  m_LevelImageIOs.clear();
+  for (unsigned int level = 0; level <= m_NumberOfLevels; ++level)
+    {
+    m_LevelWidths.push_back(cascade.GetLevelWidth(level));
+    }
+
+  if (m_WriteOverviews)
+    {
+    m_LevelImageIOs.push_back(this->CreateLevelImageIO(0, m_FileName, nbComponents));
+    }
+  else
+    {
+    for (unsigned int level = 0; level <= m_NumberOfLevels; ++level)
+      {
+      if (level == 0 && !m_WriteFullResolution)
+        {
+        m_LevelImageIOs.push_back(nullptr);
+        continue;
+        }
+      const std::string fileName = this->GetLevelFileName(level);
+      otbLogMacro(Info,<< "Level " << level << " (" << m_LevelWidths[level] << "x"
+                  << cascade.GetLevelHeight(level) << " pixels) will be written to " << fileName);
+      m_LevelImageIOs.push_back(this->CreateLevelImageIO(level, fileName, nbComponents));
+      }
+    }
+
+  m_StreamingManager->PrepareStreaming(inputPtr, inputRegion);
+  const unsigned int nbDivisions = m_StreamingManager->GetNumberOfSplits();
+
+  otbLogMacro(Info,<< "File " << m_FileName << " and " << m_NumberOfLevels << " decimated levels will be written in "
+              << nbDivisions << " strips");
+
+  for (unsigned int division = 0; division < nbDivisions && !this->GetAbortGenerateData(); ++division)
+    {
+    const InputImageRegionType streamRegion = m_StreamingManager->GetSplit(division);
+    if (streamRegion.GetSize(0) != inputRegion.GetSize(0))
+      {
+      itkExceptionMacro(<< "The decimated levels are computed from strips of full lines");
+      }
+
+    inputPtr->SetRequestedRegion(streamRegion);
+    inputPtr->PropagateRequestedRegion();
+    inputPtr->UpdateOutputData();
+
+    // The lines of the strip must be contiguous in memory
+    const InternalPixelType * buffer = inputPtr->GetBufferPointer();
+    InputImagePointer cacheImage;
+    if (inputPtr->GetBufferedRegion() != streamRegion)
+      {
+      cacheImage = InputImageType::New();
+      cacheImage->CopyInformation(inputPtr);
+      cacheImage->SetBufferedRegion(streamRegion);
+      cacheImage->Allocate();
+
+      itk::ImageRegionConstIterator<InputImageType> in(inputPtr, streamRegion);
+      itk::ImageRegionIterator<InputImageType>      out(cacheImage, streamRegion);
+      for (in.GoToBegin(), out.GoToBegin(); !in.IsAtEnd(); ++in, ++out)
+        {
+        out.Set(in.Get());
+        }
+      buffer = cacheImage->GetBufferPointer();
+      }
+
+    const unsigned int firstLine = streamRegion.GetIndex(1) - inputRegion.GetIndex(1);
+    const unsigned int nbLines = streamRegion.GetSize(1);
+
+    if (m_LevelImageIOs[0].IsNotNull())
+      {
+      itk::ImageIORegion ioRegion(TInputImage::ImageDimension);
+      ioRegion.SetIndex(0, 0);
+      ioRegion.SetIndex(1, firstLine);
+      ioRegion.SetSize(0, m_LevelWidths[0]);
+      ioRegion.SetSize(1, nbLines);
+      m_LevelImageIOs[0]->SetIORegion(ioRegion);
+      m_LevelImageIOs[0]->Write(buffer);
+      }
+
+    cascade.PushLines(nbLines, buffer);
+
+    this->UpdateProgress(static_cast<float>(division + 1) / nbDivisions);
+    }
+
+  // Release the files
+  m_LevelImageIOs.clear();
+}
+
+template <class TInputImage>
+void
+PyramidImageFileWriter<TInputImage>
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "File Name: " << m_FileName << "\n";
+  os << indent << "NumberOfLevels: " << m_NumberOfLevels << "\n";
+  os << indent << "ShrinkFactor: " << m_ShrinkFactor << "\n";
+  os << indent << "Resampling: " << (m_Resampling == CascadeType::Average ? "Average" : "Nearest") << "\n";
+  os << indent << "WriteOverviews: " << (m_WriteOverviews ? "On" : "Off") << "\n";
+  os << indent << "WriteFullResolution: " << (m_WriteFullResolution ? "On" : "Off") << "\n";
+}
+
+} // end namespace otb
+
+#endif // otbPyramidImageFileWriter_hxx
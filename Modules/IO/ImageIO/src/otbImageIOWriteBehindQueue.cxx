@@ -0,0 +1,345 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbImageIOWriteBehindQueue.h"
+#include "otbMacro.h"
+#include "itkMutexLockHolder.h"
+#include "otbTracer.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace otb
+{
+
+ImageIOWriteBehindQueue
+::ImageIOWriteBehindQueue()
+  : m_MaximumNumberOfPendingRegions(1),
+    m_NumberOfIOThreads(1),
+    m_NumberOfComponents(0),
+    m_NumberOfRegionsInProgress(0),
+    m_Concurrent(false),
+    m_Closed(false),
+    m_Running(false),
+    m_HasError(false),
+    m_WritingTime(0)
+{
+  m_NotEmpty = itk::ConditionVariable::New();
+  m_NotFull = itk::ConditionVariable::New();
+  m_Threader = itk::MultiThreader::New();
+}
+
+ImageIOWriteBehindQueue
+::~ImageIOWriteBehindQueue()
+{
+  this->Abort();
+}
+
+void
+ImageIOWriteBehindQueue
+::SetBandList(const BandListType & bandList, unsigned int numberOfComponents)
+{
+  m_BandList = bandList;
+  m_NumberOfComponents = numberOfComponents;
+}
+
+unsigned int
+ImageIOWriteBehindQueue
+::EstimateQueueDepth(unsigned long long availableRAMInBytes,
+                     unsigned long long regionSizeInBytes)
+{
+  if (regionSizeInBytes == 0)
+    {
+    return 1;
+    }
+  unsigned long long depth = availableRAMInBytes / regionSizeInBytes;
+  if (depth < 1)
+    {
+    depth = 1;
+    }
+  return static_cast<unsigned int>(
+    std::min<unsigned long long>(depth, std::numeric_limits<unsigned int>::max()));
+}
+
+void
+ImageIOWriteBehindQueue
+::Push(itk::DataObject * holder,
+       void * buffer,
+       size_t numberOfPixels,
+       const itk::ImageIORegion & region)
+{
+  if (m_ImageIO.IsNull())
+    {
+    itkExceptionMacro(<< "No ImageIO set in the write-behind queue");
+    }
+
+  itk::MutexLockHolder<itk::SimpleMutexLock> lock(m_Mutex);
+
+  this->CheckErrorUnsafe();
+
+  if (!m_Running)
+    {
+    m_Closed = false;
+    m_Running = true;
+    m_WaitingChrono.Reset();
+    m_WritingTime = 0;
+
+    // The buffers are remapped by the I/O threads, the ImageIO only sees
+    // the mapped components
+    if (!m_BandList.empty())
+      {
+      m_ImageIO->SetNumberOfComponents(m_BandList.size());
+      }
+
+    unsigned int nbThreads = 1;
+    if (m_NumberOfIOThreads > 1 && m_ImageIO->CanWriteRegionsConcurrently())
+      {
+      nbThreads = m_NumberOfIOThreads;
+      }
+    m_Concurrent = nbThreads > 1;
+
+    m_ThreadIds.clear();
+    for (unsigned int i = 0; i < nbThreads; ++i)
+      {
+      m_ThreadIds.push_back(m_Threader->SpawnThread(ThreadCallback, this));
+      }
+    }
+
+  const unsigned int maxPending = std::max(1u, m_MaximumNumberOfPendingRegions);
+  if (m_Queue.size() + m_NumberOfRegionsInProgress >= maxPending)
+    {
+    TraceScope traceScope("Wait for I/O", "wait");
+    m_WaitingChrono.Start();
+    while (m_Queue.size() + m_NumberOfRegionsInProgress >= maxPending && !m_HasError)
+      {
+      m_NotFull->Wait(&m_Mutex);
+      }
+    m_WaitingChrono.Stop();
+    this->CheckErrorUnsafe();
+    }
+
+  PendingRegion pending;
+  pending.holder = holder;
+  pending.buffer = buffer;
+  pending.numberOfPixels = numberOfPixels;
+  pending.region = region;
+  m_Queue.push_back(pending);
+
+  m_NotEmpty->Signal();
+}
+
+void
+ImageIOWriteBehindQueue
+::Stop()
+{
+  this->JoinThreads();
+
+  itk::MutexLockHolder<itk::SimpleMutexLock> lock(m_Mutex);
+  otbLogMacro(Debug,<< "Write-behind queue: I/O threads wrote during "
+              << m_WritingTime << " ms, pipeline waited for I/O during "
+              << m_WaitingChrono.GetElapsedMilliseconds() << " ms");
+  this->CheckErrorUnsafe();
+}
+
+void
+ImageIOWriteBehindQueue
+::Abort()
+{
+  m_Mutex.Lock();
+  m_Queue.clear();
+  m_Mutex.Unlock();
+
+  this->JoinThreads();
+
+  m_Mutex.Lock();
+  m_HasError = false;
+  m_ErrorDescription.clear();
+  m_Mutex.Unlock();
+}
+
+void
+ImageIOWriteBehindQueue
+::JoinThreads()
+{
+  m_Mutex.Lock();
+  bool running = m_Running;
+  m_Closed = true;
+  m_NotEmpty->Broadcast();
+  m_Mutex.Unlock();
+
+  if (running)
+    {
+    for (std::vector<itk::ThreadIdType>::const_iterator it = m_ThreadIds.begin(); it != m_ThreadIds.end(); ++it)
+      {
+      m_Threader->TerminateThread(*it);
+      }
+    m_ThreadIds.clear();
+
+    m_Mutex.Lock();
+    m_Running = false;
+    m_Mutex.Unlock();
+    }
+}
+
+void
+ImageIOWriteBehindQueue
+::CheckErrorUnsafe()
+{
+  if (m_HasError)
+    {
+    std::string description = m_ErrorDescription;
+    m_HasError = false;
+    m_ErrorDescription.clear();
+    m_Queue.clear();
+    itkExceptionMacro(<< "Error while writing in the background: " << description);
+    }
+}
+
+ITK_THREAD_RETURN_TYPE
+ImageIOWriteBehindQueue
+::ThreadCallback(void * arg)
+{
+  itk::MultiThreader::ThreadInfoStruct * info = static_cast<itk::MultiThreader::ThreadInfoStruct *>(arg);
+  Self * self = static_cast<Self *>(info->UserData);
+  self->ProcessQueue();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+ImageIOWriteBehindQueue
+::ProcessQueue()
+{
+  if (Tracer::GetInstance().IsEnabled())
+    {
+    Tracer::GetInstance().SetCurrentThreadName("I/O");
+    }
+
+  while (true)
+    {
+    PendingRegion pending;
+
+    m_Mutex.Lock();
+    while (m_Queue.empty() && !m_Closed)
+      {
+      m_NotEmpty->Wait(&m_Mutex);
+      }
+    if (m_Queue.empty())
+      {
+      // Queue closed and drained
+      m_Mutex.Unlock();
+      break;
+      }
+    pending = m_Queue.front();
+    m_Queue.pop_front();
+    ++m_NumberOfRegionsInProgress;
+    m_Mutex.Unlock();
+
+    bool failed = false;
+    std::string description;
+    Stopwatch chrono = Stopwatch::StartNew();
+    try
+      {
+      this->WriteRegion(pending);
+      }
+    catch (itk::ExceptionObject & err)
+      {
+      failed = true;
+      description = err.GetDescription();
+      }
+    catch (std::exception & err)
+      {
+      failed = true;
+      description = err.what();
+      }
+    catch (...)
+      {
+      // Nothing may escape the I/O thread: the error is rethrown by the
+      // writer thread like the others
+      failed = true;
+      description = "unknown exception";
+      }
+
+    chrono.Stop();
+
+    m_Mutex.Lock();
+    // The slot is released only once written, so that the number of
+    // buffers alive never exceeds the queue depth plus the one being
+    // computed
+    --m_NumberOfRegionsInProgress;
+    m_WritingTime += chrono.GetElapsedMilliseconds();
+    if (failed)
+      {
+      // Keep the first error if several I/O threads fail
+      if (!m_HasError)
+        {
+        m_HasError = true;
+        m_ErrorDescription = description;
+        }
+      m_Queue.clear();
+      }
+    m_NotFull->Broadcast();
+    m_Mutex.Unlock();
+
+    if (failed)
+      {
+      break;
+      }
+    }
+}
+
+void
+ImageIOWriteBehindQueue
+::WriteRegion(PendingRegion & pending)
+{
+  TraceScope traceScope("Write", "io");
+  traceScope.AddArgument("file", m_ImageIO->GetFileName());
+  traceScope.AddArgument("bytes", static_cast<unsigned long long>(pending.numberOfPixels)
+                         * m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents());
+
+  if (!m_BandList.empty())
+    {
+    // Remap the components of the buffer, as done by the synchronous writer
+    ImageIOBase::MapBuffer(pending.buffer, pending.numberOfPixels,
+                           m_ImageIO->GetComponentSize(), m_NumberOfComponents, m_BandList);
+    }
+
+  if (m_Concurrent)
+    {
+    m_ImageIO->WriteRegion(pending.region, pending.buffer);
+    }
+  else
+    {
+    m_ImageIO->SetIORegion(pending.region);
+    m_ImageIO->Write(pending.buffer);
+    }
+}
+
+void
+ImageIOWriteBehindQueue
+::PrintSelf(std::ostream& os, itk::Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfPendingRegions: " << m_MaximumNumberOfPendingRegions << std::endl;
+  os << indent << "NumberOfIOThreads: " << m_NumberOfIOThreads << std::endl;
+  os << indent << "WaitingTime (ms): " << m_WaitingChrono.GetElapsedMilliseconds() << std::endl;
+  os << indent << "WritingTime (ms): " << m_WritingTime << std::endl;
+}
+
+} // end namespace otb
@@ -151,6 +151,7 @@ void RegisterTests()
   REGISTER_TEST(otbImageFileReaderOptBandTest);
   REGISTER_TEST(otbImageFileWriterOptBandTest);
   REGISTER_TEST(otbMultiImageFileWriterTest);
+  REGISTER_TEST(otbPyramidImageFileWriter);
   REGISTER_TEST(otbWriteGeomFile);
 #if OTB_USE_DEPRECATED
   REGISTER_TEST(otbImageFileReaderServerName);
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbPyramidImageFileWriter.h"
+#include "otbVectorImage.h"
+#include "otbImageFileReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+typedef unsigned short                       PixelType;
+typedef otb::VectorImage<PixelType, 2>       ImageType;
+typedef otb::ImageFileReader<ImageType>      ReaderType;
+
+// Level decimated by factor from the previous one, by block averaging
+std::vector<PixelType> ReduceLevel(const std::vector<PixelType> & input, unsigned int width, unsigned int height,
+                                   unsigned int nbComp, unsigned int factor)
+{
+  const unsigned int outWidth = (width + factor - 1) / factor;
+  const unsigned int outHeight = (height + factor - 1) / factor;
+  std::vector<PixelType> output(outWidth * outHeight * nbComp);
+  for (unsigned int j = 0; j < outHeight; ++j)
+    {
+    for (unsigned int i = 0; i < outWidth; ++i)
+      {
+      for (unsigned int b = 0; b < nbComp; ++b)
+        {
+        double sum = 0.;
+        unsigned int count = 0;
+        for (unsigned int y = j * factor; y < std::min((j + 1) * factor, height); ++y)
+          {
+          for (unsigned int x = i * factor; x < std::min((i + 1) * factor, width); ++x)
+            {
+            sum += input[(y * width + x) * nbComp + b];
+            ++count;
+            }
+          }
+        output[(j * outWidth + i) * nbComp + b] = static_cast<PixelType>(std::floor(sum / count + 0.5));
+        }
+      }
+    }
+  return output;
+}
+
+bool CheckLevel(const std::string & fileName, const std::vector<PixelType> & expected,
+                unsigned int width, unsigned int height, double spacing)
+{
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->Update();
+
+  ImageType * image = reader->GetOutput();
+  const ImageType::SizeType size = image->GetLargestPossibleRegion().GetSize();
+  if (size[0] != width || size[1] != height)
+    {
+    std::cerr << fileName << ": size " << size << " instead of " << width << "x" << height << std::endl;
+    return false;
+    }
+
+  if (std::abs(image->GetSignedSpacing()[0] - spacing) > 1e-9 * std::abs(spacing))
+    {
+    std::cerr << fileName << ": spacing " << image->GetSignedSpacing()[0] << " instead of " << spacing << std::endl;
+    return false;
+    }
+
+  const PixelType * buffer = image->GetBufferPointer();
+  for (size_t k = 0; k < expected.size(); ++k)
+    {
+    if (buffer[k] != expected[k])
+      {
+      std::cerr << fileName << ": value " << buffer[k] << " instead of " << expected[k]
+                << " at offset " << k << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int otbPyramidImageFileWriter(int argc, char* argv[])
+{
+  typedef otb::PyramidImageFileWriter<ImageType> WriterType;
+
+  if (argc < 6)
+    {
+    std::cout << "Usage: " << argv[0] << " inputImageFileName outputImageFileName outputOverviewsFileName numberOfLevels numberOfLinesPerStrip\n";
+    return EXIT_FAILURE;
+    }
+
+  const char * inputImageFileName = argv[1];
+  const std::string outputImageFileName = argv[2];
+  const std::string outputOverviewsFileName = argv[3];
+  const unsigned int nbLevels = atoi(argv[4]);
+  const unsigned int nbLinesPerStrip = atoi(argv[5]);
+
+  // Levels written in files of their own
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(inputImageFileName);
+
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(reader->GetOutput());
+  writer->SetFileName(outputImageFileName);
+  writer->SetNumberOfLevels(nbLevels);
+  writer->SetShrinkFactor(2);
+  writer->SetNumberOfLinesStrippedStreaming(nbLinesPerStrip);
+  writer->Update();
+
+  std::cout << writer << std::endl;
+
+  // Levels written as GeoTIFF overviews
+  ReaderType::Pointer overviewsReader = ReaderType::New();
+  overviewsReader->SetFileName(inputImageFileName);
+
+  WriterType::Pointer overviewsWriter = WriterType::New();
+  overviewsWriter->SetInput(overviewsReader->GetOutput());
+  overviewsWriter->SetFileName(outputOverviewsFileName);
+  overviewsWriter->SetNumberOfLevels(nbLevels);
+  overviewsWriter->SetShrinkFactor(2);
+  overviewsWriter->WriteOverviewsOn();
+  overviewsWriter->SetNumberOfLinesStrippedStreaming(nbLinesPerStrip);
+  overviewsWriter->Update();
+
+  // Expected levels, reduced from the whole input image
+  ReaderType::Pointer inputReader = ReaderType::New();
+  inputReader->SetFileName(inputImageFileName);
+  inputReader->Update();
+
+  ImageType * input = inputReader->GetOutput();
+  unsigned int width = input->GetLargestPossibleRegion().GetSize()[0];
+  unsigned int height = input->GetLargestPossibleRegion().GetSize()[1];
+  const unsigned int nbComp = input->GetNumberOfComponentsPerPixel();
+  double spacing = input->GetSignedSpacing()[0];
+  std::vector<PixelType> level(input->GetBufferPointer(),
+                               input->GetBufferPointer() + width * height * nbComp);
+
+  bool fail = !CheckLevel(outputImageFileName, level, width, height, spacing)
+              || !CheckLevel(outputOverviewsFileName, level, width, height, spacing);
+
+  for (unsigned int k = 1; k <= nbLevels && !fail; ++k)
+    {
+    level = ReduceLevel(level, width, height, nbComp, 2);
+    width = (width + 1) / 2;
+    height = (height + 1) / 2;
+    spacing *= 2;
+
+    std::ostringstream overview;
+    overview << outputOverviewsFileName << "?&resol=" << k;
+
+    fail = !CheckLevel(writer->GetLevelFileName(k), level, width, height, spacing)
+           || !CheckLevel(overview.str(), level, width, height, spacing);
+    }
+
+  return fail ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -25,6 +25,8 @@
 #include "itkImageRegionIterator.h"
 #include "itkProgressReporter.h"
 
+#include <vector>
+
 namespace otb
 {
 /**
@@ -210,21 +212,14 @@ ImageClassificationFilter<TInputImage, TOutputImage, TMaskImage>
     maskIt.GoToBegin();
     }
 
-  // typedef typename ModelType::InputValueType       InputValueType;
-  typedef typename ModelType::InputSampleType      InputSampleType;
-  typedef typename ModelType::InputListSampleType  InputListSampleType;
-  typedef typename ModelType::TargetValueType      TargetValueType;
-  // typedef typename ModelType::TargetSampleType     TargetSampleType;
-  typedef typename ModelType::TargetListSampleType TargetListSampleType;
-  // typedef typename ModelType::ConfidenceValueType      ConfidenceValueType;
-  // typedef typename ModelType::ConfidenceSampleType     ConfidenceSampleType;
-  typedef typename ModelType::ConfidenceListSampleType ConfidenceListSampleType;
-
-  typename InputListSampleType::Pointer samples = InputListSampleType::New();
-  unsigned int num_features = inputPtr->GetNumberOfComponentsPerPixel();
-  samples->SetMeasurementVectorSize(num_features);
-  InputSampleType sample(num_features);
-  // Fill the samples
+  typedef typename ModelType::InputValueType      InputValueType;
+  typedef typename ModelType::TargetValueType     TargetValueType;
+  typedef typename ModelType::ConfidenceValueType ConfidenceValueType;
+
+  // Fill a contiguous matrix with the valid pixels, one row per pixel
+  const unsigned int num_features = inputPtr->GetNumberOfComponentsPerPixel();
+  std::vector<InputValueType> samples;
+  samples.reserve(static_cast<size_t>(outputRegionForThread.GetNumberOfPixels()) * num_features);
   bool validPoint = true;
   for (inIt.GoToBegin(); !inIt.IsAtEnd(); ++inIt)
     {
@@ -236,22 +231,24 @@ ImageClassificationFilter<TInputImage, TOutputImage, TMaskImage>
       }
     if(validPoint)
       {
-      typename InputImageType::PixelType pix = inIt.Get();
-      for(size_t feat=0; feat<num_features; ++feat)
+      const typename InputImageType::PixelType & pix = inIt.Get();
+      for(unsigned int feat=0; feat<num_features; ++feat)
         {
-        sample[feat]=pix[feat];
+        samples.push_back(static_cast<InputValueType>(pix[feat]));
         }
-      samples->PushBack(sample);
       }
     }
+  const unsigned int nbSamples = num_features > 0 ? samples.size() / num_features : 0;
+
   //Make the batch prediction
-  typename TargetListSampleType::Pointer labels;
-  typename ConfidenceListSampleType::Pointer confidences;
+  std::vector<TargetValueType> labels(nbSamples);
+  std::vector<ConfidenceValueType> confidences;
   if(computeConfidenceMap)
-    confidences = ConfidenceListSampleType::New();
+    confidences.resize(nbSamples);
 
   // This call is threadsafe
-  labels = m_Model->PredictBatch(samples,confidences);
+  m_Model->PredictBatch(samples.data(), nbSamples, num_features, labels.data(),
+                        computeConfidenceMap ? confidences.data() : nullptr);
 
   // Set the output values
   ConfidenceMapIteratorType confidenceIt;
@@ -261,7 +258,7 @@ ImageClassificationFilter<TInputImage, TOutputImage, TMaskImage>
     confidenceIt.GoToBegin();
     }
 
-  typename TargetListSampleType::ConstIterator labIt = labels->Begin();
+  unsigned int sampleId = 0;
   maskIt.GoToBegin();
   for (outIt.GoToBegin(); !outIt.IsAtEnd(); ++outIt)
     {
@@ -272,22 +269,22 @@ ImageClassificationFilter<TInputImage, TOutputImage, TMaskImage>
       validPoint = maskIt.Get() > 0;
       ++maskIt;
       }
-    if (validPoint && labIt!=labels->End())
+    if (validPoint && sampleId < nbSamples)
       {
-      labelValue = labIt.GetMeasurementVector()[0];
+      labelValue = labels[sampleId];
 
-       if(computeConfidenceMap)
+      if(computeConfidenceMap)
         {
-        confidenceIndex = confidences->GetMeasurementVector(labIt.GetInstanceIdentifier())[0];
+        confidenceIndex = confidences[sampleId];
         }
-       
-      ++labIt;    
+
+      ++sampleId;
       }
     else
       {
       labelValue = m_DefaultLabel;
       }
-    
+
     outIt.Set(labelValue);
 
     if(computeConfidenceMap)
@@ -295,7 +292,7 @@ ImageClassificationFilter<TInputImage, TOutputImage, TMaskImage>
       confidenceIt.Set(confidenceIndex);
       ++confidenceIt;
       }
-    
+
     progress.CompletedPixel();
     }
 }
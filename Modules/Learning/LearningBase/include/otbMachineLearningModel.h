@@ -131,6 +131,21 @@ public:
     * with OpenMP.
      */
   typename TargetListSampleType::Pointer PredictBatch(const InputListSampleType * input, ConfidenceListSampleType * quality = nullptr) const;
+
+  /** Predict a batch of samples stored in a contiguous row-major matrix
+    * \param input The nbSamples x nbFeatures matrix of samples
+    * \param nbSamples Number of samples (rows of the matrix)
+    * \param nbFeatures Number of features of each sample
+    * \param targets Array of nbSamples values where to store the
+    * predicted labels
+    * \param quality Array of nbSamples values where to store the
+    * confidence values, or NULL
+    * This method avoids the allocation of a sample per row, and is
+    * not multi-threaded: it is meant to be called from several threads
+    * on distinct matrices. Only for models with a single target value.
+     */
+  void PredictBatch(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures,
+                    TargetValueType * targets, ConfidenceValueType * quality = nullptr) const;
   
 /**\name Classification model file manipulation */
 //@{
@@ -232,6 +247,22 @@ private:
     */
   virtual void DoPredictBatch(const InputListSampleType * input, const unsigned int & startIndex, const unsigned int & size, TargetListSampleType * target, ConfidenceListSampleType * quality = nullptr) const;
 
+  /**  Actual implementation of the prediction of a contiguous matrix
+    *  of samples
+    *  Default implementation wraps each row in a sample, without
+    *  copy, and calls DoPredict iteratively
+    *  \param input The nbSamples x nbFeatures row-major matrix
+    *  \param nbSamples Number of samples
+    *  \param nbFeatures Number of features of each sample
+    *  \param targets Array of the nbSamples produced labels
+    *  \param quality Array of the nbSamples produced confidence
+    *  values, or NULL
+    *
+    * Override me if internal implementation allows for batch
+    * prediction.
+    */
+  virtual void DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const;
+
   /** Actual implementation of single sample prediction
    *  \param input sample to predict
    *  \param quality Pointer to a variable to store confidence value,
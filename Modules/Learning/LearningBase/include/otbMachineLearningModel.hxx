@@ -132,6 +132,80 @@ MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
 
 
 
+template <class TInputValue, class TOutputValue, class TConfidenceValue>
+void
+MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
+::PredictBatch(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures,
+               TargetValueType * targets, ConfidenceValueType * quality) const
+{
+  assert(targets != nullptr);
+
+  if (nbSamples == 0)
+    {
+    return;
+    }
+  assert(input != nullptr);
+
+  if(m_IsDoPredictBatchMultiThreaded)
+    {
+    // Simply calls DoPredictBatchMatrix
+    this->DoPredictBatchMatrix(input,nbSamples,nbFeatures,targets,quality);
+    return;
+    }
+
+#ifdef _OPENMP
+  // OpenMP threading here, each thread predicting a contiguous range of rows
+  unsigned int nb_threads(0), threadId(0), nb_batches(0);
+
+#pragma omp parallel shared(nb_threads,nb_batches) private(threadId)
+  {
+  // Get number of threads configured with ITK
+  omp_set_num_threads(itk::MultiThreader::GetGlobalDefaultNumberOfThreads());
+  nb_threads = omp_get_num_threads();
+  threadId = omp_get_thread_num();
+  nb_batches = std::min(nb_threads,nbSamples);
+  // Ensure that we do not spawn unnecessary threads
+  if(threadId<nb_batches)
+    {
+    unsigned int batch_size = nbSamples/nb_batches;
+    const unsigned int batch_start = threadId*batch_size;
+    if(threadId == nb_batches-1)
+      {
+      batch_size+=nbSamples%nb_batches;
+      }
+
+    this->DoPredictBatchMatrix(input+static_cast<size_t>(batch_start)*nbFeatures,batch_size,nbFeatures,
+                               targets+batch_start,quality != nullptr ? quality+batch_start : nullptr);
+    }
+  }
+#else
+  this->DoPredictBatchMatrix(input,nbSamples,nbFeatures,targets,quality);
+#endif
+}
+
+template <class TInputValue, class TOutputValue, class TConfidenceValue>
+void
+MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
+::DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const
+{
+  // The sample only refers to the row, it does not own its data
+  InputSampleType sample;
+  for(unsigned int id = 0;id<nbSamples;++id)
+    {
+    sample.SetData(const_cast<InputValueType *>(input + static_cast<size_t>(id)*nbFeatures),nbFeatures,false);
+    if(quality != nullptr)
+      {
+      ConfidenceValueType confidence = 0;
+      targets[id] = this->DoPredict(sample,&confidence)[0];
+      quality[id] = confidence;
+      }
+    else
+      {
+      targets[id] = this->DoPredict(sample)[0];
+      }
+    }
+}
+
 template <class TInputValue, class TOutputValue, class TConfidenceValue>
 void
 MachineLearningModel<TInputValue,TOutputValue,TConfidenceValue>
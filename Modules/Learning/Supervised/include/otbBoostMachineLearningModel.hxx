@@ -137,6 +137,49 @@ BoostMachineLearningModel<TInputValue,TOutputValue>
   return target;
 }
 
+template <class TInputValue, class TOutputValue>
+void
+BoostMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const
+{
+  //convert the matrix to Mat
+  cv::Mat samples;
+  otb::ArrayToMat<InputValueType>(input, nbSamples, nbFeatures, samples);
+
+#ifdef OTB_OPENCV_3
+  // All the rows are predicted at once
+  cv::Mat results;
+  m_BoostModel->predict(samples, results);
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    targets[i] = static_cast<TOutputValue>(results.at<float>(i,0));
+    }
+
+  if (quality != nullptr)
+    {
+    cv::Mat rawResults;
+    m_BoostModel->predict(samples, rawResults, cv::ml::StatModel::RAW_OUTPUT);
+    for (unsigned int i = 0; i < nbSamples; ++i)
+      {
+      quality[i] = static_cast<ConfidenceValueType>(rawResults.at<float>(i,0));
+      }
+    }
+#else
+  cv::Mat missing  = cv::Mat(1,nbFeatures, CV_8U );
+  missing.setTo(0);
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    const cv::Mat sample = samples.row(i);
+    targets[i] = static_cast<TOutputValue>(m_BoostModel->predict(sample,missing));
+    if (quality != nullptr)
+      {
+      quality[i] = static_cast<ConfidenceValueType>(
+        m_BoostModel->predict(sample,missing,cv::Range::all(),false,true));
+      }
+    }
+#endif
+}
+
 template <class TInputValue, class TOutputValue>
 void
 BoostMachineLearningModel<TInputValue,TOutputValue>
@@ -29,6 +29,8 @@
 
 #ifdef OTB_OPENCV_3
 #include "otbOpenCVUtils.h"
+
+#include <vector>
 #else
 class CvKNearest;
 #endif
@@ -106,6 +108,9 @@ protected:
   /** Predict values using the model */
   TargetSampleType DoPredict(const InputSampleType& input, ConfidenceValueType *quality=nullptr) const override;
 
+  /** Predict values of a contiguous matrix of samples using the model */
+  void DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const override;
+
   
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
@@ -114,6 +119,12 @@ private:
   KNearestNeighborsMachineLearningModel(const Self &) = delete;
   void operator =(const Self&) = delete;
 
+  /** Apply the decision rule to the responses of the K nearest
+   *  neighbours of a sample, given the result of OpenCV, and compute
+   *  its quality if asked. values is a scratch buffer. */
+  float ApplyDecisionRule(float result, const float * nearest, ConfidenceValueType * quality,
+                          std::vector<float> & values) const;
+
 #ifdef OTB_OPENCV_3
   cv::Ptr<cv::ml::KNearest> m_KNearestModel;
 #else
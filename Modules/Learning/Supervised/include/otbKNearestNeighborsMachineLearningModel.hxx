@@ -25,8 +25,8 @@
 #include "otbKNearestNeighborsMachineLearningModel.h"
 #include "otbOpenCVUtils.h"
 
+#include <algorithm>
 #include <fstream>
-#include <set>
 #include "itkMacro.h"
 
 namespace otb
@@ -103,24 +103,11 @@ KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
 }
 
 template <class TInputValue, class TTargetValue>
-typename KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
-::TargetSampleType
+float
 KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
-::DoPredict(const InputSampleType & input, ConfidenceValueType *quality) const
+::ApplyDecisionRule(float result, const float * nearest, ConfidenceValueType * quality,
+                    std::vector<float> & values) const
 {
-  TargetSampleType target;
-
-  //convert listsample to Mat
-  cv::Mat sample;
-  otb::SampleToMat<InputSampleType>(input, sample);
-
-  float result;
-  cv::Mat nearest(1,m_K,CV_32FC1);
-#ifdef OTB_OPENCV_3
-  result = m_KNearestModel->findNearest(sample, m_K, cv::noArray(), nearest, cv::noArray());
-#else
-  result = m_KNearestModel->find_nearest(sample, m_K,nullptr,nullptr,&nearest,nullptr);
-#endif
   // compute quality if asked (only happens in classification mode)
   if (quality != nullptr)
     {
@@ -128,7 +115,7 @@ KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
     unsigned int accuracy = 0;
     for (int k=0 ; k < m_K ; ++k)
       {
-      if (nearest.at<float>(0,k) == result)
+      if (nearest[k] == result)
         {
         accuracy++;
         }
@@ -142,21 +129,69 @@ KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
   //  MEDIAN : only case that must be handled here
   if (this->m_DecisionRule == KNN_MEDIAN)
     {
-    std::multiset<float> values;
-    for (int k=0 ; k < m_K ; ++k)
-      {
-      values.insert(nearest.at<float>(0,k));
-      }
-    std::multiset<float>::iterator median = values.begin();
-    int pos = (m_K >> 1);
-    for (int k=0 ; k < pos ; ++k , ++median) {}
+    values.assign(nearest, nearest + m_K);
+    std::vector<float>::iterator median = values.begin() + (m_K >> 1);
+    std::nth_element(values.begin(), median, values.end());
     result = *median;
     }
 
+  return result;
+}
+
+template <class TInputValue, class TTargetValue>
+typename KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
+::TargetSampleType
+KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
+::DoPredict(const InputSampleType & input, ConfidenceValueType *quality) const
+{
+  TargetSampleType target;
+
+  //convert listsample to Mat
+  cv::Mat sample;
+  otb::SampleToMat<InputSampleType>(input, sample);
+
+  float result;
+  cv::Mat nearest(1,m_K,CV_32FC1);
+#ifdef OTB_OPENCV_3
+  result = m_KNearestModel->findNearest(sample, m_K, cv::noArray(), nearest, cv::noArray());
+#else
+  result = m_KNearestModel->find_nearest(sample, m_K,nullptr,nullptr,&nearest,nullptr);
+#endif
+
+  std::vector<float> values;
+  result = this->ApplyDecisionRule(result, nearest.ptr<float>(0), quality, values);
+
   target[0] = static_cast<TTargetValue>(result);
   return target;
 }
 
+template <class TInputValue, class TTargetValue>
+void
+KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
+::DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const
+{
+  //convert the matrix to Mat
+  cv::Mat samples;
+  otb::ArrayToMat<InputValueType>(input, nbSamples, nbFeatures, samples);
+
+  // The neighbours of all the rows are searched at once
+  cv::Mat results(nbSamples,1,CV_32FC1);
+  cv::Mat nearest(nbSamples,m_K,CV_32FC1);
+#ifdef OTB_OPENCV_3
+  m_KNearestModel->findNearest(samples, m_K, results, nearest, cv::noArray());
+#else
+  m_KNearestModel->find_nearest(samples, m_K,&results,nullptr,&nearest,nullptr);
+#endif
+
+  std::vector<float> values;
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    const float result = this->ApplyDecisionRule(results.at<float>(i,0), nearest.ptr<float>(i),
+                                                 quality != nullptr ? quality + i : nullptr, values);
+    targets[i] = static_cast<TTargetValue>(result);
+    }
+}
+
 template <class TInputValue, class TTargetValue>
 void
 KNearestNeighborsMachineLearningModel<TInputValue,TTargetValue>
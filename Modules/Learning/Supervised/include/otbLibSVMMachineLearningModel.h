@@ -274,6 +274,9 @@ protected:
   /** Predict values using the model */
   TargetSampleType DoPredict(const InputSampleType& input, ConfidenceValueType *quality=nullptr) const override;
 
+  /** Predict values of a contiguous matrix of samples using the model */
+  void DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const override;
+
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
 
@@ -289,6 +292,11 @@ private:
 
   void DeleteModel(void);
 
+  /** Predict the value of a sample, given as a terminated array of nodes.
+   *  probEstimates must hold one value per class. */
+  TargetValueType PredictNodes(const struct svm_node * x, ConfidenceValueType * quality,
+                               double * probEstimates) const;
+
   void OptimizeParameters(void);
 
   /** Container to hold the SVM model itself */
@@ -21,7 +21,9 @@
 #ifndef otbLibSVMMachineLearningModel_hxx
 #define otbLibSVMMachineLearningModel_hxx
 
+#include <algorithm>
 #include <fstream>
+#include <vector>
 #include "otbLibSVMMachineLearningModel.h"
 #include "otbSVMCrossValidationCostFunction.h"
 #include "otbExhaustiveExponentialOptimizer.h"
@@ -105,30 +107,15 @@ LibSVMMachineLearningModel<TInputValue,TOutputValue>
 
 template <class TInputValue, class TOutputValue>
 typename LibSVMMachineLearningModel<TInputValue,TOutputValue>
-::TargetSampleType
+::TargetValueType
 LibSVMMachineLearningModel<TInputValue,TOutputValue>
-::DoPredict(const InputSampleType & input, ConfidenceValueType *quality) const
+::PredictNodes(const struct svm_node * x, ConfidenceValueType * quality, double * probEstimates) const
 {
-  TargetSampleType target;
-  target.Fill(0);
+  TargetValueType target = 0;
 
   // Get type and number of classes
   int svm_type = svm_get_svm_type(m_Model);
-
-  // Allocate nodes (/TODO if performances problems are related to too
-  // many allocations, a cache approach can be set)
-  struct svm_node * x = new struct svm_node[input.Size() + 1];
-
-  // Fill the node
-  for (unsigned int i = 0 ; i < input.Size() ; i++)
-    {
-    x[i].index = i + 1;
-    x[i].value = input[i];
-    }
-
-  // terminate node
-  x[input.Size()].index = -1;
-  x[input.Size()].value = 0;
+  unsigned int nr_class = svm_get_nr_class(m_Model);
 
   if (quality != nullptr)
     {
@@ -140,32 +127,27 @@ LibSVMMachineLearningModel<TInputValue,TOutputValue>
       {
       if (svm_type == C_SVC || svm_type == NU_SVC)
         {
-        // Eventually allocate space for probabilities
-        unsigned int nr_class = svm_get_nr_class(m_Model);
-        double *prob_estimates = new double[nr_class];
         // predict
-        target[0] = static_cast<TargetValueType>(svm_predict_probability(m_Model, x, prob_estimates));
+        target = static_cast<TargetValueType>(svm_predict_probability(m_Model, x, probEstimates));
         double maxProb = 0.0;
         double secProb = 0.0;
         for (unsigned int i=0 ; i< nr_class ; ++i)
           {
-          if (maxProb < prob_estimates[i])
+          if (maxProb < probEstimates[i])
             {
             secProb = maxProb;
-            maxProb = prob_estimates[i];
+            maxProb = probEstimates[i];
             }
-          else if (secProb < prob_estimates[i])
+          else if (secProb < probEstimates[i])
             {
-            secProb = prob_estimates[i];
+            secProb = probEstimates[i];
             }
           }
         (*quality) = static_cast<ConfidenceValueType>(maxProb - secProb);
-
-        delete[] prob_estimates;
         }
       else
         {
-        target[0] = static_cast<TargetValueType>(svm_predict(m_Model, x));
+        target = static_cast<TargetValueType>(svm_predict(m_Model, x));
         // Prob. model for test data: target value = predicted value + z
         // z: Laplace distribution e^(-|z|/sigma)/(2sigma)
         // sigma is output as confidence index
@@ -174,11 +156,16 @@ LibSVMMachineLearningModel<TInputValue,TOutputValue>
       }
     else if (this->m_ConfidenceMode == CM_PROBA)
       {
-      target[0] = static_cast<TargetValueType>(svm_predict_probability(m_Model, x, quality));
+      // The probabilities of all the classes are estimated, the one of
+      // the first class is the confidence index
+      target = static_cast<TargetValueType>(svm_predict_probability(m_Model, x, probEstimates));
+      (*quality) = static_cast<ConfidenceValueType>(probEstimates[0]);
       }
     else if (this->m_ConfidenceMode == CM_HYPER)
       {
-      target[0] = static_cast<TargetValueType>(svm_predict_values(m_Model, x, quality));
+      // One decision value per pair of classes
+      target = static_cast<TargetValueType>(svm_predict_values(m_Model, x, probEstimates));
+      (*quality) = static_cast<ConfidenceValueType>(probEstimates[0]);
       }
     }
   else
@@ -187,23 +174,78 @@ LibSVMMachineLearningModel<TInputValue,TOutputValue>
     // which gives different results than svm_predict()
     if (svm_check_probability_model(m_Model))
       {
-      unsigned int nr_class = svm_get_nr_class(m_Model);
-      double *prob_estimates = new double[nr_class];
-      target[0] = static_cast<TargetValueType>(svm_predict_probability(m_Model, x, prob_estimates));
-      delete[] prob_estimates;
+      target = static_cast<TargetValueType>(svm_predict_probability(m_Model, x, probEstimates));
       }
     else
       {
-      target[0] = static_cast<TargetValueType>(svm_predict(m_Model, x));
+      target = static_cast<TargetValueType>(svm_predict(m_Model, x));
       }
     }
 
-  // Free allocated memory
-  delete[] x;
+  return target;
+}
+
+template <class TInputValue, class TOutputValue>
+typename LibSVMMachineLearningModel<TInputValue,TOutputValue>
+::TargetSampleType
+LibSVMMachineLearningModel<TInputValue,TOutputValue>
+::DoPredict(const InputSampleType & input, ConfidenceValueType *quality) const
+{
+  TargetSampleType target;
+  target.Fill(0);
+
+  // Allocate nodes
+  std::vector<struct svm_node> x(input.Size() + 1);
+
+  // Fill the node
+  for (unsigned int i = 0 ; i < input.Size() ; i++)
+    {
+    x[i].index = i + 1;
+    x[i].value = input[i];
+    }
+
+  // terminate node
+  x[input.Size()].index = -1;
+  x[input.Size()].value = 0;
+
+  // Room for the probabilities or the decision values
+  const unsigned int nr_class = svm_get_nr_class(m_Model);
+  std::vector<double> probEstimates(std::max(1u, nr_class * (nr_class - 1) / 2 + nr_class));
+
+  target[0] = this->PredictNodes(x.data(), quality, probEstimates.data());
 
   return target;
 }
 
+template <class TInputValue, class TOutputValue>
+void
+LibSVMMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const
+{
+  // The nodes and the probabilities are allocated once for all the samples
+  std::vector<struct svm_node> x(nbFeatures + 1);
+  for (unsigned int i = 0 ; i < nbFeatures ; i++)
+    {
+    x[i].index = i + 1;
+    }
+  x[nbFeatures].index = -1;
+  x[nbFeatures].value = 0;
+
+  const unsigned int nr_class = svm_get_nr_class(m_Model);
+  std::vector<double> probEstimates(std::max(1u, nr_class * (nr_class - 1) / 2 + nr_class));
+
+  for (unsigned int id = 0 ; id < nbSamples ; ++id)
+    {
+    const InputValueType * sample = input + static_cast<size_t>(id) * nbFeatures;
+    for (unsigned int i = 0 ; i < nbFeatures ; i++)
+      {
+      x[i].value = sample[i];
+      }
+    targets[id] = this->PredictNodes(x.data(), quality != nullptr ? quality + id : nullptr,
+                                     probEstimates.data());
+    }
+}
+
 template <class TInputValue, class TOutputValue>
 void
 LibSVMMachineLearningModel<TInputValue,TOutputValue>
@@ -78,6 +78,24 @@ namespace otb
   }
 
 
+  /** Converts a contiguous row-major matrix of rows x cols values to a
+   *  float cv::Mat, row after row */
+  template <class T> void ArrayToMat(const T * data, unsigned int rows, unsigned int cols, cv::Mat& output)
+  {
+    output.create(rows,cols,CV_32FC1);
+
+    for(unsigned int r = 0; r < rows; ++r)
+      {
+      float * outputRow = output.ptr<float>(r);
+      const T * inputRow = data + static_cast<size_t>(r) * cols;
+      for(unsigned int c = 0; c < cols; ++c)
+        {
+        outputRow[c] = static_cast<float>(inputRow[c]);
+        }
+      }
+  }
+
+
   /** Converts a ListSample of VariableLengthVector to a CvMat. The user
    *  is responsible for freeing the output pointer with the
    *  cvReleaseMat function.  A null pointer is resturned in case the
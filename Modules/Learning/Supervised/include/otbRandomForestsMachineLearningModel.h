@@ -139,6 +139,9 @@ protected:
   /** Predict values using the model */
   TargetSampleType DoPredict(const InputSampleType& input, ConfidenceValueType *quality=nullptr) const override;
 
+  /** Predict values of a contiguous matrix of samples using the model */
+  void DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const override;
+
   
   /** PrintSelf method */
   void PrintSelf(std::ostream& os, itk::Indent indent) const override;
@@ -193,6 +193,43 @@ RandomForestsMachineLearningModel<TInputValue,TOutputValue>
   return target[0];
 }
 
+template <class TInputValue, class TOutputValue>
+void
+RandomForestsMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const
+{
+  //convert the matrix to Mat
+  cv::Mat samples;
+  otb::ArrayToMat<InputValueType>(input, nbSamples, nbFeatures, samples);
+
+#ifdef OTB_OPENCV_3
+  // All the rows are predicted at once
+  cv::Mat results;
+  m_RFModel->predict(samples, results);
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    targets[i] = static_cast<TOutputValue>(results.at<float>(i,0));
+    }
+#else
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    targets[i] = static_cast<TOutputValue>(m_RFModel->predict(samples.row(i)));
+    }
+#endif
+
+  if (quality != nullptr)
+    {
+    for (unsigned int i = 0; i < nbSamples; ++i)
+      {
+      const cv::Mat sample = samples.row(i);
+      if(m_ComputeMargin)
+        quality[i] = m_RFModel->predict_margin(sample);
+      else
+        quality[i] = m_RFModel->predict_confidence(sample);
+      }
+    }
+}
+
 template <class TInputValue, class TOutputValue>
 void
 RandomForestsMachineLearningModel<TInputValue,TOutputValue>
@@ -162,42 +162,71 @@ SharkRandomForestsMachineLearningModel<TInputValue,TOutputValue>
     itkExceptionMacro(<<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[");
     }
   
+  // The range is predicted as a contiguous matrix of samples
+  std::vector<InputValueType> matrix;
+  Shark::ListSampleRangeToArray(input, matrix, startIndex, size);
+  std::vector<TargetValueType> predictions(size);
+  std::vector<ConfidenceValueType> confidences(quality != nullptr ? size : 0);
+  this->DoPredictBatchMatrix(matrix.data(), size, input->GetMeasurementVectorSize(), predictions.data(),
+                             quality != nullptr ? confidences.data() : nullptr);
+
+  for(unsigned int i = 0; i < size; ++i)
+    {
+    TargetSampleType target;
+    target[0] = predictions[i];
+    targets->SetMeasurementVector(startIndex+i,target);
+    if(quality != nullptr)
+      {
+      ConfidenceSampleType confidence;
+      confidence[0] = confidences[i];
+      quality->SetMeasurementVector(startIndex+i,confidence);
+      }
+    }
+}
+
+template <class TInputValue, class TOutputValue>
+void
+SharkRandomForestsMachineLearningModel<TInputValue,TOutputValue>
+::DoPredictBatchMatrix(const InputValueType * input, unsigned int nbSamples, unsigned int nbFeatures, TargetValueType * targets, ConfidenceValueType * quality) const
+{
+  assert(targets != nullptr);
+
+  if(nbSamples == 0)
+    {
+    return;
+    }
+
   std::vector<shark::RealVector> features;
-  Shark::ListSampleRangeToSharkVector(input, features,startIndex,size);
+  Shark::ArrayToSharkVector(input, nbSamples, nbFeatures, features);
   shark::Data<shark::RealVector> inputSamples = shark::createDataFromRange(features);
 
 #ifdef _OPENMP
   omp_set_num_threads(itk::MultiThreader::GetGlobalDefaultNumberOfThreads());
 #endif
-  
+
   if(quality != nullptr)
     {
     shark::Data<shark::RealVector> probas = m_RFModel.decisionFunction()(inputSamples);
-    unsigned int id = startIndex;
+    unsigned int id = 0;
     for(shark::RealVector && p : probas.elements())
       {
-      ConfidenceSampleType confidence;
-      auto conf = ComputeConfidence(p, m_ComputeMargin);
-      confidence[0] = static_cast<ConfidenceValueType>(conf);
-      quality->SetMeasurementVector(id,confidence);
+      quality[id] = ComputeConfidence(p, m_ComputeMargin);
       ++id;
       }
     }
-    
+
   auto prediction = m_RFModel(inputSamples);
-  unsigned int id = startIndex;
+  unsigned int id = 0;
   for(const auto& p : prediction.elements())
     {
-    TargetSampleType target;
     if(m_NormalizeClassLabels)
       {
-      target[0] = m_ClassDictionary[static_cast<TOutputValue>(p)];
+      targets[id] = m_ClassDictionary[static_cast<TOutputValue>(p)];
       }
     else
       {
-      target[0] = static_cast<TOutputValue>(p);
+      targets[id] = static_cast<TOutputValue>(p);
       }
-    targets->SetMeasurementVector(id,target);
     ++id;
     }
 }
@@ -22,6 +22,7 @@
 #include <fstream>
 #include <string>
 #include <algorithm>
+#include <vector>
 
 #include <otbMachineLearningModel.h>
 #include "otbConfusionMatrixCalculator.h"
@@ -48,6 +49,43 @@ typedef MachineLearningModelRegressionType::TargetListSampleType TargetListSampl
 
 typedef otb::ConfusionMatrixCalculator<TargetListSampleType, TargetListSampleType> ConfusionMatrixCalculatorType;
 
+// Check that the prediction of a contiguous matrix of samples gives the
+// same labels and confidence values as the prediction of each sample
+bool CheckPredictBatchMatrix(const MachineLearningModelType * model, const InputListSampleType * samples)
+{
+  const unsigned int nbSamples = samples->Size();
+  const unsigned int nbFeatures = samples->GetMeasurementVectorSize();
+  std::vector<InputValueType> matrix;
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    const InputSampleType & sample = samples->GetMeasurementVector(i);
+    for (unsigned int j = 0; j < nbFeatures; ++j)
+      {
+      matrix.push_back(sample[j]);
+      }
+    }
+
+  const bool confidence = model->HasConfidenceIndex();
+  std::vector<TargetValueType> targets(nbSamples);
+  std::vector<MachineLearningModelType::ConfidenceValueType> quality(nbSamples);
+  model->PredictBatch(matrix.data(), nbSamples, nbFeatures, targets.data(),
+                      confidence ? quality.data() : nullptr);
+
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    MachineLearningModelType::ConfidenceValueType expectedQuality = 0;
+    const TargetValueType expected =
+      model->Predict(samples->GetMeasurementVector(i), confidence ? &expectedQuality : nullptr)[0];
+    if (targets[i] != expected || (confidence && quality[i] != expectedQuality))
+      {
+      std::cout << "Batch prediction of sample " << i << " differs: " << targets[i] << " (" << quality[i]
+                << ") instead of " << expected << " (" << expectedQuality << ")" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
 #ifdef OTB_USE_LIBSVM
 #include "otbLibSVMMachineLearningModel.h"
 
@@ -111,7 +149,7 @@ int otbLibSVMMachineLearningModel(int argc, char * argv[])
   std::cout<<"Overall Accuracy: "<<cmCalculatorLoad->GetOverallAccuracy()<<std::endl;
 
 
-  if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001)
+  if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001 && CheckPredictBatchMatrix(classifierLoad, samples))
     {
     return EXIT_SUCCESS;
     }
@@ -334,7 +372,7 @@ int otbKNearestNeighborsMachineLearningModel(int argc, char * argv[])
   std::cout<<"Overall Accuracy: "<<cmCalculatorLoad->GetOverallAccuracy()<<std::endl;
 
 
-  if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001)
+  if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001 && CheckPredictBatchMatrix(classifierLoad, samples))
     {
     return EXIT_SUCCESS;
     }
@@ -414,7 +452,7 @@ int otbRandomForestsMachineLearningModel(int argc, char * argv[])
   std::cout<<"Overall Accuracy: "<<cmCalculatorLoad->GetOverallAccuracy()<<std::endl;
 
 
-  if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001)
+  if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001 && CheckPredictBatchMatrix(classifierLoad, samples))
     {
     return EXIT_SUCCESS;
     }
@@ -494,7 +532,7 @@ int otbBoostMachineLearningModel(int argc, char * argv[])
   std::cout<<"Overall Accuracy: "<<cmCalculatorLoad->GetOverallAccuracy()<<std::endl;
 
 
-  if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001)
+  if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001 && CheckPredictBatchMatrix(classifierLoad, samples))
     {
     return EXIT_SUCCESS;
     }
@@ -809,6 +847,44 @@ int otbGradientBoostedTreeMachineLearningModel(int argc, char * argv[])
 
 #include "otbSharkRandomForestsMachineLearningModel.h"
 
+// Check that the prediction of a contiguous matrix of samples gives the
+// same labels and confidence values as the prediction of the list sample
+bool CheckPredictBatchMatrixAgainstList(const MachineLearningModelType * model, const InputListSampleType * samples)
+{
+  const unsigned int nbSamples = samples->Size();
+  const unsigned int nbFeatures = samples->GetMeasurementVectorSize();
+  std::vector<InputValueType> matrix;
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    const InputSampleType & sample = samples->GetMeasurementVector(i);
+    for (unsigned int j = 0; j < nbFeatures; ++j)
+      {
+      matrix.push_back(sample[j]);
+      }
+    }
+
+  std::vector<TargetValueType> targets(nbSamples);
+  std::vector<MachineLearningModelType::ConfidenceValueType> quality(nbSamples);
+  model->PredictBatch(matrix.data(), nbSamples, nbFeatures, targets.data(), quality.data());
+
+  MachineLearningModelType::ConfidenceListSampleType::Pointer expectedQuality =
+    MachineLearningModelType::ConfidenceListSampleType::New();
+  TargetListSampleType::Pointer expected = model->PredictBatch(samples, expectedQuality);
+
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    if (targets[i] != expected->GetMeasurementVector(i)[0] ||
+        quality[i] != expectedQuality->GetMeasurementVector(i)[0])
+      {
+      std::cout << "Batch prediction of sample " << i << " differs: " << targets[i] << " (" << quality[i]
+                << ") instead of " << expected->GetMeasurementVector(i)[0] << " ("
+                << expectedQuality->GetMeasurementVector(i)[0] << ")" << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
 int otbSharkRFMachineLearningModel(int argc, char * argv[])
 {
   if (argc != 3 )
@@ -898,7 +974,7 @@ int otbSharkRFMachineLearningModel(int argc, char * argv[])
    std::cout<<"Overall Accuracy: "<<cmCalculatorLoad->GetOverallAccuracy()<<std::endl;
 
 
-   if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001)
+   if ( std::abs(kappaIdxLoad - kappaIdx) < 0.00000001 && CheckPredictBatchMatrixAgainstList(classifierLoad, samples))
      {
      return EXIT_SUCCESS;
      }
@@ -141,6 +141,10 @@ protected:
   virtual void DoPredictBatch(const InputListSampleType *, const unsigned int &startIndex, const unsigned int &size,
                               TargetListSampleType *, ConfidenceListSampleType * = nullptr) const override;
 
+  /** Predict values of a contiguous matrix of samples using the model */
+  void DoPredictBatchMatrix(const InputValueType *input, unsigned int nbSamples, unsigned int nbFeatures,
+                            TargetValueType *targets, ConfidenceValueType *quality) const override;
+
   template<typename DataType>
   DataType NormalizeData(const DataType &data) const;
 
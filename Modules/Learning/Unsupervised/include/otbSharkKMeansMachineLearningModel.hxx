@@ -20,6 +20,7 @@
 #ifndef otbSharkKMeansMachineLearningModel_hxx
 #define otbSharkKMeansMachineLearningModel_hxx
 
+#include <algorithm>
 #include <fstream>
 #include "boost/make_shared.hpp"
 #include "itkMacro.h"
@@ -147,9 +148,45 @@ SharkKMeansMachineLearningModel<TInputValue, TOutputValue>
             <<"requested range ["<<startIndex<<", "<<startIndex+size<<"[ partially outside input sample list range.[0,"<<input->Size()<<"[" );
     }
 
-  // Convert input list of features to shark data format
+  // The range is predicted as a contiguous matrix of samples
+  std::vector<InputValueType> matrix;
+  otb::Shark::ListSampleRangeToArray( input, matrix, startIndex, size );
+  std::vector<TargetValueType> predictions( size );
+  std::vector<ConfidenceValueType> confidences( quality != nullptr ? size : 0 );
+  this->DoPredictBatchMatrix( matrix.data(), size, input->GetMeasurementVectorSize(), predictions.data(),
+                              quality != nullptr ? confidences.data() : nullptr );
+
+  for( unsigned int i = 0; i < size; ++i )
+    {
+    TargetSampleType target;
+    target[0] = predictions[i];
+    targets->SetMeasurementVector( startIndex + i, target );
+    if( quality != nullptr )
+      {
+      quality->SetMeasurementVector( startIndex + i, confidences[i] );
+      }
+    }
+}
+
+template<class TInputValue, class TOutputValue>
+void
+SharkKMeansMachineLearningModel<TInputValue, TOutputValue>
+::DoPredictBatchMatrix(const InputValueType *input,
+                       unsigned int nbSamples,
+                       unsigned int nbFeatures,
+                       TargetValueType *targets,
+                       ConfidenceValueType *quality) const
+{
+  assert( targets != nullptr );
+
+  if( nbSamples == 0 )
+    {
+    return;
+    }
+
+  // Convert the matrix of features to shark data format
   std::vector<shark::RealVector> features;
-  otb::Shark::ListSampleRangeToSharkVector( input, features, startIndex, size );
+  otb::Shark::ArrayToSharkVector( input, nbSamples, nbFeatures, features );
   shark::Data<shark::RealVector> inputSamples = shark::createDataFromRange( features );
 
   shark::Data<ClusteringOutputType> clusters;
@@ -163,22 +200,17 @@ SharkKMeansMachineLearningModel<TInputValue, TOutputValue>
                                "The number of features of input samples and the model could differ.");
     }
 
-  unsigned int id = startIndex;
+  unsigned int id = 0;
   for( const auto &p : clusters.elements() )
     {
-    TargetSampleType target;
-    target[0] = static_cast<TOutputValue>(p);
-    targets->SetMeasurementVector( id, target );
+    targets[id] = static_cast<TOutputValue>(p);
     ++id;
     }
 
   // Change quality measurement only if SoftClustering or other clustering method is used.
   if( quality != nullptr )
     {
-    for( unsigned int qid = startIndex; qid < startIndex+size; ++qid )
-      {
-      quality->SetMeasurementVector( qid, static_cast<ConfidenceValueType>(1.) );
-      }
+    std::fill( quality, quality + nbSamples, static_cast<ConfidenceValueType>(1.) );
     }
 }
 
@@ -65,10 +65,12 @@ public:
     return !(*this != other);
   }
 
-  // Operator on vector pixel type
-  inline TOutput operator ()(const InputVectorType& inputVector) const
+  // Operator on vector pixel type, reading the components of the pixel
+  // views of any component type without converting the whole pixel
+  template <class TValue>
+  inline TOutput operator ()(const itk::VariableLengthVector<TValue>& inputVector) const
   {
-    return this->Evaluate(inputVector[m_RedIndex - 1], static_cast<TInput2>(inputVector[m_NIRIndex - 1]));
+    return this->Evaluate(static_cast<TInput1>(inputVector[m_RedIndex - 1]), static_cast<TInput2>(inputVector[m_NIRIndex - 1]));
   }
 
   // Binary operator
@@ -173,10 +175,12 @@ public:
     return !(*this != other);
   }
 
-  // Operator on vector pixel type
-  inline TOutput operator ()(const InputVectorType& inputVector)
+  // Operator on vector pixel type, reading the components of the pixel
+  // views of any component type without converting the whole pixel
+  template <class TValue>
+  inline TOutput operator ()(const itk::VariableLengthVector<TValue>& inputVector)
   {
-    return this->Evaluate(inputVector[m_RedIndex - 1],
+    return this->Evaluate(static_cast<TInput1>(inputVector[m_RedIndex - 1]),
                           static_cast<TInput2>(inputVector[m_BlueIndex - 1]),
                           static_cast<TInput3>(inputVector[m_NIRIndex - 1]));
   }
@@ -301,10 +305,12 @@ public:
     return !(*this != other);
   }
 
-  // Operator on vector pixel type
-  inline TOutput operator ()(const InputVectorType& inputVector)
+  // Operator on vector pixel type, reading the components of the pixel
+  // views of any component type without converting the whole pixel
+  template <class TValue>
+  inline TOutput operator ()(const itk::VariableLengthVector<TValue>& inputVector)
   {
-    return this->Evaluate(inputVector[m_RedIndex - 1],
+    return this->Evaluate(static_cast<TInput1>(inputVector[m_RedIndex - 1]),
                           static_cast<TInput2>(inputVector[m_GreenIndex - 1]),
                           static_cast<TInput3>(inputVector[m_NIRIndex - 1]));
   }
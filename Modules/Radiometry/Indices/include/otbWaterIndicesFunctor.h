@@ -64,10 +64,12 @@ public:
     return !(*this != other);
   }
 
-  // Operator on vector pixel type
-  inline TOutput operator ()(const InputVectorType& inputVector) const
+  // Operator on vector pixel type, reading the components of the pixel
+  // views of any component type without converting the whole pixel
+  template <class TValue>
+  inline TOutput operator ()(const itk::VariableLengthVector<TValue>& inputVector) const
   {
-    return this->Evaluate(inputVector[m_Index1 - 1], static_cast<TInput2>(inputVector[m_Index2 - 1]));
+    return this->Evaluate(static_cast<TInput1>(inputVector[m_Index1 - 1]), static_cast<TInput2>(inputVector[m_Index2 - 1]));
   }
 
   // Binary operator
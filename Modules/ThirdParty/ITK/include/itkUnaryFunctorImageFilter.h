@@ -23,6 +23,9 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+// <PATCH OTB>
+#include "otbFunctorTraits.h"
+// </PATCH OTB>
 
 namespace itk
 {
@@ -38,6 +41,13 @@ namespace itk
  * UnaryFunctorImageFilter (like the CastImageFilter) can be used
  * to promote a 2D image to a 3D image, etc.
  *
+ * <PATCH OTB>
+ * Functors providing void operator()(OutputPixel &, const InputPixel &)
+ * write their result in an output pixel sized once per thread, instead
+ * of returning a new pixel for each input pixel (see
+ * otb::Functor::HasOutputArgument).
+ * </PATCH OTB>
+ *
  * \sa BinaryFunctorImageFilter TernaryFunctorImageFilter
  *
  * \ingroup   IntensityImageFilters     MultiThreaded
@@ -131,6 +141,19 @@ private:
   UnaryFunctorImageFilter(const Self &) = delete;
   void operator=(const Self &) = delete;
 
+  // <PATCH OTB>
+  typedef otb::Functor::HasOutputArgument<FunctorType, OutputImagePixelType, InputImagePixelType>
+    FunctorHasOutputArgumentType;
+
+  /** Pixel loop with functors returning the output pixel */
+  void ApplyFunctor(const OutputImageRegionType & outputRegionForThread,
+                    ThreadIdType threadId, std::false_type);
+
+  /** Pixel loop with functors writing in the output pixel */
+  void ApplyFunctor(const OutputImageRegionType & outputRegionForThread,
+                    ThreadIdType threadId, std::true_type);
+  // </PATCH OTB>
+
   FunctorType m_Functor;
 };
 } // end namespace itk
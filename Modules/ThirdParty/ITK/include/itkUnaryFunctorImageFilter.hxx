@@ -157,6 +157,18 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
 {
+  // <PATCH OTB>
+  this->ApplyFunctor(outputRegionForThread, threadId,
+                     typename FunctorHasOutputArgumentType::Type());
+}
+
+template< class TInputImage, class TOutputImage, class TFunction  >
+void
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::ApplyFunctor(const OutputImageRegionType & outputRegionForThread,
+               ThreadIdType threadId, std::false_type)
+{
+  // </PATCH OTB>
   const TInputImage *inputPtr = this->GetInput();
   TOutputImage *outputPtr = this->GetOutput(0);
 
@@ -191,6 +203,55 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
     progress.CompletedPixel();  // potential exception thrown here
     }
 }
+
+// <PATCH OTB>
+template< class TInputImage, class TOutputImage, class TFunction  >
+void
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::ApplyFunctor(const OutputImageRegionType & outputRegionForThread,
+               ThreadIdType threadId, std::true_type)
+{
+  const TInputImage *inputPtr = this->GetInput();
+  TOutputImage *outputPtr = this->GetOutput(0);
+
+  // Define the portion of the input to walk for this thread, using
+  // the CallCopyOutputRegionToInputRegion method allows for the input
+  // and output images to be different dimensions
+  InputImageRegionType inputRegionForThread;
+
+  this->CallCopyOutputRegionToInputRegion(inputRegionForThread, outputRegionForThread);
+
+  // Define the iterators
+  ImageScanlineConstIterator< TInputImage > inputIt(inputPtr, inputRegionForThread);
+  ImageScanlineIterator< TOutputImage > outputIt(outputPtr, outputRegionForThread);
+
+  inputIt.GoToBegin();
+  outputIt.GoToBegin();
+
+  const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / outputRegionForThread.GetSize(0);
+  ProgressReporter progress( this, threadId, numberOfLinesToProcess );
+
+  // Single output pixel for the whole region, filled by the functor and
+  // copied in the output buffer
+  OutputImagePixelType outputPixel;
+  NumericTraits< OutputImagePixelType >::SetLength( outputPixel,
+                                                    outputPtr->GetNumberOfComponentsPerPixel() );
+
+  while ( !inputIt.IsAtEnd() )
+    {
+    while ( !inputIt.IsAtEndOfLine() )
+      {
+      m_Functor( outputPixel, inputIt.Get() );
+      outputIt.Set( outputPixel );
+      ++inputIt;
+      ++outputIt;
+      }
+    inputIt.NextLine();
+    outputIt.NextLine();
+    progress.CompletedPixel();  // potential exception thrown here
+    }
+}
+// </PATCH OTB>
 } // end namespace itk
 
 #endif
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbFunctorTraits_h
+#define otbFunctorTraits_h
+
+#include <type_traits>
+#include <utility>
+
+namespace otb
+{
+namespace Functor
+{
+/** \struct HasOutputArgument
+ * \brief Tells whether a functor writes its result in an output pixel
+ * given as first argument.
+ *
+ * Functors returning a VariableLengthVector by value allocate a new
+ * pixel on each call. A functor may instead provide
+ * \code
+ * void operator()(TOutput & output, const TInput & input);
+ * \endcode
+ * where output is already sized to the number of components of the
+ * output image. The functor filters supporting this protocol use it
+ * whenever the functor provides it, so that a single output pixel is
+ * allocated per thread. The input pixels of a VectorImage are passed as
+ * VariableLengthVector views over the interleaved buffer of the image,
+ * without copy.
+ *
+ * Only operators returning void are considered, so that binary
+ * operators on scalars returning a value are not mistaken for this
+ * protocol.
+ *
+ * \ingroup OTBITK
+ */
+template <class TFunctor, class TOutput, class... TInputs>
+struct HasOutputArgument
+{
+private:
+  template <class F>
+  static auto Test(int)
+    -> typename std::is_void<decltype(std::declval<F&>()(std::declval<TOutput&>(),
+                                                          std::declval<const TInputs&>()...))>::type;
+
+  template <class F>
+  static std::false_type Test(...);
+
+public:
+  typedef decltype(Test<TFunctor>(0)) Type;
+  static const bool value = Type::value;
+};
+
+} // end namespace Functor
+} // end namespace otb
+
+#endif
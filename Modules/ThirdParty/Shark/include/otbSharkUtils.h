@@ -132,6 +132,45 @@ template <class T> void ListSampleToSharkVector(const T * listSample, std::vecto
   ListSampleRangeToSharkVector(listSample,output,0, static_cast<unsigned int>(listSample->Size()));
 }
 
+/** Copy a range of a list sample to a row-major matrix of samples */
+template <class T, class TValue> void ListSampleRangeToArray(const T * listSample, std::vector<TValue> & output, unsigned int start, unsigned int size)
+{
+  assert(listSample != nullptr);
+
+  if(start+size>listSample->Size())
+    {
+    std::out_of_range e_(std::string("otb::Shark::ListSampleRangeToArray "
+      ": Requested range is out of list sample bounds"));
+    throw e_;
+    }
+
+  const unsigned int sampleSize = listSample->GetMeasurementVectorSize();
+  output.clear();
+  output.reserve(static_cast<size_t>(size) * sampleSize);
+  for (unsigned int sampleIdx = start; sampleIdx < start+size; ++sampleIdx)
+    {
+    typename T::MeasurementVectorType const & sample = listSample->GetMeasurementVector(sampleIdx);
+    for (unsigned int i = 0; i < sampleSize; ++i)
+      {
+      output.push_back(static_cast<TValue>(sample[i]));
+      }
+    }
+}
+
+/** Convert a row-major matrix of nbSamples x nbFeatures values to shark vectors */
+template <class T> void ArrayToSharkVector(const T * input, unsigned int nbSamples, unsigned int nbFeatures, std::vector<shark::RealVector> & output)
+{
+  assert(input != nullptr || nbSamples == 0);
+
+  output.clear();
+  output.reserve(nbSamples);
+  for (unsigned int i = 0; i < nbSamples; ++i)
+    {
+    const T * row = input + static_cast<size_t>(i) * nbFeatures;
+    output.emplace_back(row, row + nbFeatures);
+    }
+}
+
 /** Shark assumes that labels are 0 ... (nbClasses-1). This function modifies the labels contained in the input vector and returns a vector with size = nbClasses which allows the translation from the normalised labels to the new ones oldLabel = dictionary[newLabel].
 */
 template <typename T> void NormalizeLabelsAndGetDictionary(std::vector<T>& labels, 
@@ -598,6 +598,17 @@ public:
    */
   FloatVectorImageType* GetParameterImage(std::string parameter);
 
+  /* Get an image value, read from the native coarser level of the file
+   * closest to the given decimation (see
+   * InputImageParameter::GetImageAtNativeResolution())
+   *
+   * Can be called for types :
+   * \li ParameterType_InputImage
+   */
+  FloatVectorImageType* GetParameterImageAtNativeResolution(std::string parameter,
+                                                            unsigned int decimation,
+                                                            unsigned int& factor);
+
   UInt8ImageType * GetParameterUInt8Image(std::string);
   UInt16ImageType * GetParameterUInt16Image(std::string);
   Int16ImageType * GetParameterInt16Image(std::string);
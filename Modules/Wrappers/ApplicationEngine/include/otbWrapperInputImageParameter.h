@@ -59,6 +59,16 @@ public:
   /** Get the input image as FloatVectorImageType. */
   FloatVectorImageType* GetImage();
 
+  /** Get the input image as FloatVectorImageType, read from the native
+   * coarser level (overview or JPEG2000 resolution level) of the file
+   * closest to the given decimation. factor is set to the resolution
+   * factor k of the level read, chosen so that 2^k divides decimation:
+   * the image is then decimated by 2^k with respect to GetImage(). The
+   * full resolution image is returned, with a null factor, if the image
+   * is not read from a file, if the file has no such level or if the
+   * resol option is already set in the filename. */
+  FloatVectorImageType* GetImageAtNativeResolution(unsigned int decimation, unsigned int& factor);
+
   /** Get the input image as XXXImageType */
   UInt8ImageType* GetUInt8Image();
   UInt16ImageType* GetUInt16Image();
@@ -155,6 +165,7 @@ protected:
 
   itk::ProcessObject::Pointer m_Reader;
   itk::ProcessObject::Pointer m_Caster;
+  itk::ProcessObject::Pointer m_NativeResolutionReader;
 
 private:
   InputImageParameter(const Parameter &) = delete;
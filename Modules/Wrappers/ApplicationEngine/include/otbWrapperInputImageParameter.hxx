@@ -25,6 +25,7 @@
 
 #include "itkUnaryFunctorImageFilter.h"
 #include "otbClampImageFilter.h"
+#include "otbBufferViewImageFilter.h"
 
 namespace otb
 {
@@ -234,6 +235,22 @@ InputImageParameter::CastImage()
     {
     TInputImage* realInputImage = dynamic_cast<TInputImage*>(m_Image.GetPointer());
 
+    // When both types share the same buffer layout, the upstream buffer
+    // is handed over as is, without any copy
+    typedef BufferViewImageFilter<TInputImage, TOutputImage> ViewFilterType;
+    if (ViewFilterType::CanView(realInputImage))
+      {
+      typename ViewFilterType::Pointer view = ViewFilterType::New();
+
+      view->SetInput(realInputImage);
+      view->UpdateOutputInformation();
+
+      m_Image = view->GetOutput();
+      m_Caster = view;
+
+      return view->GetOutput();
+      }
+
     typedef ClampImageFilter<TInputImage, TOutputImage> CasterType;
     typename CasterType::Pointer caster = CasterType::New();
 
@@ -1907,6 +1907,19 @@ FloatVectorImageType* Application::GetParameterImage(std::string parameter)
   return this->GetParameterImage<FloatVectorImageType>(parameter);
 }
 
+FloatVectorImageType* Application::GetParameterImageAtNativeResolution(std::string parameter,
+                                                                       unsigned int decimation,
+                                                                       unsigned int& factor)
+{
+  Parameter* param = GetParameterByKey(parameter);
+  InputImageParameter* paramDown = dynamic_cast<InputImageParameter*>(param);
+  if (!paramDown)
+    {
+    itkExceptionMacro(<<parameter << " parameter can't be casted to ImageType");
+    }
+  return paramDown->GetImageAtNativeResolution(decimation, factor);
+}
+
 FloatVectorImageListType* Application::GetParameterImageList(std::string parameter)
 {
   FloatVectorImageListType::Pointer ret=nullptr;
@@ -24,6 +24,8 @@
 #include "otbWrapperInputImageParameterMacros.h"
 #include "otb_boost_string_header.h"
 
+#include <sstream>
+
 namespace otb
 {
 
@@ -68,6 +70,54 @@ InputImageParameter::GetImage()
   return this->GetImage<FloatVectorImageType>();
 }
 
+FloatVectorImageType*
+InputImageParameter::GetImageAtNativeResolution(unsigned int decimation, unsigned int& factor)
+{
+  factor = 0;
+
+  FloatVectorImageType* image = this->GetImage<FloatVectorImageType>();
+
+  FloatVectorReaderType* reader = dynamic_cast<FloatVectorReaderType*>(m_Reader.GetPointer());
+  if (!m_UseFilename || reader == nullptr)
+    {
+    return image;
+    }
+
+  // Do not override a level chosen by the user
+  ExtendedFilenameToReaderOptions::Pointer helper = ExtendedFilenameToReaderOptions::New();
+  helper->SetExtendedFileName(m_FileName);
+  if (helper->ResolutionFactorIsSet())
+    {
+    return image;
+    }
+
+  // The remaining decimation has to be an integer
+  factor = reader->GetNativeResolutionFactor(decimation);
+  while (factor > 0 && decimation % (1u << factor) != 0)
+    {
+    --factor;
+    }
+  if (factor == 0)
+    {
+    return image;
+    }
+
+  std::ostringstream extFilename;
+  extFilename << m_FileName;
+  if (m_FileName.find('?') == std::string::npos)
+    {
+    extFilename << '?';
+    }
+  extFilename << "&resol=" << factor;
+
+  FloatVectorReaderType::Pointer nativeReader = FloatVectorReaderType::New();
+  nativeReader->SetFileName(extFilename.str());
+  nativeReader->UpdateOutputInformation();
+  m_NativeResolutionReader = nativeReader;
+
+  return nativeReader->GetOutput();
+}
+
 template <>
 ImageBaseType*
 InputImageParameter::GetImage<ImageBaseType>()
@@ -105,6 +155,7 @@ InputImageParameter
   m_Image  = nullptr;
   m_Reader = nullptr;
   m_Caster = nullptr;
+  m_NativeResolutionReader = nullptr;
   m_FileName = "";
   m_PreviousFileName="";
   m_UseFilename = true;
@@ -20,6 +20,7 @@
 
 #include "otbWrapperOutputImageParameter.h"
 #include "otbClampImageFilter.h"
+#include "otbBufferViewImageFilter.h"
 #include "otbImageIOFactory.h"
 #include "itksys/SystemTools.hxx"
 
@@ -242,11 +243,29 @@ ClampAndWriteVectorImage( TInput * in ,
                     const unsigned int & ramValue )
 {
   std::pair<itk::ProcessObject::Pointer,itk::ProcessObject::Pointer> ret;
-  typedef ClampImageFilter < TInput , TOutput > ClampFilterType;
-  typename ClampFilterType::Pointer clampFilter ( ClampFilterType::New() );
+  typedef itk::ImageToImageFilter < TInput , TOutput > CastFilterType;
+  typename CastFilterType::Pointer castFilter;
 
-  clampFilter->SetInput( in);
-  ret.first = clampFilter.GetPointer();
+  // No conversion is needed when the output pixel type matches the
+  // buffer of the image: the writer reads the buffer directly. With a
+  // band range, the writer remaps the bands in its input buffer, which
+  // must then be a copy.
+  otb::ExtendedFilenameToWriterOptions::Pointer filenameHelper =
+    otb::ExtendedFilenameToWriterOptions::New();
+  filenameHelper->SetExtendedFileName( filename );
+
+  typedef BufferViewImageFilter < TInput , TOutput > ViewFilterType;
+  if ( !filenameHelper->BandRangeIsSet() && ViewFilterType::CanView( in ) )
+    {
+    castFilter = ViewFilterType::New().GetPointer();
+    }
+  else
+    {
+    castFilter = ClampImageFilter < TInput , TOutput >::New().GetPointer();
+    }
+
+  castFilter->SetInput( in);
+  ret.first = castFilter.GetPointer();
   
   bool useStandardWriter = true;
 
@@ -267,7 +286,7 @@ ClampAndWriteVectorImage( TInput * in ,
       typedef otb::MPIVrtWriter<TOutput> VRTWriterType;
 
       typename VRTWriterType::Pointer vrtWriter = VRTWriterType::New();
-      vrtWriter->SetInput(clampFilter->GetOutput());
+      vrtWriter->SetInput(castFilter->GetOutput());
       vrtWriter->SetFileName(filename);
       vrtWriter->SetAvailableRAM(ramValue);
       ret.second = vrtWriter.GetPointer();
@@ -280,7 +299,7 @@ ClampAndWriteVectorImage( TInput * in ,
 
       typename SPTWriterType::Pointer sptWriter = SPTWriterType::New();
       sptWriter->SetFileName(filename);
-      sptWriter->SetInput(clampFilter->GetOutput());
+      sptWriter->SetInput(castFilter->GetOutput());
       sptWriter->GetStreamingManager()->SetDefaultRAM(ramValue);
       ret.second = sptWriter.GetPointer();
       }
@@ -300,7 +319,7 @@ ClampAndWriteVectorImage( TInput * in ,
     typename otb::ImageFileWriter<TOutput>::Pointer writer =
       otb::ImageFileWriter<TOutput>::New();
     writer->SetFileName( filename );
-    writer->SetInput(clampFilter->GetOutput());
+    writer->SetInput(castFilter->GetOutput());
     writer->GetStreamingManager()->SetDefaultRAM(ramValue);
     ret.second = writer.GetPointer();
     }
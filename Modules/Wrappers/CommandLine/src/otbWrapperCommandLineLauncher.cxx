@@ -45,6 +45,7 @@
 
 #include "otbWrapperApplicationRegistry.h"
 #include "otbWrapperTypes.h"
+#include "otbTracer.h"
 #include <itksys/RegularExpression.hxx>
 #include <string>
 #include <iostream>
@@ -143,7 +144,17 @@ bool CommandLineLauncher::ExecuteAndWriteOutputNoCatch()
       {
       return false;
       }
-    if( m_Application->ExecuteAndWriteOutput() == 0 )
+    const int status = m_Application->ExecuteAndWriteOutput();
+
+    if (m_Parser->IsAttributExists("-trace", m_VExpression) == true)
+      {
+      if (!otb::Tracer::GetInstance().Stop())
+        {
+        m_Application->GetLogger()->Warning("Unable to write the trace file.\n");
+        }
+      }
+
+    if( status == 0 )
       {
       this->DisplayOutputParameters();
       }
@@ -393,6 +404,18 @@ CommandLineLauncher::ParamResultType CommandLineLauncher::LoadParameters()
       }
     }
 
+  // Check for the trace parameter
+  if (m_Parser->IsAttributExists("-trace", m_VExpression) == true)
+    {
+    std::vector<std::string> val = m_Parser->GetAttribut("-trace", m_VExpression);
+    if (val.size() != 1 || val[0].empty())
+      {
+      std::cerr << "ERROR: Invalid value for parameter -trace. It must be a file name." << std::endl;
+      return WRONGPARAMETERVALUE;
+      }
+    otb::Tracer::GetInstance().Start(val[0]);
+    }
+
   const std::vector<std::string> appKeyList = m_Application->GetParametersKeys(true);
   // Loop over each parameter key declared in the application
   // FIRST PASS : set parameter values
@@ -679,6 +702,10 @@ void CommandLineLauncher::DisplayHelp(bool longHelp)
     }
 
   std::cerr << "        -"<<bigKey<<" <boolean>        Report progress " << std::endl;
+  bigKey = "trace";
+  for(unsigned int i=0; i<maxKeySize-std::string("trace").size(); i++)
+    bigKey.append(" ");
+  std::cerr << "        -"<<bigKey<<" <string>         Write a trace of the processing (Chrome trace JSON) " << std::endl;
   bigKey = "help";
   for(unsigned int i=0; i<maxKeySize-std::string("help").size(); i++)
     bigKey.append(" ");
@@ -951,6 +978,7 @@ bool CommandLineLauncher::CheckKeyValidity(std::string& refKey)
   appKeyList.push_back("help");
   appKeyList.push_back("progress");
   appKeyList.push_back("testenv");
+  appKeyList.push_back("trace");
   appKeyList.push_back("version");
 
   // Check if each key in the expression exists in the application
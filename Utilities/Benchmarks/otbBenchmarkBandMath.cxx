@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBenchmarkCommon.h"
+#include "otbBenchmarkSyntheticImageSource.h"
+#include "otbBandMathImageFilter.h"
+#include "otbMultiToMonoChannelExtractROI.h"
+#include "otbVectorImage.h"
+#include "otbImage.h"
+
+#include <sstream>
+#include <vector>
+
+// Combination of all the bands, as done by the BandMath application
+void otbBenchmarkBandMath(const otb::Benchmark::Settings & settings, otb::Benchmark::Result & result)
+{
+  typedef otb::VectorImage<float, 2>                               VectorImageType;
+  typedef otb::Image<float, 2>                                     ImageType;
+  typedef otb::Benchmark::SyntheticImageSource<VectorImageType>    SourceType;
+  typedef otb::MultiToMonoChannelExtractROI<float, float>          ExtractorType;
+  typedef otb::BandMathImageFilter<ImageType>                      FilterType;
+
+  SourceType::Pointer source = SourceType::New();
+  SourceType::SizeType size;
+  size[0] = settings.width;
+  size[1] = settings.height;
+  source->SetSize(size);
+  source->SetNumberOfBands(settings.bands);
+
+  FilterType::Pointer filter = FilterType::New();
+  std::vector<ExtractorType::Pointer> extractors;
+
+  std::ostringstream expression;
+  expression << "(b1 - b" << settings.bands << ") / (b1 + b" << settings.bands << " + 1)";
+  for (unsigned int b = 1; b <= settings.bands; ++b)
+    {
+    ExtractorType::Pointer extractor = ExtractorType::New();
+    extractor->SetInput(source->GetOutput());
+    extractor->SetChannel(b);
+    filter->SetNthInput(b - 1, extractor->GetOutput());
+    extractors.push_back(extractor);
+
+    expression << " + " << 0.1 * b << " * sqrt(b" << b << ")";
+    }
+  filter->SetExpression(expression.str());
+
+  otb::Benchmark::StreamAndTime(filter->GetOutput(), settings, result);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbBenchmarkCommon_h
+#define otbBenchmarkCommon_h
+
+#include "otbStreamingImageVirtualWriter.h"
+
+#include <chrono>
+#include <string>
+
+namespace otb
+{
+namespace Benchmark
+{
+
+/** Parameters shared by all the benchmarks */
+struct Settings
+{
+  Settings() : width(1024), height(1024), bands(4), ram(0) {}
+
+  /** Size of the synthetic input image */
+  unsigned int width;
+  unsigned int height;
+
+  /** Number of bands of the synthetic input image, for the filters
+   *  working on multi-band images */
+  unsigned int bands;
+
+  /** RAM available for streaming, in MB (0 uses the configuration) */
+  unsigned int ram;
+};
+
+/** Outcome of a single run */
+struct Result
+{
+  Result() : pixels(0), seconds(0.) {}
+
+  /** Number of output pixels produced */
+  unsigned long long pixels;
+
+  /** Time spent to produce them, setup excluded */
+  double seconds;
+};
+
+/** A benchmark builds its pipeline from the settings, runs it once and
+ *  fills the result. Errors are reported with exceptions. */
+typedef void (*FunctionType)(const Settings &, Result &);
+
+/** Seconds elapsed since start */
+inline double SecondsSince(const std::chrono::steady_clock::time_point & start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/** Stream the largest possible region of image through a virtual
+ *  writer, the way a writer would, and time it */
+template <class TImage>
+void StreamAndTime(TImage * image, const Settings & settings, Result & result)
+{
+  typedef StreamingImageVirtualWriter<TImage> StreamerType;
+
+  typename StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput(image);
+  streamer->SetAutomaticAdaptativeStreaming(settings.ram);
+
+  image->UpdateOutputInformation();
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  streamer->Update();
+  result.seconds = SecondsSince(start);
+  result.pixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+}
+
+} // end namespace Benchmark
+} // end namespace otb
+
+#endif
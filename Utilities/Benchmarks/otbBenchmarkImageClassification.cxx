@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBenchmarkCommon.h"
+#include "otbBenchmarkSyntheticImageSource.h"
+#include "otbImageClassificationFilter.h"
+#include "otbMachineLearningModel.h"
+#include "otbVectorImage.h"
+#include "otbImage.h"
+
+#include <limits>
+
+namespace
+{
+
+/** Nearest centroid classifier. The supervised models all depend on
+ *  optional third parties: this one measures the cost of the
+ *  classification filter itself, with a cheap and predictable model. */
+class NearestCentroidModel : public otb::MachineLearningModel<float, unsigned int>
+{
+public:
+  typedef NearestCentroidModel                           Self;
+  typedef otb::MachineLearningModel<float, unsigned int> Superclass;
+  typedef itk::SmartPointer<Self>                        Pointer;
+  typedef itk::SmartPointer<const Self>                  ConstPointer;
+
+  typedef Superclass::InputSampleType     InputSampleType;
+  typedef Superclass::TargetSampleType    TargetSampleType;
+  typedef Superclass::ConfidenceValueType ConfidenceValueType;
+
+  itkNewMacro(Self);
+  itkTypeMacro(NearestCentroidModel, MachineLearningModel);
+
+  static const unsigned int NumberOfClasses = 8;
+
+  void Train() override {}
+
+  void Save(const std::string &, const std::string &) override {}
+
+  void Load(const std::string &, const std::string &) override {}
+
+  bool CanReadFile(const std::string &) override
+  {
+    return false;
+  }
+
+  bool CanWriteFile(const std::string &) override
+  {
+    return false;
+  }
+
+protected:
+  NearestCentroidModel() {}
+  ~NearestCentroidModel() override {}
+
+private:
+  NearestCentroidModel(const Self &) = delete;
+  void operator =(const Self&) = delete;
+
+  /** The centroid of class c has all its components equal to 32c + 16 */
+  TargetSampleType DoPredict(const InputSampleType & input, ConfidenceValueType * quality) const override
+  {
+    unsigned int bestLabel = 0;
+    double bestDistance = std::numeric_limits<double>::max();
+    for (unsigned int c = 0; c < NumberOfClasses; ++c)
+      {
+      const double centroid = 32. * c + 16.;
+      double distance = 0.;
+      for (unsigned int b = 0; b < input.Size(); ++b)
+        {
+        const double d = input[b] - centroid;
+        distance += d * d;
+        }
+      if (distance < bestDistance)
+        {
+        bestDistance = distance;
+        bestLabel = c + 1;
+        }
+      }
+
+    if (quality != nullptr)
+      {
+      *quality = -bestDistance;
+      }
+
+    TargetSampleType target;
+    target[0] = bestLabel;
+    return target;
+  }
+};
+
+} // end anonymous namespace
+
+// Pixel-wise classification of a multi-band image, in batch mode
+void otbBenchmarkImageClassification(const otb::Benchmark::Settings & settings, otb::Benchmark::Result & result)
+{
+  typedef otb::VectorImage<float, 2>                                    ImageType;
+  typedef otb::Image<unsigned int, 2>                                   LabelImageType;
+  typedef otb::Benchmark::SyntheticImageSource<ImageType>               SourceType;
+  typedef otb::ImageClassificationFilter<ImageType, LabelImageType>     FilterType;
+
+  SourceType::Pointer source = SourceType::New();
+  SourceType::SizeType size;
+  size[0] = settings.width;
+  size[1] = settings.height;
+  source->SetSize(size);
+  source->SetNumberOfBands(settings.bands);
+
+  NearestCentroidModel::Pointer model = NearestCentroidModel::New();
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(source->GetOutput());
+  filter->SetModel(model);
+
+  otb::Benchmark::StreamAndTime(filter->GetOutput(), settings, result);
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBenchmarkCommon.h"
+#include "otbBenchmarkSyntheticImageSource.h"
+#include "otbImageClassificationFilter.h"
+#include "otbVectorImage.h"
+#include "otbImage.h"
+
+#ifdef OTB_BENCHMARKS_USE_OPENCV
+#include "otbRandomForestsMachineLearningModel.h"
+#include "otbKNearestNeighborsMachineLearningModel.h"
+#include "otbBoostMachineLearningModel.h"
+#endif
+#ifdef OTB_BENCHMARKS_USE_LIBSVM
+#include "otbLibSVMMachineLearningModel.h"
+#endif
+
+namespace
+{
+
+typedef otb::VectorImage<float, 2>                                ImageType;
+typedef otb::Image<unsigned int, 2>                               LabelImageType;
+typedef otb::Benchmark::SyntheticImageSource<ImageType>           SourceType;
+typedef otb::ImageClassificationFilter<ImageType, LabelImageType> FilterType;
+typedef FilterType::ModelType                                     ModelType;
+
+/** Train a model on pixels of the synthetic image, labelled after the
+ *  blocks of the image. Training is not timed. */
+void Train(ModelType * model, const otb::Benchmark::Settings & settings)
+{
+  typedef ModelType::InputSampleType      InputSampleType;
+  typedef ModelType::InputListSampleType  InputListSampleType;
+  typedef ModelType::TargetSampleType     TargetSampleType;
+  typedef ModelType::TargetListSampleType TargetListSampleType;
+
+  InputListSampleType::Pointer samples = InputListSampleType::New();
+  samples->SetMeasurementVectorSize(settings.bands);
+  TargetListSampleType::Pointer labels = TargetListSampleType::New();
+
+  InputSampleType sample(settings.bands);
+  TargetSampleType label;
+  for (long y = 0; y < 512; y += 9)
+    {
+    for (long x = 0; x < 512; x += 7)
+      {
+      for (unsigned int b = 0; b < settings.bands; ++b)
+        {
+        sample[b] = SourceType::Value(x, y, b);
+        }
+      label[0] = 1 + (x / 64 + y / 64) % 3;
+      samples->PushBack(sample);
+      labels->PushBack(label);
+      }
+    }
+
+  model->SetInputListSample(samples);
+  model->SetTargetListSample(labels);
+  model->Train();
+}
+
+/** Classify the synthetic image with a trained model, sample per
+ *  sample or in batch mode */
+void Classify(ModelType * model, bool batch, const otb::Benchmark::Settings & settings,
+              otb::Benchmark::Result & result)
+{
+  SourceType::Pointer source = SourceType::New();
+  SourceType::SizeType size;
+  size[0] = settings.width;
+  size[1] = settings.height;
+  source->SetSize(size);
+  source->SetNumberOfBands(settings.bands);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(source->GetOutput());
+  filter->SetModel(model);
+  filter->SetBatchMode(batch);
+
+  otb::Benchmark::StreamAndTime(filter->GetOutput(), settings, result);
+}
+
+#ifdef OTB_BENCHMARKS_USE_OPENCV
+ModelType::Pointer CreateRandomForests(const otb::Benchmark::Settings & settings)
+{
+  typedef otb::RandomForestsMachineLearningModel<float, unsigned int> RandomForestsType;
+  RandomForestsType::Pointer model = RandomForestsType::New();
+  model->SetMaxNumberOfTrees(50);
+  model->SetMaxDepth(10);
+  Train(model, settings);
+  return model.GetPointer();
+}
+
+ModelType::Pointer CreateKNearestNeighbors(const otb::Benchmark::Settings & settings)
+{
+  typedef otb::KNearestNeighborsMachineLearningModel<float, unsigned int> KNearestNeighborsType;
+  KNearestNeighborsType::Pointer model = KNearestNeighborsType::New();
+  model->SetK(8);
+  Train(model, settings);
+  return model.GetPointer();
+}
+
+ModelType::Pointer CreateBoost(const otb::Benchmark::Settings & settings)
+{
+  typedef otb::BoostMachineLearningModel<float, unsigned int> BoostType;
+  BoostType::Pointer model = BoostType::New();
+  Train(model, settings);
+  return model.GetPointer();
+}
+#endif
+
+#ifdef OTB_BENCHMARKS_USE_LIBSVM
+ModelType::Pointer CreateLibSVM(const otb::Benchmark::Settings & settings)
+{
+  typedef otb::LibSVMMachineLearningModel<float, unsigned int> LibSVMType;
+  LibSVMType::Pointer model = LibSVMType::New();
+  model->SetKernelType(RBF);
+  Train(model, settings);
+  return model.GetPointer();
+}
+#endif
+
+} // end anonymous namespace
+
+// Pixel-wise classification with the supervised models, sample per
+// sample (PerSample) and through the batch prediction path (Batch)
+#define DEFINE_PREDICTION_BENCHMARK(name) \
+  void otbBenchmark##name##PerSample(const otb::Benchmark::Settings & settings, otb::Benchmark::Result & result) \
+  { \
+    Classify(Create##name(settings), false, settings, result); \
+  } \
+  void otbBenchmark##name##Batch(const otb::Benchmark::Settings & settings, otb::Benchmark::Result & result) \
+  { \
+    Classify(Create##name(settings), true, settings, result); \
+  }
+
+#ifdef OTB_BENCHMARKS_USE_OPENCV
+DEFINE_PREDICTION_BENCHMARK(RandomForests)
+DEFINE_PREDICTION_BENCHMARK(KNearestNeighbors)
+DEFINE_PREDICTION_BENCHMARK(Boost)
+#endif
+
+#ifdef OTB_BENCHMARKS_USE_LIBSVM
+DEFINE_PREDICTION_BENCHMARK(LibSVM)
+#endif
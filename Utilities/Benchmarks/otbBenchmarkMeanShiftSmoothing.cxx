@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBenchmarkCommon.h"
+#include "otbBenchmarkSyntheticImageSource.h"
+#include "otbMeanShiftSmoothingImageFilter.h"
+#include "otbVectorImage.h"
+
+// Mean-shift smoothing of a multi-band image, with the default
+// parameters of the MeanShiftSmoothing application
+void otbBenchmarkMeanShiftSmoothing(const otb::Benchmark::Settings & settings, otb::Benchmark::Result & result)
+{
+  typedef otb::VectorImage<float, 2>                                    ImageType;
+  typedef otb::Benchmark::SyntheticImageSource<ImageType>               SourceType;
+  typedef otb::MeanShiftSmoothingImageFilter<ImageType, ImageType>      FilterType;
+
+  SourceType::Pointer source = SourceType::New();
+  SourceType::SizeType size;
+  size[0] = settings.width;
+  size[1] = settings.height;
+  source->SetSize(size);
+  source->SetNumberOfBands(settings.bands);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(source->GetOutput());
+  filter->SetSpatialBandwidth(5);
+  filter->SetRangeBandwidth(15.);
+  filter->SetThreshold(0.1);
+  filter->SetMaxIterationNumber(100);
+  filter->SetModeSearch(false);
+
+  otb::Benchmark::StreamAndTime(filter->GetOutput(), settings, result);
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBenchmarkCommon.h"
+#include "otbBenchmarkSyntheticImageSource.h"
+#include "otbOrthoRectificationFilter.h"
+#include "otbMapProjections.h"
+#include "otbGeoInformationConversion.h"
+#include "otbVectorImage.h"
+
+// Projection of a multi-band image in geographic coordinates to UTM.
+// The synthetic image has no sensor model: the geometry goes through
+// GenericRSTransform and the displacement grid all the same.
+void otbBenchmarkOrthoRectification(const otb::Benchmark::Settings & settings, otb::Benchmark::Result & result)
+{
+  typedef otb::VectorImage<float, 2>                                                   ImageType;
+  typedef otb::Benchmark::SyntheticImageSource<ImageType>                              SourceType;
+  typedef otb::UtmInverseProjection                                                    MapProjectionType;
+  typedef otb::OrthoRectificationFilter<ImageType, ImageType, MapProjectionType>       FilterType;
+
+  // About 1 m per pixel, around Toulouse
+  SourceType::Pointer source = SourceType::New();
+  SourceType::SizeType size;
+  size[0] = settings.width;
+  size[1] = settings.height;
+  SourceType::PointType origin;
+  origin[0] = 1.4;
+  origin[1] = 43.6;
+  SourceType::SpacingType spacing;
+  spacing[0] = 1.2e-5;
+  spacing[1] = -0.9e-5;
+  source->SetSize(size);
+  source->SetNumberOfBands(settings.bands);
+  source->SetOrigin(origin);
+  source->SetSpacing(spacing);
+  source->SetProjectionRef(otb::GeoInformationConversion::ToWKT(4326));
+  source->UpdateOutputInformation();
+
+  MapProjectionType::Pointer mapProjection = MapProjectionType::New();
+  mapProjection->SetZone(31);
+  mapProjection->SetHemisphere('N');
+
+  ImageType::PixelType padding(settings.bands);
+  padding.Fill(0);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(source->GetOutput());
+  filter->SetMapProjection(mapProjection);
+  filter->SetEdgePaddingValue(padding);
+
+  FilterType::SpacingType outputSpacing;
+  outputSpacing[0] = 1.;
+  outputSpacing[1] = -1.;
+  filter->SetOutputParametersFromMap("UTM", outputSpacing);
+
+  FilterType::SpacingType gridSpacing;
+  gridSpacing[0] = 4.;
+  gridSpacing[1] = -4.;
+  filter->SetDisplacementFieldSpacing(gridSpacing);
+
+  otb::Benchmark::StreamAndTime(filter->GetOutput(), settings, result);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBenchmarkCommon.h"
+#include "otbBenchmarkSyntheticImageSource.h"
+#include "otbScalarImageToTexturesFilter.h"
+#include "otbImage.h"
+
+// The eight simple Haralick textures of a single band image, with the
+// default parameters of the HaralickTextureExtraction application
+void otbBenchmarkScalarImageToTextures(const otb::Benchmark::Settings & settings, otb::Benchmark::Result & result)
+{
+  typedef otb::Image<float, 2>                                      ImageType;
+  typedef otb::Benchmark::SyntheticImageSource<ImageType>           SourceType;
+  typedef otb::ScalarImageToTexturesFilter<ImageType, ImageType>    FilterType;
+
+  SourceType::Pointer source = SourceType::New();
+  SourceType::SizeType size;
+  size[0] = settings.width;
+  size[1] = settings.height;
+  source->SetSize(size);
+
+  FilterType::SizeType radius;
+  radius.Fill(2);
+  FilterType::OffsetType offset;
+  offset.Fill(1);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(source->GetOutput());
+  filter->SetRadius(radius);
+  filter->SetOffset(offset);
+  filter->SetNumberOfBinsPerAxis(8);
+  filter->SetInputImageMinimum(0);
+  filter->SetInputImageMaximum(255);
+
+  // All the outputs are computed together
+  otb::Benchmark::StreamAndTime(filter->GetEnergyOutput(), settings, result);
+}
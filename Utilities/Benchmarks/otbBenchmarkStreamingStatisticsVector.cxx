@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBenchmarkCommon.h"
+#include "otbBenchmarkSyntheticImageSource.h"
+#include "otbStreamingStatisticsVectorImageFilter.h"
+#include "otbVectorImage.h"
+
+#include <chrono>
+
+// Mean, covariance and extrema of a multi-band image
+void otbBenchmarkStreamingStatisticsVector(const otb::Benchmark::Settings & settings, otb::Benchmark::Result & result)
+{
+  typedef otb::VectorImage<float, 2>                                 ImageType;
+  typedef otb::Benchmark::SyntheticImageSource<ImageType>            SourceType;
+  typedef otb::StreamingStatisticsVectorImageFilter<ImageType>       FilterType;
+
+  SourceType::Pointer source = SourceType::New();
+  SourceType::SizeType size;
+  size[0] = settings.width;
+  size[1] = settings.height;
+  source->SetSize(size);
+  source->SetNumberOfBands(settings.bands);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(source->GetOutput());
+  filter->GetStreamer()->SetAutomaticAdaptativeStreaming(settings.ram);
+
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  filter->Update();
+  result.seconds = otb::Benchmark::SecondsSince(start);
+  result.pixels = source->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef otbBenchmarkSyntheticImageSource_h
+#define otbBenchmarkSyntheticImageSource_h
+
+#include "itkImageSource.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMetaDataObject.h"
+#include "itkNumericTraits.h"
+#include "itkDefaultConvertPixelTraits.h"
+#include "otbMetaDataKey.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace otb
+{
+namespace Benchmark
+{
+
+/** \class SyntheticImageSource
+ *
+ * \brief Generate a deterministic multi-band image on request
+ *
+ * Pixels are computed on the fly for the requested region only, so that
+ * large images can be streamed without being held in memory. Values lie
+ * in [0, 255] and mix smooth waves, blocks and noise, so that textures,
+ * segmentation and classification filters do some actual work.
+ *
+ * The image can be given an origin, a spacing and a projection
+ * reference, for the geometric filters.
+ */
+template <class TImage>
+class SyntheticImageSource : public itk::ImageSource<TImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef SyntheticImageSource          Self;
+  typedef itk::ImageSource<TImage>      Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  typedef TImage                                OutputImageType;
+  typedef typename OutputImageType::PixelType   PixelType;
+  typedef typename OutputImageType::RegionType  RegionType;
+  typedef typename OutputImageType::SizeType    SizeType;
+  typedef typename OutputImageType::IndexType   IndexType;
+  typedef typename OutputImageType::PointType   PointType;
+  typedef typename OutputImageType::SpacingType SpacingType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SyntheticImageSource, itk::ImageSource);
+
+  itkSetMacro(Size, SizeType);
+  itkGetConstReferenceMacro(Size, SizeType);
+
+  /** Number of bands, ignored for scalar images */
+  itkSetMacro(NumberOfBands, unsigned int);
+  itkGetConstMacro(NumberOfBands, unsigned int);
+
+  itkSetMacro(Origin, PointType);
+  itkGetConstReferenceMacro(Origin, PointType);
+
+  itkSetMacro(Spacing, SpacingType);
+  itkGetConstReferenceMacro(Spacing, SpacingType);
+
+  /** Projection reference stored in the metadata, none by default */
+  itkSetMacro(ProjectionRef, std::string);
+  itkGetConstReferenceMacro(ProjectionRef, std::string);
+
+  /** Value of band b (starting at 0) at pixel (x, y) */
+  static double Value(long x, long y, unsigned int b)
+  {
+    unsigned long h = static_cast<unsigned long>(x) * 73856093UL
+      ^ static_cast<unsigned long>(y) * 19349663UL
+      ^ static_cast<unsigned long>(b + 1) * 83492791UL;
+    h = (h ^ (h >> 13)) * 1274126177UL;
+    const double noise = static_cast<double>((h >> 8) & 0xFFFF) / 65536.0 - 0.5;
+    const double wave = std::sin(0.05 * x + 0.7 * b) * std::cos(0.04 * y - 0.3 * b);
+    const double block = static_cast<double>((x / 64 + y / 64 + b) % 3) - 1.0;
+
+    return std::min(255.0, std::max(0.0, 127.5 + 60.0 * wave + 30.0 * block + 40.0 * noise));
+  }
+
+protected:
+  SyntheticImageSource()
+    : m_NumberOfBands(1)
+  {
+    m_Size.Fill(256);
+    m_Origin.Fill(0.5);
+    m_Spacing.Fill(1.0);
+  }
+
+  ~SyntheticImageSource() override {}
+
+  void GenerateOutputInformation() override
+  {
+    OutputImageType * output = this->GetOutput();
+
+    IndexType index;
+    index.Fill(0);
+    RegionType region(index, m_Size);
+
+    output->SetLargestPossibleRegion(region);
+    output->SetOrigin(m_Origin);
+    output->SetSpacing(m_Spacing);
+    output->SetNumberOfComponentsPerPixel(m_NumberOfBands);
+
+    if (!m_ProjectionRef.empty())
+      {
+      itk::EncapsulateMetaData<std::string>(output->GetMetaDataDictionary(),
+                                            MetaDataKey::ProjectionRefKey, m_ProjectionRef);
+      }
+  }
+
+  void ThreadedGenerateData(const RegionType & outputRegionForThread, itk::ThreadIdType) override
+  {
+    OutputImageType * output = this->GetOutput();
+    const unsigned int nbComponents = output->GetNumberOfComponentsPerPixel();
+
+    PixelType pixel;
+    itk::NumericTraits<PixelType>::SetLength(pixel, nbComponents);
+
+    for (itk::ImageRegionIteratorWithIndex<OutputImageType> it(output, outputRegionForThread); !it.IsAtEnd(); ++it)
+      {
+      const IndexType & idx = it.GetIndex();
+      for (unsigned int b = 0; b < nbComponents; ++b)
+        {
+        itk::DefaultConvertPixelTraits<PixelType>::SetNthComponent(b, pixel, Value(idx[0], idx[1], b));
+        }
+      it.Set(pixel);
+      }
+  }
+
+private:
+  SyntheticImageSource(const Self &) = delete;
+  void operator =(const Self&) = delete;
+
+  SizeType     m_Size;
+  unsigned int m_NumberOfBands;
+  PointType    m_Origin;
+  SpacingType  m_Spacing;
+  std::string  m_ProjectionRef;
+};
+
+} // end namespace Benchmark
+} // end namespace otb
+
+#endif
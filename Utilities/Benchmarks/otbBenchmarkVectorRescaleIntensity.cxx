@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBenchmarkCommon.h"
+#include "otbBenchmarkSyntheticImageSource.h"
+#include "otbVectorRescaleIntensityImageFilter.h"
+#include "otbVectorImage.h"
+
+// Per band rescaling of a multi-band image to 8 bits, as done by
+// DynamicConvert and Rescale
+void otbBenchmarkVectorRescaleIntensity(const otb::Benchmark::Settings & settings, otb::Benchmark::Result & result)
+{
+  typedef otb::VectorImage<float, 2>                                              InputImageType;
+  typedef otb::VectorImage<unsigned char, 2>                                      OutputImageType;
+  typedef otb::Benchmark::SyntheticImageSource<InputImageType>                    SourceType;
+  typedef otb::VectorRescaleIntensityImageFilter<InputImageType, OutputImageType> FilterType;
+
+  SourceType::Pointer source = SourceType::New();
+  SourceType::SizeType size;
+  size[0] = settings.width;
+  size[1] = settings.height;
+  source->SetSize(size);
+  source->SetNumberOfBands(settings.bands);
+
+  // Fixed input range, so that only the rescaling itself is timed
+  InputImageType::PixelType inputMin(settings.bands), inputMax(settings.bands);
+  OutputImageType::PixelType outputMin(settings.bands), outputMax(settings.bands);
+  inputMin.Fill(0.);
+  inputMax.Fill(255.);
+  outputMin.Fill(0);
+  outputMax.Fill(255);
+
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(source->GetOutput());
+  filter->AutomaticInputMinMaxComputationOff();
+  filter->SetInputMinimum(inputMin);
+  filter->SetInputMaximum(inputMax);
+  filter->SetOutputMinimum(outputMin);
+  filter->SetOutputMaximum(outputMax);
+
+  otb::Benchmark::StreamAndTime(filter->GetOutput(), settings, result);
+}
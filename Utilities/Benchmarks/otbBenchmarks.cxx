@@ -0,0 +1,579 @@
+/*
+ * Copyright (C) 2005-2017 Centre National d'Etudes Spatiales (CNES)
+ *
+ * This file is part of Orfeo Toolbox
+ *
+ *     https://www.orfeo-toolbox.org/
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "otbBenchmarkCommon.h"
+#include "otbConfigure.h"
+#include "itkMultiThreader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define OTB_BENCHMARKS_USE_FORK
+#endif
+
+// The benchmarks, defined in otbBenchmark<Name>.cxx
+#define DECLARE_BENCHMARK(name) \
+  void otbBenchmark##name(const otb::Benchmark::Settings &, otb::Benchmark::Result &)
+
+#ifdef OTB_BENCHMARKS_USE_MATHPARSER
+DECLARE_BENCHMARK(BandMath);
+#endif
+#ifdef OTB_BENCHMARKS_USE_MATHPARSERX
+DECLARE_BENCHMARK(BandMathX);
+#endif
+DECLARE_BENCHMARK(StreamingResample);
+DECLARE_BENCHMARK(GridResample);
+DECLARE_BENCHMARK(OrthoRectification);
+DECLARE_BENCHMARK(ScalarImageToTextures);
+DECLARE_BENCHMARK(MeanShiftSmoothing);
+DECLARE_BENCHMARK(ImageClassification);
+DECLARE_BENCHMARK(StreamingStatisticsVector);
+DECLARE_BENCHMARK(VectorRescaleIntensity);
+#ifdef OTB_BENCHMARKS_USE_OPENCV
+DECLARE_BENCHMARK(RandomForestsPerSample);
+DECLARE_BENCHMARK(RandomForestsBatch);
+DECLARE_BENCHMARK(KNearestNeighborsPerSample);
+DECLARE_BENCHMARK(KNearestNeighborsBatch);
+DECLARE_BENCHMARK(BoostPerSample);
+DECLARE_BENCHMARK(BoostBatch);
+#endif
+#ifdef OTB_BENCHMARKS_USE_LIBSVM
+DECLARE_BENCHMARK(LibSVMPerSample);
+DECLARE_BENCHMARK(LibSVMBatch);
+#endif
+
+namespace
+{
+
+struct Case
+{
+  Case(const std::string & n, otb::Benchmark::FunctionType f) : name(n), function(f) {}
+
+  std::string                  name;
+  otb::Benchmark::FunctionType function;
+};
+
+#define REGISTER_BENCHMARK(name) \
+  cases.push_back(Case(#name, otbBenchmark##name))
+
+std::vector<Case> GetCases()
+{
+  std::vector<Case> cases;
+#ifdef OTB_BENCHMARKS_USE_MATHPARSER
+  REGISTER_BENCHMARK(BandMath);
+#endif
+#ifdef OTB_BENCHMARKS_USE_MATHPARSERX
+  REGISTER_BENCHMARK(BandMathX);
+#endif
+  REGISTER_BENCHMARK(StreamingResample);
+  REGISTER_BENCHMARK(GridResample);
+  REGISTER_BENCHMARK(OrthoRectification);
+  REGISTER_BENCHMARK(ScalarImageToTextures);
+  REGISTER_BENCHMARK(MeanShiftSmoothing);
+  REGISTER_BENCHMARK(ImageClassification);
+  REGISTER_BENCHMARK(StreamingStatisticsVector);
+  REGISTER_BENCHMARK(VectorRescaleIntensity);
+#ifdef OTB_BENCHMARKS_USE_OPENCV
+  REGISTER_BENCHMARK(RandomForestsPerSample);
+  REGISTER_BENCHMARK(RandomForestsBatch);
+  REGISTER_BENCHMARK(KNearestNeighborsPerSample);
+  REGISTER_BENCHMARK(KNearestNeighborsBatch);
+  REGISTER_BENCHMARK(BoostPerSample);
+  REGISTER_BENCHMARK(BoostBatch);
+#endif
+#ifdef OTB_BENCHMARKS_USE_LIBSVM
+  REGISTER_BENCHMARK(LibSVMPerSample);
+  REGISTER_BENCHMARK(LibSVMBatch);
+#endif
+  return cases;
+}
+
+/** Runs of a benchmark with a given number of threads */
+struct Measure
+{
+  Measure() : threads(0), pixels(0), peakRSS(-1) {}
+
+  double GetBestSeconds() const
+  {
+    return *std::min_element(seconds.begin(), seconds.end());
+  }
+
+  double GetMeanSeconds() const
+  {
+    double sum = 0.;
+    for (std::vector<double>::const_iterator it = seconds.begin(); it != seconds.end(); ++it)
+      {
+      sum += *it;
+      }
+    return sum / seconds.size();
+  }
+
+  std::string         benchmark;
+  unsigned int        threads;
+  unsigned long long  pixels;
+  std::vector<double> seconds;
+  /** Peak resident set size in bytes, negative if unknown */
+  long long           peakRSS;
+  /** Empty if all the runs succeeded */
+  std::string         error;
+};
+
+void Run(const Case & c, const otb::Benchmark::Settings & settings,
+         unsigned int threads, unsigned int repeat, Measure & measure)
+{
+  itk::MultiThreader::SetGlobalMaximumNumberOfThreads(threads);
+  itk::MultiThreader::SetGlobalDefaultNumberOfThreads(threads);
+
+  try
+    {
+    for (unsigned int i = 0; i < repeat; ++i)
+      {
+      otb::Benchmark::Result result;
+      c.function(settings, result);
+      measure.pixels = result.pixels;
+      measure.seconds.push_back(std::max(result.seconds, 1e-9));
+      }
+    }
+  catch (itk::ExceptionObject & err)
+    {
+    measure.error = err.GetDescription();
+    }
+  catch (std::exception & err)
+    {
+    measure.error = err.what();
+    }
+  if (measure.error.empty() && measure.seconds.empty())
+    {
+    measure.error = "no run";
+    }
+}
+
+#ifdef OTB_BENCHMARKS_USE_FORK
+/** Run in a child process, so that the peak RSS is the one of this
+ *  benchmark alone */
+void RunIsolated(const Case & c, const otb::Benchmark::Settings & settings,
+                 unsigned int threads, unsigned int repeat, Measure & measure)
+{
+  int fds[2];
+  if (pipe(fds) != 0)
+    {
+    measure.error = "unable to create a pipe";
+    return;
+    }
+
+  const pid_t pid = fork();
+  if (pid < 0)
+    {
+    close(fds[0]);
+    close(fds[1]);
+    measure.error = "unable to fork";
+    return;
+    }
+
+  if (pid == 0)
+    {
+    close(fds[0]);
+    Run(c, settings, threads, repeat, measure);
+
+    std::ostringstream oss;
+    oss << std::setprecision(17);
+    if (measure.error.empty())
+      {
+      oss << "ok " << measure.pixels;
+      for (std::vector<double>::const_iterator it = measure.seconds.begin(); it != measure.seconds.end(); ++it)
+        {
+        oss << " " << *it;
+        }
+      }
+    else
+      {
+      oss << "error " << measure.error;
+      }
+    const std::string message = oss.str();
+    size_t written = 0;
+    while (written < message.size())
+      {
+      const ssize_t n = write(fds[1], message.data() + written, message.size() - written);
+      if (n <= 0)
+        {
+        break;
+        }
+      written += n;
+      }
+    close(fds[1]);
+    _exit(0);
+    }
+
+  close(fds[1]);
+  std::string message;
+  char buffer[4096];
+  ssize_t n;
+  while ((n = read(fds[0], buffer, sizeof(buffer))) > 0)
+    {
+    message.append(buffer, n);
+    }
+  close(fds[0]);
+
+  int status = 0;
+  struct rusage usage;
+  if (wait4(pid, &status, 0, &usage) == pid)
+    {
+#ifdef __APPLE__
+    measure.peakRSS = usage.ru_maxrss;
+#else
+    measure.peakRSS = static_cast<long long>(usage.ru_maxrss) * 1024;
+#endif
+    }
+
+  std::istringstream iss(message);
+  std::string tag;
+  iss >> tag;
+  if (tag == "ok")
+    {
+    iss >> measure.pixels;
+    double seconds;
+    while (iss >> seconds)
+      {
+      measure.seconds.push_back(seconds);
+      }
+    }
+  else if (tag == "error")
+    {
+    std::getline(iss >> std::ws, measure.error);
+    }
+  else if (WIFSIGNALED(status))
+    {
+    std::ostringstream oss;
+    oss << "killed by signal " << WTERMSIG(status);
+    measure.error = oss.str();
+    }
+  else
+    {
+    measure.error = "no result";
+    }
+}
+#endif
+
+std::string EscapeJSON(const std::string & value)
+{
+  std::ostringstream oss;
+  oss << '"';
+  for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+    {
+    switch (*it)
+      {
+      case '"':
+        oss << "\\\"";
+        break;
+      case '\\':
+        oss << "\\\\";
+        break;
+      case '\n':
+        oss << "\\n";
+        break;
+      case '\t':
+        oss << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(*it) < 0x20)
+          {
+          oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(*it)
+              << std::dec << std::setfill(' ');
+          }
+        else
+          {
+          oss << *it;
+          }
+      }
+    }
+  oss << '"';
+  return oss.str();
+}
+
+void WriteJSON(std::ostream & os, const otb::Benchmark::Settings & settings, unsigned int repeat,
+               const std::vector<Measure> & measures)
+{
+  os << "{\n"
+     << "  \"otbVersion\": " << EscapeJSON(OTB_VERSION_STRING) << ",\n"
+     << "  \"width\": " << settings.width << ",\n"
+     << "  \"height\": " << settings.height << ",\n"
+     << "  \"bands\": " << settings.bands << ",\n"
+     << "  \"ram\": " << settings.ram << ",\n"
+     << "  \"repeat\": " << repeat << ",\n"
+     << "  \"results\": [";
+
+  os << std::setprecision(6);
+  for (size_t i = 0; i < measures.size(); ++i)
+    {
+    const Measure & m = measures[i];
+    os << (i == 0 ? "\n" : ",\n")
+       << "    {\"benchmark\": " << EscapeJSON(m.benchmark) << ", \"threads\": " << m.threads;
+
+    if (!m.error.empty())
+      {
+      os << ", \"error\": " << EscapeJSON(m.error) << "}";
+      continue;
+      }
+
+    // Scaling is relative to the first thread count of the same benchmark
+    const Measure * reference = nullptr;
+    for (size_t j = 0; j < measures.size(); ++j)
+      {
+      if (measures[j].benchmark == m.benchmark)
+        {
+        reference = &measures[j];
+        break;
+        }
+      }
+
+    os << ", \"pixels\": " << m.pixels
+       << ", \"seconds\": " << m.GetBestSeconds()
+       << ", \"meanSeconds\": " << m.GetMeanSeconds()
+       << ", \"pixelsPerSecond\": " << m.pixels / m.GetBestSeconds();
+
+    if (reference->error.empty())
+      {
+      const double speedup = reference->GetBestSeconds() / m.GetBestSeconds();
+      os << ", \"speedup\": " << speedup
+         << ", \"efficiency\": " << speedup * reference->threads / m.threads;
+      }
+
+    os << ", \"peakRSS\": ";
+    if (m.peakRSS >= 0)
+      {
+      os << m.peakRSS;
+      }
+    else
+      {
+      os << "null";
+      }
+    os << "}";
+    }
+
+  os << "\n  ]\n}\n";
+}
+
+void Usage(const char * name)
+{
+  std::cerr << "Usage: " << name << " [options] [benchmark...]\n"
+            << "Options:\n"
+            << "  -size <n>            width and height of the synthetic image (default 1024)\n"
+            << "  -width <n>           width of the synthetic image\n"
+            << "  -height <n>          height of the synthetic image\n"
+            << "  -bands <n>           number of bands of the synthetic image (default 4)\n"
+            << "  -threads <n,n,...>   thread counts to run with (default: powers of 2 up to the number of cores)\n"
+            << "  -repeat <n>          number of runs per thread count, the best one is reported (default 3)\n"
+            << "  -ram <MB>            RAM available for streaming (default: OTB_MAX_RAM_HINT)\n"
+            << "  -out <file>          write the JSON report to file instead of the standard output\n"
+            << "  -list                list the benchmarks and exit\n"
+            << "All the benchmarks are run if none is given." << std::endl;
+}
+
+bool ParseUnsigned(const std::string & value, unsigned int & result)
+{
+  std::istringstream iss(value);
+  unsigned int v;
+  if (!(iss >> v) || !iss.eof())
+    {
+    return false;
+    }
+  result = v;
+  return true;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char * argv[])
+{
+  otb::Benchmark::Settings  settings;
+  unsigned int              repeat = 3;
+  std::vector<unsigned int> threadCounts;
+  std::string               outputFileName;
+  std::vector<std::string>  names;
+
+  const std::vector<Case> cases = GetCases();
+
+  for (int i = 1; i < argc; ++i)
+    {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+
+    if (arg == "-help" || arg == "--help" || arg == "-h")
+      {
+      Usage(argv[0]);
+      return EXIT_SUCCESS;
+      }
+    else if (arg == "-list")
+      {
+      for (std::vector<Case>::const_iterator it = cases.begin(); it != cases.end(); ++it)
+        {
+        std::cout << it->name << std::endl;
+        }
+      return EXIT_SUCCESS;
+      }
+    else if (arg == "-size" && hasValue && ParseUnsigned(argv[i + 1], settings.width))
+      {
+      settings.height = settings.width;
+      ++i;
+      }
+    else if ((arg == "-width" && hasValue && ParseUnsigned(argv[i + 1], settings.width))
+             || (arg == "-height" && hasValue && ParseUnsigned(argv[i + 1], settings.height))
+             || (arg == "-bands" && hasValue && ParseUnsigned(argv[i + 1], settings.bands))
+             || (arg == "-repeat" && hasValue && ParseUnsigned(argv[i + 1], repeat))
+             || (arg == "-ram" && hasValue && ParseUnsigned(argv[i + 1], settings.ram)))
+      {
+      ++i;
+      }
+    else if (arg == "-threads" && hasValue)
+      {
+      std::istringstream iss(argv[++i]);
+      std::string token;
+      while (std::getline(iss, token, ','))
+        {
+        unsigned int n = 0;
+        if (!ParseUnsigned(token, n) || n == 0)
+          {
+          std::cerr << "Invalid thread count: " << token << std::endl;
+          return EXIT_FAILURE;
+          }
+        threadCounts.push_back(n);
+        }
+      }
+    else if (arg == "-out" && hasValue)
+      {
+      outputFileName = argv[++i];
+      }
+    else if (!arg.empty() && arg[0] != '-')
+      {
+      names.push_back(arg);
+      }
+    else
+      {
+      std::cerr << "Invalid option: " << arg << std::endl;
+      Usage(argv[0]);
+      return EXIT_FAILURE;
+      }
+    }
+
+  if (settings.width == 0 || settings.height == 0 || settings.bands == 0 || repeat == 0)
+    {
+    std::cerr << "Size, number of bands and number of runs must be positive" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (threadCounts.empty())
+    {
+    const unsigned int cores = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+    for (unsigned int n = 1; n < cores; n *= 2)
+      {
+      threadCounts.push_back(n);
+      }
+    threadCounts.push_back(cores);
+    }
+
+  std::vector<Case> selected;
+  if (names.empty())
+    {
+    selected = cases;
+    }
+  for (std::vector<std::string>::const_iterator nit = names.begin(); nit != names.end(); ++nit)
+    {
+    std::vector<Case>::const_iterator it = cases.begin();
+    while (it != cases.end() && it->name != *nit)
+      {
+      ++it;
+      }
+    if (it == cases.end())
+      {
+      std::cerr << "Unknown benchmark: " << *nit << " (see -list)" << std::endl;
+      return EXIT_FAILURE;
+      }
+    selected.push_back(*it);
+    }
+
+  std::vector<Measure> measures;
+  bool failed = false;
+
+  for (std::vector<Case>::const_iterator it = selected.begin(); it != selected.end(); ++it)
+    {
+    for (std::vector<unsigned int>::const_iterator tit = threadCounts.begin(); tit != threadCounts.end(); ++tit)
+      {
+      Measure measure;
+      measure.benchmark = it->name;
+      measure.threads = *tit;
+
+#ifdef OTB_BENCHMARKS_USE_FORK
+      RunIsolated(*it, settings, *tit, repeat, measure);
+#else
+      Run(*it, settings, *tit, repeat, measure);
+#endif
+
+      std::cerr << std::left << std::setw(28) << it->name << std::right << std::setw(3) << *tit << " threads: ";
+      if (measure.error.empty())
+        {
+        std::cerr << std::fixed << std::setprecision(2)
+                  << measure.pixels / measure.GetBestSeconds() / 1e6 << " Mpixels/s";
+        if (measure.peakRSS >= 0)
+          {
+          std::cerr << ", peak RSS " << measure.peakRSS / (1024 * 1024) << " MB";
+          }
+        std::cerr.unsetf(std::ios_base::floatfield);
+        }
+      else
+        {
+        std::cerr << "failed: " << measure.error;
+        failed = true;
+        }
+      std::cerr << std::endl;
+
+      measures.push_back(measure);
+      }
+    }
+
+  if (outputFileName.empty())
+    {
+    WriteJSON(std::cout, settings, repeat, measures);
+    }
+  else
+    {
+    std::ofstream ofs(outputFileName.c_str());
+    if (!ofs)
+      {
+      std::cerr << "Unable to write " << outputFileName << std::endl;
+      return EXIT_FAILURE;
+      }
+    WriteJSON(ofs, settings, repeat, measures);
+    }
+
+  return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}